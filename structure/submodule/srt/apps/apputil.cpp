@@ -373,6 +373,8 @@ const char* SRTClockTypeStr()
         return "MACH_ABSTIME";
     case SRT_SYNC_CLOCK_POSIX_GETTIMEOFDAY:
         return "POSIX_GETTIMEOFDAY";
+    case SRT_SYNC_CLOCK_TSC:
+        return "TSC";
     default:
         break;
     }
@@ -254,7 +254,12 @@ const SocketOption srt_options [] {
 #ifdef SRT_ENABLE_BINDTODEVICE
     { "bindtodevice", 0, SRTO_BINDTODEVICE, SocketOption::PRE, SocketOption::STRING, nullptr},
 #endif
-    { "retransmitalgo", 0, SRTO_RETRANSMITALGO, SocketOption::PRE, SocketOption::INT, nullptr }
+    { "retransmitalgo", 0, SRTO_RETRANSMITALGO, SocketOption::PRE, SocketOption::INT, nullptr },
+    { "cryptoworkers", 0, SRTO_CRYPTOWORKERS, SocketOption::PRE, SocketOption::INT, nullptr },
+    { "tsbpdworkers", 0, SRTO_TSBPDWORKERS, SocketOption::PRE, SocketOption::INT, nullptr },
+    { "sndpriority", 0, SRTO_SNDPRIORITY, SocketOption::POST, SocketOption::INT, nullptr },
+    { "sndweight", 0, SRTO_SNDWEIGHT, SocketOption::POST, SocketOption::INT, nullptr },
+    { "muxmaxbw", 0, SRTO_MUXMAXBW, SocketOption::PRE, SocketOption::INT64, nullptr }
 #ifdef ENABLE_AEAD_API_PREVIEW
     ,{ "cryptomode", 0, SRTO_CRYPTOMODE, SocketOption::PRE, SocketOption::INT, nullptr }
 #endif
@@ -0,0 +1,56 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2026 Haivision Systems Inc.
+ * 
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ * 
+ */
+
+// Renders a binary log, written after srt_setlogbinfile(), as text.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+
+#include "logging_bin.h"
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    if (argc != 2 || string(argv[1]) == "-h" || string(argv[1]) == "-help")
+    {
+        cerr << "Usage: " << argv[0] << " <binary log file>\n";
+        cerr << "Prints the log lines from a file written with srt_setlogbinfile() or srt-live-transmit -logbin\n";
+        return 2;
+    }
+
+    ifstream in(argv[1], ios::in | ios::binary);
+    if (!in)
+    {
+        cerr << "ERROR: Can't open '" << argv[1] << "'\n";
+        return 1;
+    }
+
+    srt_logging::LogBinReader reader(in);
+    if (!reader.open())
+    {
+        cerr << "ERROR: '" << argv[1] << "' is not an SRT binary log, or was written on a different architecture\n";
+        return 1;
+    }
+
+    string line;
+    while (reader.next((line)))
+        cout << line;
+
+    if (reader.failed())
+    {
+        // A log written until a crash ends with a partial record.
+        cerr << "ERROR: '" << argv[1] << "' is truncated or malformed\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -57,6 +57,7 @@ set cmake_options {
     enable-monotonic-clock "Enforced clock_gettime with monotonic clock on GC CV /temporary fix for #729/ (default: OFF)"
     enable-thread-check "Enable #include <threadcheck.h> that implements THREAD_* macros"
     enable-stdc++-sync "Use standard C++11 chrono/threads instead of pthread wrapper (default: OFF, on Windows: ON)"
+    enable-tsc-clock "Use the calibrated CPU timestamp counter as the steady clock on x86 (default: OFF)"
     use-openssl-pc "Use pkg-config to find OpenSSL libraries (default: ON)"
     openssl-use-static-libs "Link OpenSSL statically (default: OFF)."
     use-busy-waiting "Enable more accurate sending times at a cost of potentially higher CPU load (default: OFF)"
@@ -119,6 +119,11 @@ static CRYSPR_cb* crysprOpenSSL_EVP_Open(CRYSPR_methods* cryspr, size_t max_len)
 
     cryspr_cb->aes_sek[1] = EVP_CIPHER_CTX_new();
 
+    /* AES-ECB contexts to precompute the AES-CTR keystream of several packets at once */
+    cryspr_cb->aes_ksk[0] = EVP_CIPHER_CTX_new();
+
+    cryspr_cb->aes_ksk[1] = EVP_CIPHER_CTX_new();
+
     return (cryspr_cb);
 }
 
@@ -128,13 +133,14 @@ static int crysprOpenSSL_EVP_Close(CRYSPR_cb* cryspr_cb)
     {
         EVP_CIPHER_CTX_free(cryspr_cb->aes_sek[0]);
         EVP_CIPHER_CTX_free(cryspr_cb->aes_sek[1]);
+        EVP_CIPHER_CTX_free(cryspr_cb->aes_ksk[0]);
+        EVP_CIPHER_CTX_free(cryspr_cb->aes_ksk[1]);
         EVP_CIPHER_CTX_free(cryspr_cb->aes_kek);
     }
     return (crysprHelper_Close(cryspr_cb));
 }
 
-#if !(CRYSPR_HAS_AESCTR && CRYSPR_HAS_AESKWRAP)
-
+/* AES-ECB is also used to precompute the AES-CTR keystream (CRYSPR_HAS_CTRSTREAM) */
 int crysprOpenSSL_EVP_AES_EcbCipher(bool                 bEncrypt, /* true:encrypt, false:decrypt */
                                     CRYSPR_AESCTX*       aes_key,  /* CRYpto Service PRovider AES Key context */
                                     const unsigned char* indata, /* src (clear text if encrypt, cipher text otherwise)*/
@@ -198,7 +204,6 @@ int crysprOpenSSL_EVP_AES_EcbCipher(bool                 bEncrypt, /* true:encry
     if (outlen_p != NULL) *outlen_p = nblk * CRYSPR_AESBLKSZ;
     return 0;
 }
-#endif /* !(CRYSPR_HAS_AESCTR && CRYSPR_HAS_AESKWRAP) */
 
 int crysprOpenSSL_EVP_AES_CtrCipher(bool                 bEncrypt, /* true:encrypt, false:decrypt */
                                     CRYSPR_AESCTX*       aes_key,  /* CRYpto Service PRovider AES Key context */
@@ -382,12 +387,10 @@ CRYSPR_methods* crysprOpenSSL_EVP(void)
         crysprOpenSSL_EVP_methods.aes_ctr_cipher = crysprOpenSSL_EVP_AES_CtrCipher;
 #endif
         crysprOpenSSL_EVP_methods.aes_gcm_cipher = crysprOpenSSL_EVP_AES_GCMCipher;
-#if !(CRYSPR_HAS_AESCTR && CRYSPR_HAS_AESKWRAP)
-        /* AES-ECB only required if cryspr has no AES-CTR and no AES KeyWrap */
-        /* OpenSSL has both AESCTR and AESKWRP and the AESECB wrapper is only used
-           to test the falback methods */
+        /* AES-ECB required if cryspr has no AES-CTR and no AES KeyWrap */
+        /* OpenSSL has both AESCTR and AESKWRP and the AESECB wrapper is used
+           to precompute the AES-CTR keystream and to test the falback methods */
         crysprOpenSSL_EVP_methods.aes_ecb_cipher = crysprOpenSSL_EVP_AES_EcbCipher;
-#endif
 #if !CRYSPR_HAS_PBKDF2
         crysprOpenSSL_EVP_methods.sha1_msg_digest = NULL; // Required to use eventual default/fallback KmPbkdf2
 #endif
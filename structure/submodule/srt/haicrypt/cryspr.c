@@ -22,6 +22,14 @@ written by
 
 #include <stdlib.h>
 #include <string.h>
+#ifdef _WIN32
+	#include <winsock2.h>
+#else
+	#include <arpa/inet.h>  /* htonl */
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
 int crysprStub_Prng(unsigned char *rn, int len)
 {
@@ -306,6 +314,11 @@ CRYSPR_cb *crysprHelper_Open(CRYSPR_methods *cryspr, size_t cb_len, size_t max_l
 	cryspr_cb->outbuf_ofs = 0;
 //	membuf += cryspr_cb->outbuf_siz;
 
+#if CRYSPR_HAS_CTRSTREAM
+	/* Keystream buffers are allocated on first use, if the cryspr provides aes_ksk */
+	cryspr_cb->ctr_ks_max = padded_len;
+#endif /* CRYSPR_HAS_CTRSTREAM */
+
 	cryspr_cb->cryspr=(CRYSPR_methods *)cryspr;
 
 	return(cryspr_cb);
@@ -313,6 +326,12 @@ CRYSPR_cb *crysprHelper_Open(CRYSPR_methods *cryspr, size_t cb_len, size_t max_l
 
 int crysprHelper_Close(CRYSPR_cb *cryspr_cb)
 {
+#if CRYSPR_HAS_CTRSTREAM
+	if (NULL != cryspr_cb) {
+		free(cryspr_cb->ctr_ks[0].stream);
+		free(cryspr_cb->ctr_ks[1].stream);
+	}
+#endif /* CRYSPR_HAS_CTRSTREAM */
 	free(cryspr_cb);
 	return(0);
 }
@@ -330,6 +349,179 @@ static int crysprFallback_Close(CRYSPR_cb *cryspr_cb)
 	return(crysprHelper_Close(cryspr_cb));
 }
 
+#if CRYSPR_HAS_CTRSTREAM
+/*
+ * AES-CTR keystream precomputed for a window of packets.
+ *
+ * The counter blocks of CRYSPR_CTRSTREAM_PKTS consecutive packet indexes
+ * are encrypted at once, with a single AES-ECB call, and each packet is
+ * then encrypted or decrypted in place by XORing it with its part of the
+ * keystream. The window is refilled when a packet past its end arrives,
+ * so with packets sent (or received) in sequence the per-packet cost is
+ * the XOR only. Packets behind the window (retransmissions, reordering)
+ * take the regular path and leave the window untouched.
+ */
+static void _crysprFallback_CtrStreamSetKey(CRYSPR_cb *cryspr_cb, int kk, const unsigned char *key, size_t key_len)
+{
+	CRYSPR_AESCTX *aes_ksk = CRYSPR_GETKSK(cryspr_cb, kk);
+	struct tag_CRYSPR_CtrStream *ks = &cryspr_cb->ctr_ks[kk];
+
+	ks->npkt = 0;
+	ks->keyed = false;
+	if ((NULL != aes_ksk)
+	&&  (0 == cryspr_cb->cryspr->aes_set_key(HCRYPT_CTX_MODE_AESECB, true, key, key_len, aes_ksk))) {
+		ks->keyed = true;
+	}
+}
+
+static int _crysprFallback_CtrStreamFill(CRYSPR_cb *cryspr_cb, hcrypt_Ctx *ctx, int kk, hcrypt_Pki pki, size_t pkt_len)
+{
+	struct tag_CRYSPR_CtrStream *ks = &cryspr_cb->ctr_ks[kk];
+	size_t stream_len = CRYSPR_CTRSTREAM_PKTS * pkt_len;
+	unsigned char *csp;
+	int i;
+
+	if (NULL == ks->stream) {
+		ks->stream = malloc(CRYSPR_CTRSTREAM_PKTS * cryspr_cb->ctr_ks_max);
+		if (NULL == ks->stream) {
+			ks->keyed = false;
+			return(-1);
+		}
+	}
+
+	/* Counter stream: consecutive packets, pkt_len/CRYSPR_AESBLKSZ blocks each */
+	csp = ks->stream;
+	for (i = 0; i < CRYSPR_CTRSTREAM_PKTS; i++) {
+		hcrypt_Pki npki = htonl(pki + i);
+		unsigned char iv[CRYSPR_AESBLKSZ];
+		unsigned blk, nblk = (unsigned)(pkt_len / CRYSPR_AESBLKSZ);
+
+		/* The 16-bit block counter (ctr) starts from 0: nonce is only 112-bit */
+		hcrypt_SetCtrIV((unsigned char *)&npki, ctx->salt, iv);
+		for (blk = 0; blk < nblk; blk++) {
+			memcpy(csp, iv, CRYSPR_AESBLKSZ);
+			csp[CRYSPR_AESBLKSZ-2] = (unsigned char)(blk >> 8);
+			csp[CRYSPR_AESBLKSZ-1] = (unsigned char)blk;
+			csp += CRYSPR_AESBLKSZ;
+		}
+	}
+
+	/* KeyStream: encrypt the counter stream in place */
+	if (cryspr_cb->cryspr->aes_ecb_cipher(true, CRYSPR_GETKSK(cryspr_cb, kk),
+			ks->stream, stream_len, ks->stream, &stream_len)) {
+		HCRYPT_LOG(LOG_ERR, "%s", "aes_ecb_cipher(keystream) failed\n");
+		ks->npkt = 0;
+		ks->keyed = false;
+		return(-1);
+	}
+	memcpy(ks->salt, ctx->salt, HAICRYPT_SALT_SZ);
+	ks->pki = pki;
+	ks->pkt_len = pkt_len;
+	ks->npkt = CRYSPR_CTRSTREAM_PKTS;
+	return(0);
+}
+
+static void _crysprFallback_XorKeyStream(unsigned char *data, const unsigned char *stream, size_t len)
+{
+	size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64)
+	for (; i + 16 <= len; i += 16) {
+		__m128i d = _mm_loadu_si128((const __m128i *)&data[i]);
+		__m128i k = _mm_loadu_si128((const __m128i *)&stream[i]);
+		_mm_storeu_si128((__m128i *)&data[i], _mm_xor_si128(d, k));
+	}
+#endif
+	for (; i < len; i++) {
+		data[i] ^= stream[i];
+	}
+}
+
+/*
+ * Encrypt or decrypt (same with CTR) the packet in place using the precomputed keystream.
+ * Returns -1 if the packet can't use it and has to take the regular path.
+ */
+static int _crysprFallback_CtrStreamXor(CRYSPR_cb *cryspr_cb, hcrypt_Ctx *ctx, hcrypt_DataDesc *in_data)
+{
+	int kk = hcryptCtx_GetKeyIndex(ctx);
+	struct tag_CRYSPR_CtrStream *ks = &cryspr_cb->ctr_ks[kk];
+	hcrypt_Pki pki;
+	uint32_t ofs;
+
+	if (!ks->keyed || (in_data[0].len > cryspr_cb->ctr_ks_max)) {
+		return(-1);
+	}
+	pki = hcryptMsg_GetPki(ctx->msg_info, in_data[0].pfx, 0);
+	ofs = pki - ks->pki;
+
+	if ((0 < ks->npkt) && (0 == memcmp(ks->salt, ctx->salt, HAICRYPT_SALT_SZ))) {
+		if (ofs < (uint32_t)ks->npkt && in_data[0].len <= ks->pkt_len) {
+			_crysprFallback_XorKeyStream(in_data[0].payload, &ks->stream[ofs * ks->pkt_len], in_data[0].len);
+			return(0);
+		}
+		if ((int32_t)ofs < 0) {
+			/* Behind the window */
+			return(-1);
+		}
+	}
+
+	/* Refill the window from this packet; packets of the stream are
+	 * generally of the same size, so keep the longest length seen. */
+	{
+		size_t pkt_len = hcryptMsg_PaddedLen(in_data[0].len, CRYSPR_AESBLKSZ);
+
+		if ((0 < ks->npkt) && (ks->pkt_len > pkt_len)) {
+			pkt_len = ks->pkt_len;
+		}
+		if (_crysprFallback_CtrStreamFill(cryspr_cb, ctx, kk, pki, pkt_len)) {
+			return(-1);
+		}
+	}
+	_crysprFallback_XorKeyStream(in_data[0].payload, ks->stream, in_data[0].len);
+	return(0);
+}
+
+/*
+ * Refill the window, if needed, so that it covers the leading packets of a
+ * batch with the longest of their lengths: the packets then take one AES-ECB
+ * call, instead of a refill for a packet longer than the ones before it.
+ */
+static void _crysprFallback_CtrStreamCover(CRYSPR_cb *cryspr_cb, hcrypt_Ctx *ctx, hcrypt_DataDesc *in_data, int nbin)
+{
+	int kk = hcryptCtx_GetKeyIndex(ctx);
+	struct tag_CRYSPR_CtrStream *ks = &cryspr_cb->ctr_ks[kk];
+	hcrypt_Pki pki0;
+	size_t pkt_len = 0;
+	bool covered;
+	int i;
+
+	if (!ks->keyed) {
+		return;
+	}
+	pki0 = hcryptMsg_GetPki(ctx->msg_info, in_data[0].pfx, 0);
+	covered = (0 < ks->npkt) && (0 == memcmp(ks->salt, ctx->salt, HAICRYPT_SALT_SZ));
+
+	for (i = 0; i < nbin; i++) {
+		hcrypt_Pki pki = hcryptMsg_GetPki(ctx->msg_info, in_data[i].pfx, 0);
+		size_t len = hcryptMsg_PaddedLen(in_data[i].len, CRYSPR_AESBLKSZ);
+
+		if ((uint32_t)(pki - pki0) >= CRYSPR_CTRSTREAM_PKTS || len > cryspr_cb->ctr_ks_max) {
+			continue; /* Left to the per-packet path */
+		}
+		if (len > pkt_len) {
+			pkt_len = len;
+		}
+		if ((uint32_t)(pki - ks->pki) >= (uint32_t)ks->npkt || len > ks->pkt_len) {
+			covered = false;
+		}
+	}
+
+	if (!covered && (0 < pkt_len)) {
+		_crysprFallback_CtrStreamFill(cryspr_cb, ctx, kk, pki0, pkt_len);
+	}
+}
+#endif /* CRYSPR_HAS_CTRSTREAM */
+
 static int crysprFallback_MsSetKey(CRYSPR_cb *cryspr_cb, hcrypt_Ctx *ctx, const unsigned char *key, size_t key_len)
 {
 	CRYSPR_AESCTX *aes_sek = CRYSPR_GETSEK(cryspr_cb, hcryptCtx_GetKeyIndex(ctx)); /* Ctx tells if it's for odd or even key */
@@ -345,6 +537,11 @@ static int crysprFallback_MsSetKey(CRYSPR_cb *cryspr_cb, hcrypt_Ctx *ctx, const
 			HCRYPT_LOG(LOG_ERR, "%s", "CRYSPR->set_encrypt_key(sek) failed\n");
 			return(-1);
 		}
+#if CRYSPR_HAS_CTRSTREAM
+		if (ctx->mode == HCRYPT_CTX_MODE_AESCTR) {
+			_crysprFallback_CtrStreamSetKey(cryspr_cb, hcryptCtx_GetKeyIndex(ctx), key, key_len);
+		}
+#endif /* CRYSPR_HAS_CTRSTREAM */
 	} else {                                       /* Decrypt key */
 		if (cryspr_cb->cryspr->aes_set_key(HCRYPT_CTX_MODE_AESCTR, false, key, key_len, aes_sek)) {
 			HCRYPT_LOG(LOG_ERR, "%s", "CRYSPR->set_decrypt_key(sek) failed\n");
@@ -419,6 +616,38 @@ static int crysprFallback_MsEncrypt(
 	ASSERT(NULL != cryspr_cb);
 	ASSERT((NULL != in_data) || (1 == nbin)); //Only one in_data[] supported
 
+	if ((NULL == out_p) && (NULL != nbout_p)) {
+		/* In place batch: the packets share the context, and the keystream */
+		int i;
+
+#if CRYSPR_HAS_CTRSTREAM
+		if (ctx->mode == HCRYPT_CTX_MODE_AESCTR) {
+			_crysprFallback_CtrStreamCover(cryspr_cb, ctx, in_data, nbin);
+		}
+#endif /* CRYSPR_HAS_CTRSTREAM */
+		for (i = 0; i < nbin; i++) {
+			int nb = crysprFallback_MsEncrypt(cryspr_cb, ctx, &in_data[i], 1, NULL, NULL, NULL);
+
+			if (0 > nb) {
+				break;
+			}
+			if (0 < nb) {
+				in_data[i].len = nb;
+			}
+		}
+		*nbout_p = i;
+		return((i == nbin) ? 0 : -1);
+	}
+
+#if CRYSPR_HAS_CTRSTREAM
+	/* In place encryption with the precomputed keystream */
+	if ((NULL == out_p)
+	&&  (ctx->mode == HCRYPT_CTX_MODE_AESCTR)
+	&&  (0 == _crysprFallback_CtrStreamXor(cryspr_cb, ctx, &in_data[0]))) {
+		return(0);
+	}
+#endif /* CRYSPR_HAS_CTRSTREAM */
+
 	/* 
 	 * Get message prefix length
 	 * to reserve room for unencrypted message header in output buffer
@@ -584,6 +813,15 @@ static int crysprFallback_MsDecrypt(CRYSPR_cb *cryspr_cb, hcrypt_Ctx *ctx,
 	ASSERT(NULL != ctx);
 	ASSERT((NULL != in_data) || (1 == nbin)); //Only one in_data[] supported
 
+#if CRYSPR_HAS_CTRSTREAM
+	/* In place decryption with the precomputed keystream */
+	if ((NULL == out_p)
+	&&  (ctx->mode == HCRYPT_CTX_MODE_AESCTR)
+	&&  (0 == _crysprFallback_CtrStreamXor(cryspr_cb, ctx, &in_data[0]))) {
+		return(0);
+	}
+#endif /* CRYSPR_HAS_CTRSTREAM */
+
 	/* Reserve output buffer (w/no header) */
 	out_txt = _crysprFallback_GetOutbuf(cryspr_cb, 0, in_data[0].len);
 
@@ -38,12 +38,22 @@ extern "C" {
 
 #include "cryspr-config.h"
 
+/* The AES-CTR keystream can be precomputed for a window of packets if the
+ * cryspr provides an AES-ECB context (aes_ksk) besides the AES-CTR one. */
+#if CRYSPR_HAS_AESCTR && defined(CRYSPR2)
+#define CRYSPR_HAS_CTRSTREAM 1
+#else
+#define CRYSPR_HAS_CTRSTREAM 0
+#endif
+
 typedef struct tag_CRYSPR_cb {
 #ifdef CRYSPR2
     CRYSPR_AESCTX  *aes_kek;		/* Key Encrypting Key (KEK) */
     CRYSPR_AESCTX  *aes_sek[2];		/* even/odd Stream Encrypting Key (SEK) */
+    CRYSPR_AESCTX  *aes_ksk[2];		/* even/odd SEK in AES-ECB mode for the CTR keystream (optional) */
 #define CRYSPR_GETKEK(cb)       ((cb)->aes_kek)
 #define CRYSPR_GETSEK(cb,kk)    ((cb)->aes_sek[kk])
+#define CRYSPR_GETKSK(cb,kk)    ((cb)->aes_ksk[kk])
 #else /*CRYSPR2*/
     CRYSPR_AESCTX   aes_kek;		/* Key Encrypting Key (KEK) */
     CRYSPR_AESCTX   aes_sek[2];		/* even/odd Stream Encrypting Key (SEK) */
@@ -62,6 +72,20 @@ typedef struct tag_CRYSPR_cb {
     size_t          ctr_stream_siz; /* Allocated length */
 #endif /* !CRYSPR_HAS_AESCTR */
 
+#if CRYSPR_HAS_CTRSTREAM
+                                        /* Keystream precomputed for the next packets (AES-CTR) */
+#define CRYSPR_CTRSTREAM_PKTS   16
+    struct tag_CRYSPR_CtrStream {
+        bool            keyed;          /* aes_ksk holds the current SEK */
+        unsigned char   salt[HAICRYPT_SALT_SZ]; /* salt the keystream was computed with */
+        hcrypt_Pki      pki;            /* packet index of the first packet in the window */
+        int             npkt;           /* packets in the window, 0 if empty */
+        size_t          pkt_len;        /* keystream length per packet (multiple of CRYSPR_AESBLKSZ) */
+        unsigned char * stream;         /* CRYSPR_CTRSTREAM_PKTS * ctr_ks_max bytes, allocated on first use */
+    } ctr_ks[2];                        /* even/odd key */
+    size_t          ctr_ks_max;         /* Longest keystream per packet */
+#endif /* CRYSPR_HAS_CTRSTREAM */
+
 #define	CRYSPR_OUTMSGMAX		6
     uint8_t *       outbuf; 		/* output circle buffer */
     size_t          outbuf_ofs;		/* write offset in circle buffer */
@@ -192,6 +216,10 @@ typedef struct tag_CRYSPR_methods {
         *
         * If cipher implements deferred encryption (co-processor, async encryption),
         * it may return no encrypted packets, or encrypted packets for clear text packets of a previous call.  
+        *
+        * Without out_p the packets are encrypted in place: a single one if nbout is NULL (returns the
+        * output length if it changed), otherwise all nbin of them, updating in_data[].len, with *nbout
+        * set to the number of packets encrypted before the first failure.
         */
         int (*ms_encrypt)(
             CRYSPR_cb *cryspr_cb,                           /* Cryspr Control Block */
@@ -109,6 +109,19 @@ int  HaiCrypt_Tx_ManageKeys(HaiCrypt_Handle hhc, void *out_p[], size_t out_len_p
 int  HaiCrypt_Tx_Data(HaiCrypt_Handle hhc, unsigned char *pfx, unsigned char *data, size_t data_len);
 int  HaiCrypt_Rx_Data(HaiCrypt_Handle hhc, unsigned char *pfx, unsigned char *data, size_t data_len);
 
+/* HaiCrypt_Tx_Data for nbpkt packets encrypted in place before they are sent, updating
+ * data_len[] with the resulting lengths. Returns the number of packets encrypted, stopping
+ * at the first failure. They're encrypted with the copy of the current context taken by
+ * the last HaiCrypt_Tx_SyncAhead, with a cipher state of its own, so HaiCrypt_Tx_DataAhead
+ * may run in another thread than the other calls; only the calls to HaiCrypt_Tx_SyncAhead
+ * must be serialized with both. HaiCrypt_Tx_SyncAhead returns the key flags of the copy.
+ * The packets are not counted for the key refresh (the key may change before they're sent
+ * and then they're encrypted again): HaiCrypt_Tx_CountData counts nbpkt such packets
+ * against the current key once sent. */
+int  HaiCrypt_Tx_SyncAhead(HaiCrypt_Handle hhc);
+int  HaiCrypt_Tx_DataAhead(HaiCrypt_Handle hhc, unsigned char *pfx[], unsigned char *data[], size_t data_len[], int nbpkt);
+int  HaiCrypt_Tx_CountData(HaiCrypt_Handle hhc, int nbpkt);
+
 /// @brief Check if the crypto service provider supports AES GCM.
 /// @return returns 1 if AES GCM is supported, 0 otherwise.
 int  HaiCrypt_IsAESGCM_Supported(void);
@@ -293,6 +293,7 @@ int HaiCrypt_Clone(HaiCrypt_Handle hhcSrc, HaiCrypt_CryptoDir tx, HaiCrypt_Handl
             mem_buf += inbuf_siz;
         }
         timerclear(&cryptoClone->km.tx_last);
+        memset(&cryptoClone->ahead, 0, sizeof(cryptoClone->ahead));
 
         /* Adjust pointers  pointing into cryproSrc after copy
            msg_info and crysprs are extern statics so this is ok*/
@@ -334,6 +335,8 @@ int HaiCrypt_Close(HaiCrypt_Handle hhc)
 
     if (crypto) {
         if (crypto->cryspr && crypto->cryspr->close) crypto->cryspr->close(crypto->cryspr_cb);
+        if (crypto->cryspr && crypto->cryspr->close && crypto->ahead.cryspr_cb) crypto->cryspr->close(crypto->ahead.cryspr_cb);
+        memset(&crypto->ahead.ctx, 0, sizeof(crypto->ahead.ctx));
         free(crypto);
         rc = 0;
     }
@@ -83,6 +83,11 @@ typedef struct hcrypt_Session_str {
             size_t          data_max_len;
         }cfg;
 
+        struct {
+            hcrypt_Ctx      ctx;            /* Current context as of the last HaiCrypt_Tx_SyncAhead */
+            CRYSPR_cb *     cryspr_cb;      /* Cipher state of its own, opened by the first sync */
+        }ahead;
+
         struct {
             struct timeval  tx_period;      /* Keying Material tx period (milliseconds) */  
             struct timeval  tx_last;        /* Keying Material last tx time */
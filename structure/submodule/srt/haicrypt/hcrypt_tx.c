@@ -129,6 +129,112 @@ int HaiCrypt_Tx_Data(HaiCrypt_Handle hhc,
 	return(nbout);
 }
 
+int HaiCrypt_Tx_CountData(HaiCrypt_Handle hhc, int nbpkt)
+{
+	hcrypt_Session *crypto = (hcrypt_Session *)hhc;
+
+	if ((NULL == crypto)
+	||  (NULL == crypto->ctx)
+	||  (0 > nbpkt)) {
+		HCRYPT_LOG(LOG_ERR, "Tx_CountData: invalid params: crypto=%p nbpkt=%d\n", crypto, nbpkt);
+		return(-1);
+	}
+	crypto->ctx->pkt_cnt += nbpkt;
+	return(0);
+}
+
+int HaiCrypt_Tx_SyncAhead(HaiCrypt_Handle hhc)
+{
+	hcrypt_Session *crypto = (hcrypt_Session *)hhc;
+	hcrypt_Ctx *ctx = NULL;
+	hcrypt_Ctx *ahead;
+
+	if ((NULL == crypto)
+	||  (NULL == (ctx = crypto->ctx))) {
+		HCRYPT_LOG(LOG_ERR, "Tx_SyncAhead: invalid params: crypto=%p crypto->ctx=%p\n", crypto, ctx);
+		return(-1);
+	}
+	if (NULL == crypto->ahead.cryspr_cb) {
+		crypto->ahead.cryspr_cb = crypto->cryspr->open(crypto->cryspr, crypto->cfg.data_max_len);
+		if (NULL == crypto->ahead.cryspr_cb) {
+			HCRYPT_LOG(LOG_ERR, "%s", "cryspr open failed\n");
+			return(-1);
+		}
+	}
+
+	/* Only what the encryption uses; set the key again when it changed */
+	ahead = &crypto->ahead.ctx;
+	if ((hcryptCtx_GetKeyFlags(ahead) != hcryptCtx_GetKeyFlags(ctx))
+	||  (ahead->mode != ctx->mode)
+	||  (ahead->sek_len != ctx->sek_len)
+	||  memcmp(ahead->sek, ctx->sek, ctx->sek_len)
+	||  memcmp(ahead->salt, ctx->salt, HAICRYPT_SALT_SZ)) {
+		ahead->flags    = ctx->flags & (HCRYPT_CTX_F_xSEK | HCRYPT_CTX_F_ENCRYPT);
+		ahead->status   = ctx->status;
+		ahead->mode     = ctx->mode;
+		ahead->msg_info = ctx->msg_info;
+		ahead->salt_len = ctx->salt_len;
+		memcpy(ahead->salt, ctx->salt, HAICRYPT_SALT_SZ);
+		ahead->sek_len  = ctx->sek_len;
+		memcpy(ahead->sek, ctx->sek, ctx->sek_len);
+
+		if (crypto->cryspr->ms_setkey(crypto->ahead.cryspr_cb, ahead, ahead->sek, ahead->sek_len)) {
+			HCRYPT_LOG(LOG_ERR, "cryspr setkey(sek[%zd]) failed\n", ahead->sek_len);
+			ahead->sek_len = 0;
+			return(-1);
+		}
+	}
+	return(hcryptCtx_GetKeyFlags(ahead));
+}
+
+/* Packets handed to the cryspr at once, like its AES-CTR keystream window */
+#define HCRYPT_TX_BATCH 16
+
+int HaiCrypt_Tx_DataAhead(HaiCrypt_Handle hhc,
+	unsigned char *in_pfx[], unsigned char *in_data[], size_t in_len[], int nbpkt)
+{
+	hcrypt_Session *crypto = (hcrypt_Session *)hhc;
+	hcrypt_Ctx *ctx = NULL;
+	int i, j;
+
+	if ((NULL == crypto)
+	||  (NULL == crypto->ahead.cryspr_cb)
+	||  (0 == (ctx = &crypto->ahead.ctx)->sek_len)
+	||  (NULL == in_pfx) || (NULL == in_data) || (NULL == in_len)) {
+		HCRYPT_LOG(LOG_ERR, "Tx_DataAhead: invalid params or not synced: crypto=%p\n", crypto);
+		return(-1);
+	}
+
+	/* Same context (key) for the whole batch; not counted for the key refresh */
+	for (i = 0; i < nbpkt; ) {
+		hcrypt_DataDesc indata[HCRYPT_TX_BATCH];
+		int nbin = nbpkt - i < HCRYPT_TX_BATCH ? nbpkt - i : HCRYPT_TX_BATCH;
+		int nbout = 0;
+
+		for (j = 0; j < nbin; j++) {
+			/* Get/Set packet index */
+			ctx->msg_info->indexMsg(in_pfx[i+j], ctx->MSpfx_cache);
+
+			indata[j].pfx      = in_pfx[i+j];
+			indata[j].payload  = in_data[i+j];
+			indata[j].len      = in_len[i+j];
+		}
+
+		if (0 > crypto->cryspr->ms_encrypt(crypto->ahead.cryspr_cb, ctx, indata, nbin, NULL, NULL, &nbout)) {
+			HCRYPT_LOG(LOG_ERR, "%s", "ms_encrypt failed\n");
+		}
+		/* AES-GCM produces the authentication tag too */
+		for (j = 0; j < nbout; j++) {
+			in_len[i+j] = indata[j].len;
+		}
+		i += nbout;
+		if (nbout < nbin) {
+			break;
+		}
+	}
+	return(i);
+}
+
 int HaiCrypt_Tx_Process(HaiCrypt_Handle hhc,
 	unsigned char *in_msg, size_t in_len,
 	void *out_p[], size_t out_len_p[], int maxout)
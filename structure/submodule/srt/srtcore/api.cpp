@@ -137,6 +137,7 @@ void srt::CUDTSocket::setClosed()
     // a timer is started and the socket will be removed after approximately
     // 1 second
     m_tsClosureTimeStamp = steady_clock::now();
+    CUDT::uglobal().scheduleGC(m_SocketID);
 }
 
 void srt::CUDTSocket::setBrokenClosed()
@@ -169,6 +170,48 @@ bool srt::CUDTSocket::broken() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+srt::CSocketIndex::CSocketIndex()
+{
+    for (size_t i = 0; i < NSHARDS; ++i)
+        setupMutex(m_Shards[i].lock, "SocketIndex");
+}
+
+void srt::CSocketIndex::insert(SRTSOCKET id, CUDTSocket* s)
+{
+    Shard&     sh = shard(id);
+    ScopedLock lk(sh.lock);
+    sh.sockets[id] = s;
+}
+
+void srt::CSocketIndex::erase(SRTSOCKET id)
+{
+    Shard&     sh = shard(id);
+    ScopedLock lk(sh.lock);
+    sh.sockets.erase(id);
+}
+
+srt::CUDTSocket* srt::CSocketIndex::find(SRTSOCKET id) const
+{
+    const Shard& sh = shard(id);
+    ScopedLock   lk(sh.lock);
+
+    std::map<SRTSOCKET, CUDTSocket*>::const_iterator i = sh.sockets.find(id);
+    if (i == sh.sockets.end())
+        return NULL;
+    return i->second;
+}
+
+void srt::CSocketIndex::clear()
+{
+    for (size_t i = 0; i < NSHARDS; ++i)
+    {
+        ScopedLock lk(m_Shards[i].lock);
+        m_Shards[i].sockets.clear();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 srt::CUDTUnited::CUDTUnited()
     : m_Sockets()
     , m_GlobControlLock()
@@ -291,17 +334,20 @@ int srt::CUDTUnited::cleanup()
         return 0;
 
     {
+        // The GC thread may wait with no timeout when it has
+        // nothing scheduled, so it must be signaled under the lock.
         UniqueLock gclock(m_GCStopLock);
         m_bClosing = true;
+        m_GCStopCond.notify_one();
     }
-    // NOTE: we can do relaxed signaling here because
-    // waiting on m_GCStopCond has a 1-second timeout,
-    // after which the m_bClosing flag is cheched, which
-    // is set here above. Worst case secenario, this
-    // pthread_join() call will block for 1 second.
-    CSync::notify_one_relaxed(m_GCStopCond);
     m_GCThread.join();
 
+    // All sockets are closed by the GC thread before it exits.
+    m_CryptoWorkers.stop();
+    m_KekCache.stop();
+    m_KekCache.clear();
+    m_TsbPdScheduler.stop();
+
     m_bGCStatus = false;
 
     // Global destruction code
@@ -452,7 +498,7 @@ SRTSOCKET srt::CUDTUnited::newSocket(CUDTSocket** pps)
 
         // protect the m_Sockets structure.
         ScopedLock cs(m_GlobControlLock);
-        m_Sockets[ns->m_SocketID] = ns;
+        mapSocket_LOCKED(ns);
     }
     catch (...)
     {
@@ -602,7 +648,7 @@ int srt::CUDTUnited::newConnection(const SRTSOCKET     listen,
                 "newConnection: incoming " << peer.str() << ", mapping socket " << ns->m_SocketID);
         {
             ScopedLock cg(m_GlobControlLock);
-            m_Sockets[ns->m_SocketID] = ns;
+            mapSocket_LOCKED(ns);
         }
 
         if (ls->core().m_cbAcceptHook)
@@ -835,7 +881,7 @@ ERR_ROLLBACK:
                 ns->removeFromGroup(true);
             }
 #endif
-            m_Sockets.erase(id);
+            unmapSocket_LOCKED(id);
             m_ClosedSockets[id] = ns;
         }
 
@@ -898,6 +944,12 @@ int srt::CUDTUnited::installConnectHook(const SRTSOCKET u, srt_connect_callback_
 
 SRT_SOCKSTATUS srt::CUDTUnited::getStatus(const SRTSOCKET u)
 {
+    // Fast path for an active socket; only a socket that is not
+    // found there needs the check in m_ClosedSockets.
+    CUDTSocket* s = m_SocketIndex.find(u);
+    if (s)
+        return s->getStatus();
+
     // protects the m_Sockets structure
     ScopedLock cg(m_GlobControlLock);
 
@@ -1488,8 +1540,11 @@ int srt::CUDTUnited::groupConnect(CUDTGroup* pg, SRT_SOCKGROUPCONFIG* targets, i
             else
             {
                 targets[tii].id = CUDT::INVALID_SOCK;
-                delete ns;
-                m_Sockets.erase(sid);
+                // Not deleted here, as it may be still in use by a thread that
+                // has found it in the index. The GC deletes it, as a closed one.
+                ns->setClosed();
+                unmapSocket_LOCKED(sid);
+                m_ClosedSockets[sid] = ns;
 
                 // If failed to set options, then do not continue
                 // neither with binding, nor with connecting.
@@ -1553,9 +1608,10 @@ int srt::CUDTUnited::groupConnect(CUDTGroup* pg, SRT_SOCKGROUPCONFIG* targets, i
 
             ScopedLock cl(m_GlobControlLock);
             ns->removeFromGroup(false);
-            m_Sockets.erase(ns->m_SocketID);
-            // Intercept to delete the socket on failure.
-            delete ns;
+            // Leave the socket to the GC to delete (see above).
+            ns->setClosed();
+            unmapSocket_LOCKED(sid);
+            m_ClosedSockets[sid] = ns;
             continue;
         }
         catch (...)
@@ -1565,9 +1621,10 @@ int srt::CUDTUnited::groupConnect(CUDTGroup* pg, SRT_SOCKGROUPCONFIG* targets, i
             targets[tii].id        = CUDT::INVALID_SOCK;
             ScopedLock cl(m_GlobControlLock);
             ns->removeFromGroup(false);
-            m_Sockets.erase(ns->m_SocketID);
-            // Intercept to delete the socket on failure.
-            delete ns;
+            // Leave the socket to the GC to delete (see above).
+            ns->setClosed();
+            unmapSocket_LOCKED(sid);
+            m_ClosedSockets[sid] = ns;
 
             // Do not use original exception, it may crash off a C API.
             throw CUDTException(MJ_SYSTEMRES, MN_OBJECT);
@@ -1932,6 +1989,7 @@ void srt::CUDTUnited::deleteGroup_LOCKED(CUDTGroup* g)
     // After that the group is no longer findable by GroupKeeper
     m_Groups.erase(g->m_GroupID);
     m_ClosedGroups[g->m_GroupID] = g;
+    scheduleGC(g->m_GroupID);
 
     // Paranoid check: since the group is in m_ClosedGroups
     // it may potentially be deleted. Make sure no socket points
@@ -1965,9 +2023,9 @@ void srt::CUDTUnited::deleteGroup_LOCKED(CUDTGroup* g)
 
 int srt::CUDTUnited::close(CUDTSocket* s)
 {
-    HLOGC(smlog.Debug, log << s->core().CONID() << "CLOSE. Acquiring control lock");
+    HSLOGC(smlog.Debug, s->m_SocketID, log << s->core().CONID() << "CLOSE. Acquiring control lock");
     ScopedLock socket_cg(s->m_ControlLock);
-    HLOGC(smlog.Debug, log << s->core().CONID() << "CLOSING (removing from listening, closing CUDT)");
+    HSLOGC(smlog.Debug, s->m_SocketID, log << s->core().CONID() << "CLOSING (removing from listening, closing CUDT)");
 
     const bool synch_close_snd = s->core().m_config.bSynSending;
 
@@ -1990,7 +2048,7 @@ int srt::CUDTUnited::close(CUDTSocket* s)
         // be unable to bind to this port that the about-to-delete listener
         // is currently occupying (due to blocked slot in the RcvQueue).
 
-        HLOGC(smlog.Debug, log << s->core().CONID() << "CLOSING (removing listener immediately)");
+        HSLOGC(smlog.Debug, s->m_SocketID, log << s->core().CONID() << "CLOSING (removing listener immediately)");
         s->core().notListening();
         s->m_Status = SRTS_CLOSING;
 
@@ -2040,7 +2098,7 @@ int srt::CUDTUnited::close(CUDTSocket* s)
         }
 #endif
 
-        m_Sockets.erase(s->m_SocketID);
+        unmapSocket_LOCKED(s->m_SocketID);
         m_ClosedSockets[s->m_SocketID] = s;
         HLOGC(smlog.Debug, log << "@" << u << "U::close: Socket MOVED TO CLOSED for collecting later.");
 
@@ -2122,7 +2180,7 @@ int srt::CUDTUnited::close(CUDTSocket* s)
     ...
     }
     */
-    CSync::notify_one_relaxed(m_GCStopCond);
+    scheduleGC(u);
 
     return 0;
 }
@@ -2484,9 +2542,12 @@ int srt::CUDTUnited::epoll_release(const int eid)
 
 srt::CUDTSocket* srt::CUDTUnited::locateSocket(const SRTSOCKET u, ErrorHandling erh)
 {
-    ScopedLock  cg(m_GlobControlLock);
-    CUDTSocket* s = locateSocket_LOCKED(u);
-    if (!s)
+    // No need to lock m_GlobControlLock here. The socket is removed from
+    // the index at the same time as from m_Sockets, and the object is not
+    // deleted earlier than 1 second after that, so the returned pointer
+    // is as valid as it would be if taken from m_Sockets.
+    CUDTSocket* s = m_SocketIndex.find(u);
+    if (!s || s->m_Status == SRTS_CLOSED)
     {
         if (erh == ERH_RETURN)
             return NULL;
@@ -2496,6 +2557,20 @@ srt::CUDTSocket* srt::CUDTUnited::locateSocket(const SRTSOCKET u, ErrorHandling
     return s;
 }
 
+// [[using locked(m_GlobControlLock)]];
+void srt::CUDTUnited::mapSocket_LOCKED(CUDTSocket* s)
+{
+    m_Sockets[s->m_SocketID] = s;
+    m_SocketIndex.insert(s->m_SocketID, s);
+}
+
+// [[using locked(m_GlobControlLock)]];
+void srt::CUDTUnited::unmapSocket_LOCKED(SRTSOCKET id)
+{
+    m_SocketIndex.erase(id);
+    m_Sockets.erase(id);
+}
+
 // [[using locked(m_GlobControlLock)]];
 srt::CUDTSocket* srt::CUDTUnited::locateSocket_LOCKED(SRTSOCKET u)
 {
@@ -2565,6 +2640,223 @@ srt::CUDTSocket* srt::CUDTUnited::locatePeer(const sockaddr_any& peer, const SRT
     return NULL;
 }
 
+void srt::CUDTUnited::scheduleGC(SRTSOCKET id, const steady_clock::time_point& when)
+{
+    ScopedLock gclock(m_GCStopLock);
+
+    std::map<SRTSOCKET, steady_clock::time_point>::iterator d = m_GCDeadlines.find(id);
+    if (d != m_GCDeadlines.end())
+    {
+        if (d->second <= when)
+            return;
+        m_GCQueue.erase(std::make_pair(d->second, id));
+        d->second = when;
+    }
+    else
+    {
+        m_GCDeadlines[id] = when;
+    }
+
+    // Wake up the GC thread only if it has to check earlier than it sleeps.
+    const bool earliest = m_GCQueue.empty() || when < m_GCQueue.begin()->first;
+    m_GCQueue.insert(std::make_pair(when, id));
+    if (earliest)
+        m_GCStopCond.notify_one();
+}
+
+void srt::CUDTUnited::checkScheduledSockets(const vector<SRTSOCKET>& ids)
+{
+    ScopedLock cg(m_GlobControlLock);
+
+    for (vector<SRTSOCKET>::const_iterator i = ids.begin(); i != ids.end(); ++i)
+    {
+        const SRTSOCKET id = *i;
+        const steady_clock::time_point now = steady_clock::now();
+        steady_clock::time_point next;
+
+#if ENABLE_BONDING
+        if (id & SRTGROUP_MASK)
+        {
+            groups_t::iterator g = m_ClosedGroups.find(id);
+            if (g == m_ClosedGroups.end())
+                continue;
+
+            // See the comment in checkBrokenSockets().
+            if (g->second->isStillBusy())
+            {
+                scheduleGC(id, now + milliseconds_from(GC_RECHECK_PERIOD_MS));
+                continue;
+            }
+
+            HLOGC(smlog.Debug, log << "checkScheduledSockets: deleting closed group $" << id);
+            delete g->second;
+            m_ClosedGroups.erase(g);
+            continue;
+        }
+#endif
+
+        sockets_t::iterator s = m_Sockets.find(id);
+        if (s != m_Sockets.end())
+        {
+            if (!checkBrokenSocket_LOCKED(s->second, now, (next)))
+            {
+                // Not broken sockets are no longer interesting for GC.
+                if (!is_zero(next))
+                    scheduleGC(id, next);
+                continue;
+            }
+
+            moveBrokenToClosed_LOCKED(s->second);
+            unmapSocket_LOCKED(id);
+        }
+
+        s = m_ClosedSockets.find(id);
+        if (s == m_ClosedSockets.end())
+            continue;
+
+        if (checkClosedSocket_LOCKED(s->second, now, (next)))
+        {
+            removeSocket(id);
+            if (m_ClosedSockets.count(id) == 0)
+                continue;
+
+            // Still used by the sender or receiver queue.
+            next = now + milliseconds_from(GC_RECHECK_PERIOD_MS);
+        }
+        scheduleGC(id, next);
+    }
+}
+
+// [[using locked(m_GlobControlLock)]]
+bool srt::CUDTUnited::checkBrokenSocket_LOCKED(CUDTSocket* s, const steady_clock::time_point& now, steady_clock::time_point& w_next)
+{
+    w_next = steady_clock::time_point();
+    if (!s->core().m_bBroken)
+        return false;
+
+    if (s->m_Status == SRTS_LISTENING)
+    {
+        // A listening socket should wait an extra 3 seconds
+        // in case a client is connecting.
+        const steady_clock::time_point closing_time =
+            s->m_tsClosureTimeStamp + milliseconds_from(CUDT::COMM_CLOSE_BROKEN_LISTENER_TIMEOUT_MS);
+        if (now < closing_time)
+        {
+            w_next = closing_time;
+            return false;
+        }
+        return true;
+    }
+
+    CUDT& u = s->core();
+
+    // A member of a redundant group stores packets that the other members
+    // don't (see CUDTGroup::rcvIndexPacket()), possibly behind the positions
+    // of those, so it's kept while it stores any.
+#if ENABLE_BONDING
+    const bool group_held = s->m_GroupOf && s->m_GroupOf->rcvDeduplicates();
+#else
+    const bool group_held = false;
+#endif
+    enterCS(u.m_RcvBufferLock);
+    bool has_avail_packets = u.m_pRcvBuffer
+        && (group_held ? u.m_pRcvBuffer->getFirstValidPacketInfo().seqno != SRT_SEQNO_NONE
+                       : u.m_pRcvBuffer->hasAvailablePackets());
+    leaveCS(u.m_RcvBufferLock);
+
+    if (has_avail_packets)
+    {
+        const int bc = u.m_iBrokenCounter.load();
+        if (bc > 0)
+        {
+            // if there is still data in the receiver buffer, wait longer
+            // (reading it out empty makes the check earlier)
+            u.m_iBrokenCounter.store(bc - 1);
+            w_next = now + seconds_from(1);
+            return false;
+        }
+    }
+    return true;
+}
+
+// [[using locked(m_GlobControlLock)]]
+void srt::CUDTUnited::moveBrokenToClosed_LOCKED(CUDTSocket* s)
+{
+#if ENABLE_BONDING
+    if (s->m_GroupOf)
+    {
+        HLOGC(smlog.Debug,
+             log << "@" << s->m_SocketID << " IS MEMBER OF $" << s->m_GroupOf->id() << " - REMOVING FROM GROUP");
+        s->removeFromGroup(true);
+    }
+#endif
+
+    HLOGC(smlog.Debug, log << "checkBrokenSockets: moving BROKEN socket to CLOSED: @" << s->m_SocketID);
+
+    // close broken connections and start removal timer
+    s->setClosed();
+    m_ClosedSockets[s->m_SocketID] = s;
+
+    // remove from listener's queue
+    sockets_t::iterator ls = m_Sockets.find(s->m_ListenSocket);
+    if (ls == m_Sockets.end())
+    {
+        ls = m_ClosedSockets.find(s->m_ListenSocket);
+        if (ls == m_ClosedSockets.end())
+            return;
+    }
+
+    enterCS(ls->second->m_AcceptLock);
+    ls->second->m_QueuedSockets.erase(s->m_SocketID);
+    leaveCS(ls->second->m_AcceptLock);
+}
+
+// [[using locked(m_GlobControlLock)]]
+bool srt::CUDTUnited::checkClosedSocket_LOCKED(CUDTSocket* s, const steady_clock::time_point& now, steady_clock::time_point& w_next)
+{
+    CUDT& u = s->core();
+
+    if (!is_zero(u.m_tsLingerExpiration))
+    {
+        // asynchronous close:
+        if ((!u.m_pSndBuffer) || (0 == u.m_pSndBuffer->getCurrBufSize()) ||
+            (u.m_tsLingerExpiration <= now) || u.m_bBroken)
+        {
+            HLOGC(smlog.Debug, log << "checkBrokenSockets: marking CLOSED qualified @" << s->m_SocketID);
+            u.m_tsLingerExpiration = steady_clock::time_point();
+            u.m_bClosing           = true;
+            s->m_tsClosureTimeStamp = now;
+        }
+        else
+        {
+            // Emptying the sender buffer is reported by the ACK processing.
+            w_next = std::min(u.m_tsLingerExpiration, now + milliseconds_from(GC_RECHECK_PERIOD_MS));
+            return false;
+        }
+    }
+
+    // timeout 1 second to destroy a socket AND it has been removed from
+    // RcvUList
+    const steady_clock::time_point remove_time = s->m_tsClosureTimeStamp + seconds_from(1);
+    if (now < remove_time)
+    {
+        w_next = remove_time;
+        return false;
+    }
+
+    CRNode* rnode = u.m_pRNode;
+    if (rnode && rnode->m_bOnList)
+    {
+        w_next = now + milliseconds_from(GC_RECHECK_PERIOD_MS);
+        return false;
+    }
+
+    HLOGC(smlog.Debug,
+          log << "checkBrokenSockets: @" << s->m_SocketID << " closed "
+              << FormatDuration(now - s->m_tsClosureTimeStamp) << " ago and removed from RcvQ - will remove");
+    return true;
+}
+
 void srt::CUDTUnited::checkBrokenSockets()
 {
     ScopedLock cg(m_GlobControlLock);
@@ -2598,112 +2890,27 @@ void srt::CUDTUnited::checkBrokenSockets()
     // set of sockets To Be Closed and To Be Removed
     vector<SRTSOCKET> tbc;
     vector<SRTSOCKET> tbr;
+    const steady_clock::time_point now = steady_clock::now();
+    steady_clock::time_point next;
 
     for (sockets_t::iterator i = m_Sockets.begin(); i != m_Sockets.end(); ++i)
     {
-        CUDTSocket* s = i->second;
-        if (!s->core().m_bBroken)
+        if (!checkBrokenSocket_LOCKED(i->second, now, (next)))
             continue;
 
-        if (s->m_Status == SRTS_LISTENING)
-        {
-            const steady_clock::duration elapsed = steady_clock::now() - s->m_tsClosureTimeStamp;
-            // A listening socket should wait an extra 3 seconds
-            // in case a client is connecting.
-            if (elapsed < milliseconds_from(CUDT::COMM_CLOSE_BROKEN_LISTENER_TIMEOUT_MS))
-                continue;
-        }
-        else
-        {
-            CUDT& u = s->core();
-
-            enterCS(u.m_RcvBufferLock);
-            bool has_avail_packets = u.m_pRcvBuffer && u.m_pRcvBuffer->hasAvailablePackets();
-            leaveCS(u.m_RcvBufferLock);
-
-            if (has_avail_packets)
-            {
-                const int bc = u.m_iBrokenCounter.load();
-                if (bc > 0)
-                {
-                    // if there is still data in the receiver buffer, wait longer
-                    s->core().m_iBrokenCounter.store(bc - 1);
-                    continue;
-                }
-            }
-        }
-
-#if ENABLE_BONDING
-        if (s->m_GroupOf)
-        {
-            HLOGC(smlog.Debug,
-                 log << "@" << s->m_SocketID << " IS MEMBER OF $" << s->m_GroupOf->id() << " - REMOVING FROM GROUP");
-            s->removeFromGroup(true);
-        }
-#endif
-
-        HLOGC(smlog.Debug, log << "checkBrokenSockets: moving BROKEN socket to CLOSED: @" << i->first);
-
-        // close broken connections and start removal timer
-        s->setClosed();
+        moveBrokenToClosed_LOCKED(i->second);
         tbc.push_back(i->first);
-        m_ClosedSockets[i->first] = s;
-
-        // remove from listener's queue
-        sockets_t::iterator ls = m_Sockets.find(s->m_ListenSocket);
-        if (ls == m_Sockets.end())
-        {
-            ls = m_ClosedSockets.find(s->m_ListenSocket);
-            if (ls == m_ClosedSockets.end())
-                continue;
-        }
-
-        enterCS(ls->second->m_AcceptLock);
-        ls->second->m_QueuedSockets.erase(s->m_SocketID);
-        leaveCS(ls->second->m_AcceptLock);
     }
 
     for (sockets_t::iterator j = m_ClosedSockets.begin(); j != m_ClosedSockets.end(); ++j)
     {
-        CUDTSocket* ps = j->second;
-        CUDT& u = ps->core();
-
-        // HLOGC(smlog.Debug, log << "checking CLOSED socket: " << j->first);
-        if (!is_zero(u.m_tsLingerExpiration))
-        {
-            // asynchronous close:
-            if ((!u.m_pSndBuffer) || (0 == u.m_pSndBuffer->getCurrBufSize()) ||
-                (u.m_tsLingerExpiration <= steady_clock::now()))
-            {
-                HLOGC(smlog.Debug, log << "checkBrokenSockets: marking CLOSED qualified @" << ps->m_SocketID);
-                u.m_tsLingerExpiration = steady_clock::time_point();
-                u.m_bClosing           = true;
-                ps->m_tsClosureTimeStamp        = steady_clock::now();
-            }
-        }
-
-        // timeout 1 second to destroy a socket AND it has been removed from
-        // RcvUList
-        const steady_clock::time_point now        = steady_clock::now();
-        const steady_clock::duration   closed_ago = now - ps->m_tsClosureTimeStamp;
-        if (closed_ago > seconds_from(1))
-        {
-            CRNode* rnode = u.m_pRNode;
-            if (!rnode || !rnode->m_bOnList)
-            {
-                HLOGC(smlog.Debug,
-                      log << "checkBrokenSockets: @" << ps->m_SocketID << " closed "
-                          << FormatDuration(closed_ago) << " ago and removed from RcvQ - will remove");
-
-                // HLOGC(smlog.Debug, log << "will unref socket: " << j->first);
-                tbr.push_back(j->first);
-            }
-        }
+        if (checkClosedSocket_LOCKED(j->second, now, (next)))
+            tbr.push_back(j->first);
     }
 
     // move closed sockets to the ClosedSockets structure
     for (vector<SRTSOCKET>::iterator k = tbc.begin(); k != tbc.end(); ++k)
-        m_Sockets.erase(*k);
+        unmapSocket_LOCKED(*k);
 
     // remove those timeout sockets
     for (vector<SRTSOCKET>::iterator l = tbr.begin(); l != tbr.end(); ++l)
@@ -2767,7 +2974,7 @@ void srt::CUDTUnited::removeSocket(const SRTSOCKET u)
 
             as->breakSocket_LOCKED();
             m_ClosedSockets[*q] = as;
-            m_Sockets.erase(*q);
+            unmapSocket_LOCKED(*q);
         }
     }
 
@@ -3175,7 +3382,7 @@ void srt::CUDTUnited::updateMux(CUDTSocket* s, const sockaddr_any& reqaddr, cons
 
         m.m_pTimer    = new CTimer;
         m.m_pSndQueue = new CSndQueue;
-        m.m_pSndQueue->init(m.m_pChannel, m.m_pTimer);
+        m.m_pSndQueue->init(m.m_pChannel, m.m_pTimer, m.m_mcfg.llMuxMaxBW);
         m.m_pRcvQueue = new CRcvQueue;
         m.m_pRcvQueue->init(128, s->core().maxPayloadSize(), m.m_iIPversion, 1024, m.m_pChannel, m.m_pTimer);
 
@@ -3301,12 +3508,41 @@ void* srt::CUDTUnited::garbageCollect(void* p)
     while (!self->m_bClosing)
     {
         INCREMENT_THREAD_ITERATIONS();
-        self->checkBrokenSockets();
 
-        HLOGC(inlog.Debug, log << "GC: sleep 1 s");
-        self->m_GCStopCond.wait_for(gclock, seconds_from(1));
+        // Take all sockets and groups that are due to be checked.
+        vector<SRTSOCKET> due;
+        const steady_clock::time_point now = steady_clock::now();
+        while (!self->m_GCQueue.empty() && self->m_GCQueue.begin()->first <= now)
+        {
+            const SRTSOCKET id = self->m_GCQueue.begin()->second;
+            self->m_GCQueue.erase(self->m_GCQueue.begin());
+            self->m_GCDeadlines.erase(id);
+            due.push_back(id);
+        }
+
+        if (!due.empty())
+        {
+            // The checks may schedule the sockets again.
+            InvertedLock unlock_gc(self->m_GCStopLock);
+            self->checkScheduledSockets(due);
+            continue;
+        }
+
+        if (self->m_GCQueue.empty())
+        {
+            HLOGC(inlog.Debug, log << "GC: nothing scheduled, sleep");
+            self->m_GCStopCond.wait(gclock);
+        }
+        else
+        {
+            HLOGC(inlog.Debug, log << "GC: sleep until the next scheduled check of @" << self->m_GCQueue.begin()->second);
+            self->m_GCStopCond.wait_until(gclock, self->m_GCQueue.begin()->first);
+        }
     }
 
+    // Closing the sockets below schedules them again.
+    gclock.unlock();
+
     // remove all sockets and multiplexers
     HLOGC(inlog.Debug, log << "GC: GLOBAL EXIT - releasing all pending sockets. Acquring control lock...");
 
@@ -3343,6 +3579,7 @@ void* srt::CUDTUnited::garbageCollect(void* p)
             leaveCS(ls->second->m_AcceptLock);
         }
         self->m_Sockets.clear();
+        self->m_SocketIndex.clear();
 
         for (sockets_t::iterator j = self->m_ClosedSockets.begin(); j != self->m_ClosedSockets.end(); ++j)
         {
@@ -3366,6 +3603,11 @@ void* srt::CUDTUnited::garbageCollect(void* p)
         srt::sync::this_thread::sleep_for(milliseconds_from(1));
     }
 
+    enterCS(self->m_GCStopLock);
+    self->m_GCQueue.clear();
+    self->m_GCDeadlines.clear();
+    leaveCS(self->m_GCStopLock);
+
     THREAD_EXIT();
     return NULL;
 }
@@ -3888,6 +4130,53 @@ int srt::CUDT::sendmsg2(SRTSOCKET u, const char* buf, int len, SRT_MSGCTRL& w_m)
     }
 }
 
+int srt::CUDT::sendmsg2_nocopy(SRTSOCKET u, const char* buf, int len, SRT_MSGCTRL& w_m,
+                               CSndPayload::release_fn* relfn, void* opaque)
+{
+    // The release function is called exactly once, whatever the result:
+    // either here, when nothing refers to the payload anymore, or later
+    // when the last packet referring to it has been acknowledged or dropped.
+    CSndPayload* payload = NULL;
+    int          ret     = SRT_ERROR;
+    try
+    {
+        payload = CSndPayload::create(buf, len, relfn, opaque);
+
+#if ENABLE_BONDING
+        if (u & SRTGROUP_MASK)
+        {
+            // Members of broadcast and balancing groups refer to the payload;
+            // backup groups copy the data and the payload is released right after.
+            CUDTUnited::GroupKeeper k(uglobal(), u, CUDTUnited::ERH_THROW);
+            ret = k.group->send(buf, len, (w_m), payload);
+        }
+        else
+#endif
+        {
+            ret = uglobal().locateSocket(u, CUDTUnited::ERH_THROW)->core().sendmsg2(buf, len, (w_m), payload);
+        }
+    }
+    catch (const CUDTException& e)
+    {
+        ret = APIError(e);
+    }
+    catch (bad_alloc&)
+    {
+        ret = APIError(MJ_SYSTEMRES, MN_MEMORY, 0);
+    }
+    catch (const std::exception& ee)
+    {
+        LOGC(aclog.Fatal, log << "sendmsg: UNEXPECTED EXCEPTION: " << typeid(ee).name() << ": " << ee.what());
+        ret = APIError(MJ_UNKNOWN, MN_NONE, 0);
+    }
+
+    if (payload)
+        payload->release();
+    else if (relfn)
+        relfn(opaque, buf, len);
+    return ret;
+}
+
 int srt::CUDT::recv(SRTSOCKET u, char* buf, int len, int)
 {
     SRT_MSGCTRL mctrl = srt_msgctrl_default;
@@ -3928,6 +4217,53 @@ int srt::CUDT::recvmsg2(SRTSOCKET u, char* buf, int len, SRT_MSGCTRL& w_m)
     }
 }
 
+int srt::CUDT::recvmsg2_lend(SRTSOCKET u, SRT_MSGVIEW& w_view, SRT_MSGCTRL& w_m)
+{
+    try
+    {
+        // Groups read from several member buffers; lending is not supported.
+        if (u & SRTGROUP_MASK)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+        CUnit*    unit = NULL;
+        const int res  = uglobal().locateSocket(u, CUDTUnited::ERH_THROW)->core().lendMessage((w_m), (unit));
+        w_view.data    = unit ? unit->m_Packet.m_pcData : NULL;
+        w_view.len     = unit ? res : 0;
+        w_view.token   = unit;
+        return res;
+    }
+    catch (const CUDTException& e)
+    {
+        return APIError(e);
+    }
+    catch (const std::exception& ee)
+    {
+        LOGC(aclog.Fatal, log << "recvmsg_lend: UNEXPECTED EXCEPTION: " << typeid(ee).name() << ": " << ee.what());
+        return APIError(MJ_UNKNOWN, MN_NONE, 0);
+    }
+}
+
+int srt::CUDT::recvmsg2_release(SRTSOCKET u, SRT_MSGVIEW& w_view)
+{
+    try
+    {
+        uglobal().locateSocket(u, CUDTUnited::ERH_THROW)->core().releaseLentUnit(static_cast<CUnit*>(w_view.token));
+        w_view.data  = NULL;
+        w_view.len   = 0;
+        w_view.token = NULL;
+        return 0;
+    }
+    catch (const CUDTException& e)
+    {
+        return APIError(e);
+    }
+    catch (const std::exception& ee)
+    {
+        LOGC(aclog.Fatal, log << "recvmsg_release: UNEXPECTED EXCEPTION: " << typeid(ee).name() << ": " << ee.what());
+        return APIError(MJ_UNKNOWN, MN_NONE, 0);
+    }
+}
+
 int64_t srt::CUDT::sendfile(SRTSOCKET u, fstream& ifs, int64_t& offset, int64_t size, int block)
 {
     try
@@ -4266,6 +4602,32 @@ int srt::CUDT::bstats(SRTSOCKET u, CBytePerfMon* perf, bool clear, bool instanta
     }
 }
 
+int srt::CUDT::bstatsSnapshot(SRTSOCKET u, CBytePerfMon* perf)
+{
+#if ENABLE_BONDING
+    // Group statistics are few and kept under the group lock;
+    // they are read the regular way, just never cleared.
+    if (u & SRTGROUP_MASK)
+        return groupsockbstats(u, perf, false);
+#endif
+
+    try
+    {
+        CUDT& udt = uglobal().locateSocket(u, CUDTUnited::ERH_THROW)->core();
+        udt.bstatsSnapshot(perf);
+        return 0;
+    }
+    catch (const CUDTException& e)
+    {
+        return APIError(e);
+    }
+    catch (const std::exception& ee)
+    {
+        LOGC(aclog.Fatal, log << "bstats_snapshot: UNEXPECTED EXCEPTION: " << typeid(ee).name() << ": " << ee.what());
+        return APIError(MJ_UNKNOWN, MN_NONE, 0);
+    }
+}
+
 #if ENABLE_BONDING
 int srt::CUDT::groupsockbstats(SRTSOCKET u, CBytePerfMon* perf, bool clear)
 {
@@ -4702,9 +5064,27 @@ void setloghandler(void* opaque, SRT_LOG_HANDLER_FN* handler)
 }
 
 void setlogflags(int flags)
+{
+    {
+        ScopedLock gg(srt_logger_config.mutex);
+        srt_logger_config.flags = flags;
+    }
+    // Outside the lock: turning it off waits for the pending lines to be delivered.
+    srt_logger_config.setAsync((flags & SRT_LOGF_ASYNC) || srt_logging::LogBinaryFileActive());
+}
+
+void setlogsocket(SRTSOCKET u, LogLevel::type ll)
 {
     ScopedLock gg(srt_logger_config.mutex);
-    srt_logger_config.flags = flags;
+    srt_logger_config.sock_filter = u;
+    srt_logger_config.sock_level  = ll;
+}
+
+bool setlogbinfile(const char* path)
+{
+    const bool ok = srt_logging::SetLogBinaryFile(path);
+    srt_logger_config.setAsync((srt_logger_config.flags & SRT_LOGF_ASYNC) || srt_logging::LogBinaryFileActive());
+    return ok;
 }
 
 SRT_API bool setstreamid(SRTSOCKET u, const std::string& sid)
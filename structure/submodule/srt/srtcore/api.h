@@ -54,6 +54,7 @@ modified by
 #define INC_SRT_API_H
 
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
 #include "netinet_any.h"
@@ -64,6 +65,7 @@ modified by
 #include "epoll.h"
 #include "handshake.h"
 #include "core.h"
+#include "pool.h"
 #if ENABLE_BONDING
 #include "group.h"
 #endif
@@ -123,14 +125,18 @@ public:
 
     void construct();
 
+    // The memory of deleted sockets is reused through CObjectPool.
+    static void* operator new(size_t size) { return CObjectPool::allocate(size); }
+    static void operator delete(void* ptr, size_t size) { CObjectPool::release(ptr, size); }
+
     SRT_ATTR_GUARDED_BY(m_ControlLock)
     sync::atomic<SRT_SOCKSTATUS> m_Status; //< current socket state
 
     /// Time when the socket is closed.
     /// When the socket is closed, it is not removed immediately from the list
     /// of sockets in order to prevent other methods from accessing invalid address.
-    /// A timer is started and the socket will be removed after approximately
-    /// 1 second (see CUDTUnited::checkBrokenSockets()).
+    /// A timer is started and the socket will be removed after
+    /// 1 second (see CUDTUnited::checkClosedSocket_LOCKED()).
     sync::steady_clock::time_point m_tsClosureTimeStamp;
 
     sockaddr_any m_SelfAddr; //< local address of the socket
@@ -220,6 +226,49 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Sharded lookup index of the active sockets.
+///
+/// This mirrors the contents of CUDTUnited::m_Sockets and is used by the
+/// API functions that only need to find a socket by its ID. Every shard
+/// has its own lock, so threads operating on different sockets do not
+/// contend on m_GlobControlLock. The index is only modified together with
+/// m_Sockets under m_GlobControlLock, so a socket found here has the same
+/// lifetime guarantees as one found in m_Sockets: after it's unmapped it
+/// stays in m_ClosedSockets for at least 1 second before being deleted.
+class CSocketIndex
+{
+public:
+    static const size_t NSHARDS = 64; // must be a power of 2
+
+    CSocketIndex();
+
+    void        insert(SRTSOCKET id, CUDTSocket* s);
+    void        erase(SRTSOCKET id);
+    CUDTSocket* find(SRTSOCKET id) const;
+    void        clear();
+
+private:
+    struct Shard
+    {
+        mutable sync::Mutex              lock;
+        std::map<SRTSOCKET, CUDTSocket*> sockets;
+
+        // Keep the locks of neighbor shards on different cache lines.
+        char pad[64];
+    };
+
+    Shard&       shard(SRTSOCKET id) { return m_Shards[size_t(id) & (NSHARDS - 1)]; }
+    const Shard& shard(SRTSOCKET id) const { return m_Shards[size_t(id) & (NSHARDS - 1)]; }
+
+    Shard m_Shards[NSHARDS];
+
+private:
+    CSocketIndex(const CSocketIndex&);
+    CSocketIndex& operator=(const CSocketIndex&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 class CUDTUnited
 {
     friend class CUDT;
@@ -256,6 +305,13 @@ public:
     /// @return The new UDT socket ID, or INVALID_SOCK.
     SRTSOCKET newSocket(CUDTSocket** pps = NULL);
 
+    /// Makes the GC thread check a broken or closed socket, or a closed group,
+    /// at the given time, or as soon as possible if no time is given. If the
+    /// socket is already scheduled for a later check, this makes it earlier.
+    /// @param id socket or group ID
+    /// @param when time of the check
+    void scheduleGC(SRTSOCKET id, const sync::steady_clock::time_point& when = sync::steady_clock::time_point());
+
     /// Create (listener-side) a new socket associated with the incoming connection request.
     /// @param [in] listen the listening socket ID.
     /// @param [in] peer peer address.
@@ -359,6 +415,7 @@ public:
 #endif
 
     CEPoll& epoll_ref() { return m_EPoll; }
+    CKekCache& kekcache_ref() { return m_KekCache; }
 
 private:
     /// Generates a new socket ID. This function starts from a randomly
@@ -386,6 +443,12 @@ private:
 private:
     typedef std::map<SRTSOCKET, CUDTSocket*> sockets_t; // stores all the socket structures
     sockets_t                                m_Sockets;
+    CSocketIndex                             m_SocketIndex; // lock-sharded copy of m_Sockets for lookups
+
+    // [[using locked(m_GlobControlLock)]]
+    // Both functions keep m_Sockets and m_SocketIndex in sync.
+    void mapSocket_LOCKED(CUDTSocket* s);
+    void unmapSocket_LOCKED(SRTSOCKET id);
 
 #if ENABLE_BONDING
     typedef std::map<SRTSOCKET, CUDTGroup*> groups_t;
@@ -428,6 +491,17 @@ private:
         // existence until it exits.
         GroupKeeper(CUDTUnited& glob, CUDTSocket* s) { group = glob.acquireSocketsGroup(s); }
 
+        // This is intended for the receiver worker that acquires the group
+        // only for member sockets, in a section already under m_GlobControlLock.
+        GroupKeeper(): group(NULL) {}
+
+        // [[using locked(m_GlobControlLock)]]
+        void acquire(CUDTGroup* g)
+        {
+            g->apiAcquire();
+            group = g;
+        }
+
         ~GroupKeeper()
         {
             if (group)
@@ -471,6 +545,18 @@ private:
     sync::Mutex             m_GCStopLock;
     sync::Condition         m_GCStopCond;
 
+    // Sockets and groups for the GC thread to check, in the order of time.
+    // Each ID is there only once, with its time also in m_GCDeadlines.
+    typedef std::set<std::pair<sync::steady_clock::time_point, SRTSOCKET> > gc_queue_t;
+    gc_queue_t                                          m_GCQueue;     // [[protected_by(m_GCStopLock)]]
+    std::map<SRTSOCKET, sync::steady_clock::time_point> m_GCDeadlines; // [[protected_by(m_GCStopLock)]]
+
+    // Period of checking the conditions that have no event of their own
+    // (the socket removed from the queues of the multiplexer, the group no
+    // longer used by the API). It also limits the delay of a lingering
+    // socket, should the event of its sender buffer emptied be missed.
+    static const int GC_RECHECK_PERIOD_MS = 100;
+
     sync::Mutex m_InitLock;
     int         m_iInstanceCount; // number of startup() called by application
     bool        m_bGCStatus;      // if the GC thread is working (true)
@@ -484,10 +570,18 @@ private:
 #endif
 
     void checkBrokenSockets();
+    void checkScheduledSockets(const std::vector<SRTSOCKET>& ids);
+    bool checkBrokenSocket_LOCKED(CUDTSocket* s, const sync::steady_clock::time_point& now, sync::steady_clock::time_point& w_next);
+    void moveBrokenToClosed_LOCKED(CUDTSocket* s);
+    bool checkClosedSocket_LOCKED(CUDTSocket* s, const sync::steady_clock::time_point& now, sync::steady_clock::time_point& w_next);
     void removeSocket(const SRTSOCKET u);
 
     CEPoll m_EPoll; // handling epoll data structures and events
 
+    CCryptoWorkerPool m_CryptoWorkers; // encryption ahead of sending (SRTO_CRYPTOWORKERS)
+    CKekCache m_KekCache;              // passphrase-derived keys (PBKDF2)
+    CTsbPdScheduler m_TsbPdScheduler;  // shared TSBPD threads (SRTO_TSBPDWORKERS)
+
 private:
     CUDTUnited(const CUDTUnited&);
     CUDTUnited& operator=(const CUDTUnited&);
@@ -266,6 +266,68 @@ public:
 #endif
   }
 
+  /// @brief Loads the value with no ordering of the other memory accesses.
+  T load_relaxed() const {
+#if defined(ATOMIC_USE_SRT_SYNC_MUTEX) && (ATOMIC_USE_SRT_SYNC_MUTEX == 1)
+    return load();
+#elif defined(ATOMIC_USE_GCC_INTRINSICS)
+    return __atomic_load_n(&value_, __ATOMIC_RELAXED);
+#elif defined(ATOMIC_USE_MSVC_INTRINSICS)
+    return value_;
+#elif defined(ATOMIC_USE_CPP11_ATOMIC)
+    return value_.load(std::memory_order_relaxed);
+#else
+    #error "Implement Me."
+#endif
+  }
+
+  /// @brief Stores the value with no ordering of the other memory accesses.
+  void store_relaxed(const T new_val) {
+#if defined(ATOMIC_USE_SRT_SYNC_MUTEX) && (ATOMIC_USE_SRT_SYNC_MUTEX == 1)
+    store(new_val);
+#elif defined(ATOMIC_USE_GCC_INTRINSICS)
+    __atomic_store_n(&value_, new_val, __ATOMIC_RELAXED);
+#elif defined(ATOMIC_USE_MSVC_INTRINSICS)
+    value_ = new_val;
+#elif defined(ATOMIC_USE_CPP11_ATOMIC)
+    value_.store(new_val, std::memory_order_relaxed);
+#else
+    #error "Implement Me."
+#endif
+  }
+
+  /// @brief Loads the value; the memory accesses following it can't be
+  /// reordered before it.
+  T load_acquire() const {
+#if defined(ATOMIC_USE_SRT_SYNC_MUTEX) && (ATOMIC_USE_SRT_SYNC_MUTEX == 1)
+    return load();
+#elif defined(ATOMIC_USE_GCC_INTRINSICS)
+    return __atomic_load_n(&value_, __ATOMIC_ACQUIRE);
+#elif defined(ATOMIC_USE_MSVC_INTRINSICS)
+    return load();
+#elif defined(ATOMIC_USE_CPP11_ATOMIC)
+    return value_.load(std::memory_order_acquire);
+#else
+    #error "Implement Me."
+#endif
+  }
+
+  /// @brief Stores the value; the memory accesses preceding it can't be
+  /// reordered after it.
+  void store_release(const T new_val) {
+#if defined(ATOMIC_USE_SRT_SYNC_MUTEX) && (ATOMIC_USE_SRT_SYNC_MUTEX == 1)
+    store(new_val);
+#elif defined(ATOMIC_USE_GCC_INTRINSICS)
+    __atomic_store_n(&value_, new_val, __ATOMIC_RELEASE);
+#elif defined(ATOMIC_USE_MSVC_INTRINSICS)
+    store(new_val);
+#elif defined(ATOMIC_USE_CPP11_ATOMIC)
+    value_.store(new_val, std::memory_order_release);
+#else
+    #error "Implement Me."
+#endif
+  }
+
   /// @brief Performs an atomic exchange operation.
   ///
   /// The value of the atomic object is unconditionally updated to the new
@@ -316,6 +378,41 @@ private:
   ATOMIC_DISALLOW_COPY(atomic)
 };
 
+/// @brief The loads preceding the fence can't be reordered with the
+/// memory accesses following it.
+inline void atomic_fence_acquire() {
+#if defined(ATOMIC_USE_SRT_SYNC_MUTEX) && (ATOMIC_USE_SRT_SYNC_MUTEX == 1)
+  // Every access to an atomic object is locked.
+#elif defined(ATOMIC_USE_GCC_INTRINSICS)
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#elif defined(ATOMIC_USE_MSVC_INTRINSICS)
+  // The interlocked functions are full barriers.
+  long volatile fence = 0;
+  (void)msvc::interlocked<long>::exchange(&fence, 0);
+#elif defined(ATOMIC_USE_CPP11_ATOMIC)
+  std::atomic_thread_fence(std::memory_order_acquire);
+#else
+  #error "Implement Me."
+#endif
+}
+
+/// @brief The stores following the fence can't be reordered with the
+/// memory accesses preceding it.
+inline void atomic_fence_release() {
+#if defined(ATOMIC_USE_SRT_SYNC_MUTEX) && (ATOMIC_USE_SRT_SYNC_MUTEX == 1)
+  // Every access to an atomic object is locked.
+#elif defined(ATOMIC_USE_GCC_INTRINSICS)
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+#elif defined(ATOMIC_USE_MSVC_INTRINSICS)
+  long volatile fence = 0;
+  (void)msvc::interlocked<long>::exchange(&fence, 0);
+#elif defined(ATOMIC_USE_CPP11_ATOMIC)
+  std::atomic_thread_fence(std::memory_order_release);
+#else
+  #error "Implement Me."
+#endif
+}
+
 }  // namespace sync
 }  // namespace srt
 
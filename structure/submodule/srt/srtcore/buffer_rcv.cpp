@@ -45,6 +45,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cmath>
 #include <limits>
+#include <new>
 #include "buffer_rcv.h"
 #include "logging.h"
 
@@ -128,6 +129,7 @@ CRcvBuffer::CRcvBuffer(int initSeqNo, size_t size, CUnitQueue* unitqueue, bool b
     , m_iFirstReadableOutOfOrder(-1)
     , m_bPeerRexmitFlag(true)
     , m_bMessageAPI(bMessageAPI)
+    , m_tsLastRelease(steady_clock::now())
     , m_iBytesCount(0)
     , m_iPktsCount(0)
     , m_uAvgPayloadSz(0)
@@ -138,14 +140,25 @@ CRcvBuffer::CRcvBuffer(int initSeqNo, size_t size, CUnitQueue* unitqueue, bool b
 CRcvBuffer::~CRcvBuffer()
 {
     // Can be optimized by only iterating m_iMaxPosOff from m_iStartPos.
-    for (FixedArray<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    for (size_t c = 0; c < m_entries.chunks(); ++c)
     {
-        if (!it->pUnit)
+        Entry* chunk = m_entries.chunk(c);
+        if (!chunk)
             continue;
-        
-        m_pUnitQueue->makeUnitFree(it->pUnit);
-        it->pUnit = NULL;
+
+        for (Entry* it = chunk; it != chunk + Entries::CHUNK_SIZE; ++it)
+        {
+            if (!it->pUnit)
+                continue;
+
+            m_pUnitQueue->makeUnitFree(it->pUnit);
+            it->pUnit = NULL;
+        }
     }
+
+    // Units still lent to the application are invalidated here.
+    for (std::set<CUnit*>::iterator it = m_lentUnits.begin(); it != m_lentUnits.end(); ++it)
+        m_pUnitQueue->makeUnitFree(*it);
 }
 
 int CRcvBuffer::insert(CUnit* unit)
@@ -181,16 +194,29 @@ int CRcvBuffer::insert(CUnit* unit)
 
     // Packet already exists
     SRT_ASSERT(pos >= 0 && pos < int(m_szSize));
-    if (m_entries[pos].status != EntryState_Empty)
+    if (entryAt(pos).status != EntryState_Empty)
     {
         IF_RCVBUF_DEBUG(scoped_log.ss << " returns -1");
         return -1;
     }
-    SRT_ASSERT(m_entries[pos].pUnit == NULL);
+    SRT_ASSERT(entryAt(pos).pUnit == NULL);
+
+    Entry* entry = NULL;
+    try
+    {
+        entry = &m_entries.allocate(pos);
+    }
+    catch (const std::bad_alloc&)
+    {
+        // No memory for the entries is the same as no space in the buffer.
+        LOGC(rbuflog.Error, log << "CRcvBuffer::insert: failed to allocate the entries, dropping %" << seqno);
+        IF_RCVBUF_DEBUG(scoped_log.ss << " returns -3");
+        return -3;
+    }
 
     m_pUnitQueue->makeUnitTaken(unit);
-    m_entries[pos].pUnit  = unit;
-    m_entries[pos].status = EntryState_Avail;
+    entry->pUnit  = unit;
+    entry->status = EntryState_Avail;
     countBytes(1, (int)unit->m_Packet.getLength());
 
     // If packet "in order" flag is zero, it can be read out of order.
@@ -226,8 +252,7 @@ int CRcvBuffer::dropUpTo(int32_t seqno)
     while (len > 0)
     {
         dropUnitInPos(m_iStartPos);
-        m_entries[m_iStartPos].status = EntryState_Empty;
-        SRT_ASSERT(m_entries[m_iStartPos].pUnit == NULL && m_entries[m_iStartPos].status == EntryState_Empty);
+        m_entries.clear(m_iStartPos);
         m_iStartPos = incPos(m_iStartPos);
         --len;
     }
@@ -286,10 +311,10 @@ int CRcvBuffer::dropMessage(int32_t seqnolo, int32_t seqnohi, int32_t msgno, Dro
     for (int i = start_pos; i != end_pos; i = incPos(i))
     {
         // Check if the unit was already dropped earlier.
-        if (m_entries[i].status == EntryState_Drop)
+        if (entryAt(i).status == EntryState_Drop)
             continue;
 
-        if (m_entries[i].pUnit)
+        if (entryAt(i).pUnit)
         {
             const PacketBoundary bnd = packetAt(i).getMsgBoundary();
 
@@ -319,7 +344,7 @@ int CRcvBuffer::dropMessage(int32_t seqnolo, int32_t seqnohi, int32_t msgno, Dro
 
         dropUnitInPos(i);
         ++iDropCnt;
-        m_entries[i].status = EntryState_Drop;
+        m_entries.allocate(i).status = EntryState_Drop;
         if (minDroppedOffset == -1)
             minDroppedOffset = offPos(m_iStartPos, i);
     }
@@ -335,7 +360,7 @@ int CRcvBuffer::dropMessage(int32_t seqnolo, int32_t seqnohi, int32_t msgno, Dro
         for (int i = start_pos; i != stop_pos; i = decPos(i))
         {
             // Can't drop if message number is not known.
-            if (!m_entries[i].pUnit) // also dropped earlier.
+            if (!entryAt(i).pUnit) // also dropped earlier.
                 continue;
 
             const PacketBoundary bnd = packetAt(i).getMsgBoundary();
@@ -353,7 +378,7 @@ int CRcvBuffer::dropMessage(int32_t seqnolo, int32_t seqnohi, int32_t msgno, Dro
 
             ++iDropCnt;
             dropUnitInPos(i);
-            m_entries[i].status = EntryState_Drop;
+            m_entries.allocate(i).status = EntryState_Drop;
             // As the search goes backward, i is always earlier than minDroppedOffset.
             minDroppedOffset = offPos(m_iStartPos, i);
 
@@ -382,7 +407,7 @@ int CRcvBuffer::dropMessage(int32_t seqnolo, int32_t seqnohi, int32_t msgno, Dro
     return iDropCnt;
 }
 
-int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl)
+int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl, CUnit** w_lent)
 {
     const bool canReadInOrder = hasReadableInorderPkts();
     if (!canReadInOrder && m_iFirstReadableOutOfOrder < 0)
@@ -396,6 +421,13 @@ int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl)
     IF_RCVBUF_DEBUG(ScopedLog scoped_log);
     IF_RCVBUF_DEBUG(scoped_log.ss << "CRcvBuffer::readMessage. m_iStartSeqNo " << m_iStartSeqNo << " m_iStartPos " << m_iStartPos << " readPos " << readPos);
 
+    // A unit can be lent only if it holds the whole message.
+    if (w_lent && entryAt(readPos).pUnit && (packetAt(readPos).getMsgBoundary() & PB_SOLO) != PB_SOLO)
+    {
+        LOGC(rbuflog.Error, log << "CRcvBuffer.readMessage(): can't lend a message spanning multiple packets.");
+        return -1;
+    }
+
     size_t remain = len;
     char* dst = data;
     int    pkts_read = 0;
@@ -403,8 +435,8 @@ int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl)
     const bool updateStartPos = (readPos == m_iStartPos); // Indicates if the m_iStartPos can be changed
     for (int i = readPos;; i = incPos(i))
     {
-        SRT_ASSERT(m_entries[i].pUnit);
-        if (!m_entries[i].pUnit)
+        SRT_ASSERT(entryAt(i).pUnit);
+        if (!entryAt(i).pUnit)
         {
             LOGC(rbuflog.Error, log << "CRcvBuffer::readMessage(): null packet encountered.");
             break;
@@ -414,11 +446,14 @@ int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl)
         const size_t   pktsize = packet.getLength();
         const int32_t pktseqno = packet.getSeqNo();
 
-        // unitsize can be zero
-        const size_t unitsize = std::min(remain, pktsize);
-        memcpy(dst, packet.m_pcData, unitsize);
-        remain -= unitsize;
-        dst += unitsize;
+        if (!w_lent)
+        {
+            // unitsize can be zero
+            const size_t unitsize = std::min(remain, pktsize);
+            memcpy(dst, packet.m_pcData, unitsize);
+            remain -= unitsize;
+            dst += unitsize;
+        }
 
         ++pkts_read;
         bytes_extracted += (int) pktsize;
@@ -441,7 +476,18 @@ int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl)
         if (msgctrl)
             msgctrl->pktseq = pktseqno;
 
-        releaseUnitInPos(i);
+        if (w_lent)
+        {
+            // Take the unit out of the buffer, but keep it taken in the unit queue.
+            *w_lent = entryAt(i).pUnit;
+            m_lentUnits.insert(*w_lent);
+            m_entries.clear(i);
+        }
+        else
+        {
+            releaseUnitInPos(i);
+        }
+
         if (updateStartPos)
         {
             m_iStartPos = incPos(i);
@@ -452,7 +498,7 @@ int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl)
         else
         {
             // If out of order, only mark it read.
-            m_entries[i].status = EntryState_Read;
+            m_entries.at(i).status = EntryState_Read;
         }
 
         if (pbLast)
@@ -469,8 +515,10 @@ int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl)
 
     if (!isInRange(m_iStartPos, m_iMaxPosOff, m_szSize, m_iFirstNonreadPos))
     {
+        // Filler entries (dropped ones) released past the read packets may
+        // have brought the start to packets that are already readable.
         m_iFirstNonreadPos = m_iStartPos;
-        //updateNonreadPos();
+        updateNonreadPos();
     }
 
     if (!m_tsbpd.isEnabled())
@@ -478,17 +526,26 @@ int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl)
         // incase readable inorder packets are all read out.
         updateFirstReadableOutOfOrder();
 
-    const int bytes_read = int(dst - data);
+    const int bytes_read = w_lent ? bytes_extracted : int(dst - data);
     if (bytes_read < bytes_extracted)
     {
         LOGC(rbuflog.Error, log << "readMessage: small dst buffer, copied only " << bytes_read << "/" << bytes_extracted << " bytes.");
     }
 
-    IF_RCVBUF_DEBUG(scoped_log.ss << " pldi64 " << *reinterpret_cast<uint64_t*>(data));
+    IF_RCVBUF_DEBUG(if (!w_lent) scoped_log.ss << " pldi64 " << *reinterpret_cast<uint64_t*>(data));
 
     return bytes_read;
 }
 
+bool CRcvBuffer::releaseLent(CUnit* unit)
+{
+    if (m_lentUnits.erase(unit) == 0)
+        return false;
+
+    m_pUnitQueue->makeUnitFree(unit);
+    return true;
+}
+
 namespace {
     /// @brief Writes bytes to file stream.
     /// @param data pointer to data to write.
@@ -528,7 +585,7 @@ int CRcvBuffer::readBufferTo(int len, copy_to_dst_f funcCopyToDst, void* arg)
     int rs = len;
     while ((p != end_pos) && (rs > 0))
     {
-        if (!m_entries[p].pUnit)
+        if (!entryAt(p).pUnit)
         {
             p = incPos(p);
             LOGC(rbuflog.Error, log << "readBufferTo: IPE: NULL unit found in file transmission");
@@ -629,22 +686,22 @@ int CRcvBuffer::getTimespan_ms() const
     // if TSBPD is enabled (reading out of order is not allowed).
     // However if decryption of the last packet fails, it may be dropped
     // from the buffer (AES-GCM), and the position will be empty.
-    SRT_ASSERT(m_entries[lastpos].pUnit != NULL || m_entries[lastpos].status == EntryState_Drop);
-    while (m_entries[lastpos].pUnit == NULL && lastpos != m_iStartPos)
+    SRT_ASSERT(entryAt(lastpos).pUnit != NULL || entryAt(lastpos).status == EntryState_Drop);
+    while (entryAt(lastpos).pUnit == NULL && lastpos != m_iStartPos)
     {
         lastpos = decPos(lastpos);
     }
     
-    if (m_entries[lastpos].pUnit == NULL)
+    if (entryAt(lastpos).pUnit == NULL)
         return 0;
 
     int startpos = m_iStartPos;
-    while (m_entries[startpos].pUnit == NULL && startpos != lastpos)
+    while (entryAt(startpos).pUnit == NULL && startpos != lastpos)
     {
         startpos = incPos(startpos);
     }
 
-    if (m_entries[startpos].pUnit == NULL)
+    if (entryAt(startpos).pUnit == NULL)
         return 0;
 
     const steady_clock::time_point startstamp =
@@ -666,21 +723,29 @@ int CRcvBuffer::getRcvDataSize(int& bytes, int& timespan) const
     return m_iPktsCount;
 }
 
+int CRcvBuffer::getRcvDataSizeSnapshot(int& w_bytes, int& w_timespan) const
+{
+    w_bytes = m_iBytesCount;
+    w_timespan = m_iTimespanMs;
+    return m_iPktsCount;
+}
+
 CRcvBuffer::PacketInfo CRcvBuffer::getFirstValidPacketInfo() const
 {
     const int end_pos = incPos(m_iStartPos, m_iMaxPosOff);
     for (int i = m_iStartPos; i != end_pos; i = incPos(i))
     {
         // TODO: Maybe check status?
-        if (!m_entries[i].pUnit)
+        if (!entryAt(i).pUnit)
             continue;
 
         const CPacket& packet = packetAt(i);
-        const PacketInfo info = { packet.getSeqNo(), i != m_iStartPos, getPktTsbPdTime(packet.getMsgTimeStamp()) };
+        const PacketInfo info = { packet.getSeqNo(), i != m_iStartPos, getPktTsbPdTime(packet.getMsgTimeStamp()),
+                                  packet.getMsgSeq(m_bPeerRexmitFlag) };
         return info;
     }
 
-    const PacketInfo info = { -1, false, time_point() };
+    const PacketInfo info = { -1, false, time_point(), SRT_MSGNO_NONE };
     return info;
 }
 
@@ -719,7 +784,7 @@ bool CRcvBuffer::isRcvDataReady(time_point time_now) const
 
 CRcvBuffer::PacketInfo CRcvBuffer::getFirstReadablePacketInfo(time_point time_now) const
 {
-    const PacketInfo unreadableInfo    = {SRT_SEQNO_NONE, false, time_point()};
+    const PacketInfo unreadableInfo    = {SRT_SEQNO_NONE, false, time_point(), SRT_MSGNO_NONE};
     const bool       hasInorderPackets = hasReadableInorderPkts();
 
     if (!m_tsbpd.isEnabled())
@@ -727,7 +792,7 @@ CRcvBuffer::PacketInfo CRcvBuffer::getFirstReadablePacketInfo(time_point time_no
         if (hasInorderPackets)
         {
             const CPacket&   packet = packetAt(m_iStartPos);
-            const PacketInfo info   = {packet.getSeqNo(), false, time_point()};
+            const PacketInfo info   = {packet.getSeqNo(), false, time_point(), packet.getMsgSeq(m_bPeerRexmitFlag)};
             return info;
         }
         SRT_ASSERT((!m_bMessageAPI && m_numOutOfOrderPackets == 0) || m_bMessageAPI);
@@ -735,7 +800,7 @@ CRcvBuffer::PacketInfo CRcvBuffer::getFirstReadablePacketInfo(time_point time_no
         {
             SRT_ASSERT(m_numOutOfOrderPackets > 0);
             const CPacket&   packet = packetAt(m_iFirstReadableOutOfOrder);
-            const PacketInfo info   = {packet.getSeqNo(), true, time_point()};
+            const PacketInfo info   = {packet.getSeqNo(), true, time_point(), packet.getMsgSeq(m_bPeerRexmitFlag)};
             return info;
         }
         return unreadableInfo;
@@ -755,8 +820,9 @@ CRcvBuffer::PacketInfo CRcvBuffer::getFirstReadablePacketInfo(time_point time_no
 void CRcvBuffer::countBytes(int pkts, int bytes)
 {
     ScopedLock lock(m_BytesCountLock);
-    m_iBytesCount += bytes; // added or removed bytes from rcv buffer
-    m_iPktsCount  += pkts;
+    m_iBytesCount = m_iBytesCount + bytes; // added or removed bytes from rcv buffer
+    m_iPktsCount  = m_iPktsCount + pkts;
+    m_iTimespanMs = getTimespan_ms();
     if (bytes > 0)          // Assuming one pkt when adding bytes
     {
         if (!m_uAvgPayloadSz)
@@ -768,15 +834,15 @@ void CRcvBuffer::countBytes(int pkts, int bytes)
 
 void CRcvBuffer::releaseUnitInPos(int pos)
 {
-    CUnit* tmp = m_entries[pos].pUnit;
-    m_entries[pos] = Entry(); // pUnit = NULL; status = Empty
+    CUnit* tmp = entryAt(pos).pUnit;
+    m_entries.clear(pos); // pUnit = NULL; status = Empty
     if (tmp != NULL)
         m_pUnitQueue->makeUnitFree(tmp);
 }
 
 bool CRcvBuffer::dropUnitInPos(int pos)
 {
-    if (!m_entries[pos].pUnit)
+    if (!entryAt(pos).pUnit)
         return false;
     if (m_tsbpd.isEnabled())
     {
@@ -795,7 +861,7 @@ bool CRcvBuffer::dropUnitInPos(int pos)
 void CRcvBuffer::releaseNextFillerEntries()
 {
     int pos = m_iStartPos;
-    while (m_entries[pos].status == EntryState_Read || m_entries[pos].status == EntryState_Drop)
+    while (entryAt(pos).status == EntryState_Read || entryAt(pos).status == EntryState_Drop)
     {
         m_iStartSeqNo = CSeqNo::incseq(m_iStartSeqNo);
         releaseUnitInPos(pos);
@@ -816,14 +882,14 @@ void CRcvBuffer::updateNonreadPos()
     const int end_pos = incPos(m_iStartPos, m_iMaxPosOff); // The empty position right after the last valid entry.
 
     int pos = m_iFirstNonreadPos;
-    while (m_entries[pos].pUnit && m_entries[pos].status == EntryState_Avail)
+    while (entryAt(pos).pUnit && entryAt(pos).status == EntryState_Avail)
     {
         if (m_bMessageAPI && (packetAt(pos).getMsgBoundary() & PB_FIRST) == 0)
             break;
 
         for (int i = pos; i != end_pos; i = incPos(i))
         {
-            if (!m_entries[i].pUnit || m_entries[pos].status != EntryState_Avail)
+            if (!entryAt(i).pUnit || entryAt(pos).status != EntryState_Avail)
             {
                 break;
             }
@@ -836,7 +902,7 @@ void CRcvBuffer::updateNonreadPos()
             }
         }
 
-        if (pos == m_iFirstNonreadPos || !m_entries[m_iFirstNonreadPos].pUnit)
+        if (pos == m_iFirstNonreadPos || !entryAt(m_iFirstNonreadPos).pUnit)
             break;
 
         pos = m_iFirstNonreadPos;
@@ -847,7 +913,7 @@ int CRcvBuffer::findLastMessagePkt()
 {
     for (int i = m_iStartPos; i != m_iFirstNonreadPos; i = incPos(i))
     {
-        SRT_ASSERT(m_entries[i].pUnit);
+        SRT_ASSERT(entryAt(i).pUnit);
 
         if (packetAt(i).getMsgBoundary() & PB_LAST)
         {
@@ -875,7 +941,7 @@ void CRcvBuffer::onInsertNotInOrderPacket(int insertPos)
     // Just a sanity check. This function is called when a new packet is added.
     // So the should be unacknowledged packets.
     SRT_ASSERT(m_iMaxPosOff > 0);
-    SRT_ASSERT(m_entries[insertPos].pUnit);
+    SRT_ASSERT(entryAt(insertPos).pUnit);
     const CPacket& pkt = packetAt(insertPos);
     const PacketBoundary boundary = pkt.getMsgBoundary();
 
@@ -911,7 +977,7 @@ bool CRcvBuffer::checkFirstReadableOutOfOrder()
     int msgno = -1;
     for (int pos = m_iFirstReadableOutOfOrder; pos != endPos; pos = incPos(pos))
     {
-        if (!m_entries[pos].pUnit)
+        if (!entryAt(pos).pUnit)
             return false;
 
         const CPacket& pkt = packetAt(pos);
@@ -951,7 +1017,7 @@ void CRcvBuffer::updateFirstReadableOutOfOrder()
 
     for (int pos = m_iStartPos; outOfOrderPktsRemain; pos = incPos(pos))
     {
-        if (!m_entries[pos].pUnit)
+        if (!entryAt(pos).pUnit)
         {
             posFirst = posLast = msgNo = -1;
             continue;
@@ -1005,7 +1071,7 @@ int CRcvBuffer::scanNotInOrderMessageRight(const int startPos, int msgNo) const
     do
     {
         pos = incPos(pos);
-        if (!m_entries[pos].pUnit)
+        if (!entryAt(pos).pUnit)
             break;
 
         const CPacket& pkt = packetAt(pos);
@@ -1036,7 +1102,7 @@ int CRcvBuffer::scanNotInOrderMessageLeft(const int startPos, int msgNo) const
     {
         pos = decPos(pos);
 
-        if (!m_entries[pos].pUnit)
+        if (!entryAt(pos).pUnit)
             return -1;
 
         const CPacket& pkt = packetAt(pos);
@@ -1107,7 +1173,7 @@ string CRcvBuffer::strFullnessState(int iFirstUnackSeqNo, const time_point& tsNo
         {
             ss << count_milliseconds(nextValidPkt.tsbpd_time - tsNow) << "ms";
             const int iLastPos = incPos(m_iStartPos, m_iMaxPosOff - 1);
-            if (m_entries[iLastPos].pUnit)
+            if (entryAt(iLastPos).pUnit)
             {
                 ss << ", timespan ";
                 const uint32_t usPktTimestamp = packetAt(iLastPos).getMsgTimeStamp();
@@ -1144,6 +1210,91 @@ int CRcvBuffer::getRcvAvgDataSize(int& bytes, int& timespan)
 }
 
 /* Update moving average of acked data pkts, bytes, and timespan (ms) of the receive buffer */
+void CRcvBuffer::releaseUnusedEntries(const steady_clock::time_point& now)
+{
+    if (now - m_tsLastRelease < milliseconds_from(RELEASE_PERIOD_MS))
+        return;
+
+    m_tsLastRelease = now;
+    m_entries.releaseEmpty();
+}
+
+const CRcvBuffer::Entry CRcvBuffer::Entries::s_EmptyEntry;
+
+CRcvBuffer::Entries::Entries(size_t size)
+    : m_aChunks((size + CHUNK_SIZE - 1) / CHUNK_SIZE, (Entry*)NULL)
+    , m_iUsed(0)
+    , m_iMinSpare(0)
+{
+    // Never more chunks are allocated than needed at a time,
+    // so taking them off in releaseEmpty() doesn't allocate.
+    m_aSpare.reserve(m_aChunks.size());
+}
+
+CRcvBuffer::Entries::~Entries()
+{
+    for (size_t i = 0; i < m_aChunks.size(); ++i)
+        freeChunk(m_aChunks[i]);
+    for (size_t i = 0; i < m_aSpare.size(); ++i)
+        freeChunk(m_aSpare[i]);
+}
+
+CRcvBuffer::Entry* CRcvBuffer::Entries::allocateChunk(size_t i)
+{
+    Entry* chunk;
+    if (!m_aSpare.empty())
+    {
+        chunk = m_aSpare.back();
+        m_aSpare.pop_back();
+        m_iMinSpare = std::min(m_iMinSpare, m_aSpare.size());
+    }
+    else
+    {
+        chunk = PoolAllocator<Entry>().allocate(CHUNK_SIZE);
+        for (int e = 0; e < CHUNK_SIZE; ++e)
+            new (chunk + e) Entry();
+    }
+
+    m_aChunks[i] = chunk;
+    ++m_iUsed;
+    return chunk;
+}
+
+void CRcvBuffer::Entries::freeChunk(Entry* chunk)
+{
+    if (chunk)
+        PoolAllocator<Entry>().deallocate(chunk, CHUNK_SIZE);
+}
+
+void CRcvBuffer::Entries::releaseEmpty()
+{
+    // The spare chunks that weren't needed through the whole period.
+    const size_t nfree = m_iMinSpare;
+    for (size_t i = 0; i < nfree; ++i)
+    {
+        freeChunk(m_aSpare.back());
+        m_aSpare.pop_back();
+    }
+
+    for (size_t i = 0; i < m_aChunks.size(); ++i)
+    {
+        Entry* chunk = m_aChunks[i];
+        if (!chunk)
+            continue;
+
+        bool empty = true;
+        for (int e = 0; e < CHUNK_SIZE && empty; ++e)
+            empty = chunk[e].status == EntryState_Empty && !chunk[e].pUnit;
+        if (!empty)
+            continue;
+
+        m_aChunks[i] = NULL;
+        --m_iUsed;
+        m_aSpare.push_back(chunk);
+    }
+    m_iMinSpare = m_aSpare.size();
+}
+
 void CRcvBuffer::updRcvAvgDataSize(const steady_clock::time_point& now)
 {
     if (!m_mavg.isTimeToUpdate(now))
@@ -11,9 +11,13 @@
 #ifndef INC_SRT_BUFFER_RCV_H
 #define INC_SRT_BUFFER_RCV_H
 
+#include <set>
+#include <vector>
 #include "buffer_tools.h" // AvgBufSize
 #include "common.h"
+#include "pool.h"
 #include "queue.h"
+#include "stats.h"
 #include "tsbpd_time.h"
 
 namespace srt
@@ -60,7 +64,7 @@ public:
     /// @param [in] offset offset from last ACK point.
     ///
     /// @return  0 on success, -1 if packet is already in buffer, -2 if packet is before m_iStartSeqNo.
-    /// -3 if a packet is offset is ahead the buffer capacity.
+    /// -3 if a packet is offset is ahead the buffer capacity or there's no memory for its entry.
     // TODO: Previously '-2' also meant 'already acknowledged'. Check usage of this value.
     int insert(CUnit* unit);
 
@@ -103,11 +107,22 @@ public:
     /// @param [in,out] data buffer to write the message into.
     /// @param [in] len size of the buffer.
     /// @param [in,out] message control data
+    /// @param [out] w_lent if not NULL, the message is not copied into @a data, but
+    ///         the unit holding it is lent to the caller until released with releaseLent().
+    ///         Only a message carried by a single packet can be lent.
     ///
     /// @return actual number of bytes extracted from the buffer.
     ///          0 if nothing to read.
-    ///         -1 on failure.
-    int readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl = NULL);
+    ///         -1 on failure (or if the message to lend spans several packets).
+    int readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl = NULL, CUnit** w_lent = NULL);
+
+    /// Return a unit lent by readMessage() to the unit queue.
+    /// @param [in] unit the unit to release.
+    /// @return false if the unit is not currently lent by this buffer.
+    bool releaseLent(CUnit* unit);
+
+    /// Number of units lent by readMessage() and not yet released.
+    size_t countLent() const { return m_lentUnits.size(); }
 
     /// Read acknowledged data into a user buffer.
     /// @param [in, out] dst pointer to the target user buffer.
@@ -139,15 +154,20 @@ public:
         // Therefore if the first packet in the buffer is ahead of the iFirstUnackSeqNo
         // then it does not have acknowledged packets and its full capacity is available.
         // Otherwise subtract the number of acknowledged but not yet read packets from its capacity.
+        // Units lent to the application still occupy the memory of the
+        // unit queue, so they are taken off the space offered to the peer.
+        const size_t lent     = countLent();
+        const size_t cap      = capacity() > lent ? capacity() - lent : 0;
         const int iRBufSeqNo  = getStartSeqNo();
         if (CSeqNo::seqcmp(iRBufSeqNo, iFirstUnackSeqNo) >= 0) // iRBufSeqNo >= iFirstUnackSeqNo
         {
             // Full capacity is available.
-            return capacity();
+            return cap;
         }
 
         // Note: CSeqNo::seqlen(n, n) returns 1.
-        return capacity() - CSeqNo::seqlen(iRBufSeqNo, iFirstUnackSeqNo) + 1;
+        const size_t used = CSeqNo::seqlen(iRBufSeqNo, iFirstUnackSeqNo) - 1;
+        return cap > used ? cap - used : 0;
     }
 
     /// @brief Checks if the buffer has packets available for reading regardless of the TSBPD.
@@ -165,11 +185,17 @@ public:
     /// Differs from getRcvDataSize() that it counts all packets in the buffer, not only continious.
     int getRcvDataSize(int& bytes, int& timespan) const;
 
+    /// Get the number of packets and bytes in the buffer without locking.
+    /// The two values are read separately and may differ by one pending update.
+    /// The timespan is the one stored with the last change of the counters.
+    int getRcvDataSizeSnapshot(int& w_bytes, int& w_timespan) const;
+
     struct PacketInfo
     {
         int        seqno;
         bool       seq_gap; //< true if there are missing packets in the buffer, preceding current packet
         time_point tsbpd_time;
+        int32_t    msgno;   //< message number of the packet
     };
 
     /// Get information on the 1st message in queue.
@@ -231,6 +257,15 @@ public:
         return m_tsbpd.getInternalTimeBase(w_timebase, w_wrp, w_udrift);
     }
 
+    /// The entries are allocated on demand, up to the capacity. This frees
+    /// the memory of those that have not been used for RELEASE_PERIOD_MS.
+    void releaseUnusedEntries(const time_point& now);
+
+    /// The number of entries currently allocated.
+    size_t allocatedEntries() const { return m_entries.allocated(); }
+
+    static const int RELEASE_PERIOD_MS = 1000;
+
 public: // Used for testing
     /// Peek unit in position of seqno
     const CUnit* peek(int32_t seqno);
@@ -255,8 +290,8 @@ private:
     }
 
     // NOTE: Assumes that pUnit != NULL
-    CPacket& packetAt(int pos) { return m_entries[pos].pUnit->m_Packet; }
-    const CPacket& packetAt(int pos) const { return m_entries[pos].pUnit->m_Packet; }
+    CPacket& packetAt(int pos) { return entryAt(pos).pUnit->m_Packet; }
+    const CPacket& packetAt(int pos) const { return entryAt(pos).pUnit->m_Packet; }
 
 private:
     void countBytes(int pkts, int bytes);
@@ -335,7 +370,84 @@ private:
 
     //static Entry emptyEntry() { return Entry { NULL, EntryState_Empty }; }
 
-    FixedArray<Entry> m_entries;
+    /// The entries of the buffer, allocated in chunks when first written,
+    /// so that the memory follows the packets actually held rather than
+    /// the capacity. A chunk with all entries empty is equivalent to
+    /// not allocated, so it can be released at any time.
+    class Entries
+    {
+    public:
+        static const int CHUNK_SIZE = 1024;
+
+        explicit Entries(size_t size);
+        ~Entries();
+
+        /// The entry to be written, its chunk is allocated if it isn't yet.
+        /// @throws std::bad_alloc
+        Entry& allocate(int pos)
+        {
+            Entry* chunk = m_aChunks[pos / CHUNK_SIZE];
+            if (!chunk)
+                chunk = allocateChunk(pos / CHUNK_SIZE);
+            return chunk[pos % CHUNK_SIZE];
+        }
+
+        /// The entry to be written that is already allocated (holds a unit).
+        Entry& at(int pos)
+        {
+            Entry* chunk = m_aChunks[pos / CHUNK_SIZE];
+            SRT_ASSERT(chunk != NULL);
+            return chunk[pos % CHUNK_SIZE];
+        }
+
+        /// Doesn't allocate; an entry not allocated is empty.
+        const Entry& operator[](int pos) const
+        {
+            const Entry* chunk = m_aChunks[pos / CHUNK_SIZE];
+            return chunk ? chunk[pos % CHUNK_SIZE] : s_EmptyEntry;
+        }
+
+        /// Empty the entry, if allocated.
+        void clear(int pos)
+        {
+            Entry* chunk = m_aChunks[pos / CHUNK_SIZE];
+            if (chunk)
+                chunk[pos % CHUNK_SIZE] = Entry();
+        }
+
+        size_t chunks() const { return m_aChunks.size(); }
+
+        /// @return the entries of the chunk, NULL if not allocated.
+        Entry* chunk(size_t i) { return m_aChunks[i]; }
+
+        /// The number of allocated entries, including the spare chunks.
+        size_t allocated() const { return (m_iUsed + m_aSpare.size()) * CHUNK_SIZE; }
+
+        /// Takes the chunks with all entries empty off the array and keeps
+        /// them as spare for the next allocations. The spare chunks that
+        /// were not needed since the previous call are freed.
+        void releaseEmpty();
+
+    private:
+        Entry* allocateChunk(size_t i);
+        static void freeChunk(Entry* chunk);
+
+        static const Entry s_EmptyEntry;
+
+        std::vector<Entry*> m_aChunks;    // NULL if not allocated
+        std::vector<Entry*> m_aSpare;     // allocated, currently not in m_aChunks
+        size_t              m_iUsed;      // number of non-NULL chunks in m_aChunks
+        size_t              m_iMinSpare;  // the fewest spare chunks since releaseEmpty()
+
+        Entries(const Entries&);
+        Entries& operator=(const Entries&);
+    };
+
+    /// Read the entry without allocating it.
+    const Entry& entryAt(int pos) const { return m_entries[pos]; }
+
+    Entries m_entries;
+    std::set<CUnit*>  m_lentUnits; // units lent to the application by readMessage()
 
     const size_t m_szSize;     // size of the array of units (buffer)
     CUnitQueue*  m_pUnitQueue; // the shared unit queue
@@ -351,6 +463,7 @@ private:
                                     // read
     bool m_bPeerRexmitFlag;         // Needed to read message number correctly
     const bool m_bMessageAPI;       // Operation mode flag: message or stream.
+    time_point m_tsLastRelease;     // The last call of m_entries.releaseEmpty()
 
 public: // TSBPD public functions
     /// Set TimeStamp-Based Packet Delivery Rx Mode
@@ -388,8 +501,10 @@ private: // Statistics
 
     // TODO: m_BytesCountLock is probably not needed as the buffer has to be protected from simultaneous access.
     mutable sync::Mutex m_BytesCountLock;   // used to protect counters operations
-    int         m_iBytesCount;      // Number of payload bytes in the buffer
-    int         m_iPktsCount;       // Number of payload bytes in the buffer
+    // Read by getRcvDataSizeSnapshot() without a lock.
+    stats::Value<int> m_iBytesCount; // Number of payload bytes in the buffer
+    stats::Value<int> m_iPktsCount;  // Number of packets in the buffer
+    stats::Value<int> m_iTimespanMs; // Timespan of the packets in the buffer
     unsigned    m_uAvgPayloadSz;    // Average payload size for dropped bytes estimation
 };
 
@@ -64,6 +64,41 @@ using namespace std;
 using namespace srt_logging;
 using namespace sync;
 
+sync::atomic<int> CSndPayload::s_iCreated(0);
+
+CSndPayload::CSndPayload(const char* data, int len, release_fn* relfn, void* opaque)
+    : m_pcData(data)
+    , m_iLength(len)
+    , m_fnRelease(relfn)
+    , m_pOpaque(opaque)
+    , m_iRefCount(1)
+{
+}
+
+CSndPayload* CSndPayload::create(const char* data, int len, release_fn* relfn, void* opaque)
+{
+    try
+    {
+        CSndPayload* payload = new CSndPayload(data, len, relfn, opaque);
+        ++s_iCreated;
+        return payload;
+    }
+    catch (...)
+    {
+        throw CUDTException(MJ_SYSTEMRES, MN_MEMORY, 0);
+    }
+}
+
+void CSndPayload::release()
+{
+    if (--m_iRefCount > 0)
+        return;
+
+    if (m_fnRelease)
+        m_fnRelease(m_pOpaque, m_pcData, m_iLength);
+    delete this;
+}
+
 CSndBuffer::CSndBuffer(int ip_family, int size, int maxpld, int authtag)
     : m_BufLock()
     , m_pBlock(NULL)
@@ -81,7 +116,7 @@ CSndBuffer::CSndBuffer(int ip_family, int size, int maxpld, int authtag)
 {
     // initial physical buffer of "size"
     m_pBuffer           = new Buffer;
-    m_pBuffer->m_pcData = new char[m_iSize * m_iBlockLen];
+    m_pBuffer->m_pcData = static_cast<char*>(CObjectPool::allocate(m_iSize * m_iBlockLen));
     m_pBuffer->m_iSize  = m_iSize;
     m_pBuffer->m_pNext  = NULL;
 
@@ -94,6 +129,8 @@ CSndBuffer::CSndBuffer(int ip_family, int size, int maxpld, int authtag)
     {
         pb->m_iMsgNoBitset = 0;
         pb->m_pcData       = pc;
+        pb->m_pcStorage    = pc;
+        pb->m_pPayload     = NULL;
         pc                += m_iBlockLen;
 
         if (i < m_iSize - 1)
@@ -105,12 +142,17 @@ CSndBuffer::CSndBuffer(int ip_family, int size, int maxpld, int authtag)
     pb->m_pNext = m_pBlock;
 
     m_pFirstBlock = m_pCurrBlock = m_pLastBlock = m_pBlock;
+    indexBlocks();
 
     setupMutex(m_BufLock, "Buf");
 }
 
 CSndBuffer::~CSndBuffer()
 {
+    // Return the payloads still referred to by the blocks in use.
+    for (Block* pu = m_pFirstBlock; pu != m_pLastBlock; pu = pu->m_pNext)
+        pu->releasePayload();
+
     Block* pb = m_pBlock->m_pNext;
     while (pb != m_pBlock)
     {
@@ -124,7 +166,7 @@ CSndBuffer::~CSndBuffer()
     {
         Buffer* temp = m_pBuffer;
         m_pBuffer    = m_pBuffer->m_pNext;
-        delete[] temp->m_pcData;
+        CObjectPool::release(temp->m_pcData, temp->m_iSize * m_iBlockLen);
         delete temp;
     }
 
@@ -132,6 +174,17 @@ CSndBuffer::~CSndBuffer()
 }
 
 void CSndBuffer::addBuffer(const char* data, int len, SRT_MSGCTRL& w_mctrl)
+{
+    addBuffer(data, len, NULL, (w_mctrl));
+}
+
+void CSndBuffer::addBuffer(CSndPayload& payload, int len, SRT_MSGCTRL& w_mctrl)
+{
+    SRT_ASSERT(len <= payload.size());
+    addBuffer(payload.data(), len, &payload, (w_mctrl));
+}
+
+void CSndBuffer::addBuffer(const char* data, int len, CSndPayload* payload, SRT_MSGCTRL& w_mctrl)
 {
     int32_t& w_msgno     = w_mctrl.msgno;
     int32_t& w_seqno     = w_mctrl.pktseq;
@@ -188,10 +241,24 @@ void CSndBuffer::addBuffer(const char* data, int len, SRT_MSGCTRL& w_mctrl)
         if (pktlen > iPktLen)
             pktlen = iPktLen;
 
-        HLOGC(bslog.Debug,
-              log << "addBuffer: %" << w_seqno << " #" << w_msgno << " offset=" << (i * iPktLen)
-                  << " size=" << pktlen << " TO BUFFER:" << (void*)s->m_pcData);
-        memcpy((s->m_pcData), data + i * iPktLen, pktlen);
+        if (payload)
+        {
+            HLOGC(bslog.Debug,
+                  log << "addBuffer: %" << w_seqno << " #" << w_msgno << " offset=" << (i * iPktLen)
+                      << " size=" << pktlen << " REFERRING TO:" << (void*)(data + i * iPktLen));
+            // The data are never modified through m_pcData while the block
+            // refers to the payload (see readData), hence the const_cast.
+            payload->acquire();
+            s->m_pPayload = payload;
+            s->m_pcData   = const_cast<char*>(data + i * iPktLen);
+        }
+        else
+        {
+            HLOGC(bslog.Debug,
+                  log << "addBuffer: %" << w_seqno << " #" << w_msgno << " offset=" << (i * iPktLen)
+                      << " size=" << pktlen << " TO BUFFER:" << (void*)s->m_pcData);
+            memcpy((s->m_pcData), data + i * iPktLen, pktlen);
+        }
         s->m_iLength = pktlen;
 
         s->m_iSeqNo = w_seqno;
@@ -220,7 +287,8 @@ void CSndBuffer::addBuffer(const char* data, int len, SRT_MSGCTRL& w_mctrl)
     m_pLastBlock = s;
 
     m_iCount = m_iCount + iNumBlocks;
-    m_iBytesCount += len;
+    m_iBytesCount = m_iBytesCount + len;
+    updTimespanSnapshot();
 
     m_rateEstimator.updateInputRate(m_tsLastOriginTime, iNumBlocks, len);
     updAvgBufSize(m_tsLastOriginTime);
@@ -294,7 +362,8 @@ int CSndBuffer::addBufferFromFile(fstream& ifs, int len)
 
     enterCS(m_BufLock);
     m_iCount = m_iCount + iNumBlocks;
-    m_iBytesCount += total;
+    m_iBytesCount = m_iBytesCount + total;
+    updTimespanSnapshot();
 
     leaveCS(m_BufLock);
 
@@ -313,6 +382,14 @@ int CSndBuffer::readData(CPacket& w_packet, steady_clock::time_point& w_srctime,
     ScopedLock bufferguard(m_BufLock);
     while (m_pCurrBlock != m_pLastBlock)
     {
+        // Encryption is done in place, so an external payload must be
+        // copied into the block's own storage before it's sent for the first time.
+        if (kflgs > EK_NOENC && m_pCurrBlock->m_pPayload)
+        {
+            memcpy((m_pCurrBlock->m_pcStorage), m_pCurrBlock->m_pcData, m_pCurrBlock->m_iLength);
+            m_pCurrBlock->releasePayload();
+        }
+
         // Make the packet REFLECT the data stored in the buffer.
         w_packet.m_pcData = m_pCurrBlock->m_pcData;
         readlen = m_pCurrBlock->m_iLength;
@@ -389,7 +466,7 @@ int32_t CSndBuffer::getMsgNoAt(const int offset)
                   << p->getMsgSeq() << " !" << BufferStamp(p->m_pcData, p->m_iLength));
     }
 
-    if (offset >= m_iCount)
+    if (offset < 0 || offset >= m_iCount)
     {
         // Prevent accessing the last "marker" block
         LOGC(bslog.Error,
@@ -397,23 +474,7 @@ int32_t CSndBuffer::getMsgNoAt(const int offset)
         return SRT_MSGNO_CONTROL;
     }
 
-    // XXX Suboptimal procedure to keep the blocks identifiable
-    // by sequence number. Consider using some circular buffer.
-    int       i;
-    Block* ee SRT_ATR_UNUSED = 0;
-    for (i = 0; i < offset && p; ++i)
-    {
-        ee = p;
-        p  = p->m_pNext;
-    }
-
-    if (!p)
-    {
-        LOGC(bslog.Error,
-             log << "CSndBuffer::getMsgNoAt: IPE: offset=" << offset << " not found, stopped at " << i << " with #"
-                 << (ee ? ee->getMsgSeq() : SRT_MSGNO_NONE));
-        return SRT_MSGNO_CONTROL;
-    }
+    p = blockAt(offset);
 
     HLOGC(bslog.Debug,
           log << "CSndBuffer::getMsgNoAt: offset=" << offset << " found, size=" << p->m_iLength << " %" << p->m_iSeqNo
@@ -429,19 +490,12 @@ int CSndBuffer::readData(const int offset, CPacket& w_packet, steady_clock::time
 
     ScopedLock bufferguard(m_BufLock);
 
-    Block* p = m_pFirstBlock;
-
-    // XXX Suboptimal procedure to keep the blocks identifiable
-    // by sequence number. Consider using some circular buffer.
-    for (int i = 0; i < offset && p != m_pLastBlock; ++i)
+    if (offset < 0 || offset >= m_iCount)
     {
-        p = p->m_pNext;
-    }
-    if (p == m_pLastBlock)
-    {
-        LOGC(qslog.Error, log << "CSndBuffer::readData: offset " << offset << " too large!");
+        LOGC(qslog.Error, log << "CSndBuffer::readData: offset " << offset << " out of range!");
         return READ_NONE;
     }
+    Block* p = blockAt(offset);
 #if ENABLE_HEAVY_LOGGING
     const int32_t first_seq = p->m_iSeqNo;
     int32_t last_seq = p->m_iSeqNo;
@@ -532,18 +586,9 @@ int CSndBuffer::readData(const int offset, CPacket& w_packet, steady_clock::time
 sync::steady_clock::time_point CSndBuffer::getPacketRexmitTime(const int offset)
 {
     ScopedLock bufferguard(m_BufLock);
-    const Block* p = m_pFirstBlock;
-
-    // XXX Suboptimal procedure to keep the blocks identifiable
-    // by sequence number. Consider using some circular buffer.
-    for (int i = 0; i < offset; ++i)
-    {
-        SRT_ASSERT(p);
-        p = p->m_pNext;
-    }
+    SRT_ASSERT(offset >= 0 && offset < m_iSize);
 
-    SRT_ASSERT(p);
-    return p->m_tsRexmitTime;
+    return blockAt(offset)->m_tsRexmitTime;
 }
 
 void CSndBuffer::ackData(int offset)
@@ -553,7 +598,8 @@ void CSndBuffer::ackData(int offset)
     bool move = false;
     for (int i = 0; i < offset; ++i)
     {
-        m_iBytesCount -= m_pFirstBlock->m_iLength;
+        m_iBytesCount = m_iBytesCount - m_pFirstBlock->m_iLength;
+        m_pFirstBlock->releasePayload();
         if (m_pFirstBlock == m_pCurrBlock)
             move = true;
         m_pFirstBlock = m_pFirstBlock->m_pNext;
@@ -562,6 +608,7 @@ void CSndBuffer::ackData(int offset)
         m_pCurrBlock = m_pFirstBlock;
 
     m_iCount = m_iCount - offset;
+    updTimespanSnapshot();
 
     updAvgBufSize(steady_clock::now());
 }
@@ -634,6 +681,21 @@ int CSndBuffer::getCurrBufSize(int& w_bytes, int& w_timespan) const
     return m_iCount;
 }
 
+int CSndBuffer::getCurrBufSizeSnapshot(int& w_bytes, int& w_timespan) const
+{
+    w_bytes = m_iBytesCount;
+    w_timespan = m_iTimespanMs;
+    return m_iCount;
+}
+
+void CSndBuffer::updTimespanSnapshot()
+{
+    int bytes = 0;
+    int timespan_ms = 0;
+    getCurrBufSize((bytes), (timespan_ms));
+    m_iTimespanMs = timespan_ms;
+}
+
 CSndBuffer::duration CSndBuffer::getBufferingDelay(const time_point& tnow) const
 {
     ScopedLock lck(m_BufLock);
@@ -657,6 +719,7 @@ int CSndBuffer::dropLateData(int& w_bytes, int32_t& w_first_msgno, const steady_
         dpkts++;
         dbytes += m_pFirstBlock->m_iLength;
         msgno = m_pFirstBlock->getMsgSeq();
+        m_pFirstBlock->releasePayload();
 
         if (m_pFirstBlock == m_pCurrBlock)
             move = true;
@@ -669,7 +732,8 @@ int CSndBuffer::dropLateData(int& w_bytes, int32_t& w_first_msgno, const steady_
     }
     m_iCount = m_iCount - dpkts;
 
-    m_iBytesCount -= dbytes;
+    m_iBytesCount = m_iBytesCount - dbytes;
+    updTimespanSnapshot();
     w_bytes = dbytes;
 
     // We report the increased number towards the last ever seen
@@ -691,7 +755,7 @@ void CSndBuffer::increase()
     try
     {
         nbuf           = new Buffer;
-        nbuf->m_pcData = new char[unitsize * m_iBlockLen];
+        nbuf->m_pcData = static_cast<char*>(CObjectPool::allocate(unitsize * m_iBlockLen));
     }
     catch (...)
     {
@@ -733,12 +797,15 @@ void CSndBuffer::increase()
     char* pc = nbuf->m_pcData;
     for (int i = 0; i < unitsize; ++i)
     {
-        pb->m_pcData = pc;
-        pb           = pb->m_pNext;
+        pb->m_pcData    = pc;
+        pb->m_pcStorage = pc;
+        pb->m_pPayload  = NULL;
+        pb              = pb->m_pNext;
         pc += m_iBlockLen;
     }
 
     m_iSize += unitsize;
+    indexBlocks();
 
     HLOGC(bslog.Debug,
           log << "CSndBuffer: BUFFER FULL - adding " << (unitsize * m_iBlockLen) << " bytes spread to " << unitsize
@@ -746,4 +813,18 @@ void CSndBuffer::increase()
               << " (total size: " << m_iSize << " bytes)");
 }
 
+void CSndBuffer::indexBlocks()
+{
+    m_aBlocks.resize(m_iSize);
+
+    Block* pb = m_pFirstBlock;
+    for (int i = 0; i < m_iSize; ++i)
+    {
+        m_aBlocks[i] = pb;
+        pb->m_iIndex = i;
+        pb           = pb->m_pNext;
+    }
+    SRT_ASSERT(pb == m_pFirstBlock);
+}
+
 } // namespace srt
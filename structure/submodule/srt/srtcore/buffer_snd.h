@@ -53,9 +53,13 @@ modified by
 #ifndef INC_SRT_BUFFER_SND_H
 #define INC_SRT_BUFFER_SND_H
 
+#include <vector>
+
 #include "srt.h"
 #include "packet.h"
 #include "buffer_tools.h"
+#include "pool.h"
+#include "stats.h"
 
 // The notation used for "circular numbers" in comments:
 // The "cicrular numbers" are numbers that when increased up to the
@@ -71,6 +75,50 @@ modified by
 
 namespace srt {
 
+/// Payload lent to the sender buffer by the application instead of
+/// being copied into it. The object is reference counted: every sender
+/// buffer block that refers to the payload holds one reference, and the
+/// submitting call holds one more for the time of the call. When the last
+/// reference is dropped, the release function is called, after which the
+/// application may reuse or free the memory.
+///
+/// The release function is called from whichever thread drops the last
+/// reference (the receiving thread on ACK, the sending thread on a drop,
+/// the GC thread on socket deletion or the submitting thread itself), so
+/// it must not call SRT API functions.
+class CSndPayload
+{
+public:
+    typedef void release_fn(void* opaque, const char* data, int len);
+
+    /// Create a payload with one reference held by the caller.
+    static CSndPayload* create(const char* data, int len, release_fn* relfn, void* opaque);
+
+    void acquire() { ++m_iRefCount; }
+    void release();
+
+    const char* data() const { return m_pcData; }
+    int         size() const { return m_iLength; }
+
+    /// Number of payloads created so far (diagnostics).
+    static int createdCount() { return s_iCreated; }
+
+private:
+    CSndPayload(const char* data, int len, release_fn* relfn, void* opaque);
+    ~CSndPayload() {}
+
+    const char*       m_pcData;
+    int               m_iLength;
+    release_fn*       m_fnRelease;
+    void*             m_pOpaque;
+    sync::atomic<int> m_iRefCount;
+
+    static sync::atomic<int> s_iCreated;
+
+    CSndPayload(const CSndPayload&);
+    CSndPayload& operator=(const CSndPayload&);
+};
+
 class CSndBuffer
 {
     typedef sync::steady_clock::time_point time_point;
@@ -109,6 +157,18 @@ public:
     SRT_ATTR_EXCLUDES(m_BufLock)
     void addBuffer(const char* data, int len, SRT_MSGCTRL& w_mctrl);
 
+    /// Insert a payload into the sending list without copying it.
+    /// The blocks refer to the first @a len bytes of @a payload, which
+    /// gets one reference per block until the block is acknowledged or
+    /// dropped. If the payload has to be encrypted, it is copied into the
+    /// buffer's own storage when read for sending for the first time, as
+    /// the encryption is done in place.
+    /// @param [in] payload the payload to refer to.
+    /// @param [in] len number of bytes of the payload to send.
+    /// @param [inout] w_mctrl Message control data (same as for addBuffer).
+    SRT_ATTR_EXCLUDES(m_BufLock)
+    void addBuffer(CSndPayload& payload, int len, SRT_MSGCTRL& w_mctrl);
+
     /// Read a block of data from file and insert it into the sending list.
     /// @param [in] ifs input file stream.
     /// @param [in] len size of the block.
@@ -182,6 +242,12 @@ public:
     int  getAvgBufSize(int& bytes, int& timespan);
     int  getCurrBufSize(int& bytes, int& timespan) const;
 
+    /// Read the number of packets and payload bytes in the sending list
+    /// without touching the block list, so it is safe to call without a lock.
+    /// The two values are read separately and may differ by one pending update.
+    /// The timespan is the one stored with the last change of the contents.
+    int getCurrBufSizeSnapshot(int& w_bytes, int& w_timespan) const;
+
 
     /// Het maximum payload length per packet.
     int getMaxPacketLen() const;
@@ -216,21 +282,36 @@ public:
 private:
     void increase();
 
+    void addBuffer(const char* data, int len, CSndPayload* payload, SRT_MSGCTRL& w_mctrl);
+
+    /// Rebuild m_aBlocks after the ring of blocks has changed.
+    void indexBlocks();
+
+    /// Store the current timespan for getCurrBufSizeSnapshot().
+    void updTimespanSnapshot();
+
 private:
     mutable sync::Mutex m_BufLock; // used to synchronize buffer operation
 
     struct Block
     {
-        char* m_pcData;  // pointer to the data block
+        char* m_pcData;  // pointer to the data block (the storage or the external payload)
         int   m_iLength; // payload length of the block (excluding auth tag).
 
+        char*        m_pcStorage; // block's own storage in the physical buffer
+        CSndPayload* m_pPayload;  // external payload referred to by m_pcData (NULL if using the storage)
+
         int32_t    m_iMsgNoBitset; // message number
         int32_t    m_iSeqNo;       // sequence number for scheduling
         time_point m_tsOriginTime; // block origin time (either provided from above or equals the time a message was submitted for sending.
         time_point m_tsRexmitTime; // packet retransmission time
         int        m_iTTL; // time to live (milliseconds)
 
-        Block* m_pNext; // next block
+        Block* m_pNext;  // next block
+        int    m_iIndex; // position of the block in m_aBlocks
+
+        static void* operator new(size_t size) { return CObjectPool::allocate(size); }
+        static void operator delete(void* ptr, size_t size) { CObjectPool::release(ptr, size); }
 
         int32_t getMsgSeq()
         {
@@ -241,6 +322,17 @@ private:
             return m_iMsgNoBitset & MSGNO_SEQ::mask;
         }
 
+        // Drop the reference to the external payload, if any,
+        // and make the block use its own storage again.
+        void releasePayload()
+        {
+            if (!m_pPayload)
+                return;
+            m_pcData = m_pcStorage;
+            m_pPayload->release();
+            m_pPayload = NULL;
+        }
+
     } * m_pBlock, *m_pFirstBlock, *m_pCurrBlock, *m_pLastBlock;
 
     // m_pBlock:         The head pointer
@@ -248,6 +340,16 @@ private:
     // m_pCurrBlock:	 The current block
     // m_pLastBlock:     The last block (if first == last, buffer is empty)
 
+    // All blocks in the order of the ring, so that the block at a given
+    // offset from m_pFirstBlock is found without walking the list.
+    std::vector<Block*> m_aBlocks;
+
+    /// Block at the given offset from m_pFirstBlock (m_pLastBlock at m_iCount).
+    Block* blockAt(int offset) const
+    {
+        return m_aBlocks[(m_pFirstBlock->m_iIndex + offset) % m_iSize];
+    }
+
     struct Buffer
     {
         char*   m_pcData; // buffer
@@ -266,7 +368,8 @@ private:
     // a lock.
     sync::atomic<int> m_iCount; // number of used blocks
 
-    int        m_iBytesCount; // number of payload bytes in queue
+    stats::Value<int> m_iBytesCount; // number of payload bytes in queue (read without locking as well)
+    stats::Value<int> m_iTimespanMs; // timespan of the queue, for getCurrBufSizeSnapshot()
     time_point m_tsLastOriginTime;
 
     AvgBufSize m_mavg;
@@ -136,6 +136,8 @@ extern const SRT_SOCKOPT srt_post_opt_list [SRT_SOCKOPT_NPOST] = {
 #ifdef ENABLE_MAXREXMITBW
     ,SRTO_MAXREXMITBW
 #endif
+    ,SRTO_SNDPRIORITY
+    ,SRTO_SNDWEIGHT
 };
 
 const int32_t
@@ -208,6 +210,9 @@ struct SrtOptionAction
 #endif
         flags[SRTO_PACKETFILTER]       = SRTO_R_PRE;
         flags[SRTO_RETRANSMITALGO]     = SRTO_R_PRE;
+        flags[SRTO_CRYPTOWORKERS]      = SRTO_R_PRE;
+        flags[SRTO_TSBPDWORKERS]       = SRTO_R_PRE;
+        flags[SRTO_MUXMAXBW]           = SRTO_R_PREBIND;
 #ifdef ENABLE_AEAD_API_PREVIEW
         flags[SRTO_CRYPTOMODE]         = SRTO_R_PRE;
 #endif
@@ -266,6 +271,8 @@ void srt::CUDT::construct()
     m_pSndLossList         = NULL;
     m_pRcvLossList         = NULL;
     m_iReorderTolerance    = 0;
+    m_iSndPriority         = m_config.iSndPriority;
+    m_iSndWeight           = m_config.iSndWeight;
     // How many times so far the packet considered lost has been received
     // before TTL expires.
     m_iConsecEarlyDelivery   = 0; 
@@ -300,6 +307,9 @@ void srt::CUDT::construct()
     m_bTsbPd              = false;
     m_bTsbPdAckWakeup     = false;
     m_bGroupTsbPd         = false;
+#if ENABLE_BONDING
+    m_pTsbPdGroup         = NULL;
+#endif
     m_bPeerTLPktDrop      = false;
     m_bBufferWasFull      = false;
 
@@ -317,6 +327,7 @@ srt::CUDT::CUDT(CUDTSocket* parent)
 #endif
     , m_iISN(-1)
     , m_iPeerISN(-1)
+    , m_TsbPdTask(this)
 {
     construct();
 
@@ -346,6 +357,7 @@ srt::CUDT::CUDT(CUDTSocket* parent, const CUDT& ancestor)
 #endif
     , m_iISN(-1)
     , m_iPeerISN(-1)
+    , m_TsbPdTask(this)
 {
     construct();
 
@@ -376,6 +388,8 @@ srt::CUDT::CUDT(CUDTSocket* parent, const CUDT& ancestor)
     m_SrtHsSide         = ancestor.m_SrtHsSide; // actually it sets it to HSD_RESPONDER
     m_bTLPktDrop        = ancestor.m_bTLPktDrop;
     m_iReorderTolerance = m_config.iMaxReorderTolerance;  // Initialize with maximum value
+    m_iSndPriority      = m_config.iSndPriority;
+    m_iSndWeight        = m_config.iSndWeight;
 
     // Runtime
     m_pCache = ancestor.m_pCache;
@@ -411,7 +425,7 @@ void srt::CUDT::setOpt(SRT_SOCKOPT optName, const void* optval, int optlen)
     ScopedLock sendguard (m_SendLock);
     ScopedLock recvguard (m_RecvLock);
 
-    HLOGC(aclog.Debug,
+    HSLOGC(aclog.Debug, m_SocketID,
           log << CONID() << "OPTION: #" << optName << " value:" << FormatBinaryString((uint8_t*)optval, optlen));
 
     if (IsSet(oflags, SRTO_R_PREBIND) && m_bOpened)
@@ -424,10 +438,16 @@ void srt::CUDT::setOpt(SRT_SOCKOPT optName, const void* optval, int optlen)
     const int status = m_config.set(optName, optval, optlen);
     if (status == -1)
     {
-        LOGC(aclog.Error, log << CONID() << "OPTION: #" << optName << " UNKNOWN");
+        SLOGC(aclog.Error, m_SocketID, log << CONID() << "OPTION: #" << optName << " UNKNOWN");
         throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
     }
 
+    // The send scheduler reads these at any time, not only when connected.
+    if (optName == SRTO_SNDPRIORITY)
+        m_iSndPriority = m_config.iSndPriority;
+    else if (optName == SRTO_SNDWEIGHT)
+        m_iSndWeight = m_config.iSndWeight;
+
     // Post-action, if applicable
     if (IsSet(oflags, SRTO_POST_SPEC) && m_bConnected)
     {
@@ -843,6 +863,33 @@ void srt::CUDT::getOpt(SRT_SOCKOPT optName, void *optval, int &optlen)
         *(int32_t *)optval = m_config.iRetransmitAlgo;
         optlen         = sizeof(int32_t);
         break;
+
+    case SRTO_CRYPTOWORKERS:
+        *(int32_t *)optval = m_config.iCryptoWorkers;
+        optlen         = sizeof(int32_t);
+        break;
+
+    case SRTO_TSBPDWORKERS:
+        *(int32_t *)optval = m_config.iTsbPdWorkers;
+        optlen         = sizeof(int32_t);
+        break;
+
+    case SRTO_SNDPRIORITY:
+        *(int32_t *)optval = m_config.iSndPriority;
+        optlen         = sizeof(int32_t);
+        break;
+
+    case SRTO_SNDWEIGHT:
+        *(int32_t *)optval = m_config.iSndWeight;
+        optlen         = sizeof(int32_t);
+        break;
+
+    case SRTO_MUXMAXBW:
+        if (size_t(optlen) < sizeof(m_config.llMuxMaxBW))
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+        *(int64_t *)optval = m_config.llMuxMaxBW;
+        optlen         = sizeof(int64_t);
+        break;
 #ifdef ENABLE_AEAD_API_PREVIEW
     case SRTO_CRYPTOMODE:
         if (m_pCryptoControl)
@@ -866,7 +913,7 @@ SRT_ERRNO srt::CUDT::applyMemberConfigObject(const SRT_SocketOptionObject& opt)
     for (size_t i = 0; i < opt.options.size(); ++i)
     {
         SRT_SocketOptionObject::SingleOption* o = opt.options[i];
-        HLOGC(smlog.Debug, log << CONID() << "applyMemberConfigObject: OPTION @" << m_SocketID << " #" << o->option);
+        HSLOGC(smlog.Debug, m_SocketID, log << CONID() << "applyMemberConfigObject: OPTION @" << m_SocketID << " #" << o->option);
         this_opt = SRT_SOCKOPT(o->option);
         setOpt(this_opt, o->storage, o->length);
     }
@@ -906,7 +953,7 @@ void srt::CUDT::clearData()
 {
     const size_t full_hdr_size = CPacket::UDP_HDR_SIZE - CPacket::HDR_SIZE;
     m_iMaxSRTPayloadSize = m_config.iMSS - full_hdr_size;
-    HLOGC(cnlog.Debug, log << CONID() << "clearData: PAYLOAD SIZE: " << m_iMaxSRTPayloadSize);
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "clearData: PAYLOAD SIZE: " << m_iMaxSRTPayloadSize);
 
     m_SndTimeWindow.initialize(full_hdr_size, m_iMaxSRTPayloadSize);
     m_RcvTimeWindow.initialize(full_hdr_size, m_iMaxSRTPayloadSize);
@@ -921,7 +968,7 @@ void srt::CUDT::clearData()
 
     // trace information
     {
-        ScopedLock stat_lock(m_StatsLock);
+        StatsWriteLock stat_lock(*this);
 
         m_stats.tsStartTime = steady_clock::now();
         m_stats.sndr.reset();
@@ -929,7 +976,9 @@ void srt::CUDT::clearData()
 
         m_stats.tsLastSampleTime = steady_clock::now();
         m_stats.traceReorderDistance = 0;
-        m_stats.sndDuration = m_stats.m_sndDurationTotal = 0;
+        m_stats.traceBelatedTimeUs = 0;
+        m_stats.sndDuration = 0;
+        m_stats.m_sndDurationTotal = 0;
     }
 
     // Resetting these data because this happens when agent isn't connected.
@@ -965,13 +1014,18 @@ void srt::CUDT::open()
     m_pSNode->m_pUDT      = this;
     m_pSNode->m_tsTimeStamp = steady_clock::now();
     m_pSNode->m_iHeapLoc  = -1;
+    m_pSNode->m_bReady     = false;
+    m_pSNode->m_iPriority  = 0;
+    m_pSNode->m_dStartTag  = 0;
+    m_pSNode->m_dFinishTag = 0;
 
     if (m_pRNode == NULL)
         m_pRNode = new CRNode;
     m_pRNode->m_pUDT      = this;
     m_pRNode->m_tsTimeStamp = steady_clock::now();
-    m_pRNode->m_pPrev = m_pRNode->m_pNext = NULL;
-    m_pRNode->m_bOnList                   = false;
+    m_pRNode->m_tsLastCheck = m_pRNode->m_tsTimeStamp;
+    m_pRNode->m_iHeapLoc    = -1;
+    m_pRNode->m_bOnList     = false;
 
     // Set initial values of smoothed RTT and RTT variance.
     m_iSRTT               = INITIAL_RTT;
@@ -1028,13 +1082,19 @@ void srt::CUDT::setListenState()
         throw CUDTException(MJ_NOTSUP, MN_BUSY, 0);
 
     m_bListening = true;
+
+#ifdef SRT_ENABLE_ENCRYPTION
+    // Keep the KEKs derived for the callers cached while listening.
+    if (m_config.CryptoSecret.len > 0)
+        uglobal().m_KekCache.acquire((const char*)m_config.CryptoSecret.str, m_config.CryptoSecret.len);
+#endif
 }
 
 size_t srt::CUDT::fillSrtHandshake(uint32_t *aw_srtdata, size_t srtlen, int msgtype, int hs_version)
 {
     if (srtlen < SRT_HS_E_SIZE)
     {
-        LOGC(cnlog.Fatal,
+        SLOGC(cnlog.Fatal, m_SocketID,
              log << CONID() << "IPE: fillSrtHandshake: buffer too small: " << srtlen << " (expected: " << SRT_HS_E_SIZE << ")");
         return 0;
     }
@@ -1053,7 +1113,7 @@ size_t srt::CUDT::fillSrtHandshake(uint32_t *aw_srtdata, size_t srtlen, int msgt
     case SRT_CMD_HSRSP:
         return fillSrtHandshake_HSRSP((aw_srtdata), srtlen, hs_version);
     default:
-        LOGC(cnlog.Fatal, log << CONID() << "IPE: fillSrtHandshake/sendSrtMsg called with value " << msgtype);
+        SLOGC(cnlog.Fatal, m_SocketID, log << CONID() << "IPE: fillSrtHandshake/sendSrtMsg called with value " << msgtype);
         return 0;
     }
 }
@@ -1113,7 +1173,7 @@ size_t srt::CUDT::fillSrtHandshake_HSREQ(uint32_t *aw_srtdata, size_t /* srtlen
     if (!m_config.bMessageAPI)
         aw_srtdata[SRT_HS_FLAGS] |= SRT_OPT_STREAM;
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "HSREQ/snd: LATENCY[SND:" << SRT_HS_LATENCY_SND::unwrap(aw_srtdata[SRT_HS_LATENCY])
               << " RCV:" << SRT_HS_LATENCY_RCV::unwrap(aw_srtdata[SRT_HS_LATENCY]) << "] FLAGS["
               << SrtFlagString(aw_srtdata[SRT_HS_FLAGS]) << "]");
@@ -1128,7 +1188,7 @@ size_t srt::CUDT::fillSrtHandshake_HSRSP(uint32_t *aw_srtdata, size_t /* srtlen
     // getting first received HSREQ. Doesn't look possible in both HSv4 and HSv5.
     if (is_zero(m_tsRcvPeerStartTime))
     {
-        LOGC(cnlog.Fatal, log << CONID() << "IPE: fillSrtHandshake_HSRSP: m_tsRcvPeerStartTime NOT SET!");
+        SLOGC(cnlog.Fatal, m_SocketID, log << CONID() << "IPE: fillSrtHandshake_HSRSP: m_tsRcvPeerStartTime NOT SET!");
         return 0;
     }
 
@@ -1156,7 +1216,7 @@ size_t srt::CUDT::fillSrtHandshake_HSRSP(uint32_t *aw_srtdata, size_t /* srtlen
     }
     else
     {
-        HLOGC(cnlog.Debug, log << CONID() << "HSRSP/snd: TSBPD off, NOT responding TSBPDRCV flag.");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "HSRSP/snd: TSBPD off, NOT responding TSBPDRCV flag.");
     }
 
     // Hsv5, only when peer has declared TSBPD mode.
@@ -1168,13 +1228,13 @@ size_t srt::CUDT::fillSrtHandshake_HSRSP(uint32_t *aw_srtdata, size_t /* srtlen
         aw_srtdata[SRT_HS_FLAGS] |= SRT_OPT_TSBPDSND;
         aw_srtdata[SRT_HS_LATENCY] |= SRT_HS_LATENCY_SND::wrap(m_iPeerTsbPdDelay_ms);
 
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID()
                   << "HSRSP/snd: HSv5 peer uses TSBPD, responding TSBPDSND latency=" << m_iPeerTsbPdDelay_ms);
     }
     else
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "HSRSP/snd: HSv" << (hs_version == CUDT::HS_VERSION_UDT4 ? 4 : 5)
                   << " with peer TSBPD=" << (m_bPeerTsbPd ? "on" : "off") << " - NOT responding TSBPDSND");
     }
@@ -1206,7 +1266,7 @@ size_t srt::CUDT::fillSrtHandshake_HSRSP(uint32_t *aw_srtdata, size_t /* srtlen
         {
             // Peer does not request to use rexmit flag, if so,
             // we won't use as well.
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "HSRSP/snd: AGENT understands REXMIT flag, but PEER DOES NOT. NOT setting.");
         }
         else
@@ -1223,7 +1283,7 @@ size_t srt::CUDT::fillSrtHandshake_HSRSP(uint32_t *aw_srtdata, size_t /* srtlen
         HLOGP(cnlog.Debug, "HSRSP/snd: AGENT DOES NOT UNDERSTAND REXMIT flag");
     }
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "HSRSP/snd: LATENCY[SND:" << SRT_HS_LATENCY_SND::unwrap(aw_srtdata[SRT_HS_LATENCY])
               << " RCV:" << SRT_HS_LATENCY_RCV::unwrap(aw_srtdata[SRT_HS_LATENCY]) << "] FLAGS["
               << SrtFlagString(aw_srtdata[SRT_HS_FLAGS]) << "]");
@@ -1367,7 +1427,7 @@ size_t srt::CUDT::fillHsExtKMREQ(uint32_t* pcmdspec, size_t ki)
     // is ALREADY in network order.
     const uint32_t* keydata = reinterpret_cast<const uint32_t*>(m_pCryptoControl->getKmMsg_data(ki));
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "createSrtHandshake: KMREQ: adding key #" << ki << " length=" << ra_size
               << " words (KmMsg_size=" << msglen << ")");
     // XXX INSECURE ": [" << FormatBinaryString((uint8_t*)keydata, msglen) << "]";
@@ -1392,7 +1452,7 @@ size_t srt::CUDT::fillHsExtKMRSP(uint32_t* pcmdspec, const uint32_t* kmdata, siz
 
     if (kmdata_wordsize == 0)
     {
-        LOGC(cnlog.Warn,
+        SLOGC(cnlog.Warn, m_SocketID,
              log << CONID()
                  << "createSrtHandshake: Agent has PW, but Peer sent no KMREQ. Sending error KMRSP response");
         ra_size = 1;
@@ -1407,7 +1467,7 @@ size_t srt::CUDT::fillHsExtKMRSP(uint32_t* pcmdspec, const uint32_t* kmdata, siz
         if (!kmdata)
         {
             m_RejectReason = SRT_REJ_IPE;
-            LOGC(cnlog.Fatal, log << CONID() << "createSrtHandshake: IPE: srtkm_cmd=SRT_CMD_KMRSP and no kmdata!");
+            SLOGC(cnlog.Fatal, m_SocketID, log << CONID() << "createSrtHandshake: IPE: srtkm_cmd=SRT_CMD_KMRSP and no kmdata!");
             return 0;
         }
         ra_size = kmdata_wordsize;
@@ -1415,7 +1475,7 @@ size_t srt::CUDT::fillHsExtKMRSP(uint32_t* pcmdspec, const uint32_t* kmdata, siz
     }
 
     *pcmdspec = HS_CMDSPEC_CMD::wrap(SRT_CMD_KMRSP) | HS_CMDSPEC_SIZE::wrap((uint32_t) ra_size);
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "createSrtHandshake: KMRSP: applying returned key length="
               << ra_size); // XXX INSECURE << " words: [" << FormatBinaryString((uint8_t*)kmdata,
                            // kmdata_wordsize*sizeof(uint32_t)) << "]";
@@ -1447,7 +1507,7 @@ bool srt::CUDT::createSrtHandshake(
         if (w_hs.m_extension)
         {
             // Should be impossible
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID() << "createSrtHandshake: IPE: EXTENSION SET WHEN peer reports version 4 - fixing...");
             w_hs.m_extension = false;
         }
@@ -1457,7 +1517,7 @@ bool srt::CUDT::createSrtHandshake(
         w_hs.m_iType = 0; // Prepare it for flags
     }
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "createSrtHandshake: buf size=" << w_pkt.getLength()
               << " hsx=" << MessageTypeStr(UMSG_EXT, srths_cmd) << " kmx=" << MessageTypeStr(UMSG_EXT, srtkm_cmd)
               << " kmdata_wordsize=" << kmdata_wordsize << " version=" << w_hs.m_iVersion);
@@ -1475,7 +1535,7 @@ bool srt::CUDT::createSrtHandshake(
         // PREVENT THIS HERE.
         if (w_hs.m_iReqType == URQ_CONCLUSION && srths_cmd == SRT_CMD_HSRSP && is_zero(m_tsRcvPeerStartTime))
         {
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID()
                      << "createSrtHandshake: IPE (non-fatal): Attempting to craft HSRSP without received HSREQ. "
                         "BLOCKING extensions.");
@@ -1492,7 +1552,7 @@ bool srt::CUDT::createSrtHandshake(
         w_hs.m_iType                  = SrtHSRequest::wrapFlags(false /*no magic in HSFLAGS*/, m_config.iSndCryptoKeyLen);
 
         IF_HEAVY_LOGGING(bool whether = m_config.iSndCryptoKeyLen != 0);
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "createSrtHandshake: " << (whether ? "" : "NOT ")
                   << " Advertising PBKEYLEN - value = " << m_config.iSndCryptoKeyLen);
 
@@ -1517,7 +1577,7 @@ bool srt::CUDT::createSrtHandshake(
         size_t hs_size = w_pkt.getLength();
         w_hs.store_to((w_pkt.m_pcData), (hs_size));
         w_pkt.setLength(hs_size);
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "createSrtHandshake: (no ext) size=" << hs_size << " data: " << w_hs.show());
         return true;
     }
@@ -1526,7 +1586,7 @@ bool srt::CUDT::createSrtHandshake(
     if (srths_cmd == SRT_CMD_HSREQ && m_SrtHsSide == HSD_RESPONDER)
     {
         m_RejectReason = SRT_REJ_IPE;
-        LOGC(cnlog.Fatal,
+        SLOGC(cnlog.Fatal, m_SocketID,
              log << CONID() << "IPE: SRT_CMD_HSREQ was requested to be sent in HSv5 by an INITIATOR side!");
         return false; // should cause rejection
     }
@@ -1634,7 +1694,7 @@ bool srt::CUDT::createSrtHandshake(
     }
 #endif
 
-    HLOGC(cnlog.Debug, log << CONID() << "createSrtHandshake: (ext: " << logext.str() << ") data: " << w_hs.show());
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "createSrtHandshake: (ext: " << logext.str() << ") data: " << w_hs.show());
 
     // NOTE: The HSREQ is practically always required, although may happen
     // in future that CONCLUSION can be sent multiple times for a separate
@@ -1663,7 +1723,7 @@ bool srt::CUDT::createSrtHandshake(
     ra_size   = fillSrtHandshake((p + offset), total_ra_size - offset, srths_cmd, HS_VERSION_SRT1);
     *pcmdspec = HS_CMDSPEC_CMD::wrap(srths_cmd) | HS_CMDSPEC_SIZE::wrap((uint32_t) ra_size);
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "createSrtHandshake: after HSREQ: offset=" << offset << " HSREQ size=" << ra_size
               << " space left: " << (total_ra_size - offset));
 
@@ -1678,7 +1738,7 @@ bool srt::CUDT::createSrtHandshake(
         if (m_config.sStreamName.size() >= size_limit)
         {
             m_RejectReason = SRT_REJ_ROGUE;
-            LOGC(cnlog.Warn,
+            SLOGC(cnlog.Warn, m_SocketID,
                  log << CONID() << "createSrtHandshake: stream id too long, limited to " << (size_limit - 1)
                      << " bytes");
             return false;
@@ -1687,7 +1747,7 @@ bool srt::CUDT::createSrtHandshake(
         offset += ra_size + 1;
         ra_size = fillHsExtConfigString(p + offset - 1, SRT_CMD_SID, m_config.sStreamName.str());
 
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "createSrtHandshake: after SID [" << m_config.sStreamName.c_str()
                   << "] length=" << m_config.sStreamName.size() << " alignedln=" << (4 * ra_size)
                   << ": offset=" << offset << " SID size=" << ra_size << " space left: " << (total_ra_size - offset));
@@ -1702,7 +1762,7 @@ bool srt::CUDT::createSrtHandshake(
         offset += ra_size + 1;
         ra_size = fillHsExtConfigString(p + offset - 1, SRT_CMD_CONGESTION, sm);
 
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "createSrtHandshake: after CONGCTL [" << sm << "] length=" << sm.size()
                   << " alignedln=" << (4 * ra_size) << ": offset=" << offset << " CONGCTL size=" << ra_size
                   << " space left: " << (total_ra_size - offset));
@@ -1713,7 +1773,7 @@ bool srt::CUDT::createSrtHandshake(
         offset += ra_size + 1;
         ra_size = fillHsExtConfigString(p + offset - 1, SRT_CMD_FILTER, m_config.sPacketFilterConfig.str());
 
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "createSrtHandshake: after filter [" << m_config.sPacketFilterConfig.c_str()
                   << "] length=" << m_config.sPacketFilterConfig.size() << " alignedln=" << (4 * ra_size) << ": offset="
                   << offset << " filter size=" << ra_size << " space left: " << (total_ra_size - offset));
@@ -1739,7 +1799,7 @@ bool srt::CUDT::createSrtHandshake(
             // This may only happen if since last check of m_GroupOf pointer the socket was removed
             // from the group in the meantime, which can only happen due to that the group was closed.
             // In such a case it simply means that the handshake process was requested to be interrupted.
-            LOGC(cnlog.Fatal, log << CONID() << "GROUP DISAPPEARED. Socket not capable of continuing HS");
+            SLOGC(cnlog.Fatal, m_SocketID, log << CONID() << "GROUP DISAPPEARED. Socket not capable of continuing HS");
             return false;
         }
         else
@@ -1747,14 +1807,14 @@ bool srt::CUDT::createSrtHandshake(
             if (m_parent->m_GroupOf->closing())
             {
                 m_RejectReason = SRT_REJ_IPE;
-                LOGC(cnlog.Error,
+                SLOGC(cnlog.Error, m_SocketID,
                      log << CONID() << "createSrtHandshake: group is closing during the process, rejecting.");
                 return false;
             }
             offset += ra_size + 1;
             ra_size = fillHsExtGroup(p + offset - 1);
 
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "createSrtHandshake: after GROUP [" << sm << "] length=" << sm.size() << ": offset="
                       << offset << " GROUP size=" << ra_size << " space left: " << (total_ra_size - offset));
         }
@@ -1764,14 +1824,14 @@ bool srt::CUDT::createSrtHandshake(
     // When encryption turned on
     if (have_kmreq)
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "createSrtHandshake: "
                   << (m_config.CryptoSecret.len > 0 ? "Agent uses ENCRYPTION" : "Peer requires ENCRYPTION"));
 
         if (!m_pCryptoControl && (srtkm_cmd == SRT_CMD_KMREQ || srtkm_cmd == SRT_CMD_KMRSP))
         {
             m_RejectReason = SRT_REJ_IPE;
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID() << "createSrtHandshake: IPE: need to send KM, but CryptoControl does not exist."
                      << " Socket state: connected=" << boolalpha << m_bConnected << ", connecting=" << m_bConnecting
                      << ", broken=" << m_bBroken << ", closing=" << m_bClosing << ".");
@@ -1798,7 +1858,7 @@ bool srt::CUDT::createSrtHandshake(
             if (!have_any_keys)
             {
                 m_RejectReason = SRT_REJ_IPE;
-                LOGC(cnlog.Error, log << CONID() << "createSrtHandshake: IPE: all keys have expired, no KM to send.");
+                SLOGC(cnlog.Error, m_SocketID, log << CONID() << "createSrtHandshake: IPE: all keys have expired, no KM to send.");
                 return false;
             }
         }
@@ -1810,7 +1870,7 @@ bool srt::CUDT::createSrtHandshake(
         else
         {
             m_RejectReason = SRT_REJ_IPE;
-            LOGC(cnlog.Fatal, log << CONID() << "createSrtHandshake: IPE: wrong value of srtkm_cmd: " << srtkm_cmd);
+            SLOGC(cnlog.Fatal, m_SocketID, log << CONID() << "createSrtHandshake: IPE: wrong value of srtkm_cmd: " << srtkm_cmd);
             return false;
         }
     }
@@ -1825,7 +1885,7 @@ bool srt::CUDT::createSrtHandshake(
     // Switch it again to byte unit.
     w_pkt.setLength((ra_size + offset) * sizeof(int32_t));
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "createSrtHandshake: filled HSv5 handshake flags: "
               << CHandShake::ExtensionFlagStr(w_hs.m_iType) << " length: " << w_pkt.getLength() << " bytes");
 
@@ -1999,7 +2059,7 @@ bool srt::CUDT::processSrtMsg(const CPacket *ctrlpkt)
 
     int res = SRT_CMD_NONE;
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "Dispatching message type=" << etype << " data length=" << (len / sizeof(int32_t)));
     switch (etype)
     {
@@ -2028,19 +2088,19 @@ bool srt::CUDT::processSrtMsg(const CPacket *ctrlpkt)
                 {
                     if (m_config.bEnforcedEnc)
                     {
-                        LOGC(cnlog.Warn,
+                        SLOGC(cnlog.Warn, m_SocketID,
                              log << CONID() << "KMREQ FAILURE: " << KmStateStr(SRT_KM_STATE(srtdata_out[0]))
                                  << " - rejecting per enforced encryption");
                         res = SRT_CMD_NONE;
                         break;
                     }
-                    HLOGC(cnlog.Debug,
+                    HSLOGC(cnlog.Debug, m_SocketID,
                           log << CONID()
                               << "MKREQ -> KMRSP FAILURE state: " << KmStateStr(SRT_KM_STATE(srtdata_out[0])));
                 }
                 else
                 {
-                    HLOGC(cnlog.Debug, log << CONID() << "KMREQ -> requested to send KMRSP length=" << len_out);
+                    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "KMREQ -> requested to send KMRSP length=" << len_out);
                 }
                 sendSrtMsg(SRT_CMD_KMRSP, srtdata_out, len_out);
             }
@@ -2048,7 +2108,7 @@ bool srt::CUDT::processSrtMsg(const CPacket *ctrlpkt)
             // Please review later.
             else
             {
-                LOGC(cnlog.Warn, log << CONID() << "KMREQ failed to process the request - ignoring");
+                SLOGC(cnlog.Warn, m_SocketID, log << CONID() << "KMREQ failed to process the request - ignoring");
             }
 
             return true; // already done what's necessary
@@ -2113,7 +2173,7 @@ int srt::CUDT::processSrtMsg_HSREQ(const uint32_t *srtdata, size_t bytelen, uint
         if (m_uPeerSrtVersion >= SRT_VERSION_FEAT_HSv5)
         {
             m_RejectReason = SRT_REJ_ROGUE;
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID() << "HSREQ/rcv: With HSv4 version >= " << SrtVersionString(SRT_VERSION_FEAT_HSv5)
                      << " is not acceptable.");
             return SRT_CMD_REJECT;
@@ -2124,7 +2184,7 @@ int srt::CUDT::processSrtMsg_HSREQ(const uint32_t *srtdata, size_t bytelen, uint
         if (m_uPeerSrtVersion < SRT_VERSION_FEAT_HSv5)
         {
             m_RejectReason = SRT_REJ_ROGUE;
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID() << "HSREQ/rcv: With HSv5 version must be >= " << SrtVersionString(SRT_VERSION_FEAT_HSv5)
                      << " .");
             return SRT_CMD_REJECT;
@@ -2135,27 +2195,27 @@ int srt::CUDT::processSrtMsg_HSREQ(const uint32_t *srtdata, size_t bytelen, uint
     if (m_uPeerSrtVersion < m_config.uMinimumPeerSrtVersion)
     {
         m_RejectReason = SRT_REJ_VERSION;
-        LOGC(cnlog.Error,
+        SLOGC(cnlog.Error, m_SocketID,
              log << CONID() << "HSREQ/rcv: Peer version: " << SrtVersionString(m_uPeerSrtVersion)
                  << " is too old for requested: " << SrtVersionString(m_config.uMinimumPeerSrtVersion)
                  << " - REJECTING");
         return SRT_CMD_REJECT;
     }
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "HSREQ/rcv: PEER Version: " << SrtVersionString(m_uPeerSrtVersion)
               << " Flags: " << m_uPeerSrtFlags << "(" << SrtFlagString(m_uPeerSrtFlags)
               << ") Min req version:" << SrtVersionString(m_config.uMinimumPeerSrtVersion));
 
     m_bPeerRexmitFlag = IsSet(m_uPeerSrtFlags, SRT_OPT_REXMITFLG);
-    HLOGC(cnlog.Debug, log << CONID() << "HSREQ/rcv: peer " << (m_bPeerRexmitFlag ? "UNDERSTANDS" : "DOES NOT UNDERSTAND") << " REXMIT flag");
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "HSREQ/rcv: peer " << (m_bPeerRexmitFlag ? "UNDERSTANDS" : "DOES NOT UNDERSTAND") << " REXMIT flag");
 
     // Check if both use the same API type. Reject if not.
     bool peer_message_api = !IsSet(m_uPeerSrtFlags, SRT_OPT_STREAM);
     if (peer_message_api != m_config.bMessageAPI)
     {
         m_RejectReason = SRT_REJ_MESSAGEAPI;
-        LOGC(cnlog.Error,
+        SLOGC(cnlog.Error, m_SocketID,
              log << CONID() << "HSREQ/rcv: Agent uses " << (m_config.bMessageAPI ? "MESSAGE" : "STREAM")
                  << " API, but the Peer declares " << (peer_message_api ? "MESSAGE" : "STREAM")
                  << " API. Not compatible transmission type, rejecting.");
@@ -2181,13 +2241,13 @@ int srt::CUDT::processSrtMsg_HSREQ(const uint32_t *srtdata, size_t bytelen, uint
         if (IsSet(m_uPeerSrtFlags, SRT_OPT_TSBPDSND) || IsSet(m_uPeerSrtFlags, SRT_OPT_TSBPDRCV))
         {
             m_RejectReason = SRT_REJ_ROGUE;
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID()
                      << "HSREQ/rcv: Peer sent only VERSION + FLAGS HSREQ, but TSBPD flags are set. Rejecting.");
             return SRT_CMD_REJECT;
         }
 
-        LOGC(cnlog.Warn,
+        SLOGC(cnlog.Warn, m_SocketID,
              log << CONID() << "HSREQ/rcv: Peer sent only VERSION + FLAGS HSREQ, not getting any TSBPD settings.");
         // Don't process any further settings in this case. Turn off TSBPD, just for a case.
         m_bTsbPd     = false;
@@ -2202,7 +2262,7 @@ int srt::CUDT::processSrtMsg_HSREQ(const uint32_t *srtdata, size_t bytelen, uint
         // TimeStamp-based Packet Delivery feature enabled
         if (!isOPT_TsbPd())
         {
-            LOGC(cnlog.Warn,
+            SLOGC(cnlog.Warn, m_SocketID,
                  log << CONID() << "HSREQ/rcv: Agent did not set rcv-TSBPD - ignoring proposed latency from peer");
 
             // Note: also don't set the peer TSBPD flag HERE because
@@ -2230,7 +2290,7 @@ int srt::CUDT::processSrtMsg_HSREQ(const uint32_t *srtdata, size_t bytelen, uint
             // Use the maximum latency out of latency from our settings and the latency
             // "proposed" by the peer.
             int maxdelay = std::max(m_iTsbPdDelay_ms, peer_decl_latency);
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "HSREQ/rcv: LOCAL/RCV LATENCY: Agent:" << m_iTsbPdDelay_ms
                       << " Peer:" << peer_decl_latency << "  Selecting:" << maxdelay);
             m_iTsbPdDelay_ms = maxdelay;
@@ -2240,7 +2300,7 @@ int srt::CUDT::processSrtMsg_HSREQ(const uint32_t *srtdata, size_t bytelen, uint
     else
     {
         std::string how_about_agent = isOPT_TsbPd() ? "BUT AGENT DOES" : "and nor does Agent";
-        HLOGC(cnlog.Debug, log << CONID() << "HSREQ/rcv: Peer DOES NOT USE latency for sending - " << how_about_agent);
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "HSREQ/rcv: Peer DOES NOT USE latency for sending - " << how_about_agent);
     }
 
     // This happens when the HSv5 RESPONDER receives the HSREQ message; it declares
@@ -2258,7 +2318,7 @@ int srt::CUDT::processSrtMsg_HSREQ(const uint32_t *srtdata, size_t bytelen, uint
         // and select the maximum of this one and our proposed latency for the peer.
         int peer_decl_latency = SRT_HS_LATENCY_RCV::unwrap(latencystr);
         int maxdelay          = std::max(m_iPeerTsbPdDelay_ms, peer_decl_latency);
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "HSREQ/rcv: PEER/RCV LATENCY: Agent:" << m_iPeerTsbPdDelay_ms
                   << " Peer:" << peer_decl_latency << " Selecting:" << maxdelay);
         m_iPeerTsbPdDelay_ms = maxdelay;
@@ -2266,7 +2326,7 @@ int srt::CUDT::processSrtMsg_HSREQ(const uint32_t *srtdata, size_t bytelen, uint
     else
     {
         std::string how_about_agent = isOPT_TsbPd() ? "BUT AGENT DOES" : "and nor does Agent";
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "HSREQ/rcv: Peer DOES NOT USE latency for receiving - " << how_about_agent);
     }
 
@@ -2295,14 +2355,14 @@ int srt::CUDT::processSrtMsg_HSRSP(const uint32_t *srtdata, size_t bytelen, uint
     // With HSv4 we accept only version less than 1.3.0
     if (hsv == CUDT::HS_VERSION_UDT4 && srtdata[SRT_HS_VERSION] >= SRT_VERSION_FEAT_HSv5)
     {
-        LOGC(cnlog.Error, log << CONID() << "HSRSP/rcv: With HSv4 version >= 1.2.0 is not acceptable.");
+        SLOGC(cnlog.Error, m_SocketID, log << CONID() << "HSRSP/rcv: With HSv4 version >= 1.2.0 is not acceptable.");
         return SRT_CMD_NONE;
     }
 
     if (bytelen < SRT_CMD_HSRSP_MINSZ)
     {
         /* Packet smaller than minimum compatible packet size */
-        LOGC(cnlog.Error, log << CONID() << "HSRSP/rcv: cmd=" << SRT_CMD_HSRSP << "(HSRSP) len=" << bytelen << " invalid");
+        SLOGC(cnlog.Error, m_SocketID, log << CONID() << "HSRSP/rcv: cmd=" << SRT_CMD_HSRSP << "(HSRSP) len=" << bytelen << " invalid");
         return SRT_CMD_NONE;
     }
 
@@ -2322,13 +2382,13 @@ int srt::CUDT::processSrtMsg_HSRSP(const uint32_t *srtdata, size_t bytelen, uint
         // if the agent has this value already "borrowed" from a master socket
         // that was in the group at the time when it was added.
         m_tsRcvPeerStartTime = steady_clock::now() - microseconds_from(ts);
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID()
                   << "HSRSP/rcv: PEER START TIME not yet defined, setting: " << FormatTime(m_tsRcvPeerStartTime));
     }
     else
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID()
                   << "HSRSP/rcv: PEER START TIME already set (derived): " << FormatTime(m_tsRcvPeerStartTime));
     }
@@ -2343,7 +2403,7 @@ int srt::CUDT::processSrtMsg_HSRSP(const uint32_t *srtdata, size_t bytelen, uint
     if (m_uPeerSrtVersion < m_config.uMinimumPeerSrtVersion)
     {
         m_RejectReason = SRT_REJ_VERSION;
-        LOGC(cnlog.Error,
+        SLOGC(cnlog.Error, m_SocketID,
              log << CONID() << "HSRSP/rcv: Peer version: " << SrtVersionString(m_uPeerSrtVersion)
                  << " is too old for requested: " << SrtVersionString(m_config.uMinimumPeerSrtVersion)
                  << " - REJECTING");
@@ -2358,7 +2418,7 @@ int srt::CUDT::processSrtMsg_HSRSP(const uint32_t *srtdata, size_t bytelen, uint
             // TsbPd feature enabled
             m_bPeerTsbPd         = true;
             m_iPeerTsbPdDelay_ms = SRT_HS_LATENCY_LEG::unwrap(srtdata[SRT_HS_LATENCY]);
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "HSRSP/rcv: LATENCY: Peer/snd:" << m_iPeerTsbPdDelay_ms
                       << " (Agent: declared:" << m_iTsbPdDelay_ms << " rcv:" << m_iTsbPdDelay_ms << ")");
         }
@@ -2374,11 +2434,11 @@ int srt::CUDT::processSrtMsg_HSRSP(const uint32_t *srtdata, size_t bytelen, uint
             // TsbPd feature enabled
             m_bPeerTsbPd         = true;
             m_iPeerTsbPdDelay_ms = SRT_HS_LATENCY_RCV::unwrap(srtdata[SRT_HS_LATENCY]);
-            HLOGC(cnlog.Debug, log << CONID() << "HSRSP/rcv: LATENCY: Peer/snd:" << m_iPeerTsbPdDelay_ms << "ms");
+            HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "HSRSP/rcv: LATENCY: Peer/snd:" << m_iPeerTsbPdDelay_ms << "ms");
         }
         else
         {
-            HLOGC(cnlog.Debug, log << CONID() << "HSRSP/rcv: Peer (responder) DOES NOT USE latency");
+            HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "HSRSP/rcv: Peer (responder) DOES NOT USE latency");
         }
 
         // PEER WILL SEND TSBPD == AGENT SHALL RECEIVE TSBPD.
@@ -2386,7 +2446,7 @@ int srt::CUDT::processSrtMsg_HSRSP(const uint32_t *srtdata, size_t bytelen, uint
         {
             if (!isOPT_TsbPd())
             {
-                LOGC(cnlog.Warn,
+                SLOGC(cnlog.Warn, m_SocketID,
                      log << CONID()
                          << "HSRSP/rcv: BUG? Peer (responder) declares sending latency, but Agent turned off TSBPD.");
             }
@@ -2396,7 +2456,7 @@ int srt::CUDT::processSrtMsg_HSRSP(const uint32_t *srtdata, size_t bytelen, uint
                 // Take this value as a good deal. In case when the Peer did not "correct" the latency
                 // because it has TSBPD turned off, just stay with the present value defined in options.
                 m_iTsbPdDelay_ms = SRT_HS_LATENCY_SND::unwrap(srtdata[SRT_HS_LATENCY]);
-                HLOGC(cnlog.Debug, log << CONID() << "HSRSP/rcv: LATENCY Agent/rcv: " << m_iTsbPdDelay_ms << "ms");
+                HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "HSRSP/rcv: LATENCY Agent/rcv: " << m_iTsbPdDelay_ms << "ms");
             }
         }
     }
@@ -2451,7 +2511,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
     if (m_ConnRes.m_iVersion > HS_VERSION_UDT4 && hs.m_iVersion == 0)
     {
         m_RejectReason = SRT_REJ_PEER;
-        LOGC(cnlog.Error, log << CONID() << "HS VERSION = 0, meaning the handshake has been rejected.");
+        SLOGC(cnlog.Error, m_SocketID, log << CONID() << "HS VERSION = 0, meaning the handshake has been rejected.");
         return false;
     }
 
@@ -2474,7 +2534,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
         m_RejectReason = SRT_REJ_ROGUE;
         // This would mean that the handshake was at least HSv5, but somehow no extras were added.
         // Dismiss it then, however this has to be logged.
-        LOGC(cnlog.Error, log << CONID() << "HS VERSION=" << hs.m_iVersion << " but no handshake extension found!");
+        SLOGC(cnlog.Error, m_SocketID, log << CONID() << "HS VERSION=" << hs.m_iVersion << " but no handshake extension found!");
         return false;
     }
 
@@ -2483,12 +2543,12 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
     if (ext_flags == 0)
     {
         m_RejectReason = SRT_REJ_ROGUE;
-        LOGC(cnlog.Error,
+        SLOGC(cnlog.Error, m_SocketID,
              log << CONID() << "HS VERSION=" << hs.m_iVersion << " but no handshake extension flags are set!");
         return false;
     }
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "HS VERSION=" << hs.m_iVersion
               << " EXTENSIONS: " << CHandShake::ExtensionFlagStr(ext_flags));
 
@@ -2500,7 +2560,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
 
     if (IsSet(ext_flags, CHandShake::HS_EXT_HSREQ))
     {
-        HLOGC(cnlog.Debug, log << CONID() << "interpretSrtHandshake: extracting HSREQ/RSP type extension");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "interpretSrtHandshake: extracting HSREQ/RSP type extension");
         uint32_t *begin    = p;
         uint32_t *next     = 0;
         size_t    length   = size / sizeof(uint32_t);
@@ -2520,7 +2580,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                 if (blocklen < SRT_HS_E_SIZE)
                 {
                     m_RejectReason = SRT_REJ_ROGUE;
-                    LOGC(cnlog.Error,
+                    SLOGC(cnlog.Error, m_SocketID,
                          log << CONID() << "HS-ext HSREQ found but invalid size: " << bytelen
                              << " (expected: " << SRT_HS_E_SIZE << ")");
                     return false; // don't interpret
@@ -2531,7 +2591,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                 if (rescmd != SRT_CMD_HSRSP)
                 {
                     // m_RejectReason already set
-                    LOGC(cnlog.Error,
+                    SLOGC(cnlog.Error, m_SocketID,
                          log << CONID() << "interpretSrtHandshake: process HSREQ returned unexpected value " << rescmd);
                     return false;
                 }
@@ -2546,7 +2606,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                 if (blocklen < SRT_HS_E_SIZE)
                 {
                     m_RejectReason = SRT_REJ_ROGUE;
-                    LOGC(cnlog.Error,
+                    SLOGC(cnlog.Error, m_SocketID,
                          log << CONID() << "HS-ext HSRSP found but invalid size: " << bytelen
                              << " (expected: " << SRT_HS_E_SIZE << ")");
 
@@ -2562,7 +2622,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                     // (unless it's already set)
                     if (m_RejectReason == SRT_REJ_UNKNOWN)
                         m_RejectReason = SRT_REJ_ROGUE;
-                    LOGC(cnlog.Error,
+                    SLOGC(cnlog.Error, m_SocketID,
                          log << CONID() << "interpretSrtHandshake: process HSRSP returned unexpected value " << rescmd);
                     return false;
                 }
@@ -2572,7 +2632,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
             else if (cmd == SRT_CMD_NONE)
             {
                 m_RejectReason = SRT_REJ_ROGUE;
-                LOGC(cnlog.Warn,
+                SLOGC(cnlog.Warn, m_SocketID,
                      log << CONID() << "interpretSrtHandshake: no HSREQ/HSRSP block found in the handshake msg!");
                 // This means that there can be no more processing done by FindExtensionBlock().
                 // And we haven't found what we need - otherwise one of the above cases would pass
@@ -2592,7 +2652,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
         }
     }
 
-    HLOGC(cnlog.Debug, log << CONID() << "interpretSrtHandshake: HSREQ done, checking KMREQ");
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "interpretSrtHandshake: HSREQ done, checking KMREQ");
 
     // Now check the encrypted
 
@@ -2600,7 +2660,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
 
     if (IsSet(ext_flags, CHandShake::HS_EXT_KMREQ))
     {
-        HLOGC(cnlog.Debug, log << CONID() << "interpretSrtHandshake: extracting KMREQ/RSP type extension");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "interpretSrtHandshake: extracting KMREQ/RSP type extension");
 
 #ifdef SRT_ENABLE_ENCRYPTION
         if (!m_pCryptoControl->hasPassphrase())
@@ -2608,14 +2668,14 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
             if (m_config.bEnforcedEnc)
             {
                 m_RejectReason = SRT_REJ_UNSECURE;
-                LOGC(cnlog.Error,
+                SLOGC(cnlog.Error, m_SocketID,
                      log << CONID()
                          << "HS KMREQ: Peer declares encryption, but agent does not - rejecting per enforced "
                             "encryption");
                 return false;
             }
 
-            LOGC(cnlog.Warn,
+            SLOGC(cnlog.Warn, m_SocketID,
                  log << CONID()
                      << "HS KMREQ: Peer declares encryption, but agent does not - still allowing connection.");
 
@@ -2632,7 +2692,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
         {
             int cmd = FindExtensionBlock(begin, length, (blocklen), (next));
 
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "interpretSrtHandshake: found extension: (" << cmd << ") "
                       << MessageTypeStr(UMSG_EXT, cmd));
 
@@ -2642,7 +2702,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                 if (!out_data || !pw_len)
                 {
                     m_RejectReason = SRT_REJ_IPE;
-                    LOGC(cnlog.Fatal, log << CONID() << "IPE: HS/KMREQ extracted without passing target buffer!");
+                    SLOGC(cnlog.Fatal, m_SocketID, log << CONID() << "IPE: HS/KMREQ extracted without passing target buffer!");
                     return false;
                 }
 
@@ -2652,7 +2712,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                 {
                     m_RejectReason = SRT_REJ_IPE;
                     // Something went wrong.
-                    HLOGC(cnlog.Debug,
+                    HSLOGC(cnlog.Debug, m_SocketID,
                           log << CONID() << "interpretSrtHandshake: IPE/EPE KMREQ processing failed - returned "
                               << res);
                     return false;
@@ -2664,7 +2724,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                     {
                         // Cryptographic modes mismatch. Not acceptable at all.
                         m_RejectReason = SRT_REJ_CRYPTO;
-                        LOGC(cnlog.Error,
+                        SLOGC(cnlog.Error, m_SocketID,
                              log << CONID()
                                  << "interpretSrtHandshake: KMREQ result: Bad crypto mode - rejecting");
                         return false;
@@ -2683,7 +2743,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                         {
                             m_RejectReason = SRT_REJ_UNSECURE;
                         }
-                        LOGC(cnlog.Error,
+                        SLOGC(cnlog.Error, m_SocketID,
                              log << CONID()
                                  << "interpretSrtHandshake: KMREQ result abnornal - rejecting per enforced encryption");
                         return false;
@@ -2704,7 +2764,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
 #endif
                     else
                         m_RejectReason = SRT_REJ_UNSECURE;
-                    LOGC(cnlog.Error,
+                    SLOGC(cnlog.Error, m_SocketID,
                          log << CONID() << "KMRSP failed - rejecting connection as per enforced encryption.");
                     return false;
                 }
@@ -2713,12 +2773,12 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
             else if (cmd == SRT_CMD_NONE)
             {
                 m_RejectReason = SRT_REJ_ROGUE;
-                LOGC(cnlog.Error, log << CONID() << "HS KMREQ expected - none found!");
+                SLOGC(cnlog.Error, m_SocketID, log << CONID() << "HS KMREQ expected - none found!");
                 return false;
             }
             else
             {
-                HLOGC(cnlog.Debug, log << CONID() << "interpretSrtHandshake: ... skipping " << MessageTypeStr(UMSG_EXT, cmd));
+                HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "interpretSrtHandshake: ... skipping " << MessageTypeStr(UMSG_EXT, cmd));
                 if (NextExtensionBlock((begin), next, (length)))
                     continue;
             }
@@ -2732,14 +2792,14 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
         if (m_config.bEnforcedEnc)
         {
             m_RejectReason = SRT_REJ_UNSECURE;
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID()
                      << "HS KMREQ: Peer declares encryption, but agent didn't enable it at compile time - rejecting "
                         "per enforced encryption");
             return false;
         }
 
-        LOGC(cnlog.Warn,
+        SLOGC(cnlog.Warn, m_SocketID,
              log << CONID()
                  << "HS KMREQ: Peer declares encryption, but agent didn't enable it at compile time - still allowing "
                     "connection.");
@@ -2760,7 +2820,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
 
     if (IsSet(ext_flags, CHandShake::HS_EXT_CONFIG))
     {
-        HLOGC(cnlog.Debug, log << CONID() << "interpretSrtHandshake: extracting various CONFIG extensions");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "interpretSrtHandshake: extracting various CONFIG extensions");
 
         uint32_t *begin    = p;
         uint32_t *next     = 0;
@@ -2771,7 +2831,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
         {
             int cmd = FindExtensionBlock(begin, length, (blocklen), (next));
 
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "interpretSrtHandshake: found extension: (" << cmd << ") "
                       << MessageTypeStr(UMSG_EXT, cmd));
 
@@ -2780,7 +2840,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
             {
                 if (!bytelen || bytelen > CSrtConfig::MAX_SID_LENGTH)
                 {
-                    LOGC(cnlog.Error,
+                    SLOGC(cnlog.Error, m_SocketID,
                          log << CONID() << "interpretSrtHandshake: STREAMID length " << bytelen << " is 0 or > "
                              << +CSrtConfig::MAX_SID_LENGTH << " - PROTOCOL ERROR, REJECTING");
                     return false;
@@ -2815,7 +2875,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                 }
 
                 m_config.sStreamName.set(target, targetlen);
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID() << "CONNECTOR'S REQUESTED SID [" << m_config.sStreamName.c_str()
                           << "] (bytelen=" << bytelen << " blocklen=" << blocklen << ")");
             }
@@ -2824,13 +2884,13 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                 if (have_congctl)
                 {
                     m_RejectReason = SRT_REJ_ROGUE;
-                    LOGC(cnlog.Error, log << CONID() << "CONGCTL BLOCK REPEATED!");
+                    SLOGC(cnlog.Error, m_SocketID, log << CONID() << "CONGCTL BLOCK REPEATED!");
                     return false;
                 }
 
                 if (!bytelen || bytelen > CSrtConfig::MAX_CONG_LENGTH)
                 {
-                    LOGC(cnlog.Error,
+                    SLOGC(cnlog.Error, m_SocketID,
                          log << CONID() << "interpretSrtHandshake: CONGESTION-control type length " << bytelen
                              << " is 0 or > " << +CSrtConfig::MAX_CONG_LENGTH << " - PROTOCOL ERROR, REJECTING");
                     return false;
@@ -2852,13 +2912,13 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                 if (sm != agsm)
                 {
                     m_RejectReason = SRT_REJ_CONGESTION;
-                    LOGC(cnlog.Error,
+                    SLOGC(cnlog.Error, m_SocketID,
                          log << CONID() << "PEER'S CONGCTL '" << sm << "' does not match AGENT'S CONGCTL '" << agsm
                              << "'");
                     return false;
                 }
 
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID() << "CONNECTOR'S CONGCTL [" << sm << "] (bytelen=" << bytelen
                           << " blocklen=" << blocklen << ")");
             }
@@ -2867,13 +2927,13 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                 if (have_filter)
                 {
                     m_RejectReason = SRT_REJ_FILTER;
-                    LOGC(cnlog.Error, log << CONID() << "FILTER BLOCK REPEATED!");
+                    SLOGC(cnlog.Error, m_SocketID, log << CONID() << "FILTER BLOCK REPEATED!");
                     return false;
                 }
 
                 if (!bytelen || bytelen > CSrtConfig::MAX_PFILTER_LENGTH)
                 {
-                    LOGC(cnlog.Error,
+                    SLOGC(cnlog.Error, m_SocketID,
                          log << CONID() << "interpretSrtHandshake: packet-filter type length " << bytelen
                              << " is 0 or > " << +CSrtConfig::MAX_PFILTER_LENGTH << " - PROTOCOL ERROR, REJECTING");
                     return false;
@@ -2889,14 +2949,14 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
 
                 string fltcfg = target;
 
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID() << "PEER'S FILTER CONFIG [" << fltcfg << "] (bytelen=" << bytelen
                           << " blocklen=" << blocklen << ")");
 
                 if (!checkApplyFilterConfig(fltcfg))
                 {
                     m_RejectReason = SRT_REJ_FILTER;
-                    LOGC(cnlog.Error, log << CONID() << "PEER'S FILTER CONFIG [" << fltcfg << "] has been rejected");
+                    SLOGC(cnlog.Error, m_SocketID, log << CONID() << "PEER'S FILTER CONFIG [" << fltcfg << "] has been rejected");
                     return false;
                 }
             }
@@ -2913,7 +2973,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                 if (bytelen < GRPD_MIN_SIZE * GRPD_FIELD_SIZE || bytelen % GRPD_FIELD_SIZE)
                 {
                     m_RejectReason = SRT_REJ_ROGUE;
-                    LOGC(cnlog.Error, log << CONID() << "PEER'S GROUP wrong size: " << (bytelen/GRPD_FIELD_SIZE));
+                    SLOGC(cnlog.Error, m_SocketID, log << CONID() << "PEER'S GROUP wrong size: " << (bytelen/GRPD_FIELD_SIZE));
                     return false;
                 }
                 size_t groupdata_size = bytelen / GRPD_FIELD_SIZE;
@@ -2926,7 +2986,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
                 }
 
                 have_group = true;
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID() << "CONNECTOR'S PEER GROUP [" << groupdata[0] << "] (bytelen=" << bytelen
                           << " blocklen=" << blocklen << ")");
             }
@@ -2938,7 +2998,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
             else
             {
                 // Found some block that is not interesting here. Skip this and get the next one.
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID() << "interpretSrtHandshake: ... skipping " << MessageTypeStr(UMSG_EXT, cmd));
             }
 
@@ -2954,14 +3014,14 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
         if (m_config.bEnforcedEnc)
         {
             m_RejectReason = SRT_REJ_UNSECURE;
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID()
                      << "HS EXT: Agent declares encryption, but Peer does not - rejecting connection per "
                         "enforced encryption.");
             return false;
         }
 
-        LOGC(cnlog.Warn,
+        SLOGC(cnlog.Warn, m_SocketID,
              log << CONID()
                  << "HS EXT: Agent declares encryption, but Peer does not (Agent can still receive unencrypted packets "
                     "from Peer).");
@@ -2978,7 +3038,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
     if (agsm != "live" && !have_congctl)
     {
         m_RejectReason = SRT_REJ_CONGESTION;
-        LOGC(cnlog.Error,
+        SLOGC(cnlog.Error, m_SocketID,
              log << CONID() << "HS EXT: Agent uses '" << agsm
                  << "' congctl, but peer DID NOT DECLARE congctl (assuming 'live').");
         return false;
@@ -2996,7 +3056,7 @@ bool srt::CUDT::interpretSrtHandshake(const CHandShake& hs,
         if (!have_group)
         {
             m_RejectReason = SRT_REJ_GROUP;
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID()
                      << "HS EXT: agent is a group member, but the listener did not respond with group ID. Rejecting.");
             return false;
@@ -3055,7 +3115,7 @@ bool srt::CUDT::checkApplyFilterConfig(const std::string &confstr)
                 return false;
         }
 
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "checkApplyFilterConfig: param: LOCAL: " << Printable(mycfg.parameters)
                   << " FORGN: " << Printable(cfg.parameters));
 
@@ -3068,12 +3128,12 @@ bool srt::CUDT::checkApplyFilterConfig(const std::string &confstr)
 
         m_config.sPacketFilterConfig.set(myos.str());
 
-        HLOGC(cnlog.Debug, log << CONID() << "checkApplyFilterConfig: Effective config: " << thisconf);
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "checkApplyFilterConfig: Effective config: " << thisconf);
     }
     else
     {
         // Take the foreign configuration as a good deal.
-        HLOGC(cnlog.Debug, log << CONID() << "checkApplyFilterConfig: Good deal config: " << thisconf);
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "checkApplyFilterConfig: Good deal config: " << thisconf);
         m_config.sPacketFilterConfig.set(confstr);
     }
 
@@ -3082,7 +3142,7 @@ bool srt::CUDT::checkApplyFilterConfig(const std::string &confstr)
     size_t efc_max_payload_size = SRT_LIVE_MAX_PLSIZE - cfg.extra_size;
     if (m_config.zExpPayloadSize > efc_max_payload_size)
     {
-        LOGC(cnlog.Warn,
+        SLOGC(cnlog.Warn, m_SocketID,
              log << CONID() << "Due to filter-required extra " << cfg.extra_size << " bytes, SRTO_PAYLOADSIZE fixed to "
                  << efc_max_payload_size << " bytes");
         m_config.zExpPayloadSize = efc_max_payload_size;
@@ -3110,7 +3170,7 @@ bool srt::CUDT::interpretGroup(const int32_t groupdata[], size_t data_size SRT_A
     if (m_config.iGroupConnect == 0)
     {
         m_RejectReason = SRT_REJ_GROUP;
-        LOGC(cnlog.Error, log << CONID() << "HS/GROUP: this socket is not allowed for group connect.");
+        SLOGC(cnlog.Error, m_SocketID, log << CONID() << "HS/GROUP: this socket is not allowed for group connect.");
         return false;
     }
 
@@ -3118,7 +3178,7 @@ bool srt::CUDT::interpretGroup(const int32_t groupdata[], size_t data_size SRT_A
     if (gtp >= SRT_GTYPE_E_END)
     {
         m_RejectReason = SRT_REJ_GROUP;
-        LOGC(cnlog.Error,
+        SLOGC(cnlog.Error, m_SocketID,
              log << CONID() << "HS/GROUP: incorrect group type value " << gtp << " (max is " << SRT_GTYPE_E_END << ")");
         return false;
     }
@@ -3126,7 +3186,7 @@ bool srt::CUDT::interpretGroup(const int32_t groupdata[], size_t data_size SRT_A
     if ((grpid & SRTGROUP_MASK) == 0)
     {
         m_RejectReason = SRT_REJ_ROGUE;
-        LOGC(cnlog.Error, log << CONID() << "HS/GROUP: socket ID passed as a group ID is not a group ID");
+        SLOGC(cnlog.Error, m_SocketID, log << CONID() << "HS/GROUP: socket ID passed as a group ID is not a group ID");
         return false;
     }
 
@@ -3137,7 +3197,7 @@ bool srt::CUDT::interpretGroup(const int32_t groupdata[], size_t data_size SRT_A
 
 #if ENABLE_HEAVY_LOGGING
     static const char* hs_side_name[] = {"draw", "initiator", "responder"};
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "interpretGroup: STATE: HsSide=" << hs_side_name[m_SrtHsSide]
               << " HS MSG: " << MessageTypeStr(UMSG_EXT, hsreq_type_cmd) << " $" << grpid << " type=" << gtp
               << " weight=" << link_weight << " flags=0x" << std::hex << link_flags);
@@ -3152,7 +3212,7 @@ bool srt::CUDT::interpretGroup(const int32_t groupdata[], size_t data_size SRT_A
     if (m_SrtHsSide == HSD_DRAW)
     {
         m_RejectReason = SRT_REJ_IPE;
-        LOGC(cnlog.Error,
+        SLOGC(cnlog.Error, m_SocketID,
              log << CONID()
                  << "IPE: interpretGroup: The HS side should have been already decided; it's still DRAW. Grouping "
                     "rejected.");
@@ -3177,7 +3237,7 @@ bool srt::CUDT::interpretGroup(const int32_t groupdata[], size_t data_size SRT_A
             // but the initiator did not request any group membership presence.
             // Currently impossible situation.
             m_RejectReason = SRT_REJ_IPE;
-            LOGC(cnlog.Error, log << CONID() << "IPE: HS/RSP: group membership responded, while not requested.");
+            SLOGC(cnlog.Error, m_SocketID, log << CONID() << "IPE: HS/RSP: group membership responded, while not requested.");
             return false;
         }
 
@@ -3187,7 +3247,7 @@ bool srt::CUDT::interpretGroup(const int32_t groupdata[], size_t data_size SRT_A
         // Now we know the group exists, but it might still be closed
         if (pg->closing())
         {
-            LOGC(cnlog.Error, log << CONID() << "HS/RSP: group was closed in the process, can't continue connecting");
+            SLOGC(cnlog.Error, m_SocketID, log << CONID() << "HS/RSP: group was closed in the process, can't continue connecting");
             m_RejectReason = SRT_REJ_IPE;
             return false;
         }
@@ -3198,7 +3258,7 @@ bool srt::CUDT::interpretGroup(const int32_t groupdata[], size_t data_size SRT_A
             // This is the first connection within this group, so this group
             // has just been informed about the peer membership. Accept it.
             pg->set_peerid(grpid);
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "HS/RSP: group $" << pg->id() << " -> peer $" << pg->peerid()
                       << ", copying characteristic data");
 
@@ -3214,7 +3274,7 @@ bool srt::CUDT::interpretGroup(const int32_t groupdata[], size_t data_size SRT_A
         // different peers).
         else if (peer != grpid)
         {
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID() << "IPE: HS/RSP: group membership responded for peer $" << grpid
                      << " but the current socket's group $" << pg->id() << " has already a peer $" << peer);
             m_RejectReason = SRT_REJ_GROUP;
@@ -3222,7 +3282,7 @@ bool srt::CUDT::interpretGroup(const int32_t groupdata[], size_t data_size SRT_A
         }
         else
         {
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "HS/RSP: group $" << pg->id() << " ALREADY MAPPED to peer mirror $"
                       << pg->peerid());
         }
@@ -3250,7 +3310,7 @@ bool srt::CUDT::interpretGroup(const int32_t groupdata[], size_t data_size SRT_A
         {
             // Strange, we just added it...
             m_RejectReason = SRT_REJ_IPE;
-            LOGC(cnlog.Fatal, log << CONID() << "IPE: socket not in group after adding to it");
+            SLOGC(cnlog.Fatal, m_SocketID, log << CONID() << "IPE: socket not in group after adding to it");
             return false;
         }
 
@@ -3292,13 +3352,13 @@ SRTSOCKET srt::CUDT::makeMePeerOf(SRTSOCKET peergroup, SRT_GROUP_TYPE gtp, uint3
     {
         if (gp->type() != gtp)
         {
-            LOGC(gmlog.Error,
+            SLOGC(gmlog.Error, m_SocketID,
                  log << CONID() << "HS: GROUP TYPE COLLISION: peer group=$" << peergroup << " type " << gtp
                      << " agent group=$" << gp->id() << " type" << gp->type());
             return -1;
         }
 
-        HLOGC(gmlog.Debug, log << CONID() << "makeMePeerOf: group for peer=$" << peergroup << " found: $" << gp->id());
+        HSLOGC(gmlog.Debug, m_SocketID, log << CONID() << "makeMePeerOf: group for peer=$" << peergroup << " found: $" << gp->id());
 
         if (!gp->groupEmpty())
             was_empty = false;
@@ -3330,7 +3390,7 @@ SRTSOCKET srt::CUDT::makeMePeerOf(SRTSOCKET peergroup, SRT_GROUP_TYPE gtp, uint3
         // Therefore such a group shall always be considered opened.
         gp->setOpen();
 
-        HLOGC(gmlog.Debug,
+        HSLOGC(gmlog.Debug, m_SocketID,
               log << CONID() << "makeMePeerOf: no group has peer=$" << peergroup << " - creating new mirror group $"
                   << gp->id());
     }
@@ -3339,7 +3399,7 @@ SRTSOCKET srt::CUDT::makeMePeerOf(SRTSOCKET peergroup, SRT_GROUP_TYPE gtp, uint3
         ScopedLock glock (*gp->exp_groupLock());
         if (gp->closing())
         {
-            HLOGC(gmlog.Debug, log << CONID() << "makeMePeerOf: group $" << gp->id() << " is being closed, can't process");
+            HSLOGC(gmlog.Debug, m_SocketID, log << CONID() << "makeMePeerOf: group $" << gp->id() << " is being closed, can't process");
         }
 
         if (was_empty)
@@ -3360,7 +3420,7 @@ SRTSOCKET srt::CUDT::makeMePeerOf(SRTSOCKET peergroup, SRT_GROUP_TYPE gtp, uint3
     {
         // XXX This is internal error. Report it, but continue
         // (A newly created socket from acceptAndRespond should not have any group membership yet)
-        LOGC(gmlog.Error, log << CONID() << "IPE (non-fatal): the socket is in the group, but has no clue about it!");
+        SLOGC(gmlog.Error, m_SocketID, log << CONID() << "IPE (non-fatal): the socket is in the group, but has no clue about it!");
         s->m_GroupOf         = gp;
         s->m_GroupMemberData = f;
         return 0;
@@ -3389,7 +3449,7 @@ void srt::CUDT::synchronizeWithGroup(CUDTGroup* gp)
 
     if (!gp->applyGroupTime((start_time), (peer_start_time)))
     {
-        HLOGC(gmlog.Debug,
+        HSLOGC(gmlog.Debug, m_SocketID,
               log << CONID() << "synchronizeWithGroup: ST=" << FormatTime(m_stats.tsStartTime) << " -> "
                   << FormatTime(start_time) << " PST=" << FormatTime(m_tsRcvPeerStartTime) << " -> "
                   << FormatTime(peer_start_time));
@@ -3399,7 +3459,7 @@ void srt::CUDT::synchronizeWithGroup(CUDTGroup* gp)
     else
     {
         // This was the first connected socket and it defined start time.
-        HLOGC(gmlog.Debug,
+        HSLOGC(gmlog.Debug, m_SocketID,
               log << CONID() << "synchronizeWithGroup: ST=" << FormatTime(m_stats.tsStartTime)
                   << " PST=" << FormatTime(m_tsRcvPeerStartTime));
     }
@@ -3435,7 +3495,7 @@ void srt::CUDT::synchronizeWithGroup(CUDTGroup* gp)
     }
     else
     {
-        HLOGC(gmlog.Debug,
+        HSLOGC(gmlog.Debug, m_SocketID,
               log << CONID() << "AFTER HS: (GROUP, but "
                   << (m_bTsbPd ? "FIRST SOCKET is initialized normally)" : "no TSBPD set)"));
         updateSrtRcvSettings();
@@ -3449,7 +3509,7 @@ void srt::CUDT::synchronizeWithGroup(CUDTGroup* gp)
     int32_t snd_isn = m_iSndLastAck, rcv_isn = m_iRcvLastAck;
     if (!gp->applyGroupSequences(m_SocketID, (snd_isn), (rcv_isn)))
     {
-        HLOGC(gmlog.Debug,
+        HSLOGC(gmlog.Debug, m_SocketID,
                 log << CONID() << "synchronizeWithGroup: DERIVED ISN: RCV=%" << m_iRcvLastAck << " -> %" << rcv_isn
                 << " (shift by " << CSeqNo::seqcmp(rcv_isn, m_iRcvLastAck) << ") SND=%" << m_iSndLastAck
                 << " -> %" << snd_isn << " (shift by " << CSeqNo::seqcmp(snd_isn, m_iSndLastAck) << ")");
@@ -3458,7 +3518,7 @@ void srt::CUDT::synchronizeWithGroup(CUDTGroup* gp)
     }
     else
     {
-        HLOGC(gmlog.Debug,
+        HSLOGC(gmlog.Debug, m_SocketID,
                 log << CONID() << "synchronizeWithGroup: DEFINED ISN: RCV=%" << m_iRcvLastAck << " SND=%"
                 << m_iSndLastAck);
     }
@@ -3469,7 +3529,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
 {
     ScopedLock cg (m_ConnectionLock);
 
-    HLOGC(aclog.Debug, log << CONID() << "startConnect: -> " << serv_addr.str()
+    HSLOGC(aclog.Debug, m_SocketID, log << CONID() << "startConnect: -> " << serv_addr.str()
             << (m_config.bSynRecving ? " (SYNCHRONOUS)" : " (ASYNCHRONOUS)") << "...");
 
     if (!m_bOpened)
@@ -3526,7 +3586,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
         // SRT didn't read this field from URQ_WAVEAHAND message, only URQ_CONCLUSION.
         m_ConnReq.m_iType           = SrtHSRequest::wrapFlags(false /* no MAGIC here */, m_config.iSndCryptoKeyLen);
         IF_HEAVY_LOGGING(const bool whether = m_config.iSndCryptoKeyLen != 0);
-        HLOGC(aclog.Debug,
+        HSLOGC(aclog.Debug, m_SocketID,
               log << CONID() << "startConnect (rnd): " << (whether ? "" : "NOT ")
                   << " Advertising PBKEYLEN - value = " << m_config.iSndCryptoKeyLen);
         m_RdvState  = CHandShake::RDV_WAVING;
@@ -3559,11 +3619,11 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
     if (forced_isn == SRT_SEQNO_NONE)
     {
         forced_isn = generateISN();
-        HLOGC(aclog.Debug, log << CONID() << "startConnect: ISN generated = " << forced_isn);
+        HSLOGC(aclog.Debug, m_SocketID, log << CONID() << "startConnect: ISN generated = " << forced_isn);
     }
     else
     {
-        HLOGC(aclog.Debug, log << CONID() << "startConnect: ISN forced = " << forced_isn);
+        HSLOGC(aclog.Debug, m_SocketID, log << CONID() << "startConnect: ISN forced = " << forced_isn);
     }
 
     m_iISN = m_ConnReq.m_iISN = forced_isn;
@@ -3599,7 +3659,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
     m_SndLastAck2Time = tnow;
     setPacketTS(reqpkt, tnow);
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "CUDT::startConnect: REQ-TIME set HIGH (TimeStamp: " << reqpkt.timestamp()
               << "). SENDING HS: " << m_ConnReq.show());
 
@@ -3631,7 +3691,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
     //////////////////////////////////////////////////////
     if (!m_config.bSynRecving)
     {
-        HLOGC(cnlog.Debug, log << CONID() << "startConnect: ASYNC MODE DETECTED. Deferring the process to RcvQ:worker");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "startConnect: ASYNC MODE DETECTED. Deferring the process to RcvQ:worker");
         return;
     }
 
@@ -3667,7 +3727,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
         // the next iteration.
         if (count_milliseconds(tdiff) > 250)
         {
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "startConnect: LOOP: time to send (" << count_milliseconds(tdiff)
                       << " > 250 ms). size=" << reqpkt.getLength());
 
@@ -3678,7 +3738,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
             {
                 CHandShake debughs;
                 debughs.load_from(reqpkt.m_pcData, reqpkt.getLength());
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID() << "startConnect: REQ-TIME HIGH."
                           << " cont/sending HS to peer: " << debughs.show());
             }
@@ -3690,7 +3750,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
         }
         else
         {
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "startConnect: LOOP: too early to send - " << count_milliseconds(tdiff)
                       << " < 250ms");
         }
@@ -3701,10 +3761,10 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
         {
             use_source_adr = response.udpDestAddr();
 
-            HLOGC(cnlog.Debug, log << CONID() << "startConnect: got response for connect request");
+            HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "startConnect: got response for connect request");
             cst = processConnectResponse(response, &e);
 
-            HLOGC(cnlog.Debug, log << CONID() << "startConnect: response processing result: " << ConnectStatusStr(cst));
+            HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "startConnect: response processing result: " << ConnectStatusStr(cst));
 
             // Expected is that:
             // - the peer responded with URQ_INDUCTION + cookie. This above function
@@ -3739,7 +3799,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
                 if (cst == CONN_CONTINUE)
                     continue;
 
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                         log << CONID() << "startConnect: processRendezvous returned cst=" << ConnectStatusStr(cst));
 
                 if (cst == CONN_REJECT)
@@ -3757,7 +3817,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
 
             if (cst == CONN_REJECT)
             {
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                         log << CONID() << "startConnect: REJECTED by processConnectResponse - sending SHUTDOWN");
                 sendCtrl(UMSG_SHUTDOWN);
             }
@@ -3769,7 +3829,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
             // [[using assert(m_pCryptoControl != nullptr)]];
 
             // new request/response should be sent out immediately on receiving a response
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "startConnect: SYNC CONNECTION STATUS:" << ConnectStatusStr(cst)
                       << ", REQ-TIME: LOW.");
             m_tsLastReqTime = steady_clock::time_point();
@@ -3784,7 +3844,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
             // small to store the CONCLUSION handshake (with HSv5 extensions).
             reqpkt.setLength(m_iMaxSRTPayloadSize);
 
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "startConnect: creating HS CONCLUSION: buffer size=" << reqpkt.getLength());
 
             // NOTE: BUGFIX: SERIALIZE AGAIN.
@@ -3803,7 +3863,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
             // are sent only when there is a rendezvous mode or non-blocking mode.
             if (!createSrtHandshake(SRT_CMD_HSREQ, SRT_CMD_KMREQ, 0, 0, (reqpkt), (m_ConnReq)))
             {
-                LOGC(cnlog.Warn, log << CONID() << "createSrtHandshake failed - REJECTING.");
+                SLOGC(cnlog.Warn, m_SocketID, log << CONID() << "createSrtHandshake failed - REJECTING.");
                 cst = CONN_REJECT;
                 break;
             }
@@ -3814,14 +3874,14 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
             // listener should respond with HS_VERSION_SRT1, if it is HSv5 capable.
         }
 
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "startConnect: timeout from Q:recvfrom, looping again; cst=" << ConnectStatusStr(cst));
 
 #if ENABLE_HEAVY_LOGGING
         // Non-fatal assertion
         if (cst == CONN_REJECT) // Might be returned by processRendezvous
         {
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID()
                      << "startConnect: IPE: cst=REJECT NOT EXPECTED HERE, the loop should've been interrupted!");
             break;
@@ -3833,7 +3893,7 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
             // timeout
             e = CUDTException(MJ_SETUP, MN_TIMEOUT, 0);
             m_RejectReason = SRT_REJ_TIMEOUT;
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "startConnect: TTL time " << FormatTime(ttl_time) << " exceeded, TIMEOUT.");
             break;
         }
@@ -3870,11 +3930,11 @@ void srt::CUDT::startConnect(const sockaddr_any& serv_addr, int32_t forced_isn)
         throw e;
     }
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "startConnect: handshake exchange succeeded. sourceIP=" << m_SourceAddr.str());
 
     // Parameters at the end.
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "startConnect: END. Parameters: mss=" << m_config.iMSS
               << " max-cwnd-size=" << m_CongCtl->cgWindowMaxSize() << " cwnd-size=" << m_CongCtl->cgWindowSize()
               << " rtt=" << m_iSRTT << " bw=" << m_iBandwidth);
@@ -3887,10 +3947,10 @@ EConnectStatus srt::CUDT::processAsyncConnectResponse(const CPacket &pkt) ATR_NO
     CUDTException  e;
 
     ScopedLock cg(m_ConnectionLock);
-    HLOGC(cnlog.Debug, log << CONID() << "processAsyncConnectResponse: got response for connect request, processing");
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processAsyncConnectResponse: got response for connect request, processing");
     cst = processConnectResponse(pkt, &e);
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "processAsyncConnectResponse: response processing result: " << ConnectStatusStr(cst)
               << "; REQ-TIME LOW to enforce immediate response");
     m_tsLastReqTime = steady_clock::time_point();
@@ -3916,7 +3976,7 @@ bool srt::CUDT::processAsyncConnectRequest(EReadStatus         rst,
     const steady_clock::time_point now = steady_clock::now();
     setPacketTS(reqpkt, now);
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "processAsyncConnectRequest: REQ-TIME: HIGH. Should prevent too quick responses.");
     m_tsLastReqTime = now;
     // ID = 0, connection request
@@ -3930,11 +3990,11 @@ bool srt::CUDT::processAsyncConnectRequest(EReadStatus         rst,
 
     if (cst == CONN_RENDEZVOUS)
     {
-        HLOGC(cnlog.Debug, log << CONID() << "processAsyncConnectRequest: passing to processRendezvous");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processAsyncConnectRequest: passing to processRendezvous");
         cst = processRendezvous(pResponse, serv_addr, rst, (reqpkt));
         if (cst == CONN_ACCEPT)
         {
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID()
                       << "processAsyncConnectRequest: processRendezvous completed the process and responded by itself. "
                          "Done.");
@@ -3944,7 +4004,7 @@ bool srt::CUDT::processAsyncConnectRequest(EReadStatus         rst,
         if (cst != CONN_CONTINUE)
         {
             // processRendezvous already set the reject reason
-            LOGC(cnlog.Warn,
+            SLOGC(cnlog.Warn, m_SocketID,
                  log << CONID()
                      << "processAsyncConnectRequest: REJECT reported from processRendezvous, not processing further.");
 
@@ -3958,7 +4018,7 @@ bool srt::CUDT::processAsyncConnectRequest(EReadStatus         rst,
     else if (cst == CONN_REJECT)
     {
         // m_RejectReason already set at worker_ProcessAddressedPacket.
-        LOGC(cnlog.Warn,
+        SLOGC(cnlog.Warn, m_SocketID,
              log << CONID() << "processAsyncConnectRequest: REJECT reported from HS processing: "
                  << srt_rejectreason_str(m_RejectReason) << " - not processing further");
         // m_tsLastReqTime = steady_clock::time_point(); XXX ?
@@ -3967,18 +4027,18 @@ bool srt::CUDT::processAsyncConnectRequest(EReadStatus         rst,
     else
     {
         // (this procedure will be also run for HSv4 rendezvous)
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "processAsyncConnectRequest: serializing HS: buffer size=" << reqpkt.getLength());
         if (!createSrtHandshake(SRT_CMD_HSREQ, SRT_CMD_KMREQ, 0, 0, (reqpkt), (m_ConnReq)))
         {
             // All 'false' returns from here are IPE-type, mostly "invalid argument" plus "all keys expired".
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID() << "IPE: processAsyncConnectRequest: createSrtHandshake failed, dismissing.");
             status = false;
         }
         else
         {
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID()
                       << "processAsyncConnectRequest: sending HS reqtype=" << RequestTypeStr(m_ConnReq.m_iReqType)
                       << " to socket " << reqpkt.id() << " size=" << reqpkt.getLength());
@@ -3997,7 +4057,7 @@ bool srt::CUDT::processAsyncConnectRequest(EReadStatus         rst,
         */
     }
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "processAsyncConnectRequest: setting REQ-TIME HIGH, SENDING HS:" << m_ConnReq.show());
     m_tsLastReqTime = steady_clock::now();
     m_pSndQueue->sendto(serv_addr, reqpkt, m_SourceAddr);
@@ -4015,7 +4075,7 @@ void srt::CUDT::sendRendezvousRejection(const sockaddr_any& serv_addr, CPacket&
     m_ConnReq.store_to((r_rsppkt.m_pcData), (size));
     r_rsppkt.setLength(size);
 
-    HLOGC(cnlog.Debug, log << CONID() << "sendRendezvousRejection: using code=" << m_ConnReq.m_iReqType
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "sendRendezvousRejection: using code=" << m_ConnReq.m_iReqType
             << " for reject reason code " << m_RejectReason << " (" << srt_rejectreason_str(m_RejectReason) << ")");
 
     setPacketTS(r_rsppkt, steady_clock::now());
@@ -4027,7 +4087,7 @@ void srt::CUDT::cookieContest()
     if (m_SrtHsSide != HSD_DRAW)
         return;
 
-    LOGC(cnlog.Debug,
+    SLOGC(cnlog.Debug, m_SocketID,
          log << CONID() << "cookieContest: agent=" << m_ConnReq.m_iCookie << " peer=" << m_ConnRes.m_iCookie);
 
     // Here m_ConnReq.m_iCookie is a local cookie value sent in connection request to the peer.
@@ -4099,7 +4159,7 @@ EConnectStatus srt::CUDT::craftKmResponse(uint32_t* aw_kmdata, size_t& w_kmdatas
         if (!m_pCryptoControl)
         {
             m_RejectReason = SRT_REJ_IPE;
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID() << "IPE: craftKmResponse needs to send KM, but CryptoControl does not exist."
                      << " Socket state: connected=" << boolalpha << m_bConnected << ", connecting=" << m_bConnecting
                      << ", broken=" << m_bBroken << ", opened " << m_bOpened << ", closing=" << m_bClosing << ".");
@@ -4117,7 +4177,7 @@ EConnectStatus srt::CUDT::craftKmResponse(uint32_t* aw_kmdata, size_t& w_kmdatas
             case SRT_KM_S_NOSECRET:
             case SRT_KM_S_BADSECRET:
                 {
-                    HLOGC(cnlog.Debug,
+                    HSLOGC(cnlog.Debug, m_SocketID,
                           log << CONID() << "craftKmResponse: No KMX recorded, status = "
                               << KmStateStr(m_pCryptoControl->m_RcvKmState) << ". Respond it.");
 
@@ -4137,7 +4197,7 @@ EConnectStatus srt::CUDT::craftKmResponse(uint32_t* aw_kmdata, size_t& w_kmdatas
                     m_RejectReason = SRT_REJ_IPE;
                     // Remaining situations:
                     // - password only on this site: shouldn't be considered to be sent to a no-password site
-                    LOGC(cnlog.Error,
+                    SLOGC(cnlog.Error, m_SocketID,
                          log << CONID() << "craftKmResponse: IPE: PERIODIC HS: NO KMREQ RECORDED KMSTATE: RCV="
                              << KmStateStr(m_pCryptoControl->m_RcvKmState)
                              << " SND=" << KmStateStr(m_pCryptoControl->m_SndKmState));
@@ -4152,12 +4212,12 @@ EConnectStatus srt::CUDT::craftKmResponse(uint32_t* aw_kmdata, size_t& w_kmdatas
             if (msgsize > w_kmdatasize * 4)
             {
                 // Sanity check
-                LOGC(cnlog.Error, log << CONID() << "IPE: KMX data not aligned to 4 bytes! size=" << msgsize);
+                SLOGC(cnlog.Error, m_SocketID, log << CONID() << "IPE: KMX data not aligned to 4 bytes! size=" << msgsize);
                 memset((aw_kmdata + (w_kmdatasize * 4)), 0, msgsize - (w_kmdatasize * 4));
                 ++w_kmdatasize;
             }
 
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "craftKmResponse: getting KM DATA from the fore-recorded KMX from KMREQ, size="
                       << w_kmdatasize);
             memcpy((aw_kmdata), m_pCryptoControl->getKmMsg_data(0), msgsize);
@@ -4165,7 +4225,7 @@ EConnectStatus srt::CUDT::craftKmResponse(uint32_t* aw_kmdata, size_t& w_kmdatas
     }
     else
     {
-        HLOGC(cnlog.Debug, log << CONID() << "craftKmResponse: no KMX flag - not extracting KM data for KMRSP");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "craftKmResponse: no KMX flag - not extracting KM data for KMRSP");
         w_kmdatasize = 0;
     }
 
@@ -4178,7 +4238,7 @@ EConnectStatus srt::CUDT::processRendezvous(
 {
     if (m_RdvState == CHandShake::RDV_CONNECTED)
     {
-        HLOGC(cnlog.Debug, log << CONID() << "processRendezvous: already in CONNECTED state.");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processRendezvous: already in CONNECTED state.");
         return CONN_ACCEPT;
     }
 
@@ -4193,7 +4253,7 @@ EConnectStatus srt::CUDT::processRendezvous(
     if (m_SrtHsSide == HSD_DRAW)
     {
         m_RejectReason = SRT_REJ_RDVCOOKIE;
-        LOGC(cnlog.Error,
+        SLOGC(cnlog.Error, m_SocketID,
              log << CONID() << "COOKIE CONTEST UNRESOLVED: can't assign connection roles, please wait another minute.");
         return CONN_REJECT;
     }
@@ -4211,7 +4271,7 @@ EConnectStatus srt::CUDT::processRendezvous(
     if (rsp_type > URQ_FAILURE_TYPES)
     {
         m_RejectReason = RejectReasonForURQ(rsp_type);
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID()
                   << "processRendezvous: rejecting due to switch-state response: " << RequestTypeStr(rsp_type));
         return CONN_REJECT;
@@ -4229,7 +4289,7 @@ EConnectStatus srt::CUDT::processRendezvous(
     // This must be done before prepareConnectionObjects(), because it sets ISN and m_iMaxSRTPayloadSize needed to create buffers.
     if (!applyResponseSettings(pResponse))
     {
-        LOGC(cnlog.Error, log << CONID() << "processRendezvous: peer settings rejected");
+        SLOGC(cnlog.Error, m_SocketID, log << CONID() << "processRendezvous: peer settings rejected");
         return CONN_REJECT;
     }
 
@@ -4238,7 +4298,7 @@ EConnectStatus srt::CUDT::processRendezvous(
     if (!prepareConnectionObjects(m_ConnRes, m_SrtHsSide, NULL) || !prepareBuffers(NULL))
     {
         // m_RejectReason already handled
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "processRendezvous: rejecting due to problems in prepareConnectionObjects.");
         return CONN_REJECT;
     }
@@ -4256,14 +4316,14 @@ EConnectStatus srt::CUDT::processRendezvous(
             if (!pResponse || pResponse->getLength() == size_t(-1))
             {
                 m_RejectReason = SRT_REJ_IPE;
-                LOGC(cnlog.Fatal,
+                SLOGC(cnlog.Fatal, m_SocketID,
                      log << CONID() << "IPE: rst=RST_OK, but the packet has set -1 length - REJECTING (REQ-TIME: LOW)");
                 return CONN_REJECT;
             }
 
             if (!interpretSrtHandshake(m_ConnRes, *pResponse, kmdata, &kmdatasize))
             {
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID() << "processRendezvous: rejecting due to problems in interpretSrtHandshake REQ-TIME: LOW.");
                 return CONN_REJECT;
             }
@@ -4271,7 +4331,7 @@ EConnectStatus srt::CUDT::processRendezvous(
             updateAfterSrtHandshake(HS_VERSION_SRT1);
 
             // Pass on, inform about the shortened response-waiting period.
-            HLOGC(cnlog.Debug, log << CONID() << "processRendezvous: setting REQ-TIME: LOW. Forced to respond immediately.");
+            HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processRendezvous: setting REQ-TIME: LOW. Forced to respond immediately.");
         }
         else
         {
@@ -4286,7 +4346,7 @@ EConnectStatus srt::CUDT::processRendezvous(
         // when HSREQ was interpreted (to store HSRSP extension).
         m_ConnReq.m_extension = true;
 
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID()
                   << "processRendezvous: HSREQ extension ok, creating HSRSP response. kmdatasize=" << kmdatasize);
 
@@ -4295,7 +4355,7 @@ EConnectStatus srt::CUDT::processRendezvous(
                     kmdata, kmdatasize,
                     (w_reqpkt), (m_ConnReq)))
         {
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID()
                       << "processRendezvous: rejecting due to problems in createSrtHandshake. REQ-TIME: LOW");
             m_tsLastReqTime = steady_clock::time_point();
@@ -4319,14 +4379,14 @@ EConnectStatus srt::CUDT::processRendezvous(
         if (rst != RST_OK || !pResponse || pResponse->getLength() == size_t(-1))
         {
             // Actually the -1 length would be an IPE, but it's likely that this was reported already.
-            HLOGC(
-                cnlog.Debug,
+            HSLOGC(
+                cnlog.Debug, m_SocketID,
                 log << CONID()
                     << "processRendezvous: no INCOMING packet, NOT interpreting extensions (relying on exising data)");
         }
         else
         {
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "processRendezvous: INITIATOR, will send AGREEMENT - interpreting HSRSP extension");
             if (!interpretSrtHandshake(m_ConnRes, *pResponse, 0, 0))
             {
@@ -4338,25 +4398,25 @@ EConnectStatus srt::CUDT::processRendezvous(
         // This should be false, make a kinda assert here.
         if (needs_extension)
         {
-            LOGC(cnlog.Fatal,
+            SLOGC(cnlog.Fatal, m_SocketID,
                  log << CONID() << "IPE: INITIATOR responding AGREEMENT should declare no extensions to HS");
             m_ConnReq.m_extension = false;
         }
         updateAfterSrtHandshake(HS_VERSION_SRT1);
     }
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "processRendezvous: COOKIES Agent/Peer: " << m_ConnReq.m_iCookie << "/"
               << m_ConnRes.m_iCookie << " HSD:" << (m_SrtHsSide == HSD_INITIATOR ? "initiator" : "responder")
               << " STATE:" << CHandShake::RdvStateStr(m_RdvState) << " ...");
 
     if (rsp_type == URQ_DONE)
     {
-        HLOGC(cnlog.Debug, log << CONID() << "... WON'T SEND any response, both sides considered connected");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "... WON'T SEND any response, both sides considered connected");
     }
     else
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "... WILL SEND " << RequestTypeStr(rsp_type) << " "
                   << (m_ConnReq.m_extension ? "with" : "without") << " SRT HS extensions");
     }
@@ -4374,7 +4434,7 @@ EConnectStatus srt::CUDT::processRendezvous(
         if (cst == CONN_REJECT)
         {
             // m_RejectReason already set
-            HLOGC(cnlog.Debug, log << CONID() << "processRendezvous: rejecting due to problems in postConnect.");
+            HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processRendezvous: rejecting due to problems in postConnect.");
             return CONN_REJECT;
         }
     }
@@ -4385,7 +4445,7 @@ EConnectStatus srt::CUDT::processRendezvous(
     // this time with URQ_AGREEMENT message, but still consider yourself connected.
     if (rsp_type == URQ_DONE)
     {
-        HLOGC(cnlog.Debug, log << CONID() << "processRendezvous: rsp=DONE, reporting ACCEPT (nothing to respond)");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processRendezvous: rsp=DONE, reporting ACCEPT (nothing to respond)");
         return CONN_ACCEPT;
     }
 
@@ -4399,7 +4459,7 @@ EConnectStatus srt::CUDT::processRendezvous(
                 (w_reqpkt), (m_ConnReq)))
     {
         // m_RejectReason already set
-        LOGC(cnlog.Warn, log << CONID() << "createSrtHandshake failed (IPE?), connection rejected. REQ-TIME: LOW");
+        SLOGC(cnlog.Warn, m_SocketID, log << CONID() << "createSrtHandshake failed (IPE?), connection rejected. REQ-TIME: LOW");
         m_tsLastReqTime = steady_clock::time_point();
         return CONN_REJECT;
     }
@@ -4423,7 +4483,7 @@ EConnectStatus srt::CUDT::processRendezvous(
         const steady_clock::time_point now = steady_clock::now();
         m_tsLastReqTime                    = now;
         setPacketTS(w_reqpkt, now);
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID()
                   << "processRendezvous: rsp=AGREEMENT, reporting ACCEPT and sending just this one, REQ-TIME HIGH.");
 
@@ -4442,7 +4502,7 @@ EConnectStatus srt::CUDT::processRendezvous(
     }
     else
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "processRendezvous: REQ-TIME: remains previous value, consider yourself connected");
     }
     return CONN_CONTINUE;
@@ -4464,7 +4524,7 @@ EConnectStatus srt::CUDT::processConnectResponse(const CPacket& response, CUDTEx
 
     // This is required in HSv5 rendezvous, in which it should send the URQ_AGREEMENT message to
     // the peer, however switch to connected state.
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "processConnectResponse: TYPE:"
               << (response.isControl() ? MessageTypeStr(response.getType(), response.getExtendedType())
                                        : string("DATA")));
@@ -4502,7 +4562,7 @@ EConnectStatus srt::CUDT::processConnectResponse(const CPacket& response, CUDTEx
         // a data packet or a keep-alive packet comes, which means the peer side is already connected
         // in this situation, the previously recorded response will be used
         // In HSv5 this situation is theoretically possible if this party has missed the URQ_AGREEMENT message.
-        HLOGC(cnlog.Debug, log << CONID() << "processConnectResponse: already connected - pinning in");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectResponse: already connected - pinning in");
         if (hsv5)
         {
             m_RdvState = CHandShake::RDV_CONNECTED;
@@ -4516,11 +4576,11 @@ EConnectStatus srt::CUDT::processConnectResponse(const CPacket& response, CUDTEx
         m_RejectReason = SRT_REJ_ROGUE;
         if (!response.isControl())
         {
-            LOGC(cnlog.Warn, log << CONID() << "processConnectResponse: received DATA while HANDSHAKE expected");
+            SLOGC(cnlog.Warn, m_SocketID, log << CONID() << "processConnectResponse: received DATA while HANDSHAKE expected");
         }
         else
         {
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID()
                      << "processConnectResponse: CONFUSED: expected UMSG_HANDSHAKE as connection not yet established, "
                         "got: "
@@ -4528,7 +4588,7 @@ EConnectStatus srt::CUDT::processConnectResponse(const CPacket& response, CUDTEx
 
             if (response.getType() == UMSG_SHUTDOWN)
             {
-                LOGC(cnlog.Error,
+                SLOGC(cnlog.Error, m_SocketID,
                         log << CONID() << "processConnectResponse: UMSG_SHUTDOWN received, rejecting connection.");
                 return CONN_REJECT;
             }
@@ -4556,17 +4616,17 @@ EConnectStatus srt::CUDT::processConnectResponse(const CPacket& response, CUDTEx
     {
         m_RejectReason = SRT_REJ_ROGUE;
         // Handshake data were too small to reach the Handshake structure. Reject.
-        LOGC(cnlog.Error,
+        SLOGC(cnlog.Error, m_SocketID,
              log << CONID()
                  << "processConnectResponse: HANDSHAKE data buffer too small - possible blueboxing. Rejecting.");
         return CONN_REJECT;
     }
 
-    HLOGC(cnlog.Debug, log << CONID() << "processConnectResponse: HS RECEIVED: " << m_ConnRes.show());
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectResponse: HS RECEIVED: " << m_ConnRes.show());
     if (m_ConnRes.m_iReqType >= URQ_FAILURE_TYPES)
     {
         m_RejectReason = RejectReasonForURQ(m_ConnRes.m_iReqType);
-        LOGC(cnlog.Warn,
+        SLOGC(cnlog.Warn, m_SocketID,
                 log << CONID() << "processConnectResponse: rejecting per reception of a rejection HS response: "
                     << RequestTypeStr(m_ConnRes.m_iReqType));
         return CONN_REJECT;
@@ -4577,7 +4637,7 @@ EConnectStatus srt::CUDT::processConnectResponse(const CPacket& response, CUDTEx
         // Yes, we do abort to prevent buffer overrun. Set your MSS correctly
         // and you'll avoid problems.
         m_RejectReason = SRT_REJ_ROGUE;
-        LOGC(cnlog.Fatal, log << CONID() << "MSS size " << m_config.iMSS << "exceeds MTU size!");
+        SLOGC(cnlog.Fatal, m_SocketID, log << CONID() << "MSS size " << m_config.iMSS << "exceeds MTU size!");
         return CONN_REJECT;
     }
 
@@ -4592,7 +4652,7 @@ EConnectStatus srt::CUDT::processConnectResponse(const CPacket& response, CUDTEx
         if (m_ConnRes.m_iReqType == URQ_INDUCTION)
         {
             m_RejectReason = SRT_REJ_ROGUE;
-            LOGC(cnlog.Error,
+            SLOGC(cnlog.Error, m_SocketID,
                  log << CONID()
                      << "processConnectResponse: Rendezvous-point received INDUCTION handshake (expected WAVEAHAND). "
                         "Rejecting.");
@@ -4604,18 +4664,18 @@ EConnectStatus srt::CUDT::processConnectResponse(const CPacket& response, CUDTEx
 
         if (m_ConnRes.m_iVersion > HS_VERSION_UDT4)
         {
-            HLOGC(cnlog.Debug, log << CONID() << "processConnectResponse: Rendezvous HSv5 DETECTED.");
+            HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectResponse: Rendezvous HSv5 DETECTED.");
             return CONN_RENDEZVOUS; // --> will continue in CUDT::processRendezvous().
         }
 
-        HLOGC(cnlog.Debug, log << CONID() << "processConnectResponse: Rendsezvous HSv4 DETECTED.");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectResponse: Rendsezvous HSv4 DETECTED.");
         // So, here it has either received URQ_WAVEAHAND handshake message (while it should be in URQ_WAVEAHAND itself)
         // or it has received URQ_CONCLUSION/URQ_AGREEMENT message while this box has already sent URQ_WAVEAHAND to the
         // peer, and DID NOT send the URQ_CONCLUSION yet.
 
         if (m_ConnReq.m_iReqType == URQ_WAVEAHAND || m_ConnRes.m_iReqType == URQ_WAVEAHAND)
         {
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "processConnectResponse: REQ-TIME LOW. got HS RDV. Agent state:"
                       << RequestTypeStr(m_ConnReq.m_iReqType) << " Peer HS:" << m_ConnRes.show());
 
@@ -4640,7 +4700,7 @@ EConnectStatus srt::CUDT::processConnectResponse(const CPacket& response, CUDTEx
         }
         else
         {
-            HLOGC(cnlog.Debug, log << CONID() << "processConnectResponse: Rendezvous HSv4 PAST waveahand");
+            HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectResponse: Rendezvous HSv4 PAST waveahand");
         }
     }
     else
@@ -4648,7 +4708,7 @@ EConnectStatus srt::CUDT::processConnectResponse(const CPacket& response, CUDTEx
         // set cookie
         if (m_ConnRes.m_iReqType == URQ_INDUCTION)
         {
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "processConnectResponse: REQ-TIME LOW; got INDUCTION HS response (cookie:" << hex
                       << m_ConnRes.m_iCookie << " version:" << dec << m_ConnRes.m_iVersion
                       << "), sending CONCLUSION HS with this cookie");
@@ -4664,7 +4724,7 @@ EConnectStatus srt::CUDT::processConnectResponse(const CPacket& response, CUDTEx
 
                 if (hs_flags != SrtHSRequest::SRT_MAGIC_CODE)
                 {
-                    LOGC(cnlog.Warn,
+                    SLOGC(cnlog.Warn, m_SocketID,
                          log << CONID() << "processConnectResponse: Listener HSv5 did not set the SRT_MAGIC_CODE.");
                     m_RejectReason = SRT_REJ_ROGUE;
                     return CONN_REJECT;
@@ -4714,7 +4774,7 @@ bool srt::CUDT::applyResponseSettings(const CPacket* pHspkt /*[[nullable]]*/) AT
 {
     if (!m_ConnRes.valid())
     {
-        LOGC(cnlog.Error, log << CONID() << "applyResponseSettings: ROGUE HANDSHAKE - rejecting");
+        SLOGC(cnlog.Error, m_SocketID, log << CONID() << "applyResponseSettings: ROGUE HANDSHAKE - rejecting");
         m_RejectReason = SRT_REJ_ROGUE;
         return false;
     }
@@ -4724,7 +4784,7 @@ bool srt::CUDT::applyResponseSettings(const CPacket* pHspkt /*[[nullable]]*/) AT
 
     const size_t full_hdr_size = CPacket::UDP_HDR_SIZE + CPacket::HDR_SIZE;
     m_iMaxSRTPayloadSize = m_config.iMSS - full_hdr_size;
-    HLOGC(cnlog.Debug, log << CONID() << "applyResponseSettings: PAYLOAD SIZE: " << m_iMaxSRTPayloadSize);
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "applyResponseSettings: PAYLOAD SIZE: " << m_iMaxSRTPayloadSize);
 
     m_iFlowWindowSize    = m_ConnRes.m_iFlightFlagSize;
     const int udpsize    = m_config.iMSS - CPacket::UDP_HDR_SIZE;
@@ -4739,7 +4799,7 @@ bool srt::CUDT::applyResponseSettings(const CPacket* pHspkt /*[[nullable]]*/) AT
     if (pHspkt)
         m_SourceAddr = pHspkt->udpDestAddr();
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "applyResponseSettings: HANSHAKE CONCLUDED. SETTING: payload-size=" << m_iMaxSRTPayloadSize
               << " mss=" << m_ConnRes.m_iMSS << " flw=" << m_ConnRes.m_iFlightFlagSize << " peer-ISN=" << m_ConnRes.m_iISN
               << " local-ISN=" << m_iISN
@@ -4757,7 +4817,7 @@ EConnectStatus srt::CUDT::postConnect(const CPacket* pResponse, bool rendezvous,
     // in rendezvous it's completed before calling this function.
     if (!rendezvous)
     {
-        HLOGC(cnlog.Debug, log << CONID() << boolalpha << "postConnect: packet:" << bool(pResponse) << " rendezvous:" << rendezvous);
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << boolalpha << "postConnect: packet:" << bool(pResponse) << " rendezvous:" << rendezvous);
         // The "local storage depleted" case shouldn't happen here, but
         // this is a theoretical path that needs prevention.
         bool ok = pResponse;
@@ -4902,7 +4962,7 @@ EConnectStatus srt::CUDT::postConnect(const CPacket* pResponse, bool rendezvous,
     // Ok, no more things to be done as per "clear connecting state"
     if (!s)
     {
-        LOGC(cnlog.Error, log << CONID() << "Connection broken in the process - socket closed");
+        SLOGC(cnlog.Error, m_SocketID, log << CONID() << "Connection broken in the process - socket closed");
         m_RejectReason = SRT_REJ_CLOSE;
         if (eout)
         {
@@ -4969,7 +5029,7 @@ EConnectStatus srt::CUDT::postConnect(const CPacket* pResponse, bool rendezvous,
 
     */
     
-    LOGC(cnlog.Note, log << CONID() << "Connection established from ("
+    SLOGC(cnlog.Note, m_SocketID, log << CONID() << "Connection established from ("
         << m_SourceAddr.str() << ") to peer @" << m_PeerID << " (" << m_PeerAddr.str() << ")");
 
     return CONN_ACCEPT;
@@ -4988,7 +5048,7 @@ void srt::CUDT::checkUpdateCryptoKeyLen(const char *loghdr SRT_ATR_UNUSED, int32
         if (m_config.iSndCryptoKeyLen == 0)
         {
             m_config.iSndCryptoKeyLen = rcv_pbkeylen;
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << loghdr
                       << ": PBKEYLEN adopted from advertised value: " << m_config.iSndCryptoKeyLen);
         }
@@ -4998,14 +5058,14 @@ void srt::CUDT::checkUpdateCryptoKeyLen(const char *loghdr SRT_ATR_UNUSED, int32
             // the enforcement, otherwise simply let it win.
             if (!m_config.bDataSender)
             {
-                LOGC(cnlog.Warn,
+                SLOGC(cnlog.Warn, m_SocketID,
                      log << CONID() << loghdr << ": PBKEYLEN conflict - OVERRIDDEN " << m_config.iSndCryptoKeyLen
                          << " by " << rcv_pbkeylen << " from PEER (as AGENT is not SRTO_SENDER)");
                 m_config.iSndCryptoKeyLen = rcv_pbkeylen;
             }
             else
             {
-                LOGC(cnlog.Warn,
+                SLOGC(cnlog.Warn, m_SocketID,
                      log << CONID() << loghdr << ": PBKEYLEN conflict - keep " << m_config.iSndCryptoKeyLen
                          << "; peer-advertised PBKEYLEN " << rcv_pbkeylen << " rejected because Agent is SRTO_SENDER");
             }
@@ -5013,11 +5073,11 @@ void srt::CUDT::checkUpdateCryptoKeyLen(const char *loghdr SRT_ATR_UNUSED, int32
     }
     else if (enc_flags != 0)
     {
-        LOGC(cnlog.Error, log << CONID() << loghdr << ": IPE: enc_flags outside allowed 2, 3, 4: " << enc_flags);
+        SLOGC(cnlog.Error, m_SocketID, log << CONID() << loghdr << ": IPE: enc_flags outside allowed 2, 3, 4: " << enc_flags);
     }
     else
     {
-        HLOGC(cnlog.Debug, log << CONID() << loghdr << ": No encryption flags found in type field: " << typefield);
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << loghdr << ": No encryption flags found in type field: " << typefield);
     }
 }
 
@@ -5068,7 +5128,7 @@ void srt::CUDT::rendezvousSwitchState(UDTRequestType& w_rsptype, bool& w_needs_e
 
 #if ENABLE_HEAVY_LOGGING
 
-    HLOGC(cnlog.Debug, log << CONID() << "rendezvousSwitchState: HS: " << m_ConnRes.show());
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "rendezvousSwitchState: HS: " << m_ConnRes.show());
 
     struct LogAtTheEnd
     {
@@ -5153,7 +5213,7 @@ void srt::CUDT::rendezvousSwitchState(UDTRequestType& w_rsptype, bool& w_needs_e
                 // If no HSRSP attached, stay in this state.
                 if (hs_flags == 0)
                 {
-                    HLOGC(cnlog.Debug,
+                    HSLOGC(cnlog.Debug, m_SocketID,
                           log << CONID()
                               << "rendezvousSwitchState: {INITIATOR}[ATTENTION] awaits CONCLUSION+HSRSP, got "
                                  "CONCLUSION, remain in [ATTENTION]");
@@ -5173,7 +5233,7 @@ void srt::CUDT::rendezvousSwitchState(UDTRequestType& w_rsptype, bool& w_needs_e
                 // (Although this seems completely impossible).
                 if (hs_flags == 0)
                 {
-                    LOGC(cnlog.Warn,
+                    SLOGC(cnlog.Warn, m_SocketID,
                          log << CONID()
                              << "rendezvousSwitchState: (IPE!){RESPONDER}[ATTENTION] awaits CONCLUSION+HSREQ, got "
                                 "CONCLUSION, remain in [ATTENTION]");
@@ -5189,7 +5249,7 @@ void srt::CUDT::rendezvousSwitchState(UDTRequestType& w_rsptype, bool& w_needs_e
                 return;
             }
 
-            LOGC(cnlog.Error, log << CONID() << "RENDEZVOUS COOKIE DRAW! Cannot resolve to a valid state.");
+            SLOGC(cnlog.Error, m_SocketID, log << CONID() << "RENDEZVOUS COOKIE DRAW! Cannot resolve to a valid state.");
             // Fallback for cookie draw
             m_RdvState = CHandShake::RDV_INVALID;
             w_rsptype   = URQFailure(SRT_REJ_RDVCOOKIE);
@@ -5253,7 +5313,7 @@ void srt::CUDT::rendezvousSwitchState(UDTRequestType& w_rsptype, bool& w_needs_e
             {
                 // Received REPEATED empty conclusion that has initially switched it into FINE state.
                 // To exit FINE state we need the CONCLUSION message with HSRSP.
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID()
                           << "rendezvousSwitchState: {INITIATOR}[FINE] <CONCLUSION without HSRSP. Stay in [FINE], "
                              "await CONCLUSION+HSRSP");
@@ -5265,7 +5325,7 @@ void srt::CUDT::rendezvousSwitchState(UDTRequestType& w_rsptype, bool& w_needs_e
                 // it to FINE state. That CONCLUSION message should have contained extension,
                 // so if this is a repeated CONCLUSION+HSREQ, it should be responded with
                 // CONCLUSION+HSRSP.
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID()
                           << "rendezvousSwitchState: {RESPONDER}[FINE] <CONCLUSION. Stay in [FINE], await AGREEMENT");
             }
@@ -5315,11 +5375,11 @@ void srt::CUDT::rendezvousSwitchState(UDTRequestType& w_rsptype, bool& w_needs_e
             // No matter in which state we'd be, just switch to connected.
             if (m_RdvState == CHandShake::RDV_CONNECTED)
             {
-                HLOGC(cnlog.Debug, log << CONID() << "<-- AGREEMENT: already connected");
+                HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "<-- AGREEMENT: already connected");
             }
             else
             {
-                HLOGC(cnlog.Debug, log << CONID() << "<-- AGREEMENT: switched to connected");
+                HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "<-- AGREEMENT: switched to connected");
             }
             m_RdvState = CHandShake::RDV_CONNECTED;
             w_rsptype   = URQ_DONE;
@@ -5334,7 +5394,7 @@ void srt::CUDT::rendezvousSwitchState(UDTRequestType& w_rsptype, bool& w_needs_e
             w_rsptype = URQ_CONCLUSION;
             if (hsd == HSD_RESPONDER)
             {
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID()
                           << "rendezvousSwitchState: {RESPONDER}[INITIATED] awaits AGREEMENT, "
                              "got CONCLUSION, sending CONCLUSION+HSRSP");
@@ -5349,7 +5409,7 @@ void srt::CUDT::rendezvousSwitchState(UDTRequestType& w_rsptype, bool& w_needs_e
             // HSREQ, and set responding HSRSP in that case.
             if (hs_flags == 0)
             {
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID()
                           << "rendezvousSwitchState: {INITIATOR}[INITIATED] awaits AGREEMENT, "
                              "got empty CONCLUSION, STILL RESPONDING CONCLUSION+HSRSP");
@@ -5357,7 +5417,7 @@ void srt::CUDT::rendezvousSwitchState(UDTRequestType& w_rsptype, bool& w_needs_e
             else
             {
 
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID()
                           << "rendezvousSwitchState: {INITIATOR}[INITIATED] awaits AGREEMENT, "
                              "got CONCLUSION+HSREQ, responding CONCLUSION+HSRSP");
@@ -5377,7 +5437,7 @@ void srt::CUDT::rendezvousSwitchState(UDTRequestType& w_rsptype, bool& w_needs_e
         return;
     }
 
-    HLOGC(cnlog.Debug, log << CONID() << "rendezvousSwitchState: INVALID STATE TRANSITION, result: INVALID");
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "rendezvousSwitchState: INVALID STATE TRANSITION, result: INVALID");
     // All others are treated as errors
     m_RdvState = CHandShake::RDV_WAVING;
     w_rsptype   = URQFailure(SRT_REJ_ROGUE);
@@ -5408,127 +5468,13 @@ void * srt::CUDT::tsbpd(void* param)
     self->m_bTsbPdAckWakeup = true;
     while (!self->m_bClosing)
     {
-        steady_clock::time_point tsNextDelivery; // Next packet delivery time
-        bool                     rxready = false;
-#if ENABLE_BONDING
-        bool shall_update_group = false;
-#endif
-
         INCREMENT_THREAD_ITERATIONS();
 
-        enterCS(self->m_RcvBufferLock);
-        const steady_clock::time_point tnow = steady_clock::now();
-
-        self->m_pRcvBuffer->updRcvAvgDataSize(tnow);
-        const srt::CRcvBuffer::PacketInfo info = self->m_pRcvBuffer->getFirstValidPacketInfo();
-
-        const bool is_time_to_deliver = !is_zero(info.tsbpd_time) && (tnow >= info.tsbpd_time);
-        tsNextDelivery = info.tsbpd_time;
-
-        if (!self->m_bTLPktDrop)
-        {
-            rxready = !info.seq_gap && is_time_to_deliver;
-        }
-        else if (is_time_to_deliver)
-        {
-            rxready = true;
-            if (info.seq_gap)
-            {
-                const int iDropCnt SRT_ATR_UNUSED = self->rcvDropTooLateUpTo(info.seqno);
-#if ENABLE_BONDING
-                shall_update_group = true;
-#endif
-
-#if ENABLE_LOGGING
-                const int64_t timediff_us = count_microseconds(tnow - info.tsbpd_time);
-#if ENABLE_HEAVY_LOGGING
-                HLOGC(tslog.Debug,
-                    log << self->CONID() << "tsbpd: DROPSEQ: up to seqno %" << CSeqNo::decseq(info.seqno) << " ("
-                    << iDropCnt << " packets) playable at " << FormatTime(info.tsbpd_time) << " delayed "
-                    << (timediff_us / 1000) << "." << std::setw(3) << std::setfill('0') << (timediff_us % 1000) << " ms");
-#endif
-                string why;
-                if (self->frequentLogAllowed(FREQLOGFA_RCV_DROPPED, tnow, (why)))
-                {
-                    LOGC(brlog.Warn, log << self->CONID() << "RCV-DROPPED " << iDropCnt << " packet(s). Packet seqno %" << info.seqno
-                            << " delayed for " << (timediff_us / 1000) << "." << std::setw(3) << std::setfill('0')
-                            << (timediff_us % 1000) << " ms " << why);
-                }
-#if SRT_ENABLE_FREQUENT_LOG_TRACE
-                else
-                {
-                    LOGC(brlog.Warn, log << "SUPPRESSED: RCV-DROPPED LOG: " << why);
-                }
-#endif
-#endif
-
-                tsNextDelivery = steady_clock::time_point(); // Ready to read, nothing to wait for.
-            }
-        }
-        leaveCS(self->m_RcvBufferLock);
-
-        if (rxready)
-        {
-            HLOGC(tslog.Debug,
-                log << self->CONID() << "tsbpd: PLAYING PACKET seq=" << info.seqno << " (belated "
-                << (count_milliseconds(steady_clock::now() - info.tsbpd_time)) << "ms)");
-            /*
-             * There are packets ready to be delivered
-             * signal a waiting "recv" call if there is any data available
-             */
-            if (self->m_config.bSynRecving)
-            {
-                recvdata_lcc.notify_one();
-            }
-            /*
-             * Set EPOLL_IN to wakeup any thread waiting on epoll
-             */
-            self->uglobal().m_EPoll.update_events(self->m_SocketID, self->m_sPollID, SRT_EPOLL_IN, true);
 #if ENABLE_BONDING
-            // If this is NULL, it means:
-            // - the socket never was a group member
-            // - the socket was a group member, but:
-            //    - was just removed as a part of closure
-            //    - and will never be member of the group anymore
-
-            // If this is not NULL, it means:
-            // - This socket is currently member of the group
-            // - This socket WAS a member of the group, though possibly removed from it already, BUT:
-            //   - the group that this socket IS OR WAS member of is in the GroupKeeper
-            //   - the GroupKeeper prevents the group from being deleted
-            //   - it is then completely safe to access the group here,
-            //     EVEN IF THE SOCKET THAT WAS ITS MEMBER IS BEING DELETED.
-
-            // It is ensured that the group object exists here because GroupKeeper
-            // keeps it busy, even if you just closed the socket, remove it as a member
-            // or even the group is empty and was explicitly closed.
-            if (gkeeper.group)
-            {
-                // Functions called below will lock m_GroupLock, which in hierarchy
-                // lies after m_RecvLock. Must unlock m_RecvLock to be able to lock
-                // m_GroupLock inside the calls.
-                InvertedLock unrecv(self->m_RecvLock);
-                // The current "APP reader" needs to simply decide as to whether
-                // the next CUDTGroup::recv() call should return with no blocking or not.
-                // When the group is read-ready, it should update its pollers as it sees fit.
-
-                // NOTE: this call will set lock to m_IncludedGroup->m_GroupLock
-                HLOGC(tslog.Debug, log << self->CONID() << "tsbpd: GROUP: checking if %" << info.seqno << " makes group readable");
-                gkeeper.group->updateReadState(self->m_SocketID, info.seqno);
-
-                if (shall_update_group)
-                {
-                    // A group may need to update the parallelly used idle links,
-                    // should it have any. Pass the current socket position in order
-                    // to skip it from the group loop.
-                    // NOTE: SELF LOCKING.
-                    gkeeper.group->updateLatestRcv(self->m_parent);
-                }
-            }
+        const steady_clock::time_point tsNextDelivery = self->tsbpdCheck(gkeeper.group);
+#else
+        const steady_clock::time_point tsNextDelivery = self->tsbpdCheck(NULL);
 #endif
-            CGlobEvent::triggerEvent();
-            tsNextDelivery = steady_clock::time_point(); // Ready to read, nothing to wait for.
-        }
 
         // We may just briefly unlocked the m_RecvLock, so we need to check m_bClosing again to avoid deadlock.
         if (self->m_bClosing)
@@ -5536,15 +5482,11 @@ void * srt::CUDT::tsbpd(void* param)
 
         if (!is_zero(tsNextDelivery))
         {
-            IF_HEAVY_LOGGING(const steady_clock::duration timediff = tsNextDelivery - tnow);
             /*
              * Buffer at head of queue is not ready to play.
              * Schedule wakeup when it will be.
              */
             self->m_bTsbPdAckWakeup = false;
-            HLOGC(tslog.Debug,
-                log << self->CONID() << "tsbpd: FUTURE PACKET seq=" << info.seqno
-                << " T=" << FormatTime(tsNextDelivery) << " - waiting " << count_milliseconds(timediff) << "ms");
             THREAD_PAUSED();
             tsbpd_cc.wait_until(tsNextDelivery);
             THREAD_RESUMED();
@@ -5562,20 +5504,181 @@ void * srt::CUDT::tsbpd(void* param)
              * - New buffers ACKed
              * - Closing the connection
              */
-            HLOGC(tslog.Debug, log << self->CONID() << "tsbpd: no data, scheduling wakeup at ack");
+            HSLOGC(tslog.Debug, self->m_SocketID, log << self->CONID() << "tsbpd: no data, scheduling wakeup at ack");
             self->m_bTsbPdAckWakeup = true;
             THREAD_PAUSED();
             tsbpd_cc.wait();
             THREAD_RESUMED();
         }
 
-        HLOGC(tslog.Debug, log << self->CONID() << "tsbpd: WAKE UP!!!");
+        HSLOGC(tslog.Debug, self->m_SocketID, log << self->CONID() << "tsbpd: WAKE UP!!!");
     }
     THREAD_EXIT();
-    HLOGC(tslog.Debug, log << self->CONID() << "tsbpd: EXITING");
+    HSLOGC(tslog.Debug, self->m_SocketID, log << self->CONID() << "tsbpd: EXITING");
     return NULL;
 }
 
+steady_clock::time_point srt::CUDT::tsbpdCheck(CUDTGroup* group SRT_ATR_UNUSED)
+{
+    steady_clock::time_point tsNextDelivery; // Next packet delivery time
+    bool                     rxready = false;
+#if ENABLE_BONDING
+    bool shall_update_group = false;
+#endif
+
+    enterCS(m_RcvBufferLock);
+    const steady_clock::time_point tnow = steady_clock::now();
+
+    m_pRcvBuffer->updRcvAvgDataSize(tnow);
+    const srt::CRcvBuffer::PacketInfo info = m_pRcvBuffer->getFirstValidPacketInfo();
+
+    const bool is_time_to_deliver = !is_zero(info.tsbpd_time) && (tnow >= info.tsbpd_time);
+    tsNextDelivery = info.tsbpd_time;
+
+    if (!m_bTLPktDrop)
+    {
+        rxready = !info.seq_gap && is_time_to_deliver;
+    }
+    else if (is_time_to_deliver)
+    {
+        rxready = true;
+        if (info.seq_gap)
+        {
+            const int iDropCnt SRT_ATR_UNUSED = rcvDropTooLateUpTo(info.seqno);
+#if ENABLE_BONDING
+            shall_update_group = true;
+#endif
+
+#if ENABLE_LOGGING
+            const int64_t timediff_us = count_microseconds(tnow - info.tsbpd_time);
+#if ENABLE_HEAVY_LOGGING
+            HSLOGC(tslog.Debug, m_SocketID,
+                log << CONID() << "tsbpd: DROPSEQ: up to seqno %" << CSeqNo::decseq(info.seqno) << " ("
+                << iDropCnt << " packets) playable at " << FormatTime(info.tsbpd_time) << " delayed "
+                << (timediff_us / 1000) << "." << std::setw(3) << std::setfill('0') << (timediff_us % 1000) << " ms");
+#endif
+            string why;
+            if (frequentLogAllowed(FREQLOGFA_RCV_DROPPED, tnow, (why)))
+            {
+                SLOGC(brlog.Warn, m_SocketID, log << CONID() << "RCV-DROPPED " << iDropCnt << " packet(s). Packet seqno %" << info.seqno
+                        << " delayed for " << (timediff_us / 1000) << "." << std::setw(3) << std::setfill('0')
+                        << (timediff_us % 1000) << " ms " << why);
+            }
+#if SRT_ENABLE_FREQUENT_LOG_TRACE
+            else
+            {
+                LOGC(brlog.Warn, log << "SUPPRESSED: RCV-DROPPED LOG: " << why);
+            }
+#endif
+#endif
+
+            tsNextDelivery = steady_clock::time_point(); // Ready to read, nothing to wait for.
+        }
+    }
+    leaveCS(m_RcvBufferLock);
+
+    if (rxready)
+    {
+        HSLOGC(tslog.Debug, m_SocketID,
+            log << CONID() << "tsbpd: PLAYING PACKET seq=" << info.seqno << " (belated "
+            << (count_milliseconds(steady_clock::now() - info.tsbpd_time)) << "ms)");
+        /*
+         * There are packets ready to be delivered
+         * signal a waiting "recv" call if there is any data available
+         */
+        if (m_config.bSynRecving)
+        {
+            m_RecvDataCond.notify_one();
+        }
+        /*
+         * Set EPOLL_IN to wakeup any thread waiting on epoll
+         */
+        uglobal().m_EPoll.update_events(m_SocketID, m_sPollID, SRT_EPOLL_IN, true);
+#if ENABLE_BONDING
+        // If this is NULL, it means:
+        // - the socket never was a group member
+        // - the socket was a group member, but:
+        //    - was just removed as a part of closure
+        //    - and will never be member of the group anymore
+
+        // If this is not NULL, it means:
+        // - This socket is currently member of the group
+        // - This socket WAS a member of the group, though possibly removed from it already, BUT:
+        //   - the group that this socket IS OR WAS member of is in the GroupKeeper
+        //   - the GroupKeeper prevents the group from being deleted
+        //   - it is then completely safe to access the group here,
+        //     EVEN IF THE SOCKET THAT WAS ITS MEMBER IS BEING DELETED.
+
+        // It is ensured that the group object exists here because GroupKeeper
+        // keeps it busy, even if you just closed the socket, remove it as a member
+        // or even the group is empty and was explicitly closed.
+        if (group)
+        {
+            // Functions called below will lock m_GroupLock, which in hierarchy
+            // lies after m_RecvLock. Must unlock m_RecvLock to be able to lock
+            // m_GroupLock inside the calls.
+            InvertedLock unrecv(m_RecvLock);
+            // The current "APP reader" needs to simply decide as to whether
+            // the next CUDTGroup::recv() call should return with no blocking or not.
+            // When the group is read-ready, it should update its pollers as it sees fit.
+
+            // NOTE: this call will set lock to m_IncludedGroup->m_GroupLock
+            HSLOGC(tslog.Debug, m_SocketID, log << CONID() << "tsbpd: GROUP: checking if %" << info.seqno << " makes group readable");
+            group->updateReadState(m_SocketID, info.seqno);
+
+            if (shall_update_group)
+            {
+                // A group may need to update the parallelly used idle links,
+                // should it have any. Pass the current socket position in order
+                // to skip it from the group loop.
+                // NOTE: SELF LOCKING.
+                group->updateLatestRcv(m_parent);
+            }
+        }
+#endif
+        CGlobEvent::triggerEvent();
+        tsNextDelivery = steady_clock::time_point(); // Ready to read, nothing to wait for.
+    }
+
+#if ENABLE_HEAVY_LOGGING
+    if (!is_zero(tsNextDelivery))
+    {
+        HSLOGC(tslog.Debug, m_SocketID,
+            log << CONID() << "tsbpd: FUTURE PACKET seq=" << info.seqno
+            << " T=" << FormatTime(tsNextDelivery) << " - waiting " << count_milliseconds(tsNextDelivery - tnow) << "ms");
+    }
+#endif
+    return tsNextDelivery;
+}
+
+steady_clock::time_point srt::CUDT::tsbpdCheckShared()
+{
+    // The group is acquired in checkLazySpawnTsbPdThread(), as this must not
+    // lock m_GlobControlLock: releaseSynch() holds it while waiting for this call.
+    ScopedLock recvlock(m_RecvLock);
+    if (m_bClosing)
+        return steady_clock::time_point();
+
+#if ENABLE_BONDING
+    const steady_clock::time_point tsNextDelivery = tsbpdCheck(m_pTsbPdGroup);
+#else
+    const steady_clock::time_point tsNextDelivery = tsbpdCheck(NULL);
+#endif
+
+    // See tsbpd(): when not waiting for a particular time,
+    // the scheduler has to be woken up on ACK.
+    m_bTsbPdAckWakeup = is_zero(tsNextDelivery);
+    return tsNextDelivery;
+}
+
+void srt::CUDT::notifyTsbPd()
+{
+    if (m_TsbPdTask.worker >= 0)
+        uglobal().m_TsbPdScheduler.wake(m_TsbPdTask);
+    else
+        m_RcvTsbPdCond.notify_one();
+}
+
 int srt::CUDT::rcvDropTooLateUpTo(int seqno)
 {
     // Make sure that it would not drop over m_iRcvCurrSeqNo, which may break senders.
@@ -5587,11 +5690,11 @@ int srt::CUDT::rcvDropTooLateUpTo(int seqno)
     const int iDropCnt = m_pRcvBuffer->dropUpTo(seqno);
     if (iDropCnt > 0)
     {
-        enterCS(m_StatsLock);
+        enterStatsCS();
         // Estimate dropped bytes from average payload size.
         const uint64_t avgpayloadsz = m_pRcvBuffer->getRcvAvgPayloadSize();
         m_stats.rcvr.dropped.count(stats::BytesPackets(iDropCnt * avgpayloadsz, (uint32_t) iDropCnt));
-        leaveCS(m_StatsLock);
+        leaveStatsCS();
     }
     return iDropCnt;
 }
@@ -5610,10 +5713,10 @@ void srt::CUDT::setInitialRcvSeq(int32_t isn)
     {
         if (!m_pRcvBuffer->empty())
         {
-            LOGC(cnlog.Error, log << CONID() << "IPE: setInitialRcvSeq expected empty RCV buffer. Dropping all.");
+            SLOGC(cnlog.Error, m_SocketID, log << CONID() << "IPE: setInitialRcvSeq expected empty RCV buffer. Dropping all.");
             const int        iDropCnt     = m_pRcvBuffer->dropAll();
             const uint64_t   avgpayloadsz = m_pRcvBuffer->getRcvAvgPayloadSize();
-            sync::ScopedLock sl(m_StatsLock);
+            StatsWriteLock sl(*this);
             m_stats.rcvr.dropped.count(stats::BytesPackets(iDropCnt * avgpayloadsz, (uint32_t) iDropCnt));
         }
 
@@ -5629,7 +5732,7 @@ bool srt::CUDT::prepareConnectionObjects(const CHandShake &hs, HandshakeSide hsd
     // be run once in the whole connection process.
     if (m_pCryptoControl)
     {
-        HLOGC(rslog.Debug, log << CONID() << "prepareConnectionObjects: (lazy) already created.");
+        HSLOGC(rslog.Debug, m_SocketID, log << CONID() << "prepareConnectionObjects: (lazy) already created.");
         return true;
     }
 
@@ -5675,7 +5778,7 @@ bool srt::CUDT::prepareBuffers(CUDTException* eout)
 {
     if (m_pSndBuffer)
     {
-        HLOGC(rslog.Debug, log << CONID() << "prepareBuffers: (lazy) already created.");
+        HSLOGC(rslog.Debug, m_SocketID, log << CONID() << "prepareBuffers: (lazy) already created.");
         return true;
     }
     
@@ -5686,7 +5789,7 @@ bool srt::CUDT::prepareBuffers(CUDTException* eout)
 
         SRT_ASSERT(m_iMaxSRTPayloadSize != 0);
 
-        HLOGC(rslog.Debug, log << CONID() << "Creating buffers: snd-plsize=" << m_iMaxSRTPayloadSize
+        HSLOGC(rslog.Debug, m_SocketID, log << CONID() << "Creating buffers: snd-plsize=" << m_iMaxSRTPayloadSize
                 << " snd-bufsize=" << 32
                 << " authtag=" << authtag);
 
@@ -5729,7 +5832,7 @@ void srt::CUDT::rewriteHandshakeData(const sockaddr_any& peer, CHandShake& w_hs)
 
 void srt::CUDT::acceptAndRespond(const sockaddr_any& agent, const sockaddr_any& peer, const CPacket& hspkt, CHandShake& w_hs)
 {
-    HLOGC(cnlog.Debug, log << CONID() << "acceptAndRespond: setting up data according to handshake");
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "acceptAndRespond: setting up data according to handshake");
 #if ENABLE_BONDING
     // Keep the group alive for the lifetime of this function,
     // and do it BEFORE acquiring m_ConnectionLock to avoid
@@ -5749,7 +5852,7 @@ void srt::CUDT::acceptAndRespond(const sockaddr_any& agent, const sockaddr_any&
     const size_t full_hdr_size = CPacket::UDP_HDR_SIZE + CPacket::HDR_SIZE;
     m_iMaxSRTPayloadSize = m_config.iMSS - full_hdr_size;
 
-    HLOGC(cnlog.Debug, log << CONID() << "acceptAndRespond: PAYLOAD SIZE: " << m_iMaxSRTPayloadSize);
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "acceptAndRespond: PAYLOAD SIZE: " << m_iMaxSRTPayloadSize);
 
     // exchange info for maximum flow window size
     m_iFlowWindowSize = w_hs.m_iFlightFlagSize;
@@ -5776,7 +5879,7 @@ void srt::CUDT::acceptAndRespond(const sockaddr_any& agent, const sockaddr_any&
     // Prepare all structures
     if (!prepareConnectionObjects(w_hs, HSD_DRAW, 0))
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "acceptAndRespond: prepareConnectionObjects failed - responding with REJECT.");
         // If the SRT Handshake extension was provided and wasn't interpreted
         // correctly, the connection should be rejected.
@@ -5813,7 +5916,7 @@ void srt::CUDT::acceptAndRespond(const sockaddr_any& agent, const sockaddr_any&
     size_t   kmdatasize = SRTDATA_MAXSIZE;
     if (!interpretSrtHandshake(w_hs, hspkt, (kmdata), (&kmdatasize)))
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "acceptAndRespond: interpretSrtHandshake failed - responding with REJECT.");
         // If the SRT Handshake extension was provided and wasn't interpreted
         // correctly, the connection should be rejected.
@@ -5827,7 +5930,7 @@ void srt::CUDT::acceptAndRespond(const sockaddr_any& agent, const sockaddr_any&
 
     if (!prepareBuffers(NULL))
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
             log << CONID() << "acceptAndRespond: prepareConnectionObjects failed - responding with REJECT.");
         // If the SRT buffers failed to be allocated,
         // the connection must be rejected.
@@ -5896,12 +5999,12 @@ void srt::CUDT::acceptAndRespond(const sockaddr_any& agent, const sockaddr_any&
     rsppkt.allocate(size);
 
     // This will serialize the handshake according to its current form.
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID()
               << "acceptAndRespond: creating CONCLUSION response (HSv5: with HSRSP/KMRSP) buffer size=" << size);
     if (!createSrtHandshake(SRT_CMD_HSRSP, SRT_CMD_KMRSP, kmdata, kmdatasize, (rsppkt), (w_hs)))
     {
-        LOGC(cnlog.Error, log << CONID() << "acceptAndRespond: error creating handshake response");
+        SLOGC(cnlog.Error, m_SocketID, log << CONID() << "acceptAndRespond: error creating handshake response");
         throw CUDTException(MJ_SETUP, MN_REJECTED, 0);
     }
 
@@ -5914,7 +6017,7 @@ void srt::CUDT::acceptAndRespond(const sockaddr_any& agent, const sockaddr_any&
         // data that have been just written into the buffer.
         CHandShake debughs;
         debughs.load_from(rsppkt.m_pcData, rsppkt.getLength());
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "acceptAndRespond: sending HS from agent @"
                 << debughs.m_iID << " to peer @" << rsppkt.id()
                 << "HS:" << debughs.show()
@@ -5997,11 +6100,20 @@ bool srt::CUDT::createCrypter(HandshakeSide side, bool bidirectional)
 
     if (bidirectional || m_config.bDataSender)
     {
-        HLOGC(rslog.Debug, log << CONID() << "createCrypter: setting RCV/SND KeyLen=" << m_config.iSndCryptoKeyLen);
+        HSLOGC(rslog.Debug, m_SocketID, log << CONID() << "createCrypter: setting RCV/SND KeyLen=" << m_config.iSndCryptoKeyLen);
         m_pCryptoControl->setCryptoKeylen(m_config.iSndCryptoKeyLen);
     }
 
-    return m_pCryptoControl->init(side, m_config, bidirectional);
+    if (!m_pCryptoControl->init(side, m_config, bidirectional))
+        return false;
+
+    if (m_config.iCryptoWorkers > 0 && m_pCryptoControl->hasPassphrase())
+    {
+        const size_t max_payload = m_config.iMSS - CPacket::SRT_DATA_HDR_SIZE;
+        m_pCryptoControl->enableAhead(&uglobal().m_CryptoWorkers, m_config.iCryptoWorkers, max_payload);
+    }
+
+    return true;
 }
 
 SRT_REJECT_REASON srt::CUDT::setupCC()
@@ -6035,7 +6147,7 @@ SRT_REJECT_REASON srt::CUDT::setupCC()
 
         // At this point we state everything is checked and the appropriate
         // corrector type is already selected, so now create it.
-        HLOGC(pflog.Debug, log << CONID() << "filter: Configuring: " << m_config.sPacketFilterConfig.c_str());
+        HSLOGC(pflog.Debug, m_SocketID, log << CONID() << "filter: Configuring: " << m_config.sPacketFilterConfig.c_str());
         bool status = true;
         try
         {
@@ -6074,14 +6186,14 @@ SRT_REJECT_REASON srt::CUDT::setupCC()
     m_tsLastRspAckTime = currtime;
     m_tsLastSndTime.store(currtime);
 
-    HLOGC(rslog.Debug,
+    HSLOGC(rslog.Debug, m_SocketID,
           log << CONID() << "setupCC: setting parameters: mss=" << m_config.iMSS << " maxCWNDSize/FlowWindowSize="
               << m_iFlowWindowSize << " rcvrate=" << m_iDeliveryRate << "p/s (" << m_iByteDeliveryRate << "B/S)"
               << " rtt=" << m_iSRTT << " bw=" << m_iBandwidth);
 
     if (!updateCC(TEV_INIT, EventVariant(TEV_INIT_RESET)))
     {
-        LOGC(rslog.Error, log << CONID() << "setupCC: IPE: resrouces not yet initialized!");
+        SLOGC(rslog.Error, m_SocketID, log << CONID() << "setupCC: IPE: resrouces not yet initialized!");
         return SRT_REJ_IPE;
     }
     return SRT_REJ_UNKNOWN;
@@ -6097,7 +6209,7 @@ void srt::CUDT::considerLegacySrtHandshake(const steady_clock::time_point &timeb
 
     if (m_iSndHsRetryCnt <= 0)
     {
-        HLOGC(cnlog.Debug, log << CONID() << "Legacy HSREQ: not needed, expire counter=" << m_iSndHsRetryCnt);
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "Legacy HSREQ: not needed, expire counter=" << m_iSndHsRetryCnt);
         return;
     }
 
@@ -6117,7 +6229,7 @@ void srt::CUDT::considerLegacySrtHandshake(const steady_clock::time_point &timeb
          */
         if (timebase > now) // too early
         {
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "Legacy HSREQ: TOO EARLY, will still retry " << m_iSndHsRetryCnt << " times");
             return;
         }
@@ -6126,13 +6238,13 @@ void srt::CUDT::considerLegacySrtHandshake(const steady_clock::time_point &timeb
     // payload packet sent. Send only if this is still set to maximum+1 value.
     else if (m_iSndHsRetryCnt < SRT_MAX_HSRETRY + 1)
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "Legacy HSREQ: INITIAL, REPEATED, so not to be done. Will repeat on sending "
                   << m_iSndHsRetryCnt << " times");
         return;
     }
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "Legacy HSREQ: SENDING, will repeat " << m_iSndHsRetryCnt << " times if no response");
     m_iSndHsRetryCnt--;
     m_tsSndHsLastTime = now;
@@ -6143,14 +6255,14 @@ void srt::CUDT::checkSndTimers()
 {
     if (m_SrtHsSide == HSD_INITIATOR)
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "checkSndTimers: HS SIDE: INITIATOR, considering legacy handshake with timebase");
         // Legacy method for HSREQ, only if initiator.
         considerLegacySrtHandshake(m_tsSndHsLastTime + microseconds_from(m_iSRTT * 3 / 2));
     }
     else
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID()
                   << "checkSndTimers: HS SIDE: " << (m_SrtHsSide == HSD_RESPONDER ? "RESPONDER" : "DRAW (IPE?)")
                   << " - not considering legacy handshake");
@@ -6200,13 +6312,13 @@ bool srt::CUDT::closeInternal() ATR_NOEXCEPT
     // that has m_bBroken == false or m_bConnected == true.
     // If it is intended to forcefully close the socket, make sure
     // that it's in response to a broken connection.
-    HLOGC(smlog.Debug, log << CONID() << "closing socket");
+    HSLOGC(smlog.Debug, m_SocketID, log << CONID() << "closing socket");
 
     if (m_config.Linger.l_onoff != 0)
     {
         const steady_clock::time_point entertime = steady_clock::now();
 
-        HLOGC(smlog.Debug, log << CONID() << "... (linger)");
+        HSLOGC(smlog.Debug, m_SocketID, log << CONID() << "... (linger)");
         while (!m_bBroken && m_bConnected && (m_pSndBuffer->getCurrBufSize() > 0) &&
                (steady_clock::now() - entertime < seconds_from(m_config.Linger.l_linger)))
         {
@@ -6220,7 +6332,7 @@ bool srt::CUDT::closeInternal() ATR_NOEXCEPT
                 if (is_zero(m_tsLingerExpiration))
                     m_tsLingerExpiration = entertime + seconds_from(m_config.Linger.l_linger);
 
-                HLOGC(smlog.Debug,
+                HSLOGC(smlog.Debug, m_SocketID,
                       log << CONID() << "CUDT::close: linger-nonblocking, setting expire time T="
                           << FormatTime(m_tsLingerExpiration));
 
@@ -6257,13 +6369,13 @@ bool srt::CUDT::closeInternal() ATR_NOEXCEPT
     leaveCS(uglobal().m_EPoll.m_EPollLock);
 
     // trigger any pending IO events.
-    HLOGC(smlog.Debug, log << CONID() << "close: SETTING ERR readiness on E" << Printable(epollid));
+    HSLOGC(smlog.Debug, m_SocketID, log << CONID() << "close: SETTING ERR readiness on E" << Printable(epollid));
     uglobal().m_EPoll.update_events(m_SocketID, m_sPollID, SRT_EPOLL_ERR, true);
     // then remove itself from all epoll monitoring
     int no_events = 0;
     for (set<int>::iterator i = epollid.begin(); i != epollid.end(); ++i)
     {
-        HLOGC(smlog.Debug, log << CONID() << "close: CLEARING subscription on E" << (*i));
+        HSLOGC(smlog.Debug, m_SocketID, log << CONID() << "close: CLEARING subscription on E" << (*i));
         try
         {
             uglobal().m_EPoll.update_usock(*i, m_SocketID, &no_events);
@@ -6274,7 +6386,7 @@ bool srt::CUDT::closeInternal() ATR_NOEXCEPT
             // the epoll system to this socket. If it's unsubscribed already,
             // that's even better.
         }
-        HLOGC(smlog.Debug, log << CONID() << "close: removing E" << (*i) << " from back-subscribers");
+        HSLOGC(smlog.Debug, m_SocketID, log << CONID() << "close: removing E" << (*i) << " from back-subscribers");
     }
 
     // Not deleting elements from m_sPollID inside the loop because it invalidates
@@ -6296,19 +6408,28 @@ bool srt::CUDT::closeInternal() ATR_NOEXCEPT
     // Inform the threads handler to stop.
     m_bClosing = true;
 
-    HLOGC(smlog.Debug, log << CONID() << "CLOSING STATE. Acquiring connection lock");
+    // Have the socket removed from the receiver queue without waiting
+    // for its timers to be due.
+    if (m_pRcvQueue && m_bConnected)
+        m_pRcvQueue->wakeTimers(m_SocketID);
+
+    HSLOGC(smlog.Debug, m_SocketID, log << CONID() << "CLOSING STATE. Acquiring connection lock");
 
     ScopedLock connectguard(m_ConnectionLock);
 
     // Signal the sender and recver if they are waiting for data.
     releaseSynch();
 
-    HLOGC(smlog.Debug, log << CONID() << "CLOSING, removing from listener/connector");
+    HSLOGC(smlog.Debug, m_SocketID, log << CONID() << "CLOSING, removing from listener/connector");
 
     if (m_bListening)
     {
         m_bListening = false;
         m_pRcvQueue->removeListener(this);
+#ifdef SRT_ENABLE_ENCRYPTION
+        if (m_config.CryptoSecret.len > 0)
+            uglobal().m_KekCache.release((const char*)m_config.CryptoSecret.str, m_config.CryptoSecret.len);
+#endif
     }
     else if (m_bConnecting)
     {
@@ -6319,7 +6440,7 @@ bool srt::CUDT::closeInternal() ATR_NOEXCEPT
     {
         if (!m_bShutdown)
         {
-            HLOGC(smlog.Debug, log << CONID() << "CLOSING - sending SHUTDOWN to the peer @" << m_PeerID);
+            HSLOGC(smlog.Debug, m_SocketID, log << CONID() << "CLOSING - sending SHUTDOWN to the peer @" << m_PeerID);
             sendCtrl(UMSG_SHUTDOWN);
         }
 
@@ -6339,7 +6460,7 @@ bool srt::CUDT::closeInternal() ATR_NOEXCEPT
         m_bConnected = false;
     }
 
-    HLOGC(smlog.Debug, log << CONID() << "CLOSING, joining send/receive threads");
+    HSLOGC(smlog.Debug, m_SocketID, log << CONID() << "CLOSING, joining send/receive threads");
 
     // waiting all send and recv calls to stop
     ScopedLock sendguard(m_SendLock);
@@ -6396,17 +6517,16 @@ int srt::CUDT::receiveBuffer(char *data, int len)
             // make this function return 0, potentially also without breaking
             // the connection and potentially also with losing no ability to
             // send some larger portion of data next time.
-            HLOGC(arlog.Debug, log << CONID() << "STREAM API, SHUTDOWN: marking as EOF");
+            HSLOGC(arlog.Debug, m_SocketID, log << CONID() << "STREAM API, SHUTDOWN: marking as EOF");
             return 0;
         }
-        HLOGC(arlog.Debug,
+        HSLOGC(arlog.Debug, m_SocketID,
               log << CONID() << (m_config.bMessageAPI ? "MESSAGE" : "STREAM") << " API, " << (m_bShutdown ? "" : "no")
                   << " SHUTDOWN. Reporting as BROKEN.");
         throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
     }
 
     CSync rcond  (m_RecvDataCond, recvguard);
-    CSync tscond (m_RcvTsbPdCond, recvguard);
     if (!isRcvBufferReady())
     {
         if (!m_config.bSynRecving)
@@ -6448,10 +6568,10 @@ int srt::CUDT::receiveBuffer(char *data, int len)
         // See at the beginning
         if (!m_config.bMessageAPI && m_bShutdown)
         {
-            HLOGC(arlog.Debug, log << CONID() << "STREAM API, SHUTDOWN: marking as EOF");
+            HSLOGC(arlog.Debug, m_SocketID, log << CONID() << "STREAM API, SHUTDOWN: marking as EOF");
             return 0;
         }
-        HLOGC(arlog.Debug,
+        HSLOGC(arlog.Debug, m_SocketID,
               log << CONID() << (m_config.bMessageAPI ? "MESSAGE" : "STREAM") << " API, " << (m_bShutdown ? "" : "no")
                   << " SHUTDOWN. Reporting as BROKEN.");
 
@@ -6466,7 +6586,7 @@ int srt::CUDT::receiveBuffer(char *data, int len)
     if (m_bTsbPd)
     {
         HLOGP(tslog.Debug, "Ping TSBPD thread to schedule wakeup");
-        tscond.notify_one_locked(recvguard);
+        notifyTsbPd();
     }
     else
     {
@@ -6494,7 +6614,7 @@ int srt::CUDT::sndDropTooLate()
 
     if (!m_config.bMessageAPI)
     {
-        LOGC(aslog.Error, log << CONID() << "The SRTO_TLPKTDROP flag can only be used with message API.");
+        SLOGC(aslog.Error, m_SocketID, log << CONID() << "The SRTO_TLPKTDROP flag can only be used with message API.");
         throw CUDTException(MJ_NOTSUP, MN_INVALBUFFERAPI, 0);
     }
 
@@ -6526,9 +6646,9 @@ int srt::CUDT::sndDropTooLate()
     m_iFlowWindowSize = m_iFlowWindowSize + dpkts;
 
     // If some packets were dropped update stats, socket state, loss list and the parent group if any.
-    enterCS(m_StatsLock);
+    enterStatsCS();
     m_stats.sndr.dropped.count(stats::BytesPackets((uint64_t) dbytes, (uint32_t) dpkts));
-    leaveCS(m_StatsLock);
+    leaveStatsCS();
 
     IF_HEAVY_LOGGING(const int32_t realack = m_iSndLastDataAck);
     const int32_t fakeack = CSeqNo::incseq(m_iSndLastDataAck, dpkts);
@@ -6545,7 +6665,7 @@ int srt::CUDT::sndDropTooLate()
         m_iSndCurrSeqNo = minlastack;
     }
 
-    HLOGC(qslog.Debug,
+    HSLOGC(qslog.Debug, m_SocketID,
           log << CONID() << "SND-DROP: %(" << realack << "-" << m_iSndCurrSeqNo << ") n=" << dpkts << "pkt " << dbytes
               << "B, span=" << buffdelay_ms << " ms, FIRST #" << first_msgno);
 
@@ -6587,7 +6707,7 @@ int srt::CUDT::sendmsg(const char *data, int len, int msttl, bool inorder, int64
 // [[using maybe_locked(CUDTGroup::m_GroupLock, m_parent->m_GroupOf != NULL)]]
 // GroupLock is applied when this function is called from inside CUDTGroup::send,
 // which is the only case when the m_parent->m_GroupOf is not NULL.
-int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
+int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl, CSndPayload* payload)
 {
     // throw an exception if not connected
     if (m_bBroken || m_bClosing)
@@ -6597,7 +6717,7 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
 
     if (len <= 0)
     {
-        LOGC(aslog.Error, log << CONID() << "INVALID: Data size for sending declared with length: " << len);
+        SLOGC(aslog.Error, m_SocketID, log << CONID() << "INVALID: Data size for sending declared with length: " << len);
         return 0;
     }
 
@@ -6605,7 +6725,7 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
     {
         if (w_mctrl.msgno < 1 || w_mctrl.msgno > MSGNO_SEQ_MAX)
         {
-            LOGC(aslog.Error,
+            SLOGC(aslog.Error, m_SocketID,
                  log << CONID() << "INVALID forced msgno " << w_mctrl.msgno << ": can be -1 (trap) or <1..."
                      << MSGNO_SEQ_MAX << ">");
             throw CUDTException(MJ_NOTSUP, MN_INVAL);
@@ -6651,7 +6771,7 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
 
     if (m_config.bMessageAPI && len > int(m_config.iSndBufSize * m_iMaxSRTPayloadSize))
     {
-        LOGC(aslog.Error,
+        SLOGC(aslog.Error, m_SocketID,
              log << CONID() << "Message length (" << len << ") exceeds the size of sending buffer: "
                  << (m_config.iSndBufSize * m_iMaxSRTPayloadSize) << ". Use SRTO_SNDBUF if needed.");
         throw CUDTException(MJ_NOTSUP, MN_XSIZE, 0);
@@ -6688,7 +6808,7 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
 
     if (m_bTsbPd && iNumPktsRequired > 1)
     {
-        LOGC(aslog.Error,
+        SLOGC(aslog.Error, m_SocketID,
             log << CONID() << "Message length (" << len << ") can't fit into a single data packet ("
                 << m_pSndBuffer->getMaxPacketLen() << " bytes max).");
         throw CUDTException(MJ_NOTSUP, MN_XSIZE, 0);
@@ -6760,7 +6880,7 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
             //    - m_bPeerHealth condition is checked and responded with PEERERROR
             //
             // ERGO: never happens?
-            LOGC(aslog.Fatal,
+            SLOGC(aslog.Fatal, m_SocketID,
                  log << CONID()
                      << "IPE: sendmsg: the loop exited, while not enough size, still connected, peer healthy. "
                         "Impossible.");
@@ -6810,7 +6930,7 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
         {
             if (CSeqNo::seqcmp(w_mctrl.pktseq, seqno) < 0)
             {
-                HLOGC(aslog.Debug, log << CONID() << "sock:SENDING (NOT): group-req %" << w_mctrl.pktseq
+                HSLOGC(aslog.Debug, m_SocketID, log << CONID() << "sock:SENDING (NOT): group-req %" << w_mctrl.pktseq
                         << " OLDER THAN next expected %" << seqno << " - FAKE-SENDING.");
                 return size;
             }
@@ -6825,22 +6945,22 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
 
         // Now seqno is the sequence to which it was scheduled
         // XXX Conversion from w_mctrl.srctime -> steady_clock::time_point need not be accurrate.
-        HLOGC(aslog.Debug, log << CONID() << "buf:SENDING (BEFORE) srctime:"
+        HSLOGC(aslog.Debug, m_SocketID, log << CONID() << "buf:SENDING (BEFORE) srctime:"
                 << (w_mctrl.srctime ? FormatTime(ts_srctime) : "none")
                 << " DATA SIZE: " << size << " sched-SEQUENCE: " << seqno
                 << " STAMP: " << BufferStamp(data, size));
 
         if (w_mctrl.srctime && w_mctrl.srctime < count_microseconds(m_stats.tsStartTime.time_since_epoch()))
         {
-            LOGC(aslog.Error,
+            SLOGC(aslog.Error, m_SocketID,
                 log << CONID() << "Wrong source time was provided. Sending is rejected.");
             throw CUDTException(MJ_NOTSUP, MN_INVALMSGAPI);
         }
 
         if (w_mctrl.srctime && (!m_config.bMessageAPI || !m_bTsbPd))
         {
-            HLOGC(
-                aslog.Warn,
+            HSLOGC(
+                aslog.Warn, m_SocketID,
                 log << CONID()
                     << "Source time can only be used with TSBPD and Message API enabled. Using default time instead.");
             w_mctrl.srctime = 0;
@@ -6851,11 +6971,19 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
         // - OUTPUT: value of the sequence number to be put on the first packet at the next sendmsg2 call.
         // We need to supply to the output the value that was STAMPED ON THE PACKET,
         // which is seqno. In the output we'll get the next sequence number.
-        m_pSndBuffer->addBuffer(data, size, (w_mctrl));
+        // Timers of a socket with nothing to send may not be checked
+        // periodically (see nextTimersCheckTime()).
+        const bool was_idle = m_pSndBuffer->getCurrBufSize() == 0;
+        if (payload)
+            m_pSndBuffer->addBuffer(*payload, size, (w_mctrl));
+        else
+            m_pSndBuffer->addBuffer(data, size, (w_mctrl));
         m_iSndNextSeqNo = w_mctrl.pktseq;
+        if (was_idle)
+            m_pRcvQueue->wakeTimers(m_SocketID);
         w_mctrl.pktseq = seqno;
 
-        HLOGC(aslog.Debug, log << CONID() << "buf:SENDING srctime:" << FormatTime(ts_srctime)
+        HSLOGC(aslog.Debug, m_SocketID, log << CONID() << "buf:SENDING srctime:" << FormatTime(ts_srctime)
               << " size=" << size << " #" << w_mctrl.msgno << " SCHED %" << orig_seqno
               << "(>> %" << seqno << ") !" << BufferStamp(data, size));
 
@@ -6866,6 +6994,11 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
         }
     }
 
+    // Hand over a single-packet message to the crypto workers, so that
+    // it's possibly already encrypted when it's time to send it.
+    if (m_config.iCryptoWorkers > 0 && size <= m_iMaxSRTPayloadSize)
+        m_pCryptoControl->submitAhead(w_mctrl.pktseq, payload ? payload->data() : data, size);
+
     // Insert this socket to the snd list if it is not on the list already.
     // m_pSndUList->pop may lock CSndUList::m_ListLock and then m_RecvAckLock
     m_pSndQueue->m_pSndUList->update(this, CSndUList::DONT_RESCHEDULE);
@@ -6874,12 +7007,12 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
     // IF there was a packet drop on the sender side, report congestion to the app.
     if (iPktsTLDropped > 0)
     {
-        LOGC(aslog.Error, log << CONID() << "sendmsg2: CONGESTION; reporting error");
+        SLOGC(aslog.Error, m_SocketID, log << CONID() << "sendmsg2: CONGESTION; reporting error");
         throw CUDTException(MJ_AGAIN, MN_CONGESTION, 0);
     }
 #endif /* SRT_ENABLE_ECN */
 
-    HLOGC(aslog.Debug, log << CONID() << "sock:SENDING (END): success, size=" << size);
+    HSLOGC(aslog.Debug, m_SocketID, log << CONID() << "sock:SENDING (END): success, size=" << size);
     return size;
 }
 
@@ -6918,7 +7051,7 @@ int srt::CUDT::recvmsg2(char* data, int len, SRT_MSGCTRL& w_mctrl)
 
     if (len <= 0)
     {
-        LOGC(arlog.Error, log << CONID() << "Length of '" << len << "' supplied to srt_recvmsg.");
+        SLOGC(arlog.Error, m_SocketID, log << CONID() << "Length of '" << len << "' supplied to srt_recvmsg.");
         throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
     }
 
@@ -6945,11 +7078,53 @@ bool srt::CUDT::isRcvBufferReadyNoLock() const
     return m_pRcvBuffer->isRcvDataReady(steady_clock::now());
 }
 
+int srt::CUDT::lendMessage(SRT_MSGCTRL& w_mctrl, CUnit*& w_unit)
+{
+#if ENABLE_BONDING
+    if (m_parent->m_GroupOf && m_parent->m_GroupOf->isGroupReceiver())
+    {
+        LOGP(arlog.Error, "recv*: This socket is a receiver group member. Use group ID, NOT socket ID.");
+        throw CUDTException(MJ_NOTSUP, MN_INVALMSGAPI, 0);
+    }
+#endif
+
+    if (!m_bConnected || !m_CongCtl.ready())
+        throw CUDTException(MJ_CONNECTION, MN_NOCONN, 0);
+
+    // Stream mode has no message boundaries to lend a unit along.
+    if (!m_config.bMessageAPI)
+        throw CUDTException(MJ_NOTSUP, MN_INVALBUFFERAPI, 0);
+
+    w_unit = NULL;
+    const int res = receiveMessage(NULL, m_config.iMSS, (w_mctrl), CUDTUnited::ERH_THROW, &w_unit);
+    if (res < 0)
+    {
+        // The message is not in a single unit; it must be read by copying.
+        throw CUDTException(MJ_NOTSUP, MN_INVALMSGAPI, 0);
+    }
+    return res;
+}
+
+void srt::CUDT::releaseLentUnit(CUnit* unit)
+{
+    bool released = false;
+    {
+        ScopedLock lck(m_RcvBufferLock);
+        released = m_pRcvBuffer && m_pRcvBuffer->releaseLent(unit);
+    }
+
+    if (!released)
+    {
+        SLOGC(arlog.Error, m_SocketID, log << CONID() << "releaseLentUnit: the unit is not lent by this socket.");
+        throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+    }
+}
+
 // int by_exception: accepts values of CUDTUnited::ErrorHandling:
 // - 0 - by return value
 // - 1 - by exception
 // - 2 - by abort (unused)
-int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_exception)
+int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_exception, CUnit** w_lent)
 {
     // Recvmsg isn't restricted to the congctl type, it's the most
     // basic method of passing the data. You can retrieve data as
@@ -6966,7 +7141,6 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
         throw CUDTException(MJ_NOTSUP, MN_INVALMSGAPI, 0);
 
     UniqueLock recvguard (m_RecvLock);
-    CSync tscond     (m_RcvTsbPdCond,  recvguard);
 
     /* XXX DEBUG STUFF - enable when required
        char charbool[2] = {'0', '1'};
@@ -6983,10 +7157,10 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
 
     if (m_bBroken || m_bClosing)
     {
-        HLOGC(arlog.Debug, log << CONID() << "receiveMessage: CONNECTION BROKEN - reading from recv buffer just for formality");
+        HSLOGC(arlog.Debug, m_SocketID, log << CONID() << "receiveMessage: CONNECTION BROKEN - reading from recv buffer just for formality");
         enterCS(m_RcvBufferLock);
         const int res = (m_pRcvBuffer->isRcvDataReady(steady_clock::now()))
-            ? m_pRcvBuffer->readMessage(data, len, &w_mctrl)
+            ? m_pRcvBuffer->readMessage(data, len, &w_mctrl, w_lent)
             : 0;
         leaveCS(m_RcvBufferLock);
 
@@ -6994,7 +7168,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
         if (m_bTsbPd)
         {
             HLOGP(tslog.Debug, "Ping TSBPD thread to schedule wakeup");
-            tscond.notify_one_locked(recvguard);
+            notifyTsbPd();
         }
         else
         {
@@ -7005,6 +7179,10 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
         {
             // read is not available any more
             uglobal().m_EPoll.update_events(m_SocketID, m_sPollID, SRT_EPOLL_IN, false);
+
+            // The broken socket was kept for reading out the data.
+            if (m_bBroken)
+                uglobal().scheduleGC(m_SocketID);
         }
 
         if (res == 0)
@@ -7022,13 +7200,13 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
 
     if (!m_config.bSynRecving)
     {
-        HLOGC(arlog.Debug, log << CONID() << "receiveMessage: BEGIN ASYNC MODE. Going to extract payload size=" << len);
+        HSLOGC(arlog.Debug, m_SocketID, log << CONID() << "receiveMessage: BEGIN ASYNC MODE. Going to extract payload size=" << len);
         enterCS(m_RcvBufferLock);
         const int res = (m_pRcvBuffer->isRcvDataReady(steady_clock::now()))
-            ? m_pRcvBuffer->readMessage(data, len, &w_mctrl)
+            ? m_pRcvBuffer->readMessage(data, len, &w_mctrl, w_lent)
             : 0;
         leaveCS(m_RcvBufferLock);
-        HLOGC(arlog.Debug, log << CONID() << "AFTER readMsg: (NON-BLOCKING) result=" << res);
+        HSLOGC(arlog.Debug, m_SocketID, log << CONID() << "AFTER readMsg: (NON-BLOCKING) result=" << res);
 
         if (res == 0)
         {
@@ -7037,7 +7215,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
             if (m_bTsbPd)
             {
                 HLOGP(arlog.Debug, "receiveMessage: nothing to read, kicking TSBPD, return AGAIN");
-                tscond.notify_one_locked(recvguard);
+                notifyTsbPd();
             }
             else
             {
@@ -7058,7 +7236,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
             if (m_bTsbPd)
             {
                 HLOGP(arlog.Debug, "receiveMessage: DATA READ, but nothing more - kicking TSBPD.");
-                tscond.notify_one_locked(recvguard);
+                notifyTsbPd();
             }
             else
             {
@@ -7071,13 +7249,13 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
             // After signaling the tsbpd for ready data, report the bandwidth.
 #if ENABLE_HEAVY_LOGGING
             double bw = Bps2Mbps(int64_t(m_iBandwidth) * m_iMaxSRTPayloadSize );
-            HLOGC(arlog.Debug, log << CONID() << "CURRENT BANDWIDTH: " << bw << "Mbps (" << m_iBandwidth << " buffers per second)");
+            HSLOGC(arlog.Debug, m_SocketID, log << CONID() << "CURRENT BANDWIDTH: " << bw << "Mbps (" << m_iBandwidth << " buffers per second)");
 #endif
         }
         return res;
     }
 
-    HLOGC(arlog.Debug, log << CONID() << "receiveMessage: BEGIN SYNC MODE. Going to extract payload size max=" << len);
+    HSLOGC(arlog.Debug, m_SocketID, log << CONID() << "receiveMessage: BEGIN SYNC MODE. Going to extract payload size max=" << len);
 
     int  res     = 0;
     bool timeout = false;
@@ -7101,8 +7279,8 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
                 // of kicking TSBPD.
                 // bool spurious = (tstime != 0);
 
-                HLOGC(tslog.Debug, log << CONID() << "receiveMessage: KICK tsbpd");
-                tscond.notify_one_locked(recvguard);
+                HSLOGC(tslog.Debug, m_SocketID, log << CONID() << "receiveMessage: KICK tsbpd");
+                notifyTsbPd();
             }
 
             THREAD_PAUSED();
@@ -7114,7 +7292,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
                 // higher than this.
                 const steady_clock::time_point exptime = steady_clock::now() + recv_timeout;
 
-                HLOGC(tslog.Debug,
+                HSLOGC(tslog.Debug, m_SocketID,
                       log << CONID() << "receiveMessage: fall asleep up to TS=" << FormatTime(exptime)
                           << " lock=" << (&m_RecvLock) << " cond=" << (&m_RecvDataCond));
 
@@ -7132,7 +7310,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
             } while (stillConnected() && !timeout && (!isRcvBufferReady()));
             THREAD_RESUMED();
 
-            HLOGC(tslog.Debug,
+            HSLOGC(tslog.Debug, m_SocketID,
                   log << CONID() << "receiveMessage: lock-waiting loop exited: stillConntected=" << stillConnected()
                       << " timeout=" << timeout << " data-ready=" << isRcvBufferReady());
         }
@@ -7144,9 +7322,9 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
                 */
 
         enterCS(m_RcvBufferLock);
-        res = m_pRcvBuffer->readMessage((data), len, &w_mctrl);
+        res = m_pRcvBuffer->readMessage((data), len, &w_mctrl, w_lent);
         leaveCS(m_RcvBufferLock);
-        HLOGC(arlog.Debug, log << CONID() << "AFTER readMsg: (BLOCKING) result=" << res);
+        HSLOGC(arlog.Debug, m_SocketID, log << CONID() << "AFTER readMsg: (BLOCKING) result=" << res);
 
         if (m_bBroken || m_bClosing)
         {
@@ -7179,7 +7357,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
         if (m_bTsbPd)
         {
             HLOGP(tslog.Debug, "recvmsg: KICK tsbpd() (buffer empty)");
-            tscond.notify_one_locked(recvguard);
+            notifyTsbPd();
         }
 
         // Shut up EPoll if no more messages in non-blocking mode
@@ -7215,7 +7393,7 @@ int64_t srt::CUDT::sendfile(fstream &ifs, int64_t &offset, int64_t size, int blo
 
     if (!m_pCryptoControl || !m_pCryptoControl->isSndEncryptionOK())
     {
-        LOGC(aslog.Error,
+        SLOGC(aslog.Error, m_SocketID,
              log << CONID()
                  << "Encryption is required, but the peer did not supply correct credentials. Sending rejected.");
         throw CUDTException(MJ_SETUP, MN_SECURITY, 0);
@@ -7302,7 +7480,10 @@ int64_t srt::CUDT::sendfile(fstream &ifs, int64_t &offset, int64_t size, int blo
 
         {
             ScopedLock        recvAckLock(m_RecvAckLock);
+            const bool    was_idle = m_pSndBuffer->getCurrBufSize() == 0;
             const int64_t sentsize = m_pSndBuffer->addBufferFromFile(ifs, unitsize);
+            if (was_idle)
+                m_pRcvQueue->wakeTimers(m_SocketID);
 
             if (sentsize > 0)
             {
@@ -7343,7 +7524,7 @@ int64_t srt::CUDT::recvfile(fstream &ofs, int64_t &offset, int64_t size, int blo
 
     if (isOPT_TsbPd())
     {
-        LOGC(arlog.Error,
+        SLOGC(arlog.Error, m_SocketID,
              log << CONID() << "Reading from file is incompatible with TSBPD mode and would cause a deadlock");
         throw CUDTException(MJ_NOTSUP, MN_INVALBUFFERAPI, 0);
     }
@@ -7446,6 +7627,103 @@ int64_t srt::CUDT::recvfile(fstream &ofs, int64_t &offset, int64_t size, int blo
     return size - torecv;
 }
 
+// Copies the statistics counters and the current connection parameters.
+// All the values read here can be read without any lock. The counters are
+// consistent with each other when called under m_StatsLock, or when
+// m_StatsVersion is the same before and after.
+void srt::CUDT::fillPerfCounters(CBytePerfMon* perf, const steady_clock::time_point& currtime)
+{
+    const int pktHdrSize = CPacket::HDR_SIZE + CPacket::UDP_HDR_SIZE;
+
+    perf->msTimeStamp          = count_milliseconds(currtime - m_stats.tsStartTime);
+    perf->pktSent              = m_stats.sndr.sent.trace.count();
+    perf->pktSentUnique        = m_stats.sndr.sentUnique.trace.count();
+    perf->pktRecv              = m_stats.rcvr.recvd.trace.count();
+    perf->pktRecvUnique        = m_stats.rcvr.recvdUnique.trace.count();
+
+    perf->pktSndLoss           = m_stats.sndr.lost.trace.count();
+    perf->pktRcvLoss           = m_stats.rcvr.lost.trace.count();
+    perf->pktRetrans           = m_stats.sndr.sentRetrans.trace.count();
+    perf->pktRcvRetrans        = m_stats.rcvr.recvdRetrans.trace.count();
+    perf->pktSentACK           = m_stats.rcvr.sentAck.trace.count();
+    perf->pktRecvACK           = m_stats.sndr.recvdAck.trace.count();
+    perf->pktSentNAK           = m_stats.rcvr.sentNak.trace.count();
+    perf->pktRecvNAK           = m_stats.sndr.recvdNak.trace.count();
+    perf->usSndDuration        = m_stats.sndDuration.load();
+    perf->pktReorderDistance   = m_stats.traceReorderDistance.load();
+    perf->pktReorderTolerance  = m_iReorderTolerance;
+    perf->pktRcvAvgBelatedTime = m_stats.traceBelatedTimeUs.load() / 1000.0;
+    perf->pktRcvBelated        = m_stats.rcvr.recvdBelated.trace.count();
+
+    perf->pktSndFilterExtra  = m_stats.sndr.sentFilterExtra.trace.count();
+    perf->pktRcvFilterExtra  = m_stats.rcvr.recvdFilterExtra.trace.count();
+    perf->pktRcvFilterSupply = m_stats.rcvr.suppliedByFilter.trace.count();
+    perf->pktRcvFilterLoss   = m_stats.rcvr.lossFilter.trace.count();
+
+    /* perf byte counters include all headers (SRT+UDP+IP) */
+    perf->byteSent       = m_stats.sndr.sent.trace.bytesWithHdr(pktHdrSize);
+    perf->byteSentUnique = m_stats.sndr.sentUnique.trace.bytesWithHdr(pktHdrSize);
+    perf->byteRecv       = m_stats.rcvr.recvd.trace.bytesWithHdr(pktHdrSize);
+    perf->byteRecvUnique = m_stats.rcvr.recvdUnique.trace.bytesWithHdr(pktHdrSize);
+    perf->byteRetrans    = m_stats.sndr.sentRetrans.trace.bytesWithHdr(pktHdrSize);
+    perf->byteRcvLoss    = m_stats.rcvr.lost.trace.bytesWithHdr(pktHdrSize);
+
+    perf->pktSndDrop  = m_stats.sndr.dropped.trace.count();
+    perf->pktRcvDrop  = m_stats.rcvr.dropped.trace.count();
+    perf->byteSndDrop = m_stats.sndr.dropped.trace.bytesWithHdr(pktHdrSize);
+    perf->byteRcvDrop = m_stats.rcvr.dropped.trace.bytesWithHdr(pktHdrSize);
+    perf->pktRcvUndecrypt  = m_stats.rcvr.undecrypted.trace.count();
+    perf->byteRcvUndecrypt = m_stats.rcvr.undecrypted.trace.bytes();
+
+    perf->pktSentTotal       = m_stats.sndr.sent.total.count();
+    perf->pktSentUniqueTotal = m_stats.sndr.sentUnique.total.count();
+    perf->pktRecvTotal       = m_stats.rcvr.recvd.total.count();
+    perf->pktRecvUniqueTotal = m_stats.rcvr.recvdUnique.total.count();
+    perf->pktSndLossTotal    = m_stats.sndr.lost.total.count();
+    perf->pktRcvLossTotal    = m_stats.rcvr.lost.total.count();
+    perf->pktRetransTotal    = m_stats.sndr.sentRetrans.total.count();
+    perf->pktSentACKTotal    = m_stats.rcvr.sentAck.total.count();
+    perf->pktRecvACKTotal    = m_stats.sndr.recvdAck.total.count();
+    perf->pktSentNAKTotal    = m_stats.rcvr.sentNak.total.count();
+    perf->pktRecvNAKTotal    = m_stats.sndr.recvdNak.total.count();
+    perf->usSndDurationTotal = m_stats.m_sndDurationTotal.load();
+
+    perf->byteSentTotal           = m_stats.sndr.sent.total.bytesWithHdr(pktHdrSize);
+    perf->byteSentUniqueTotal     = m_stats.sndr.sentUnique.total.bytesWithHdr(pktHdrSize);
+    perf->byteRecvTotal           = m_stats.rcvr.recvd.total.bytesWithHdr(pktHdrSize);
+    perf->byteRecvUniqueTotal     = m_stats.rcvr.recvdUnique.total.bytesWithHdr(pktHdrSize);
+    perf->byteRetransTotal        = m_stats.sndr.sentRetrans.total.bytesWithHdr(pktHdrSize);
+    perf->pktSndFilterExtraTotal  = m_stats.sndr.sentFilterExtra.total.count();
+    perf->pktRcvFilterExtraTotal  = m_stats.rcvr.recvdFilterExtra.total.count();
+    perf->pktRcvFilterSupplyTotal = m_stats.rcvr.suppliedByFilter.total.count();
+    perf->pktRcvFilterLossTotal   = m_stats.rcvr.lossFilter.total.count();
+
+    perf->byteRcvLossTotal = m_stats.rcvr.lost.total.bytesWithHdr(pktHdrSize);
+    perf->pktSndDropTotal  = m_stats.sndr.dropped.total.count();
+    perf->pktRcvDropTotal  = m_stats.rcvr.dropped.total.count();
+    // TODO: The payload is dropped. Probably header sizes should not be counted?
+    perf->byteSndDropTotal = m_stats.sndr.dropped.total.bytesWithHdr(pktHdrSize);
+    perf->byteRcvDropTotal = m_stats.rcvr.dropped.total.bytesWithHdr(pktHdrSize);
+    perf->pktRcvUndecryptTotal  = m_stats.rcvr.undecrypted.total.count();
+    perf->byteRcvUndecryptTotal = m_stats.rcvr.undecrypted.total.bytes();
+
+    const double interval     = (double) count_microseconds(currtime - m_stats.tsLastSampleTime.load());
+    perf->mbpsSendRate        = double(perf->byteSent) * 8.0 / interval;
+    perf->mbpsRecvRate        = double(perf->byteRecv) * 8.0 / interval;
+    perf->usPktSndPeriod      = (double) count_microseconds(m_tdSendInterval.load());
+    perf->pktFlowWindow       = m_iFlowWindowSize.load();
+    perf->pktCongestionWindow = m_iCongestionWindow;
+    perf->pktFlightSize       = getFlightSpan();
+    perf->msRTT               = (double)m_iSRTT / 1000.0;
+    perf->msSndTsbPdDelay     = m_bPeerTsbPd ? m_iPeerTsbPdDelay_ms : 0;
+    perf->msRcvTsbPdDelay     = isOPT_TsbPd() ? m_iTsbPdDelay_ms : 0;
+    perf->byteMSS             = m_config.iMSS;
+
+    perf->mbpsMaxBW = m_config.llMaxBW > 0 ? Bps2Mbps(m_config.llMaxBW)
+                    : m_CongCtl.ready()    ? Bps2Mbps(m_CongCtl->sndBandwidth())
+                                            : 0;
+}
+
 void srt::CUDT::bstats(CBytePerfMon *perf, bool clear, bool instantaneous)
 {
     if (!m_bConnected)
@@ -7455,108 +7733,21 @@ void srt::CUDT::bstats(CBytePerfMon *perf, bool clear, bool instantaneous)
 
     const int pktHdrSize = CPacket::HDR_SIZE + CPacket::UDP_HDR_SIZE;
     {
-        int32_t flight_span = getFlightSpan();
-
         ScopedLock statsguard(m_StatsLock);
 
         const steady_clock::time_point currtime = steady_clock::now();
 
-        perf->msTimeStamp          = count_milliseconds(currtime - m_stats.tsStartTime);
-        perf->pktSent              = m_stats.sndr.sent.trace.count();
-        perf->pktSentUnique        = m_stats.sndr.sentUnique.trace.count();
-        perf->pktRecv              = m_stats.rcvr.recvd.trace.count();
-        perf->pktRecvUnique        = m_stats.rcvr.recvdUnique.trace.count();
-
-        perf->pktSndLoss           = m_stats.sndr.lost.trace.count();
-        perf->pktRcvLoss           = m_stats.rcvr.lost.trace.count();
-        perf->pktRetrans           = m_stats.sndr.sentRetrans.trace.count();
-        perf->pktRcvRetrans        = m_stats.rcvr.recvdRetrans.trace.count();
-        perf->pktSentACK           = m_stats.rcvr.sentAck.trace.count();
-        perf->pktRecvACK           = m_stats.sndr.recvdAck.trace.count();
-        perf->pktSentNAK           = m_stats.rcvr.sentNak.trace.count();
-        perf->pktRecvNAK           = m_stats.sndr.recvdNak.trace.count();
-        perf->usSndDuration        = m_stats.sndDuration;
-        perf->pktReorderDistance   = m_stats.traceReorderDistance;
-        perf->pktReorderTolerance  = m_iReorderTolerance;
-        perf->pktRcvAvgBelatedTime = m_stats.traceBelatedTime;
-        perf->pktRcvBelated        = m_stats.rcvr.recvdBelated.trace.count();
-
-        perf->pktSndFilterExtra  = m_stats.sndr.sentFilterExtra.trace.count();
-        perf->pktRcvFilterExtra  = m_stats.rcvr.recvdFilterExtra.trace.count();
-        perf->pktRcvFilterSupply = m_stats.rcvr.suppliedByFilter.trace.count();
-        perf->pktRcvFilterLoss   = m_stats.rcvr.lossFilter.trace.count();
-
-        /* perf byte counters include all headers (SRT+UDP+IP) */
-        perf->byteSent       = m_stats.sndr.sent.trace.bytesWithHdr(pktHdrSize);
-        perf->byteSentUnique = m_stats.sndr.sentUnique.trace.bytesWithHdr(pktHdrSize);
-        perf->byteRecv       = m_stats.rcvr.recvd.trace.bytesWithHdr(pktHdrSize);
-        perf->byteRecvUnique = m_stats.rcvr.recvdUnique.trace.bytesWithHdr(pktHdrSize);
-        perf->byteRetrans    = m_stats.sndr.sentRetrans.trace.bytesWithHdr(pktHdrSize);
-        perf->byteRcvLoss    = m_stats.rcvr.lost.trace.bytesWithHdr(pktHdrSize);
-
-        perf->pktSndDrop  = m_stats.sndr.dropped.trace.count();
-        perf->pktRcvDrop  = m_stats.rcvr.dropped.trace.count();
-        perf->byteSndDrop = m_stats.sndr.dropped.trace.bytesWithHdr(pktHdrSize);
-        perf->byteRcvDrop = m_stats.rcvr.dropped.trace.bytesWithHdr(pktHdrSize);
-        perf->pktRcvUndecrypt  = m_stats.rcvr.undecrypted.trace.count();
-        perf->byteRcvUndecrypt = m_stats.rcvr.undecrypted.trace.bytes();
-
-        perf->pktSentTotal       = m_stats.sndr.sent.total.count();
-        perf->pktSentUniqueTotal = m_stats.sndr.sentUnique.total.count();
-        perf->pktRecvTotal       = m_stats.rcvr.recvd.total.count();
-        perf->pktRecvUniqueTotal = m_stats.rcvr.recvdUnique.total.count();
-        perf->pktSndLossTotal    = m_stats.sndr.lost.total.count();
-        perf->pktRcvLossTotal    = m_stats.rcvr.lost.total.count();
-        perf->pktRetransTotal    = m_stats.sndr.sentRetrans.total.count();
-        perf->pktSentACKTotal    = m_stats.rcvr.sentAck.total.count();
-        perf->pktRecvACKTotal    = m_stats.sndr.recvdAck.total.count();
-        perf->pktSentNAKTotal    = m_stats.rcvr.sentNak.total.count();
-        perf->pktRecvNAKTotal    = m_stats.sndr.recvdNak.total.count();
-        perf->usSndDurationTotal = m_stats.m_sndDurationTotal;
-
-        perf->byteSentTotal           = m_stats.sndr.sent.total.bytesWithHdr(pktHdrSize);
-        perf->byteSentUniqueTotal     = m_stats.sndr.sentUnique.total.bytesWithHdr(pktHdrSize);
-        perf->byteRecvTotal           = m_stats.rcvr.recvd.total.bytesWithHdr(pktHdrSize);
-        perf->byteRecvUniqueTotal     = m_stats.rcvr.recvdUnique.total.bytesWithHdr(pktHdrSize);
-        perf->byteRetransTotal        = m_stats.sndr.sentRetrans.total.bytesWithHdr(pktHdrSize);
-        perf->pktSndFilterExtraTotal  = m_stats.sndr.sentFilterExtra.total.count();
-        perf->pktRcvFilterExtraTotal  = m_stats.rcvr.recvdFilterExtra.total.count();
-        perf->pktRcvFilterSupplyTotal = m_stats.rcvr.suppliedByFilter.total.count();
-        perf->pktRcvFilterLossTotal   = m_stats.rcvr.lossFilter.total.count();
-
-        perf->byteRcvLossTotal = m_stats.rcvr.lost.total.bytesWithHdr(pktHdrSize);
-        perf->pktSndDropTotal  = m_stats.sndr.dropped.total.count();
-        perf->pktRcvDropTotal  = m_stats.rcvr.dropped.total.count();
-        // TODO: The payload is dropped. Probably header sizes should not be counted?
-        perf->byteSndDropTotal = m_stats.sndr.dropped.total.bytesWithHdr(pktHdrSize);
-        perf->byteRcvDropTotal = m_stats.rcvr.dropped.total.bytesWithHdr(pktHdrSize);
-        perf->pktRcvUndecryptTotal  = m_stats.rcvr.undecrypted.total.count();
-        perf->byteRcvUndecryptTotal = m_stats.rcvr.undecrypted.total.bytes();
-
-        // TODO: The following class members must be protected with a different mutex, not the m_StatsLock.
-        const double interval     = (double) count_microseconds(currtime - m_stats.tsLastSampleTime);
-        perf->mbpsSendRate        = double(perf->byteSent) * 8.0 / interval;
-        perf->mbpsRecvRate        = double(perf->byteRecv) * 8.0 / interval;
-        perf->usPktSndPeriod      = (double) count_microseconds(m_tdSendInterval.load());
-        perf->pktFlowWindow       = m_iFlowWindowSize.load();
-        perf->pktCongestionWindow = m_iCongestionWindow;
-        perf->pktFlightSize       = flight_span;
-        perf->msRTT               = (double)m_iSRTT / 1000.0;
-        perf->msSndTsbPdDelay     = m_bPeerTsbPd ? m_iPeerTsbPdDelay_ms : 0;
-        perf->msRcvTsbPdDelay     = isOPT_TsbPd() ? m_iTsbPdDelay_ms : 0;
-        perf->byteMSS             = m_config.iMSS;
-
-        perf->mbpsMaxBW = m_config.llMaxBW > 0 ? Bps2Mbps(m_config.llMaxBW)
-                        : m_CongCtl.ready()    ? Bps2Mbps(m_CongCtl->sndBandwidth())
-                                                : 0;
+        fillPerfCounters(perf, currtime);
 
         if (clear)
         {
+            m_StatsVersion.beginWrite();
             m_stats.sndr.resetTrace();
             m_stats.rcvr.resetTrace();
 
             m_stats.sndDuration = 0;
             m_stats.tsLastSampleTime = currtime;
+            m_StatsVersion.endWrite();
         }
     }
 
@@ -7624,6 +7815,71 @@ void srt::CUDT::bstats(CBytePerfMon *perf, bool clear, bool instantaneous)
     }
 }
 
+void srt::CUDT::bstatsSnapshot(CBytePerfMon* perf)
+{
+#if SRT_STATS_LOCKFREE
+    if (!m_bConnected)
+        throw CUDTException(MJ_CONNECTION, MN_NOCONN, 0);
+    if (m_bBroken || m_bClosing)
+        throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
+
+    // No lock is taken here: neither m_StatsLock nor any of the buffer locks
+    // that the sending and receiving threads contend for. The counters are
+    // read again if they were updated in the meantime (see stats::Version),
+    // and only if this keeps happening, m_StatsLock is taken to read them.
+    const int pktHdrSize = CPacket::HDR_SIZE + CPacket::UDP_HDR_SIZE;
+    const steady_clock::time_point currtime = steady_clock::now();
+
+    bool consistent = false;
+    for (int i = 0; i < 4 && !consistent; ++i)
+    {
+        const uint32_t ver = m_StatsVersion.beginRead();
+        fillPerfCounters(perf, currtime);
+        consistent = m_StatsVersion.validRead(ver);
+    }
+    if (!consistent)
+    {
+        ScopedLock statsguard(m_StatsLock);
+        fillPerfCounters(perf, currtime);
+    }
+
+    perf->mbpsBandwidth = Bps2Mbps(int64_t(m_iBandwidth.load()) * (m_iMaxSRTPayloadSize + pktHdrSize));
+
+    // The buffer contents are not consistent with the counters, as they are
+    // updated under the buffer locks. The timespans are stored by the buffers
+    // whenever their contents change.
+    if (m_pSndBuffer)
+    {
+        perf->pktSndBuf = m_pSndBuffer->getCurrBufSizeSnapshot((perf->byteSndBuf), (perf->msSndBuf));
+        perf->byteSndBuf += (perf->pktSndBuf * pktHdrSize);
+        perf->byteAvailSndBuf = (m_config.iSndBufSize - perf->pktSndBuf) * m_config.iMSS;
+    }
+    else
+    {
+        perf->byteAvailSndBuf = 0;
+        perf->pktSndBuf  = 0;
+        perf->byteSndBuf = 0;
+        perf->msSndBuf   = 0;
+    }
+
+    if (m_pRcvBuffer)
+    {
+        perf->pktRcvBuf = m_pRcvBuffer->getRcvDataSizeSnapshot((perf->byteRcvBuf), (perf->msRcvBuf));
+        perf->byteAvailRcvBuf = std::max(0, m_config.iRcvBufSize - perf->pktRcvBuf) * m_config.iMSS;
+    }
+    else
+    {
+        perf->byteAvailRcvBuf = 0;
+        perf->pktRcvBuf  = 0;
+        perf->byteRcvBuf = 0;
+        perf->msRcvBuf   = 0;
+    }
+#else
+    // Without atomic instructions the counters can't be read without locking.
+    bstats(perf, false, true);
+#endif
+}
+
 bool srt::CUDT::updateCC(ETransmissionEvent evt, const EventVariant arg)
 {
     // Special things that must be done HERE, not in SrtCongestion,
@@ -7634,14 +7890,14 @@ bool srt::CUDT::updateCC(ETransmissionEvent evt, const EventVariant arg)
     // time when the sending buffer. For sanity check, check both first.
     if (!m_CongCtl.ready() || !m_pSndBuffer)
     {
-        LOGC(rslog.Error,
+        SLOGC(rslog.Error, m_SocketID,
              log << CONID() << "updateCC: CAN'T DO UPDATE - congctl " << (m_CongCtl.ready() ? "ready" : "NOT READY")
             << "; sending buffer " << (m_pSndBuffer ? "NOT CREATED" : "created"));
 
         return false;
     }
 
-    HLOGC(rslog.Debug, log << CONID() << "updateCC: EVENT:" << TransmissionEventStr(evt));
+    HSLOGC(rslog.Debug, m_SocketID, log << CONID() << "updateCC: EVENT:" << TransmissionEventStr(evt));
 
     if (evt == TEV_INIT)
     {
@@ -7654,7 +7910,7 @@ bool srt::CUDT::updateCC(ETransmissionEvent evt, const EventVariant arg)
 
         if (only_input != TEV_INIT_RESET && m_config.llMaxBW)
         {
-            HLOGC(rslog.Debug, log << CONID() << "updateCC/TEV_INIT: non-RESET stage and m_config.llMaxBW already set to " << m_config.llMaxBW);
+            HSLOGC(rslog.Debug, m_SocketID, log << CONID() << "updateCC/TEV_INIT: non-RESET stage and m_config.llMaxBW already set to " << m_config.llMaxBW);
             // Don't change
         }
         else // either m_config.llMaxBW == 0 or only_input == TEV_INIT_RESET
@@ -7683,7 +7939,7 @@ bool srt::CUDT::updateCC(ETransmissionEvent evt, const EventVariant arg)
                 m_pSndBuffer->resetInputRateSmpPeriod(disable_in_rate_calc);
             }
 
-            HLOGC(rslog.Debug,
+            HSLOGC(rslog.Debug, m_SocketID,
                   log << CONID() << "updateCC/TEV_INIT: updating BW=" << m_config.llMaxBW
                       << (only_input == TEV_INIT_RESET
                               ? " (UNCHANGED)"
@@ -7714,7 +7970,7 @@ bool srt::CUDT::updateCC(ETransmissionEvent evt, const EventVariant arg)
         }
     }
 
-    HLOGC(rslog.Debug, log << CONID() << "updateCC: emitting signal for EVENT:" << TransmissionEventStr(evt));
+    HSLOGC(rslog.Debug, m_SocketID, log << CONID() << "updateCC: emitting signal for EVENT:" << TransmissionEventStr(evt));
 
     // Now execute a congctl-defined action for that event.
     EmitSignal(evt, arg);
@@ -7731,14 +7987,14 @@ bool srt::CUDT::updateCC(ETransmissionEvent evt, const EventVariant arg)
         const double cgwindow = m_CongCtl->cgWindowSize();
         m_iCongestionWindow = cgwindow;
 #if ENABLE_HEAVY_LOGGING
-        HLOGC(rslog.Debug,
+        HSLOGC(rslog.Debug, m_SocketID,
               log << CONID() << "updateCC: updated values from congctl: interval=" << count_microseconds(m_tdSendInterval) << " us ("
                   << "tk (" << m_CongCtl->pktSndPeriod_us() << "us) cgwindow="
                   << std::setprecision(3) << cgwindow);
 #endif
     }
 
-    HLOGC(rslog.Debug, log << CONID() << "udpateCC: finished handling for EVENT:" << TransmissionEventStr(evt));
+    HSLOGC(rslog.Debug, m_SocketID, log << CONID() << "udpateCC: finished handling for EVENT:" << TransmissionEventStr(evt));
 
     return true;
 }
@@ -7804,6 +8060,16 @@ void srt::CUDT::releaseSynch()
     {
         m_RcvTsbPdThread.join();
     }
+    // Or wait for the shared scheduler to finish checking this socket.
+    uglobal().m_TsbPdScheduler.remove(m_TsbPdTask);
+#if ENABLE_BONDING
+    if (m_pTsbPdGroup)
+    {
+        ScopedLock cgroup (*m_pTsbPdGroup->exp_groupLock());
+        m_pTsbPdGroup->apiRelease();
+        m_pTsbPdGroup = NULL;
+    }
+#endif
     leaveCS(m_RcvTsbPdStartupLock);
 
     // Acquiring the m_RecvLock it is assumed that both tsbpd()
@@ -7838,7 +8104,7 @@ void srt::CUDT::dropToGroupRecvBase()
     int cnt = rcvDropTooLateUpTo(CSeqNo::incseq(group_recv_base));
     if (cnt > 0)
     {
-        HLOGC(grlog.Debug,
+        HSLOGC(grlog.Debug, m_SocketID,
               log << CONID() << "dropToGroupRecvBase: dropped " << cnt << " packets before ACK: group_recv_base="
                   << group_recv_base << " m_iRcvLastAck=" << m_iRcvLastAck
                   << " m_iRcvCurrSeqNo=" << m_iRcvCurrSeqNo << " m_bTsbPd=" << m_bTsbPd);
@@ -7848,18 +8114,18 @@ void srt::CUDT::dropToGroupRecvBase()
 
 namespace srt {
 #if ENABLE_HEAVY_LOGGING
-static void DebugAck(string hdr, int prev, int ack)
+static void DebugAck(const srt_logging::LogSocketId& conid, const char* hdr, int prev, int ack)
 {
     if (!prev)
     {
-        HLOGC(xtlog.Debug, log << hdr << "ACK " << ack);
+        HSLOGC(xtlog.Debug, conid.id, log << conid << hdr << "ACK " << ack);
         return;
     }
 
     int diff = CSeqNo::seqoff(prev, ack);
     if (diff < 0)
     {
-        HLOGC(xtlog.Debug, log << hdr << "ACK ERROR: " << prev << "-" << ack << "(diff " << diff << ")");
+        HSLOGC(xtlog.Debug, conid.id, log << conid << hdr << "ACK ERROR: " << prev << "-" << ack << "(diff " << diff << ")");
         return;
     }
 
@@ -7867,15 +8133,18 @@ static void DebugAck(string hdr, int prev, int ack)
     if (shorted)
         ack = CSeqNo::incseq(prev, 100);
 
+    if (!xtlog.Debug.CheckEnabled(conid.id))
+        return;
+
     ostringstream ackv;
     for (; prev != ack; prev = CSeqNo::incseq(prev))
         ackv << prev << " ";
     if (shorted)
         ackv << "...";
-    HLOGC(xtlog.Debug, log << hdr << "ACK (" << (diff + 1) << "): " << ackv.str() << ack);
+    HSLOGC(xtlog.Debug, conid.id, log << conid << hdr << "ACK (" << (diff + 1) << "): " << ackv.str() << ack);
 }
 #else
-static inline void DebugAck(string, int, int) {}
+static inline void DebugAck(const srt_logging::LogSocketId&, const char*, int, int) {}
 #endif
 }
 
@@ -7914,9 +8183,9 @@ void srt::CUDT::sendCtrl(UDTMessageType pkttype, const int32_t* lparam, void* rp
             ctrlpkt.set_id(m_PeerID);
             nbsent        = m_pSndQueue->sendto(m_PeerAddr, ctrlpkt, m_SourceAddr);
 
-            enterCS(m_StatsLock);
+            enterStatsCS();
             m_stats.rcvr.sentNak.count(1);
-            leaveCS(m_StatsLock);
+            leaveStatsCS();
         }
         // Call with no arguments - get loss list from internal data.
         else if (m_pRcvLossList->getLossLength() > 0)
@@ -7935,9 +8204,9 @@ void srt::CUDT::sendCtrl(UDTMessageType pkttype, const int32_t* lparam, void* rp
                 ctrlpkt.set_id(m_PeerID);
                 nbsent        = m_pSndQueue->sendto(m_PeerAddr, ctrlpkt, m_SourceAddr);
 
-                enterCS(m_StatsLock);
+                enterStatsCS();
                 m_stats.rcvr.sentNak.count(1);
-                leaveCS(m_StatsLock);
+                leaveStatsCS();
             }
 
             delete[] data;
@@ -8069,6 +8338,8 @@ int srt::CUDT::sendCtrlAck(CPacket& ctrlpkt, int size)
     // The TSBPD thread may change the first lost sequence record (TLPKTDROP).
     // To avoid it the m_RcvBufferLock has to be acquired.
     UniqueLock bufflock(m_RcvBufferLock);
+    m_pRcvBuffer->releaseUnusedEntries(loop_now());
+
     // The full ACK should be sent to indicate there is now available space in the RCV buffer
     // since the last full ACK. It should unblock the sender to proceed further.
     const bool bNeedFullAck = (m_bBufferWasFull && getAvailRcvBufferSizeNoLock() > 0);
@@ -8078,7 +8349,7 @@ int srt::CUDT::sendCtrlAck(CPacket& ctrlpkt, int size)
 
     if (m_iRcvLastAckAck == ack && !bNeedFullAck)
     {
-        HLOGC(xtlog.Debug,      
+        HSLOGC(xtlog.Debug, m_SocketID,      
                 log << CONID() << "sendCtrl(UMSG_ACK): last ACK %" << ack << "(" << reason << ") == last ACKACK");     
         return nbsent;    
     }
@@ -8090,7 +8361,7 @@ int srt::CUDT::sendCtrlAck(CPacket& ctrlpkt, int size)
         ctrlpkt.pack(UMSG_ACK, NULL, &ack, size);
         ctrlpkt.set_id(m_PeerID);
         nbsent = m_pSndQueue->sendto(m_PeerAddr, ctrlpkt, m_SourceAddr);
-        DebugAck(CONID() + "sendCtrl(lite): ", local_prevack, ack);
+        DebugAck(CONID(), "sendCtrl(lite): ", local_prevack, ack);
         return nbsent;
     }
 
@@ -8109,13 +8380,13 @@ int srt::CUDT::sendCtrlAck(CPacket& ctrlpkt, int size)
         // should it happen in the future.
         if (CSeqNo::seqcmp(ack, m_pRcvBuffer->getStartSeqNo()) < 0)
         {
-            LOGC(xtlog.Error,
+            SLOGC(xtlog.Error, m_SocketID,
                     log << CONID() << "sendCtrlAck: IPE: invalid ACK from %" << m_iRcvLastAck << " to %" << ack << " ("
                     << CSeqNo::seqoff(m_iRcvLastAck, ack) << " packets) buffer=%" << m_pRcvBuffer->getStartSeqNo());
         }
         else
         {
-            HLOGC(xtlog.Debug,
+            HSLOGC(xtlog.Debug, m_SocketID,
                     log << CONID() << "sendCtrlAck: %" << m_iRcvLastAck << " -> %" << ack << " ("
                     << CSeqNo::seqoff(m_iRcvLastAck, ack) << " packets)");
         }
@@ -8164,17 +8435,17 @@ int srt::CUDT::sendCtrlAck(CPacket& ctrlpkt, int size)
         // signal m_RcvTsbPdCond. This will kick in the tsbpd thread, which
         // will signal m_RecvDataCond when there's time to play for particular
         // data packet.
-        HLOGC(xtlog.Debug,
+        HSLOGC(xtlog.Debug, m_SocketID,
               log << CONID() << "ACK: clip %" << m_iRcvLastAck << "-%" << ack << ", REVOKED "
                   << CSeqNo::seqoff(ack, m_iRcvLastAck) << " from RCV buffer");
 
         if (m_bTsbPd)
         {
             /* Newly acknowledged data, signal TsbPD thread */
-            CUniqueSync tslcc (m_RecvLock, m_RcvTsbPdCond);
+            ScopedLock recvlock (m_RecvLock);
             // m_bTsbPdAckWakeup is protected by m_RecvLock in the tsbpd() thread
             if (m_bTsbPdAckWakeup)
-                tslcc.notify_one();
+                notifyTsbPd();
         }
         else
         {
@@ -8228,7 +8499,7 @@ int srt::CUDT::sendCtrlAck(CPacket& ctrlpkt, int size)
         if ((steady_clock::now() - m_tsLastAckTime) <
             (microseconds_from(m_iSRTT + 4 * m_iRTTVar)))
         {
-            HLOGC(xtlog.Debug,
+            HSLOGC(xtlog.Debug, m_SocketID,
                   log << CONID() << "sendCtrl(UMSG_ACK): ACK %" << ack << " just sent - too early to repeat");
             return nbsent;
         }
@@ -8236,7 +8507,7 @@ int srt::CUDT::sendCtrlAck(CPacket& ctrlpkt, int size)
     else if (!bNeedFullAck)
     {
         // Not possible (m_iRcvCurrSeqNo+1 <% m_iRcvLastAck ?)
-        LOGC(xtlog.Error, log << CONID() << "sendCtrl(UMSG_ACK): IPE: curr %" << ack << " <% last %" << m_iRcvLastAck);
+        SLOGC(xtlog.Error, m_SocketID, log << CONID() << "sendCtrl(UMSG_ACK): IPE: curr %" << ack << " <% last %" << m_iRcvLastAck);
         return nbsent;
     }
 
@@ -8295,17 +8566,17 @@ int srt::CUDT::sendCtrlAck(CPacket& ctrlpkt, int size)
         ctrlpkt.set_id(m_PeerID);
         setPacketTS(ctrlpkt, steady_clock::now());
         nbsent = m_pSndQueue->sendto(m_PeerAddr, ctrlpkt, m_SourceAddr);
-        DebugAck(CONID() + "sendCtrl(UMSG_ACK): ", local_prevack, ack);
+        DebugAck(CONID(), "sendCtrl(UMSG_ACK): ", local_prevack, ack);
 
         m_ACKWindow.store(m_iAckSeqNo, m_iRcvLastAck);
 
-        enterCS(m_StatsLock);
+        enterStatsCS();
         m_stats.rcvr.sentAck.count(1);
-        leaveCS(m_StatsLock);
+        leaveStatsCS();
     }
     else
     {
-        HLOGC(xtlog.Debug, log << CONID() << "sendCtrl(UMSG_ACK): " << "ACK %" << m_iRcvLastAck
+        HSLOGC(xtlog.Debug, m_SocketID, log << CONID() << "sendCtrl(UMSG_ACK): " << "ACK %" << m_iRcvLastAck
             << " <=%  ACKACK %" << m_iRcvLastAckAck << " - NOT SENDING ACK");
     }
 
@@ -8353,6 +8624,11 @@ void srt::CUDT::updateSndLossListOnACK(int32_t ackdata_seqno)
         // acknowledge the sending buffer (remove data that predate 'ack')
         m_pSndBuffer->ackData(offset);
 
+        // A closed socket lingering until all data are delivered
+        // can be collected now (see CUDTUnited::checkClosedSocket_LOCKED()).
+        if (!is_zero(m_tsLingerExpiration) && m_pSndBuffer->getCurrBufSize() == 0)
+            uglobal().scheduleGC(m_SocketID);
+
         // acknowledde any waiting epolls to write
         uglobal().m_EPoll.update_events(m_SocketID, m_sPollID, SRT_EPOLL_OUT, true);
         CGlobEvent::triggerEvent();
@@ -8366,7 +8642,7 @@ void srt::CUDT::updateSndLossListOnACK(int32_t ackdata_seqno)
         ScopedLock glock (uglobal().m_GlobControlLock);
         if (m_parent->m_GroupOf)
         {
-            HLOGC(inlog.Debug, log << CONID() << "ACK: acking group sender buffer for #" << msgno_at_last_acked_seq);
+            HSLOGC(inlog.Debug, m_SocketID, log << CONID() << "ACK: acking group sender buffer for #" << msgno_at_last_acked_seq);
 
             // Guard access to m_iSndAckedMsgNo field
             // Note: This can't be done inside CUDTGroup::ackMessage
@@ -8392,11 +8668,12 @@ void srt::CUDT::updateSndLossListOnACK(int32_t ackdata_seqno)
     }
 
     // record total time used for sending
-    enterCS(m_StatsLock);
-    m_stats.sndDuration += count_microseconds(currtime - m_stats.sndDurationCounter);
-    m_stats.m_sndDurationTotal += count_microseconds(currtime - m_stats.sndDurationCounter);
+    enterStatsCS();
+    const int64_t sndduration = count_microseconds(currtime - m_stats.sndDurationCounter);
+    m_stats.sndDuration = m_stats.sndDuration + sndduration;
+    m_stats.m_sndDurationTotal = m_stats.m_sndDurationTotal + sndduration;
     m_stats.sndDurationCounter = currtime;
-    leaveCS(m_StatsLock);
+    leaveStatsCS();
 }
 
 void srt::CUDT::processCtrlAck(const CPacket &ctrlpkt, const steady_clock::time_point& currtime)
@@ -8411,13 +8688,13 @@ void srt::CUDT::processCtrlAck(const CPacket &ctrlpkt, const steady_clock::time_
         // as the variable is of a signed type. So, SRT_SEQNO_NONE is
         // included, but it also triggers for any other kind of invalid value.
         // This check MUST BE DONE before making any operation on this number.
-        LOGC(inlog.Error, log << CONID() << "ACK: IPE/EPE: received invalid ACK value: " << ackdata_seqno
+        SLOGC(inlog.Error, m_SocketID, log << CONID() << "ACK: IPE/EPE: received invalid ACK value: " << ackdata_seqno
                 << " " << std::hex << ackdata_seqno << " (IGNORED)");
         return;
     }
 
     const bool isLiteAck = ctrlpkt.getLength() == (size_t)SEND_LITE_ACK;
-    HLOGC(inlog.Debug,
+    HSLOGC(inlog.Debug, m_SocketID,
           log << CONID() << "ACK covers: " << m_iSndLastDataAck << " - " << ackdata_seqno << " [ACK=" << m_iSndLastAck
               << "]" << (isLiteAck ? "[LITE]" : "[FULL]"));
 
@@ -8467,11 +8744,12 @@ void srt::CUDT::processCtrlAck(const CPacket &ctrlpkt, const steady_clock::time_
         if (CSeqNo::seqcmp(ackdata_seqno, CSeqNo::incseq(m_iSndCurrSeqNo)) > 0)
         {
             // this should not happen: attack or bug
-            LOGC(gglog.Error,
+            SLOGC(gglog.Error, m_SocketID,
                     log << CONID() << "ATTACK/IPE: incoming ack seq " << ackdata_seqno << " exceeds current "
                     << m_iSndCurrSeqNo << " by " << (CSeqNo::seqoff(m_iSndCurrSeqNo, ackdata_seqno) - 1) << "!");
             m_bBroken        = true;
             m_iBrokenCounter = 0;
+            uglobal().scheduleGC(m_SocketID);
             return;
         }
 
@@ -8489,7 +8767,7 @@ void srt::CUDT::processCtrlAck(const CPacket &ctrlpkt, const steady_clock::time_
         if (bWasStuck && cwnd > getFlightSpan())
         {
             m_pSndQueue->m_pSndUList->update(this, CSndUList::DONT_RESCHEDULE);
-            HLOGC(gglog.Debug,
+            HSLOGC(gglog.Debug, m_SocketID,
                     log << CONID() << "processCtrlAck: could reschedule SND. iFlowWindowSize " << m_iFlowWindowSize
                     << " SPAN " << getFlightSpan() << " ackdataseqno %" << ackdata_seqno);
         }
@@ -8535,7 +8813,7 @@ void srt::CUDT::processCtrlAck(const CPacket &ctrlpkt, const steady_clock::time_
     if (wrongsize)
     {
         // Issue a log, but don't do anything but skipping the "odd" bytes from the payload.
-        LOGC(inlog.Warn,
+        SLOGC(inlog.Warn, m_SocketID,
              log << CONID() << "Received UMSG_ACK payload is not evened up to 4-byte based field size - cutting to "
                  << acksize << " fields");
     }
@@ -8543,7 +8821,7 @@ void srt::CUDT::processCtrlAck(const CPacket &ctrlpkt, const steady_clock::time_
     // Start with checking the base size.
     if (acksize < ACKD_TOTAL_SIZE_SMALL)
     {
-        LOGC(inlog.Warn, log << CONID() << "Invalid ACK size " << acksize << " fields - less than minimum required!");
+        SLOGC(inlog.Warn, m_SocketID, log << CONID() << "Invalid ACK size " << acksize << " fields - less than minimum required!");
         // Ack is already interpreted, just skip further parts.
         return;
     }
@@ -8652,9 +8930,9 @@ void srt::CUDT::processCtrlAck(const CPacket &ctrlpkt, const steady_clock::time_
 
     updateCC(TEV_ACK, EventVariant(ackdata_seqno));
 
-    enterCS(m_StatsLock);
+    enterStatsCS();
     m_stats.sndr.recvdAck.count(1);
-    leaveCS(m_StatsLock);
+    leaveStatsCS();
 }
 
 void srt::CUDT::processCtrlAckAck(const CPacket& ctrlpkt, const time_point& tsArrival)
@@ -8668,14 +8946,14 @@ void srt::CUDT::processCtrlAckAck(const CPacket& ctrlpkt, const time_point& tsAr
     {
         if (ctrlpkt.getAckSeqNo() > (m_iAckSeqNo - static_cast<int>(ACK_WND_SIZE)) && ctrlpkt.getAckSeqNo() <= m_iAckSeqNo)
         {
-            LOGC(inlog.Note,
+            SLOGC(inlog.Note, m_SocketID,
                 log << CONID() << "ACKACK out of order, skipping RTT calculation "
                 << "(ACK number: " << ctrlpkt.getAckSeqNo() << ", last ACK sent: " << m_iAckSeqNo
                 << ", RTT (EWMA): " << m_iSRTT << ")");
             return;
         }
 
-        LOGC(inlog.Error,
+        SLOGC(inlog.Error, m_SocketID,
              log << CONID() << "ACK record not found, can't estimate RTT "
                  << "(ACK number: " << ctrlpkt.getAckSeqNo() << ", last ACK sent: " << m_iAckSeqNo
                  << ", RTT (EWMA): " << m_iSRTT << ")");
@@ -8684,7 +8962,7 @@ void srt::CUDT::processCtrlAckAck(const CPacket& ctrlpkt, const time_point& tsAr
 
     if (rtt <= 0)
     {
-        LOGC(inlog.Error,
+        SLOGC(inlog.Error, m_SocketID,
             log << CONID() << "IPE: invalid RTT estimate " << rtt
             << ", possible time shift. Clock: " << SRT_SYNC_CLOCK_STR);
         return;
@@ -8772,7 +9050,7 @@ void srt::CUDT::processCtrlLossReport(const CPacket& ctrlpkt)
                 // <LO, HI> specification means that the consecutive cell has been already interpreted.
                 ++i;
 
-                HLOGC(inlog.Debug, log << CONID() << "received UMSG_LOSSREPORT: "
+                HSLOGC(inlog.Debug, m_SocketID, log << CONID() << "received UMSG_LOSSREPORT: "
                                        << losslist_lo << "-" << losslist_hi
                                        << " (" << CSeqNo::seqlen(losslist_lo, losslist_hi) << " packets)...");
 
@@ -8781,7 +9059,7 @@ void srt::CUDT::processCtrlLossReport(const CPacket& ctrlpkt)
                 {
                     // LO must not be greater than HI.
                     // HI must not be greater than the most recent sent seq.
-                    LOGC(inlog.Warn, log << CONID() << "rcv LOSSREPORT rng " << losslist_lo << " - " << losslist_hi
+                    SLOGC(inlog.Warn, m_SocketID, log << CONID() << "rcv LOSSREPORT rng " << losslist_lo << " - " << losslist_hi
                         << " with last sent " << m_iSndCurrSeqNo << " - DISCARDING");
                     secure = false;
                     wrong_loss = losslist_hi;
@@ -8792,7 +9070,7 @@ void srt::CUDT::processCtrlLossReport(const CPacket& ctrlpkt)
                 // IF losslist_lo %>= m_iSndLastAck
                 if (CSeqNo::seqcmp(losslist_lo, m_iSndLastAck) >= 0)
                 {
-                    HLOGC(inlog.Debug, log << CONID() << "LOSSREPORT: adding "
+                    HSLOGC(inlog.Debug, m_SocketID, log << CONID() << "LOSSREPORT: adding "
                         << losslist_lo << " - " << losslist_hi << " to loss list");
                     num = m_pSndLossList->insert(losslist_lo, losslist_hi);
                 }
@@ -8816,7 +9094,7 @@ void srt::CUDT::processCtrlLossReport(const CPacket& ctrlpkt)
                     // IF losslist_hi %>= m_iSndLastAck
                     if (CSeqNo::seqcmp(losslist_hi, m_iSndLastAck) >= 0)
                     {
-                        HLOGC(inlog.Debug, log << CONID() << "LOSSREPORT: adding "
+                        HSLOGC(inlog.Debug, m_SocketID, log << CONID() << "LOSSREPORT: adding "
                                 << m_iSndLastAck << "[ACK] - " << losslist_hi << " to loss list");
                         num = m_pSndLossList->insert(m_iSndLastAck, losslist_hi);
                         dropreq_hi = CSeqNo::decseq(m_iSndLastAck);
@@ -8832,15 +9110,18 @@ void srt::CUDT::processCtrlLossReport(const CPacket& ctrlpkt)
                     // - repeatedly send LOSSREPORT (as per NAKREPORT), so this will happen again
                     // - finally give up rexmit request as per TLPKTDROP (DROPREQ should make
                     //   TSBPD wake up should it still wait for new packets to get ACK-ed)
-                    HLOGC(inlog.Debug,
+                    HSLOGC(inlog.Debug, m_SocketID,
                           log << CONID() << "LOSSREPORT: " << drop_type << " IGNORED with SndLastAck=%" << m_iSndLastAck
                               << ": %" << losslist_lo << "-" << dropreq_hi << " - sending DROPREQ");
                     sendCtrl(UMSG_DROPREQ, &no_msgno, seqpair, sizeof(seqpair));
                 }
 
-                enterCS(m_StatsLock);
+                enterStatsCS();
                 m_stats.sndr.lost.count(num);
-                leaveCS(m_StatsLock);
+                leaveStatsCS();
+
+                if (m_PacketFilter && num > 0)
+                    m_PacketFilter.lossReported(losslist_lo, losslist_hi, num);
             }
             // ELSE the loss is a single seq
             else
@@ -8850,7 +9131,7 @@ void srt::CUDT::processCtrlLossReport(const CPacket& ctrlpkt)
                 {
                     if (CSeqNo::seqcmp(losslist[i], m_iSndCurrSeqNo) > 0)
                     {
-                        LOGC(inlog.Warn, log << CONID() << "rcv LOSSREPORT pkt %" << losslist[i]
+                        SLOGC(inlog.Warn, m_SocketID, log << CONID() << "rcv LOSSREPORT pkt %" << losslist[i]
                                 << " with last sent %" << m_iSndCurrSeqNo << " - DISCARDING");
                         // loss_seq must not be greater than the most recent sent seq
                         secure = false;
@@ -8858,13 +9139,16 @@ void srt::CUDT::processCtrlLossReport(const CPacket& ctrlpkt)
                         break;
                     }
 
-                    HLOGC(inlog.Debug,
+                    HSLOGC(inlog.Debug, m_SocketID,
                             log << CONID() << "LOSSREPORT: adding %" << losslist[i] << " (1 packet) to loss list");
                     const int num = m_pSndLossList->insert(losslist[i], losslist[i]);
 
-                    enterCS(m_StatsLock);
+                    enterStatsCS();
                     m_stats.sndr.lost.count(num);
-                    leaveCS(m_StatsLock);
+                    leaveStatsCS();
+
+                    if (m_PacketFilter && num > 0)
+                        m_PacketFilter.lossReported(losslist[i], losslist[i], num);
                 }
                 // ELSE loss_seq %< m_iSndLastAck
                 else
@@ -8873,7 +9157,7 @@ void srt::CUDT::processCtrlLossReport(const CPacket& ctrlpkt)
                     // and the data are <LO, HI>, with no range bit.
                     int32_t seqpair[2] = { losslist[i], losslist[i] };
                     const int32_t no_msgno = 0; // We don't know.
-                    HLOGC(inlog.Debug,
+                    HSLOGC(inlog.Debug, m_SocketID,
                             log << CONID() << "LOSSREPORT: IGNORED with SndLastAck=%" << m_iSndLastAck << ": %" << losslist[i]
                             << " - sending DROPREQ");
                     sendCtrl(UMSG_DROPREQ, &no_msgno, seqpair, sizeof(seqpair));
@@ -8886,21 +9170,22 @@ void srt::CUDT::processCtrlLossReport(const CPacket& ctrlpkt)
 
     if (!secure)
     {
-        LOGC(inlog.Warn,
+        SLOGC(inlog.Warn, m_SocketID,
             log << CONID() << "out-of-band LOSSREPORT received; BUG or ATTACK - last sent %" << m_iSndCurrSeqNo
             << " vs loss %" << wrong_loss);
         // this should not happen: attack or bug
         m_bBroken = true;
         m_iBrokenCounter = 0;
+        uglobal().scheduleGC(m_SocketID);
         return;
     }
 
     // the lost packet (retransmission) should be sent out immediately
     m_pSndQueue->m_pSndUList->update(this, CSndUList::DONT_RESCHEDULE);
 
-    enterCS(m_StatsLock);
+    enterStatsCS();
     m_stats.sndr.recvdNak.count(1);
-    leaveCS(m_StatsLock);
+    leaveStatsCS();
 }
 
 void srt::CUDT::processCtrlHS(const CPacket& ctrlpkt)
@@ -8908,7 +9193,7 @@ void srt::CUDT::processCtrlHS(const CPacket& ctrlpkt)
     CHandShake req;
     req.load_from(ctrlpkt.m_pcData, ctrlpkt.getLength());
 
-    HLOGC(inlog.Debug, log << CONID() << "processCtrl: got HS: " << req.show());
+    HSLOGC(inlog.Debug, m_SocketID, log << CONID() << "processCtrl: got HS: " << req.show());
 
     if ((req.m_iReqType > URQ_INDUCTION_TYPES) // acually it catches URQ_INDUCTION and URQ_ERROR_* symbols...???
         || (m_config.bRendezvous && (req.m_iReqType != URQ_AGREEMENT))) // rnd sends AGREEMENT in rsp to CONCLUSION
@@ -8940,7 +9225,7 @@ void srt::CUDT::processCtrlHS(const CPacket& ctrlpkt)
             const int hs_flags = SrtHSRequest::SRT_HSTYPE_HSFLAGS::unwrap(m_ConnRes.m_iType);
             if (hs_flags != 0) // has SRT extensions
             {
-                HLOGC(inlog.Debug,
+                HSLOGC(inlog.Debug, m_SocketID,
                     log << CONID() << "processCtrl/HS: got HS reqtype=" << RequestTypeStr(req.m_iReqType)
                     << " WITH SRT ext");
                 have_hsreq = interpretSrtHandshake(req, ctrlpkt, (kmdata), (&kmdatasize));
@@ -8960,7 +9245,7 @@ void srt::CUDT::processCtrlHS(const CPacket& ctrlpkt)
                     // Sanity check - according to the rules, there should be no such situation
                     if (m_config.bRendezvous && m_SrtHsSide == HSD_RESPONDER)
                     {
-                        LOGC(inlog.Error,
+                        SLOGC(inlog.Error, m_SocketID,
                             log << CONID() << "processCtrl/HS: IPE???: RESPONDER should receive all its handshakes in "
                             "handshake phase.");
                     }
@@ -8968,14 +9253,14 @@ void srt::CUDT::processCtrlHS(const CPacket& ctrlpkt)
                     // The 'extension' flag will be set from this variable; set it to false
                     // in case when the AGREEMENT response is to be sent.
                     have_hsreq = initdata.m_iReqType == URQ_CONCLUSION;
-                    HLOGC(inlog.Debug,
+                    HSLOGC(inlog.Debug, m_SocketID,
                         log << CONID() << "processCtrl/HS: processing ok, reqtype=" << RequestTypeStr(initdata.m_iReqType)
                         << " kmdatasize=" << kmdatasize);
                 }
             }
             else
             {
-                HLOGC(inlog.Debug, log << CONID() << "processCtrl/HS: got HS reqtype=" << RequestTypeStr(req.m_iReqType));
+                HSLOGC(inlog.Debug, m_SocketID, log << CONID() << "processCtrl/HS: got HS reqtype=" << RequestTypeStr(req.m_iReqType));
             }
         }
         else
@@ -8986,7 +9271,7 @@ void srt::CUDT::processCtrlHS(const CPacket& ctrlpkt)
 
         initdata.m_extension = have_hsreq;
 
-        HLOGC(inlog.Debug,
+        HSLOGC(inlog.Debug, m_SocketID,
             log << CONID() << "processCtrl: responding HS reqtype=" << RequestTypeStr(initdata.m_iReqType)
             << (have_hsreq ? " WITH SRT HS response extensions" : ""));
 
@@ -9012,7 +9297,7 @@ void srt::CUDT::processCtrlHS(const CPacket& ctrlpkt)
     }
     else
     {
-        HLOGC(inlog.Debug, log << CONID() << "processCtrl: ... not INDUCTION, not ERROR, not rendezvous - IGNORED.");
+        HSLOGC(inlog.Debug, m_SocketID, log << CONID() << "processCtrl: ... not INDUCTION, not ERROR, not rendezvous - IGNORED.");
     }
 }
 
@@ -9021,7 +9306,7 @@ void srt::CUDT::processCtrlDropReq(const CPacket& ctrlpkt)
     const int32_t* dropdata = (const int32_t*) ctrlpkt.m_pcData;
 
     {
-        CUniqueSync rcvtscc (m_RecvLock, m_RcvTsbPdCond);
+        ScopedLock recvlock (m_RecvLock);
         // With both TLPktDrop and TsbPd enabled, a message always consists only of one packet.
         // It will be dropped as too late anyway. Not dropping it from the receiver buffer
         // in advance reduces false drops if the packet somehow manages to arrive.
@@ -9034,12 +9319,12 @@ void srt::CUDT::processCtrlDropReq(const CPacket& ctrlpkt)
 
             if (iDropCnt > 0)
             {
-                ScopedLock lg (m_StatsLock);
+                StatsWriteLock lg(*this);
                 const steady_clock::time_point tnow = steady_clock::now();
                 string why;
                 if (frequentLogAllowed(FREQLOGFA_RCV_DROPPED, tnow, (why)))
                 {
-                    LOGC(brlog.Warn, log << CONID() << "RCV-DROPPED " << iDropCnt << " packet(s), seqno range %"
+                    SLOGC(brlog.Warn, m_SocketID, log << CONID() << "RCV-DROPPED " << iDropCnt << " packet(s), seqno range %"
                             << dropdata[0] << "-%" << dropdata[1] << ", msgno " << ctrlpkt.getMsgSeq(using_rexmit_flag)
                             << " (SND DROP REQUEST). " << why);
                 }
@@ -9061,7 +9346,7 @@ void srt::CUDT::processCtrlDropReq(const CPacket& ctrlpkt)
         if (m_bTsbPd)
         {
             HLOGP(inlog.Debug, "DROPREQ: signal TSBPD");
-            rcvtscc.notify_one();
+            notifyTsbPd();
         }
     }
 
@@ -9072,13 +9357,13 @@ void srt::CUDT::processCtrlDropReq(const CPacket& ctrlpkt)
     if ((CSeqNo::seqcmp(dropdata[0], CSeqNo::incseq(m_iRcvCurrSeqNo)) <= 0)
         && (CSeqNo::seqcmp(dropdata[1], m_iRcvCurrSeqNo) > 0))
     {
-        HLOGC(inlog.Debug, log << CONID() << "DROPREQ: dropping %"
+        HSLOGC(inlog.Debug, m_SocketID, log << CONID() << "DROPREQ: dropping %"
             << dropdata[0] << "-" << dropdata[1] << " <-- set as current seq");
         m_iRcvCurrSeqNo = dropdata[1];
     }
     else
     {
-        HLOGC(inlog.Debug, log << CONID() << "DROPREQ: dropping %"
+        HSLOGC(inlog.Debug, m_SocketID, log << CONID() << "DROPREQ: dropping %"
             << dropdata[0] << "-" << dropdata[1] << " current %" << m_iRcvCurrSeqNo);
     }
 }
@@ -9098,7 +9383,7 @@ void srt::CUDT::processCtrlShutdown()
 
 void srt::CUDT::processCtrlUserDefined(const CPacket& ctrlpkt)
 {
-    HLOGC(inlog.Debug, log << CONID() << "CONTROL EXT MSG RECEIVED:"
+    HSLOGC(inlog.Debug, m_SocketID, log << CONID() << "CONTROL EXT MSG RECEIVED:"
         << MessageTypeStr(ctrlpkt.getType(), ctrlpkt.getExtendedType())
         << ", value=" << ctrlpkt.getExtendedType());
 
@@ -9133,7 +9418,7 @@ void srt::CUDT::processCtrl(const CPacket &ctrlpkt)
     const steady_clock::time_point currtime = steady_clock::now();
     m_tsLastRspTime = currtime;
 
-    HLOGC(inlog.Debug,
+    HSLOGC(inlog.Debug, m_SocketID,
           log << CONID() << "incoming UMSG:" << ctrlpkt.getType() << " ("
               << MessageTypeStr(ctrlpkt.getType(), ctrlpkt.getExtendedType()) << ") socket=%" << ctrlpkt.id());
 
@@ -9222,7 +9507,7 @@ void srt::CUDT::updateSrtRcvSettings()
     }
     else
     {
-        HLOGC(cnlog.Debug, log << CONID() << "AFTER HS: Rcv TsbPd mode not set");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "AFTER HS: Rcv TsbPd mode not set");
     }
 }
 
@@ -9244,13 +9529,13 @@ void srt::CUDT::updateSrtSndSettings()
     }
     else
     {
-        HLOGC(cnlog.Debug, log << CONID() << "AFTER HS: Snd TsbPd mode not set");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "AFTER HS: Snd TsbPd mode not set");
     }
 }
 
 void srt::CUDT::updateAfterSrtHandshake(int hsv)
 {
-    HLOGC(cnlog.Debug, log << CONID() << "updateAfterSrtHandshake: HS version " << hsv);
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "updateAfterSrtHandshake: HS version " << hsv);
     // This is blocked from being run in the "app reader" version because here
     // every socket does its TsbPd independently, just the sequence screwup is
     // done and the application reader sorts out packets by sequence numbers,
@@ -9281,7 +9566,7 @@ void srt::CUDT::updateAfterSrtHandshake(int hsv)
     const char* grpspec = "";
 #endif
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "updateAfterSrtHandshake: version=" << m_ConnRes.m_iVersion
               << " side=" << hs_side[m_SrtHsSide] << grpspec);
 #endif
@@ -9307,7 +9592,7 @@ int srt::CUDT::packLostData(CPacket& w_packet)
 {
     // protect m_iSndLastDataAck from updating by ACK processing
     UniqueLock ackguard(m_RecvAckLock);
-    const steady_clock::time_point time_now = steady_clock::now();
+    const steady_clock::time_point time_now = loop_now();
     const steady_clock::time_point time_nak = time_now - microseconds_from(m_iSRTT - 4 * m_iRTTVar);
 
     for (;;)
@@ -9325,7 +9610,7 @@ int srt::CUDT::packLostData(CPacket& w_packet)
             // XXX Likely that this will never be executed because if the upper
             // sequence is not in the sender buffer, then most likely the loss 
             // was completely ignored.
-            LOGC(qrlog.Error,
+            SLOGC(qrlog.Error, m_SocketID,
                  log << CONID() << "IPE/EPE: packLostData: LOST packet negative offset: seqoff(seqno() "
                      << w_packet.seqno() << ", m_iSndLastDataAck " << m_iSndLastDataAck << ")=" << offset
                      << ". Continue, request DROP");
@@ -9338,7 +9623,7 @@ int srt::CUDT::packLostData(CPacket& w_packet)
                 CSeqNo::decseq(m_iSndLastDataAck)
             };
 
-            HLOGC(qrlog.Debug,
+            HSLOGC(qrlog.Debug, m_SocketID,
                   log << CONID() << "PEER reported LOSS not from the sending buffer - requesting DROP: #"
                       << MSGNO_SEQ::unwrap(w_packet.msgflags()) << " SEQ:" << seqpair[0] << " - " << seqpair[1] << "("
                       << (-offset) << " packets)");
@@ -9356,7 +9641,7 @@ int srt::CUDT::packLostData(CPacket& w_packet)
             const steady_clock::time_point tsLastRexmit = m_pSndBuffer->getPacketRexmitTime(offset);
             if (tsLastRexmit >= time_nak)
             {
-                HLOGC(qrlog.Debug, log << CONID() << "REXMIT: ignoring seqno "
+                HSLOGC(qrlog.Debug, m_SocketID, log << CONID() << "REXMIT: ignoring seqno "
                     << w_packet.seqno() << ", last rexmit " << (is_zero(tsLastRexmit) ? "never" : FormatTime(tsLastRexmit))
                     << " RTT=" << m_iSRTT << " RTTVar=" << m_iRTTVar
                     << " now=" << FormatTime(time_now));
@@ -9373,7 +9658,7 @@ int srt::CUDT::packLostData(CPacket& w_packet)
         {
             SRT_ASSERT(CSeqNo::seqoff(buffer_drop.seqno[DropRange::BEGIN], buffer_drop.seqno[DropRange::END]) >= 0);
 
-            HLOGC(qrlog.Debug,
+            HSLOGC(qrlog.Debug, m_SocketID,
                   log << CONID() << "loss-reported packets expired in SndBuf - requesting DROP: #"
                       << buffer_drop.msgno << " %(" << buffer_drop.seqno[DropRange::BEGIN] << " - "
                       << buffer_drop.seqno[DropRange::END] << ")");
@@ -9399,9 +9684,9 @@ int srt::CUDT::packLostData(CPacket& w_packet)
         // Therefore unlocking in order not to block other threads.
         ackguard.unlock();
 
-        enterCS(m_StatsLock);
+        enterStatsCS();
         m_stats.sndr.sentRetrans.count(payload);
-        leaveCS(m_StatsLock);
+        leaveStatsCS();
 
         // Despite the contextual interpretation of packet.m_iMsgNo around
         // CSndBuffer::readData version 2 (version 1 doesn't return -1), in this particular
@@ -9534,7 +9819,7 @@ void srt::CUDT::setDataPacketTS(CPacket& p, const time_point& ts)
     if (ts < tsStart)
     {
         p.set_timestamp(makeTS(steady_clock::now(), tsStart));
-        LOGC(qslog.Warn,
+        SLOGC(qslog.Warn, m_SocketID,
             log << CONID() << "setPacketTS: reference time=" << FormatTime(ts)
             << " is in the past towards start time=" << FormatTime(tsStart)
             << " - setting NOW as reference time for the data packet");
@@ -9602,7 +9887,7 @@ bool srt::CUDT::packData(CPacket& w_packet, steady_clock::time_point& w_nexttime
     bool probe = false;
     bool new_packet_packed = false;
 
-    const steady_clock::time_point enter_time = steady_clock::now();
+    const steady_clock::time_point enter_time = loop_now();
 
     w_nexttime = enter_time;
 
@@ -9634,12 +9919,12 @@ bool srt::CUDT::packData(CPacket& w_packet, steady_clock::time_point& w_nexttime
     else if (m_PacketFilter &&
              m_PacketFilter.packControlPacket(m_iSndCurrSeqNo, m_pCryptoControl->getSndCryptoFlags(), (w_packet)))
     {
-        HLOGC(qslog.Debug, log << CONID() << "filter: filter/CTL packet ready - packing instead of data.");
+        HSLOGC(qslog.Debug, m_SocketID, log << CONID() << "filter: filter/CTL packet ready - packing instead of data.");
         payload        = (int) w_packet.getLength();
         IF_HEAVY_LOGGING(reason = "filter");
 
         // Stats
-        ScopedLock lg(m_StatsLock);
+        StatsWriteLock lg(*this);
         m_stats.sndr.sentFilterExtra.count(1);
     }
     else
@@ -9664,12 +9949,12 @@ bool srt::CUDT::packData(CPacket& w_packet, steady_clock::time_point& w_nexttime
 
     if (new_packet_packed && m_PacketFilter)
     {
-        HLOGC(qslog.Debug, log << CONID() << "filter: Feeding packet for source clip");
+        HSLOGC(qslog.Debug, m_SocketID, log << CONID() << "filter: Feeding packet for source clip");
         m_PacketFilter.feedSource((w_packet));
     }
 
 #if ENABLE_HEAVY_LOGGING // Required because of referring to MessageFlagStr()
-    HLOGC(qslog.Debug,
+    HSLOGC(qslog.Debug, m_SocketID,
           log << CONID() << "packData: " << reason << " packet seq=" << w_packet.seqno() << " (ACK=" << m_iSndLastAck
               << " ACKDATA=" << m_iSndLastDataAck << " MSG/FLAGS: " << w_packet.MessageFlagStr() << ")");
 #endif
@@ -9691,11 +9976,11 @@ bool srt::CUDT::packData(CPacket& w_packet, steady_clock::time_point& w_nexttime
     // different thread than the rest of the signals.
     // m_pSndTimeWindow->onPktSent(w_packet.timestamp());
 
-    enterCS(m_StatsLock);
+    enterStatsCS();
     m_stats.sndr.sent.count(payload);
     if (new_packet_packed)
         m_stats.sndr.sentUnique.count(payload);
-    leaveCS(m_StatsLock);
+    leaveStatsCS();
 
     const duration sendint = m_tdSendInterval;
     if (probe)
@@ -9750,7 +10035,7 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
         const int flightspan = getFlightSpan();
         if (cwnd <= flightspan)
         {
-            HLOGC(qslog.Debug,
+            HSLOGC(qslog.Debug, m_SocketID,
                     log << CONID() << "packUniqueData: CONGESTED: cwnd=min(" << m_iFlowWindowSize << "," << m_iCongestionWindow
                     << ")=" << cwnd << " seqlen=(" << m_iSndLastAck << "-" << m_iSndCurrSeqNo << ")=" << flightspan);
             return false;
@@ -9801,7 +10086,7 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
                 // after connection. No packets in the buffer, no packets are sent,
                 // no ACK to be awaited. We can screw up all the variables that are
                 // initialized from ISN just after connection.
-                LOGC(qslog.Note,
+                SLOGC(qslog.Note, m_SocketID,
                      log << CONID() << "packUniqueData: Fixing EXTRACTION sequence " << current_sequence_number
                          << " from SCHEDULING sequence " << w_packet.seqno() << " for the first packet: DIFF="
                          << packetspan << " STAMP=" << BufferStamp(w_packet.m_pcData, w_packet.getLength()));
@@ -9809,7 +10094,7 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
             else
             {
                 // There will be a serious data discrepancy between the agent and the peer.
-                LOGC(qslog.Error,
+                SLOGC(qslog.Error, m_SocketID,
                      log << CONID() << "IPE: packUniqueData: Fixing EXTRACTION sequence " << current_sequence_number
                          << " from SCHEDULING sequence " << w_packet.seqno() << " in the middle of transition: DIFF="
                          << packetspan << " STAMP=" << BufferStamp(w_packet.m_pcData, w_packet.getLength()));
@@ -9822,7 +10107,7 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
             seqpair[0]             = current_sequence_number;
             seqpair[1]             = CSeqNo::decseq(w_packet.seqno());
             const int32_t no_msgno = 0;
-            LOGC(qslog.Debug,
+            SLOGC(qslog.Debug, m_SocketID,
                  log << CONID() << "packUniqueData: Sending DROPREQ: SEQ: " << seqpair[0] << " - " << seqpair[1] << " ("
                      << packetspan << " packets)");
             sendCtrl(UMSG_DROPREQ, &no_msgno, seqpair, sizeof(seqpair));
@@ -9840,7 +10125,7 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
         }
         else if (packetspan < 0)
         {
-            LOGC(qslog.Error,
+            SLOGC(qslog.Error, m_SocketID,
                  log << CONID() << "IPE: packData: SCHEDULING sequence " << w_packet.seqno()
                      << " is behind of EXTRACTION sequence " << current_sequence_number << ", dropping this packet: DIFF="
                      << packetspan << " STAMP=" << BufferStamp(w_packet.m_pcData, w_packet.getLength()));
@@ -9851,7 +10136,7 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
     else
 #endif
     {
-        HLOGC(qslog.Debug,
+        HSLOGC(qslog.Debug, m_SocketID,
               log << CONID() << "packUniqueData: Applying EXTRACTION sequence " << current_sequence_number
                   << " over SCHEDULING sequence " << w_packet.seqno() << " for socket not in group:"
                   << " DIFF=" << CSeqNo::seqcmp(current_sequence_number, w_packet.seqno())
@@ -9873,7 +10158,7 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
         {
             // Encryption failed
             //>>Add stats for crypto failure
-            LOGC(qslog.Warn, log << CONID() << "ENCRYPT FAILED - packet won't be sent, size=" << pld_size);
+            SLOGC(qslog.Warn, m_SocketID, log << CONID() << "ENCRYPT FAILED - packet won't be sent, size=" << pld_size);
             return false;
         }
 
@@ -9898,6 +10183,7 @@ void srt::CUDT::processClose()
     m_bClosing       = true;
     m_bBroken        = true;
     m_iBrokenCounter = 60;
+    uglobal().scheduleGC(m_SocketID);
 
     HLOGP(smlog.Debug, "processClose: sent message and set flags");
 
@@ -9971,7 +10257,7 @@ bool srt::CUDT::overrideSndSeqNo(int32_t seq)
     const int diff = CSeqNo(seq) - CSeqNo(m_iSndCurrSeqNo);
     if (diff < 0 || diff > CSeqNo::m_iSeqNoTH)
     {
-        LOGC(gslog.Error, log << CONID() << "IPE: Overriding with seq %" << seq << " DISCREPANCY against current %"
+        SLOGC(gslog.Error, m_SocketID, log << CONID() << "IPE: Overriding with seq %" << seq << " DISCREPANCY against current %"
                 << m_iSndCurrSeqNo << " and next sched %" << m_iSndNextSeqNo << " - diff=" << diff);
         return false;
     }
@@ -9988,7 +10274,7 @@ bool srt::CUDT::overrideSndSeqNo(int32_t seq)
     // the latter is ahead with the number of packets already scheduled, but
     // not yet sent.
 
-    HLOGC(gslog.Debug,
+    HSLOGC(gslog.Debug, m_SocketID,
           log << CONID() << "overrideSndSeqNo: sched-seq=" << m_iSndNextSeqNo << " send-seq=" << m_iSndCurrSeqNo
               << " (unchanged)");
     return true;
@@ -9998,10 +10284,44 @@ int srt::CUDT::checkLazySpawnTsbPdThread()
 {
     const bool need_tsbpd = m_bTsbPd || m_bGroupTsbPd;
 
-    if (need_tsbpd && !m_RcvTsbPdThread.joinable())
+    if (need_tsbpd && !m_RcvTsbPdThread.joinable() && m_TsbPdTask.worker < 0)
     {
+#if ENABLE_BONDING
+        // Kept for the time the socket is in the scheduler, like the GroupKeeper
+        // of the TSBPD thread, and released in releaseSynch() after removing it.
+        // Acquired before m_RcvTsbPdStartupLock, which releaseSynch() locks
+        // with m_GlobControlLock already locked.
+        CUDTGroup* tsbpd_group = NULL;
+        if (m_config.iTsbPdWorkers > 0)
+            tsbpd_group = uglobal().acquireSocketsGroup(m_parent);
+#endif
         ScopedLock lock(m_RcvTsbPdStartupLock);
 
+        if (m_config.iTsbPdWorkers > 0 && !m_bClosing)
+        {
+            CTsbPdScheduler& sched = uglobal().m_TsbPdScheduler;
+#if ENABLE_BONDING
+            m_pTsbPdGroup = tsbpd_group;
+#endif
+            if (sched.reserve(m_config.iTsbPdWorkers) > 0 && sched.add(m_TsbPdTask))
+            {
+                HLOGP(qrlog.Debug, "Socket TSBPD done by the shared scheduler");
+                return 0;
+            }
+#if ENABLE_BONDING
+            m_pTsbPdGroup = NULL;
+#endif
+            SLOGC(qrlog.Warn, m_SocketID, log << CONID() << "Can't start TSBPD workers, spawning the TSBPD thread");
+        }
+
+#if ENABLE_BONDING
+        if (tsbpd_group)
+        {
+            ScopedLock cgroup (*tsbpd_group->exp_groupLock());
+            tsbpd_group->apiRelease();
+        }
+#endif
+
         if (m_bClosing) // Check again to protect join() in CUDT::releaseSync()
             return -1;
 
@@ -10031,7 +10351,7 @@ CUDT::time_point srt::CUDT::getPktTsbPdTime(void*, const CPacket& packet)
 SRT_ATR_UNUSED static const char *const s_rexmitstat_str[] = {"ORIGINAL", "REXMITTED", "RXS-UNKNOWN"};
 
 // [[using locked(m_RcvBufferLock)]]
-int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool& w_new_inserted, bool& w_was_sent_in_order, CUDT::loss_seqs_t& w_srt_loss_seqs)
+int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, CUDTGroup* rcvgroup SRT_ATR_UNUSED, bool& w_new_inserted, bool& w_was_sent_in_order, CUDT::loss_seqs_t& w_srt_loss_seqs)
 {
     bool excessive SRT_ATR_UNUSED = true; // stays true unless it was successfully added
 
@@ -10079,15 +10399,12 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
         {
             time_point pts = getPktTsbPdTime(NULL, rpkt);
 
-            enterCS(m_StatsLock);
-            const double bltime = (double) CountIIR<uint64_t>(
-                    uint64_t(m_stats.traceBelatedTime) * 1000,
+            enterStatsCS();
+            m_stats.traceBelatedTimeUs = CountIIR<int64_t>(m_stats.traceBelatedTimeUs,
                     count_microseconds(steady_clock::now() - pts), 0.2);
-
-            m_stats.traceBelatedTime = bltime / 1000.0;
             m_stats.rcvr.recvdBelated.count(rpkt.getLength());
-            leaveCS(m_StatsLock);
-            HLOGC(qrlog.Debug,
+            leaveStatsCS();
+            HSLOGC(qrlog.Debug, m_SocketID,
                     log << CONID() << "RECEIVED: %" << rpkt.seqno() << " bufidx=" << bufidx << " (BELATED/"
                     << s_rexmitstat_str[pktrexmitflag] << ") with ACK %" << m_iRcvLastAck
                     << " FLAGS: " << rpkt.MessageFlagStr());
@@ -10108,7 +10425,7 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
                 // that exceeds the buffer size. Receiving data in this situation
                 // is no longer possible and this is a point of no return.
 
-                LOGC(qrlog.Error, log << CONID() <<
+                SLOGC(qrlog.Error, m_SocketID, log << CONID() <<
                         "SEQUENCE DISCREPANCY. BREAKING CONNECTION."
                         " %" << rpkt.seqno()
                         << " buffer=(%" << bufseq
@@ -10121,7 +10438,7 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
             }
             else
             {
-                LOGC(qrlog.Warn, log << CONID() << "No room to store incoming packet seqno " << rpkt.seqno()
+                SLOGC(qrlog.Warn, m_SocketID, log << CONID() << "No room to store incoming packet seqno " << rpkt.seqno()
                         << ", insert offset " << bufidx << ". "
                         << m_pRcvBuffer->strFullnessState(m_iRcvLastAck, steady_clock::now())
                     );
@@ -10130,7 +10447,23 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
             }
         }
 
-        const int buffer_add_result = m_pRcvBuffer->insert(u);
+        bool group_duplicate = false;
+#if ENABLE_BONDING
+        // Another member link of a redundant group may have already stored this
+        // packet. Then only mark its place as filled, so that this link does
+        // not report it lost, but don't store the payload a second time: the
+        // unit stays free for the next incoming packet.
+        if (rcvgroup && !rcvgroup->rcvIndexPacket(m_SocketID, rpkt.seqno(), m_pRcvBuffer->capacity()))
+        {
+            m_pRcvBuffer->dropMessage(rpkt.seqno(), rpkt.seqno(), SRT_MSGNO_NONE, CRcvBuffer::KEEP_EXISTING);
+            group_duplicate = true;
+            w_new_inserted = true;
+            excessive = false;
+            IF_HEAVY_LOGGING(exc_type = "GROUP-DUPLICATE");
+        }
+#endif
+
+        const int buffer_add_result = group_duplicate ? 0 : m_pRcvBuffer->insert(u);
         if (buffer_add_result < 0)
         {
             // The insert() result is -1 if at the position evaluated from this packet's
@@ -10139,7 +10472,7 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
             IF_HEAVY_LOGGING(exc_type = "UNACKED");
             adding_successful = false;
         }
-        else
+        else if (!group_duplicate)
         {
             w_new_inserted = true;
 
@@ -10173,13 +10506,13 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
                     const int iDropCnt = m_pRcvBuffer->dropMessage(u->m_Packet.getSeqNo(), u->m_Packet.getSeqNo(), SRT_MSGNO_NONE, CRcvBuffer::DROP_EXISTING);
 
                     const steady_clock::time_point tnow = steady_clock::now();
-                    ScopedLock lg(m_StatsLock);
+                    StatsWriteLock lg(*this);
                     m_stats.rcvr.dropped.count(stats::BytesPackets(iDropCnt * rpkt.getLength(), iDropCnt));
                     m_stats.rcvr.undecrypted.count(stats::BytesPackets(rpkt.getLength(), 1));
                     string why;
                     if (frequentLogAllowed(FREQLOGFA_ENCRYPTION_FAILURE, tnow, (why)))
                     {
-                        LOGC(qrlog.Warn, log << CONID() << "Decryption failed (seqno %" << u->m_Packet.getSeqNo() << "), dropped "
+                        SLOGC(qrlog.Warn, m_SocketID, log << CONID() << "Decryption failed (seqno %" << u->m_Packet.getSeqNo() << "), dropped "
                             << iDropCnt << ". pktRcvUndecryptTotal=" << m_stats.rcvr.undecrypted.total.count() << "." << why);
                     }
 #if SRT_ENABLE_FREQUENT_LOG_TRACE
@@ -10197,21 +10530,27 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
                 const int iDropCnt = m_pRcvBuffer->dropMessage(u->m_Packet.getSeqNo(), u->m_Packet.getSeqNo(), SRT_MSGNO_NONE, CRcvBuffer::DROP_EXISTING);
 
                 const steady_clock::time_point tnow = steady_clock::now();
-                ScopedLock lg(m_StatsLock);
+                StatsWriteLock lg(*this);
                 m_stats.rcvr.dropped.count(stats::BytesPackets(iDropCnt* rpkt.getLength(), iDropCnt));
                 m_stats.rcvr.undecrypted.count(stats::BytesPackets(rpkt.getLength(), 1));
                 string why;
                 if (frequentLogAllowed(FREQLOGFA_ENCRYPTION_FAILURE, tnow, (why)))
                 {
-                    LOGC(qrlog.Warn, log << CONID() << "Packet not encrypted (seqno %" << u->m_Packet.getSeqNo() << "), dropped "
+                    SLOGC(qrlog.Warn, m_SocketID, log << CONID() << "Packet not encrypted (seqno %" << u->m_Packet.getSeqNo() << "), dropped "
                         << iDropCnt << ". pktRcvUndecryptTotal=" << m_stats.rcvr.undecrypted.total.count() << ".");
                 }
             }
+
+#if ENABLE_BONDING
+            // The copy that may come in over another member must be stored then.
+            if (!adding_successful && rcvgroup)
+                rcvgroup->rcvIndexWithdraw(m_SocketID, rpkt.seqno());
+#endif
         }
 
-        if (adding_successful)
+        if (adding_successful && !group_duplicate)
         {
-            ScopedLock statslock(m_StatsLock);
+            StatsWriteLock statslock(*this);
             m_stats.rcvr.recvdUnique.count(u->m_Packet.getLength());
         }
 
@@ -10240,7 +10579,7 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
         // Empty buffer info in case of groupwise receiver.
         // There's no way to obtain this information here.
 
-        LOGC(qrlog.Debug, log << CONID() << "RECEIVED: %" << rpkt.seqno()
+        SLOGC(qrlog.Debug, m_SocketID, log << CONID() << "RECEIVED: %" << rpkt.seqno()
                 << bufinfo.str()
                 << " RSL=" << expectspec.str()
                 << " SN=" << s_rexmitstat_str[pktrexmitflag]
@@ -10252,7 +10591,7 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
         // Otherwise it's an error.
         if (adding_successful)
         {
-            HLOGC(qrlog.Debug,
+            HSLOGC(qrlog.Debug, m_SocketID,
                       log << CONID()
                           << "CONTIGUITY CHECK: sequence distance: " << CSeqNo::seqoff(m_iRcvCurrSeqNo, rpkt.seqno()));
 
@@ -10308,9 +10647,9 @@ int srt::CUDT::processData(CUnit* in_unit)
     if (retransmitted)
     {
         // This packet was retransmitted
-        enterCS(m_StatsLock);
+        enterStatsCS();
         m_stats.rcvr.recvdRetrans.count(packet.getLength());
-        leaveCS(m_StatsLock);
+        leaveStatsCS();
 
 #if ENABLE_HEAVY_LOGGING
         // Check if packet was retransmitted on request or on ack timeout
@@ -10333,7 +10672,7 @@ int srt::CUDT::processData(CUnit* in_unit)
        steady_clock::time_point pts = m_pRcvBuffer->getPktTsbPdTime(packet.getMsgTimeStamp());
        steady_clock::time_point ets = pts - tsbpddelay;
 
-       HLOGC(qrlog.Debug, log << CONID() << "processData: RECEIVED DATA: size=" << packet.getLength()
+       HSLOGC(qrlog.Debug, m_SocketID, log << CONID() << "processData: RECEIVED DATA: size=" << packet.getLength()
            << " seq=" << packet.getSeqNo()
            // XXX FIX IT. OTS should represent the original sending time, but it's relative.
            //<< " OTS=" << FormatTime(packet.getMsgTimeStamp())
@@ -10368,9 +10707,9 @@ int srt::CUDT::processData(CUnit* in_unit)
     // otherwise measurement must be rejected.
     m_RcvTimeWindow.probeArrival(packet, unordered || retransmitted);
 
-    enterCS(m_StatsLock);
+    enterStatsCS();
     m_stats.rcvr.recvd.count(pktsz);
-    leaveCS(m_StatsLock);
+    leaveStatsCS();
 
     loss_seqs_t                             filter_loss_seqs;
     loss_seqs_t                             srt_loss_seqs;
@@ -10397,11 +10736,11 @@ int srt::CUDT::processData(CUnit* in_unit)
         {
             const int loss = diff - 1; // loss is all that is above diff == 1
 
-            ScopedLock lg(m_StatsLock);
+            StatsWriteLock lg(*this);
             const uint64_t avgpayloadsz = m_pRcvBuffer->getRcvAvgPayloadSize();
             m_stats.rcvr.lost.count(stats::BytesPackets(loss * avgpayloadsz, (uint32_t) loss));
 
-            HLOGC(qrlog.Debug,
+            HSLOGC(qrlog.Debug, m_SocketID,
                   log << CONID() << "LOSS STATS: n=" << loss << " SEQ: [" << CSeqNo::incseq(m_iRcvCurrPhySeqNo) << " "
                       << CSeqNo::decseq(packet.seqno()) << "]");
         }
@@ -10423,6 +10762,7 @@ int srt::CUDT::processData(CUnit* in_unit)
     // accepted or rejected because if it was belated it may result in a
     // "runaway train" problem as the IDLE links are being updated the base
     // reception sequence pointer stating that this link is not receiving.
+    CUDTUnited::GroupKeeper rcvgroup_keeper;
     if (m_parent->m_GroupOf)
     {
         ScopedLock protect_group_existence (uglobal().m_GlobControlLock);
@@ -10436,19 +10776,27 @@ int srt::CUDT::processData(CUnit* in_unit)
         {
             if (gi->rcvstate < SRT_GST_RUNNING) // PENDING or IDLE, tho PENDING is unlikely
             {
-                HLOGC(qrlog.Debug,
+                HSLOGC(qrlog.Debug, m_SocketID,
                       log << CONID() << "processData: IN-GROUP rcv state transition " << srt_log_grp_state[gi->rcvstate]
                           << " -> RUNNING.");
                 gi->rcvstate = SRT_GST_RUNNING;
             }
             else
             {
-                HLOGC(qrlog.Debug,
+                HSLOGC(qrlog.Debug, m_SocketID,
                       log << CONID() << "processData: IN-GROUP rcv state transition NOT DONE - state:"
                           << srt_log_grp_state[gi->rcvstate]);
             }
+
+            // Keep the group for checking the incoming packets against
+            // its receiver index, till the end of this call.
+            if (m_parent->m_GroupOf->rcvDeduplicates())
+                rcvgroup_keeper.acquire(m_parent->m_GroupOf);
         }
     }
+    CUDTGroup* const rcvgroup = rcvgroup_keeper.group;
+#else
+    CUDTGroup* const rcvgroup = NULL;
 #endif
 
     bool new_inserted = false;
@@ -10457,7 +10805,7 @@ int srt::CUDT::processData(CUnit* in_unit)
     {
         // Stuff this data into the filter
         m_PacketFilter.receive(in_unit, (incoming), (filter_loss_seqs));
-        HLOGC(qrlog.Debug,
+        HSLOGC(qrlog.Debug, m_SocketID,
               log << CONID() << "(FILTER) fed data, received " << incoming.size() << " pkts, " << Printable(filter_loss_seqs)
                   << " loss to report, "
                   << (m_PktFilterRexmitLevel == SRT_ARQ_ALWAYS ? "FIND & REPORT LOSSES YOURSELF"
@@ -10477,7 +10825,7 @@ int srt::CUDT::processData(CUnit* in_unit)
         // Needed for possibly check for needsQuickACK.
         const bool incoming_belated = (CSeqNo::seqcmp(in_unit->m_Packet.seqno(), m_pRcvBuffer->getStartSeqNo()) < 0);
 
-        const int res = handleSocketPacketReception(incoming,
+        const int res = handleSocketPacketReception(incoming, rcvgroup,
                 (new_inserted),
                 (was_sent_in_order),
                 (srt_loss_seqs));
@@ -10503,7 +10851,7 @@ int srt::CUDT::processData(CUnit* in_unit)
         {
             ScopedLock lock(m_RcvLossLock);
 
-            HLOGC(qrlog.Debug,
+            HSLOGC(qrlog.Debug, m_SocketID,
                   log << CONID() << "processData: RECORDING LOSS: " << Printable(srt_loss_seqs)
                       << " tolerance=" << initial_loss_ttl);
 
@@ -10565,18 +10913,19 @@ int srt::CUDT::processData(CUnit* in_unit)
         const bool report_recorded_loss = !m_PacketFilter || m_PktFilterRexmitLevel == SRT_ARQ_ALWAYS;
         if (!initial_loss_ttl && report_recorded_loss)
         {
-            HLOGC(qrlog.Debug, log << CONID() << "WILL REPORT LOSSES (SRT): " << Printable(srt_loss_seqs));
+            HSLOGC(qrlog.Debug, m_SocketID, log << CONID() << "WILL REPORT LOSSES (SRT): " << Printable(srt_loss_seqs));
             sendLossReport(srt_loss_seqs);
         }
 
         if (m_bTsbPd)
         {
-            HLOGC(qrlog.Debug, log << CONID() << "loss: signaling TSBPD cond");
-            CSync::lock_notify_one(m_RcvTsbPdCond, m_RecvLock);
+            HSLOGC(qrlog.Debug, m_SocketID, log << CONID() << "loss: signaling TSBPD cond");
+            ScopedLock recvlock (m_RecvLock);
+            notifyTsbPd();
         }
         else
         {
-            HLOGC(qrlog.Debug, log << CONID() << "loss: socket is not TSBPD, not signaling");
+            HSLOGC(qrlog.Debug, m_SocketID, log << CONID() << "loss: socket is not TSBPD, not signaling");
         }
     }
 
@@ -10587,13 +10936,14 @@ int srt::CUDT::processData(CUnit* in_unit)
     // With NEVER, nothing is to be reported.
     if (!filter_loss_seqs.empty())
     {
-        HLOGC(qrlog.Debug, log << CONID() << "WILL REPORT LOSSES (filter): " << Printable(filter_loss_seqs));
+        HSLOGC(qrlog.Debug, m_SocketID, log << CONID() << "WILL REPORT LOSSES (filter): " << Printable(filter_loss_seqs));
         sendLossReport(filter_loss_seqs);
 
         if (m_bTsbPd)
         {
-            HLOGC(qrlog.Debug, log << CONID() << "loss: signaling TSBPD cond");
-            CSync::lock_notify_one(m_RcvTsbPdCond, m_RecvLock);
+            HSLOGC(qrlog.Debug, m_SocketID, log << CONID() << "loss: signaling TSBPD cond");
+            ScopedLock recvlock (m_RecvLock);
+            notifyTsbPd();
         }
     }
 
@@ -10677,9 +11027,9 @@ int srt::CUDT::processData(CUnit* in_unit)
             if (m_iReorderTolerance > 0)
             {
                 m_iReorderTolerance--;
-                enterCS(m_StatsLock);
-                m_stats.traceReorderDistance--;
-                leaveCS(m_StatsLock);
+                enterStatsCS();
+                m_stats.traceReorderDistance = m_stats.traceReorderDistance - 1;
+                leaveStatsCS();
                 HLOGC(qrlog.Debug, log << "ORDERED DELIVERY of 50 packets in a row - decreasing tolerance to "
                         << m_iReorderTolerance);
             }
@@ -10781,9 +11131,9 @@ void srt::CUDT::unlose(const CPacket &packet)
             HLOGC(qrlog.Debug, log << "received out-of-band packet %" << sequence);
 
             const int seqdiff = abs(CSeqNo::seqcmp(m_iRcvCurrSeqNo, packet.seqno()));
-            enterCS(m_StatsLock);
-            m_stats.traceReorderDistance = max(seqdiff, m_stats.traceReorderDistance);
-            leaveCS(m_StatsLock);
+            enterStatsCS();
+            m_stats.traceReorderDistance = max(seqdiff, m_stats.traceReorderDistance.load());
+            leaveStatsCS();
             if (seqdiff > m_iReorderTolerance)
             {
                 const int new_tolerance = min(seqdiff, m_config.iMaxReorderTolerance);
@@ -10796,7 +11146,7 @@ void srt::CUDT::unlose(const CPacket &packet)
         }
         else
         {
-            HLOGC(qrlog.Debug, log << CONID() << "received reXmitted packet seq=" << sequence);
+            HSLOGC(qrlog.Debug, m_SocketID, log << CONID() << "received reXmitted packet seq=" << sequence);
         }
     }
     else
@@ -10840,9 +11190,9 @@ void srt::CUDT::unlose(const CPacket &packet)
                 if (m_iReorderTolerance > 0)
                 {
                     m_iReorderTolerance--;
-                    enterCS(m_StatsLock);
-                    m_stats.traceReorderDistance--;
-                    leaveCS(m_StatsLock);
+                    enterStatsCS();
+                    m_stats.traceReorderDistance = m_stats.traceReorderDistance - 1;
+                    leaveStatsCS();
                     HLOGC(qrlog.Debug, log << "... reached " << m_iConsecEarlyDelivery
                             << " times - decreasing tolerance to " << m_iReorderTolerance);
                 }
@@ -10892,7 +11242,7 @@ void srt::CUDT::dropFromLossLists(int32_t from, int32_t to)
 
     const char* const reqtype = (from == SRT_SEQNO_NONE) ? "TLPKTDROP" : "DROPREQ";
 
-    HLOGC(qrlog.Debug, log << CONID() << "DROP PER " << reqtype << " %" << begin
+    HSLOGC(qrlog.Debug, m_SocketID, log << CONID() << "DROP PER " << reqtype << " %" << begin
             << "[" << beginwhere[1*autodetected] << "]-" << to << " ("
             << range.str() << " packets)");
 #endif
@@ -10992,17 +11342,68 @@ int32_t srt::CUDT::bake(const sockaddr_any& addr, int32_t current_cookie, int co
 // and this will be directly passed to the caller.
 
 // [[using locked(m_pRcvQueue->m_LSLock)]];
+bool srt::CUDT::prepareConclusionKek(const CHandShake& hs, const CPacket& hspkt)
+{
+#ifdef SRT_ENABLE_ENCRYPTION
+    if (m_config.CryptoSecret.len <= 0 || hs.m_iVersion < HS_VERSION_SRT1
+            || hspkt.getLength() <= CHandShake::m_iContentSize
+            || !IsSet(SrtHSRequest::SRT_HSTYPE_HSFLAGS::unwrap(hs.m_iType), CHandShake::HS_EXT_KMREQ))
+        return true;
+
+    uint32_t* begin  = reinterpret_cast<uint32_t*>(hspkt.m_pcData + CHandShake::m_iContentSize);
+    size_t    length = (hspkt.getLength() - CHandShake::m_iContentSize) / sizeof(uint32_t);
+
+    for (;;)
+    {
+        uint32_t* next     = NULL;
+        size_t    blocklen = 0;
+        const int cmd      = FindExtensionBlock(begin, length, (blocklen), (next));
+
+        if (cmd == SRT_CMD_KMREQ)
+        {
+            // All 32-bit fields were swapped on reception, see processSrtMsg_KMREQ().
+            uint32_t kmwords[SRTDATA_MAXSIZE];
+            const size_t nwords = std::min(blocklen, SRTDATA_MAXSIZE);
+            HtoNLA((kmwords), begin + 1, nwords);
+            const unsigned char* kmdata  = reinterpret_cast<const unsigned char*>(kmwords);
+            const size_t         bytelen = nwords * sizeof(uint32_t);
+
+            if (bytelen <= HCRYPT_MSG_KM_OFS_SALT)
+                return true;
+
+            const size_t salt_len = hcryptMsg_KM_GetSaltLen(kmdata);
+            const size_t sek_len  = hcryptMsg_KM_GetSekLen(kmdata);
+            if (salt_len == 0 || sek_len == 0 || HCRYPT_MSG_KM_OFS_SALT + salt_len > bytelen)
+                return true; // Malformed; let it be rejected as usual.
+
+            // KEK = PBKDF2(Pwd, LSB(64, Salt), Iter, Klen), see hcryptCtx_GenSecret().
+            const size_t pbkdf_salt_len = std::min(salt_len, size_t(HAICRYPT_PBKDF2_SALT_LEN));
+            const unsigned char* salt   = kmdata + HCRYPT_MSG_KM_OFS_SALT + salt_len - pbkdf_salt_len;
+            return uglobal().m_KekCache.prepare(reinterpret_cast<const char*>(m_config.CryptoSecret.str),
+                    m_config.CryptoSecret.len, salt, pbkdf_salt_len, sek_len);
+        }
+
+        if (cmd == SRT_CMD_NONE || !NextExtensionBlock((begin), next, (length)))
+            return true;
+    }
+#else
+    (void)hs;
+    (void)hspkt;
+    return true;
+#endif
+}
+
 int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
 {
     // XXX ASSUMPTIONS:
     // [[using assert(packet.id() == 0)]]
 
-    HLOGC(cnlog.Debug, log << CONID() << "processConnectRequest: received a connection request");
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectRequest: received a connection request");
 
     if (m_bClosing)
     {
         m_RejectReason = SRT_REJ_CLOSE;
-        HLOGC(cnlog.Debug, log << CONID() << "processConnectRequest: ... NOT. Rejecting because closing.");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectRequest: ... NOT. Rejecting because closing.");
         return m_RejectReason;
     }
 
@@ -11014,7 +11415,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
     if (m_bBroken)
     {
         m_RejectReason = SRT_REJ_CLOSE;
-        HLOGC(cnlog.Debug, log << CONID() << "processConnectRequest: ... NOT. Rejecting because broken.");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectRequest: ... NOT. Rejecting because broken.");
         return m_RejectReason;
     }
     // When CHandShake::m_iContentSize is used in log, the file fails to link!
@@ -11029,7 +11430,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
     if (packet.getLength() < exp_len)
     {
         m_RejectReason = SRT_REJ_ROGUE;
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "processConnectRequest: ... NOT. Wrong size: " << packet.getLength()
                   << " (expected: " << exp_len << ")");
         return m_RejectReason;
@@ -11041,7 +11442,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
     if (!packet.isControl(UMSG_HANDSHAKE))
     {
         m_RejectReason = SRT_REJ_ROGUE;
-        LOGC(cnlog.Error,
+        SLOGC(cnlog.Error, m_SocketID,
              log << CONID() << "processConnectRequest: the packet received as handshake is not a handshake message");
         return m_RejectReason;
     }
@@ -11060,7 +11461,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
 
     int32_t cookie_val = bake(addr);
 
-    HLOGC(cnlog.Debug, log << CONID() << "processConnectRequest: new cookie: " << hex << cookie_val);
+    HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectRequest: new cookie: " << hex << cookie_val);
 
     // Remember the incoming destination address here and use it as a source
     // address when responding. It's not possible to record this address yet
@@ -11074,7 +11475,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
     // RESPONSE:INDUCTION.
     if (hs.m_iReqType == URQ_INDUCTION)
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "processConnectRequest: received type=induction, sending back with cookie+socket");
 
         // XXX That looks weird - the calculated md5 sum out of the given host/port/timestamp
@@ -11103,7 +11504,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
         // In this field we also advertise the PBKEYLEN value. When 0, it's considered not advertised.
         hs.m_iType = SrtHSRequest::wrapFlags(true /*put SRT_MAGIC_CODE in HSFLAGS*/, m_config.iSndCryptoKeyLen);
         bool whether SRT_ATR_UNUSED = m_config.iSndCryptoKeyLen != 0;
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "processConnectRequest: " << (whether ? "" : "NOT ")
                   << " Advertising PBKEYLEN - value = " << m_config.iSndCryptoKeyLen);
 
@@ -11112,7 +11513,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
         setPacketTS(packet, steady_clock::now());
 
         // Display the HS before sending it to peer
-        HLOGC(cnlog.Debug, log << CONID() << "processConnectRequest: SENDING HS (i): " << hs.show());
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectRequest: SENDING HS (i): " << hs.show());
 
         m_pSndQueue->sendto(addr, packet, use_source_addr);
         return SRT_REJ_UNKNOWN; // EXCEPTION: this is a "no-error" code.
@@ -11125,12 +11526,12 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
 
     if (!hs.valid())
     {
-        LOGC(cnlog.Error, log << CONID() << "processConnectRequest: ROGUE HS RECEIVED. Rejecting");
+        SLOGC(cnlog.Error, m_SocketID, log << CONID() << "processConnectRequest: ROGUE HS RECEIVED. Rejecting");
         m_RejectReason = SRT_REJ_ROGUE;
         return SRT_REJ_ROGUE;
     }
 
-    HLOGC(cnlog.Debug,
+    HSLOGC(cnlog.Debug, m_SocketID,
           log << CONID() << "processConnectRequest: received type=" << RequestTypeStr(hs.m_iReqType)
               << " - checking cookie...");
     if (hs.m_iCookie != cookie_val)
@@ -11140,15 +11541,15 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
         if (hs.m_iCookie != cookie_val)
         {
             m_RejectReason = SRT_REJ_RDVCOOKIE;
-            HLOGC(cnlog.Debug, log << CONID() << "processConnectRequest: ...wrong cookie " << hex << cookie_val << ". Ignoring.");
+            HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectRequest: ...wrong cookie " << hex << cookie_val << ". Ignoring.");
             return m_RejectReason;
         }
 
-        HLOGC(cnlog.Debug, log << CONID() << "processConnectRequest: ... correct (FIXED) cookie. Proceeding.");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectRequest: ... correct (FIXED) cookie. Proceeding.");
     }
     else
     {
-        HLOGC(cnlog.Debug, log << CONID() << "processConnectRequest: ... correct (ORIGINAL) cookie. Proceeding.");
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectRequest: ... correct (ORIGINAL) cookie. Proceeding.");
     }
 
     SRTSOCKET id = hs.m_iID;
@@ -11192,7 +11593,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
 
     if (!accepted_hs)
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "processConnectRequest: version/type mismatch. Sending REJECT code:" << m_RejectReason
                   << " MSG: " << srt_rejectreason_str(m_RejectReason));
         // mismatch, reject the request
@@ -11201,9 +11602,17 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
         hs.store_to((packet.m_pcData), (size));
         packet.set_id(id);
         setPacketTS((packet), steady_clock::now());
-        HLOGC(cnlog.Debug, log << CONID() << "processConnectRequest: SENDING HS (e): " << hs.show());
+        HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectRequest: SENDING HS (e): " << hs.show());
         m_pSndQueue->sendto(addr, packet, use_source_addr);
     }
+    else if (!prepareConclusionKek(hs, packet))
+    {
+        // The caller repeats the conclusion handshake until it gets
+        // the response, and by then the KEK will be in the cache.
+        HSLOGC(cnlog.Debug, m_SocketID,
+              log << CONID() << "processConnectRequest: KEK derivation deferred, ignoring the request for now");
+        return SRT_REJ_RESOURCE;
+    }
     else
     {
         // IMPORTANT!!!
@@ -11240,7 +11649,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
             // by the handshake response. It wouldn't be good to call interpretSrtHandshake
             // here because the data from the handshake have been already interpreted
             // and recorded. We just need to craft a response.
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "processConnectRequest: sending REPEATED handshake response req="
                       << RequestTypeStr(hs.m_iReqType));
 
@@ -11270,7 +11679,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
                         kmdata, kmdatasize,
                         (packet), (hs)))
             {
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                       log << CONID() << "processConnectRequest: rejecting due to problems in createSrtHandshake.");
                 result        = -1; // enforce fallthrough for the below condition!
                 hs.m_iReqType = URQFailure(m_RejectReason == SRT_REJ_UNKNOWN ? int(SRT_REJ_IPE) : m_RejectReason.load());
@@ -11278,7 +11687,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
             else
             {
                 // Send the crafted handshake
-                HLOGC(cnlog.Debug, log << CONID() << "processConnectRequest: SENDING (repeated) HS (a): " << hs.show());
+                HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectRequest: SENDING (repeated) HS (a): " << hs.show());
                 acpu->addressAndSend((packet));
             }
         }
@@ -11288,7 +11697,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
             // BUG! There is no need to update write-readiness on the listener socket once new connection is accepted.
             // Only read-readiness has to be updated, but it is done so in the newConnection(..) function.
             // See PR #1831 and issue #1667.
-            HLOGC(cnlog.Debug,
+            HSLOGC(cnlog.Debug, m_SocketID,
                   log << CONID() << "processConnectRequest: accepted connection, updating epoll to write-ready");
 
             // New connection has been accepted or an existing one has been found. Update epoll write-readiness.
@@ -11306,7 +11715,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
             // HSv5: Send a handshake with an error code (hs.m_iReqType set earlier) to the peer.
             if (hs.m_iVersion < HS_VERSION_SRT1)
             {
-                HLOGC(cnlog.Debug, log << CONID() << "processConnectRequest: HSv4 caller, sending SHUTDOWN after rejection with "
+                HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectRequest: HSv4 caller, sending SHUTDOWN after rejection with "
                         << RequestTypeStr(hs.m_iReqType));
                 CPacket rsp;
                 setPacketTS((rsp), steady_clock::now());
@@ -11316,7 +11725,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
             }
             else
             {
-                HLOGC(cnlog.Debug,
+                HSLOGC(cnlog.Debug, m_SocketID,
                         log << CONID() << "processConnectRequest: sending ABNORMAL handshake info req="
                         << RequestTypeStr(hs.m_iReqType));
                 size_t size = CHandShake::m_iContentSize;
@@ -11324,12 +11733,12 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
                 packet.setLength(size);
                 packet.set_id(id);
                 setPacketTS(packet, steady_clock::now());
-                HLOGC(cnlog.Debug, log << CONID() << "processConnectRequest: SENDING HS (a): " << hs.show());
+                HSLOGC(cnlog.Debug, m_SocketID, log << CONID() << "processConnectRequest: SENDING HS (a): " << hs.show());
                 m_pSndQueue->sendto(addr, packet, use_source_addr);
             }
         }
     }
-    LOGC(cnlog.Debug, log << CONID() << "listen ret: " << hs.m_iReqType << " - " << RequestTypeStr(hs.m_iReqType));
+    SLOGC(cnlog.Debug, m_SocketID, log << CONID() << "listen ret: " << hs.m_iReqType << " - " << RequestTypeStr(hs.m_iReqType));
 
     return RejectReasonForURQ(hs.m_iReqType);
 }
@@ -11426,6 +11835,20 @@ int srt::CUDT::checkNAKTimer(const steady_clock::time_point& currtime)
     return debug_decision;
 }
 
+srt::sync::steady_clock::time_point srt::CUDT::nextExpTime()
+{
+    // In UDT the m_bUserDefinedRTO and m_iRTO were in CCC class.
+    // There's nothing in the original code that alters these values.
+    if (m_CongCtl->RTO())
+        return m_tsLastRspTime.load() + microseconds_from(m_CongCtl->RTO());
+
+    steady_clock::duration exp_timeout =
+        microseconds_from(m_iEXPCount * (m_iSRTT + 4 * m_iRTTVar) + COMM_SYN_INTERVAL_US);
+    if (exp_timeout < (m_iEXPCount * m_tdMinExpInterval))
+        exp_timeout = m_iEXPCount * m_tdMinExpInterval;
+    return m_tsLastRspTime.load() + exp_timeout;
+}
+
 bool srt::CUDT::checkExpTimer(const steady_clock::time_point& currtime, int check_reason SRT_ATR_UNUSED)
 {
     // VERY HEAVY LOGGING
@@ -11449,26 +11872,10 @@ bool srt::CUDT::checkExpTimer(const steady_clock::time_point& currtime, int chec
         }
         decision = decd.str();
     }
-    HLOGC(xtlog.Debug, log << CONID() << "checkTimer: ACTIVITIES PERFORMED: " << decision);
+    HSLOGC(xtlog.Debug, m_SocketID, log << CONID() << "checkTimer: ACTIVITIES PERFORMED: " << decision);
 #endif
 
-    // In UDT the m_bUserDefinedRTO and m_iRTO were in CCC class.
-    // There's nothing in the original code that alters these values.
-
-    steady_clock::time_point next_exp_time;
-    if (m_CongCtl->RTO())
-    {
-        next_exp_time = m_tsLastRspTime.load() + microseconds_from(m_CongCtl->RTO());
-    }
-    else
-    {
-        steady_clock::duration exp_timeout =
-            microseconds_from(m_iEXPCount * (m_iSRTT + 4 * m_iRTTVar) + COMM_SYN_INTERVAL_US);
-        if (exp_timeout < (m_iEXPCount * m_tdMinExpInterval))
-            exp_timeout = m_iEXPCount * m_tdMinExpInterval;
-        next_exp_time = m_tsLastRspTime.load() + exp_timeout;
-    }
-
+    const steady_clock::time_point next_exp_time = nextExpTime();
     if (currtime <= next_exp_time && !m_bBreakAsUnstable)
         return false;
 
@@ -11485,7 +11892,7 @@ bool srt::CUDT::checkExpTimer(const steady_clock::time_point& currtime, int chec
         // UDT does not signal any information about this instead of to stop quietly.
         // Application will detect this when it calls any UDT methods next time.
         //
-        HLOGC(xtlog.Debug,
+        HSLOGC(xtlog.Debug, m_SocketID,
               log << CONID() << "CONNECTION EXPIRED after " << FormatDuration<DUNIT_MS>(currtime - last_rsp_time) << " - BREAKING");
         m_bClosing       = true;
         m_bBroken        = true;
@@ -11500,7 +11907,7 @@ bool srt::CUDT::checkExpTimer(const steady_clock::time_point& currtime, int chec
         return true;
     }
 
-    HLOGC(xtlog.Debug,
+    HSLOGC(xtlog.Debug, m_SocketID,
           log << CONID() << "EXP TIMER: count=" << m_iEXPCount << "/" << (+COMM_RESPONSE_MAX_EXP)
               << " elapsed=" << (count_microseconds(currtime - last_rsp_time)) << "/" << (+PEER_IDLE_TMO_US) << "us");
 
@@ -11580,11 +11987,11 @@ void srt::CUDT::checkRexmitTimer(const steady_clock::time_point& currtime)
         const int     num = m_pSndLossList->insert(m_iSndLastAck, csn);
         if (num > 0)
         {
-            enterCS(m_StatsLock);
+            enterStatsCS();
             m_stats.sndr.lost.count(num);
-            leaveCS(m_StatsLock);
+            leaveStatsCS();
 
-            HLOGC(xtlog.Debug,
+            HSLOGC(xtlog.Debug, m_SocketID,
                   log << CONID() << "ENFORCED " << (is_laterexmit ? "LATEREXMIT" : "FASTREXMIT")
                       << " by ACK-TMOUT (scheduling): " << CSeqNo::incseq(m_iSndLastAck) << "-" << csn << " ("
                       << CSeqNo::seqoff(m_iSndLastAck, csn) << " packets)");
@@ -11605,11 +12012,12 @@ void srt::CUDT::checkTimers()
     // update CC parameters
     updateCC(TEV_CHECKTIMER, EventVariant(TEV_CHT_INIT));
 
-    const steady_clock::time_point currtime = steady_clock::now();
+    // Read once for all sockets checked in one iteration of the receiver queue.
+    const steady_clock::time_point currtime = loop_now();
 
     // This is a very heavy log, unblock only for temporary debugging!
 #if 0
-    HLOGC(xtlog.Debug, log << CONID() << "checkTimers: nextacktime=" << FormatTime(m_tsNextACKTime)
+    HSLOGC(xtlog.Debug, m_SocketID, log << CONID() << "checkTimers: nextacktime=" << FormatTime(m_tsNextACKTime)
         << " AckInterval=" << m_iACKInterval
         << " pkt-count=" << m_iPktCount << " liteack-count=" << m_iLightACKCount);
 #endif
@@ -11648,9 +12056,57 @@ void srt::CUDT::checkTimers()
     }
 }
 
+srt::sync::steady_clock::time_point srt::CUDT::nextTimersCheckTime(const steady_clock::time_point& lastcheck)
+{
+    // The periodic check, as long as any of the timers may have something to do.
+    const steady_clock::time_point next_syn = lastcheck + microseconds_from(COMM_SYN_INTERVAL_US);
+
+    // Data received since the last full ACK or the last ACK not confirmed yet by ACKACK:
+    // the ACK timer will send an ACK.
+    if (m_iPktCount > 0 || m_iRcvLastAckAck != m_iRcvLastAck || m_bBufferWasFull || m_bBreakAsUnstable)
+        return next_syn;
+
+    // Data to send or retransmit: the retransmission timer and the congestion
+    // control (input rate sampling) are active.
+    if (m_pSndBuffer->getCurrBufSize() > 0 || m_pSndLossList->getLossLength() > 0)
+        return next_syn;
+
+    // Handshake or KM requests waiting for a response (see checkSndTimers()).
+    if ((m_SrtHsSide == HSD_INITIATOR && m_iSndHsRetryCnt > 0)
+            || (m_pCryptoControl && m_pCryptoControl->isKmRetryPending()))
+        return next_syn;
+
+#if ENABLE_BONDING
+    // The receiver base of a group can move the ACK of its member sockets.
+    if (m_parent->m_GroupOf)
+        return next_syn;
+#endif
+
+    {
+        ScopedLock lock(m_RcvLossLock);
+        if (m_pRcvLossList->getLossLength() > 0)
+            return next_syn;
+    }
+
+    // Idle: nothing to acknowledge or report and no data to send. Only the expiration
+    // and keepalive timers are due at some point. Any incoming packet makes the
+    // socket checked again (see CRcvQueue::worker_ProcessAddressedPacket()), and
+    // so does sending data or closing (CRcvQueue::wakeTimers()).
+    const steady_clock::time_point next_keepalive = m_tsLastSndTime.load() + microseconds_from(COMM_KEEPALIVE_PERIOD_US);
+    return std::max(next_syn, std::min(next_keepalive, nextExpTime()));
+}
+
+void srt::CUDT::breakAsUnstable()
+{
+    m_bBreakAsUnstable = true;
+    if (m_pRcvQueue)
+        m_pRcvQueue->wakeTimers(m_SocketID);
+}
+
 void srt::CUDT::updateBrokenConnection()
 {
     m_bClosing = true;
+    uglobal().scheduleGC(m_SocketID);
     releaseSynch();
     // app can call any UDT API to learn the connection_broken error
     uglobal().m_EPoll.update_events(m_SocketID, m_sPollID, SRT_EPOLL_IN | SRT_EPOLL_OUT | SRT_EPOLL_ERR, true);
@@ -11670,12 +12126,12 @@ void srt::CUDT::completeBrokenConnectionDependencies(int errorcode)
             token = m_parent->m_GroupMemberData->token;
             if (m_parent->m_GroupMemberData->sndstate == SRT_GST_PENDING)
             {
-                HLOGC(gmlog.Debug, log << CONID() << "updateBrokenConnection: a pending link was broken - will be removed");
+                HSLOGC(gmlog.Debug, m_SocketID, log << CONID() << "updateBrokenConnection: a pending link was broken - will be removed");
                 pending_broken = true;
             }
             else
             {
-                HLOGC(gmlog.Debug,
+                HSLOGC(gmlog.Debug, m_SocketID,
                       log << CONID() << "updateBrokenConnection: state="
                           << CUDTGroup::StateStr(m_parent->m_GroupMemberData->sndstate)
                           << " a used link was broken - not closing automatically");
@@ -11875,7 +12331,7 @@ bool srt::CUDT::runAcceptHook(CUDT *acore, const sockaddr* peer, const CHandShak
             {
                 if (!bytelen || bytelen > CSrtConfig::MAX_SID_LENGTH)
                 {
-                    LOGC(cnlog.Error,
+                    SLOGC(cnlog.Error, m_SocketID,
                          log << CONID() << "interpretSrtHandshake: STREAMID length " << bytelen << " is 0 or > "
                              << +CSrtConfig::MAX_SID_LENGTH << " - PROTOCOL ERROR, REJECTING");
                     return false;
@@ -11913,7 +12369,7 @@ bool srt::CUDT::runAcceptHook(CUDT *acore, const sockaddr* peer, const CHandShak
 #if ENABLE_BONDING
     if (have_group && acore->m_config.iGroupConnect == 0)
     {
-        HLOGC(cnlog.Debug,
+        HSLOGC(cnlog.Debug, m_SocketID,
               log << CONID() << "runAcceptHook: REJECTING connection WITHOUT calling the hook - groups not allowed");
         return false;
     }
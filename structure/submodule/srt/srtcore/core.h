@@ -69,9 +69,11 @@ modified by
 #include "handshake.h"
 #include "congctl.h"
 #include "packetfilter.h"
+#include "epoll.h"
 #include "socketconfig.h"
 #include "utilities.h"
 #include "logger_defs.h"
+#include "tsbpd_sched.h"
 
 #include "stats.h"
 
@@ -121,9 +123,9 @@ enum AckDataItem
 const size_t ACKD_FIELD_SIZE = sizeof(int32_t);
 
 #ifdef ENABLE_MAXREXMITBW
-static const size_t SRT_SOCKOPT_NPOST = 13;
+static const size_t SRT_SOCKOPT_NPOST = 15;
 #else
-static const size_t SRT_SOCKOPT_NPOST = 12;
+static const size_t SRT_SOCKOPT_NPOST = 14;
 #endif
 
 extern const SRT_SOCKOPT srt_post_opt_list [];
@@ -224,7 +226,10 @@ public: //API
     static int sendmsg(SRTSOCKET u, const char* buf, int len, int ttl = SRT_MSGTTL_INF, bool inorder = false, int64_t srctime = 0);
     static int recvmsg(SRTSOCKET u, char* buf, int len, int64_t& srctime);
     static int sendmsg2(SRTSOCKET u, const char* buf, int len, SRT_MSGCTRL& mctrl);
+    static int sendmsg2_nocopy(SRTSOCKET u, const char* buf, int len, SRT_MSGCTRL& mctrl, CSndPayload::release_fn* relfn, void* opaque);
     static int recvmsg2(SRTSOCKET u, char* buf, int len, SRT_MSGCTRL& w_mctrl);
+    static int recvmsg2_lend(SRTSOCKET u, SRT_MSGVIEW& w_view, SRT_MSGCTRL& w_mctrl);
+    static int recvmsg2_release(SRTSOCKET u, SRT_MSGVIEW& w_view);
     static int64_t sendfile(SRTSOCKET u, std::fstream& ifs, int64_t& offset, int64_t size, int block = SRT_DEFAULT_SENDFILE_BLOCK);
     static int64_t recvfile(SRTSOCKET u, std::fstream& ofs, int64_t& offset, int64_t size, int block = SRT_DEFAULT_RECVFILE_BLOCK);
     static int select(int nfds, UDT::UDSET* readfds, UDT::UDSET* writefds, UDT::UDSET* exceptfds, const timeval* timeout);
@@ -244,6 +249,7 @@ public: //API
     static int epoll_release(const int eid);
     static CUDTException& getlasterror();
     static int bstats(SRTSOCKET u, CBytePerfMon* perf, bool clear = true, bool instantaneous = false);
+    static int bstatsSnapshot(SRTSOCKET u, CBytePerfMon* perf);
 #if ENABLE_BONDING
     static int groupsockbstats(SRTSOCKET u, CBytePerfMon* perf, bool clear = true);
 #endif
@@ -293,16 +299,7 @@ public: // internal API
         return m_ConnRes.m_iVersion;
     }
 
-    std::string CONID() const
-    {
-#if ENABLE_LOGGING
-        std::ostringstream os;
-        os << "@" << m_SocketID << ": ";
-        return os.str();
-#else
-        return "";
-#endif
-    }
+    srt_logging::LogSocketId CONID() const { return srt_logging::LogSocketId(m_SocketID); }
 
     SRTSOCKET socketID() const { return m_SocketID; }
 
@@ -447,7 +444,7 @@ public: // internal API
 
     static CUDTUnited& uglobal();                      // UDT global management base
 
-    std::set<int>& pollset() { return m_sPollID; }
+    CEPollSubscribers& pollset() { return m_sPollID; }
 
     CSrtConfig m_config;
 
@@ -460,7 +457,7 @@ public: // internal API
     SRTU_PROPERTY_RR(sync::Condition*, recvTsbPdCond, &m_RcvTsbPdCond);
 
     /// @brief  Request a socket to be broken due to too long instability (normally by a group).
-    void breakAsUnstable() { m_bBreakAsUnstable = true; }
+    void breakAsUnstable();
 
     void ConnectSignal(ETransmissionEvent tev, EventSlot sl);
     void DisconnectSignal(ETransmissionEvent tev);
@@ -637,11 +634,21 @@ private:
     /// @param len [in] size of the buffer.
     /// @return Actual size of data received.
 
-    SRT_ATR_NODISCARD int sendmsg2(const char* data, int len, SRT_MSGCTRL& w_m);
+    /// Send a message; see srt_sendmsg2.
+    /// @param payload [in] if not NULL, the sender buffer refers to it instead of copying @a data.
+    SRT_ATR_NODISCARD int sendmsg2(const char* data, int len, SRT_MSGCTRL& w_m, CSndPayload* payload = NULL);
 
     SRT_ATR_NODISCARD int recvmsg(char* data, int len, int64_t& srctime);
     SRT_ATR_NODISCARD int recvmsg2(char* data, int len, SRT_MSGCTRL& w_m);
-    SRT_ATR_NODISCARD int receiveMessage(char* data, int len, SRT_MSGCTRL& w_m, int erh = 1 /*throw exception*/);
+    SRT_ATR_NODISCARD int receiveMessage(char* data, int len, SRT_MSGCTRL& w_m, int erh = 1 /*throw exception*/, CUnit** w_lent = NULL);
+
+    /// Receive a message without copying it: the unit holding the payload
+    /// is lent to the caller until returned with releaseLentUnit().
+    /// @param w_m [out] message control data.
+    /// @param w_unit [out] the unit holding the message.
+    /// @return Size of the message.
+    SRT_ATR_NODISCARD int lendMessage(SRT_MSGCTRL& w_m, CUnit*& w_unit);
+    void releaseLentUnit(CUnit* unit);
     SRT_ATR_NODISCARD int receiveBuffer(char* data, int len);
 
     size_t dropMessage(int32_t seqtoskip);
@@ -692,6 +699,13 @@ private:
     /// instead of moving averages.
     void bstats(CBytePerfMon* perf, bool clear = true, bool instantaneous = false);
 
+    /// Read the performance data without locking, so that frequent polling
+    /// does not contend with the sending and receiving threads.
+    /// Does not clear the trace counters. The buffer timespans are the ones
+    /// stored by the buffers with the last change of their contents.
+    /// @param perf [out] pointer to a CPerfMon structure to record the performance data.
+    void bstatsSnapshot(CBytePerfMon* perf);
+
     /// Mark sequence contained in the given packet as not lost. This
     /// removes the loss record from both current receiver loss list and
     /// the receiver fresh loss list.
@@ -755,6 +769,26 @@ private:
     // TSBPD thread main function.
     static void* tsbpd(void* param);
 
+    /// Signal the readers if a packet is ready to play, dropping the packets
+    /// too late to play if needed.
+    /// @param group the group kept for the TSBPD, if the socket is a member
+    /// @return the time when the next packet will be ready to play, or zero
+    /// if the TSBPD should wait until notified.
+    SRT_ATTR_REQUIRES(m_RecvLock)
+    time_point tsbpdCheck(CUDTGroup* group);
+
+    /// TSBPD check done by the shared scheduler.
+    /// @return the time when to check the socket again, or zero
+    /// to wait for notifyTsbPd().
+    SRT_ATTR_EXCLUDES(m_RecvLock)
+    time_point tsbpdCheckShared();
+
+    /// Wake up the TSBPD thread, or the shared scheduler, to check the receiver buffer.
+    SRT_ATTR_REQUIRES(m_RecvLock)
+    void notifyTsbPd();
+
+    friend class CTsbPdScheduler;
+
     /// Drop too late packets (receiver side). Update loss lists and ACK positions.
     /// The @a seqno packet itself is not dropped.
     /// @param seqno [in] The sequence number of the first packets following those to be dropped.
@@ -852,6 +886,9 @@ private: // Sending related data
 
     atomic_duration m_tdSendTimeDiff;            // Aggregate difference in inter-packet sending time
 
+    sync::atomic<int> m_iSndPriority;            // SRTO_SNDPRIORITY, as read by the send scheduler
+    sync::atomic<int> m_iSndWeight;              // SRTO_SNDWEIGHT, as read by the send scheduler
+
     SRT_ATTR_GUARDED_BY(m_RecvAckLock)
     sync::atomic<int> m_iFlowWindowSize;         // Flow control window size
     sync::atomic<int> m_iCongestionWindow;       // Congestion window size
@@ -982,6 +1019,10 @@ private: // Receiving related data
     sync::Condition m_RcvTsbPdCond;              // TSBPD signals if reading is ready. Use together with m_RecvLock
     bool m_bTsbPdAckWakeup;                      // Signal TsbPd thread on Ack sent
     sync::Mutex m_RcvTsbPdStartupLock;           // Protects TSBPD thread creating and joining
+    CTsbPdTask m_TsbPdTask;                      // TSBPD done by the shared scheduler instead (SRTO_TSBPDWORKERS)
+#if ENABLE_BONDING
+    CUDTGroup* m_pTsbPdGroup;                    // Group kept for the shared scheduler, like GroupKeeper in tsbpd()
+#endif
 
     CallbackHolder<srt_listen_callback_fn> m_cbAcceptHook;
     CallbackHolder<srt_connect_callback_fn> m_cbConnectHook;
@@ -1023,6 +1064,33 @@ private: // synchronization: mutexes and conditions
     sync::Mutex m_SendLock;                      // used to synchronize "send" call
     sync::Mutex m_RcvLossLock;                   // Protects the receiver loss list (access: CRcvQueue::worker, CUDT::tsbpd)
     mutable sync::Mutex m_StatsLock;             // used to synchronize access to trace statistics
+    stats::Version m_StatsVersion;               // changed with every update of m_stats, for bstatsSnapshot()
+
+    // Lock m_StatsLock for updating the statistics.
+    void enterStatsCS() SRT_ATTR_ACQUIRE(m_StatsLock)
+    {
+        sync::enterCS(m_StatsLock);
+        m_StatsVersion.beginWrite();
+    }
+
+    void leaveStatsCS() SRT_ATTR_RELEASE(m_StatsLock)
+    {
+        m_StatsVersion.endWrite();
+        sync::leaveCS(m_StatsLock);
+    }
+
+    class StatsWriteLock
+    {
+    public:
+        explicit StatsWriteLock(CUDT& u) : m_u(u) { m_u.enterStatsCS(); }
+        ~StatsWriteLock() { m_u.leaveStatsCS(); }
+
+    private:
+        CUDT& m_u;
+
+        StatsWriteLock(const StatsWriteLock&);
+        StatsWriteLock& operator=(const StatsWriteLock&);
+    };
 
     void initSynch();
     void destroySynch();
@@ -1120,6 +1188,7 @@ private: // Generation and processing of packets
     /// and report the status thereof.
     ///
     /// @param incoming [in] The packet coming from the network medium
+    /// @param rcvgroup [in] The redundant group whose receiver index is checked for duplicates, or NULL
     /// @param w_new_inserted [out] Set false, if the packet already exists, otherwise true (packet added)
     /// @param w_was_sent_in_order [out] Set false, if the packet was belated, but had no R flag set.
     /// @param w_srt_loss_seqs [out] Gets inserted a loss, if this function has detected it.
@@ -1127,7 +1196,7 @@ private: // Generation and processing of packets
     /// @return 0 The call was successful (regardless if the packet was accepted or not).
     /// @return -1 The call has failed: no space left in the buffer.
     /// @return -2 The incoming packet exceeds the expected sequence by more than a length of the buffer (irrepairable discrepancy).
-    int handleSocketPacketReception(const std::vector<CUnit*>& incoming, bool& w_new_inserted, bool& w_was_sent_in_order, CUDT::loss_seqs_t& w_srt_loss_seqs);
+    int handleSocketPacketReception(const std::vector<CUnit*>& incoming, CUDTGroup* rcvgroup, bool& w_new_inserted, bool& w_was_sent_in_order, CUDT::loss_seqs_t& w_srt_loss_seqs);
 
     /// Get the packet's TSBPD time.
     /// The @a grp passed by void* is not used yet
@@ -1146,6 +1215,11 @@ private: // Generation and processing of packets
     /// @param packet contents of the packet
     /// @return URQ code, possibly containing reject reason
     int processConnectRequest(const sockaddr_any& addr, CPacket& packet);
+
+    /// Check if the KEK for the KMREQ of the conclusion handshake can be derived
+    /// now, or if the derivation has been left to the derivation thread.
+    /// @return false if the request should be ignored until the KEK is ready
+    bool prepareConclusionKek(const CHandShake& hs, const CPacket& hspkt);
     static void addLossRecord(std::vector<int32_t>& lossrecord, int32_t lo, int32_t hi);
     int32_t bake(const sockaddr_any& addr, int32_t previous_cookie = 0, int correction = 0);
 
@@ -1163,6 +1237,10 @@ private: // Generation and processing of packets
     SRT_ATTR_REQUIRES(m_RcvBufferLock)
     size_t getAvailRcvBufferSizeNoLock() const;
 
+    /// Fills in the counters and connection parameters shared by bstats()
+    /// and bstatsSnapshot(). Reads only atomic fields.
+    void fillPerfCounters(CBytePerfMon* perf, const time_point& currtime);
+
 private: // Trace
     struct CoreStats
     {
@@ -1170,13 +1248,14 @@ private: // Trace
         stats::Sender sndr;                 // sender statistics
         stats::Receiver rcvr;               // receiver statistics
 
-        int64_t m_sndDurationTotal;         // total real time for sending
+        // The fields read by bstatsSnapshot() are updated under m_StatsLock by enterStatsCS().
+        stats::Value<int64_t> m_sndDurationTotal; // total real time for sending
 
-        time_point tsLastSampleTime;        // last performance sample time
-        int traceReorderDistance;
-        double traceBelatedTime;
+        atomic_time_point tsLastSampleTime; // last performance sample time
+        stats::Value<int> traceReorderDistance;
+        stats::Value<int64_t> traceBelatedTimeUs;
 
-        int64_t sndDuration;                // real time for sending
+        stats::Value<int64_t> sndDuration;  // real time for sending
         time_point sndDurationCounter;      // timers to record the sending Duration
 
     } m_stats;
@@ -1200,6 +1279,8 @@ private: // Timers functions
                      LAST_BECAUSE_BIT  =      3;
 
     void checkTimers();
+    time_point nextTimersCheckTime(const time_point& lastcheck);
+    time_point nextExpTime();
     void considerLegacySrtHandshake(const time_point &timebase);
     int checkACKTimer (const time_point& currtime);
     int checkNAKTimer(const time_point& currtime);
@@ -1221,7 +1302,7 @@ public: // For SrtCongestion
     const CRcvQueue* rcvQueue() { return m_pRcvQueue; }
 
 private: // for epoll
-    std::set<int> m_sPollID;                     // set of epoll ID to trigger
+    CEPollSubscribers m_sPollID;                 // set of epoll ID to trigger
     void addEPoll(const int eid);
     void removeEPollEvents(const int eid);
     void removeEPollID(const int eid);
@@ -27,6 +27,11 @@ written by
 #include "logging.h"
 #include "core.h"
 #include "api.h"
+#include "threadname.h"
+#include "md5.h"
+#ifdef SRT_ENABLE_ENCRYPTION
+#include <hcrypt.h> // CRYSPR_methods
+#endif
 
 using namespace srt_logging;
 
@@ -511,6 +516,9 @@ void srt::CCryptoControl::regenCryptoKm(CUDT* sock SRT_ATR_UNUSED, bool bidirect
     if (!m_hSndCrypto)
         return;
 
+    // The key refresh is decided by the number of packets sent.
+    countAheadSent();
+
     void *out_p[2];
     size_t out_len_p[2];
     int nbo = HaiCrypt_Tx_ManageKeys(m_hSndCrypto, out_p, out_len_p, 2);
@@ -542,6 +550,7 @@ void srt::CCryptoControl::regenCryptoKm(CUDT* sock SRT_ATR_UNUSED, bool bidirect
 
             /* New Keying material, send to peer */
             memcpy((m_SndKmMsg[ki].Msg), out_p[i], out_len_p[i]);
+            m_iSndKeyEpoch.store(m_iSndKeyEpoch.load() + 1); // invalidates packets encrypted ahead
             m_SndKmMsg[ki].MsgLen = out_len_p[i];
             m_SndKmMsg[ki].iPeerRetry = SRT_MAX_KMRETRY;  
 
@@ -594,8 +603,24 @@ srt::CCryptoControl::CCryptoControl(SRTSOCKET id)
     , m_KmPreAnnouncePkt(0)
     , m_iCryptoMode(CSrtConfig::CIPHER_MODE_AUTO)
     , m_bErrorReported(false)
+    , m_pAheadPool(NULL)
+    , m_bAheadEnabled(false)
+    , m_zAheadSlotSize(0)
+    , m_iAheadLastSeq(SRT_SEQNO_NONE)
+    , m_iSndKeyEpoch(0)
+    , m_iAheadUncounted(0)
 {
+    for (int i = 0; i < AHEAD_SLOTS; ++i)
+    {
+        m_AheadSlots[i].seqno = SRT_SEQNO_NONE;
+        m_AheadSlots[i].kflg = EK_NOENC;
+        m_AheadSlots[i].keyepoch = 0;
+        m_AheadSlots[i].length = 0;
+        m_AheadSlots[i].data = NULL;
+    }
+
     m_KmSecret.len = 0;
+    m_bKekCacheHeld = false;
     //send
     m_SndKmMsg[0].MsgLen = 0;
     m_SndKmMsg[0].iPeerRetry = 0;
@@ -636,6 +661,15 @@ bool srt::CCryptoControl::init(HandshakeSide side, const CSrtConfig& cfg, bool b
     // Set security-pending state, if a password was set.
     m_SndKmState = hasPassphrase() ? SRT_KM_S_SECURING : SRT_KM_S_UNSECURED;
 
+#ifdef SRT_ENABLE_ENCRYPTION
+    // Keep the KEKs derived from the passphrase cached while it's used here.
+    if (hasPassphrase() && !m_bKekCacheHeld)
+    {
+        CUDT::uglobal().m_KekCache.acquire((const char*)m_KmSecret.str, m_KmSecret.len);
+        m_bKekCacheHeld = true;
+    }
+#endif
+
     m_KmPreAnnouncePkt = cfg.uKmPreAnnouncePkt;
     m_KmRefreshRatePkt = cfg.uKmRefreshRatePkt;
 
@@ -700,8 +734,26 @@ bool srt::CCryptoControl::init(HandshakeSide side, const CSrtConfig& cfg, bool b
 
 void srt::CCryptoControl::close() 
 {
+    // No job can be submitted after the pool is reset, so none is left
+    // once the queued ones are cancelled. The workers lock m_mtxLock,
+    // so this must be done before taking it.
+    CCryptoWorkerPool* pool;
+    {
+        sync::ScopedLock lck(m_mtxAheadPoolLock);
+        pool = m_pAheadPool;
+        m_pAheadPool = NULL;
+        m_bAheadEnabled.store(false);
+    }
+    if (pool)
+        pool->cancel(this);
+
     /* Wipeout secrets */
     sync::ScopedLock lck(m_mtxLock);
+    if (m_bKekCacheHeld)
+    {
+        CUDT::uglobal().m_KekCache.release((const char*)m_KmSecret.str, m_KmSecret.len);
+        m_bKekCacheHeld = false;
+    }
     memset(&m_KmSecret, 0, sizeof(m_KmSecret));
 }
 
@@ -764,7 +816,7 @@ bool srt::CCryptoControl::createCryptoCtx(HaiCrypt_Handle& w_hCrypto, size_t key
 #endif
     crypto_cfg.flags = HAICRYPT_CFG_F_CRYPTO | (cdir == HAICRYPT_CRYPTO_DIR_TX ? HAICRYPT_CFG_F_TX : 0) | (bAESGCM ? HAICRYPT_CFG_F_GCM : 0);
     crypto_cfg.xport = HAICRYPT_XPT_SRT;
-    crypto_cfg.cryspr = HaiCryptCryspr_Get_Instance();
+    crypto_cfg.cryspr = CUDT::uglobal().m_KekCache.cryspr();
     crypto_cfg.key_len = (size_t)keylen;
     crypto_cfg.data_max_len = HAICRYPT_DEF_DATA_MAX_LENGTH;    //MTU
     crypto_cfg.km_tx_period_ms = 0;//No HaiCrypt KM inject period, handled in SRT;
@@ -800,6 +852,20 @@ srt::EncryptionStatus srt::CCryptoControl::encrypt(CPacket& w_packet SRT_ATR_UNU
     if ( getSndCryptoFlags() == EK_NOENC )
         return ENCS_CLEAR;
 
+    // The workers encrypt with a context of their own, and the packets
+    // taken from them are counted for the key refresh by regenCryptoKm.
+    if (m_bAheadEnabled.load() && takeAhead((w_packet)))
+        return ENCS_CLEAR;
+
+    return encryptPacket((w_packet));
+#else
+    return ENCS_NOTSUP;
+#endif
+}
+
+srt::EncryptionStatus srt::CCryptoControl::encryptPacket(CPacket& w_packet SRT_ATR_UNUSED)
+{
+#ifdef SRT_ENABLE_ENCRYPTION
     // Note that in case of GCM the header has to zero Retransmitted Packet Flag (R).
     // If TSBPD is disabled, timestamp also has to be zeroed.
     int rc = HaiCrypt_Tx_Data(m_hSndCrypto, ((uint8_t*)w_packet.getHeader()), ((uint8_t*)w_packet.m_pcData), w_packet.getLength());
@@ -820,6 +886,719 @@ srt::EncryptionStatus srt::CCryptoControl::encrypt(CPacket& w_packet SRT_ATR_UNU
 #endif
 }
 
+namespace srt
+{
+// Compare-and-swap that doesn't fail spuriously: it fails only
+// when the state is found different than @a from.
+static bool casAheadState(sync::atomic<int>& state, int from, int to)
+{
+    for (;;)
+    {
+        if (state.compare_exchange(from, to))
+            return true;
+        if (state.load() != from)
+            return false;
+    }
+}
+}
+
+void srt::CCryptoControl::enableAhead(CCryptoWorkerPool* pool, int workers, size_t max_payload)
+{
+    if (pool->reserve(workers) == 0)
+    {
+        LOGC(cnlog.Error, log << CONID() << "enableAhead: no crypto worker could be started, encrypting on send");
+        return;
+    }
+
+    m_zAheadSlotSize = max_payload;
+    m_AheadStorage.resize(AHEAD_SLOTS * max_payload);
+    for (int i = 0; i < AHEAD_SLOTS; ++i)
+        m_AheadSlots[i].data = &m_AheadStorage[i * max_payload];
+    {
+        sync::ScopedLock lck(m_mtxAheadPoolLock);
+        m_pAheadPool = pool;
+        m_bAheadEnabled.store(true);
+    }
+    HLOGC(cnlog.Debug, log << CONID() << "enableAhead: encrypting packets of up to " << max_payload
+            << " bytes with " << workers << " workers");
+}
+
+bool srt::CCryptoControl::aheadStale(int32_t seqno) const
+{
+    const int32_t last = m_iAheadLastSeq.load();
+    return last != SRT_SEQNO_NONE && CSeqNo::seqcmp(seqno, last) <= 0;
+}
+
+void srt::CCryptoControl::submitAhead(int32_t seqno SRT_ATR_UNUSED, const char* data SRT_ATR_UNUSED, size_t len SRT_ATR_UNUSED)
+{
+#ifdef SRT_ENABLE_ENCRYPTION
+    if (!m_bAheadEnabled.load() || len > m_zAheadSlotSize || m_iCryptoMode == CSrtConfig::CIPHER_MODE_AES_GCM)
+        return;
+
+    const int slotx = seqno % AHEAD_SLOTS;
+    AheadSlot& slot = m_AheadSlots[slotx];
+
+    // Take a free slot, or one whose packet has been sent already. The
+    // slot with a packet still waiting for sending is not overtaken;
+    // this packet will simply be encrypted when being sent.
+    const int state = slot.state.load();
+    if (state == AHEAD_READY)
+    {
+        if (!aheadStale(slot.seqno) || !casAheadState(slot.state, AHEAD_READY, AHEAD_FILLING))
+            return;
+    }
+    else if (state != AHEAD_FREE || !casAheadState(slot.state, AHEAD_FREE, AHEAD_FILLING))
+    {
+        return;
+    }
+
+    memcpy(slot.data, data, len);
+    slot.seqno = seqno;
+    slot.length = len;
+    slot.state.store(AHEAD_QUEUED);
+
+    sync::ScopedLock lck(m_mtxAheadPoolLock);
+    if (m_pAheadPool)
+        m_pAheadPool->submit(this, slotx);
+    else
+        slot.state.store(AHEAD_FREE);
+#endif
+}
+
+void srt::CCryptoControl::encryptAhead(const int* slotx SRT_ATR_UNUSED, int n SRT_ATR_UNUSED)
+{
+#ifdef SRT_ENABLE_ENCRYPTION
+    const int MAX_BATCH = CCryptoWorkerPool::MAX_BATCH;
+    AheadSlot* slots[MAX_BATCH];
+    int nslots = 0;
+    for (int i = 0; i < n && nslots < MAX_BATCH; ++i)
+    {
+        // Skip those taken back by the sender.
+        AheadSlot& slot = m_AheadSlots[slotx[i]];
+        if (casAheadState(slot.state, AHEAD_QUEUED, AHEAD_BUSY))
+            slots[nslots++] = &slot;
+    }
+    if (nslots == 0)
+        return;
+
+    // One worker at a time uses the context for encrypting ahead, which
+    // only needs m_mtxLock to be updated to the current key.
+    sync::ScopedLock alck(m_mtxAheadLock);
+    HaiCrypt_Handle hcrypto;
+    int kflg;
+    int keyepoch;
+    {
+        sync::ScopedLock lck(m_mtxLock);
+        hcrypto = m_hSndCrypto;
+        kflg = getSndCryptoFlags();
+        keyepoch = m_iSndKeyEpoch.load();
+        if (!hcrypto || kflg <= EK_NOENC || HaiCrypt_Tx_SyncAhead(hcrypto) != kflg)
+            kflg = EK_NOENC;
+    }
+
+    // Only the sequence number and the key flags of the header are used
+    // by AES-CTR, the rest doesn't need to be filled.
+    uint32_t headers[MAX_BATCH][SRT_PH_E_SIZE] = {};
+    unsigned char* pfx[MAX_BATCH];
+    unsigned char* data[MAX_BATCH];
+    size_t len[MAX_BATCH];
+    int nbatch = 0;
+    for (int i = 0; i < nslots; ++i)
+    {
+        // The packet might have been sent already when the slot was being filled.
+        AheadSlot& slot = *slots[i];
+        if (kflg <= EK_NOENC || aheadStale(slot.seqno))
+        {
+            slot.state.store(AHEAD_FREE);
+            continue;
+        }
+
+        headers[nbatch][SRT_PH_SEQNO] = slot.seqno;
+        headers[nbatch][SRT_PH_MSGNO] = EncryptionKeyBits(EncryptionKeySpec(kflg));
+        pfx[nbatch] = (unsigned char*)headers[nbatch];
+        data[nbatch] = (unsigned char*)slot.data;
+        len[nbatch] = slot.length;
+        slots[nbatch++] = &slot;
+    }
+    if (nbatch == 0)
+        return;
+
+    // Counted for the key refresh only when taken for sending.
+    const int nenc = HaiCrypt_Tx_DataAhead(hcrypto, pfx, data, len, nbatch);
+    for (int i = 0; i < nbatch; ++i)
+    {
+        AheadSlot& slot = *slots[i];
+        if (i >= nenc)
+        {
+            slot.state.store(AHEAD_FREE);
+            continue;
+        }
+
+        slot.length = len[i];
+        slot.kflg = kflg;
+        slot.keyepoch = keyepoch;
+        slot.state.store(AHEAD_READY);
+    }
+#endif
+}
+
+void srt::CCryptoControl::countAheadSent()
+{
+#ifdef SRT_ENABLE_ENCRYPTION
+    const int sent = m_iAheadUncounted.exchange(0);
+    if (sent && m_hSndCrypto)
+        HaiCrypt_Tx_CountData(m_hSndCrypto, sent);
+#endif
+}
+
+bool srt::CCryptoControl::takeAhead(CPacket& w_packet)
+{
+    const int32_t seqno = w_packet.seqno();
+    // Set it before checking the slot so that a worker that gets the
+    // slot later finds it stale.
+    m_iAheadLastSeq.store(seqno);
+
+    AheadSlot& slot = m_AheadSlots[seqno % AHEAD_SLOTS];
+    int state = slot.state.load();
+    if (state == AHEAD_QUEUED)
+    {
+        // Not started yet, encrypting now is faster than waiting.
+        if (casAheadState(slot.state, AHEAD_QUEUED, AHEAD_FREE))
+            return false;
+        state = slot.state.load();
+    }
+
+    if (state == AHEAD_BUSY)
+    {
+        // The worker holds the lock until the slot is ready.
+        sync::ScopedLock lck(m_mtxAheadLock);
+        state = slot.state.load();
+    }
+
+    if (state != AHEAD_READY || slot.seqno != seqno || !casAheadState(slot.state, AHEAD_READY, AHEAD_TAKING))
+        return false;
+
+    const bool match = slot.kflg == int(w_packet.getMsgCryptoFlags())
+        && slot.keyepoch == m_iSndKeyEpoch.load()
+        && slot.length == w_packet.getLength();
+    if (match)
+    {
+        memcpy(w_packet.m_pcData, slot.data, slot.length);
+        int uncounted = m_iAheadUncounted.load();
+        while (!m_iAheadUncounted.compare_exchange(uncounted, uncounted + 1))
+            uncounted = m_iAheadUncounted.load();
+    }
+    slot.state.store(AHEAD_FREE);
+
+    HLOGC(cnlog.Debug, log << CONID() << "takeAhead: %" << seqno << (match ? " encrypted ahead" : " key changed, encrypting"));
+    return match;
+}
+
+srt::CCryptoWorkerPool::CCryptoWorkerPool()
+    : m_iWorkers(0)
+    , m_bClosing(false)
+{
+    sync::setupMutex(m_Lock, "CryptoWorkers");
+    setupCond(m_JobCond, "CryptoJob");
+    setupCond(m_DoneCond, "CryptoDone");
+    for (int i = 0; i < MAX_WORKERS; ++i)
+    {
+        m_Workers[i].pool = this;
+        m_Workers[i].current = NULL;
+    }
+}
+
+srt::CCryptoWorkerPool::~CCryptoWorkerPool()
+{
+    stop();
+    releaseCond(m_JobCond);
+    releaseCond(m_DoneCond);
+    sync::releaseMutex(m_Lock);
+}
+
+int srt::CCryptoWorkerPool::reserve(int workers)
+{
+    sync::ScopedLock lk(m_Lock);
+    m_bClosing = false;
+    workers = std::min(workers, int(MAX_WORKERS));
+    while (m_iWorkers < workers)
+    {
+        Worker& w = m_Workers[m_iWorkers];
+#if ENABLE_LOGGING
+        const std::string thname = "SRT:Crypt:w" + Sprint(m_iWorkers + 1);
+#else
+        const std::string thname = "SRT:Crypt";
+#endif
+        if (!sync::StartThread(w.thread, workerThread, &w, thname))
+            break;
+        ++m_iWorkers;
+    }
+    return m_iWorkers;
+}
+
+void srt::CCryptoWorkerPool::submit(CCryptoControl* ctrl, int slot)
+{
+    Job job;
+    job.ctrl = ctrl;
+    job.slot = slot;
+
+    sync::ScopedLock lk(m_Lock);
+    m_Jobs.push_back(job);
+    m_JobCond.notify_one();
+}
+
+void srt::CCryptoWorkerPool::cancel(CCryptoControl* ctrl)
+{
+    sync::UniqueLock lk(m_Lock);
+    for (std::deque<Job>::iterator i = m_Jobs.begin(); i != m_Jobs.end();)
+    {
+        if (i->ctrl == ctrl)
+            i = m_Jobs.erase(i);
+        else
+            ++i;
+    }
+
+    for (;;)
+    {
+        bool busy = false;
+        for (int i = 0; i < m_iWorkers; ++i)
+            busy = busy || m_Workers[i].current == ctrl;
+        if (!busy)
+            break;
+        m_DoneCond.wait(lk);
+    }
+}
+
+void srt::CCryptoWorkerPool::stop()
+{
+    int workers;
+    {
+        sync::ScopedLock lk(m_Lock);
+        m_bClosing = true;
+        m_Jobs.clear();
+        m_JobCond.notify_all();
+        workers = m_iWorkers;
+    }
+
+    for (int i = 0; i < workers; ++i)
+        m_Workers[i].thread.join();
+
+    sync::ScopedLock lk(m_Lock);
+    m_iWorkers = 0;
+}
+
+void* srt::CCryptoWorkerPool::workerThread(void* arg)
+{
+    Worker* w = (Worker*)arg;
+    THREAD_STATE_INIT("SRT:Crypt");
+    w->pool->workerLoop(*w);
+    THREAD_EXIT();
+    return NULL;
+}
+
+void srt::CCryptoWorkerPool::workerLoop(Worker& w)
+{
+    sync::UniqueLock lk(m_Lock);
+    while (!m_bClosing)
+    {
+        if (m_Jobs.empty())
+        {
+            m_JobCond.wait(lk);
+            continue;
+        }
+
+        // Take the other queued jobs of the same control along, so that
+        // they are encrypted at once.
+        CCryptoControl* const ctrl = m_Jobs.front().ctrl;
+        int slots[MAX_BATCH];
+        int n = 0;
+        for (std::deque<Job>::iterator i = m_Jobs.begin(); i != m_Jobs.end() && n < MAX_BATCH;)
+        {
+            if (i->ctrl == ctrl)
+            {
+                slots[n++] = i->slot;
+                i = m_Jobs.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        w.current = ctrl;
+        {
+            sync::InvertedLock unlocked(m_Lock);
+            ctrl->encryptAhead(slots, n);
+        }
+        w.current = NULL;
+        m_DoneCond.notify_all();
+    }
+}
+
+#ifdef SRT_ENABLE_ENCRYPTION
+namespace srt
+{
+// The cryspr handed to HaiCrypt: the default one with km_pbkdf2 replaced.
+// HaiCrypt passes the control block opened from it to km_pbkdf2, which
+// points back to these methods.
+struct KekCacheCryspr
+{
+    CRYSPR_methods methods;
+    int (*base_pbkdf2)(CRYSPR_cb*, char*, size_t, unsigned char*, size_t, int, size_t, unsigned char*);
+    CKekCache* cache;
+};
+
+static int kekCachePbkdf2(CRYSPR_cb* cryspr_cb, char* passwd, size_t passwd_len,
+        unsigned char* salt, size_t salt_len, int itr, size_t out_len, unsigned char* out)
+{
+    KekCacheCryspr* kc = (KekCacheCryspr*)cryspr_cb->cryspr;
+    return kc->cache->derive(passwd, passwd_len, salt, salt_len, itr, out_len, out);
+}
+} // namespace srt
+#endif
+
+srt::CKekCache::CKekCache()
+    : m_pCryspr(NULL)
+    , m_bThreadStarted(false)
+    , m_bClosing(false)
+    , m_tdBudgetUsed(sync::steady_clock::duration::zero())
+    , m_tdDeriveCost(sync::steady_clock::duration::zero())
+    , m_iHits(0)
+    , m_iMisses(0)
+    , m_iDeferred(0)
+{
+    sync::setupMutex(m_Lock, "KekCache");
+    setupCond(m_PendingCond, "KekPending");
+#ifdef SRT_ENABLE_ENCRYPTION
+    KekCacheCryspr* kc = new KekCacheCryspr;
+    kc->methods = *(CRYSPR_methods*)HaiCryptCryspr_Get_Instance();
+    kc->base_pbkdf2 = kc->methods.km_pbkdf2;
+    kc->methods.km_pbkdf2 = kekCachePbkdf2;
+    kc->cache = this;
+    m_pCryspr = kc;
+    if (kc->methods.prng(m_HashKey, sizeof m_HashKey) != 0)
+    {
+        for (size_t i = 0; i < sizeof m_HashKey; ++i)
+            m_HashKey[i] = (unsigned char)sync::genRandomInt(0, 255);
+    }
+#else
+    memset(m_HashKey, 0, sizeof m_HashKey);
+#endif
+}
+
+srt::CKekCache::~CKekCache()
+{
+    stop();
+    clear();
+#ifdef SRT_ENABLE_ENCRYPTION
+    delete (KekCacheCryspr*)m_pCryspr;
+#endif
+    releaseCond(m_PendingCond);
+    sync::releaseMutex(m_Lock);
+}
+
+HaiCrypt_Cryspr srt::CKekCache::cryspr()
+{
+    return (HaiCrypt_Cryspr)m_pCryspr;
+}
+
+bool srt::CKekCache::Key::operator==(const Key& other) const
+{
+    return salt_len == other.salt_len && kek_len == other.kek_len && itr == other.itr
+        && memcmp(pwdhash, other.pwdhash, sizeof pwdhash) == 0
+        && memcmp(salt, other.salt, salt_len) == 0;
+}
+
+void srt::CKekCache::hashPassphrase(const char* pwd, size_t pwd_len, unsigned char* w_hash) const
+{
+    // HMAC-MD5 (RFC 2104) with m_HashKey.
+    unsigned char pad[64];
+    unsigned char inner[16];
+    md5_state_t state;
+
+    memset(pad, 0x36, sizeof pad);
+    for (size_t i = 0; i < sizeof m_HashKey; ++i)
+        pad[i] ^= m_HashKey[i];
+    md5_init(&state);
+    md5_append(&state, pad, sizeof pad);
+    md5_append(&state, (const md5_byte_t*)pwd, (int)pwd_len);
+    md5_finish(&state, inner);
+
+    memset(pad, 0x5C, sizeof pad);
+    for (size_t i = 0; i < sizeof m_HashKey; ++i)
+        pad[i] ^= m_HashKey[i];
+    md5_init(&state);
+    md5_append(&state, pad, sizeof pad);
+    md5_append(&state, inner, sizeof inner);
+    md5_finish(&state, w_hash);
+
+    memset(pad, 0, sizeof pad);
+    memset(inner, 0, sizeof inner);
+}
+
+bool srt::CKekCache::makeKey(const char* pwd, size_t pwd_len, const unsigned char* salt, size_t salt_len,
+        int itr, size_t kek_len, Key& w_key) const
+{
+    if (salt_len > sizeof w_key.salt || kek_len > HAICRYPT_KEY_MAX_SZ || pwd_len > HAICRYPT_SECRET_MAX_SZ)
+        return false;
+
+    hashPassphrase(pwd, pwd_len, w_key.pwdhash);
+    memset(w_key.salt, 0, sizeof w_key.salt);
+    memcpy(w_key.salt, salt, salt_len);
+    w_key.salt_len = salt_len;
+    w_key.kek_len = kek_len;
+    w_key.itr = itr;
+    return true;
+}
+
+void srt::CKekCache::acquire(const char* pwd, size_t pwd_len)
+{
+    Key key;
+    hashPassphrase(pwd, pwd_len, key.pwdhash);
+
+    sync::ScopedLock lk(m_Lock);
+    ++m_Users[std::string((const char*)key.pwdhash, sizeof key.pwdhash)];
+}
+
+void srt::CKekCache::release(const char* pwd, size_t pwd_len)
+{
+    Key key;
+    hashPassphrase(pwd, pwd_len, key.pwdhash);
+    const unsigned char* hash = key.pwdhash;
+
+    sync::ScopedLock lk(m_Lock);
+    std::map<std::string, int>::iterator u = m_Users.find(std::string((const char*)hash, sizeof key.pwdhash));
+    if (u == m_Users.end() || --u->second > 0)
+        return;
+    m_Users.erase(u);
+
+    for (std::list<Entry>::iterator i = m_Entries.begin(); i != m_Entries.end();)
+    {
+        if (memcmp(i->key.pwdhash, hash, sizeof key.pwdhash) == 0)
+        {
+            memset(i->kek, 0, sizeof i->kek);
+            i = m_Entries.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    for (std::deque<Pending>::iterator i = m_Pending.begin(); i != m_Pending.end();)
+    {
+        if (memcmp(i->key.pwdhash, hash, sizeof key.pwdhash) == 0)
+        {
+            memset(i->pwd, 0, sizeof i->pwd);
+            i = m_Pending.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+bool srt::CKekCache::findLocked(const Key& key, unsigned char* w_kek)
+{
+    for (std::list<Entry>::iterator i = m_Entries.begin(); i != m_Entries.end(); ++i)
+    {
+        if (i->key == key)
+        {
+            if (w_kek)
+                memcpy(w_kek, i->kek, key.kek_len);
+            m_Entries.splice(m_Entries.begin(), m_Entries, i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void srt::CKekCache::storeLocked(const Key& key, const unsigned char* kek)
+{
+    // Not kept for a passphrase that no socket uses (anymore).
+    if (m_Users.count(std::string((const char*)key.pwdhash, sizeof key.pwdhash)) == 0)
+        return;
+
+    if (findLocked(key, NULL))
+        return;
+
+    // Reuse the least recently used entry when full.
+    if (m_Entries.size() >= MAX_ENTRIES)
+        m_Entries.splice(m_Entries.begin(), m_Entries, --m_Entries.end());
+    else
+        m_Entries.push_front(Entry());
+
+    Entry& e = m_Entries.front();
+    e.key = key;
+    memcpy(e.kek, kek, key.kek_len);
+}
+
+int srt::CKekCache::derive(const char* pwd, size_t pwd_len, const unsigned char* salt, size_t salt_len,
+        int itr, size_t kek_len, unsigned char* w_kek)
+{
+#ifdef SRT_ENABLE_ENCRYPTION
+    KekCacheCryspr* kc = (KekCacheCryspr*)m_pCryspr;
+    Key key;
+    const bool cacheable = makeKey(pwd, pwd_len, salt, salt_len, itr, kek_len, (key));
+    if (cacheable)
+    {
+        sync::ScopedLock lk(m_Lock);
+        if (findLocked(key, w_kek))
+        {
+            ++m_iHits;
+            return 0;
+        }
+        ++m_iMisses;
+    }
+
+    // The cryspr implementations don't use the control block for PBKDF2.
+    const sync::steady_clock::time_point start = sync::steady_clock::now();
+    const int ret = kc->base_pbkdf2(NULL, (char*)pwd, pwd_len, (unsigned char*)salt, salt_len, itr, kek_len, w_kek);
+    const sync::steady_clock::duration cost = sync::steady_clock::now() - start;
+
+    sync::ScopedLock lk(m_Lock);
+    m_tdDeriveCost = (m_tdDeriveCost * 7 + cost) / 8;
+    if (ret == 0 && cacheable)
+        storeLocked(key, w_kek);
+    return ret;
+#else
+    (void)pwd; (void)pwd_len; (void)salt; (void)salt_len; (void)itr; (void)kek_len; (void)w_kek;
+    return -1;
+#endif
+}
+
+bool srt::CKekCache::prepare(const char* pwd, size_t pwd_len, const unsigned char* salt, size_t salt_len, size_t kek_len)
+{
+#ifdef SRT_ENABLE_ENCRYPTION
+    Pending p;
+    if (!makeKey(pwd, pwd_len, salt, salt_len, HAICRYPT_PBKDF2_ITER_CNT, kek_len, (p.key)))
+        return true;
+
+    sync::ScopedLock lk(m_Lock);
+    if (findLocked(p.key, NULL))
+        return true;
+
+    const sync::steady_clock::time_point now = sync::steady_clock::now();
+    if (now - m_tsBudgetStart >= sync::milliseconds_from(SYNC_PERIOD_MS))
+    {
+        m_tsBudgetStart = now;
+        m_tdBudgetUsed = sync::steady_clock::duration::zero();
+    }
+
+    if (m_tdBudgetUsed < sync::milliseconds_from(SYNC_BUDGET_MS))
+    {
+        m_tdBudgetUsed += m_tdDeriveCost;
+        return true;
+    }
+
+    if (m_bClosing)
+        return false;
+
+    for (std::deque<Pending>::iterator i = m_Pending.begin(); i != m_Pending.end(); ++i)
+    {
+        if (i->key == p.key)
+            return false; // A repeated request, already queued.
+    }
+
+    if (m_Pending.size() >= MAX_PENDING)
+    {
+        HLOGC(cnlog.Debug, log << "KekCache: too many derivations pending, request ignored");
+        return false;
+    }
+
+    if (!m_bThreadStarted)
+    {
+        if (!sync::StartThread(m_Thread, deriveThread, this, "SRT:KekDrv"))
+            return true; // Derive it in the receive worker then.
+        m_bThreadStarted = true;
+    }
+
+    memcpy(p.pwd, pwd, pwd_len);
+    p.pwd_len = pwd_len;
+    m_Pending.push_back(p);
+    ++m_iDeferred;
+    m_PendingCond.notify_one();
+    return false;
+#else
+    (void)pwd; (void)pwd_len; (void)salt; (void)salt_len; (void)kek_len;
+    return true;
+#endif
+}
+
+void srt::CKekCache::stop()
+{
+    {
+        sync::ScopedLock lk(m_Lock);
+        if (!m_bThreadStarted)
+            return;
+        m_bClosing = true;
+        m_PendingCond.notify_all();
+    }
+
+    m_Thread.join();
+
+    sync::ScopedLock lk(m_Lock);
+    for (std::deque<Pending>::iterator i = m_Pending.begin(); i != m_Pending.end(); ++i)
+        memset(i->pwd, 0, sizeof i->pwd);
+    m_Pending.clear();
+    m_bThreadStarted = false;
+    m_bClosing = false;
+}
+
+void srt::CKekCache::clear()
+{
+    sync::ScopedLock lk(m_Lock);
+    for (std::list<Entry>::iterator i = m_Entries.begin(); i != m_Entries.end(); ++i)
+        memset(i->kek, 0, sizeof i->kek);
+    m_Entries.clear();
+    m_iHits = m_iMisses = m_iDeferred = 0;
+    m_tdBudgetUsed = sync::steady_clock::duration::zero();
+}
+
+srt::CKekCache::Stats srt::CKekCache::stats()
+{
+    sync::ScopedLock lk(m_Lock);
+    Stats st;
+    st.entries = m_Entries.size();
+    st.hits = m_iHits;
+    st.misses = m_iMisses;
+    st.deferred = m_iDeferred;
+    return st;
+}
+
+void* srt::CKekCache::deriveThread(void* arg)
+{
+    CKekCache* self = (CKekCache*)arg;
+    THREAD_STATE_INIT("SRT:KekDrv");
+    self->deriveLoop();
+    THREAD_EXIT();
+    return NULL;
+}
+
+void srt::CKekCache::deriveLoop()
+{
+    sync::UniqueLock lk(m_Lock);
+    while (!m_bClosing)
+    {
+        if (m_Pending.empty())
+        {
+            m_PendingCond.wait(lk);
+            continue;
+        }
+
+        Pending p = m_Pending.front();
+        memset(m_Pending.front().pwd, 0, sizeof p.pwd);
+        m_Pending.pop_front();
+        {
+            sync::InvertedLock unlocked(m_Lock);
+            unsigned char kek[HAICRYPT_KEY_MAX_SZ];
+            derive(p.pwd, p.pwd_len, p.key.salt, p.key.salt_len, p.key.itr, p.key.kek_len, kek);
+            memset(kek, 0, sizeof kek);
+            memset(p.pwd, 0, sizeof p.pwd);
+        }
+    }
+}
+
 srt::EncryptionStatus srt::CCryptoControl::decrypt(CPacket& w_packet SRT_ATR_UNUSED)
 {
 #ifdef SRT_ENABLE_ENCRYPTION
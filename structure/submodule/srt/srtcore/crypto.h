@@ -18,12 +18,17 @@ written by
 
 #include <cstring>
 #include <string>
+#include <deque>
+#include <list>
+#include <map>
 
 // UDT
 #include "udt.h"
 #include "packet.h"
 #include "utilities.h"
 #include "logging.h"
+#include "sync.h"
+#include "atomic.h"
 
 #include <haicrypt.h>
 #include <hcrypt_msg.h>
@@ -42,7 +47,190 @@ namespace srt
 {
 class CUDT;
 struct CSrtConfig;
+class CCryptoControl;
 
+/// Threads encrypting packets ahead of their sending time for the
+/// sockets with SRTO_CRYPTOWORKERS set. One pool is shared by all
+/// sockets and it grows up to the highest number of workers requested.
+class CCryptoWorkerPool
+{
+public:
+    static const int MAX_WORKERS = 8;
+
+    /// Most slots of one crypto control encrypted by a worker at once.
+    static const int MAX_BATCH = 16;
+
+    CCryptoWorkerPool();
+    ~CCryptoWorkerPool();
+
+    /// Start more workers, if fewer than @a workers are running.
+    /// @return the number of running workers.
+    int reserve(int workers);
+
+    /// Schedule the encryption of a slot of the given crypto control.
+    void submit(CCryptoControl* ctrl, int slot);
+
+    /// Remove the jobs of the given crypto control from the queue
+    /// and wait until none of its jobs is being processed.
+    void cancel(CCryptoControl* ctrl);
+
+    /// Stop and join all workers. Queued jobs are dropped.
+    void stop();
+
+private:
+    struct Job
+    {
+        CCryptoControl* ctrl;
+        int slot;
+    };
+
+    struct Worker
+    {
+        CCryptoWorkerPool* pool;
+        CCryptoControl* current; //< control whose job is being processed
+        sync::CThread thread;
+    };
+
+    sync::Mutex m_Lock;
+    sync::Condition m_JobCond;  //< signaled when a job is queued or the pool stops
+    sync::Condition m_DoneCond; //< signaled when a worker finishes a job
+    std::deque<Job> m_Jobs;
+    Worker m_Workers[MAX_WORKERS];
+    int m_iWorkers;
+    bool m_bClosing;
+
+    static void* workerThread(void* arg);
+    void workerLoop(Worker& w);
+};
+
+/// Cache of the Key Encrypting Keys (KEK) derived from the passphrase.
+/// The PBKDF2 derivation is deliberately expensive and a listener does it
+/// for every caller, so during a storm of (re)connections it can keep
+/// the receive worker busy for long enough to have the handshakes time out.
+/// The cache is installed into HaiCrypt as the km_pbkdf2 method of the
+/// cryspr, so every derivation goes through it. The entries are keyed
+/// by the HMAC-MD5 of the passphrase with a random key of the cache (the
+/// passphrase itself is not kept, and the hash can't be tested against
+/// guessed passphrases out of the process), the salt and the key length.
+///
+/// Only the KEKs of a passphrase in use are kept: the sockets using one
+/// hold it with acquire() and release(), and the entries are wiped when
+/// the last one releases it. Beyond MAX_ENTRIES the least recently used
+/// entries are dropped.
+///
+/// The listener additionally limits the number of derivations done by
+/// the receive worker itself, see prepare().
+class CKekCache
+{
+public:
+    static const size_t MAX_ENTRIES = 128;
+
+    /// Time that the receive worker may spend deriving keys in every
+    /// SYNC_PERIOD_MS, estimated from the measured cost of a derivation;
+    /// the rest is left to the derivation thread.
+    static const int SYNC_BUDGET_MS = 25;
+    static const int SYNC_PERIOD_MS = 100;
+
+    /// Maximum number of derivations waiting for the derivation thread.
+    static const size_t MAX_PENDING = 64;
+
+    CKekCache();
+    ~CKekCache();
+
+    /// The cryspr to use for HaiCrypt, deriving the keys through this cache.
+    HaiCrypt_Cryspr cryspr();
+
+    /// Get the KEK from the cache or derive it and store it in the cache.
+    /// @return 0 on success, as the km_pbkdf2 method of the cryspr.
+    int derive(const char* pwd, size_t pwd_len, const unsigned char* salt, size_t salt_len,
+            int itr, size_t kek_len, unsigned char* w_kek);
+
+    /// Called by the receive worker for a connection request that will
+    /// need the KEK derived from the given passphrase and KM salt.
+    /// @return true if the connection may be processed now, that is,
+    /// the KEK is in the cache or the synchronous budget allows to derive
+    /// it. Otherwise the derivation is queued for the derivation thread
+    /// and the request should be ignored; the peer will repeat it.
+    bool prepare(const char* pwd, size_t pwd_len, const unsigned char* salt, size_t salt_len, size_t kek_len);
+
+    /// Mark the passphrase as used by one more socket. The KEKs derived
+    /// from a passphrase are cached only while it's in use.
+    void acquire(const char* pwd, size_t pwd_len);
+
+    /// Mark the passphrase as no longer used by a socket; when none uses
+    /// it anymore, its KEKs are wiped out of the cache.
+    void release(const char* pwd, size_t pwd_len);
+
+    /// Stop and join the derivation thread. Queued derivations are dropped.
+    void stop();
+
+    /// Drop all entries and reset the statistics.
+    void clear();
+
+    struct Stats
+    {
+        size_t entries;
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t deferred; //< derivations queued for the derivation thread
+    };
+    Stats stats();
+
+private:
+    struct Key
+    {
+        unsigned char pwdhash[16];
+        unsigned char salt[HAICRYPT_SALT_SZ];
+        size_t salt_len;
+        size_t kek_len;
+        int itr;
+
+        bool operator==(const Key& other) const;
+    };
+
+    struct Entry
+    {
+        Key key;
+        unsigned char kek[HAICRYPT_KEY_MAX_SZ];
+    };
+
+    struct Pending
+    {
+        Key key;
+        char pwd[HAICRYPT_SECRET_MAX_SZ];
+        size_t pwd_len;
+    };
+
+    // Returns false if the parameters can't be cached.
+    bool makeKey(const char* pwd, size_t pwd_len, const unsigned char* salt, size_t salt_len,
+            int itr, size_t kek_len, Key& w_key) const;
+    void hashPassphrase(const char* pwd, size_t pwd_len, unsigned char* w_hash) const;
+    bool findLocked(const Key& key, unsigned char* w_kek);
+    void storeLocked(const Key& key, const unsigned char* kek);
+
+    void* m_pCryspr; // see KekCacheCryspr in crypto.cpp
+
+    sync::Mutex m_Lock;
+    sync::Condition m_PendingCond;
+    std::list<Entry> m_Entries; //< most recently used first
+    std::map<std::string, int> m_Users; //< sockets using a passphrase, by its hash
+    unsigned char m_HashKey[16];        //< random key of the passphrase hash
+    std::deque<Pending> m_Pending;
+    sync::CThread m_Thread;
+    bool m_bThreadStarted;
+    bool m_bClosing;
+
+    sync::steady_clock::time_point m_tsBudgetStart;
+    sync::steady_clock::duration m_tdBudgetUsed;
+    sync::steady_clock::duration m_tdDeriveCost; //< smoothed duration of one derivation
+
+    uint64_t m_iHits;
+    uint64_t m_iMisses;
+    uint64_t m_iDeferred;
+
+    static void* deriveThread(void* arg);
+    void deriveLoop();
+};
 
 // For KMREQ/KMRSP. Only one field is used.
 const size_t SRT_KMR_KMSTATE = 0;
@@ -70,6 +258,7 @@ private:
     int m_iCryptoMode;
 
     HaiCrypt_Secret m_KmSecret;     //Key material shared secret
+    bool            m_bKekCacheHeld; //m_KmSecret acquired in the KEK cache
     // Sender
     sync::steady_clock::time_point m_SndKmLastTime;
     sync::Mutex m_mtxLock; // A mutex to protect concurrent access to CCryptoControl.
@@ -84,6 +273,55 @@ private:
 
     bool m_bErrorReported;
 
+public:
+    /// Number of packets that can be encrypted ahead. The slot of a packet
+    /// is its sequence number modulo this value.
+    static const int AHEAD_SLOTS = 64;
+
+private:
+    // Packets encrypted ahead by the worker pool (SRTO_CRYPTOWORKERS).
+    // A slot is selected by the packet's sequence number and moves through
+    // the AHEAD_* states; the application thread fills it, a worker encrypts
+    // it and the sending thread takes the ciphertext. Only AES-CTR packets
+    // are encrypted ahead; with AES-GCM the header is authenticated too.
+    enum AheadState { AHEAD_FREE, AHEAD_FILLING, AHEAD_QUEUED, AHEAD_BUSY, AHEAD_READY, AHEAD_TAKING };
+    struct AheadSlot
+    {
+        sync::atomic<int> state;
+        int32_t seqno;
+        int     kflg;     //< key flags the slot was encrypted with
+        int     keyepoch; //< m_iSndKeyEpoch at the time of encryption
+        size_t  length;
+        char*   data;
+    };
+    CCryptoWorkerPool* m_pAheadPool; // [[using locked(m_mtxAheadPoolLock)]]
+    sync::Mutex m_mtxAheadPoolLock;  // orders submitAhead with close
+    sync::atomic<bool> m_bAheadEnabled;
+
+    // Held by a worker encrypting with the HaiCrypt context for encrypting
+    // ahead, so that m_mtxLock, and so the sender, is not held meanwhile.
+    sync::Mutex m_mtxAheadLock;
+    size_t m_zAheadSlotSize;
+    std::vector<char> m_AheadStorage;
+    AheadSlot m_AheadSlots[AHEAD_SLOTS];
+
+    // The last sequence number passed to encrypt(). Slots with packets
+    // that are not after it won't be needed anymore.
+    sync::atomic<int32_t> m_iAheadLastSeq;
+
+    // Incremented by regenCryptoKm when a new key is generated.
+    sync::atomic<int> m_iSndKeyEpoch;
+
+    // Packets sent as encrypted ahead, not yet counted for the key
+    // refresh. The workers encrypt without counting, as the packet
+    // may still be encrypted again with a new key when sent.
+    sync::atomic<int> m_iAheadUncounted;
+
+    bool aheadStale(int32_t seqno) const;
+    bool takeAhead(CPacket& w_packet);
+    void countAheadSent(); // [[using locked(m_mtxLock)]]
+    EncryptionStatus encryptPacket(CPacket& w_packet);
+
 public:
     static void globalInit();
 
@@ -138,6 +376,9 @@ public:
     int processSrtMsg_KMRSP(const uint32_t* srtdata, size_t len, int hsv);
     void createFakeSndContext();
 
+    /// Check if sendKeysToPeer() may still resend a KM request to the peer.
+    bool isKmRetryPending() const { return m_SndKmMsg[0].iPeerRetry > 0 || m_SndKmMsg[1].iPeerRetry > 0; }
+
     const unsigned char* getKmMsg_data(size_t ki) const { return m_SndKmMsg[ki].Msg; }
     size_t getKmMsg_size(size_t ki) const { return m_SndKmMsg[ki].MsgLen; }
 
@@ -268,6 +509,20 @@ public:
     /// field in the header must be correctly set before calling.
     EncryptionStatus encrypt(CPacket& w_packet);
 
+    /// Turn on encryption ahead of the sending time, done by the
+    /// given pool with at least @a workers threads. Payloads longer
+    /// than @a max_payload are always encrypted when being sent.
+    void enableAhead(CCryptoWorkerPool* pool, int workers, size_t max_payload);
+
+    /// Pass the plaintext of the packet scheduled with the given
+    /// sequence number to the worker pool. Called by the application
+    /// thread after the packet has been added to the sender buffer.
+    void submitAhead(int32_t seqno, const char* data, size_t len);
+
+    /// Encrypt the packets in the given @a n slots, at most
+    /// CCryptoWorkerPool::MAX_BATCH, at once. Called by the worker pool.
+    void encryptAhead(const int* slots, int n);
+
     /// Decrypts the packet. If the packet has ENCKEYSPEC part
     /// in PH_MSGNO set to EK_NOENC, it does nothing. It decrypts
     /// only if the encryption correctly configured, otherwise it
@@ -866,6 +866,9 @@ int srt::CEPoll::release(const int eid)
 }
 
 
+const int srt::CEPollSubscribers::STATE_UNKNOWN;
+const int srt::CEPollSubscribers::STATE_NOSUBS;
+
 int srt::CEPoll::update_events(const SRTSOCKET& uid, std::set<int>& eids, const int events, const bool enable)
 {
     // As event flags no longer contain only event types, check now.
@@ -875,14 +878,55 @@ int srt::CEPoll::update_events(const SRTSOCKET& uid, std::set<int>& eids, const
         return -1; // still, ignored.
     }
 
+    ScopedLock pg (m_EPollLock);
+    return update_events_LOCKED(uid, eids, events, enable, NULL);
+}
+
+int srt::CEPoll::update_events(const SRTSOCKET& uid, CEPollSubscribers& eids, const int events, const bool enable)
+{
+    if ((events & ~SRT_EPOLL_EVENTTYPES) != 0)
+    {
+        LOGC(eilog.Fatal, log << "epoll/update: IPE: 'events' parameter shall not contain special flags!");
+        return -1; // still, ignored.
+    }
+
+    // Fast path: all subscribers have already the state that this
+    // update would set, or there are no subscribers at all.
+    const int known = eids.state();
+    if (known == CEPollSubscribers::STATE_NOSUBS)
+        return 0;
+
+    if (known != CEPollSubscribers::STATE_UNKNOWN)
+    {
+        const int newstate = enable ? known | events : known & ~events;
+        if (newstate == known)
+            return 0;
+    }
+
+    ScopedLock pg (m_EPollLock);
+    return update_events_LOCKED(uid, eids, events, enable, &eids);
+}
+
+int srt::CEPoll::update_events_LOCKED(const SRTSOCKET& uid, std::set<int>& eids, const int events, const bool enable,
+                                      CEPollSubscribers* subs)
+{
     int nupdated = 0;
     vector<int> lost;
 
+    // The cached state is about to become outdated. An update coming
+    // on the fast path while this one is in progress has to wait for
+    // the lock and be applied after it, not compared with the old state.
+    if (subs)
+        subs->state(CEPollSubscribers::STATE_UNKNOWN);
+
+    // The state common for all subscribers, as it results from this update.
+    // It stays STATE_NOSUBS if there are no subscribers.
+    int common_state = CEPollSubscribers::STATE_NOSUBS;
+
     IF_HEAVY_LOGGING(ostringstream debug);
     IF_HEAVY_LOGGING(debug << "epoll/update: @" << uid << " " << (enable ? "+" : "-"));
     IF_HEAVY_LOGGING(PrintEpollEvent(debug, events));
 
-    ScopedLock pg (m_EPollLock);
     for (set<int>::iterator i = eids.begin(); i != eids.end(); ++ i)
     {
         map<int, CEPollDesc>::iterator p = m_mPolls.find(*i);
@@ -904,9 +948,20 @@ int srt::CEPoll::update_events(const SRTSOCKET& uid, std::set<int>& eids, const
             // As this is mapped in the socket's data, it should be impossible.
             LOGC(eilog.Error, log << "epoll/update: IPE: update struck E"
                     << (*i) << " which is NOT SUBSCRIBED to @" << uid);
+            common_state = CEPollSubscribers::STATE_UNKNOWN;
             continue;
         }
 
+        // The state of this subscriber after the update is known
+        // already here, the rest only updates the notices.
+        {
+            const int newstate = enable ? pwait->state | events : pwait->state & (~events);
+            if (common_state == CEPollSubscribers::STATE_NOSUBS)
+                common_state = newstate;
+            else if (common_state != newstate)
+                common_state = CEPollSubscribers::STATE_UNKNOWN;
+        }
+
         IF_HEAVY_LOGGING(string tracking = " TRACKING: " + ed.DisplayEpollWatch());
         // compute new states
 
@@ -948,6 +1003,9 @@ int srt::CEPoll::update_events(const SRTSOCKET& uid, std::set<int>& eids, const
     for (vector<int>::iterator i = lost.begin(); i != lost.end(); ++ i)
         eids.erase(*i);
 
+    if (subs)
+        subs->state(common_state);
+
     return nupdated;
 }
 
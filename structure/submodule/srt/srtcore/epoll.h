@@ -56,8 +56,9 @@ modified by
 
 #include <map>
 #include <set>
-#include <list>
 #include "udt.h"
+#include "sync.h"
+#include "atomic.h"
 
 namespace srt
 {
@@ -67,6 +68,60 @@ class CRendezvousQueue;
 class CUDTGroup;
 
 
+/// The set of EIDs that a socket or a group reports its events to.
+///
+/// Additionally it caches the event state that was last applied to all
+/// of these EIDs by CEPoll::update_events(). An update that wouldn't change
+/// this state - which is what happens for nearly every incoming packet or
+/// ACK of an already readable or writable socket - then costs one atomic
+/// read and doesn't lock m_EPollLock. The cache is reset whenever the set
+/// is modified, which must be done with m_EPollLock locked, and for the
+/// time of every update that locks it, so that an update skipped on the
+/// fast path is always one that would be void before the locked one.
+class CEPollSubscribers: public std::set<int>
+{
+public:
+    static const int STATE_UNKNOWN = -1; // EIDs' states unknown or differ
+    static const int STATE_NOSUBS  = -2; // no EIDs, every update is void
+
+    CEPollSubscribers()
+        : m_iState(STATE_NOSUBS)
+    {
+    }
+
+    CEPollSubscribers(const CEPollSubscribers& src)
+        : std::set<int>(src)
+        , m_iState(STATE_UNKNOWN)
+    {
+    }
+
+    std::pair<iterator, bool> insert(int eid)
+    {
+        m_iState = STATE_UNKNOWN;
+        return std::set<int>::insert(eid);
+    }
+
+    size_type erase(int eid)
+    {
+        m_iState = STATE_UNKNOWN;
+        return std::set<int>::erase(eid);
+    }
+
+    void clear()
+    {
+        m_iState = STATE_UNKNOWN;
+        std::set<int>::clear();
+    }
+
+    int  state() const { return m_iState; }
+    void state(int st) { m_iState = st; }
+
+private:
+    CEPollSubscribers& operator=(const CEPollSubscribers&);
+
+    sync::atomic<int> m_iState;
+};
+
 class CEPollDesc
 {
 #ifdef __GNUG__
@@ -80,17 +135,77 @@ class CEPollDesc
    {
        Wait* parent;
 
-       Notice(Wait* p, SRTSOCKET sock, int ev): parent(p)
+       // Links in the intrusive list of notices (`m_USockEventNotice`).
+       Notice* prev;
+       Notice* next;
+
+       Notice(): parent(NULL), prev(NULL), next(NULL)
        {
-           fd = sock;
-           events = ev;
+           fd = SRT_INVALID_SOCK;
+           events = 0;
        }
    };
 
-   /// The type for `m_USockEventNotice`, the pair contains:
-   /// * The back-pointer to the subscriber object for which this event notice serves
-   /// * The events currently being on
-   typedef std::list<Notice> enotice_t;
+   /// The type for `m_USockEventNotice`. This is an intrusive list
+   /// of notice objects that are embedded in the `Wait` objects, so
+   /// signalling an event on a socket doesn't allocate anything, and
+   /// taking the notice out of the list doesn't require any search.
+   /// The interface follows std::list as far as it is used here.
+   class enotice_t
+   {
+       Notice m_Head; // sentinel, not a real notice
+
+   public:
+       class iterator
+       {
+           Notice* m_p;
+
+       public:
+           explicit iterator(Notice* p = NULL): m_p(p) {}
+
+           Notice& operator*() const { return *m_p; }
+           Notice* operator->() const { return m_p; }
+           iterator& operator++() { m_p = m_p->next; return *this; }
+           iterator operator++(int) { iterator old = *this; m_p = m_p->next; return old; }
+           bool operator==(const iterator& i) const { return m_p == i.m_p; }
+           bool operator!=(const iterator& i) const { return m_p != i.m_p; }
+       };
+
+       enotice_t() { m_Head.prev = m_Head.next = &m_Head; }
+
+       // Copying is only used when inserting a new (empty) descriptor
+       // into the container; the notices are never shared.
+       enotice_t(const enotice_t&) { m_Head.prev = m_Head.next = &m_Head; }
+
+       iterator begin() { return iterator(m_Head.next); }
+       iterator end() { return iterator(&m_Head); }
+       bool empty() const { return m_Head.next == &m_Head; }
+
+       void push_back(Notice& n)
+       {
+           n.prev = m_Head.prev;
+           n.next = &m_Head;
+           m_Head.prev->next = &n;
+           m_Head.prev = &n;
+       }
+
+       void erase(iterator i)
+       {
+           Notice& n = *i;
+           n.prev->next = n.next;
+           n.next->prev = n.prev;
+           n.prev = n.next = NULL;
+       }
+
+       void clear()
+       {
+           while (!empty())
+               erase(begin());
+       }
+
+   private:
+       enotice_t& operator=(const enotice_t&);
+   };
 
    struct Wait
    {
@@ -111,9 +226,12 @@ class CEPollDesc
        /// subscription mode for the event.
        int32_t state;
 
-       /// The iterator to `m_USockEventNotice` container that contains the
-       /// event notice object for this subscription, or the value from
-       /// `nullNotice()` if there is no such object.
+       /// The event notice object for this subscription. It is linked
+       /// into `m_USockEventNotice` as long as any watched event is on.
+       Notice notice;
+
+       /// The iterator to `m_USockEventNotice` container that points to
+       /// `notice`, or the value from `nullNotice()` if it isn't there.
        enotice_t::iterator notit;
 
        Wait(explicit_t<int32_t> sub, explicit_t<int32_t> etr, enotice_t::iterator i)
@@ -200,8 +318,6 @@ std::string DisplayEpollWatch();
    // Container accessors for enotice_t.
    enotice_t::iterator enotice_begin() { return m_USockEventNotice.begin(); }
    enotice_t::iterator enotice_end() { return m_USockEventNotice.end(); }
-   enotice_t::const_iterator enotice_begin() const { return m_USockEventNotice.begin(); }
-   enotice_t::const_iterator enotice_end() const { return m_USockEventNotice.end(); }
    bool enotice_empty() const { return m_USockEventNotice.empty(); }
 
    const int m_iLocalID;                           // local system epoll ID
@@ -222,9 +338,13 @@ std::string DisplayEpollWatch();
 
        if (wait.notit == nullNotice()) // No notice object
        {
-           // Add new event notice and bind to the wait object.
-           m_USockEventNotice.push_back(Notice(&wait, sock, events));
-           wait.notit = --m_USockEventNotice.end();
+           // Link the notice embedded in the wait object.
+           Notice& n = wait.notice;
+           n.parent = &wait;
+           n.fd = sock;
+           n.events = events;
+           m_USockEventNotice.push_back(n);
+           wait.notit = enotice_t::iterator(&n);
 
            return;
        }
@@ -489,9 +609,16 @@ public: // for CUDT to acknowledge IO status
 
    int update_events(const SRTSOCKET& uid, std::set<int>& eids, int events, bool enable);
 
+   /// Same as above, but for the EIDs subscribed to a socket or group.
+   /// This one returns immediately without locking if the cached state
+   /// of the subscribers shows that there's nothing to change.
+   int update_events(const SRTSOCKET& uid, CEPollSubscribers& eids, int events, bool enable);
+
    int setflags(const int eid, int32_t flags);
 
 private:
+   int update_events_LOCKED(const SRTSOCKET& uid, std::set<int>& eids, int events, bool enable, CEPollSubscribers* subs);
+
    int m_iIDSeed;                            // seed to generate a new ID
    srt::sync::Mutex m_SeedLock;
 
@@ -13,9 +13,19 @@
 #include <string>
 #include <map>
 #include <vector>
-#include <deque>
 #include <iterator>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SRT_FEC_XOR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// AVX2 is used only when the CPU supports it, checked at runtime.
+#if SRT_FEC_XOR_SSE2 && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SRT_FEC_XOR_AVX2 1
+#include <immintrin.h>
+#endif
+
 #include "packetfilter.h"
 #include "core.h"
 #include "packet.h"
@@ -37,6 +47,74 @@ using namespace srt_logging;
 
 namespace srt {
 
+namespace {
+
+// XOR the src buffer into dst. The kernel is selected once,
+// depending on what the CPU supports.
+typedef void xor_clip_fn(char* dst, const char* src, size_t len);
+
+void XorClipScalar(char* dst, const char* src, size_t len)
+{
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8)
+    {
+        uint64_t d, s;
+        memcpy(&d, dst + i, 8);
+        memcpy(&s, src + i, 8);
+        d ^= s;
+        memcpy(dst + i, &d, 8);
+    }
+    for (; i < len; ++i)
+        dst[i] ^= src[i];
+}
+
+#if SRT_FEC_XOR_SSE2
+void XorClipSSE2(char* dst, const char* src, size_t len)
+{
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d, s));
+    }
+    XorClipScalar(dst + i, src + i, len - i);
+}
+#endif
+
+#if SRT_FEC_XOR_AVX2
+__attribute__((target("avx2")))
+void XorClipAVX2(char* dst, const char* src, size_t len)
+{
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32)
+    {
+        const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(d, s));
+    }
+    XorClipSSE2(dst + i, src + i, len - i);
+}
+#endif
+
+xor_clip_fn* SelectXorClip()
+{
+#if SRT_FEC_XOR_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return &XorClipAVX2;
+#endif
+#if SRT_FEC_XOR_SSE2
+    return &XorClipSSE2;
+#else
+    return &XorClipScalar;
+#endif
+}
+
+xor_clip_fn* const XorClip = SelectXorClip();
+
+} // namespace
+
 const char FECFilterBuiltin::defaultConfig [] = "fec,rows:1,layout:staircase,arq:onreq";
 
 struct StringKeys
@@ -216,7 +294,13 @@ FECFilterBuiltin::FECFilterBuiltin(const SrtFilterInitializer &init, std::vector
     // Setup the bit matrix, initialize everything with false.
 
     // Vertical size (y)
-    rcv.cells.resize(sizeCol() * sizeRow(), false);
+    rcv.cells.resize(sizeCol() * sizeRow());
+
+    // Normally the receiver keeps up to two series of groups; more
+    // is possible, just the containers would have to grow then.
+    rcv.cells.reserve(2 * sizeCol() * sizeRow());
+    rcv.rowq.reserve(2 * numberRows() + 1);
+    rcv.colq.reserve(2 * numberCols() + 1);
 
     // These sequence numbers are both the value of ISN-1 at the moment
     // when the handshake is done. The sender ISN is generated here, the
@@ -602,17 +686,12 @@ void FECFilterBuiltin::ClipData(Group& g, uint16_t length_net, uint8_t kflg,
             << " to a clip buffer size=" << payloadSize());
 
     // Payload goes "as is".
-    for (size_t i = 0; i < payload_size; ++i)
-    {
-        g.payload_clip[i] = g.payload_clip[i] ^ payload[i];
-    }
+    XorClip(&g.payload_clip[0], payload, payload_size);
 
-    // Fill the rest with zeros. When this packet is going to be
-    // recovered, the payload extracted from this process will have
-    // the maximum length, but it will be cut to the right length
-    // and these padding 0s taken out.
-    for (size_t i = payload_size; i < payloadSize(); ++i)
-        g.payload_clip[i] = g.payload_clip[i] ^ 0;
+    // The rest is treated as filled with zeros, which leaves the clip
+    // unchanged. When this packet is going to be recovered, the payload
+    // extracted from this process will have the maximum length, but it
+    // will be cut to the right length and these padding 0s taken out.
 }
 
 bool FECFilterBuiltin::packControlPacket(SrtPacket& rpkt, int32_t seq)
@@ -1100,7 +1179,7 @@ void FECFilterBuiltin::CollectIrrecoverRow(RcvGroup& g, loss_seqs_t& irrecover)
 }
 
 #if ENABLE_HEAVY_LOGGING
-static inline char CellMark(const std::deque<bool>& cells, int index)
+static inline char CellMark(const FECCellBits& cells, int index)
 {
     if (index >= int(cells.size()))
         return '/';
@@ -1108,7 +1187,7 @@ static inline char CellMark(const std::deque<bool>& cells, int index)
     return cells[index] ? '#' : '.';
 }
 
-static void DebugPrintCells(int32_t base, const std::deque<bool>& cells, size_t row_size)
+static void DebugPrintCells(int32_t base, const FECCellBits& cells, size_t row_size)
 {
     size_t i = 0;
     // Shift to the first empty cell
@@ -1141,7 +1220,7 @@ static void DebugPrintCells(int32_t base, const std::deque<bool>& cells, size_t
     }
 }
 #else
-static void DebugPrintCells(int32_t /*base*/, const std::deque<bool>& /*cells*/, size_t /*row_size*/) {}
+static void DebugPrintCells(int32_t /*base*/, const FECCellBits& /*cells*/, size_t /*row_size*/) {}
 #endif
 
 FECFilterBuiltin::EHangStatus FECFilterBuiltin::HangHorizontal(const CPacket& rpkt, bool isfec, loss_seqs_t& irrecover)
@@ -1285,8 +1364,8 @@ FECFilterBuiltin::EHangStatus FECFilterBuiltin::HangHorizontal(const CPacket& rp
                         << " AND " << npktremove << " CELLS, base switch %"
                         << rcv.cell_base << " -> %" << rcv.rowq[past].base);
 
-                rcv.rowq.erase(rcv.rowq.begin(), rcv.rowq.begin() + nrowremove);
-                rcv.cells.erase(rcv.cells.begin(), rcv.cells.begin() + ersize);
+                rcv.rowq.erase_front(nrowremove);
+                rcv.cells.erase_front(ersize);
 
                 // We state that we have removed as many cells as for the removed
                 // rows. In case when the number of cells proved to be less than that,
@@ -1660,7 +1739,7 @@ void FECFilterBuiltin::MarkCellReceived(int32_t seq, ECellReceived is_received)
         // Resize normally up to the required size, just set the lastmost
         // item to true.
         resized = true;
-        rcv.cells.resize(cell_offset+1, false);
+        rcv.cells.resize(cell_offset+1);
     }
 
     if (resized || is_received != CELL_EXTEND)
@@ -1668,7 +1747,7 @@ void FECFilterBuiltin::MarkCellReceived(int32_t seq, ECellReceived is_received)
         // In both RECEIVED and REMOVE cases, forcefully set the value always.
         // In EXTEND, only if it was received
         // Value set should be true only if RECEIVED, false otherwise
-        rcv.cells[cell_offset] = (is_received == CELL_RECEIVED);
+        rcv.cells.set(cell_offset, is_received == CELL_RECEIVED);
     }
 
 #if ENABLE_HEAVY_LOGGING
@@ -1804,7 +1883,7 @@ bool FECFilterBuiltin::CheckEmergencyShrink(size_t n_series, size_t size_in_pack
     else
     {
         HLOGC(pflog.Debug, log << "FEC: Shifting rcv row %" << oldbase << " -> %" << newbase);
-        rcv.rowq.erase(rcv.rowq.begin(), rcv.rowq.begin() + shift_rows);
+        rcv.rowq.erase_front(shift_rows);
     }
 
     const size_t shift_cols = shift_series * numberCols();
@@ -1830,7 +1909,7 @@ bool FECFilterBuiltin::CheckEmergencyShrink(size_t n_series, size_t size_in_pack
 
     if (rcv.cells.size() > shift)
     {
-        rcv.cells.erase(rcv.cells.begin(), rcv.cells.begin() + shift);
+        rcv.cells.erase_front(shift);
     }
     else
     {
@@ -2083,7 +2162,7 @@ void FECFilterBuiltin::RcvCheckDismissColumn(int32_t seq, int colgx, loss_seqs_t
                 << " AND " << matrix_size << " cells");
 
         // ensured existence of the removed range: see COND 2 above.
-        rcv.colq.erase(rcv.colq.begin(), rcv.colq.begin() + numberCols());
+        rcv.colq.erase_front(numberCols());
 
 #if ENABLE_HEAVY_LOGGING
         LOGC(pflog.Debug, log << "FEC: COL STATS BEFORE: n=" << rcv.colq.size());
@@ -2121,7 +2200,7 @@ void FECFilterBuiltin::RcvCheckDismissColumn(int32_t seq, int colgx, loss_seqs_t
         {
             // Remove "legally" a matrix of rows.
             // ensured existence of the removed range: see COND 3 above
-            rcv.rowq.erase(rcv.rowq.begin(), rcv.rowq.begin() + numberRows());
+            rcv.rowq.erase_front(numberRows());
         }
 
         // And now accordingly remove cells. Exactly one matrix of cells.
@@ -2137,14 +2216,14 @@ void FECFilterBuiltin::RcvCheckDismissColumn(int32_t seq, int colgx, loss_seqs_t
             if (shift < 0 || size_t(shift) > rcv.cells.size())
                 rcv.cells.clear();
             else
-                rcv.cells.erase(rcv.cells.begin(), rcv.cells.begin() + shift);
+                rcv.cells.erase_front(shift);
         }
         else
         {
             if (rcv.cells.size() <= size_t(matrix_size))
                 rcv.cells.clear();
             else
-                rcv.cells.erase(rcv.cells.begin(), rcv.cells.begin() + matrix_size);
+                rcv.cells.erase_front(matrix_size);
         }
         rcv.cell_base = newbase;
         DebugPrintCells(rcv.cell_base, rcv.cells, sizeRow());
@@ -2186,7 +2265,7 @@ void FECFilterBuiltin::RcvCheckDismissColumn(int32_t seq, int colgx, loss_seqs_t
     {
     any_dismiss = true;
     int32_t newbase = rcv.colq[numberCols()].base;
-    rcv.colq.erase(rcv.colq.begin(), rcv.colq.begin() + numberCols());
+    rcv.colq.erase_front(numberCols());
 
     // colgx is INVALIDATED after removal
     int newcolgx SRT_ATR_UNUSED = colgx - numberCols();
@@ -2209,7 +2288,7 @@ void FECFilterBuiltin::RcvCheckDismissColumn(int32_t seq, int colgx, loss_seqs_t
     {
     if (CSeqNo::seqoff(newbase, rcv.rowq[r].base) >= 0)
     {
-    rcv.rowq.erase(rcv.rowq.begin(), rcv.rowq.begin() + r);
+    rcv.rowq.erase_front(r);
     nrowrem = r;
     break;
     }
@@ -2217,7 +2296,7 @@ void FECFilterBuiltin::RcvCheckDismissColumn(int32_t seq, int colgx, loss_seqs_t
     }
     else
     {
-    rcv.rowq.erase(rcv.rowq.begin(), rcv.rowq.begin() + numberRows());
+    rcv.rowq.erase_front(numberRows());
     nrowrem = numberRows();
     }
     }
@@ -2255,7 +2334,7 @@ void FECFilterBuiltin::RcvCheckDismissColumn(int32_t seq, int colgx, loss_seqs_t
                     << rcv.cell_base << " - %" << newbase
                     << ", losses collected: " << Printable(loss));
 
-            rcv.cells.erase(rcv.cells.begin(), rcv.cells.begin() + nrem);
+            rcv.cells.erase_front(nrem);
             rcv.cell_base = newbase;
 
             DebugPrintCells(rcv.cell_base, rcv.cells, sizeRow());
@@ -15,12 +15,178 @@
 #include <string>
 #include <map>
 #include <vector>
-#include <deque>
+#include <algorithm>
 
 #include "packetfilter_api.h"
 
 namespace srt {
 
+// Queue of groups kept in a ring of slots that are reused when the
+// queue moves forward, so that the clip buffers of the groups aren't
+// reallocated. The capacity is a power of two and grows when needed.
+// Value::recycle() is called on a slot when it's taken back into use.
+template <class Value>
+class FECGroupRing
+{
+public:
+    FECGroupRing(): m_iFirst(0), m_iSize(0) {}
+
+    size_t size() const { return m_iSize; }
+    bool empty() const { return m_iSize == 0; }
+
+    Value& operator[](size_t index) { return m_aSlots[(m_iFirst + index) & (m_aSlots.size() - 1)]; }
+    const Value& operator[](size_t index) const { return m_aSlots[(m_iFirst + index) & (m_aSlots.size() - 1)]; }
+
+    void reserve(size_t n)
+    {
+        if (n > m_aSlots.size())
+            grow(n);
+    }
+
+    void resize(size_t n)
+    {
+        reserve(n);
+        for (size_t i = m_iSize; i < n; ++i)
+            (*this)[i].recycle();
+        m_iSize = n;
+    }
+
+    void clear()
+    {
+        m_iFirst = 0;
+        m_iSize  = 0;
+    }
+
+    void erase_front(size_t n)
+    {
+        SRT_ASSERT(n <= m_iSize);
+        m_iFirst = (m_iFirst + n) & (m_aSlots.size() - 1);
+        m_iSize -= n;
+    }
+
+private:
+    void grow(size_t n)
+    {
+        size_t cap = m_aSlots.empty() ? 8 : m_aSlots.size();
+        while (cap < n)
+            cap *= 2;
+
+        std::vector<Value> slots(cap);
+        for (size_t i = 0; i < m_aSlots.size(); ++i)
+            std::swap(slots[i], (*this)[i]);
+        m_aSlots.swap(slots);
+        m_iFirst = 0;
+    }
+
+    std::vector<Value> m_aSlots;
+    size_t m_iFirst;
+    size_t m_iSize;
+};
+
+// Bit per cell, kept in a ring the same way as FECGroupRing.
+// Bits outside the used range are always clear.
+class FECCellBits
+{
+public:
+    FECCellBits(): m_iFirst(0), m_iSize(0) {}
+
+    size_t size() const { return m_iSize; }
+
+    bool operator[](size_t index) const
+    {
+        const size_t pos = (m_iFirst + index) & mask();
+        return (m_aWords[pos / WORD_BITS] >> (pos % WORD_BITS)) & 1;
+    }
+
+    void set(size_t index, bool value)
+    {
+        const size_t pos = (m_iFirst + index) & mask();
+        const uint64_t bit = uint64_t(1) << (pos % WORD_BITS);
+        if (value)
+            m_aWords[pos / WORD_BITS] |= bit;
+        else
+            m_aWords[pos / WORD_BITS] &= ~bit;
+    }
+
+    void reserve(size_t n)
+    {
+        if (n > capacity())
+            grow(n);
+    }
+
+    // New cells are clear.
+    void resize(size_t n)
+    {
+        if (n < m_iSize)
+            clearBits(n, m_iSize - n);
+        reserve(n);
+        m_iSize = n;
+    }
+
+    void push_back(bool value)
+    {
+        resize(m_iSize + 1);
+        set(m_iSize - 1, value);
+    }
+
+    void clear()
+    {
+        std::fill(m_aWords.begin(), m_aWords.end(), 0);
+        m_iFirst = 0;
+        m_iSize  = 0;
+    }
+
+    void erase_front(size_t n)
+    {
+        SRT_ASSERT(n <= m_iSize);
+        clearBits(0, n);
+        m_iFirst = (m_iFirst + n) & mask();
+        m_iSize -= n;
+    }
+
+private:
+    static const size_t WORD_BITS = 64;
+
+    size_t capacity() const { return m_aWords.size() * WORD_BITS; }
+    size_t mask() const { return capacity() - 1; }
+
+    void clearBits(size_t index, size_t count)
+    {
+        while (count > 0)
+        {
+            const size_t pos   = (m_iFirst + index) & mask();
+            const size_t off   = pos % WORD_BITS;
+            const size_t nbits = std::min(WORD_BITS - off, count);
+            const uint64_t m   = (nbits == WORD_BITS ? ~uint64_t(0) : ((uint64_t(1) << nbits) - 1)) << off;
+            m_aWords[pos / WORD_BITS] &= ~m;
+            index += nbits;
+            count -= nbits;
+        }
+    }
+
+    void grow(size_t n)
+    {
+        size_t cap = m_aWords.empty() ? WORD_BITS : capacity();
+        while (cap < n)
+            cap *= 2;
+
+        FECCellBits bigger;
+        bigger.m_aWords.resize(cap / WORD_BITS, 0);
+        bigger.m_iSize = m_iSize;
+        for (size_t i = 0; i < m_iSize; ++i)
+        {
+            if ((*this)[i])
+                bigger.set(i, true);
+        }
+        m_aWords.swap(bigger.m_aWords);
+        m_iFirst = 0;
+    }
+
+    std::vector<uint64_t> m_aWords;
+    size_t m_iFirst;
+    size_t m_iSize;
+};
+
 class FECFilterBuiltin: public SrtPacketFilterBase
 {
     SrtFilterConfig cfg;
@@ -84,6 +250,19 @@ public:
         bool dismissed;
         RcvGroup(): fec(false), dismissed(false) {}
 
+        // Make the group as if freshly constructed, except that the clip
+        // buffer stays allocated. It is zeroed, as ConfigureGroup() expects.
+        void recycle()
+        {
+            base = SRT_SEQNO_NONE;
+            step = 0;
+            drop = 0;
+            collected = 0;
+            std::fill(payload_clip.begin(), payload_clip.end(), 0);
+            fec = false;
+            dismissed = false;
+        }
+
 #if ENABLE_HEAVY_LOGGING
         std::string DisplayStats()
         {
@@ -125,10 +304,9 @@ private:
         // for possible later tracking. A horizontal group should be dismissed
         // when the size of this container exceeds the `m_number_rows` (size of the column).
         //
-        // The 'std::deque' type is used here for a trial implementation. A desired solution
-        // would be a kind of a ring buffer where new groups are added and old (exceeding
-        // the size) automatically dismissed.
-        std::deque<RcvGroup> rowq;
+        // Groups are kept in a ring, so dismissing the oldest
+        // groups and adding new ones reuses their buffers.
+        FECGroupRing<RcvGroup> rowq;
 
         // Base index at the oldest column platform determines
         // the base index of the queue. Meaning, first you need
@@ -143,15 +321,15 @@ private:
         // /number-series. The latter multiplied by the row size
         // is the offset between the firstmost column and the
         // searched column.
-        std::deque<RcvGroup> colq;
+        FECGroupRing<RcvGroup> colq;
 
         // This keeps the value of "packet received or not".
         // The sequence number of the first cell is rowq[0].base.
         // When dropping a row,
         // - the firstmost element of rowq is removed
-        // - the length of one row is removed from this std::vector
+        // - the length of one row is removed from this container
         int32_t cell_base;
-        std::deque<bool> cells;
+        FECCellBits cells;
 
         // Note this function will automatically extend the container
         // with empty cells if the index exceeds the size, HOWEVER
@@ -163,7 +341,7 @@ private:
             {
                 // Cells not prepared for this sequence yet,
                 // so extend in advance.
-                cells.resize(index+1, false);
+                cells.resize(index+1);
                 return false; // It wasn't marked, anyway.
             }
 
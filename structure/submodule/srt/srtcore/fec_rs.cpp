@@ -0,0 +1,855 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2026 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#include "platform_sys.h"
+
+#include <string>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// SSSE3 and AVX2 are used only when the CPU supports it, checked at runtime.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SRT_FEC_RS_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+#include "packetfilter.h"
+#include "core.h"
+#include "packet.h"
+#include "logging.h"
+
+#include "fec_rs.h"
+
+// Number of blocks the receiver keeps. When a packet comes in for a
+// block that doesn't fit in this history, the oldest blocks are dismissed
+// and their lacking packets reported as irrecoverable.
+#define SRT_FEC_RS_RCV_HISTORY 2
+
+// Range of the number of windows within the loss target required before
+// the adaptive mode with arq:onreq decreases the number of parity packets.
+// It's doubled every time a decrease is followed by an increase.
+#define SRT_FEC_RS_ADAPT_HOLD_MIN 3
+#define SRT_FEC_RS_ADAPT_HOLD_MAX 48
+
+using namespace std;
+using namespace srt_logging;
+
+namespace srt {
+
+namespace {
+
+// Arithmetic in GF(2^8) with the 0x11D polynomial.
+struct GF256
+{
+    uint8_t exp[512];
+    uint8_t log[256];
+    uint8_t mul[256][256];
+
+    // Products of every coefficient with the low and high nibble
+    // of a byte, for the vector kernels.
+    uint8_t nib_lo[256][16];
+    uint8_t nib_hi[256][16];
+
+    GF256()
+    {
+        unsigned x = 1;
+        for (int i = 0; i < 255; ++i)
+        {
+            exp[i] = uint8_t(x);
+            log[x] = uint8_t(i);
+            x <<= 1;
+            if (x & 0x100)
+                x ^= 0x11D;
+        }
+        for (int i = 255; i < 512; ++i)
+            exp[i] = exp[i - 255];
+        log[0] = 0; // never used
+
+        for (int a = 0; a < 256; ++a)
+        {
+            for (int b = 0; b < 256; ++b)
+                mul[a][b] = (a && b) ? exp[log[a] + log[b]] : 0;
+
+            for (int n = 0; n < 16; ++n)
+            {
+                nib_lo[a][n] = mul[a][n];
+                nib_hi[a][n] = mul[a][n << 4];
+            }
+        }
+    }
+
+    uint8_t inv(uint8_t a) const { return exp[255 - log[a]]; }
+};
+
+const GF256 gf;
+
+// dst ^= c * src, for every byte. The kernel is selected once,
+// depending on what the CPU supports.
+typedef void gf_muladd_fn(char* dst, const char* src, uint8_t c, size_t len);
+
+void GfMulAddScalar(char* dst, const char* src, uint8_t c, size_t len)
+{
+    const uint8_t* row = gf.mul[c];
+    for (size_t i = 0; i < len; ++i)
+        dst[i] ^= row[uint8_t(src[i])];
+}
+
+#if SRT_FEC_RS_X86_SIMD
+__attribute__((target("ssse3")))
+void GfMulAddSSSE3(char* dst, const char* src, uint8_t c, size_t len)
+{
+    const __m128i lo   = _mm_loadu_si128((const __m128i*)gf.nib_lo[c]);
+    const __m128i hi   = _mm_loadu_si128((const __m128i*)gf.nib_hi[c]);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        const __m128i l = _mm_shuffle_epi8(lo, _mm_and_si128(s, mask));
+        const __m128i h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi64(s, 4), mask));
+        const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d, _mm_xor_si128(l, h)));
+    }
+    GfMulAddScalar(dst + i, src + i, c, len - i);
+}
+
+__attribute__((target("avx2")))
+void GfMulAddAVX2(char* dst, const char* src, uint8_t c, size_t len)
+{
+    const __m256i lo   = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)gf.nib_lo[c]));
+    const __m256i hi   = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)gf.nib_hi[c]));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32)
+    {
+        const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        const __m256i l = _mm256_shuffle_epi8(lo, _mm256_and_si256(s, mask));
+        const __m256i h = _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi64(s, 4), mask));
+        const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(d, _mm256_xor_si256(l, h)));
+    }
+    GfMulAddSSSE3(dst + i, src + i, c, len - i);
+}
+#endif
+
+gf_muladd_fn* SelectGfMulAdd()
+{
+#if SRT_FEC_RS_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return &GfMulAddAVX2;
+    if (__builtin_cpu_supports("ssse3"))
+        return &GfMulAddSSSE3;
+#endif
+    return &GfMulAddScalar;
+}
+
+gf_muladd_fn* const GfMulAddKernel = SelectGfMulAdd();
+
+inline void GfMulAdd(char* dst, const char* src, uint8_t c, size_t len)
+{
+    if (c != 0)
+        GfMulAddKernel(dst, src, c, len);
+}
+
+// Invert the n x n matrix in place (Gauss-Jordan).
+// Returns false if the matrix is singular.
+bool GfInvert(vector<uint8_t>& a, size_t n)
+{
+    vector<uint8_t> r(n * n, 0);
+    for (size_t i = 0; i < n; ++i)
+        r[i * n + i] = 1;
+
+    for (size_t col = 0; col < n; ++col)
+    {
+        size_t piv = col;
+        while (piv < n && a[piv * n + col] == 0)
+            ++piv;
+        if (piv == n)
+            return false;
+
+        if (piv != col)
+        {
+            for (size_t j = 0; j < n; ++j)
+            {
+                swap(a[piv * n + j], a[col * n + j]);
+                swap(r[piv * n + j], r[col * n + j]);
+            }
+        }
+
+        const uint8_t* scale = gf.mul[gf.inv(a[col * n + col])];
+        for (size_t j = 0; j < n; ++j)
+        {
+            a[col * n + j] = scale[a[col * n + j]];
+            r[col * n + j] = scale[r[col * n + j]];
+        }
+
+        for (size_t row = 0; row < n; ++row)
+        {
+            const uint8_t f = a[row * n + col];
+            if (row == col || f == 0)
+                continue;
+            const uint8_t* fm = gf.mul[f];
+            for (size_t j = 0; j < n; ++j)
+            {
+                a[row * n + j] ^= fm[a[col * n + j]];
+                r[row * n + j] ^= fm[r[col * n + j]];
+            }
+        }
+    }
+
+    a.swap(r);
+    return true;
+}
+
+} // namespace
+
+const char RSFilterBuiltin::defaultConfig [] = "rs,k:10,m:2,arq:onreq";
+
+bool RSFilterBuiltin::verifyConfig(const SrtFilterConfig& cfg, string& w_error)
+{
+    string kspec = map_get(cfg.parameters, "k"), mspec = map_get(cfg.parameters, "m");
+
+    int k = 10, m = 2;
+    if (kspec != "")
+        k = atoi(kspec.c_str());
+    if (mspec != "")
+        m = atoi(mspec.c_str());
+
+    if (k < 2)
+    {
+        w_error = "'k' must be > 1";
+        return false;
+    }
+
+    if (m < 1)
+    {
+        w_error = "'m' must be > 0";
+        return false;
+    }
+
+    // The parity packet carries k and m in single bytes, and
+    // the Cauchy matrix requires k+m distinct field elements.
+    if (k + m > 255)
+    {
+        w_error = "'k' + 'm' must not exceed 255";
+        return false;
+    }
+
+    string adaptive = map_get(cfg.parameters, "adaptive");
+    if (adaptive != "" && adaptive != "on" && adaptive != "off")
+    {
+        w_error = "value for 'adaptive' must be 'on' or 'off'";
+        return false;
+    }
+
+    string target = map_get(cfg.parameters, "target");
+    if (target != "")
+    {
+        const double t = atof(target.c_str());
+        if (t <= 0 || t >= 100)
+        {
+            w_error = "'target' must be a percentage > 0 and < 100";
+            return false;
+        }
+    }
+
+    string level = map_get(cfg.parameters, "arq");
+
+    // The adaptive mode relies on the loss reports.
+    if (adaptive == "on" && level == "never")
+    {
+        w_error = "'adaptive' requires 'arq' set to 'onreq' or 'always'";
+        return false;
+    }
+
+    if (level != "")
+    {
+        static const char* const levelnames [] = {"never", "onreq", "always"};
+        size_t i = 0;
+        for (i = 0; i < Size(levelnames); ++i)
+        {
+            if (strcmp(level.c_str(), levelnames[i]) == 0)
+                break;
+        }
+
+        if (i == Size(levelnames))
+        {
+            w_error = "'arq' value '" + level + "' invalid. Allowed: never, onreq, always";
+            return false;
+        }
+    }
+
+    for (map<string, string>::const_iterator i = cfg.parameters.begin(); i != cfg.parameters.end(); ++i)
+    {
+        if (i->first != "k" && i->first != "m" && i->first != "arq"
+                && i->first != "adaptive" && i->first != "target")
+        {
+            w_error = "Extra parameters. Allowed only: k, m, arq, adaptive, target";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+RSFilterBuiltin::RSFilterBuiltin(const SrtFilterInitializer &init, std::vector<SrtPacket> &provided, const string &confstr)
+    : SrtPacketFilterBase(init)
+    , m_fallback_level(SRT_ARQ_ONREQ)
+    , rcv(provided)
+{
+    if (!ParseFilterConfig(confstr, cfg))
+        throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+    string ermsg;
+    if (!verifyConfig(cfg, (ermsg)))
+    {
+        LOGC(pflog.Error, log << "IPE: Filter config failed: " << ermsg);
+        throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+    }
+
+    // Missing parameters are filled from the default config during
+    // the handshake, but the filter can be also created directly.
+    SrtFilterConfig defconf;
+    ParseFilterConfig(defaultConfig, (defconf));
+
+    string kspec = map_get(cfg.parameters, "k"), mspec = map_get(cfg.parameters, "m");
+    m_number_data   = atoi((kspec != "" ? kspec : defconf.parameters["k"]).c_str());
+    m_number_parity = atoi((mspec != "" ? mspec : defconf.parameters["m"]).c_str());
+
+    string level = map_get(cfg.parameters, "arq");
+    if (level == "never")
+        m_fallback_level = SRT_ARQ_NEVER;
+    else if (level == "always")
+        m_fallback_level = SRT_ARQ_ALWAYS;
+    else
+        m_fallback_level = SRT_ARQ_ONREQ;
+
+    // Default target for unrecovered losses is 0.1%.
+    string target = map_get(cfg.parameters, "target");
+    adapt.enabled = map_get(cfg.parameters, "adaptive") == "on";
+    adapt.target = (target != "" ? atof(target.c_str()) : 0.1) / 100;
+    adapt.sent = 0;
+    adapt.loss_rate = 0;
+    adapt.have_rate = false;
+    adapt.clean = 0;
+    adapt.hold = SRT_FEC_RS_ADAPT_HOLD_MIN;
+    adapt.decreased = false;
+    adapt.reported = 0;
+
+    // Cauchy matrix: coef(i, j) = 1 / (x_i + y_j), with x_i = i
+    // and y_j = m + j. Every square submatrix of it is invertible,
+    // so any k packets out of k+m are enough to rebuild the block.
+    // In the adaptive mode m is the maximum, so the coefficients
+    // stay the same when fewer parity packets are sent.
+    m_coef.resize(m_number_parity * m_number_data);
+    for (size_t i = 0; i < m_number_parity; ++i)
+    {
+        for (size_t j = 0; j < m_number_data; ++j)
+            m_coef[i * m_number_data + j] = gf.inv(uint8_t(i ^ (m_number_parity + j)));
+    }
+
+    // Required to store in the header when rebuilding
+    rcv.id = socketID();
+
+    // These sequence numbers are both the value of ISN-1 at the moment
+    // when the handshake is done.
+    snd.parity.resize(m_number_parity * symbolSize(), 0);
+    snd.active = m_number_parity;
+    snd.length = 0;
+    ResetSendBlock(CSeqNo::incseq(sndISN()));
+
+    rcv.base = CSeqNo::incseq(rcvISN());
+    rcv.syndromes.resize(m_number_parity * symbolSize());
+    rcv.blocks.reserve(SRT_FEC_RS_RCV_HISTORY + 1);
+    rcv.blocks.resize(1);
+    ConfigureBlock(rcv.blocks[0], rcv.base);
+
+    HLOGC(pflog.Debug, log << "RS: CONFIG: k=" << m_number_data << " m=" << m_number_parity
+            << " snd base %" << snd.base << " rcv base %" << rcv.base);
+}
+
+void RSFilterBuiltin::ResetSendBlock(int32_t base)
+{
+    // Only the part that was clipped needs to be cleared.
+    for (size_t i = 0; i < snd.active; ++i)
+        memset(&snd.parity[i * symbolSize()], 0, snd.length);
+
+    snd.base = base;
+    snd.collected = 0;
+    snd.emitted = 0;
+    snd.length = 0;
+    snd.timestamp = 0;
+}
+
+void RSFilterBuiltin::feedSource(CPacket& packet)
+{
+    int offset = CSeqNo::seqoff(snd.base, packet.getSeqNo());
+    if (offset < 0)
+    {
+        LOGC(pflog.Error, log << "RS: feedSource: IPE: %" << packet.getSeqNo()
+                << " is older than the block base %" << snd.base);
+        return;
+    }
+
+    if (offset >= int(m_number_data))
+    {
+        // Normally the parity packets are extracted before the next
+        // block starts. If not, the block has some packets never fed,
+        // so it's abandoned and the block with this packet started.
+        const int32_t newbase = CSeqNo::incseq(snd.base, (offset / int(m_number_data)) * int(m_number_data));
+        HLOGC(pflog.Debug, log << "RS: feedSource: %" << packet.getSeqNo() << " abandons block %"
+                << snd.base << " collected " << snd.collected << "/" << m_number_data);
+        ResetSendBlock(newbase);
+        offset = CSeqNo::seqoff(snd.base, packet.getSeqNo());
+    }
+
+    // Both length and timestamp are stored in network order, as they
+    // are clipped into the payload of the parity packet.
+    char prefix[SYMBOL_PREFIX_SIZE];
+    const uint32_t timestamp_net = htonl(packet.getMsgTimeStamp());
+    const uint16_t length_net = htons(uint16_t(packet.size()));
+    memcpy(prefix, &timestamp_net, sizeof timestamp_net);
+    memcpy(prefix + 4, &length_net, sizeof length_net);
+    prefix[6] = char(packet.getMsgCryptoFlags());
+    prefix[7] = 0;
+
+    const size_t symsize = symbolSize();
+    for (size_t i = 0; i < snd.active; ++i)
+    {
+        char* parity = &snd.parity[i * symsize];
+        const uint8_t c = coef(i, offset);
+        GfMulAdd(parity, prefix, c, SYMBOL_PREFIX_SIZE);
+        GfMulAdd(parity + SYMBOL_PREFIX_SIZE, packet.data(), c, packet.size());
+    }
+
+    snd.length = max(snd.length, SYMBOL_PREFIX_SIZE + packet.size());
+    snd.timestamp = packet.getMsgTimeStamp();
+    ++snd.collected;
+
+    HLOGC(pflog.Debug, log << "RS: feedSource: %" << packet.getSeqNo() << " [" << offset << "/"
+            << m_number_data << "] size=" << packet.size() << " collected " << snd.collected);
+}
+
+bool RSFilterBuiltin::packControlPacket(SrtPacket& rpkt, int32_t seq)
+{
+    // NOTE: seq is the sequence number of the LAST PACKET SENT regularly,
+    // which is the last packet of the block when the parity is ready.
+    if (snd.collected < m_number_data)
+        return false;
+
+    if (snd.emitted == snd.active)
+    {
+        // No parity packets for this block in the adaptive mode.
+        ResetSendBlock(CSeqNo::incseq(snd.base, int32_t(m_number_data)));
+        AdaptParity();
+        return false;
+    }
+
+    const size_t index = snd.emitted;
+
+    // The number of parity packets is sent in-band, so that the
+    // receiver follows the adaptive mode changes.
+    char* out = rpkt.buffer;
+    out[0] = char(index);
+    out[1] = char(m_number_data);
+    out[2] = char(snd.active);
+    out[3] = 0;
+    memcpy((out + CONTROL_HEADER_SIZE), &snd.parity[index * symbolSize()], snd.length);
+
+    rpkt.length = CONTROL_HEADER_SIZE + snd.length;
+    rpkt.hdr[SRT_PH_TIMESTAMP] = snd.timestamp;
+    rpkt.hdr[SRT_PH_SEQNO] = seq;
+
+    HLOGC(pflog.Debug, log << "RS/CTL: parity " << index << "/" << snd.active << " for block %"
+            << snd.base << " size=" << rpkt.length);
+
+    if (++snd.emitted == snd.active)
+    {
+        ResetSendBlock(CSeqNo::incseq(snd.base, int32_t(m_number_data)));
+        AdaptParity();
+    }
+
+    return true;
+}
+
+void RSFilterBuiltin::lossReported(int32_t, int32_t, int newly)
+{
+    if (!adapt.enabled)
+        return;
+
+    int old = adapt.reported.load();
+    while (!adapt.reported.compare_exchange(old, old + newly))
+        old = adapt.reported.load();
+}
+
+size_t RSFilterBuiltin::RequiredParity(double p) const
+{
+    if (p <= 0)
+        return 0;
+    if (p >= 1)
+        return m_number_parity;
+
+    // With m parity packets, the block can't be rebuilt when more than m
+    // of its k+m packets are lost. The expected fraction of data packets
+    // lost this way is the sum of P(x lost) * x/(k+m) for x > m, with the
+    // losses binomially distributed.
+    for (size_t m = 0; m < m_number_parity; ++m)
+    {
+        const size_t n = m_number_data + m;
+        double pmf = pow(1 - p, double(n));
+        double unrecovered = 0;
+        for (size_t x = 0; x < n; ++x)
+        {
+            pmf *= double(n - x) / double(x + 1) * p / (1 - p);
+            if (x + 1 > m)
+                unrecovered += pmf * double(x + 1) / double(n);
+        }
+
+        if (unrecovered <= adapt.target)
+            return m;
+    }
+
+    return m_number_parity;
+}
+
+void RSFilterBuiltin::AdaptParity()
+{
+    if (!adapt.enabled)
+        return;
+
+    adapt.sent += m_number_data;
+    const size_t prev = snd.active;
+
+    if (m_fallback_level == SRT_ARQ_ALWAYS)
+    {
+        if (adapt.sent < ADAPT_WINDOW)
+            return;
+
+        // Raise immediately, lower slowly.
+        const double rate = double(adapt.reported.exchange(0)) / double(adapt.sent);
+        if (!adapt.have_rate || rate > adapt.loss_rate)
+            adapt.loss_rate = rate;
+        else
+            adapt.loss_rate = 0.75 * adapt.loss_rate + 0.25 * rate;
+        adapt.have_rate = true;
+        adapt.sent = 0;
+
+        snd.active = RequiredParity(adapt.loss_rate);
+    }
+    else
+    {
+        // Unrecovered losses exceeding the target for the window
+        // raise the parity without waiting for the window end.
+        if (adapt.reported.load() > adapt.target * ADAPT_WINDOW)
+        {
+            if (snd.active < m_number_parity)
+                ++snd.active;
+            if (adapt.decreased)
+                adapt.hold = min(adapt.hold * 2, size_t(SRT_FEC_RS_ADAPT_HOLD_MAX));
+            adapt.decreased = false;
+            adapt.clean = 0;
+            adapt.sent = 0;
+            adapt.reported = 0;
+        }
+        else if (adapt.sent >= ADAPT_WINDOW)
+        {
+            adapt.sent = 0;
+            adapt.reported = 0;
+            if (++adapt.clean >= adapt.hold && snd.active > 0)
+            {
+                --snd.active;
+                adapt.decreased = true;
+                adapt.clean = 0;
+            }
+        }
+    }
+
+    if (snd.active != prev)
+    {
+        LOGC(pflog.Note, log << "RS: adaptive: parity per block " << prev << " -> " << snd.active
+                << " (k=" << m_number_data << ")");
+    }
+}
+
+void RSFilterBuiltin::ConfigureBlock(RcvBlock& b, int32_t base)
+{
+    if (b.symbols.empty())
+    {
+        b.have.resize(m_number_data + m_number_parity, 0);
+        b.symbols.resize((m_number_data + m_number_parity) * symbolSize());
+    }
+    b.base = base;
+}
+
+void RSFilterBuiltin::StoreSymbol(RcvBlock& b, size_t slot, const char* prefix, const char* payload, size_t payload_size)
+{
+    char* sym = &b.symbols[slot * symbolSize()];
+    if (prefix)
+        memcpy(sym, prefix, SYMBOL_PREFIX_SIZE);
+
+    char* data = prefix ? sym + SYMBOL_PREFIX_SIZE : sym;
+    const size_t room = prefix ? payloadSize() : symbolSize();
+    memcpy(data, payload, payload_size);
+
+    // Symbols shorter than the longest one in the block are taken
+    // as padded with zeros.
+    memset(data + payload_size, 0, room - payload_size);
+
+    b.length = max(b.length, size_t(data + payload_size - sym));
+    b.have[slot] = 1;
+}
+
+bool RSFilterBuiltin::receive(const CPacket& rpkt, loss_seqs_t& loss_seqs)
+{
+    const int32_t seqno = rpkt.getSeqNo();
+    const bool isctl = rpkt.getMsgSeq() == SRT_MSGNO_CONTROL;
+
+    size_t parityx = 0;
+    if (isctl)
+    {
+        const char* payload = rpkt.data();
+        if (rpkt.size() < CONTROL_HEADER_SIZE + SYMBOL_PREFIX_SIZE
+                || rpkt.size() > CONTROL_HEADER_SIZE + symbolSize()
+                || size_t(uint8_t(payload[1])) != m_number_data
+                || size_t(uint8_t(payload[2])) > m_number_parity
+                || uint8_t(payload[0]) >= uint8_t(payload[2]))
+        {
+            LOGC(pflog.Warn, log << "RS: RECEIVED %" << seqno << " parity packet with invalid header, IGNORING.");
+            return false;
+        }
+        parityx = uint8_t(payload[0]);
+    }
+    else
+    {
+        // Remember this simply every time a packet comes in, as FEC does.
+        rcv.order_required = rpkt.getMsgOrderFlag();
+    }
+
+    const int offset = CSeqNo::seqoff(rcv.base, seqno);
+    if (offset < 0)
+    {
+        HLOGC(pflog.Debug, log << "RS: packet %" << seqno << " in the PAST, IGNORING.");
+        return !isctl;
+    }
+
+    size_t blockx = offset / m_number_data;
+    if (blockx >= SRT_FEC_RS_RCV_HISTORY)
+    {
+        loss_seqs_t irrecover;
+        const size_t ndismiss = blockx - SRT_FEC_RS_RCV_HISTORY + 1;
+        DismissBlocks(ndismiss, (irrecover));
+        blockx -= ndismiss;
+
+        if (m_fallback_level == SRT_ARQ_ONREQ)
+            loss_seqs = irrecover;
+    }
+
+    if (blockx >= rcv.blocks.size())
+    {
+        const size_t oldsize = rcv.blocks.size();
+        rcv.blocks.resize(blockx + 1);
+        for (size_t i = oldsize; i <= blockx; ++i)
+            ConfigureBlock(rcv.blocks[i], CSeqNo::incseq(rcv.base, int32_t(i * m_number_data)));
+    }
+
+    RcvBlock& b = rcv.blocks[blockx];
+    const size_t slot = isctl ? m_number_data + parityx : size_t(CSeqNo::seqoff(b.base, seqno));
+
+    if (b.done || b.have[slot])
+    {
+        HLOGC(pflog.Debug, log << "RS: packet %" << seqno << (isctl ? " parity " : " data ")
+                << "already known or block complete, IGNORING.");
+        return !isctl;
+    }
+
+    if (isctl)
+    {
+        StoreSymbol(b, slot, NULL, rpkt.data() + CONTROL_HEADER_SIZE, rpkt.size() - CONTROL_HEADER_SIZE);
+        ++b.nparity;
+    }
+    else
+    {
+        char prefix[SYMBOL_PREFIX_SIZE];
+        const uint32_t timestamp_net = htonl(rpkt.getMsgTimeStamp());
+        const uint16_t length_net = htons(uint16_t(rpkt.size()));
+        memcpy(prefix, &timestamp_net, sizeof timestamp_net);
+        memcpy(prefix + 4, &length_net, sizeof length_net);
+        prefix[6] = char(rpkt.getMsgCryptoFlags());
+        prefix[7] = 0;
+
+        StoreSymbol(b, slot, prefix, rpkt.data(), rpkt.size());
+        ++b.ndata;
+    }
+
+    HLOGC(pflog.Debug, log << "RS: RECEIVED %" << seqno << (isctl ? " parity" : " data") << " block %" << b.base
+            << " data " << b.ndata << "/" << m_number_data << " parity " << b.nparity);
+
+    if (b.ndata == m_number_data)
+    {
+        b.done = true;
+    }
+    else if (b.ndata + b.nparity >= m_number_data)
+    {
+        b.done = RcvRebuild(b);
+    }
+
+    return !isctl;
+}
+
+bool RSFilterBuiltin::RcvRebuild(RcvBlock& b)
+{
+    const size_t k = m_number_data;
+    const size_t symsize = symbolSize();
+
+    vector<size_t> lost, parities;
+    for (size_t j = 0; j < k; ++j)
+    {
+        if (!b.have[j])
+            lost.push_back(j);
+    }
+    for (size_t i = 0; i < m_number_parity && parities.size() < lost.size(); ++i)
+    {
+        if (b.have[k + i])
+            parities.push_back(i);
+    }
+
+    const size_t n = lost.size();
+    SRT_ASSERT(parities.size() == n);
+
+    // The lost symbols satisfy: for every used parity row r,
+    //   sum(c) coef(r, lost[c]) * D[lost[c]] = P[r] + sum(present j) coef(r, j) * D[j]
+    // The right side (syndrome) is calculated first, then the system
+    // is solved with the inverted matrix of the lost columns.
+    vector<uint8_t> a(n * n);
+    for (size_t r = 0; r < n; ++r)
+    {
+        for (size_t c = 0; c < n; ++c)
+            a[r * n + c] = coef(parities[r], lost[c]);
+    }
+
+    if (!GfInvert((a), n))
+    {
+        LOGC(pflog.Error, log << "RS: IPE: singular matrix for block %" << b.base << ", NOT REBUILDING.");
+        return false;
+    }
+
+    const size_t len = b.length;
+    for (size_t r = 0; r < n; ++r)
+    {
+        char* syn = &rcv.syndromes[r * symsize];
+        memcpy(syn, &b.symbols[(k + parities[r]) * symsize], len);
+        for (size_t j = 0; j < k; ++j)
+        {
+            if (b.have[j])
+                GfMulAdd(syn, &b.symbols[j * symsize], coef(parities[r], j), len);
+        }
+    }
+
+    for (size_t c = 0; c < n; ++c)
+    {
+        char* sym = &b.symbols[lost[c] * symsize];
+        memset(sym, 0, symsize);
+        for (size_t r = 0; r < n; ++r)
+            GfMulAdd(sym, &rcv.syndromes[r * symsize], a[c * n + r], len);
+
+        const int32_t seqno = CSeqNo::incseq(b.base, int32_t(lost[c]));
+
+        uint32_t timestamp_net;
+        uint16_t length_net;
+        memcpy(&timestamp_net, sym, sizeof timestamp_net);
+        memcpy(&length_net, sym + 4, sizeof length_net);
+        const uint16_t length_hw = ntohs(length_net);
+        const uint8_t kflg = uint8_t(sym[6]);
+
+        if (length_hw > payloadSize())
+        {
+            LOGC(pflog.Warn, log << "RS: DECODED length '" << length_hw << "' for %" << seqno
+                    << " exceeds payload size. NOT REBUILDING.");
+            continue;
+        }
+
+        rcv.rebuilt.push_back(length_hw);
+        SrtPacket& p = rcv.rebuilt.back();
+
+        // Same as in the FEC filter: the message number is 1, PB_SOLO,
+        // and the REXMIT flag is set because the packet comes out of order.
+        p.hdr[SRT_PH_SEQNO] = seqno;
+        p.hdr[SRT_PH_MSGNO] = 1
+            | MSGNO_PACKET_BOUNDARY::wrap(PB_SOLO)
+            | MSGNO_PACKET_INORDER::wrap(rcv.order_required)
+            | MSGNO_ENCKEYSPEC::wrap(kflg)
+            | MSGNO_REXMIT::wrap(true)
+            ;
+        p.hdr[SRT_PH_TIMESTAMP] = ntohl(timestamp_net);
+        p.hdr[SRT_PH_ID] = rcv.id;
+
+        memcpy(p.buffer, sym + SYMBOL_PREFIX_SIZE, length_hw);
+
+        HLOGC(pflog.Debug, log << "RS: REBUILT: %" << seqno
+                << " TS=" << p.hdr[SRT_PH_TIMESTAMP] << " size=" << length_hw
+                << " !" << BufferStamp(p.buffer, p.length));
+
+        b.have[lost[c]] = 1;
+        ++b.ndata;
+    }
+
+    return b.ndata == m_number_data;
+}
+
+void RSFilterBuiltin::CollectIrrecover(const RcvBlock& b, loss_seqs_t& irrecover) const
+{
+    if (b.done)
+        return;
+
+    for (size_t j = 0; j < m_number_data; ++j)
+    {
+        if (b.have[j])
+            continue;
+
+        const int32_t seqno = CSeqNo::incseq(b.base, int32_t(j));
+        if (!irrecover.empty() && CSeqNo::incseq(irrecover.back().second) == seqno)
+            irrecover.back().second = seqno;
+        else
+            irrecover.push_back(make_pair(seqno, seqno));
+    }
+}
+
+void RSFilterBuiltin::DismissBlocks(size_t n, loss_seqs_t& irrecover)
+{
+    const size_t nexisting = min(n, rcv.blocks.size());
+    for (size_t i = 0; i < nexisting; ++i)
+        CollectIrrecover(rcv.blocks[i], (irrecover));
+
+    if (n > nexisting)
+    {
+        // Blocks that never had any packet received.
+        const int32_t first = CSeqNo::incseq(rcv.base, int32_t(nexisting * m_number_data));
+        const int32_t last = CSeqNo::decseq(CSeqNo::incseq(rcv.base, int32_t(n * m_number_data)));
+        if (!irrecover.empty() && CSeqNo::incseq(irrecover.back().second) == first)
+            irrecover.back().second = last;
+        else
+            irrecover.push_back(make_pair(first, last));
+    }
+
+    HLOGC(pflog.Debug, log << "RS: dismissing " << n << " blocks from %" << rcv.base
+            << " IRRECOVERABLE: " << Printable(irrecover));
+
+    rcv.blocks.erase_front(nexisting);
+    rcv.base = CSeqNo::incseq(rcv.base, int32_t(n * m_number_data));
+
+    // Blocks that stay in the ring keep their base.
+}
+
+} // namespace srt
@@ -0,0 +1,210 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2026 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+
+#ifndef INC_SRT_FEC_RS_H
+#define INC_SRT_FEC_RS_H
+
+#include <string>
+#include <vector>
+
+#include "packetfilter_api.h"
+#include "atomic.h"
+#include "fec.h"
+
+namespace srt {
+
+// Reed-Solomon packet filter ("rs").
+//
+// Packets are collected in blocks of k consecutive sequence numbers.
+// For every block the sender generates m parity packets, computed
+// with a systematic Reed-Solomon code over GF(2^8) (Cauchy matrix).
+// The receiver can rebuild up to m lost data packets in a block as
+// long as any k out of the k+m packets of the block have arrived.
+//
+// Every packet in a block is coded as a "symbol" consisting of an
+// 8-byte prefix (timestamp, length, encryption flags) and the payload
+// padded with zeros up to the maximum payload size.
+//
+// In the adaptive mode the sender changes the number of parity packets
+// per block between 0 and m, depending on the losses reported by the
+// receiver. The number of parity packets of the block is sent in-band,
+// in every parity packet, and the coefficients don't depend on it, so
+// the receiver doesn't need to know it in advance.
+class RSFilterBuiltin: public SrtPacketFilterBase
+{
+    SrtFilterConfig cfg;
+    size_t m_number_data;   //< k: number of data packets in a block
+    size_t m_number_parity; //< m: maximum number of parity packets in a block
+
+    SRT_ARQLevel m_fallback_level;
+
+    // Coefficients of the parity rows, m rows of k items.
+    std::vector<uint8_t> m_coef;
+
+public:
+
+    size_t numberData() const { return m_number_data; }
+    size_t numberParity() const { return m_number_parity; }
+
+    // Number of parity packets generated for the current block.
+    size_t activeParity() const { return snd.active; }
+
+    // Size of the symbol prefix: timestamp(4), length(2), flags(1), reserved(1).
+    static const size_t SYMBOL_PREFIX_SIZE = 8;
+
+    // Size of the parity packet header: index(1), k(1), m(1), reserved(1).
+    static const size_t CONTROL_HEADER_SIZE = 4;
+
+    size_t symbolSize() const { return SYMBOL_PREFIX_SIZE + payloadSize(); }
+
+    uint8_t coef(size_t parityx, size_t datax) const { return m_coef[parityx * m_number_data + datax]; }
+
+    struct RcvBlock
+    {
+        int32_t base;   //< Sequence of the first packet in the block
+        size_t ndata;   //< number of data packets present (received or rebuilt)
+        size_t nparity; //< number of parity packets received
+        size_t length;  //< the longest symbol length stored in this block
+        bool done;      //< all data packets are present, nothing more to do
+
+        // Presence of the k data and m parity symbols, in this order.
+        std::vector<char> have;
+        std::vector<char> symbols;
+
+        RcvBlock(): base(SRT_SEQNO_NONE), ndata(0), nparity(0), length(0), done(false) {}
+
+        // Make the block as if freshly constructed, except that the
+        // symbol buffer stays allocated.
+        void recycle()
+        {
+            base = SRT_SEQNO_NONE;
+            ndata = 0;
+            nparity = 0;
+            length = 0;
+            done = false;
+            std::fill(have.begin(), have.end(), 0);
+        }
+    };
+
+private:
+
+    struct Send
+    {
+        int32_t base;       //< Sequence of the first packet in the current block
+        size_t active;      //< how many parity packets are generated for this block
+        size_t collected;   //< how many data packets were clipped into parity
+        size_t emitted;     //< how many parity packets were already extracted
+        size_t length;      //< the longest symbol length clipped
+        uint32_t timestamp; //< timestamp of the last data packet, for the parity packets
+
+        // Parity symbols being accumulated, m of symbolSize().
+        std::vector<char> parity;
+    } snd;
+
+    // Adaptation of the number of parity packets, done by the sender
+    // at the block boundary. The losses are counted in windows of
+    // data packets. With arq:always the reported losses are the raw
+    // network losses, and the number of parity packets is calculated
+    // from the loss rate. With arq:onreq only the losses that the
+    // receiver failed to rebuild are reported, so the number of parity
+    // packets is increased when they exceed the target and decreased
+    // back after a number of windows within the target.
+    struct Adapt
+    {
+        bool enabled;
+        double target;     //< maximum accepted unrecovered loss rate (fraction)
+        size_t sent;       //< data packets sent in the current window
+        double loss_rate;  //< smoothed raw loss rate (arq:always)
+        bool have_rate;    //< loss_rate has been measured at least once
+        size_t clean;      //< consecutive windows within the target (arq:onreq)
+        size_t hold;       //< windows within the target required to decrease
+        bool decreased;    //< the last change was a decrease
+
+        // Written by the thread processing the loss reports.
+        sync::atomic<int> reported;
+    } adapt;
+
+    struct Receive
+    {
+        SRTSOCKET id;
+        bool order_required;
+
+        // Sequence number of the first packet in blocks[0].
+        int32_t base;
+
+        // Blocks are kept in a ring, so that dismissing the oldest
+        // and adding new ones reuses their symbol buffers.
+        FECGroupRing<RcvBlock> blocks;
+
+        // Syndromes calculated during rebuilding, m of symbolSize().
+        std::vector<char> syndromes;
+
+        Receive(std::vector<SrtPacket>& provided): id(SRT_INVALID_SOCK), order_required(false), base(SRT_SEQNO_NONE), rebuilt(provided)
+        {
+        }
+
+        std::vector<SrtPacket>& rebuilt;
+    } rcv;
+
+    // Sending
+    void ResetSendBlock(int32_t base);
+    void AdaptParity();
+    size_t RequiredParity(double loss_rate) const;
+
+    // Receiving
+    void ConfigureBlock(RcvBlock& b, int32_t base);
+    void StoreSymbol(RcvBlock& b, size_t slot, const char* prefix, const char* payload, size_t payload_size);
+    void DismissBlocks(size_t n, loss_seqs_t& irrecover);
+    void CollectIrrecover(const RcvBlock& b, loss_seqs_t& irrecover) const;
+    bool RcvRebuild(RcvBlock& b);
+
+public:
+
+    RSFilterBuiltin(const SrtFilterInitializer& init, std::vector<SrtPacket>& provided, const std::string& confstr);
+
+    // Sender side
+
+    // Provides the next parity packet of the current block, once all
+    // k data packets of this block have been fed. The parity packets
+    // are provided in m subsequent calls.
+    virtual bool packControlPacket(SrtPacket& r_packet, int32_t seq) ATR_OVERRIDE;
+
+    // Clips the data packet into the parity symbols of its block.
+    virtual void feedSource(CPacket& r_packet) ATR_OVERRIDE;
+
+    // Counts the reported losses for the adaptive mode.
+    virtual void lossReported(int32_t lo, int32_t hi, int newly) ATR_OVERRIDE;
+
+    // Number of data packets in the window after which the
+    // number of parity packets is reconsidered.
+    static const size_t ADAPT_WINDOW = 1000;
+
+    // Receiver side
+
+    // Stores the packet in its block and rebuilds the lost data packets
+    // as soon as at least k packets of the block are present.
+    virtual bool receive(const CPacket& pkt, loss_seqs_t& loss_seqs) ATR_OVERRIDE;
+
+    // Configuration
+
+    // The parity packet carries the control header and the parity
+    // of the symbol prefix in addition to the payload.
+    static const size_t EXTRA_SIZE = CONTROL_HEADER_SIZE + SYMBOL_PREFIX_SIZE;
+
+    virtual SRT_ARQLevel arqLevel() ATR_OVERRIDE { return m_fallback_level; }
+
+    static const char defaultConfig [];
+    static bool verifyConfig(const SrtFilterConfig& config, std::string& w_errormsg);
+};
+
+} // namespace srt
+
+#endif
@@ -65,6 +65,14 @@ bool CUDTGroup::getBufferTimeBase(CUDT*                     forthesakeof,
 // [[using locked(this->m_GroupLock)]];
 bool CUDTGroup::applyGroupSequences(SRTSOCKET target, int32_t& w_snd_isn, int32_t& w_rcv_isn)
 {
+    // In the balancing group every link carries different packets, each
+    // in its own sequence, so the sequences from the handshake are kept.
+    if (m_type == SRT_GTYPE_BALANCING)
+    {
+        HLOGC(gmlog.Debug, log << "applyGroupSequences: @" << target << " in balancing group keeps its sequences");
+        return true;
+    }
+
     if (m_bConnected) // You are the first one, no need to change.
     {
         IF_HEAVY_LOGGING(string update_reason = "what?");
@@ -271,14 +279,19 @@ CUDTGroup::CUDTGroup(SRT_GROUP_TYPE gtype)
     , m_tsStartTime()
     , m_tsRcvPeerStartTime()
     , m_RcvBaseSeqNo(SRT_SEQNO_NONE)
+    , m_RcvLastMsgNo(SRT_MSGNO_NONE)
+    , m_iRcvIndexStartPos(0)
+    , m_RcvIndexStartSeq(SRT_SEQNO_NONE)
     , m_bOpened(false)
     , m_bConnected(false)
     , m_bClosing(false)
     , m_iLastSchedSeqNo(SRT_SEQNO_NONE)
     , m_iLastSchedMsgNo(SRT_MSGNO_NONE)
+    , m_dBalancingVirtTime(0)
 {
     setupMutex(m_GroupLock, "Group");
     setupMutex(m_RcvDataLock, "G/RcvData");
+    setupMutex(m_RcvIndexLock, "G/RcvIndex");
     setupCond(m_RcvDataCond, "G/RcvData");
     m_RcvEID = m_Global.m_EPoll.create(&m_RcvEpolld);
     m_SndEID = m_Global.m_EPoll.create(&m_SndEpolld);
@@ -1026,7 +1039,7 @@ void CUDTGroup::send_CheckValidSockets()
     }
 }
 
-int CUDTGroup::send(const char* buf, int len, SRT_MSGCTRL& w_mc)
+int CUDTGroup::send(const char* buf, int len, SRT_MSGCTRL& w_mc, CSndPayload* payload)
 {
     switch (m_type)
     {
@@ -1035,15 +1048,15 @@ int CUDTGroup::send(const char* buf, int len, SRT_MSGCTRL& w_mc)
         throw CUDTException(MJ_SETUP, MN_INVAL, 0);
 
     case SRT_GTYPE_BROADCAST:
-        return sendBroadcast(buf, len, (w_mc));
+        return sendBroadcast(buf, len, (w_mc), payload);
 
     case SRT_GTYPE_BACKUP:
         return sendBackup(buf, len, (w_mc));
 
-        /* to be implemented
-
     case SRT_GTYPE_BALANCING:
-        return sendBalancing(buf, len, (w_mc));
+        return sendBalancing(buf, len, (w_mc), payload);
+
+        /* to be implemented
 
     case SRT_GTYPE_MULTICAST:
         return sendMulticast(buf, len, (w_mc));
@@ -1051,7 +1064,50 @@ int CUDTGroup::send(const char* buf, int len, SRT_MSGCTRL& w_mc)
     }
 }
 
-int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc)
+// Release function of the payload shared by the members of a broadcast group.
+static void releaseBroadcastPayload(void*, const char* data, int)
+{
+    delete[] data;
+}
+
+// A payload stored once is of use only for a member sending it as is. An encrypting
+// member copies it into its own sender buffer anyway, as the encryption is done in place
+// with the member's own keys and packet sequence numbers.
+bool CUDTGroup::sendBroadcast_IsPlaintext(const CUDT& u)
+{
+    return !u.m_pCryptoControl.get() || u.m_pCryptoControl->getSndCryptoFlags() == EK_NOENC;
+}
+
+// Holds one reference to a shared payload and releases it when it goes out
+// of scope, so that no exception thrown while sending can leak it.
+class CSndPayloadRef
+{
+public:
+    CSndPayloadRef()
+        : m_pPayload(NULL)
+    {
+    }
+
+    ~CSndPayloadRef() { reset(NULL); }
+
+    // Takes over the reference already held for @a payload.
+    void reset(CSndPayload* payload)
+    {
+        if (m_pPayload)
+            m_pPayload->release();
+        m_pPayload = payload;
+    }
+
+    CSndPayload* get() const { return m_pPayload; }
+
+private:
+    CSndPayload* m_pPayload;
+
+    CSndPayloadRef(const CSndPayloadRef&);
+    CSndPayloadRef& operator=(const CSndPayloadRef&);
+};
+
+int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc, CSndPayload* payload)
 {
     // Avoid stupid errors in the beginning.
     if (len <= 0)
@@ -1185,6 +1241,41 @@ int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc)
     if (w_mc.srctime == 0)
         w_mc.srctime = count_microseconds(steady_clock::now().time_since_epoch());
 
+    // With more than one link sending the message unencrypted, it is stored once and
+    // the sender buffers of these members refer to it, instead of every one copying it.
+    // The encrypting members copy it into their sender buffers as usual.
+    size_t plaintext_links = 0;
+    if (!payload)
+    {
+        for (vector<gli_t>::iterator i = activeLinks.begin(); i != activeLinks.end(); ++i)
+            plaintext_links += sendBroadcast_IsPlaintext((*i)->ps->core());
+        for (vector<gli_t>::iterator i = idleLinks.begin(); i != idleLinks.end(); ++i)
+            plaintext_links += sendBroadcast_IsPlaintext((*i)->ps->core());
+    }
+
+    CSndPayloadRef shared;
+    if (payload)
+    {
+        payload->acquire();
+        shared.reset(payload);
+    }
+    else if (plaintext_links > 1)
+    {
+        char* copy = new char[len];
+        memcpy(copy, buf, len);
+        try
+        {
+            shared.reset(CSndPayload::create(copy, len, &releaseBroadcastPayload, NULL));
+        }
+        catch (...)
+        {
+            delete[] copy;
+            throw;
+        }
+        HLOGC(gslog.Debug, log << "grp/sendBroadcast: sharing the payload by "
+                << plaintext_links << " links");
+    }
+
     for (vector<gli_t>::iterator snd = activeLinks.begin(); snd != activeLinks.end(); ++snd)
     {
         gli_t d   = *snd;
@@ -1196,7 +1287,8 @@ int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc)
             // Possible return values are only 0, in case when len was passed 0, or a positive
             // >0 value that defines the size of the data that it has sent, that is, in case
             // of Live mode, equal to 'len'.
-            stat = d->ps->core().sendmsg2(buf, len, (w_mc));
+            stat = d->ps->core().sendmsg2(buf, len, (w_mc),
+                    (payload || sendBroadcast_IsPlaintext(d->ps->core())) ? shared.get() : NULL);
         }
         catch (CUDTException& e)
         {
@@ -1284,7 +1376,8 @@ int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc)
 
         try
         {
-            stat = d->ps->core().sendmsg2(buf, len, (w_mc));
+            stat = d->ps->core().sendmsg2(buf, len, (w_mc),
+                    (payload || sendBroadcast_IsPlaintext(d->ps->core())) ? shared.get() : NULL);
         }
         catch (CUDTException& e)
         {
@@ -1312,6 +1405,9 @@ int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc)
         sendstates.push_back(cstate);
     }
 
+    // The sender buffers hold their own references now.
+    shared.reset(NULL);
+
     if (nextseq != SRT_SEQNO_NONE)
     {
         HLOGC(gslog.Debug,
@@ -1705,6 +1801,275 @@ int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc)
     return rstat;
 }
 
+size_t CUDTGroup::sendBalancing_SelectLink(const vector<gli_t>& links)
+{
+    size_t selected        = links.size();
+    double selected_pocket = 0;
+    bool   selected_late   = true;
+
+    for (size_t i = 0; i < links.size(); ++i)
+    {
+        CUDT& u = links[i]->ps->core();
+
+        // Time in which a packet scheduled now would reach the receiver:
+        // half of the RTT plus sending out the packets waiting before it,
+        // at the bandwidth estimated for the link. A link that can't make
+        // it within the latency has got more than it can carry for now.
+        bool      late    = false;
+        const int bw      = u.bandwidth();
+        const int latency = int(u.peerLatency_us());
+        if (bw > 1 && latency > 0)
+        {
+            const int64_t delay_us = u.SRTT() / 2 + int64_t(u.m_pSndBuffer->getCurrBufSize()) * 1000000 / bw;
+            late = delay_us > latency;
+        }
+
+        // The pocket of a link that wasn't selected for a while (or has
+        // just joined) doesn't give it a credit over the others.
+        const double pocket = std::max(links[i]->pocket, m_dBalancingVirtTime);
+
+        HLOGC(gslog.Debug,
+              log << "grp/sendBalancing: @" << links[i]->id << " weight=" << links[i]->weight << " bw=" << bw
+                  << "pkt/s rtt=" << u.SRTT() << "us sndbuf=" << u.m_pSndBuffer->getCurrBufSize()
+                  << " pocket=" << pocket << (late ? " LATE" : ""));
+
+        if (selected == links.size() || (selected_late && !late)
+                || (late == selected_late && pocket < selected_pocket))
+        {
+            selected        = i;
+            selected_pocket = pocket;
+            selected_late   = late;
+        }
+    }
+
+    return selected;
+}
+
+int CUDTGroup::sendBalancing(const char* buf, int len, SRT_MSGCTRL& w_mc, CSndPayload* payload)
+{
+    if (len <= 0)
+    {
+        throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+    }
+
+    vector<SRTSOCKET> wipeme;
+    vector<SRTSOCKET> pendingSockets;
+
+    // First, acquire GlobControlLock to make sure all member sockets still exist
+    enterCS(m_Global.m_GlobControlLock);
+    ScopedLock guard(m_GroupLock);
+
+    if (m_bClosing)
+    {
+        leaveCS(m_Global.m_GlobControlLock);
+        throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
+    }
+
+    // LOCKED: GlobControlLock, GroupLock (RIGHT ORDER!)
+    send_CheckValidSockets();
+    leaveCS(m_Global.m_GlobControlLock);
+
+    if (m_bClosing)
+    {
+        throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
+    }
+
+    // Every message goes over one link only, in the sequence of that link.
+    // The receiver restores the order by the message number, which is
+    // assigned by the group.
+    if (m_iLastSchedMsgNo == SRT_MSGNO_NONE)
+        m_iLastSchedMsgNo = 1;
+    w_mc.msgno = m_iLastSchedMsgNo;
+    if (w_mc.srctime == 0)
+        w_mc.srctime = count_microseconds(steady_clock::now().time_since_epoch());
+
+    int rstat  = -1;
+    int ercode = 0;
+    for (;;)
+    {
+        vector<gli_t> links;
+        for (gli_t d = m_Group.begin(); d != m_Group.end(); ++d)
+        {
+            if (d->sndstate != SRT_GST_BROKEN && (!d->ps || d->ps->core().m_bBroken))
+            {
+                HLOGC(gslog.Debug,
+                      log << "grp/sendBalancing: socket @" << d->id << " detected +Broken - transit to BROKEN");
+                d->sndstate = SRT_GST_BROKEN;
+                d->rcvstate = SRT_GST_BROKEN;
+            }
+
+            if (d->sndstate == SRT_GST_BROKEN)
+            {
+                wipeme.push_back(d->id);
+                continue;
+            }
+
+            if (d->sndstate == SRT_GST_IDLE)
+            {
+                if (!send_CheckIdle(d, (wipeme), (pendingSockets)))
+                    continue;
+
+                HLOGC(gslog.Debug, log << "grp/sendBalancing: socket @" << d->id << " IDLE - activating");
+                d->pocket   = m_dBalancingVirtTime;
+                d->sndstate = SRT_GST_RUNNING;
+            }
+
+            if (d->sndstate == SRT_GST_RUNNING)
+                links.push_back(d);
+        }
+
+        // The shares are compared between the links, so they must all be
+        // of the same kind: the weights if every link has got one, otherwise
+        // the estimated bandwidth for all of them. A link that has no estimate
+        // yet (it is made from the data the link carries) gets the average of
+        // the others, or it would never be given the data to make one. The
+        // shares are then taken as fractions of their sum, so that the price
+        // of a message doesn't depend on which of them are used.
+        bool    by_weight  = !links.empty();
+        int64_t weight_sum = 0;
+        int64_t bw_sum     = 0;
+        int     bw_links   = 0;
+        for (size_t i = 0; i < links.size(); ++i)
+        {
+            if (!links[i]->weight)
+                by_weight = false;
+            weight_sum += links[i]->weight;
+            const int bw = links[i]->ps->core().bandwidth();
+            if (bw > 1)
+            {
+                bw_sum += bw;
+                ++bw_links;
+            }
+        }
+        const int64_t bw_default = bw_links ? bw_sum / bw_links : 1;
+        bw_sum += bw_default * int64_t(links.size() - bw_links);
+
+        // Try the links in the order of preference until one takes the message.
+        bool blocked = false;
+        while (!links.empty() && rstat == -1)
+        {
+            const size_t pos = sendBalancing_SelectLink(links);
+            const gli_t  d   = links[pos];
+            links.erase(links.begin() + pos);
+
+            int stat = -1;
+            int erc  = 0;
+            try
+            {
+                stat = d->ps->core().sendmsg2(buf, len, (w_mc), payload);
+            }
+            catch (CUDTException& e)
+            {
+                erc = e.getErrorCode();
+            }
+            d->sndresult  = stat;
+            d->laststatus = d->ps->getStatus();
+
+            if (stat == len)
+            {
+                // The link has to pay for the data in proportion to its share.
+                const int    bw    = d->ps->core().bandwidth();
+                const double share = by_weight ? double(d->weight) / weight_sum
+                                               : double(bw > 1 ? bw : bw_default) / bw_sum;
+                const double start = std::max(d->pocket, m_dBalancingVirtTime);
+                m_dBalancingVirtTime = start;
+                d->pocket            = start + len / share;
+                rstat                = stat;
+
+                HLOGC(gslog.Debug,
+                      log << "grp/sendBalancing: #" << w_mc.msgno << " sent over @" << d->id << " %" << w_mc.pktseq);
+                break;
+            }
+
+            if (erc == SRT_EASYNCSND)
+            {
+                HLOGC(gslog.Debug, log << "grp/sendBalancing: @" << d->id << " full, trying another link");
+                blocked = true;
+                continue;
+            }
+
+            LOGC(gslog.Warn, log << "grp/sendBalancing: @" << d->id << " failed to send, closing");
+            d->sndstate = SRT_GST_BROKEN;
+            wipeme.push_back(d->id);
+            ercode = erc;
+        }
+
+        if (rstat != -1 || !blocked)
+            break;
+
+        m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_OUT, false);
+        if (!m_bSynSending)
+        {
+            send_CloseBrokenSockets(wipeme);
+            throw CUDTException(MJ_AGAIN, MN_WRAVAIL, 0);
+        }
+
+        // All links are full, wait until any of them can send.
+        int modes = SRT_EPOLL_OUT | SRT_EPOLL_ERR;
+        for (gli_t d = m_Group.begin(); d != m_Group.end(); ++d)
+        {
+            if (d->sndstate == SRT_GST_RUNNING)
+                CUDT::uglobal().epoll_add_usock_INTERNAL(m_SndEID, d->ps, &modes);
+        }
+
+        CEPoll::fmap_t sready;
+        {
+            InvertedLock ug(m_GroupLock);
+            HLOGC(gslog.Debug, log << "grp/sendBalancing: all links full, waiting");
+
+            // m_iSndTimeOut is -1 by default, which matches the meaning of waiting forever.
+            // XTIMEOUT is propagated to the API.
+            THREAD_PAUSED();
+            m_Global.m_EPoll.swait(*m_SndEpolld, sready, m_iSndTimeOut);
+            THREAD_RESUMED();
+        }
+
+        if (m_bClosing)
+            throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
+    }
+
+    send_CloseBrokenSockets(wipeme);
+
+    if (rstat == -1)
+    {
+        HLOGC(gslog.Debug, log << "grp/sendBalancing: no link could send the payload");
+        m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_OUT, false);
+        m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_ERR, true);
+        CodeMajor major = CodeMajor(ercode ? ercode / 1000 : MJ_CONNECTION);
+        CodeMinor minor = CodeMinor(ercode ? ercode % 1000 : MN_CONNLOST);
+        throw CUDTException(major, minor, 0);
+    }
+
+    m_iLastSchedMsgNo = ++MsgNo(m_iLastSchedMsgNo);
+    m_stats.sent.count(len);
+
+    const size_t grpsize = m_Group.size();
+    if (w_mc.grpdata_size < grpsize)
+    {
+        w_mc.grpdata = NULL;
+    }
+
+    size_t i           = 0;
+    bool   ready_again = false;
+    for (gli_t d = m_Group.begin(); d != m_Group.end(); ++d, ++i)
+    {
+        if (w_mc.grpdata)
+        {
+            copyGroupData(*d, (w_mc.grpdata[i]));
+        }
+
+        ready_again = ready_again || d->ps->writeReady();
+    }
+    w_mc.grpdata_size = i;
+
+    if (!ready_again)
+    {
+        m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_OUT, false);
+    }
+
+    return rstat;
+}
+
 int CUDTGroup::getGroupData(SRT_SOCKGROUPDATA* pdata, size_t* psize)
 {
     if (!psize)
@@ -1891,7 +2256,9 @@ void CUDTGroup::recv_CollectAliveAndBroken(vector<CUDTSocket*>& alive, set<CUDTS
             continue; // don't read over a failed or pending socket
         }
 
-        if (gi->laststatus >= SRTS_BROKEN)
+        // The state of the member may be not yet updated after it was
+        // reported broken by the wait, while it is no longer reported so.
+        if (gi->laststatus >= SRTS_BROKEN || gi->ps->core().m_bBroken)
         {
             broken.insert(gi->ps);
         }
@@ -1938,7 +2305,49 @@ void CUDTGroup::recv_CollectAliveAndBroken(vector<CUDTSocket*>& alive, set<CUDTS
 #undef HCLOG
 }
 
-vector<CUDTSocket*> CUDTGroup::recv_WaitForReadReady(const vector<CUDTSocket*>& aliveMembers, set<CUDTSocket*>& w_broken)
+CUDTGroup::time_point CUDTGroup::recv_CollectDraining(const set<CUDTSocket*>& broken,
+                                                      const set<CUDTSocket*>& discrepant,
+                                                      vector<CUDTSocket*>&    w_draining)
+{
+    time_point earliest;
+    const bool dedup = rcvDeduplicates();
+    const time_point now = steady_clock::now();
+
+    // Take the sockets from the member list, as those remembered
+    // as broken might have been removed from the group meanwhile.
+    for (gli_t gi = m_Group.begin(); gi != m_Group.end(); ++gi)
+    {
+        CUDTSocket* ps = gi->ps;
+        if (!broken.count(ps))
+            continue;
+
+        // Its readiness would otherwise end every wait for the others at once.
+        if (rcvIndexRetire(gi->id))
+            CUDT::uglobal().epoll_remove_socket_INTERNAL(m_RcvEID, ps);
+
+        if (!dedup || discrepant.count(ps))
+            continue;
+
+        ScopedLock lg(ps->core().m_RcvBufferLock);
+        const CRcvBuffer* rcvbuf = ps->core().m_pRcvBuffer;
+        if (!rcvbuf)
+            continue;
+
+        const CRcvBuffer::PacketInfo head = rcvbuf->getFirstValidPacketInfo();
+        if (head.seqno == SRT_SEQNO_NONE)
+            continue;
+
+        const time_point ready = rcvbuf->getFirstReadablePacketInfo(now).seqno != SRT_SEQNO_NONE ? now : head.tsbpd_time;
+        if (is_zero(earliest) || ready < earliest)
+            earliest = ready;
+        w_draining.push_back(ps);
+        HLOGC(grlog.Debug, log << "grp/recv: $" << id() << ": @" << gi->id << " broken, still has %" << head.seqno
+                << " to deliver");
+    }
+    return earliest;
+}
+
+vector<CUDTSocket*> CUDTGroup::recv_WaitForReadReady(const vector<CUDTSocket*>& aliveMembers, set<CUDTSocket*>& w_broken, int maxwait_ms)
 {
     if (aliveMembers.empty())
     {
@@ -1978,6 +2387,9 @@ vector<CUDTSocket*> CUDTGroup::recv_WaitForReadReady(const vector<CUDTSocket*>&
     // means to block indefinitely, also in swait().
     // In non-blocking mode use 0, which means to always return immediately.
     int timeout = m_bSynRecving ? m_iRcvTimeOut : 0;
+    const bool timeout_limited = maxwait_ms >= 0 && (timeout < 0 || timeout > maxwait_ms);
+    if (timeout_limited)
+        timeout = maxwait_ms;
     int nready = 0;
     // Poll on this descriptor until reading is available, indefinitely.
     CEPoll::fmap_t sready;
@@ -1998,6 +2410,12 @@ vector<CUDTSocket*> CUDTGroup::recv_WaitForReadReady(const vector<CUDTSocket*>&
 
     HLOGC(grlog.Debug, log << "group/recv: " << nready << " RDY: " << DisplayEpollResults(sready));
 
+    if (nready == 0 && timeout_limited)
+    {
+        leaveCS(CUDT::uglobal().m_GlobControlLock);
+        return vector<CUDTSocket*>();
+    }
+
     if (nready == 0)
     {
         // GlobControlLock is applied manually, so unlock manually.
@@ -2117,6 +2535,104 @@ int32_t CUDTGroup::getRcvBaseSeqNo()
     return m_RcvBaseSeqNo;
 }
 
+bool CUDTGroup::rcvIndexPacket(SRTSOCKET id, int32_t seqno, size_t capacity)
+{
+    ScopedLock lk(m_RcvIndexLock);
+    if (m_RcvIndexStartSeq == SRT_SEQNO_NONE)
+    {
+        // The first packet received by the group since it was (re)connected.
+        m_RcvIndex.assign(capacity, SRT_INVALID_SOCK);
+        m_iRcvIndexStartPos = 0;
+        m_RcvIndexStartSeq  = seqno;
+    }
+
+    // A packet before the index start was already delivered; a packet beyond
+    // the index range would not fit in the member's buffer either. Both cases
+    // are left to the member to handle.
+    const int offset = CSeqNo::seqoff(m_RcvIndexStartSeq, seqno);
+    if (offset < 0 || offset >= int(m_RcvIndex.size()))
+        return true;
+
+    SRTSOCKET& holder = m_RcvIndex[(m_iRcvIndexStartPos + offset) % m_RcvIndex.size()];
+    if (holder != SRT_INVALID_SOCK && holder != id && !m_RcvIndexRetired.count(holder))
+    {
+        HLOGC(grlog.Debug, log << "grp/rcvIndexPacket: $" << this->id() << ": %" << seqno << " over @" << id
+                << " is a duplicate, already held by @" << holder);
+        return false;
+    }
+
+    holder = id;
+    return true;
+}
+
+void CUDTGroup::rcvIndexWithdraw(SRTSOCKET id, int32_t seqno)
+{
+    ScopedLock lk(m_RcvIndexLock);
+    if (m_RcvIndexStartSeq == SRT_SEQNO_NONE)
+        return;
+
+    const int offset = CSeqNo::seqoff(m_RcvIndexStartSeq, seqno);
+    if (offset < 0 || offset >= int(m_RcvIndex.size()))
+        return;
+
+    SRTSOCKET& holder = m_RcvIndex[(m_iRcvIndexStartPos + offset) % m_RcvIndex.size()];
+    if (holder == id)
+        holder = SRT_INVALID_SOCK;
+}
+
+void CUDTGroup::rcvIndexAdvance(int32_t seqno)
+{
+    ScopedLock lk(m_RcvIndexLock);
+    if (m_RcvIndexStartSeq == SRT_SEQNO_NONE)
+        return;
+
+    const int offset = CSeqNo::seqoff(m_RcvIndexStartSeq, seqno);
+    if (offset <= 0)
+        return;
+
+    if (offset >= int(m_RcvIndex.size()))
+    {
+        std::fill(m_RcvIndex.begin(), m_RcvIndex.end(), SRT_INVALID_SOCK);
+        m_iRcvIndexStartPos = 0;
+    }
+    else
+    {
+        for (int i = 0; i < offset; ++i)
+        {
+            m_RcvIndex[m_iRcvIndexStartPos] = SRT_INVALID_SOCK;
+            m_iRcvIndexStartPos = (m_iRcvIndexStartPos + 1) % m_RcvIndex.size();
+        }
+    }
+    m_RcvIndexStartSeq = seqno;
+}
+
+bool CUDTGroup::rcvIndexRetire(SRTSOCKET id)
+{
+    ScopedLock lk(m_RcvIndexLock);
+    if (!m_RcvIndexRetired.insert(id).second)
+        return false;
+
+    HLOGC(grlog.Debug, log << "grp/rcvIndexRetire: $" << this->id() << ": @" << id
+            << " broken, its packets are no longer counted as held");
+    return true;
+}
+
+void CUDTGroup::rcvIndexForget(SRTSOCKET id)
+{
+    ScopedLock lk(m_RcvIndexLock);
+    std::replace(m_RcvIndex.begin(), m_RcvIndex.end(), id, SRTSOCKET(SRT_INVALID_SOCK));
+    m_RcvIndexRetired.erase(id);
+}
+
+void CUDTGroup::rcvIndexReset()
+{
+    ScopedLock lk(m_RcvIndexLock);
+    m_RcvIndex.clear();
+    m_RcvIndexRetired.clear();
+    m_iRcvIndexStartPos = 0;
+    m_RcvIndexStartSeq  = SRT_SEQNO_NONE;
+}
+
 void CUDTGroup::updateWriteState()
 {
     ScopedLock lg(m_GroupLock);
@@ -2189,6 +2705,13 @@ int CUDTGroup::recv(char* buf, int len, SRT_MSGCTRL& w_mc)
     // if it was ever seen broken, so that it's skipped.
     set<CUDTSocket*> broken;
 
+    // Members broken by a sequence discrepancy, their packets aren't read.
+    set<CUDTSocket*> discrepant;
+
+    // The links of a balancing group carry different messages, each link in its
+    // own sequence, so they are ordered by the message numbers of the group.
+    const bool balancing = m_type == SRT_GTYPE_BALANCING;
+
     for (;;)
     {
         if (!m_bOpened || !m_bConnected)
@@ -2201,7 +2724,9 @@ int CUDTGroup::recv(char* buf, int len, SRT_MSGCTRL& w_mc)
 
         vector<CUDTSocket*> aliveMembers;
         recv_CollectAliveAndBroken(aliveMembers, broken);
-        if (aliveMembers.empty())
+        vector<CUDTSocket*> draining;
+        const steady_clock::time_point drain_time = recv_CollectDraining(broken, discrepant, (draining));
+        if (aliveMembers.empty() && draining.empty())
         {
             LOGC(grlog.Error, log << "grp/recv: ALL LINKS BROKEN, ABANDONING.");
             m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_IN, false);
@@ -2209,11 +2734,38 @@ int CUDTGroup::recv(char* buf, int len, SRT_MSGCTRL& w_mc)
         }
 
         vector<CUDTSocket*> readySockets;
-        if (m_bSynRecving)
-            readySockets = recv_WaitForReadReady(aliveMembers, broken);
+        if (!draining.empty() && (aliveMembers.empty() || drain_time <= steady_clock::now()))
+        {
+            // A broken member still has a packet to deliver, possibly the only ones left.
+            const steady_clock::time_point now = steady_clock::now();
+            if (drain_time > now)
+            {
+                HLOGC(grlog.Debug, log << "grp/recv: $" << id() << ": only broken links left, next packet due at "
+                        << FormatTime(drain_time));
+                if (!m_bSynRecving)
+                    throw CUDTException(MJ_AGAIN, MN_RDAVAIL, 0);
+
+                InvertedLock ug(m_GroupLock);
+                sync::this_thread::sleep_for(drain_time - now);
+                continue;
+            }
+            readySockets = aliveMembers;
+        }
+        else if (m_bSynRecving)
+        {
+            // Don't wait for the alive members longer than until the next
+            // packet of the broken ones is due; these may have the last ones.
+            const int maxwait_ms = draining.empty()
+                ? -1
+                : int(count_milliseconds(drain_time - steady_clock::now())) + 1;
+            readySockets = recv_WaitForReadReady(aliveMembers, broken, maxwait_ms);
+        }
         else
             readySockets = aliveMembers;
 
+        // The members being drained are read as any other from now on.
+        aliveMembers.insert(aliveMembers.end(), draining.begin(), draining.end());
+
         if (m_bClosing)
         {
             HLOGC(grlog.Debug, log << "grp/recv: $" << id() << ": GROUP CLOSED, ABANDONING.");
@@ -2222,12 +2774,27 @@ int CUDTGroup::recv(char* buf, int len, SRT_MSGCTRL& w_mc)
 
         // Find the first readable packet among all member sockets.
         CUDTSocket*               socketToRead = NULL;
-        CRcvBuffer::PacketInfo infoToRead   = {-1, false, time_point()};
-        for (vector<CUDTSocket*>::const_iterator si = readySockets.begin(); si != readySockets.end(); ++si)
+        CRcvBuffer::PacketInfo infoToRead   = {-1, false, time_point(), SRT_MSGNO_NONE};
+        CRcvBuffer::PacketInfo pendingInfo  = {-1, false, time_point(), SRT_MSGNO_NONE};
+        // The members of a balancing group are all checked, as the read-ready
+        // state of the one carrying the next message may not be signalled yet.
+        // The same applies to the redundant groups, where every packet is stored
+        // by one member only (see rcvIndexPacket()).
+        const bool dedup = rcvDeduplicates();
+        const vector<CUDTSocket*>& candidates = (balancing || dedup) ? aliveMembers : readySockets;
+        for (vector<CUDTSocket*>::const_iterator si = candidates.begin(); si != candidates.end(); ++si)
         {
             CUDTSocket* ps = *si;
 
             ScopedLock lg(ps->core().m_RcvBufferLock);
+            if (balancing)
+            {
+                if (!recv_BalancingCandidate(ps, socketToRead, (infoToRead), (pendingInfo)))
+                    continue;
+                socketToRead = ps;
+                continue;
+            }
+
             if (m_RcvBaseSeqNo != SRT_SEQNO_NONE)
             {
                 // Drop here to make sure the getFirstReadablePacketInfo() below return fresher packet.
@@ -2244,6 +2811,13 @@ int CUDTGroup::recv(char* buf, int len, SRT_MSGCTRL& w_mc)
                 ps->core().m_pRcvBuffer->getFirstReadablePacketInfo(steady_clock::now());
             if (info.seqno == SRT_SEQNO_NONE)
             {
+                // The packet this member holds may be due a moment later than the
+                // next one held by another member, as their time bases slightly differ.
+                const CRcvBuffer::PacketInfo head = ps->core().m_pRcvBuffer->getFirstValidPacketInfo();
+                if (dedup && head.seqno != SRT_SEQNO_NONE && !head.seq_gap
+                        && (pendingInfo.seqno == SRT_SEQNO_NONE || CSeqNo::seqcmp(head.seqno, pendingInfo.seqno) < 0))
+                    pendingInfo = head;
+
                 HLOGC(grlog.Debug, log << "grp/recv: $" << id() << ": @" << ps->m_SocketID << ": Nothing to read.");
                 continue;
             }
@@ -2254,7 +2828,9 @@ int CUDTGroup::recv(char* buf, int len, SRT_MSGCTRL& w_mc)
                      log << "grp/recv: $" << id() << ": @" << ps->m_SocketID << ": SEQUENCE DISCREPANCY: base=%"
                          << m_RcvBaseSeqNo << " vs pkt=%" << info.seqno << ", setting ESECFAIL");
                 ps->core().m_bBroken = true;
+                m_Global.scheduleGC(ps->m_SocketID);
                 broken.insert(ps);
+                discrepant.insert(ps);
                 continue;
             }
             if (socketToRead == NULL || CSeqNo::seqcmp(info.seqno, infoToRead.seqno) < 0)
@@ -2264,6 +2840,24 @@ int CUDTGroup::recv(char* buf, int len, SRT_MSGCTRL& w_mc)
             }
         }
 
+        if (socketToRead && pendingInfo.seqno != SRT_SEQNO_NONE
+                && (balancing ? MsgNo(pendingInfo.msgno) < MsgNo(infoToRead.msgno)
+                              : CSeqNo::seqcmp(pendingInfo.seqno, infoToRead.seqno) < 0))
+        {
+            HLOGC(grlog.Debug,
+                  log << "grp/recv: $" << id() << ": %" << infoToRead.seqno << " #" << infoToRead.msgno << " ready, but %"
+                      << pendingInfo.seqno << " #" << pendingInfo.msgno << " is due at " << FormatTime(pendingInfo.tsbpd_time));
+            if (m_bSynRecving)
+            {
+                InvertedLock ug(m_GroupLock);
+                const steady_clock::time_point now = steady_clock::now();
+                if (pendingInfo.tsbpd_time > now)
+                    sync::this_thread::sleep_for(pendingInfo.tsbpd_time - now);
+                continue;
+            }
+            socketToRead = NULL;
+        }
+
         if (socketToRead == NULL)
         {
             if (m_bSynRecving)
@@ -2309,9 +2903,19 @@ int CUDTGroup::recv(char* buf, int len, SRT_MSGCTRL& w_mc)
         }
         fillGroupData((w_mc), w_mc);
 
-        HLOGC(grlog.Debug,
-              log << "grp/recv: $" << id() << ": Update m_RcvBaseSeqNo: %" << m_RcvBaseSeqNo << " -> %" << w_mc.pktseq);
-        m_RcvBaseSeqNo = w_mc.pktseq;
+        if (balancing)
+        {
+            HLOGC(grlog.Debug,
+                  log << "grp/recv: $" << id() << ": Update m_RcvLastMsgNo: #" << m_RcvLastMsgNo << " -> #" << w_mc.msgno);
+            m_RcvLastMsgNo = w_mc.msgno;
+        }
+        else
+        {
+            HLOGC(grlog.Debug,
+                  log << "grp/recv: $" << id() << ": Update m_RcvBaseSeqNo: %" << m_RcvBaseSeqNo << " -> %" << w_mc.pktseq);
+            m_RcvBaseSeqNo = w_mc.pktseq;
+            rcvIndexAdvance(CSeqNo::incseq(m_RcvBaseSeqNo));
+        }
 
         // Update stats as per delivery
         m_stats.recv.count(res);
@@ -2349,6 +2953,52 @@ int CUDTGroup::recv(char* buf, int len, SRT_MSGCTRL& w_mc)
     throw CUDTException(MJ_AGAIN, MN_RDAVAIL, 0);
 }
 
+// [[using locked(ps->core().m_RcvBufferLock)]]
+bool CUDTGroup::recv_BalancingCandidate(CUDTSocket*             ps,
+                                        CUDTSocket*             socketToRead,
+                                        CRcvBuffer::PacketInfo& w_infoToRead,
+                                        CRcvBuffer::PacketInfo& w_pendingInfo)
+{
+    CUDT& u = ps->core();
+    const CRcvBuffer::PacketInfo head = u.m_pRcvBuffer->getFirstValidPacketInfo();
+    if (head.seqno == SRT_SEQNO_NONE)
+    {
+        HLOGC(grlog.Debug, log << "grp/recv: $" << id() << ": @" << ps->m_SocketID << ": Nothing to read.");
+        return false;
+    }
+
+    // A message that comes only now, while a later one has been
+    // delivered already over another link, is too late.
+    if (m_RcvLastMsgNo != SRT_MSGNO_NONE && !(MsgNo(m_RcvLastMsgNo) < MsgNo(head.msgno)))
+    {
+        const int cnt = u.rcvDropTooLateUpTo(CSeqNo::incseq(head.seqno));
+        HLOGC(grlog.Debug,
+              log << "grp/recv: $" << id() << ": @" << ps->m_SocketID << ": #" << head.msgno
+                  << " behind delivered #" << m_RcvLastMsgNo << ", dropped " << cnt << " packets");
+        (void)cnt;
+        return false;
+    }
+
+    const CRcvBuffer::PacketInfo info = u.m_pRcvBuffer->getFirstReadablePacketInfo(steady_clock::now());
+    if (info.seqno == SRT_SEQNO_NONE)
+    {
+        // The time base of every link is a bit different, so a message may be
+        // due a moment later than the next one received over another link.
+        if (!head.seq_gap && (w_pendingInfo.seqno == SRT_SEQNO_NONE || MsgNo(head.msgno) < MsgNo(w_pendingInfo.msgno)))
+            w_pendingInfo = head;
+
+        HLOGC(grlog.Debug,
+              log << "grp/recv: $" << id() << ": @" << ps->m_SocketID << ": #" << head.msgno << " not ready yet.");
+        return false;
+    }
+
+    if (socketToRead && !(MsgNo(info.msgno) < MsgNo(w_infoToRead.msgno)))
+        return false;
+
+    w_infoToRead = info;
+    return true;
+}
+
 const char* CUDTGroup::StateStr(CUDTGroup::GroupState st)
 {
     static const char* const states[] = {"PENDING", "IDLE", "RUNNING", "BROKEN"};
@@ -2609,6 +3259,8 @@ void CUDTGroup::sendBackup_QualifyMemberStates(SendBackupCtx& w_sendBackupCtx, c
 
         if (d->sndstate == SRT_GST_IDLE)
         {
+            // The health of a link is sampled from its activation.
+            d->health.reset();
             const BackupMemberState idle_state = sendBackup_QualifyIfStandBy(d);
             sendBackup_AssignBackupState(d->ps->core(), idle_state, currtime);
             w_sendBackupCtx.recordMemberState(&(*d), idle_state);
@@ -2626,6 +3278,7 @@ void CUDTGroup::sendBackup_QualifyMemberStates(SendBackupCtx& w_sendBackupCtx, c
 
         if (d->sndstate == SRT_GST_RUNNING)
         {
+            sendBackup_CheckLinkHealth(d, currtime);
             const BackupMemberState active_state = sendBackup_QualifyActiveState(d, currtime);
             sendBackup_AssignBackupState(d->ps->core(), active_state, currtime);
             w_sendBackupCtx.recordMemberState(&(*d), active_state);
@@ -2741,11 +3394,15 @@ CUDTGroup::BackupMemberState CUDTGroup::sendBackup_QualifyActiveState(const gli_
         ? initial_stabtout_us // activation phase
         : min<int64_t>(max<int64_t>(min_stability_us, 2 * u.SRTT() + 4 * u.RTTVar()), latency_us);
 
-    const steady_clock::time_point last_rsp = max(u.freshActivationStart(), u.lastRspTime());
+    // A response is awaited only for the packets sent and not acknowledged
+    // yet (see sendBackup_CheckLinkHealth()), not between the packets of
+    // a low rate stream.
+    const steady_clock::time_point unacked_since = d->health.tsUnackedSince;
+    const steady_clock::time_point last_rsp = max(max(u.freshActivationStart(), u.lastRspTime()), unacked_since);
     const steady_clock::duration td_response = currtime - last_rsp;
 
     // No response for a long time
-    if (count_microseconds(td_response) > stability_tout_us)
+    if (!is_zero(unacked_since) && count_microseconds(td_response) > stability_tout_us)
     {
         return BKUPST_ACTIVE_UNSTABLE;
     }
@@ -2789,6 +3446,105 @@ CUDTGroup::BackupMemberState CUDTGroup::sendBackup_QualifyActiveState(const gli_
     return BKUPST_ACTIVE_STABLE;
 }
 
+// [[using locked(this->m_GroupLock)]]
+void CUDTGroup::sendBackup_CheckLinkHealth(const gli_t d, const time_point& currtime)
+{
+    LinkHealth& h = d->health;
+    CUDT&       u = d->ps->core();
+
+    if (!is_zero(h.tsLastSample) && count_microseconds(currtime - h.tsLastSample) < CUDT::COMM_SYN_INTERVAL_US)
+        return;
+
+    enterCS(u.m_StatsLock);
+    const int64_t sent_total    = u.m_stats.sndr.sent.total.count();
+    const int64_t retrans_total = u.m_stats.sndr.sentRetrans.total.count();
+    leaveCS(u.m_StatsLock);
+
+    int bytes SRT_ATR_UNUSED = 0, span_ms = 0;
+    u.m_pSndBuffer->getCurrBufSize((bytes), (span_ms));
+
+    const int srtt_us   = u.SRTT();
+    const int rttvar_us = u.RTTVar();
+
+    // A response is awaited only while some packets are unacknowledged.
+    // They are known sent since the first sample that has found them,
+    // after the ACK position moved for the last time.
+    const int32_t last_ack = u.m_iSndLastAck;
+    if (u.getFlightSpan() == 0)
+        h.tsUnackedSince = time_point();
+    else if (is_zero(h.tsUnackedSince) || last_ack != h.sndLastAck)
+        h.tsUnackedSince = currtime;
+    h.sndLastAck = last_ack;
+
+    if (is_zero(h.tsLastSample))
+    {
+        // First sample since the link was activated, nothing to compare yet.
+        h.tsLastSample    = currtime;
+        h.pktSentTotal    = sent_total;
+        h.pktRetransTotal = retrans_total;
+        h.rttVarBase      = rttvar_us;
+        h.sndSpanMs       = span_ms;
+        return;
+    }
+
+    const int64_t sent    = sent_total - h.pktSentTotal;
+    const int64_t retrans = retrans_total - h.pktRetransTotal;
+    if (sent > 0)
+        h.retransRate = avg_iir<8>(h.retransRate, double(retrans) / sent);
+
+    // ACKs come at least every COMM_SYN_INTERVAL_US while sending, so a response
+    // delayed by a few of them, plus the RTT, is a sign of a link getting
+    // blocked. Not less than the minimum stability timeout, though, as the
+    // activation of the other links is no sooner wanted.
+    const int64_t    rsp_tmo_us  = max<int64_t>(m_uOPT_MinStabilityTimeout_us,
+                                               srtt_us + 4 * rttvar_us + 3 * CUDT::COMM_SYN_INTERVAL_US);
+    const time_point rsp_since   = max(max(u.freshActivationStart(), u.lastRspTime()), h.tsUnackedSince);
+    const bool       rsp_delayed = !is_zero(h.tsUnackedSince) && count_microseconds(currtime - rsp_since) > rsp_tmo_us;
+
+    // The RTT gets unsteady before it grows.
+    const bool rtt_unsteady = rttvar_us > 2 * h.rttVarBase + 1000;
+
+    const bool retrans_high = h.retransRate > 0.05;
+
+    // The sender buffer keeps packets until ACK-ed, so it normally spans about
+    // one RTT plus the ACK period. Growing beyond that means the link doesn't
+    // carry the stream anymore.
+    const bool span_excess = int64_t(span_ms) * 1000 > srtt_us + 4 * rttvar_us + 2 * CUDT::COMM_SYN_INTERVAL_US;
+    if (span_excess && span_ms > h.sndSpanMs)
+        ++h.sndGrowth;
+    else if (!span_excess)
+        h.sndGrowth = 0;
+    const bool sndbuf_growing = h.sndGrowth >= 3;
+
+    const int  symptoms  = int(rtt_unsteady) + int(retrans_high) + int(sndbuf_growing);
+    const bool degrading = rsp_delayed || symptoms >= 2;
+
+    h.tsLastSample    = currtime;
+    h.pktSentTotal    = sent_total;
+    h.pktRetransTotal = retrans_total;
+    h.sndSpanMs       = span_ms;
+    h.rttVarBase      = avg_iir<16>(h.rttVarBase, double(rttvar_us));
+
+    if (degrading)
+    {
+        if (!h.degrading)
+        {
+            LOGC(gslog.Warn,
+                 log << "grp/sendBackup: @" << d->id << " DEGRADING: rsp-delay="
+                     << count_milliseconds(currtime - rsp_since) << "ms rtt=" << srtt_us << "us rttvar="
+                     << rttvar_us << "us retrans=" << (h.retransRate * 100) << "% sndbuf=" << span_ms << "ms");
+        }
+        h.degrading      = true;
+        h.healthySamples = 0;
+    }
+    else if (h.degrading && ++h.healthySamples >= 20)
+    {
+        // Healthy for a while (at least 20 samples, 200ms), recovered.
+        LOGC(gslog.Note, log << "grp/sendBackup: @" << d->id << " recovered from degrading");
+        h.degrading = false;
+    }
+}
+
 // [[using locked(this->m_GroupLock)]]
 bool CUDTGroup::sendBackup_CheckSendStatus(const steady_clock::time_point& currtime SRT_ATR_UNUSED,
                                            const int                       send_status,
@@ -2900,6 +3656,19 @@ void CUDTGroup::sendBackup_Buffering(const char* buf, const int len, int32_t& w_
         m_iLastSchedSeqNo = oldest_buffer_seq;
 }
 
+// Number of stable members that are predicted to get unstable.
+static unsigned countDegradingStable(const SendBackupCtx& sendBackupCtx)
+{
+    unsigned num = 0;
+    typedef vector<BackupMemberStateEntry>::const_iterator const_iter_t;
+    for (const_iter_t member = sendBackupCtx.memberStates().begin(); member != sendBackupCtx.memberStates().end(); ++member)
+    {
+        if (member->state == BKUPST_ACTIVE_STABLE && member->pSocketData->health.degrading)
+            ++num;
+    }
+    return num;
+}
+
 size_t CUDTGroup::sendBackup_TryActivateStandbyIfNeeded(
     const char* buf,
     const int   len,
@@ -2927,6 +3696,14 @@ size_t CUDTGroup::sendBackup_TryActivateStandbyIfNeeded(
             << "Reason: no stable links"
         );
     }
+    else if (num_fresh == 0 && countDegradingStable(w_sendBackupCtx) == num_stable)
+    {
+        // Warm up a stand-by link while the active one still works.
+        LOGC(gslog.Warn,
+            log << "grp/sendBackup: trying to activate a stand-by link (" << num_standby << " available). "
+            << "Reason: all stable links are degrading"
+        );
+    }
     else if (w_sendBackupCtx.maxActiveWeight() < w_sendBackupCtx.maxStandbyWeight())
     {
         LOGC(gslog.Warn,
@@ -3454,7 +4231,7 @@ void CUDTGroup::sendBackup_SilenceRedundantLinks(SendBackupCtx& w_sendBackupCtx,
     // even if it means temporarily full redundancy.
     // A member can be silenced only if there is at least one stable memebr.
     const unsigned num_stable = w_sendBackupCtx.countMembersByState(BKUPST_ACTIVE_STABLE);
-    if (num_stable == 0)
+    if (num_stable == 0 || countDegradingStable(w_sendBackupCtx) == num_stable)
         return;
 
     // INPUT NEEDED:
@@ -3476,6 +4253,11 @@ void CUDTGroup::sendBackup_SilenceRedundantLinks(SendBackupCtx& w_sendBackupCtx,
 
         if (member->state == BKUPST_ACTIVE_STABLE)
         {
+            // A degrading link keeps sending until it's qualified unstable,
+            // but it can't be the one to silence the others in favor of.
+            if (!haveHigherWeightStable && member->pSocketData->health.degrading)
+                continue;
+
             // silence stable link if it is not the first stable
             if (!haveHigherWeightStable)
             {
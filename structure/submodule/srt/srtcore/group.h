@@ -162,6 +162,9 @@ public:
         {
             m_Group.erase(f);
 
+            // The packets held by this member are gone with it.
+            rcvIndexForget(id);
+
             // Reset sequence numbers on a dead group so that they are
             // initialized anew with the new alive connection within
             // the group.
@@ -205,15 +208,32 @@ public:
 
     void setGroupConnected();
 
-    int            send(const char* buf, int len, SRT_MSGCTRL& w_mc);
-    int            sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc);
+    /// Send a message over the group. If @a payload is given, the sender
+    /// buffers of the members refer to it instead of copying the data
+    /// (broadcast groups only).
+    int            send(const char* buf, int len, SRT_MSGCTRL& w_mc, CSndPayload* payload = NULL);
+    int            sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc, CSndPayload* payload = NULL);
     int            sendBackup(const char* buf, int len, SRT_MSGCTRL& w_mc);
+    int            sendBalancing(const char* buf, int len, SRT_MSGCTRL& w_mc, CSndPayload* payload = NULL);
     static int32_t generateISN();
 
 private:
+    /// Select the member link to send the next message of a balancing group.
+    /// The links share the data in proportion to their weights if all of them
+    /// have a weight set, otherwise to their estimated bandwidth. A link that
+    /// can't deliver within the latency is skipped while there are others
+    /// that can.
+    /// @param links running member links, not yet tried for this message
+    /// @returns position of the selected link in @a links
+    size_t sendBalancing_SelectLink(const std::vector<gli_t>& links);
+
     // For Backup, sending all previous packet
     int sendBackupRexmit(srt::CUDT& core, SRT_MSGCTRL& w_mc);
 
+    /// Check if a member sends the payload as is, so that it can use
+    /// the payload stored once for all members by sendBroadcast.
+    static bool sendBroadcast_IsPlaintext(const CUDT& u);
+
     // Support functions for sendBackup and sendBroadcast
     /// Check if group member is idle.
     /// @param d group member
@@ -241,6 +261,12 @@ private:
 
     BackupMemberState sendBackup_QualifyIfStandBy(const gli_t d);
 
+    /// Sample the health of an active link: the RTT variance trend, the share of
+    /// retransmissions and the growth of the sender buffer, as well as a response
+    /// delay shorter than the stability timeout. Updates @a d->health.degrading,
+    /// which makes a stand-by link warm up before the link is qualified unstable.
+    void sendBackup_CheckLinkHealth(const gli_t d, const time_point& currtime);
+
     /// Sends the same payload over all active members.
     /// @param[in] buf payload
     /// @param[in] len payload length in bytes
@@ -331,7 +357,7 @@ public:
     {
         // XXX add here also other group types, which
         // predict group receiving.
-        return m_type == SRT_GTYPE_BROADCAST;
+        return m_type == SRT_GTYPE_BROADCAST || m_type == SRT_GTYPE_BALANCING;
     }
 
     sync::Mutex* exp_groupLock() { return &m_GroupLock; }
@@ -369,6 +395,26 @@ public:
     /// @param ack The past-the-last-received ACK sequence number
     void readyPackets(srt::CUDT* core, int32_t ack);
 
+    /// Redundant groups (broadcast and backup) keep a receiver index that
+    /// records, per sequence number not yet delivered, the member that stores
+    /// the packet, so that the copies coming in over the other members are
+    /// not stored again.
+    bool rcvDeduplicates() const { return m_type == SRT_GTYPE_BROADCAST || m_type == SRT_GTYPE_BACKUP; }
+
+    /// Check the packet that has just come in over the member @a id against
+    /// the receiver index and record this member as its holder, if none is.
+    /// [[using locked(CUDT::m_RcvBufferLock)]] of the member
+    ///
+    /// @param id member socket that received the packet
+    /// @param seqno sequence number of the packet
+    /// @param capacity capacity of the member's receiver buffer (index size)
+    /// @return false if another alive member already stores this packet
+    bool rcvIndexPacket(SRTSOCKET id, int32_t seqno, size_t capacity);
+
+    /// Withdraw the record made by rcvIndexPacket() for a packet that the
+    /// member rejected after all (e.g. it failed to decrypt).
+    void rcvIndexWithdraw(SRTSOCKET id, int32_t seqno);
+
     void syncWithSocket(const srt::CUDT& core, const HandshakeSide side);
     int  getGroupData(SRT_SOCKGROUPDATA* pdata, size_t* psize);
     int  getGroupData_LOCKED(SRT_SOCKGROUPDATA* pdata, size_t* psize);
@@ -620,7 +666,7 @@ private:
     // that does use sender buffer.
     int32_t addMessageToBuffer(const char* buf, size_t len, SRT_MSGCTRL& w_mc);
 
-    std::set<int>      m_sPollID; // set of epoll ID to trigger
+    CEPollSubscribers  m_sPollID; // set of epoll ID to trigger
     int                m_iMaxPayloadSize;
     int                m_iAvgPayloadSize;
     bool               m_bSynRecving;
@@ -645,20 +691,73 @@ private:
 
     void recv_CollectAliveAndBroken(std::vector<srt::CUDTSocket*>& w_alive, std::set<srt::CUDTSocket*>& w_broken);
 
+    /// Stop polling the broken members for reading, retire them from the
+    /// receiver index and collect those of
+    /// a redundant group that still store packets. These packets are not stored
+    /// by the other members (see rcvIndexPacket()), so they are read until drained.
+    /// [[using locked(m_GroupLock)]]
+    ///
+    /// @param broken the members found broken
+    /// @param discrepant the broken members whose packets are not to be read
+    /// @param[out] w_draining the broken members with packets to read
+    /// @returns the earliest time when a packet of @a w_draining is ready to play
+    time_point recv_CollectDraining(const std::set<srt::CUDTSocket*>& broken,
+                                    const std::set<srt::CUDTSocket*>& discrepant,
+                                    std::vector<srt::CUDTSocket*>&    w_draining);
+
+    /// Check if the first readable message of a balancing group member is
+    /// the one to deliver next, as the earliest one among the members checked
+    /// so far. A message older than the one delivered last is dropped.
+    /// @param ps the group member
+    /// @param socketToRead the member found so far, NULL if none
+    /// @param[in,out] w_infoToRead the readable packet of @a socketToRead, replaced if @a ps has an earlier one
+    /// @param[in,out] w_pendingInfo the earliest message received, but not ready to play yet
+    /// @returns true if @a ps has the earliest readable message
+    bool recv_BalancingCandidate(srt::CUDTSocket*             ps,
+                                 srt::CUDTSocket*             socketToRead,
+                                 srt::CRcvBuffer::PacketInfo& w_infoToRead,
+                                 srt::CRcvBuffer::PacketInfo& w_pendingInfo);
+
     /// The function polls alive member sockets and retrieves a list of read-ready.
     /// [acquires lock for CUDT::uglobal()->m_GlobControlLock]
     /// [[using locked(m_GroupLock)]] temporally unlocks-locks internally
     ///
+    /// @param maxwait_ms if not -1, wait at most this long and return an empty list then
     /// @returns list of read-ready sockets
     /// @throws CUDTException(MJ_CONNECTION, MN_NOCONN, 0)
     /// @throws CUDTException(MJ_AGAIN, MN_RDAVAIL, 0)
-    std::vector<srt::CUDTSocket*> recv_WaitForReadReady(const std::vector<srt::CUDTSocket*>& aliveMembers, std::set<srt::CUDTSocket*>& w_broken);
+    std::vector<srt::CUDTSocket*> recv_WaitForReadReady(const std::vector<srt::CUDTSocket*>& aliveMembers,
+                                                        std::set<srt::CUDTSocket*>&          w_broken,
+                                                        int                                  maxwait_ms = -1);
 
     // This is the sequence number of a packet that has been previously
     // delivered. Initially it should be set to SRT_SEQNO_NONE so that the sequence read
     // from the first delivering socket will be taken as a good deal.
     sync::atomic<int32_t> m_RcvBaseSeqNo;
 
+    // Balancing groups: message number of the message that has been previously
+    // delivered, as the sequence numbers are different on every link.
+    int32_t m_RcvLastMsgNo;
+
+    // Receiver index of the redundant groups, see rcvIndexPacket(). It is a ring
+    // of the member sockets holding the packets since m_RcvIndexStartSeq.
+    // Members found broken are retired: their records no longer count, so
+    // the other members store these packets again while the broken ones are
+    // read until drained. Lock order: the innermost one.
+    sync::Mutex             m_RcvIndexLock;
+    std::vector<SRTSOCKET>  m_RcvIndex;
+    size_t                  m_iRcvIndexStartPos;
+    int32_t                 m_RcvIndexStartSeq;
+    std::set<SRTSOCKET>     m_RcvIndexRetired;
+
+    /// Move the receiver index start to @a seqno (the packets before it
+    /// have been delivered or dropped by the group).
+    void rcvIndexAdvance(int32_t seqno);
+    /// @return true if @a id has just been retired, false if it already was.
+    bool rcvIndexRetire(SRTSOCKET id);
+    void rcvIndexForget(SRTSOCKET id);
+    void rcvIndexReset();
+
     bool m_bOpened;    // Set to true when at least one link is at least pending
     bool m_bConnected; // Set to true on first link confirmed connected
     bool m_bClosing;
@@ -674,7 +773,8 @@ private:
     sync::Condition       m_RcvDataCond;
     sync::Mutex           m_RcvDataLock;
     sync::atomic<int32_t> m_iLastSchedSeqNo; // represetnts the value of CUDT::m_iSndNextSeqNo for each running socket
-    sync::atomic<int32_t> m_iLastSchedMsgNo;
+    sync::atomic<int32_t> m_iLastSchedMsgNo; // Balancing groups: message number for the next message
+    double                m_dBalancingVirtTime; // Balancing groups: pocket of the link that was last selected
     // Statistics
 
     struct Stats
@@ -754,6 +854,8 @@ public:
         // this is going to be past the ISN, at worst it will be caused
         // by TLPKTDROP.
         m_RcvBaseSeqNo = SRT_SEQNO_NONE;
+        m_RcvLastMsgNo = SRT_MSGNO_NONE;
+        rcvIndexReset();
     }
 
     bool applyGroupTime(time_point& w_start_time, time_point& w_peer_start_time)
@@ -799,7 +901,7 @@ public:
     SRTU_PROPERTY_RW_CHAIN(CUDTGroup, SRTSOCKET, peerid, m_PeerGroupID);
     SRTU_PROPERTY_RW_CHAIN(CUDTGroup, SRT_GROUP_TYPE, type, m_type);
     SRTU_PROPERTY_RW_CHAIN(CUDTGroup, int32_t, currentSchedSequence, m_iLastSchedSeqNo);
-    SRTU_PROPERTY_RRW(std::set<int>&, epollset, m_sPollID);
+    SRTU_PROPERTY_RR(CEPollSubscribers&, epollset, m_sPollID);
     SRTU_PROPERTY_RW_CHAIN(CUDTGroup, int64_t, latency_us, m_iTsbPdDelay_us);
     SRTU_PROPERTY_RO(bool, closing, m_bClosing);
 };
@@ -54,7 +54,9 @@ SocketData prepareSocketData(CUDTSocket* s)
         false,
         false,
         0, // weight
-        0  // pktSndDropTotal
+        0, // pocket
+        0, // pktSndDropTotal
+        LinkHealth()
     };
     return sd;
 }
@@ -28,6 +28,41 @@ namespace groups
 {
     typedef SRT_MEMBERSTATUS GroupState;
 
+    /// Health of a member link of a main/backup group, sampled while sending,
+    /// used to predict that the link is going to be unstable, before it stops
+    /// responding for the whole stability timeout.
+    struct LinkHealth
+    {
+        sync::steady_clock::time_point tsLastSample;
+        int64_t pktSentTotal;    // Number of packets sent at the last sample
+        int64_t pktRetransTotal; // Number of packets retransmitted at the last sample
+        double  retransRate;     // Smoothed share of retransmitted packets
+        double  rttVarBase;      // Slowly smoothed RTTVar, as the reference for its trend
+        int     sndSpanMs;       // Time span of the packets in the sender buffer at the last sample
+        int     sndGrowth;       // Number of consecutive samples with the sender buffer growing
+        int     healthySamples;  // Number of consecutive samples without symptoms since degrading
+        int32_t sndLastAck;      // ACK position at the last sample
+        sync::steady_clock::time_point tsUnackedSince; // First sample with the current unacknowledged packets
+        bool    degrading;
+
+        LinkHealth() { reset(); }
+
+        void reset()
+        {
+            tsLastSample    = sync::steady_clock::time_point();
+            pktSentTotal    = 0;
+            pktRetransTotal = 0;
+            retransRate     = 0;
+            rttVarBase      = 0;
+            sndSpanMs       = 0;
+            sndGrowth       = 0;
+            healthySamples  = 0;
+            sndLastAck      = SRT_SEQNO_NONE;
+            tsUnackedSince  = sync::steady_clock::time_point();
+            degrading       = false;
+        }
+    };
+
     struct SocketData
     {
         SRTSOCKET      id; // same as ps->m_SocketID
@@ -47,8 +82,14 @@ namespace groups
         // Configuration
         uint16_t       weight;
 
+        // Balancing: cost of the data sent over the link so far
+        double         pocket;
+
         // Stats
         int64_t        pktSndDropTotal;
+
+        // Backup: prediction of the link instability
+        LinkHealth     health;
     };
 
     SocketData prepareSocketData(CUDTSocket* s);
@@ -52,6 +52,8 @@ modified by
 
 #include "platform_sys.h"
 
+#include <algorithm>
+
 #include "list.h"
 #include "packet.h"
 #include "logging.h"
@@ -70,6 +72,560 @@ using srt_logging::tslog;
 
 using namespace srt::sync;
 
+#if SRT_ENABLE_LOSSLIST_BITMAP
+
+namespace
+{
+// Index of the lowest set bit, x must not be 0.
+inline int lowestBit(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while ((x & 0xFF) == 0)
+    {
+        x >>= 8;
+        n += 8;
+    }
+    while ((x & 1) == 0)
+    {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+inline int countBits(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return int((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Mask of 'nbits' bits starting from bit 'off', off + nbits <= 64.
+inline uint64_t bitRange(int off, int nbits)
+{
+    const uint64_t m = nbits == 64 ? ~uint64_t(0) : ((uint64_t(1) << nbits) - 1);
+    return m << off;
+}
+} // namespace
+
+srt::CSeqBitmap::CSeqBitmap(int span)
+    : m_aWords()
+    , m_aSummary()
+    , m_iMask(0)
+{
+    // The capacity must divide the sequence number space (2^31),
+    // which is the case for every power of two up to 2^30.
+    int cap = WORD_BITS;
+    while (cap < span && cap < (1 << 30))
+        cap *= 2;
+
+    m_iMask = cap - 1;
+    m_aWords.resize(cap / WORD_BITS, 0);
+    m_aSummary.resize((m_aWords.size() + WORD_BITS - 1) / WORD_BITS, 0);
+}
+
+bool srt::CSeqBitmap::test(int32_t seqno) const
+{
+    const int pos = seqno & m_iMask;
+    return (m_aWords[pos / WORD_BITS] >> (pos % WORD_BITS)) & 1;
+}
+
+void srt::CSeqBitmap::markWord(int w)
+{
+    if (m_aWords[w])
+        m_aSummary[w / WORD_BITS] |= word_t(1) << (w % WORD_BITS);
+    else
+        m_aSummary[w / WORD_BITS] &= ~(word_t(1) << (w % WORD_BITS));
+}
+
+int srt::CSeqBitmap::set(int32_t seqlo, int32_t seqhi)
+{
+    const int count = CSeqNo::seqlen(seqlo, seqhi);
+    SRT_ASSERT(count > 0 && count <= capacity());
+
+    int changed = 0;
+    int pos     = seqlo & m_iMask;
+    for (int left = count; left > 0;)
+    {
+        const int w     = pos / WORD_BITS;
+        const int off   = pos % WORD_BITS;
+        const int nbits = std::min(WORD_BITS - off, left);
+        const word_t m  = bitRange(off, nbits);
+
+        changed += countBits(m & ~m_aWords[w]);
+        m_aWords[w] |= m;
+        markWord(w);
+
+        left -= nbits;
+        pos = (pos + nbits) & m_iMask;
+    }
+    return changed;
+}
+
+int srt::CSeqBitmap::clear(int32_t seqlo, int32_t seqhi)
+{
+    const int count = CSeqNo::seqlen(seqlo, seqhi);
+    SRT_ASSERT(count > 0 && count <= capacity());
+
+    int changed = 0;
+    int pos     = seqlo & m_iMask;
+    for (int left = count; left > 0;)
+    {
+        const int w     = pos / WORD_BITS;
+        const int off   = pos % WORD_BITS;
+        const int nbits = std::min(WORD_BITS - off, left);
+        const word_t m  = bitRange(off, nbits);
+
+        if (m_aWords[w] & m)
+        {
+            changed += countBits(m & m_aWords[w]);
+            m_aWords[w] &= ~m;
+            markWord(w);
+        }
+
+        left -= nbits;
+        pos = (pos + nbits) & m_iMask;
+    }
+    return changed;
+}
+
+// Find the first set bit in the bit positions [start, start + count),
+// wrapping around the end of the bitmap. Whole empty words are skipped
+// with the use of the summary bitmap.
+int srt::CSeqBitmap::findSetOffset(int start, int count) const
+{
+    const int cap = capacity();
+    for (int done = 0; done < count;)
+    {
+        const int pos = (start + done) & m_iMask;
+        const int end = std::min(pos + (count - done), cap);
+
+        int    w = pos / WORD_BITS;
+        word_t x = m_aWords[w] & (~word_t(0) << (pos % WORD_BITS));
+        while (x == 0)
+        {
+            ++w;
+            if (w * WORD_BITS >= end)
+                break;
+
+            // Skip the empty words.
+            int    sw = w / WORD_BITS;
+            word_t s  = m_aSummary[sw] & (~word_t(0) << (w % WORD_BITS));
+            while (s == 0 && (sw + 1) * WORD_BITS * WORD_BITS < end)
+                s = m_aSummary[++sw];
+            if (s == 0)
+                break;
+
+            w = sw * WORD_BITS + lowestBit(s);
+            if (w * WORD_BITS >= end)
+                break;
+            x = m_aWords[w];
+        }
+
+        if (x != 0)
+        {
+            const int found = w * WORD_BITS + lowestBit(x);
+            if (found < end)
+                return done + (found - pos);
+        }
+
+        done += end - pos;
+    }
+    return -1;
+}
+
+// Find the first clear bit in the bit positions [start, start + count),
+// wrapping around the end of the bitmap.
+int srt::CSeqBitmap::findClearOffset(int start, int count) const
+{
+    const int cap = capacity();
+    for (int done = 0; done < count;)
+    {
+        const int pos = (start + done) & m_iMask;
+        const int end = std::min(pos + (count - done), cap);
+
+        int    w = pos / WORD_BITS;
+        word_t x = ~m_aWords[w] & (~word_t(0) << (pos % WORD_BITS));
+        while (x == 0 && (w + 1) * WORD_BITS < end)
+            x = ~m_aWords[++w];
+
+        if (x != 0)
+        {
+            const int found = w * WORD_BITS + lowestBit(x);
+            if (found < end)
+                return done + (found - pos);
+        }
+
+        done += end - pos;
+    }
+    return -1;
+}
+
+int32_t srt::CSeqBitmap::findSet(int32_t seqlo, int32_t seqhi) const
+{
+    const int off = findSetOffset(seqlo & m_iMask, CSeqNo::seqlen(seqlo, seqhi));
+    return off == -1 ? SRT_SEQNO_NONE : CSeqNo::incseq(seqlo, off);
+}
+
+int32_t srt::CSeqBitmap::findClear(int32_t seqlo, int32_t seqhi) const
+{
+    const int off = findClearOffset(seqlo & m_iMask, CSeqNo::seqlen(seqlo, seqhi));
+    return off == -1 ? SRT_SEQNO_NONE : CSeqNo::incseq(seqlo, off);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+srt::CSndLossList::CSndLossList(int size)
+    : m_Bitmap(size * 2)
+    , m_iFirst(SRT_SEQNO_NONE)
+    , m_iLast(SRT_SEQNO_NONE)
+    , m_iLength(0)
+    , m_iSize(size)
+    , m_ListLock()
+{
+    // sender list needs mutex protection
+    setupMutex(m_ListLock, "LossList");
+}
+
+srt::CSndLossList::~CSndLossList()
+{
+    releaseMutex(m_ListLock);
+}
+
+void srt::CSndLossList::traceState() const
+{
+    traceState(std::cout) << "\n";
+}
+
+int srt::CSndLossList::insert(int32_t seqno1, int32_t seqno2)
+{
+    if (seqno1 < 0 || seqno2 < 0 ) {
+        LOGC(qslog.Error, log << "IPE: Tried to insert negative seqno " << seqno1 << ":" << seqno2
+            << " into sender's loss list. Ignoring.");
+        return 0;
+    }
+
+    const int inserted_range = CSeqNo::seqlen(seqno1, seqno2);
+    if (inserted_range <= 0 || inserted_range >= m_iSize) {
+        LOGC(qslog.Error, log << "IPE: Tried to insert too big range of seqno: " << inserted_range <<  ". Ignoring. "
+                << "seqno " << seqno1 << ":" << seqno2);
+        return 0;
+    }
+
+    ScopedLock listguard(m_ListLock);
+
+    if (m_iLength == 0)
+    {
+        m_Bitmap.set(seqno1, seqno2);
+        m_iFirst  = seqno1;
+        m_iLast   = seqno2;
+        m_iLength = inserted_range;
+        return m_iLength;
+    }
+
+    const int offset = CSeqNo::seqoff(m_iFirst, seqno1);
+    if (offset >= m_iSize)
+    {
+        LOGC(qslog.Error, log << "IPE: New loss record is too far from the first record. Ignoring. "
+                << "First loss seqno " << m_iFirst
+                << ", insert seqno " << seqno1 << ":" << seqno2);
+        return 0;
+    }
+
+    const int32_t first = offset < 0 ? seqno1 : m_iFirst;
+    const int32_t last  = CSeqNo::seqcmp(seqno2, m_iLast) > 0 ? seqno2 : m_iLast;
+    if (CSeqNo::seqlen(first, last) > m_Bitmap.capacity())
+    {
+        // The size of the CSndLossList should be at least the size of the flow window.
+        // It means that all the packets sender has sent should fit within m_iSize.
+        // If the new loss does not fit, there is some error.
+        LOGC(qslog.Error, log << "IPE: New loss record is too old. Ignoring. "
+            << "First loss seqno " << m_iFirst
+            << ", insert seqno " << seqno1 << ":" << seqno2);
+        return 0;
+    }
+
+    const int inserted = m_Bitmap.set(seqno1, seqno2);
+    m_iFirst = first;
+    m_iLast  = last;
+    m_iLength += inserted;
+    return inserted;
+}
+
+void srt::CSndLossList::removeUpTo(int32_t seqno)
+{
+    ScopedLock listguard(m_ListLock);
+
+    if (0 == m_iLength || CSeqNo::seqcmp(seqno, m_iFirst) < 0)
+        return;
+
+    if (CSeqNo::seqcmp(seqno, m_iLast) >= 0)
+    {
+        m_Bitmap.clear(m_iFirst, m_iLast);
+        m_iFirst  = SRT_SEQNO_NONE;
+        m_iLast   = SRT_SEQNO_NONE;
+        m_iLength = 0;
+        return;
+    }
+
+    // m_iLast is in the list, so there's at least this one left.
+    m_iLength -= m_Bitmap.clear(m_iFirst, seqno);
+    m_iFirst = m_Bitmap.findSet(CSeqNo::incseq(seqno), m_iLast);
+    SRT_ASSERT(m_iFirst != SRT_SEQNO_NONE && m_iLength > 0);
+}
+
+int srt::CSndLossList::getLossLength() const
+{
+    ScopedLock listguard(m_ListLock);
+
+    return m_iLength;
+}
+
+int32_t srt::CSndLossList::popLostSeq()
+{
+    ScopedLock listguard(m_ListLock);
+
+    if (0 == m_iLength)
+        return SRT_SEQNO_NONE;
+
+    const int32_t seqno = m_iFirst;
+    m_Bitmap.clear(seqno, seqno);
+    --m_iLength;
+
+    if (m_iLength == 0)
+    {
+        m_iFirst = SRT_SEQNO_NONE;
+        m_iLast  = SRT_SEQNO_NONE;
+    }
+    else
+    {
+        m_iFirst = m_Bitmap.findSet(CSeqNo::incseq(seqno), m_iLast);
+    }
+
+    return seqno;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+srt::CRcvLossList::CRcvLossList(int size)
+    : m_Bitmap(size * 2)
+    , m_iFirst(SRT_SEQNO_NONE)
+    , m_iLast(SRT_SEQNO_NONE)
+    , m_iLength(0)
+    , m_iLargestSeq(SRT_SEQNO_NONE)
+{
+}
+
+srt::CRcvLossList::~CRcvLossList() {}
+
+int srt::CRcvLossList::insert(int32_t seqno1, int32_t seqno2)
+{
+    SRT_ASSERT(seqno1 != SRT_SEQNO_NONE && seqno2 != SRT_SEQNO_NONE);
+    // Make sure that seqno2 isn't earlier than seqno1.
+    SRT_ASSERT(CSeqNo::seqcmp(seqno1, seqno2) <= 0);
+
+    // Data to be inserted must be larger than all those in the list
+    if (m_iLargestSeq != SRT_SEQNO_NONE && CSeqNo::seqcmp(seqno1, m_iLargestSeq) <= 0)
+    {
+        if (CSeqNo::seqcmp(seqno2, m_iLargestSeq) > 0)
+        {
+            LOGC(qrlog.Warn,
+                 log << "RCV-LOSS/insert: seqno1=" << seqno1 << " too small, adjust to "
+                     << CSeqNo::incseq(m_iLargestSeq));
+            seqno1 = CSeqNo::incseq(m_iLargestSeq);
+        }
+        else
+        {
+            LOGC(qrlog.Warn,
+                 log << "RCV-LOSS/insert: (" << seqno1 << "," << seqno2
+                     << ") to be inserted is too small: m_iLargestSeq=" << m_iLargestSeq << ", m_iLength=" << m_iLength
+                     << ", m_iFirst=" << m_iFirst << ", m_iLast=" << m_iLast << " -- REJECTING");
+            return 0;
+        }
+    }
+    m_iLargestSeq = seqno2;
+
+    const int32_t first = m_iLength == 0 ? seqno1 : m_iFirst;
+    if (CSeqNo::seqoff(first, seqno1) < 0)
+    {
+        LOGC(qrlog.Error,
+             log << "RCV-LOSS/insert: IPE: new LOSS %(" << seqno1 << "-" << seqno2 << ") PREDATES HEAD %"
+                 << m_iFirst << " -- REJECTING");
+        return -1;
+    }
+
+    if (CSeqNo::seqlen(first, seqno2) > m_Bitmap.capacity())
+    {
+        LOGC(qrlog.Error,
+             log << "RCV-LOSS/insert: IPE: new LOSS %(" << seqno1 << "-" << seqno2 << ") exceeds the capacity "
+                 << m_Bitmap.capacity() << " from HEAD %" << first << " -- REJECTING");
+        return -1;
+    }
+
+    const int n = m_Bitmap.set(seqno1, seqno2);
+    m_iFirst = first;
+    m_iLast  = seqno2;
+    m_iLength += n;
+    return n;
+}
+
+bool srt::CRcvLossList::remove(int32_t seqno)
+{
+    if (m_iLargestSeq == SRT_SEQNO_NONE || CSeqNo::seqcmp(seqno, m_iLargestSeq) > 0)
+        m_iLargestSeq = seqno;
+
+    if (0 == m_iLength)
+        return false;
+
+    if (CSeqNo::seqcmp(seqno, m_iFirst) < 0 || CSeqNo::seqcmp(seqno, m_iLast) > 0 || !m_Bitmap.test(seqno))
+        return false;
+
+    m_Bitmap.clear(seqno, seqno);
+    m_iLength--;
+    if (m_iLength == 0)
+    {
+        m_iFirst      = SRT_SEQNO_NONE;
+        m_iLast       = SRT_SEQNO_NONE;
+        m_iLargestSeq = SRT_SEQNO_NONE;
+    }
+    else if (seqno == m_iFirst)
+    {
+        m_iFirst = m_Bitmap.findSet(CSeqNo::incseq(seqno), m_iLast);
+    }
+
+    return true;
+}
+
+bool srt::CRcvLossList::remove(int32_t seqno1, int32_t seqno2)
+{
+    if (CSeqNo::seqcmp(seqno1, seqno2) > 0)
+    {
+        return false;
+    }
+    removeRange(seqno1, seqno2);
+    return true;
+}
+
+void srt::CRcvLossList::removeRange(int32_t seqno1, int32_t seqno2)
+{
+    if (0 == m_iLength)
+    {
+        if (m_iLargestSeq == SRT_SEQNO_NONE || CSeqNo::seqcmp(seqno2, m_iLargestSeq) > 0)
+            m_iLargestSeq = seqno2;
+        return;
+    }
+
+    const int32_t lo = CSeqNo::seqcmp(seqno1, m_iFirst) > 0 ? seqno1 : m_iFirst;
+    const int32_t hi = CSeqNo::seqcmp(seqno2, m_iLast) < 0 ? seqno2 : m_iLast;
+    bool          last_removed = false;
+    if (CSeqNo::seqcmp(lo, hi) <= 0)
+    {
+        last_removed = hi == seqno2 && m_Bitmap.test(seqno2);
+        m_iLength -= m_Bitmap.clear(lo, hi);
+        if (m_iLength > 0 && lo == m_iFirst)
+            m_iFirst = m_Bitmap.findSet(hi, m_iLast);
+    }
+
+    // Removing one by one, the largest sequence is reset when the list gets
+    // empty and from then on follows the sequence numbers being removed.
+    if (m_iLength == 0)
+    {
+        m_iFirst      = SRT_SEQNO_NONE;
+        m_iLast       = SRT_SEQNO_NONE;
+        m_iLargestSeq = last_removed ? SRT_SEQNO_NONE : seqno2;
+    }
+    else if (CSeqNo::seqcmp(seqno2, m_iLargestSeq) > 0)
+    {
+        m_iLargestSeq = seqno2;
+    }
+}
+
+int32_t srt::CRcvLossList::removeUpTo(int32_t seqno_last)
+{
+    int32_t first = getFirstLostSeq();
+    if (first == SRT_SEQNO_NONE)
+    {
+        //HLOGC(tslog.Debug, log << "rcv-loss: DROP to %" << seqno_last << " - empty list");
+        return first; // empty, so nothing to remove
+    }
+
+    if (CSeqNo::seqcmp(seqno_last, first) < 0)
+    {
+        //HLOGC(tslog.Debug, log << "rcv-loss: DROP to %" << seqno_last << " - first %" << first << " is newer, exitting");
+        return first; // seqno_last older than first - nothing to remove
+    }
+
+    HLOGC(tslog.Debug, log << "rcv-loss: DROP to %" << seqno_last << " ...");
+
+    removeRange(first, seqno_last);
+    return first;
+}
+
+bool srt::CRcvLossList::find(int32_t seqno1, int32_t seqno2) const
+{
+    if (0 == m_iLength)
+        return false;
+
+    // With seqno2 preceding seqno1 only seqno1 is checked.
+    const int32_t upper = CSeqNo::seqcmp(seqno2, seqno1) < 0 ? seqno1 : seqno2;
+    const int32_t lo    = CSeqNo::seqcmp(seqno1, m_iFirst) > 0 ? seqno1 : m_iFirst;
+    const int32_t hi    = CSeqNo::seqcmp(upper, m_iLast) < 0 ? upper : m_iLast;
+    if (CSeqNo::seqcmp(lo, hi) > 0)
+        return false;
+
+    return m_Bitmap.findSet(lo, hi) != SRT_SEQNO_NONE;
+}
+
+int srt::CRcvLossList::getLossLength() const
+{
+    return m_iLength;
+}
+
+int32_t srt::CRcvLossList::getFirstLostSeq() const
+{
+    if (0 == m_iLength)
+        return SRT_SEQNO_NONE;
+
+    return m_iFirst;
+}
+
+void srt::CRcvLossList::getLossArray(int32_t* array, int& len, int limit)
+{
+    len = 0;
+
+    int32_t lo = getFirstLostSeq();
+    while ((len < limit - 1) && (SRT_SEQNO_NONE != lo))
+    {
+        // The range ends before the first clear bit, found 64 at a time.
+        const int32_t next = m_Bitmap.findClear(lo, m_iLast);
+        const int32_t hi   = next == SRT_SEQNO_NONE ? m_iLast : CSeqNo::decseq(next);
+
+        array[len] = lo;
+        if (hi != lo)
+        {
+            // there are more than 1 loss in the sequence
+            array[len] |= LOSSDATA_SEQNO_RANGE_FIRST;
+            ++len;
+            array[len] = hi;
+        }
+
+        ++len;
+
+        lo = (hi == m_iLast) ? SRT_SEQNO_NONE : m_Bitmap.findSet(CSeqNo::incseq(hi), m_iLast);
+    }
+}
+
+#else // !SRT_ENABLE_LOSSLIST_BITMAP
+
 srt::CSndLossList::CSndLossList(int size)
     : m_caSeq()
     , m_iHead(-1)
@@ -78,7 +634,7 @@ srt::CSndLossList::CSndLossList(int size)
     , m_iLastInsertPos(-1)
     , m_ListLock()
 {
-    m_caSeq = new Seq[size];
+    m_caSeq = PoolAllocator<Seq>().allocate(size);
 
     // -1 means there is no data in the node
     for (int i = 0; i < size; ++i)
@@ -93,7 +649,7 @@ srt::CSndLossList::CSndLossList(int size)
 
 srt::CSndLossList::~CSndLossList()
 {
-    delete[] m_caSeq;
+    PoolAllocator<Seq>().deallocate(m_caSeq, m_iSize);
     releaseMutex(m_ListLock);
 }
 
@@ -482,7 +1038,7 @@ srt::CRcvLossList::CRcvLossList(int size)
     , m_iSize(size)
     , m_iLargestSeq(SRT_SEQNO_NONE)
 {
-    m_caSeq = new Seq[m_iSize];
+    m_caSeq = PoolAllocator<Seq>().allocate(m_iSize);
 
     // -1 means there is no data in the node
     for (int i = 0; i < size; ++i)
@@ -494,7 +1050,7 @@ srt::CRcvLossList::CRcvLossList(int size)
 
 srt::CRcvLossList::~CRcvLossList()
 {
-    delete[] m_caSeq;
+    PoolAllocator<Seq>().deallocate(m_caSeq, m_iSize);
 }
 
 int srt::CRcvLossList::insert(int32_t seqno1, int32_t seqno2)
@@ -814,6 +1370,8 @@ void srt::CRcvLossList::getLossArray(int32_t* array, int& len, int limit)
     }
 }
 
+#endif // SRT_ENABLE_LOSSLIST_BITMAP
+
 srt::CRcvFreshLoss::CRcvFreshLoss(int32_t seqlo, int32_t seqhi, int initial_age)
     : ttl(initial_age)
     , timestamp(steady_clock::now())
@@ -54,12 +54,191 @@ modified by
 #define INC_SRT_LIST_H
 
 #include <deque>
+#include <vector>
 
 #include "udt.h"
 #include "common.h"
+#include "pool.h"
 
 namespace srt {
 
+#if SRT_ENABLE_LOSSLIST_BITMAP
+
+/// Circular bitmap of sequence numbers, one bit per sequence number, used
+/// by the loss lists when built with ENABLE_LOSSLIST_BITMAP. The number of
+/// bits is a power of two, so that the sequence number space (2^31) maps
+/// onto it the same way across the sequence number wrap. A second level
+/// marks the non-empty words, so that searches skip 4096 sequence numbers
+/// per word of the second level.
+class CSeqBitmap
+{
+public:
+    /// @param span maximum distance between sequence numbers kept at a time.
+    explicit CSeqBitmap(int span);
+
+    /// Number of sequence numbers that can be kept at a time.
+    int capacity() const { return m_iMask + 1; }
+
+    bool test(int32_t seqno) const;
+
+    /// Set bits for [seqlo, seqhi].
+    /// @return the number of bits that were not set before.
+    int set(int32_t seqlo, int32_t seqhi);
+
+    /// Clear bits for [seqlo, seqhi].
+    /// @return the number of bits that were set before.
+    int clear(int32_t seqlo, int32_t seqhi);
+
+    /// Find the first set bit in [seqlo, seqhi].
+    /// @return the sequence number or SRT_SEQNO_NONE if none is set.
+    int32_t findSet(int32_t seqlo, int32_t seqhi) const;
+
+    /// Find the first clear bit in [seqlo, seqhi].
+    /// @return the sequence number or SRT_SEQNO_NONE if all are set.
+    int32_t findClear(int32_t seqlo, int32_t seqhi) const;
+
+private:
+    typedef uint64_t word_t;
+    static const int WORD_BITS = 64;
+
+    int findSetOffset(int start, int count) const;
+    int findClearOffset(int start, int count) const;
+    void markWord(int w);
+
+    typedef std::vector<word_t, PoolAllocator<word_t> > words_t;
+
+    words_t m_aWords;   // one bit per sequence number
+    words_t m_aSummary; // one bit per non-empty word of m_aWords
+    int     m_iMask;    // capacity - 1
+};
+
+class CSndLossList
+{
+public:
+    CSndLossList(int size = 1024);
+    ~CSndLossList();
+
+    /// Insert a seq. no. into the sender loss list.
+    /// @param [in] seqno1 sequence number starts.
+    /// @param [in] seqno2 sequence number ends.
+    /// @return number of packets that are not in the list previously.
+    int insert(int32_t seqno1, int32_t seqno2);
+
+    /// Remove the given sequence number and all numbers that precede it.
+    /// @param [in] seqno sequence number.
+    void removeUpTo(int32_t seqno);
+
+    /// Read the loss length.
+    /// @return The length of the list.
+    int getLossLength() const;
+
+    /// Read the first (smallest) loss seq. no. in the list and remove it.
+    /// @return The seq. no. or -1 if the list is empty.
+    int32_t popLostSeq();
+
+    template <class Stream>
+    Stream& traceState(Stream& sout) const
+    {
+        if (m_iLength > 0)
+        {
+            for (int32_t lo = m_iFirst; lo != SRT_SEQNO_NONE;)
+            {
+                const int32_t next = m_Bitmap.findClear(lo, m_iLast);
+                const int32_t hi   = next == SRT_SEQNO_NONE ? m_iLast : CSeqNo::decseq(next);
+                sout << lo;
+                if (hi != lo)
+                    sout << ":" << hi;
+                sout << ", ";
+                lo = (hi == m_iLast) ? SRT_SEQNO_NONE : m_Bitmap.findSet(CSeqNo::incseq(hi), m_iLast);
+            }
+        }
+        sout << " {len:" << m_iLength << " first:" << m_iFirst << " last:" << m_iLast << "}";
+        return sout;
+    }
+    void traceState() const;
+
+private:
+    CSeqBitmap m_Bitmap;
+    int32_t    m_iFirst;  // smallest seq. no. in the list
+    int32_t    m_iLast;   // largest seq. no. in the list
+    int        m_iLength; // loss length
+    const int  m_iSize;   // maximum distance of a new record from the first one
+
+    mutable srt::sync::Mutex m_ListLock; // used to synchronize list operation
+
+private:
+    CSndLossList(const CSndLossList&);
+    CSndLossList& operator=(const CSndLossList&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+class CRcvLossList
+{
+public:
+    CRcvLossList(int size = 1024);
+    ~CRcvLossList();
+
+    /// Insert a series of loss seq. no. between "seqno1" and "seqno2" into the receiver's loss list.
+    /// @param [in] seqno1 sequence number starts.
+    /// @param [in] seqno2 seqeunce number ends.
+    /// @return length of the loss record inserted (seqlen(seqno1, seqno2)), -1 on error.
+    int insert(int32_t seqno1, int32_t seqno2);
+
+    /// Remove a loss seq. no. from the receiver's loss list.
+    /// @param [in] seqno sequence number.
+    /// @return if the packet is removed (true) or no such lost packet is found (false).
+    bool remove(int32_t seqno);
+
+    /// Remove all packets between seqno1 and seqno2.
+    /// @param [in] seqno1 start sequence number.
+    /// @param [in] seqno2 end sequence number.
+    /// @return if the packet is removed (true) or no such lost packet is found (false).
+    bool remove(int32_t seqno1, int32_t seqno2);
+
+    /// Remove all numbers that precede the given sequence number.
+    /// @param [in] seqno sequence number.
+    /// @return the first removed sequence number
+    int32_t removeUpTo(int32_t seqno);
+
+    /// Find if there is any lost packets whose sequence number falling seqno1 and seqno2.
+    /// @param [in] seqno1 start sequence number.
+    /// @param [in] seqno2 end sequence number.
+    /// @return True if found; otherwise false.
+    bool find(int32_t seqno1, int32_t seqno2) const;
+
+    /// Read the loss length.
+    /// @return the length of the list.
+    int getLossLength() const;
+
+    /// Read the first (smallest) seq. no. in the list.
+    /// @return the sequence number or -1 if the list is empty.
+    int32_t getFirstLostSeq() const;
+
+    /// Get a encoded loss array for NAK report.
+    /// @param [out] array the result list of seq. no. to be included in NAK.
+    /// @param [out] len physical length of the result array.
+    /// @param [in] limit maximum length of the array.
+    void getLossArray(int32_t* array, int& len, int limit);
+
+private:
+    /// Remove [seqno1, seqno2] with the same effect as calling remove()
+    /// for every sequence number in this range, one by one.
+    void removeRange(int32_t seqno1, int32_t seqno2);
+
+    CSeqBitmap m_Bitmap;
+    int32_t    m_iFirst;      // smallest seq. no. in the list
+    int32_t    m_iLast;       // no seq. no. in the list is larger than this one
+    int        m_iLength;     // loss length
+    int32_t    m_iLargestSeq; // largest seq ever seen
+
+private:
+    CRcvLossList(const CRcvLossList&);
+    CRcvLossList& operator=(const CRcvLossList&);
+};
+
+#else // !SRT_ENABLE_LOSSLIST_BITMAP
+
 class CSndLossList
 {
 public:
@@ -276,6 +455,8 @@ public:
     iterator end() { return iterator(m_caSeq, -1); }
 };
 
+#endif // SRT_ENABLE_LOSSLIST_BITMAP
+
 struct CRcvFreshLoss
 {
     int32_t                             seq[2];
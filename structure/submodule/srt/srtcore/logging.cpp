@@ -14,6 +14,9 @@ written by
  *****************************************************************************/
 
 
+#include <fstream>
+#include <new>
+
 #include "srt_compat.h"
 #include "logging.h"
 
@@ -26,18 +29,71 @@ namespace srt_logging
 
 #if ENABLE_LOGGING
 
-LogDispatcher::Proxy::Proxy(LogDispatcher& guy) : that(guy), that_enabled(that.CheckEnabled())
+static uint64_t SysTimeMicroseconds()
+{
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return uint64_t(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
+static LogRing* LocalLogRing();
+
+LogDispatcher::Proxy::Proxy(LogDispatcher& guy, int sock) : that(guy), os(NULL), that_enabled(that.CheckEnabled(sock)), ring(NULL)
 {
     if (that_enabled)
     {
         i_file = "";
         i_line = 0;
+        i_area = "";
         flags = that.src_config->flags;
-        // Create logger prefix
-        that.CreateLogLinePrefix(os);
+
+        if (that.src_config->async)
+            ring = LocalLogRing();
+
+        if (ring)
+        {
+            // Only reserve the space for the header; it's filled in submit().
+            ring_start = ring->begin();
+            ring_time_us = SysTimeMicroseconds();
+            const LogRecordHead head = LogRecordHead();
+            ring->put(&head, sizeof head);
+
+            // The stream is reused, so reset what the previous record might have changed.
+            os = &ring->text();
+            os->str(std::string());
+            os->clear();
+            os->flags(std::ios_base::skipws | std::ios_base::dec);
+            os->width(0);
+            os->precision(6);
+
+            // The prefix would leave '0' as the fill character.
+            ring_text = false;
+            os->fill((flags & SRT_LOGF_DISABLE_TIME) ? ' ' : '0');
+            ring_flags = os->flags();
+            ring_fill = os->fill();
+        }
+        else
+        {
+            // Create logger prefix
+            os = new std::ostringstream;
+            that.CreateLogLinePrefix(*os);
+        }
     }
 }
 
+void LogDispatcher::Proxy::submit()
+{
+    LogRecordHead head;
+    head.size       = uint32_t(ring->position() - ring_start);
+    head.line       = i_line;
+    head.time_us    = ring_time_us;
+    head.dispatcher = &that;
+    head.file       = i_file;
+    head.area       = i_area;
+    ring->poke(ring_start, &head, sizeof head);
+    ring->commit();
+}
+
 LogDispatcher::Proxy LogDispatcher::operator()()
 {
     return Proxy(*this);
@@ -48,37 +104,17 @@ void LogDispatcher::CreateLogLinePrefix(std::ostringstream& serr)
     using namespace std;
     using namespace srt;
 
-    SRT_STATIC_ASSERT(ThreadName::BUFSIZE >= sizeof("hh:mm:ss.") * 2, // multiply 2 for some margin
-                      "ThreadName::BUFSIZE is too small to be used for strftime");
-    char tmp_buf[ThreadName::BUFSIZE];
-    if ( !isset(SRT_LOGF_DISABLE_TIME) )
-    {
-        // Not necessary if sending through the queue.
-        timeval tv;
-        gettimeofday(&tv, NULL);
-        struct tm tm = SysLocalTime((time_t) tv.tv_sec);
-
-        if (strftime(tmp_buf, sizeof(tmp_buf), "%X.", &tm))
-        {
-            serr << tmp_buf << setw(6) << setfill('0') << tv.tv_usec;
-        }
-    }
-
-    string out_prefix;
-    if ( !isset(SRT_LOGF_DISABLE_SEVERITY) )
-    {
-        out_prefix = prefix;
-    }
+    const int cfgflags = src_config->flags;
+    const uint64_t time_us = (cfgflags & SRT_LOGF_DISABLE_TIME) ? 0 : SysTimeMicroseconds();
 
     // Note: ThreadName::get needs a buffer of size min. ThreadName::BUFSIZE
-    if ( !isset(SRT_LOGF_DISABLE_THREADNAME) && ThreadName::get(tmp_buf) )
-    {
-        serr << "/" << tmp_buf << out_prefix << ": ";
-    }
-    else
+    char threadname[ThreadName::BUFSIZE];
+    if ( (cfgflags & SRT_LOGF_DISABLE_THREADNAME) || !ThreadName::get(threadname) )
     {
-        serr << out_prefix << ": ";
+        threadname[0] = '\0';
     }
+
+    FormatLogLinePrefix(serr, time_us, threadname, prefix, cfgflags);
 }
 
 std::string LogDispatcher::Proxy::ExtractName(std::string pretty_function)
@@ -143,6 +179,409 @@ std::string LogDispatcher::Proxy::ExtractName(std::string pretty_function)
 
     return pretty_function.substr(pos+2);
 }
+
+// Writer thread of the asynchronous logging, common for all LogConfig
+// objects. It collects the records from the LogRing of every thread that
+// has logged, and either formats them and delivers through the LogConfig
+// of their call site, or writes them raw into the binary log file.
+class AsyncLogWriter
+{
+public:
+    AsyncLogWriter();
+
+    LogRing* localRing();
+    void setUser(LogConfig& config, bool on);
+    bool setBinaryFile(const char* path);
+    bool binaryFileActive() const { return m_bBinaryFile; }
+
+private:
+    static void* worker(void* arg);
+    void start();
+    void stop();
+    void collect();
+    void deliver(LogRing& ring, const std::vector<char>& record);
+    void reportDrops(LogRing& ring);
+
+    template <class T>
+    void writeBin(const T& val)
+    {
+        m_BinFile.write((const char*)&val, sizeof val);
+    }
+
+    void writeBin(const std::string& val)
+    {
+        writeBin(uint32_t(val.size()));
+        m_BinFile.write(val.data(), val.size());
+    }
+
+    uint32_t binSite(const LogRecordHead& head);
+
+    static void releaseRing(void* ring);
+
+    // Serializes starting and stopping the thread, which
+    // also covers the binary file and the users count.
+    srt::sync::Mutex m_ControlLock;
+    int m_iUsers;
+
+    srt::sync::Mutex m_RingsLock;
+    std::vector<LogRing*> m_Rings;
+    uint32_t m_uLastRingId;
+
+    srt::sync::CThread m_Thread;
+    srt::sync::atomic<bool> m_bRunning;
+    srt::sync::Mutex m_StopLock;
+    srt::sync::Condition m_StopCond;
+
+    // Accessed by the writer thread only while running.
+    std::ofstream m_BinFile;
+    srt::sync::atomic<bool> m_bBinaryFile;
+    std::set<uint32_t> m_BinThreads;
+    std::map<std::pair<const void*, std::pair<const char*, int> >, uint32_t> m_BinSites;
+
+#if ENABLE_STDCXX_SYNC
+    struct RingHolder
+    {
+        LogRing* ring;
+        RingHolder(): ring(NULL) {}
+        ~RingHolder() { if (ring) releaseRing(ring); }
+    };
+    static thread_local RingHolder s_LocalRing;
+#else
+    pthread_key_t m_LocalRingKey;
+#endif
+};
+
+#if ENABLE_STDCXX_SYNC
+thread_local AsyncLogWriter::RingHolder AsyncLogWriter::s_LocalRing;
+#endif
+
+// The writer is never destroyed, because the log calls
+// may happen during the destruction of static objects.
+static AsyncLogWriter& TheAsyncLogWriter()
+{
+    static AsyncLogWriter* writer = new AsyncLogWriter;
+    return *writer;
+}
+
+static LogRing* LocalLogRing()
+{
+    return TheAsyncLogWriter().localRing();
+}
+
+AsyncLogWriter::AsyncLogWriter()
+    : m_iUsers(0)
+    , m_uLastRingId(0)
+    , m_bRunning(false)
+    , m_bBinaryFile(false)
+{
+    srt::sync::setupCond(m_StopCond, "LogWriterStop");
+#if !ENABLE_STDCXX_SYNC
+    pthread_key_create(&m_LocalRingKey, &AsyncLogWriter::releaseRing);
+#endif
+}
+
+void AsyncLogWriter::releaseRing(void* ring)
+{
+    // The remaining records will be read and the ring deleted by the writer.
+    static_cast<LogRing*>(ring)->m_bOrphaned = true;
+}
+
+LogRing* AsyncLogWriter::localRing()
+{
+    if (!m_bRunning)
+        return NULL;
+
+#if ENABLE_STDCXX_SYNC
+    LogRing* ring = s_LocalRing.ring;
+#else
+    LogRing* ring = static_cast<LogRing*>(pthread_getspecific(m_LocalRingKey));
+#endif
+
+    if (!ring)
+    {
+        char threadname[srt::ThreadName::BUFSIZE];
+        if (!srt::ThreadName::get(threadname))
+            threadname[0] = '\0';
+
+        char* data = new (std::nothrow) char[LogRing::CAPACITY];
+        if (!data)
+            return NULL;
+        ring = new (std::nothrow) LogRing(data, threadname);
+        if (!ring)
+        {
+            delete[] data;
+            return NULL;
+        }
+
+        {
+            srt::sync::ScopedLock lk(m_RingsLock);
+            ring->m_uId = ++m_uLastRingId;
+            m_Rings.push_back(ring);
+        }
+#if ENABLE_STDCXX_SYNC
+        s_LocalRing.ring = ring;
+#else
+        pthread_setspecific(m_LocalRingKey, ring);
+#endif
+    }
+
+    return ring->busy() ? NULL : ring;
+}
+
+void AsyncLogWriter::setUser(LogConfig& config, bool on)
+{
+    srt::sync::ScopedLock lk(m_ControlLock);
+    if (config.async == on)
+        return;
+
+    if (on)
+    {
+        if (m_iUsers++ == 0)
+            start();
+        config.async = true;
+    }
+    else
+    {
+        config.async = false;
+        if (--m_iUsers == 0)
+            stop();
+    }
+}
+
+bool AsyncLogWriter::setBinaryFile(const char* path)
+{
+    srt::sync::ScopedLock lk(m_ControlLock);
+
+    // The records collected so far go to the previous destination.
+    const bool running = m_bRunning;
+    if (running)
+        stop();
+
+    if (m_BinFile.is_open())
+        m_BinFile.close();
+    m_BinThreads.clear();
+    m_BinSites.clear();
+    m_bBinaryFile = false;
+
+    bool ok = true;
+    if (path)
+    {
+        m_BinFile.clear();
+        m_BinFile.open(path, ios::out | ios::binary | ios::trunc);
+        ok = m_BinFile.is_open();
+        if (ok)
+        {
+            m_BinFile.write(LOGBIN_MAGIC, sizeof LOGBIN_MAGIC);
+            writeBin(LOGBIN_BYTEORDER);
+            m_bBinaryFile = true;
+        }
+    }
+
+    if (running)
+        start();
+    return ok;
+}
+
+void AsyncLogWriter::start()
+{
+    m_bRunning = true;
+    if (!srt::sync::StartThread(m_Thread, AsyncLogWriter::worker, this, "SRT:Log"))
+        m_bRunning = false;
+}
+
+void AsyncLogWriter::stop()
+{
+    {
+        srt::sync::ScopedLock lk(m_StopLock);
+        m_bRunning = false;
+    }
+    srt::sync::CSync::notify_one_relaxed(m_StopCond);
+    m_Thread.join();
+}
+
+void* AsyncLogWriter::worker(void* arg)
+{
+    AsyncLogWriter* self = static_cast<AsyncLogWriter*>(arg);
+
+    srt::sync::UniqueLock lk(self->m_StopLock);
+    while (self->m_bRunning)
+    {
+        self->collect();
+        self->m_StopCond.wait_for(lk, srt::sync::milliseconds_from(10));
+    }
+    // Records committed before the writer was stopped.
+    self->collect();
+    if (self->m_BinFile.is_open())
+        self->m_BinFile.flush();
+
+    return NULL;
+}
+
+struct LogRecordEarlier
+{
+    bool operator()(const std::pair<LogRing*, std::vector<char> >& a, const std::pair<LogRing*, std::vector<char> >& b) const
+    {
+        const LogRecordHead* ha = reinterpret_cast<const LogRecordHead*>(&a.second[0]);
+        const LogRecordHead* hb = reinterpret_cast<const LogRecordHead*>(&b.second[0]);
+        return ha->time_us < hb->time_us;
+    }
+};
+
+void AsyncLogWriter::collect()
+{
+    std::vector<LogRing*> rings;
+    {
+        srt::sync::ScopedLock lk(m_RingsLock);
+        rings = m_Rings;
+    }
+
+    // Records from different threads are merged in the order of time.
+    std::vector< std::pair<LogRing*, std::vector<char> > > records;
+    std::vector<LogRing*> orphaned;
+    std::vector<char> rec;
+    for (size_t i = 0; i < rings.size(); ++i)
+    {
+        LogRing* ring = rings[i];
+        // Checked first: an orphaned ring gets no more records.
+        if (ring->m_bOrphaned)
+            orphaned.push_back(ring);
+        while (ring->read((rec)))
+        {
+            records.push_back(std::make_pair(ring, std::vector<char>()));
+            records.back().second.swap(rec);
+        }
+    }
+
+    std::stable_sort(records.begin(), records.end(), LogRecordEarlier());
+    for (size_t i = 0; i < records.size(); ++i)
+        deliver(*records[i].first, records[i].second);
+
+    for (size_t i = 0; i < rings.size(); ++i)
+        reportDrops(*rings[i]);
+
+    if (!orphaned.empty())
+    {
+        srt::sync::ScopedLock lk(m_RingsLock);
+        for (size_t i = 0; i < orphaned.size(); ++i)
+        {
+            m_Rings.erase(std::find(m_Rings.begin(), m_Rings.end(), orphaned[i]));
+            delete orphaned[i];
+        }
+    }
+}
+
+uint32_t AsyncLogWriter::binSite(const LogRecordHead& head)
+{
+    const std::pair<const void*, std::pair<const char*, int> > key(head.dispatcher, std::make_pair(head.file, int(head.line)));
+    std::map<std::pair<const void*, std::pair<const char*, int> >, uint32_t>::iterator i = m_BinSites.find(key);
+    if (i != m_BinSites.end())
+        return i->second;
+
+    const uint32_t id = uint32_t(m_BinSites.size() + 1);
+    m_BinSites[key] = id;
+
+    const LogDispatcher* disp = static_cast<const LogDispatcher*>(head.dispatcher);
+    m_BinFile.put(char(LOGBIN_SITE));
+    writeBin(id);
+    writeBin(int32_t(disp->level));
+    writeBin(int32_t(head.line));
+    writeBin(std::string(disp->prefix));
+    writeBin(std::string(head.file));
+    writeBin(std::string(head.area));
+    return id;
+}
+
+void AsyncLogWriter::deliver(LogRing& ring, const std::vector<char>& record)
+{
+    const LogRecordHead* head = reinterpret_cast<const LogRecordHead*>(&record[0]);
+    const char* args = &record[0] + sizeof(LogRecordHead);
+    const size_t args_size = record.size() - sizeof(LogRecordHead);
+    ring.m_pLastDispatcher = head->dispatcher;
+
+    if (m_bBinaryFile)
+    {
+        if (m_BinThreads.insert(ring.m_uId).second)
+        {
+            m_BinFile.put(char(LOGBIN_THREAD));
+            writeBin(ring.m_uId);
+            writeBin(std::string(ring.threadName()));
+        }
+        const uint32_t site = binSite(*head);
+        m_BinFile.put(char(LOGBIN_RECORD));
+        writeBin(ring.m_uId);
+        writeBin(site);
+        writeBin(head->time_us);
+        writeBin(uint32_t(args_size));
+        m_BinFile.write(args, args_size);
+        return;
+    }
+
+    LogDispatcher* disp = const_cast<LogDispatcher*>(static_cast<const LogDispatcher*>(head->dispatcher));
+    const int flags = disp->src_config->flags;
+    std::ostringstream line;
+    FormatLogLinePrefix(line, head->time_us, ring.threadName(), disp->prefix, flags);
+    FormatLogArgs(line, args, args_size);
+    if (!(flags & SRT_LOGF_DISABLE_EOL))
+        line << std::endl;
+    disp->SendLogLine(head->file, head->line, head->area, line.str());
+}
+
+void AsyncLogWriter::reportDrops(LogRing& ring)
+{
+    const uint64_t dropped = ring.dropped();
+    if (dropped == ring.m_uReportedDrops || !ring.m_pLastDispatcher)
+        return;
+    ring.m_uReportedDrops = dropped;
+
+    if (m_bBinaryFile)
+    {
+        m_BinFile.put(char(LOGBIN_DROPPED));
+        writeBin(ring.m_uId);
+        writeBin(dropped);
+        return;
+    }
+
+    LogDispatcher* disp = const_cast<LogDispatcher*>(static_cast<const LogDispatcher*>(ring.m_pLastDispatcher));
+    const int flags = disp->src_config->flags;
+    std::ostringstream line;
+    FormatLogLinePrefix(line, SysTimeMicroseconds(), ring.threadName(), disp->prefix, flags);
+    line << "LOG: " << dropped << " log records dropped so far";
+    if (!(flags & SRT_LOGF_DISABLE_EOL))
+        line << std::endl;
+    disp->SendLogLine(__FILE__, __LINE__, "AsyncLogWriter", line.str());
+}
+
+void LogConfig::setAsync(bool on)
+{
+    TheAsyncLogWriter().setUser(*this, on);
+}
+
+bool SetLogBinaryFile(const char* path)
+{
+    return TheAsyncLogWriter().setBinaryFile(path);
+}
+
+bool LogBinaryFileActive()
+{
+    return TheAsyncLogWriter().binaryFileActive();
+}
+
+#else // !ENABLE_LOGGING
+
+void LogConfig::setAsync(bool)
+{
+}
+
+bool SetLogBinaryFile(const char*)
+{
+    return false;
+}
+
+bool LogBinaryFileActive()
+{
+    return false;
+}
+
 #endif
 
 } // (end namespace srt_logging)
@@ -33,6 +33,7 @@ written by
 #include "utilities.h"
 #include "threadname.h"
 #include "logging_api.h"
+#include "logging_bin.h"
 #include "sync.h"
 
 #ifdef __GNUC__
@@ -66,11 +67,24 @@ written by
 // Usage: LOGP(gglog.Debug, param1, param2, param3);
 #define LOGP(logdes, ...) if (logdes.CheckEnabled()) logdes.printloc(__FILE__, __LINE__, __FUNCTION__,##__VA_ARGS__)
 
+// SLOGC is LOGC for a line that concerns the given socket. The lines of
+// the socket set by srt_setlogsocket() are logged up to the level set there,
+// so that debug logging can be on for one socket only. This is checked before
+// anything is formatted.
+// Usage: SLOGC(gglog.Debug, m_SocketID, log << CONID() << param1);
+#define SLOGC(logdes, sock, args) if (logdes.CheckEnabled(sock)) \
+{ \
+    srt_logging::LogDispatcher::Proxy log(logdes, sock); \
+    log.setloc(__FILE__, __LINE__, __FUNCTION__); \
+    const srt_logging::LogDispatcher::Proxy& log_prox SRT_ATR_UNUSED = args; \
+}
+
 #define IF_LOGGING(instr) instr
 
 #if ENABLE_HEAVY_LOGGING
 
 #define HLOGC LOGC
+#define HSLOGC SLOGC
 #define HLOGP LOGP
 #define HLOGF LOGF
 
@@ -79,6 +93,7 @@ written by
 #else
 
 #define HLOGC(...)
+#define HSLOGC(...)
 #define HLOGF(...)
 #define HLOGP(...)
 
@@ -89,10 +104,12 @@ written by
 #else
 
 #define LOGC(...)
+#define SLOGC(...)
 #define LOGF(...)
 #define LOGP(...)
 
 #define HLOGC(...)
+#define HSLOGC(...)
 #define HLOGF(...)
 #define HLOGP(...)
 
@@ -104,33 +121,60 @@ written by
 namespace srt_logging
 {
 
+// The "@<id>: " socket prefix of a log line. The id is stored as a number
+// and formatted only if the line is formatted.
+struct LogSocketId
+{
+    explicit LogSocketId(int id): id(id) {}
+    int id;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const LogSocketId& sid)
+{
+    return os << "@" << sid.id << ": ";
+}
+
 struct LogConfig
 {
     typedef std::bitset<SRT_LOGFA_LASTNONE+1> fa_bitset_t;
     fa_bitset_t enabled_fa;   // NOTE: assumed atomic reading
     LogLevel::type max_level; // NOTE: assumed atomic reading
+    int sock_filter;          // NOTE: assumed atomic reading
+    LogLevel::type sock_level; // NOTE: assumed atomic reading
     std::ostream* log_stream;
     SRT_LOG_HANDLER_FN* loghandler_fn;
     void* loghandler_opaque;
     srt::sync::Mutex mutex;
     int flags;
+    bool async;               // NOTE: assumed atomic reading
 
     LogConfig(const fa_bitset_t& efa,
             LogLevel::type l = LogLevel::warning,
             std::ostream* ls = &std::cerr)
         : enabled_fa(efa)
         , max_level(l)
+        , sock_filter(SRT_INVALID_SOCK)
+        , sock_level(l)
         , log_stream(ls)
         , loghandler_fn()
         , loghandler_opaque()
         , flags()
+        , async(false)
     {
     }
 
     ~LogConfig()
     {
+        // Deliver the lines still waiting for the writer thread.
+        if (async)
+            setAsync(false);
     }
 
+    // Turns on or off deferring the log formatting to the writer thread
+    // (see LogRing). Must not be called with 'mutex' locked, as turning it
+    // off waits for the writer thread to deliver the pending log lines.
+    void setAsync(bool on);
+
     SRT_ATTR_ACQUIRE(mutex)
     void lock() { mutex.lock(); }
 
@@ -138,6 +182,12 @@ struct LogConfig
     void unlock() { mutex.unlock(); }
 };
 
+// Binary logging: with a file set, the writer thread of the asynchronous
+// logging writes the records raw into it (see LogBinReader). Pass NULL to
+// close the file. Returns false if the file can't be opened.
+bool SetLogBinaryFile(const char* path);
+bool LogBinaryFileActive();
+
 // The LogDispatcher class represents the object that is responsible for
 // a decision whether to log something or not, and if so, print the log.
 struct SRT_API LogDispatcher
@@ -151,6 +201,8 @@ private:
 
     bool isset(int flg) { return (src_config->flags & flg) != 0; }
 
+    friend class AsyncLogWriter;
+
 public:
 
     LogDispatcher(int functional_area, LogLevel::type log_level, const char* your_pfx,
@@ -190,7 +242,7 @@ public:
     {
     }
 
-    bool CheckEnabled();
+    bool CheckEnabled(int sock = SRT_INVALID_SOCK);
 
     void CreateLogLinePrefix(std::ostringstream&);
     void SendLogLine(const char* file, int line, const std::string& area, const std::string& sl);
@@ -285,7 +337,9 @@ struct LogDispatcher::Proxy
 {
     LogDispatcher& that;
 
-    std::ostringstream os;
+    // The stream of the thread's LogRing, or without the ring,
+    // one created for this line.
+    std::ostringstream* os;
 
     // Cache the 'enabled' state in the beginning. If the logging
     // becomes enabled or disabled in the middle of the log, we don't
@@ -296,8 +350,20 @@ struct LogDispatcher::Proxy
     // CACHE!!!
     const char* i_file;
     int i_line;
+    const char* i_area;
     std::string area;
 
+    // Set when the arguments are stored into the thread's LogRing
+    // instead of being formatted here (SRT_LOGF_ASYNC).
+    LogRing* ring;
+    uint64_t ring_start;
+    uint64_t ring_time_us;
+    // A manipulator has changed the state of 'os', so the following
+    // arguments must be formatted here to get the same result.
+    bool ring_text;
+    std::ios_base::fmtflags ring_flags;
+    char ring_fill;
+
     Proxy& setloc(const char* f, int l, std::string a)
     {
         i_file = f;
@@ -306,23 +372,36 @@ struct LogDispatcher::Proxy
         return *this;
     }
 
+    // The location is a string literal, which can be stored as a pointer.
+    Proxy& setloc(const char* f, int l, const char* a)
+    {
+        i_file = f;
+        i_line = l;
+        i_area = a;
+        if (!ring)
+            area = a;
+        return *this;
+    }
+
     // Left for future. Not sure if it's more convenient
     // to use this to translate __PRETTY_FUNCTION__ to
     // something short, or just let's leave __FUNCTION__
     // or better __func__.
     std::string ExtractName(std::string pretty_function);
 
-    Proxy(LogDispatcher& guy);
+    Proxy(LogDispatcher& guy, int sock = SRT_INVALID_SOCK);
 
     // Copy constructor is needed due to noncopyable ostringstream.
     // This is used only in creation of the default object, so just
     // use the default values, just copy the location cache.
-    Proxy(const Proxy& p): that(p.that), area(p.area)
+    Proxy(const Proxy& p): that(p.that), os(NULL), area(p.area)
     {
         i_file = p.i_file;
         i_line = p.i_line;
+        i_area = p.i_area;
         that_enabled = false;
         flags = p.flags;
+        ring = NULL;
     }
 
 
@@ -331,7 +410,10 @@ struct LogDispatcher::Proxy
     {
         if ( that_enabled )
         {
-            os << arg;
+            if (ring)
+                putarg(arg);
+            else
+                *os << arg;
         }
         return *this;
     }
@@ -340,15 +422,102 @@ struct LogDispatcher::Proxy
     {
         if ( that_enabled )
         {
+            if (ring)
+            {
+                submit();
+                return;
+            }
             if ( (flags & SRT_LOGF_DISABLE_EOL) == 0 )
-                os << std::endl;
-            that.SendLogLine(i_file, i_line, area, os.str());
+                *os << std::endl;
+            that.SendLogLine(i_file, i_line, area, os->str());
+            delete os;
         }
-        // Needed in destructor?
-        //os.clear();
-        //os.str("");
     }
 
+    // Storing arguments into the LogRing. Numbers, characters and strings
+    // are stored raw; anything else is formatted here and stored as text.
+    void putarg(bool v)               { putnum(v, LOGARG_INT, int64_t(v)); }
+    void putarg(char v)               { putnum(v, LOGARG_CHAR, v); }
+    void putarg(signed char v)        { putnum(v, LOGARG_CHAR, char(v)); }
+    void putarg(unsigned char v)      { putnum(v, LOGARG_CHAR, char(v)); }
+    void putarg(short v)              { putnum(v, LOGARG_INT, int64_t(v)); }
+    void putarg(unsigned short v)     { putnum(v, LOGARG_UINT, uint64_t(v)); }
+    void putarg(int v)                { putnum(v, LOGARG_INT, int64_t(v)); }
+    void putarg(unsigned int v)       { putnum(v, LOGARG_UINT, uint64_t(v)); }
+    void putarg(long v)               { putnum(v, LOGARG_INT, int64_t(v)); }
+    void putarg(unsigned long v)      { putnum(v, LOGARG_UINT, uint64_t(v)); }
+    void putarg(long long v)          { putnum(v, LOGARG_INT, int64_t(v)); }
+    void putarg(unsigned long long v) { putnum(v, LOGARG_UINT, uint64_t(v)); }
+    void putarg(float v)              { putnum(v, LOGARG_DOUBLE, double(v)); }
+    void putarg(double v)             { putnum(v, LOGARG_DOUBLE, v); }
+    void putarg(const std::string& v) { if (ring_text) puttext(v); else putstr(v.data(), v.size()); }
+
+    void putarg(const char* v)
+    {
+        if (ring_text)
+            puttext(v);
+        else if (v)
+            putstr(v, strlen(v));
+    }
+
+    void putarg(const LogSocketId& v)
+    {
+        if (ring_text)
+        {
+            puttext(v);
+            return;
+        }
+        putstr("@", 1);
+        putnum(v.id, LOGARG_INT, int64_t(v.id));
+        putstr(": ", 2);
+    }
+
+    template <class T>
+    void putarg(const T& arg)
+    {
+        puttext(arg);
+    }
+
+    template <class T, class V>
+    void putnum(const T& arg, LogArgTag tag, V v)
+    {
+        if (ring_text)
+        {
+            puttext(arg);
+            return;
+        }
+        char buf[1 + sizeof v];
+        buf[0] = char(tag);
+        memcpy(buf + 1, &v, sizeof v);
+        ring->put(buf, sizeof buf);
+    }
+
+    void putstr(const char* s, size_t len)
+    {
+        const uint32_t len32 = uint32_t(len);
+        char buf[1 + sizeof len32];
+        buf[0] = char(LOGARG_TEXT);
+        memcpy(buf + 1, &len32, sizeof len32);
+        ring->put(buf, sizeof buf);
+        ring->put(s, len);
+    }
+
+    template <class T>
+    void puttext(const T& arg)
+    {
+        *os << arg;
+        const std::string text = os->str();
+        os->str(std::string());
+        if (!text.empty())
+            putstr(text.data(), text.size());
+
+        if (os->flags() != ring_flags || os->fill() != ring_fill || os->width() != 0 || os->precision() != 6)
+            ring_text = true;
+    }
+
+    // Publishes the record in the LogRing.
+    void submit();
+
     Proxy& form(const char* fmts, ...) PRINTF_LIKE
     {
         if ( !that_enabled )
@@ -381,7 +550,10 @@ struct LogDispatcher::Proxy
             buf[len-1] = '\0';
         }
 
-        os << buf;
+        if (ring)
+            putarg((const char*)buf);
+        else
+            *os << buf;
         return *this;
     }
 };
@@ -414,7 +586,7 @@ public:
     }
 };
 
-inline bool LogDispatcher::CheckEnabled()
+inline bool LogDispatcher::CheckEnabled(int sock)
 {
     // Don't use enabler caching. Check enabled state every time.
 
@@ -426,6 +598,8 @@ inline bool LogDispatcher::CheckEnabled()
     const LogConfig* config = src_config; // to enforce using const operator[]
     int configured_enabled_fa = config->enabled_fa[fa];
     int configured_maxlevel = config->max_level;
+    if (sock != SRT_INVALID_SOCK && sock == config->sock_filter && config->sock_level > configured_maxlevel)
+        configured_maxlevel = config->sock_level;
 
     return configured_enabled_fa && level <= configured_maxlevel;
 }
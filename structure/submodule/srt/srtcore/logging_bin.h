@@ -0,0 +1,474 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2026 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+/*****************************************************************************
+written by
+   Haivision Systems Inc.
+ *****************************************************************************/
+
+#ifndef INC_SRT_LOGGING_BIN_H
+#define INC_SRT_LOGGING_BIN_H
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "srt.h"
+#include "srt_compat.h"
+#include "logging_api.h"
+#include "atomic.h"
+
+// Binary log records.
+//
+// With SRT_LOGF_ASYNC the log call sites don't format anything. The
+// arguments are stored raw, as a sequence of tagged values, into a
+// per-thread LogRing, and the log writer thread formats them, or writes
+// them into a binary log file (see srt_setlogbinfile), which can be
+// rendered later with srt-logdecode.
+
+namespace srt_logging
+{
+
+// Encoding of a single argument: one tag byte, followed by the value.
+enum LogArgTag
+{
+    LOGARG_INT    = 'i', // int64_t
+    LOGARG_UINT   = 'u', // uint64_t
+    LOGARG_DOUBLE = 'd', // double
+    LOGARG_CHAR   = 'c', // char
+    LOGARG_TEXT   = 's'  // uint32_t length, then the characters
+};
+
+// Binary log file: LOGBIN_MAGIC, LOGBIN_BYTEORDER as uint32_t, then
+// entries, each starting with the type byte. Integers are in the byte
+// order of the host that has written the file. Strings are stored as
+// uint32_t length followed by the characters.
+static const char LOGBIN_MAGIC[8] = {'S', 'R', 'T', 'L', 'O', 'G', 'B', '1'};
+static const uint32_t LOGBIN_BYTEORDER = 0x01020304;
+
+enum LogBinEntry
+{
+    LOGBIN_THREAD  = 'T', // uint32_t id, string name
+    LOGBIN_SITE    = 'S', // uint32_t id, int32_t level, int32_t line, string prefix, string file, string area
+    LOGBIN_RECORD  = 'R', // uint32_t thread, uint32_t site, uint64_t time_us, uint32_t size, encoded arguments
+    LOGBIN_DROPPED = 'D'  // uint32_t thread, uint64_t number of records dropped so far
+};
+
+// Header of a record in LogRing. The location and the dispatcher are
+// kept as pointers; they all have static storage.
+struct LogRecordHead
+{
+    uint32_t size;          // size of the whole record, including this header
+    int32_t line;
+    uint64_t time_us;       // system time (since epoch) in microseconds
+    const void* dispatcher; // LogDispatcher of the call site
+    const char* file;
+    const char* area;
+};
+
+// Writes the beginning of the log line, as LogDispatcher::CreateLogLinePrefix does.
+// An empty thread name means that the name isn't available.
+inline void FormatLogLinePrefix(std::ostream& serr, uint64_t time_us, const char* threadname, const char* prefix, int flags)
+{
+    if (!(flags & SRT_LOGF_DISABLE_TIME))
+    {
+        char tmp_buf[64];
+        const struct tm tm = SysLocalTime((time_t) (time_us / 1000000));
+        if (strftime(tmp_buf, sizeof(tmp_buf), "%X.", &tm))
+        {
+            serr << tmp_buf << std::setw(6) << std::setfill('0') << (time_us % 1000000);
+        }
+    }
+
+    const char* out_prefix = (flags & SRT_LOGF_DISABLE_SEVERITY) ? "" : prefix;
+
+    if (!(flags & SRT_LOGF_DISABLE_THREADNAME) && threadname[0] != '\0')
+    {
+        serr << "/" << threadname << out_prefix << ": ";
+    }
+    else
+    {
+        serr << out_prefix << ": ";
+    }
+}
+
+// Renders the encoded arguments of a record.
+// Returns false if the data are malformed.
+inline bool FormatLogArgs(std::ostream& os, const char* data, size_t size)
+{
+    const char* const end = data + size;
+    while (data < end)
+    {
+        const char tag = *data++;
+        const size_t avail = end - data;
+        switch (tag)
+        {
+        case LOGARG_INT:
+            {
+                int64_t v;
+                if (avail < sizeof v)
+                    return false;
+                memcpy(&v, data, sizeof v);
+                data += sizeof v;
+                os << v;
+            }
+            break;
+
+        case LOGARG_UINT:
+            {
+                uint64_t v;
+                if (avail < sizeof v)
+                    return false;
+                memcpy(&v, data, sizeof v);
+                data += sizeof v;
+                os << v;
+            }
+            break;
+
+        case LOGARG_DOUBLE:
+            {
+                double v;
+                if (avail < sizeof v)
+                    return false;
+                memcpy(&v, data, sizeof v);
+                data += sizeof v;
+                os << v;
+            }
+            break;
+
+        case LOGARG_CHAR:
+            if (avail < 1)
+                return false;
+            os << *data++;
+            break;
+
+        case LOGARG_TEXT:
+            {
+                uint32_t len;
+                if (avail < sizeof len)
+                    return false;
+                memcpy(&len, data, sizeof len);
+                data += sizeof len;
+                if (size_t(end - data) < len)
+                    return false;
+                os.write(data, len);
+                data += len;
+            }
+            break;
+
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+// Ring buffer of the binary log records of one thread. Only the owner
+// thread writes into it and only the log writer thread reads from it,
+// so the positions are synchronized without locking. A record that
+// doesn't fit is dropped and counted.
+class LogRing
+{
+public:
+    static const size_t CAPACITY = 1 << 17; // must be a power of 2
+
+    LogRing(char* data, const char* threadname)
+        : m_pData(data)
+        , m_uHead(0)
+        , m_uTail(0)
+        , m_uDropped(0)
+        , m_bOrphaned(false)
+        , m_uPending(0)
+        , m_bOverflow(false)
+        , m_bBusy(false)
+        , m_uId(0)
+        , m_uReportedDrops(0)
+        , m_pLastDispatcher(NULL)
+    {
+        const size_t len = std::min(strlen(threadname), sizeof m_szThreadName - 1);
+        memcpy(m_szThreadName, threadname, len);
+        m_szThreadName[len] = '\0';
+    }
+
+    ~LogRing() { delete[] m_pData; }
+
+    const char* threadName() const { return m_szThreadName; }
+
+    // Producer side, used only by the owner thread.
+
+    // A record is being written; a log call nested in the formatting
+    // of an argument must not use the ring.
+    bool busy() const { return m_bBusy; }
+
+    uint64_t begin()
+    {
+        m_bBusy = true;
+        m_bOverflow = false;
+        m_uPending = m_uHead;
+        return m_uPending;
+    }
+
+    void put(const void* data, size_t size)
+    {
+        if (m_bOverflow)
+            return;
+        if (m_uPending + size - m_uTail.load() > CAPACITY)
+        {
+            m_bOverflow = true;
+            return;
+        }
+        copyIn(m_uPending, data, size);
+        m_uPending += size;
+    }
+
+    // Overwrites the data already put at the given position.
+    void poke(uint64_t pos, const void* data, size_t size)
+    {
+        if (!m_bOverflow)
+            copyIn(pos, data, size);
+    }
+
+    uint64_t position() const { return m_uPending; }
+
+    // Stream for the arguments that have to be formatted at the log call,
+    // reused by all the records of the owner thread.
+    std::ostringstream& text() { return m_Text; }
+
+    // Publishes the record. Returns false if it was dropped.
+    bool commit()
+    {
+        m_bBusy = false;
+        if (m_bOverflow)
+        {
+            m_uDropped = m_uDropped + 1;
+            return false;
+        }
+        m_uHead = m_uPending;
+        return true;
+    }
+
+    // Consumer side, used only by the log writer thread.
+
+    // Reads the oldest record. Returns false if there's none.
+    bool read(std::vector<char>& w_record)
+    {
+        const uint64_t tail = m_uTail;
+        if (tail == m_uHead)
+            return false;
+
+        uint32_t size;
+        copyOut(tail, &size, sizeof size);
+        w_record.resize(size);
+        copyOut(tail, &w_record[0], size);
+        m_uTail = tail + size;
+        return true;
+    }
+
+    uint64_t dropped() const { return m_uDropped; }
+
+private:
+    void copyIn(uint64_t pos, const void* data, size_t size)
+    {
+        const size_t off   = size_t(pos & (CAPACITY - 1));
+        const size_t first = std::min(size, CAPACITY - off);
+        memcpy(m_pData + off, data, first);
+        memcpy(m_pData, (const char*)data + first, size - first);
+    }
+
+    void copyOut(uint64_t pos, void* data, size_t size) const
+    {
+        const size_t off   = size_t(pos & (CAPACITY - 1));
+        const size_t first = std::min(size, CAPACITY - off);
+        memcpy(data, m_pData + off, first);
+        memcpy((char*)data + first, m_pData, size - first);
+    }
+
+    char* const m_pData;
+    srt::sync::atomic<uint64_t> m_uHead; // end of the published records, written by the owner
+    srt::sync::atomic<uint64_t> m_uTail; // beginning of the oldest record, written by the reader
+    srt::sync::atomic<uint64_t> m_uDropped;
+
+public:
+    // Set when the owner thread has exited. The reader
+    // deletes the ring after reading the remaining records.
+    srt::sync::atomic<bool> m_bOrphaned;
+
+private:
+    // Owner's state of the record being written.
+    uint64_t m_uPending;
+    bool m_bOverflow;
+    bool m_bBusy;
+    std::ostringstream m_Text;
+
+    char m_szThreadName[64];
+
+public:
+    // Reader's state.
+    uint32_t m_uId;
+    uint64_t m_uReportedDrops;
+    const void* m_pLastDispatcher;
+};
+
+// Reads a binary log file written after srt_setlogbinfile()
+// and renders it as text, one log line at a time.
+class LogBinReader
+{
+public:
+    explicit LogBinReader(std::istream& in)
+        : m_in(in)
+        , m_bFailed(false)
+    {
+    }
+
+    // Reads the file header. Returns false if this isn't a binary log
+    // or it was written on a machine with a different byte order.
+    bool open()
+    {
+        char magic[sizeof LOGBIN_MAGIC];
+        uint32_t byteorder = 0;
+        m_in.read(magic, sizeof magic);
+        if (!m_in || memcmp(magic, LOGBIN_MAGIC, sizeof magic) != 0 || !read(byteorder)
+                || byteorder != LOGBIN_BYTEORDER)
+        {
+            m_bFailed = true;
+            return false;
+        }
+        return true;
+    }
+
+    // Renders the next log line, including the EOL, into w_line.
+    // Returns false at the end of the log, or if the data are
+    // malformed, which is then reported by failed().
+    bool next(std::string& w_line)
+    {
+        for (;;)
+        {
+            const int type = m_in.get();
+            if (type == std::char_traits<char>::eof())
+                return false;
+
+            switch (type)
+            {
+            case LOGBIN_THREAD:
+                {
+                    uint32_t id;
+                    std::string name;
+                    if (!read(id) || !read(name))
+                        return fail();
+                    m_Threads[id] = name;
+                }
+                continue;
+
+            case LOGBIN_SITE:
+                {
+                    uint32_t id;
+                    Site s;
+                    if (!read(id) || !read(s.level) || !read(s.line) || !read(s.prefix) || !read(s.file) || !read(s.area))
+                        return fail();
+                    m_Sites[id] = s;
+                }
+                continue;
+
+            case LOGBIN_RECORD:
+                {
+                    uint32_t thread, site, size;
+                    uint64_t time_us;
+                    if (!read(thread) || !read(site) || !read(time_us) || !read(size))
+                        return fail();
+                    m_Args.resize(size);
+                    if (size && !m_in.read(&m_Args[0], size))
+                        return fail();
+
+                    std::map<uint32_t, Site>::const_iterator s = m_Sites.find(site);
+                    if (s == m_Sites.end())
+                        return fail();
+
+                    std::ostringstream os;
+                    FormatLogLinePrefix(os, time_us, threadName(thread), s->second.prefix.c_str(), 0);
+                    if (size && !FormatLogArgs(os, &m_Args[0], size))
+                        return fail();
+                    os << std::endl;
+                    w_line = os.str();
+                }
+                return true;
+
+            case LOGBIN_DROPPED:
+                {
+                    uint32_t thread;
+                    uint64_t dropped;
+                    if (!read(thread) || !read(dropped))
+                        return fail();
+                    std::ostringstream os;
+                    os << "/" << threadName(thread) << ": LOG: " << dropped << " log records dropped so far" << std::endl;
+                    w_line = os.str();
+                }
+                return true;
+
+            default:
+                return fail();
+            }
+        }
+    }
+
+    bool failed() const { return m_bFailed; }
+
+private:
+    struct Site
+    {
+        int32_t level;
+        int32_t line;
+        std::string prefix;
+        std::string file;
+        std::string area;
+    };
+
+    template <class T>
+    bool read(T& w_val)
+    {
+        return bool(m_in.read((char*)&w_val, sizeof w_val));
+    }
+
+    bool read(std::string& w_val)
+    {
+        uint32_t len;
+        if (!read(len))
+            return false;
+        w_val.resize(len);
+        return len == 0 || m_in.read(&w_val[0], len);
+    }
+
+    bool fail()
+    {
+        m_bFailed = true;
+        return false;
+    }
+
+    const char* threadName(uint32_t id) const
+    {
+        std::map<uint32_t, std::string>::const_iterator i = m_Threads.find(id);
+        return i == m_Threads.end() ? "" : i->second.c_str();
+    }
+
+    std::istream& m_in;
+    bool m_bFailed;
+    std::map<uint32_t, std::string> m_Threads;
+    std::map<uint32_t, Site> m_Sites;
+    std::vector<char> m_Args;
+};
+
+} // namespace srt_logging
+
+#endif // INC_SRT_LOGGING_BIN_H
@@ -137,7 +137,7 @@ void srt::PacketFilter::receive(CUnit* unit, std::vector<CUnit*>& w_incoming, lo
     else
     {
         // Packet not to be passthru, update stats
-        ScopedLock lg(m_parent->m_StatsLock);
+        CUDT::StatsWriteLock lg(*m_parent);
         m_parent->m_stats.rcvr.recvdFilterExtra.count(1);
     }
 
@@ -150,7 +150,7 @@ void srt::PacketFilter::receive(CUnit* unit, std::vector<CUnit*>& w_incoming, lo
         int dist = CSeqNo::seqoff(i->first, i->second) + 1;
         if (dist > 0)
         {
-            ScopedLock lg(m_parent->m_StatsLock);
+            CUDT::StatsWriteLock lg(*m_parent);
             m_parent->m_stats.rcvr.lossFilter.count(dist);
         }
         else
@@ -168,7 +168,7 @@ void srt::PacketFilter::receive(CUnit* unit, std::vector<CUnit*>& w_incoming, lo
         size_t nsupply = m_provided.size();
         InsertRebuilt(w_incoming, m_unitq);
 
-        ScopedLock lg(m_parent->m_StatsLock);
+        CUDT::StatsWriteLock lg(*m_parent);
         m_parent->m_stats.rcvr.suppliedByFilter.count((uint32_t)nsupply);
     }
 
@@ -294,6 +294,9 @@ void srt::PacketFilter::globalInit()
 
     filters["fec"] = new Creator<FECFilterBuiltin>;
     builtin_filters.insert("fec");
+
+    filters["rs"] = new Creator<RSFilterBuiltin>;
+    builtin_filters.insert("rs");
 }
 
 bool srt::PacketFilter::configure(CUDT* parent, CUnitQueue* uq, const std::string& confstr)
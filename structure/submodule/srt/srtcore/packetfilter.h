@@ -191,6 +191,7 @@ public:
     void feedSource(CPacket& w_packet);
     SRT_ARQLevel arqLevel();
     bool packControlPacket(int32_t seq, int kflg, CPacket& w_packet);
+    void lossReported(int32_t lo, int32_t hi, int newly);
     void receive(CUnit* unit, std::vector<CUnit*>& w_incoming, loss_seqs_t& w_loss_seqs);
 
 protected:
@@ -211,6 +212,7 @@ bool CheckFilterCompat(SrtFilterConfig& w_agent, SrtFilterConfig peer);
 
 inline void PacketFilter::feedSource(CPacket& w_packet) { SRT_ASSERT(m_filter); return m_filter->feedSource((w_packet)); }
 inline SRT_ARQLevel PacketFilter::arqLevel() { SRT_ASSERT(m_filter); return m_filter->arqLevel(); }
+inline void PacketFilter::lossReported(int32_t lo, int32_t hi, int newly) { SRT_ASSERT(m_filter); return m_filter->lossReported(lo, hi, newly); }
 
 bool ParseFilterConfig(const std::string& s, SrtFilterConfig& out, PacketFilter::Factory** ppf);
 
@@ -134,6 +134,17 @@ protected:
     /// @param [INOUT] packet The packet about to send
     virtual void feedSource(CPacket& packet) = 0;
 
+    /// This is called when the peer has reported lost packets. It's only
+    /// informative and can be used to adjust the filter to the link quality.
+    /// Note that it's called from a different thread than the sender
+    /// side functions above.
+    /// @param [IN] lo The first sequence number of the reported range
+    /// @param [IN] hi The last sequence number of the reported range
+    /// @param [IN] newly The number of packets in the range not reported earlier
+    virtual void lossReported(int32_t /*lo*/, int32_t /*hi*/, int /*newly*/)
+    {
+    }
+
 
     // Receiver side
 
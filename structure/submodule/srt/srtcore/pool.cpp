@@ -0,0 +1,132 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2026 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#include "platform_sys.h"
+
+#include <map>
+#include <vector>
+
+#include "pool.h"
+#include "sync.h"
+#include "atomic.h"
+
+using namespace srt::sync;
+
+namespace
+{
+
+struct PoolState
+{
+    typedef std::map<size_t, std::vector<void*> > buckets_t;
+
+    Mutex        lock;
+    buckets_t    buckets;    // [[protected_by(lock)]]
+    size_t       capacity;   // [[protected_by(lock)]]
+    size_t       retained;   // [[protected_by(lock)]]
+    atomic<bool> enabled;    // capacity != 0, for checking without locking
+
+    PoolState()
+        : capacity(0)
+        , retained(0)
+        , enabled(false)
+    {
+    }
+
+    // [[using locked(lock)]]
+    void trim(size_t limit)
+    {
+        // Free the biggest blocks first, they are the fewest to reallocate.
+        while (retained > limit && !buckets.empty())
+        {
+            buckets_t::iterator b = --buckets.end();
+            while (retained > limit && !b->second.empty())
+            {
+                ::operator delete(b->second.back());
+                b->second.pop_back();
+                retained -= b->first;
+            }
+            if (b->second.empty())
+                buckets.erase(b);
+        }
+    }
+};
+
+// The pool is never destroyed, because the remaining sockets are released
+// by the destruction of the CUDTUnited instance, which is a static object
+// of another translation unit, so in no particular order with this one.
+PoolState& ThePool()
+{
+    static PoolState* pool = new PoolState;
+    return *pool;
+}
+
+} // namespace
+
+void* srt::CObjectPool::allocate(size_t size)
+{
+    PoolState& pool = ThePool();
+    if (pool.enabled)
+    {
+        ScopedLock lk(pool.lock);
+        PoolState::buckets_t::iterator b = pool.buckets.find(size);
+        if (b != pool.buckets.end() && !b->second.empty())
+        {
+            void* ptr = b->second.back();
+            b->second.pop_back();
+            pool.retained -= size;
+            return ptr;
+        }
+    }
+
+    return ::operator new(size);
+}
+
+void srt::CObjectPool::release(void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    PoolState& pool = ThePool();
+    if (pool.enabled)
+    {
+        ScopedLock lk(pool.lock);
+        if (pool.retained + size <= pool.capacity)
+        {
+            try
+            {
+                pool.buckets[size].push_back(ptr);
+                pool.retained += size;
+                return;
+            }
+            catch (...)
+            {
+                // No memory for keeping it, free it then.
+            }
+        }
+    }
+
+    ::operator delete(ptr);
+}
+
+void srt::CObjectPool::setCapacity(size_t bytes)
+{
+    PoolState& pool = ThePool();
+    ScopedLock lk(pool.lock);
+    pool.capacity = bytes;
+    pool.enabled  = bytes != 0;
+    pool.trim(bytes);
+}
+
+size_t srt::CObjectPool::retained()
+{
+    PoolState& pool = ThePool();
+    ScopedLock lk(pool.lock);
+    return pool.retained;
+}
@@ -0,0 +1,88 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2026 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#ifndef INC_SRT_POOL_H
+#define INC_SRT_POOL_H
+
+#include <cstddef>
+#include <new>
+
+namespace srt
+{
+
+/// Memory of the deleted sockets and their buffers, kept for reuse by the
+/// new sockets (see srt_setsocketpool()). The blocks are kept in buckets
+/// of the same size. The sizes of the buffers follow from the socket options,
+/// so the sockets configured the same way reuse the memory that has already
+/// been mapped, instead of allocating and page-faulting it again. The objects
+/// are still constructed anew in the reused memory. Disabled by default,
+/// and then it only forwards to the global operator new and delete.
+class CObjectPool
+{
+public:
+    /// @throw std::bad_alloc
+    static void* allocate(size_t size);
+
+    /// @param size the size passed to allocate()
+    static void release(void* ptr, size_t size);
+
+    /// Sets the maximum number of bytes kept for reuse (0 - off).
+    /// Decreasing the capacity frees the blocks above it.
+    static void setCapacity(size_t bytes);
+
+    /// The number of bytes currently kept for reuse.
+    static size_t retained();
+};
+
+/// Standard allocator taking the memory from CObjectPool.
+template <class T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef PoolAllocator<U> other;
+    };
+
+    PoolAllocator() {}
+    template <class U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    pointer address(reference x) const { return &x; }
+    const_pointer address(const_reference x) const { return &x; }
+
+    pointer allocate(size_type n, const void* = 0)
+    {
+        return static_cast<pointer>(CObjectPool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(pointer p, size_type n) { CObjectPool::release(p, n * sizeof(T)); }
+
+    size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+    void construct(pointer p, const T& val) { new (p) T(val); }
+    void destroy(pointer p) { p->~T(); }
+
+    bool operator==(const PoolAllocator&) const { return true; }
+    bool operator!=(const PoolAllocator&) const { return false; }
+};
+
+} // namespace srt
+
+#endif
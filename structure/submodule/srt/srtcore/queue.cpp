@@ -185,6 +185,58 @@ srt::CUnit* srt::CUnitQueue::getNextAvailUnit()
     return NULL;
 }
 
+void srt::CUnitQueue::shrink(const steady_clock::time_point& now)
+{
+    const int target = std::max(m_iBlockSize, 2 * m_iNumTaken.load());
+    if (m_iSize - m_iBlockSize < target)
+    {
+        m_tsLowOccupancy = steady_clock::time_point();
+        return;
+    }
+
+    if (is_zero(m_tsLowOccupancy))
+        m_tsLowOccupancy = now;
+    if (now - m_tsLowOccupancy < milliseconds_from(SHRINK_DELAY_MS))
+        return;
+    m_tsLowOccupancy = steady_clock::time_point();
+
+    // Units are taken only by this thread, so a block found with all
+    // units free stays so. Other threads can only free the units.
+    CQEntry* prev = m_pQEntry;
+    CQEntry* p    = m_pQEntry->m_pNext;
+    while (p != m_pQEntry && m_iSize - p->m_iSize >= target)
+    {
+        bool unused = true;
+        for (int i = 0; i < p->m_iSize && unused; ++i)
+            unused = !p->m_pUnit[i].m_bTaken;
+
+        if (!unused)
+        {
+            prev = p;
+            p    = p->m_pNext;
+            continue;
+        }
+
+        CQEntry* next = p->m_pNext;
+        prev->m_pNext = next;
+        if (p == m_pLastQueue)
+            m_pLastQueue = prev;
+        if (p == m_pCurrQueue)
+        {
+            m_pCurrQueue = next;
+            m_pAvailUnit = next->m_pUnit;
+        }
+        m_iSize -= p->m_iSize;
+
+        HLOGC(qrlog.Debug, log << "CUnitQueue::shrink: freed " << p->m_iSize << " units, capacity " << m_iSize
+                               << ", " << m_iNumTaken << " in use.");
+        delete[] p->m_pUnit;
+        delete[] p->m_pBuffer;
+        delete p;
+        p = next;
+    }
+}
+
 void srt::CUnitQueue::makeUnitFree(CUnit* unit)
 {
     SRT_ASSERT(unit != NULL);
@@ -207,6 +259,8 @@ srt::CSndUList::CSndUList(sync::CTimer* pTimer)
     : m_pHeap(NULL)
     , m_iArrayLength(512)
     , m_iLastEntry(-1)
+    , m_vReady()
+    , m_dVirtTime(0)
     , m_ListLock()
     , m_pTimer(pTimer)
 {
@@ -231,6 +285,10 @@ void srt::CSndUList::update(const CUDT* u, EReschedule reschedule, sync::steady_
         if (reschedule == DONT_RESCHEDULE)
             return;
 
+        // Already waiting for its turn to send.
+        if (n->m_bReady)
+            return;
+
         if (n->m_tsTimeStamp <= ts)
             return;
 
@@ -253,16 +311,27 @@ srt::CUDT* srt::CSndUList::pop()
 {
     ScopedLock listguard(m_ListLock);
 
-    if (-1 == m_iLastEntry)
-        return NULL;
+    // Move the sockets whose time has come to the heap of the ready ones.
+    const steady_clock::time_point now = loop_now();
+    while (m_iLastEntry >= 0 && m_pHeap[0]->m_tsTimeStamp <= now)
+    {
+        CSNode* n = m_pHeap[0];
+        removeFromTimeHeap_(n);
+        insertReady_(n);
+    }
 
     // no pop until the next scheduled time
-    if (m_pHeap[0]->m_tsTimeStamp > steady_clock::now())
+    if (m_vReady.empty())
         return NULL;
 
-    CUDT* u = m_pHeap[0]->m_pUDT;
-    remove_(u);
-    return u;
+    CSNode* n = m_vReady[0];
+    removeReady_(n);
+
+    // Start-time fair queuing: the socket has its next turn after the others
+    // of the same class have sent as much as their weights allow in the meantime.
+    m_dVirtTime    = std::max(m_dVirtTime, n->m_dStartTag);
+    n->m_dFinishTag = n->m_dStartTag + 1.0 / n->m_pUDT->m_iSndWeight;
+    return n->m_pUDT;
 }
 
 void srt::CSndUList::remove(const CUDT* u)
@@ -275,6 +344,9 @@ steady_clock::time_point srt::CSndUList::getNextProcTime()
 {
     ScopedLock listguard(m_ListLock);
 
+    if (!m_vReady.empty())
+        return m_vReady[0]->m_tsTimeStamp;
+
     if (-1 == m_iLastEntry)
         return steady_clock::time_point();
 
@@ -284,7 +356,7 @@ steady_clock::time_point srt::CSndUList::getNextProcTime()
 void srt::CSndUList::waitNonEmpty() const
 {
     UniqueLock listguard(m_ListLock);
-    if (m_iLastEntry >= 0)
+    if (m_iLastEntry >= 0 || !m_vReady.empty())
         return;
 
     m_ListCond.wait(listguard);
@@ -371,37 +443,145 @@ void srt::CSndUList::remove_(const CUDT* u)
 
     if (n->m_iHeapLoc >= 0)
     {
-        // remove the node from heap
-        m_pHeap[n->m_iHeapLoc] = m_pHeap[m_iLastEntry];
-        m_iLastEntry--;
-        m_pHeap[n->m_iHeapLoc]->m_iHeapLoc = n->m_iHeapLoc.load();
+        if (n->m_bReady)
+            removeReady_(n);
+        else
+            removeFromTimeHeap_(n);
+    }
 
-        int q = n->m_iHeapLoc;
-        int p = q * 2 + 1;
-        while (p <= m_iLastEntry)
-        {
-            if ((p + 1 <= m_iLastEntry) && (m_pHeap[p]->m_tsTimeStamp > m_pHeap[p + 1]->m_tsTimeStamp))
-                p++;
+    // the only event has been deleted, wake up immediately
+    if (0 == m_iLastEntry)
+        m_pTimer->interrupt();
+}
 
-            if (m_pHeap[q]->m_tsTimeStamp > m_pHeap[p]->m_tsTimeStamp)
-            {
-                swap(m_pHeap[p], m_pHeap[q]);
-                m_pHeap[p]->m_iHeapLoc = p;
-                m_pHeap[q]->m_iHeapLoc = q;
+void srt::CSndUList::removeFromTimeHeap_(CSNode* n)
+{
+    // remove the node from heap
+    m_pHeap[n->m_iHeapLoc] = m_pHeap[m_iLastEntry];
+    m_iLastEntry--;
+    m_pHeap[n->m_iHeapLoc]->m_iHeapLoc = n->m_iHeapLoc.load();
 
-                q = p;
-                p = q * 2 + 1;
-            }
-            else
-                break;
+    int q = n->m_iHeapLoc;
+    int p = q * 2 + 1;
+    while (p <= m_iLastEntry)
+    {
+        if ((p + 1 <= m_iLastEntry) && (m_pHeap[p]->m_tsTimeStamp > m_pHeap[p + 1]->m_tsTimeStamp))
+            p++;
+
+        if (m_pHeap[q]->m_tsTimeStamp > m_pHeap[p]->m_tsTimeStamp)
+        {
+            swap(m_pHeap[p], m_pHeap[q]);
+            m_pHeap[p]->m_iHeapLoc = p;
+            m_pHeap[q]->m_iHeapLoc = q;
+
+            q = p;
+            p = q * 2 + 1;
         }
+        else
+            break;
+    }
+
+    n->m_iHeapLoc = -1;
+}
+
+bool srt::CSndUList::readyBefore_(const CSNode* a, const CSNode* b) const
+{
+    if (a->m_iPriority != b->m_iPriority)
+        return a->m_iPriority > b->m_iPriority;
+    if (a->m_dStartTag != b->m_dStartTag)
+        return a->m_dStartTag < b->m_dStartTag;
+    return a->m_tsTimeStamp < b->m_tsTimeStamp;
+}
+
+void srt::CSndUList::setReady_(int pos, CSNode* n)
+{
+    m_vReady[pos] = n;
+    n->m_iHeapLoc = pos;
+}
 
-        n->m_iHeapLoc = -1;
+void srt::CSndUList::insertReady_(CSNode* n)
+{
+    n->m_bReady     = true;
+    n->m_iPriority = n->m_pUDT->m_iSndPriority;
+    n->m_dStartTag  = std::max(m_dVirtTime, n->m_dFinishTag);
+
+    m_vReady.push_back(n);
+    int q = int(m_vReady.size()) - 1;
+    while (q > 0)
+    {
+        const int p = (q - 1) >> 1;
+        if (!readyBefore_(n, m_vReady[p]))
+            break;
+        setReady_(q, m_vReady[p]);
+        q = p;
     }
+    setReady_(q, n);
+}
 
-    // the only event has been deleted, wake up immediately
-    if (0 == m_iLastEntry)
-        m_pTimer->interrupt();
+void srt::CSndUList::removeReady_(CSNode* n)
+{
+    int q = n->m_iHeapLoc;
+    CSNode* last = m_vReady.back();
+    m_vReady.pop_back();
+    n->m_iHeapLoc = -1;
+    n->m_bReady   = false;
+    if (last == n)
+        return;
+
+    // Put the last one in place of the removed one and restore the heap order.
+    while (q > 0 && readyBefore_(last, m_vReady[(q - 1) >> 1]))
+    {
+        setReady_(q, m_vReady[(q - 1) >> 1]);
+        q = (q - 1) >> 1;
+    }
+    const int size = int(m_vReady.size());
+    for (;;)
+    {
+        int p = q * 2 + 1;
+        if (p >= size)
+            break;
+        if (p + 1 < size && readyBefore_(m_vReady[p + 1], m_vReady[p]))
+            p++;
+        if (!readyBefore_(m_vReady[p], last))
+            break;
+        setReady_(q, m_vReady[p]);
+        q = p;
+    }
+    setReady_(q, last);
+}
+
+//
+void srt::CSndRateLimiter::setRate(int64_t rate)
+{
+    m_llRate = rate;
+    // Allow bursts of 10ms worth of data, but at least two full packets.
+    m_dBurst   = std::max(double(2 * CPacket::ETH_MAX_MTU_SIZE), rate / 100.0);
+    m_dTokens  = m_dBurst;
+    m_tsRefill = steady_clock::now();
+}
+
+void srt::CSndRateLimiter::refill(const steady_clock::time_point& now)
+{
+    if (now <= m_tsRefill)
+        return;
+
+    m_dTokens  = std::min(m_dBurst, m_dTokens + m_llRate * (count_microseconds(now - m_tsRefill) / 1000000.0));
+    m_tsRefill = now;
+}
+
+steady_clock::time_point srt::CSndRateLimiter::nextTime(const steady_clock::time_point& now)
+{
+    refill(now);
+    if (m_dTokens >= 0)
+        return now;
+
+    return now + microseconds_from(int64_t(-m_dTokens * 1000000 / m_llRate) + 1);
+}
+
+void srt::CSndRateLimiter::consume(size_t bytes, const steady_clock::time_point& now)
+{
+    refill(now);
+    m_dTokens -= double(bytes);
 }
 
 //
@@ -447,11 +627,12 @@ int srt::CSndQueue::sockoptQuery(int level, int type) const
 int srt::CSndQueue::m_counter = 0;
 #endif
 
-void srt::CSndQueue::init(CChannel* c, CTimer* t)
+void srt::CSndQueue::init(CChannel* c, CTimer* t, int64_t maxbw)
 {
     m_pChannel  = c;
     m_pTimer    = t;
     m_pSndUList = new CSndUList(t);
+    m_RateLimiter.setRate(maxbw);
 
 #if ENABLE_LOGGING
     ++m_counter;
@@ -555,6 +736,23 @@ void* srt::CSndQueue::worker(void* param)
             IF_DEBUG_HIGHRATE(self->m_WorkerStats.lSleepTo++);
         }
 
+        // wait until the rate limit of the multiplexer allows sending
+        if (self->m_RateLimiter.enabled())
+        {
+            const steady_clock::time_point now = steady_clock::now();
+            const steady_clock::time_point allowed_time = self->m_RateLimiter.nextTime(now);
+            if (now < allowed_time)
+            {
+                THREAD_PAUSED();
+                self->m_pTimer->sleep_until(allowed_time);
+                THREAD_RESUMED();
+                continue;
+            }
+        }
+
+        // The time is read once for the packet to be sent.
+        const LoopClock loop_clock;
+
         // Get a socket with a send request if any.
         CUDT* u = self->m_pSndUList->pop();
         if (u == NULL)
@@ -594,7 +792,10 @@ void* srt::CSndQueue::worker(void* param)
             self->m_pSndUList->update(u, CSndUList::DO_RESCHEDULE, next_send_time);
 
         HLOGC(qslog.Debug, log << self->CONID() << "chn:SENDING: " << pkt.Info());
+        const size_t pktsize = pkt.getLength() + CPacket::SRT_DATA_HDR_SIZE;
         self->m_pChannel->sendto(addr, pkt, source_addr);
+        if (self->m_RateLimiter.enabled())
+            self->m_RateLimiter.consume(pktsize, steady_clock::now());
 
         IF_DEBUG_HIGHRATE(self->m_WorkerStats.lSendTo++);
     }
@@ -615,8 +816,7 @@ int srt::CSndQueue::sendto(const sockaddr_any& addr, CPacket& w_packet, const so
 
 //
 srt::CRcvUList::CRcvUList()
-    : m_pUList(NULL)
-    , m_pLast(NULL)
+    : m_vHeap()
 {
 }
 
@@ -624,84 +824,105 @@ srt::CRcvUList::~CRcvUList() {}
 
 void srt::CRcvUList::insert(const CUDT* u)
 {
-    CRNode* n        = u->m_pRNode;
-    n->m_tsTimeStamp = steady_clock::now();
-
-    if (NULL == m_pUList)
-    {
-        // empty list, insert as the single node
-        n->m_pPrev = n->m_pNext = NULL;
-        m_pLast = m_pUList = n;
-
+    CRNode* n = u->m_pRNode;
+    if (n->m_iHeapLoc >= 0)
         return;
-    }
 
-    // always insert at the end for RcvUList
-    n->m_pPrev       = m_pLast;
-    n->m_pNext       = NULL;
-    m_pLast->m_pNext = n;
-    m_pLast          = n;
+    n->m_tsLastCheck = steady_clock::now();
+    n->m_tsTimeStamp = n->m_tsLastCheck + microseconds_from(CUDT::COMM_SYN_INTERVAL_US);
+
+    m_vHeap.push_back(n);
+    heapUp(int(m_vHeap.size()) - 1);
 }
 
 void srt::CRcvUList::remove(const CUDT* u)
 {
     CRNode* n = u->m_pRNode;
 
-    if (!n->m_bOnList)
+    if (!n->m_bOnList || n->m_iHeapLoc < 0)
         return;
 
-    if (NULL == n->m_pPrev)
-    {
-        // n is the first node
-        m_pUList = n->m_pNext;
-        if (NULL == m_pUList)
-            m_pLast = NULL;
-        else
-            m_pUList->m_pPrev = NULL;
-    }
-    else
-    {
-        n->m_pPrev->m_pNext = n->m_pNext;
-        if (NULL == n->m_pNext)
-        {
-            // n is the last node
-            m_pLast = n->m_pPrev;
-        }
-        else
-            n->m_pNext->m_pPrev = n->m_pPrev;
-    }
+    const int pos = n->m_iHeapLoc;
+    n->m_iHeapLoc = -1;
 
-    n->m_pNext = n->m_pPrev = NULL;
+    CRNode* last = m_vHeap.back();
+    m_vHeap.pop_back();
+    if (last == n)
+        return;
+
+    heapSet(pos, last);
+    heapUp(pos);
+    heapDown(last->m_iHeapLoc);
 }
 
 void srt::CRcvUList::update(const CUDT* u)
 {
     CRNode* n = u->m_pRNode;
 
-    if (!n->m_bOnList)
+    if (!n->m_bOnList || n->m_iHeapLoc < 0)
         return;
 
-    n->m_tsTimeStamp = steady_clock::now();
+    n->m_tsLastCheck = loop_now();
+    n->m_tsTimeStamp = n->m_pUDT->nextTimersCheckTime(n->m_tsLastCheck);
+
+    // The check time may only go later after a check,
+    // unless the socket was woken up before its time.
+    heapDown(n->m_iHeapLoc);
+    heapUp(n->m_iHeapLoc);
+}
 
-    // if n is the last node, do not need to change
-    if (NULL == n->m_pNext)
+void srt::CRcvUList::wake(const CUDT* u)
+{
+    CRNode* n = u->m_pRNode;
+
+    if (!n->m_bOnList || n->m_iHeapLoc < 0)
         return;
 
-    if (NULL == n->m_pPrev)
+    const steady_clock::time_point now = steady_clock::now();
+    if (n->m_tsTimeStamp <= now)
+        return;
+
+    n->m_tsTimeStamp = now;
+    heapUp(n->m_iHeapLoc);
+}
+
+bool srt::CRcvUList::overdue(const CUDT* u, const steady_clock::time_point& now) const
+{
+    const CRNode* n = u->m_pRNode;
+    return n->m_iHeapLoc >= 0 && n->m_tsLastCheck + microseconds_from(CUDT::COMM_SYN_INTERVAL_US) < now;
+}
+
+void srt::CRcvUList::heapUp(int pos)
+{
+    CRNode* n = m_vHeap[pos];
+    while (pos > 0)
     {
-        m_pUList          = n->m_pNext;
-        m_pUList->m_pPrev = NULL;
+        const int parent = (pos - 1) >> 1;
+        if (!(n->m_tsTimeStamp < m_vHeap[parent]->m_tsTimeStamp))
+            break;
+        heapSet(pos, m_vHeap[parent]);
+        pos = parent;
     }
-    else
+    heapSet(pos, n);
+}
+
+void srt::CRcvUList::heapDown(int pos)
+{
+    CRNode*   n    = m_vHeap[pos];
+    const int size = int(m_vHeap.size());
+    for (;;)
     {
-        n->m_pPrev->m_pNext = n->m_pNext;
-        n->m_pNext->m_pPrev = n->m_pPrev;
+        int child = pos * 2 + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && m_vHeap[child + 1]->m_tsTimeStamp < m_vHeap[child]->m_tsTimeStamp)
+            ++child;
+        if (!(m_vHeap[child]->m_tsTimeStamp < n->m_tsTimeStamp))
+            break;
+        heapSet(pos, m_vHeap[child]);
+        pos = child;
     }
-
-    n->m_pPrev       = m_pLast;
-    n->m_pNext       = NULL;
-    m_pLast->m_pNext = n;
-    m_pLast          = n;
+    heapSet(pos, n);
 }
 
 //
@@ -1133,6 +1354,7 @@ srt::CRcvQueue::CRcvQueue()
     , m_pListener(NULL)
     , m_pRendezvousQueue(NULL)
     , m_vNewEntry()
+    , m_vWakeTimers()
     , m_IDLock()
     , m_mBuffer()
     , m_BufferCond()
@@ -1285,12 +1507,16 @@ void* srt::CRcvQueue::worker(void* param)
         }
         // OTHERWISE: this is an "AGAIN" situation. No data was read, but the process should continue.
 
-        // take care of the timing event for all UDT sockets
-        const steady_clock::time_point curtime_minus_syn =
-            steady_clock::now() - microseconds_from(CUDT::COMM_SYN_INTERVAL_US);
+        // take care of the timing event for the UDT sockets that have their timers due,
+        // all at the time read once here
+        const LoopClock                loop_clock;
+        const steady_clock::time_point curtime = loop_clock.now();
+
+        // The unit received in this iteration has been taken or dropped.
+        self->m_pUnitQueue->shrink(curtime);
 
-        CRNode* ul = self->m_pRcvUList->m_pUList;
-        while ((NULL != ul) && (ul->m_tsTimeStamp < curtime_minus_syn))
+        CRNode* ul = self->m_pRcvUList->front();
+        while ((NULL != ul) && (ul->m_tsTimeStamp <= curtime))
         {
             CUDT* u = ul->m_pUDT;
 
@@ -1309,7 +1535,7 @@ void* srt::CRcvQueue::worker(void* param)
                 u->m_pRNode->m_bOnList = false;
             }
 
-            ul = self->m_pRcvUList->m_pUList;
+            ul = self->m_pRcvUList->front();
         }
 
         if (have_received)
@@ -1358,6 +1584,20 @@ srt::EReadStatus srt::CRcvQueue::worker_RetrieveUnit(int32_t& w_id, CUnit*& w_un
             m_pHash->insert(ne->m_SocketID, ne);
         }
     }
+
+    // sockets that need their timers checked earlier than scheduled
+    std::vector<int32_t> wake;
+    {
+        ScopedLock listguard(m_IDLock);
+        wake.swap(m_vWakeTimers);
+    }
+    for (size_t i = 0; i < wake.size(); ++i)
+    {
+        CUDT* u = m_pHash->lookup(wake[i]);
+        if (u)
+            m_pRcvUList->wake(u);
+    }
+
     // find next available slot for incoming packet
     w_unit = m_pUnitQueue->getNextAvailUnit();
     if (!w_unit)
@@ -1459,6 +1699,11 @@ srt::EConnectStatus srt::CRcvQueue::worker_ProcessAddressedPacket(int32_t id, CU
         return CONN_AGAIN;
     }
 
+    // An idle socket is not checked periodically. If it would be due for
+    // a periodic check by now, do it before the packet changes its state.
+    if (u->m_bConnected && !u->m_bBroken && !u->m_bClosing && m_pRcvUList->overdue(u, steady_clock::now()))
+        u->checkTimers();
+
     if (!u->m_bConnected || u->m_bBroken || u->m_bClosing)
     {
         u->m_RejectReason = SRT_REJ_CLOSE;
@@ -1751,6 +1996,12 @@ bool srt::CRcvQueue::ifNewEntry()
     return !(m_vNewEntry.empty());
 }
 
+void srt::CRcvQueue::wakeTimers(int32_t id)
+{
+    ScopedLock listguard(m_IDLock);
+    m_vWakeTimers.push_back(id);
+}
+
 srt::CUDT* srt::CRcvQueue::getNewEntry()
 {
     ScopedLock listguard(m_IDLock);
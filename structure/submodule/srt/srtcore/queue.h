@@ -99,6 +99,15 @@ public:
 
     void makeUnitTaken(CUnit* unit);
 
+    /// @brief Free the blocks of units that are all unused, once the occupancy has stayed
+    /// below half of the capacity for SHRINK_DELAY_MS. The first block and twice as many
+    /// units as are in use are kept.
+    /// @note Like getNextAvailUnit(), to be called only by the CRcvQueue::worker thread,
+    /// and not while the unit it has returned is still to be taken.
+    void shrink(const sync::steady_clock::time_point& now);
+
+    static const int SHRINK_DELAY_MS = 1000;
+
 private:
     struct CQEntry
     {
@@ -129,6 +138,7 @@ private:
     sync::atomic<int> m_iNumTaken; // total number of valid (occupied) packets in the queue
     const int m_iMSS; // unit buffer size
     const int m_iBlockSize; // Number of units in each CQEntry.
+    sync::steady_clock::time_point m_tsLowOccupancy; // since when the occupancy is low (see shrink())
 
 private:
     CUnitQueue(const CUnitQueue&);
@@ -141,6 +151,10 @@ struct CSNode
     sync::steady_clock::time_point m_tsTimeStamp;
 
     sync::atomic<int> m_iHeapLoc; // location on the heap, -1 means not on the heap
+    bool              m_bReady;   // on the heap of sockets ready to send rather than on the time heap
+    int               m_iPriority; // priority class, while on the ready heap
+    double            m_dStartTag; // virtual time of fair queuing when it becomes its turn
+    double            m_dFinishTag; // virtual time when the last packet has been sent
 };
 
 class CSndUList
@@ -164,7 +178,11 @@ public:
     /// @param [in] ts the next time to trigger sending logic on the CUDT
     void update(const CUDT* u, EReschedule reschedule, sync::steady_clock::time_point ts = sync::steady_clock::now());
 
-    /// Retrieve the next (in time) socket from the heap to process its sending request.
+    /// Retrieve the next socket to process its sending request. Among the sockets
+    /// whose time has come, the one in the highest priority class (SRTO_SNDPRIORITY)
+    /// is chosen, and within the class the sockets take turns in proportion to
+    /// their weights (SRTO_SNDWEIGHT). Without contention this is simply the next
+    /// socket in time.
     /// @return a pointer to CUDT instance to process next.
     CUDT* pop();
 
@@ -204,11 +222,23 @@ private:
     /// If the last entry is removed, calls sync::CTimer::interrupt().
     void remove_(const CUDT* u);
 
+    /// Removes the node from the heap of the sockets waiting for their time.
+    void removeFromTimeHeap_(CSNode* n);
+
+    /// Operations on the heap of the sockets ready to send.
+    void insertReady_(CSNode* n);
+    void removeReady_(CSNode* n);
+    bool readyBefore_(const CSNode* a, const CSNode* b) const;
+    void setReady_(int pos, CSNode* n);
+
 private:
     CSNode** m_pHeap;        // The heap array
     int      m_iArrayLength; // physical length of the array
     int      m_iLastEntry;   // position of last entry on the heap array or -1 if empty.
 
+    std::vector<CSNode*> m_vReady;    // Sockets whose time has come, in the order of sending.
+    double               m_dVirtTime; // Virtual time of fair queuing among the ready sockets.
+
     mutable sync::Mutex     m_ListLock; // Protects the list (m_pHeap, m_iArrayLength, m_iLastEntry).
     mutable sync::Condition m_ListCond;
 
@@ -222,14 +252,21 @@ private:
 struct CRNode
 {
     CUDT*                          m_pUDT;        // Pointer to the instance of CUDT socket
-    sync::steady_clock::time_point m_tsTimeStamp; // Time Stamp
+    sync::steady_clock::time_point m_tsTimeStamp; // Time of the next timers check
+    sync::steady_clock::time_point m_tsLastCheck; // Time of the last timers check
 
-    CRNode* m_pPrev; // previous link
-    CRNode* m_pNext; // next link
+    int m_iHeapLoc; // location on the heap, -1 means not on the heap
 
     sync::atomic<bool> m_bOnList; // if the node is already on the list
 };
 
+/// The sockets of the receiving queue, in a heap ordered by the time when
+/// their timers (ACK, NAK, EXP, keepalive, retransmission) need to be checked
+/// next (see CUDT::checkTimers()). A socket with pending activity is checked
+/// every COMM_SYN_INTERVAL_US after its last check, as it happens when the
+/// sockets were swept in order. An idle socket is only checked when its
+/// expiration or keepalive timer is due, or after it has been woken up.
+/// Accessed only by the worker thread of CRcvQueue.
 class CRcvUList
 {
 public:
@@ -237,7 +274,7 @@ public:
     ~CRcvUList();
 
 public:
-    /// Insert a new UDT instance to the list.
+    /// Insert a new UDT instance to the list, to be checked after COMM_SYN_INTERVAL_US.
     /// @param [in] u pointer to the UDT instance
 
     void insert(const CUDT* u);
@@ -247,16 +284,40 @@ public:
 
     void remove(const CUDT* u);
 
-    /// Move the UDT instance to the end of the list, if it already exists; otherwise, do nothing.
+    /// Record that the timers of the UDT instance have just been checked,
+    /// and schedule the next check, if it is on the list.
     /// @param [in] u pointer to the UDT instance
 
     void update(const CUDT* u);
 
-public:
-    CRNode* m_pUList; // the head node
+    /// Have the UDT instance checked on the next round, if it is on the list.
+    /// @param [in] u pointer to the UDT instance
+
+    void wake(const CUDT* u);
+
+    /// Check if the UDT instance is on the list and was last checked longer
+    /// than COMM_SYN_INTERVAL_US before @a now.
+    /// @param [in] u pointer to the UDT instance
+    /// @param [in] now current time
+
+    bool overdue(const CUDT* u, const sync::steady_clock::time_point& now) const;
+
+    /// Retrieve the node to be checked first.
+    /// @return The node with the earliest check time or NULL if the list is empty.
+
+    CRNode* front() const { return m_vHeap.empty() ? NULL : m_vHeap[0]; }
+
+private:
+    void heapUp(int pos);
+    void heapDown(int pos);
+    void heapSet(int pos, CRNode* n)
+    {
+        m_vHeap[pos]   = n;
+        n->m_iHeapLoc = pos;
+    }
 
 private:
-    CRNode* m_pLast; // the last node
+    std::vector<CRNode*> m_vHeap; // The heap array
 
 private:
     CRcvUList(const CRcvUList&);
@@ -391,6 +452,38 @@ private:
     mutable sync::Mutex m_RIDListLock;
 };
 
+/// Token bucket limiting the sending rate of all sockets of a multiplexer
+/// (SRTO_MUXMAXBW). Used only by the worker thread of CSndQueue.
+class CSndRateLimiter
+{
+public:
+    CSndRateLimiter()
+        : m_llRate(0)
+        , m_dTokens(0)
+        , m_dBurst(0)
+    {
+    }
+
+    /// Set the rate in bytes per second, 0 for unlimited.
+    void setRate(int64_t rate);
+
+    bool enabled() const { return m_llRate > 0; }
+
+    /// Time when the next packet may be sent.
+    sync::steady_clock::time_point nextTime(const sync::steady_clock::time_point& now);
+
+    /// Take the tokens for a packet of the given size sent at the given time.
+    void consume(size_t bytes, const sync::steady_clock::time_point& now);
+
+private:
+    void refill(const sync::steady_clock::time_point& now);
+
+    int64_t                        m_llRate;   // bytes per second
+    double                         m_dTokens;  // bytes, negative when in debt
+    double                         m_dBurst;   // maximum tokens
+    sync::steady_clock::time_point m_tsRefill; // time of the last refill
+};
+
 class CSndQueue
 {
     friend class CUDT;
@@ -410,7 +503,8 @@ public:
     /// Initialize the sending queue.
     /// @param [in] c UDP channel to be associated to the queue
     /// @param [in] t Timer
-    void init(CChannel* c, sync::CTimer* t);
+    /// @param [in] maxbw maximum sending rate of all sockets in bytes per second, 0 for unlimited
+    void init(CChannel* c, sync::CTimer* t, int64_t maxbw = 0);
 
     /// Send out a packet to a given address. The @a src parameter is
     /// blindly passed by the caller down the call with intention to
@@ -445,9 +539,10 @@ private:
     sync::CThread m_WorkerThread;
 
 private:
-    CSndUList*    m_pSndUList; // List of UDT instances for data sending
-    CChannel*     m_pChannel;  // The UDP channel for data sending
-    sync::CTimer* m_pTimer;    // Timing facility
+    CSndUList*      m_pSndUList;    // List of UDT instances for data sending
+    CChannel*       m_pChannel;     // The UDP channel for data sending
+    sync::CTimer*   m_pTimer;       // Timing facility
+    CSndRateLimiter m_RateLimiter;  // Limit of the sending rate of the multiplexer
 
     sync::atomic<bool> m_bClosing;            // closing the worker
 
@@ -551,6 +646,11 @@ private:
     bool  ifNewEntry();
     CUDT* getNewEntry();
 
+    /// Request the timers of the socket to be checked on the next round
+    /// of the worker (see CRcvUList::wake()).
+    /// @param [in] id socket ID
+    void wakeTimers(int32_t id);
+
     void storePktClone(int32_t id, const CPacket& pkt);
 
 private:
@@ -558,8 +658,9 @@ private:
     CUDT*             m_pListener;        // pointer to the (unique, if any) listening UDT entity
     CRendezvousQueue* m_pRendezvousQueue; // The list of sockets in rendezvous mode
 
-    std::vector<CUDT*> m_vNewEntry; // newly added entries, to be inserted
-    sync::Mutex        m_IDLock;
+    std::vector<CUDT*>   m_vNewEntry;   // newly added entries, to be inserted
+    std::vector<int32_t> m_vWakeTimers; // sockets to have their timers checked, see wakeTimers()
+    sync::Mutex          m_IDLock;
 
     std::map<int32_t, std::queue<CPacket*> > m_mBuffer; // temporary buffer for rendezvous connection request
     sync::Mutex                              m_BufferLock;
@@ -932,6 +932,77 @@ struct CSrtConfigSetter<SRTO_CRYPTOMODE>
 };
 #endif
 
+template<>
+struct CSrtConfigSetter<SRTO_CRYPTOWORKERS>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        using namespace srt_logging;
+        const int val = cast_optval<int>(optval, optlen);
+#ifdef SRT_ENABLE_ENCRYPTION
+        if (val < 0 || val > CSrtConfig::MAX_CRYPTO_WORKERS)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+        co.iCryptoWorkers = val;
+#else
+        LOGC(aclog.Error, log << "SRT was built without crypto module.");
+        throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+#endif
+    }
+};
+
+template<>
+struct CSrtConfigSetter<SRTO_TSBPDWORKERS>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        const int val = cast_optval<int>(optval, optlen);
+        if (val < 0 || val > CSrtConfig::MAX_TSBPD_WORKERS)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+        co.iTsbPdWorkers = val;
+    }
+};
+
+template<>
+struct CSrtConfigSetter<SRTO_SNDPRIORITY>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        const int val = cast_optval<int>(optval, optlen);
+        if (val < 0 || val > CSrtConfig::MAX_SND_PRIORITY)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+        co.iSndPriority = val;
+    }
+};
+
+template<>
+struct CSrtConfigSetter<SRTO_SNDWEIGHT>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        const int val = cast_optval<int>(optval, optlen);
+        if (val < 1 || val > CSrtConfig::MAX_SND_WEIGHT)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+        co.iSndWeight = val;
+    }
+};
+
+template<>
+struct CSrtConfigSetter<SRTO_MUXMAXBW>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        const int64_t val = cast_optval<int64_t>(optval, optlen);
+        if (val < 0)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+        co.llMuxMaxBW = val;
+    }
+};
+
 int dispatchSet(SRT_SOCKOPT optName, CSrtConfig& co, const void* optval, int optlen)
 {
     switch (optName)
@@ -995,6 +1066,11 @@ int dispatchSet(SRT_SOCKOPT optName, CSrtConfig& co, const void* optval, int opt
 #ifdef ENABLE_MAXREXMITBW
         DISPATCH(SRTO_MAXREXMITBW);
 #endif
+        DISPATCH(SRTO_CRYPTOWORKERS);
+        DISPATCH(SRTO_TSBPDWORKERS);
+        DISPATCH(SRTO_SNDPRIORITY);
+        DISPATCH(SRTO_SNDWEIGHT);
+        DISPATCH(SRTO_MUXMAXBW);
 
 #undef DISPATCH
     default:
@@ -1086,6 +1162,9 @@ bool SRT_SocketOptionObject::add(SRT_SOCKOPT optname, const void* optval, size_t
         //SRTO_RCVTIMEO - must be always -1 in groups
     case SRTO_SNDBUF:
     case SRTO_SNDDROPDELAY:
+    case SRTO_SNDPRIORITY:
+    case SRTO_SNDWEIGHT:
+    case SRTO_MUXMAXBW:
         //SRTO_TLPKTDROP - per transmission setting
         //SRTO_TSBPDMODE - per transmission setting
     case SRTO_UDP_RCVBUF:
@@ -90,6 +90,7 @@ struct CSrtMuxerConfig
 #endif
     int iUDPSndBufSize; // UDP sending buffer size
     int iUDPRcvBufSize; // UDP receiving buffer size
+    int64_t llMuxMaxBW; // SRTO_MUXMAXBW
 
     // NOTE: this operator is not reversable. The syntax must use:
     //  muxer_entry == socket_entry
@@ -104,6 +105,7 @@ struct CSrtMuxerConfig
 #endif
             && CEQUAL(iUDPSndBufSize)
             && CEQUAL(iUDPRcvBufSize)
+            && CEQUAL(llMuxMaxBW)
             && (other.iIpV6Only == -1 || CEQUAL(iIpV6Only))
             // NOTE: iIpV6Only is not regarded because
             // this matches only in case of IPv6 with "any" address.
@@ -121,6 +123,7 @@ struct CSrtMuxerConfig
         , bReuseAddr(true) // This is default in SRT
         , iUDPSndBufSize(DEF_UDP_BUFFER_SIZE)
         , iUDPRcvBufSize(DEF_UDP_BUFFER_SIZE)
+        , llMuxMaxBW(0)
     {
     }
 };
@@ -209,6 +212,10 @@ struct CSrtConfig: CSrtMuxerConfig
     static const size_t MAX_SID_LENGTH     = 512;
     static const size_t MAX_PFILTER_LENGTH = 64;
     static const size_t MAX_CONG_LENGTH    = 16;
+    static const int    MAX_CRYPTO_WORKERS = 8;
+    static const int    MAX_TSBPD_WORKERS  = 8;
+    static const int    MAX_SND_PRIORITY   = 7;
+    static const int    MAX_SND_WEIGHT     = 100;
 
     int    iMSS;            // Maximum Segment Size, in bytes
     size_t zExpPayloadSize; // Expected average payload size (user option)
@@ -253,6 +260,10 @@ struct CSrtConfig: CSrtMuxerConfig
     uint32_t uMinStabilityTimeout_ms;
     int      iRetransmitAlgo;
     int      iCryptoMode; // SRTO_CRYPTOMODE
+    int      iCryptoWorkers; // SRTO_CRYPTOWORKERS
+    int      iTsbPdWorkers;  // SRTO_TSBPDWORKERS
+    int      iSndPriority;   // SRTO_SNDPRIORITY
+    int      iSndWeight;     // SRTO_SNDWEIGHT
 
     int64_t llInputBW;         // Input stream rate (bytes/sec). 0: use internally estimated input bandwidth
     int64_t llMinInputBW;      // Minimum input stream rate estimate (bytes/sec)
@@ -308,6 +319,10 @@ struct CSrtConfig: CSrtMuxerConfig
         , uMinStabilityTimeout_ms(COMM_DEF_MIN_STABILITY_TIMEOUT_MS)
         , iRetransmitAlgo(1)
         , iCryptoMode(CIPHER_MODE_AUTO)
+        , iCryptoWorkers(0)
+        , iTsbPdWorkers(0)
+        , iSndPriority(0)
+        , iSndWeight(1)
         , llInputBW(0)
         , llMinInputBW(0)
         , iOverheadBW(25)
@@ -233,6 +233,11 @@ typedef enum SRT_SOCKOPT {
 #ifdef ENABLE_MAXREXMITBW
    SRTO_MAXREXMITBW = 63,    // Maximum bandwidth limit for retransmision (Bytes/s)
 #endif
+   SRTO_CRYPTOWORKERS = 64,  // Number of threads encrypting packets ahead of sending (0 - encrypt when sending)
+   SRTO_TSBPDWORKERS = 65,   // Number of shared threads doing the TSBPD (0 - a thread per socket)
+   SRTO_SNDPRIORITY = 66,    // Priority class of sending among sockets of one multiplexer (0 - lowest, default)
+   SRTO_SNDWEIGHT = 67,      // Share of sending among sockets of the same priority class of one multiplexer
+   SRTO_MUXMAXBW = 68,       // Maximum sending rate of all sockets of a multiplexer (Bytes/s, 0 - unlimited)
 
    SRTO_E_SIZE // Always last element, not a valid option.
 } SRT_SOCKOPT;
@@ -743,6 +748,9 @@ static const int SRT_ERROR = -1;
 // library initialization
 SRT_API       int srt_startup(void);
 SRT_API       int srt_cleanup(void);
+// Keep up to maxbytes of the memory of deleted sockets and their buffers
+// for reuse by new sockets (0 - off, the default).
+SRT_API       int srt_setsocketpool(size_t maxbytes);
 
 //
 // Socket operations
@@ -835,6 +843,17 @@ SRT_API int srt_send    (SRTSOCKET u, const char* buf, int len);
 SRT_API int srt_sendmsg (SRTSOCKET u, const char* buf, int len, int ttl/* = -1*/, int inorder/* = false*/);
 SRT_API int srt_sendmsg2(SRTSOCKET u, const char* buf, int len, SRT_MSGCTRL *mctrl);
 
+// Zero-copy sending: the sender buffer refers to the caller's buffer
+// instead of copying it. The buffer must stay valid and unmodified until
+// the release function is called, which happens exactly once, when no
+// packet refers to the data anymore (acknowledged, dropped or the socket
+// deleted), or before returning if nothing has been scheduled. The release
+// function is called from an SRT internal thread and must not call SRT API
+// functions. With encryption on, the data are copied at the first sending.
+typedef void srt_send_release_fn(void* opaque, const char* buf, int len);
+SRT_API int srt_sendmsg2_nocopy(SRTSOCKET u, const char* buf, int len, SRT_MSGCTRL *mctrl,
+                                srt_send_release_fn* release_fn, void* opaque);
+
 //
 // Receiving functions
 //
@@ -844,6 +863,22 @@ SRT_API int srt_recv    (SRTSOCKET u, char* buf, int len);
 SRT_API int srt_recvmsg (SRTSOCKET u, char* buf, int len);
 SRT_API int srt_recvmsg2(SRTSOCKET u, char *buf, int len, SRT_MSGCTRL *mctrl);
 
+// Zero-copy receiving: instead of copying the message into the caller's
+// buffer, srt_recvmsg2_lend() gives a read-only view into the receiver
+// buffer unit holding it. The unit is returned with srt_recvmsg2_release()
+// and until then it's counted off the receiver window. Only a message
+// carried by a single packet can be lent (always the case in live mode).
+// Views still held when the socket is closed become invalid.
+typedef struct SRT_MsgView_
+{
+   const char* data;     // message payload
+   int len;              // payload length
+   void* token;          // lent unit identifier for srt_recvmsg2_release
+} SRT_MSGVIEW;
+
+SRT_API int srt_recvmsg2_lend(SRTSOCKET u, SRT_MSGVIEW *view, SRT_MSGCTRL *mctrl);
+SRT_API int srt_recvmsg2_release(SRTSOCKET u, SRT_MSGVIEW *view);
+
 
 // Special send/receive functions for files only.
 #define SRT_DEFAULT_SENDFILE_BLOCK 364000
@@ -863,6 +898,8 @@ SRT_API       void  srt_clearlasterror(void);
 SRT_API int srt_bstats(SRTSOCKET u, SRT_TRACEBSTATS * perf, int clear);
 // Performance monitor with Byte counters and instantaneous stats instead of moving averages for Snd/Rcvbuffer sizes.
 SRT_API int srt_bistats(SRTSOCKET u, SRT_TRACEBSTATS * perf, int clear, int instantaneous);
+// Performance monitor reading the counters without locking, for frequent polling. Never clears the counters.
+SRT_API int srt_bstats_snapshot(SRTSOCKET u, SRT_TRACEBSTATS * perf);
 
 // Socket Status (for problem tracking)
 SRT_API SRT_SOCKSTATUS srt_getsockstate(SRTSOCKET u);
@@ -903,6 +940,12 @@ SRT_API void srt_resetlogfa(const int* fara, size_t fara_size);
 // SRT_API void srt_setlogstream(std::ostream& stream);
 SRT_API void srt_setloghandler(void* opaque, SRT_LOG_HANDLER_FN* handler);
 SRT_API void srt_setlogflags(int flags);
+// Log the lines of the given socket up to the given level, even if it's above
+// the one set by srt_setloglevel. Pass SRT_INVALID_SOCK to turn it off.
+SRT_API void srt_setlogsocket(SRTSOCKET sock, int ll);
+// Write the log records in binary form into the file, to be rendered with srt-logdecode.
+// Pass NULL to close the file. Returns -1 if the file can't be opened.
+SRT_API int srt_setlogbinfile(const char* path);
 
 
 SRT_API int srt_getsndbuffer(SRTSOCKET sock, size_t* blocks, size_t* bytes);
@@ -929,6 +972,7 @@ SRT_API int64_t srt_connection_time(SRTSOCKET sock);
 #define SRT_SYNC_CLOCK_AMD64_RDTSC        5
 #define SRT_SYNC_CLOCK_IA32_RDTSC         6
 #define SRT_SYNC_CLOCK_IA64_ITC           7
+#define SRT_SYNC_CLOCK_TSC                8 // Calibrated invariant TSC, resynchronized with CLOCK_MONOTONIC
 
 SRT_API int srt_clock_type(void);
 
@@ -939,6 +983,7 @@ typedef enum SRT_GROUP_TYPE
     SRT_GTYPE_UNDEFINED,
     SRT_GTYPE_BROADCAST,
     SRT_GTYPE_BACKUP,
+    SRT_GTYPE_BALANCING,
     // ...
     SRT_GTYPE_E_END
 } SRT_GROUP_TYPE;
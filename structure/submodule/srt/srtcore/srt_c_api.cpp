@@ -21,6 +21,7 @@ written by
 #include "common.h"
 #include "packet.h"
 #include "core.h"
+#include "pool.h"
 #include "utilities.h"
 
 using namespace std;
@@ -32,6 +33,12 @@ extern "C" {
 int srt_startup() { return CUDT::startup(); }
 int srt_cleanup() { return CUDT::cleanup(); }
 
+int srt_setsocketpool(size_t maxbytes)
+{
+    srt::CObjectPool::setCapacity(maxbytes);
+    return 0;
+}
+
 // Socket creation.
 SRTSOCKET srt_socket(int , int , int ) { return CUDT::socket(); }
 SRTSOCKET srt_create_socket() { return CUDT::socket(); }
@@ -231,6 +238,32 @@ int srt_sendmsg2(SRTSOCKET u, const char * buf, int len, SRT_MSGCTRL *mctrl)
     return CUDT::sendmsg2(u, buf, len, (mignore));
 }
 
+int srt_sendmsg2_nocopy(SRTSOCKET u, const char * buf, int len, SRT_MSGCTRL *mctrl,
+                        srt_send_release_fn* release_fn, void* opaque)
+{
+    if (mctrl)
+        return CUDT::sendmsg2_nocopy(u, buf, len, (*mctrl), release_fn, opaque);
+    SRT_MSGCTRL mignore = srt_msgctrl_default;
+    return CUDT::sendmsg2_nocopy(u, buf, len, (mignore), release_fn, opaque);
+}
+
+int srt_recvmsg2_lend(SRTSOCKET u, SRT_MSGVIEW *view, SRT_MSGCTRL *mctrl)
+{
+    if (!view)
+        return CUDT::APIError(MJ_NOTSUP, MN_INVAL, 0);
+    if (mctrl)
+        return CUDT::recvmsg2_lend(u, (*view), (*mctrl));
+    SRT_MSGCTRL mignore = srt_msgctrl_default;
+    return CUDT::recvmsg2_lend(u, (*view), (mignore));
+}
+
+int srt_recvmsg2_release(SRTSOCKET u, SRT_MSGVIEW *view)
+{
+    if (!view)
+        return CUDT::APIError(MJ_NOTSUP, MN_INVAL, 0);
+    return CUDT::recvmsg2_release(u, (*view));
+}
+
 int srt_recvmsg2(SRTSOCKET u, char * buf, int len, SRT_MSGCTRL *mctrl)
 {
     if (mctrl)
@@ -263,6 +296,7 @@ void srt_clearlasterror()
 
 int srt_bstats(SRTSOCKET u, SRT_TRACEBSTATS * perf, int clear) { return CUDT::bstats(u, perf, 0!=  clear); }
 int srt_bistats(SRTSOCKET u, SRT_TRACEBSTATS * perf, int clear, int instantaneous) { return CUDT::bstats(u, perf, 0!=  clear, 0!= instantaneous); }
+int srt_bstats_snapshot(SRTSOCKET u, SRT_TRACEBSTATS * perf) { return CUDT::bstatsSnapshot(u, perf); }
 
 SRT_SOCKSTATUS srt_getsockstate(SRTSOCKET u) { return SRT_SOCKSTATUS((int)CUDT::getsockstate(u)); }
 
@@ -370,6 +404,18 @@ void srt_setlogflags(int flags)
     UDT::setlogflags(flags);
 }
 
+void srt_setlogsocket(SRTSOCKET sock, int ll)
+{
+    srt::setlogsocket(sock, srt_logging::LogLevel::type(ll));
+}
+
+int srt_setlogbinfile(const char* path)
+{
+    if (!srt::setlogbinfile(path))
+        return CUDT::APIError(MJ_FILESYSTEM, MN_WRITEFAIL, 0);
+    return 0;
+}
+
 int srt_getsndbuffer(SRTSOCKET sock, size_t* blocks, size_t* bytes)
 {
     return CUDT::getsndbuffer(sock, blocks, bytes);
@@ -12,6 +12,7 @@
 #define INC_SRT_STATS_H
 
 #include "platform_sys.h"
+#include "atomic.h"
 #include "packet.h"
 
 namespace srt
@@ -19,6 +20,86 @@ namespace srt
 namespace stats
 {
 
+#if defined(ATOMIC_USE_SRT_SYNC_MUTEX) && (ATOMIC_USE_SRT_SYNC_MUTEX == 1)
+// Without atomic instructions, CUDT::bstatsSnapshot() takes the locks.
+#define SRT_STATS_LOCKFREE 0
+#else
+#define SRT_STATS_LOCKFREE 1
+#endif
+
+// A statistics value with a single writer at a time: all updates are done
+// under the lock of the object that owns it (e.g. CUDT::m_StatsLock). It can
+// be read at any time without the lock (see CUDT::bstatsSnapshot()), hence
+// the accesses are atomic, but relaxed, as the ordering of the reads is
+// ensured by the Version of the owner.
+template <class T>
+class Value
+{
+public:
+    explicit Value(T val = T()) : m_value(val) {}
+
+#if SRT_STATS_LOCKFREE
+    T load() const { return m_value.load_relaxed(); }
+    void store(T val) { m_value.store_relaxed(val); }
+#else
+    T load() const { return m_value; }
+    void store(T val) { m_value = val; }
+#endif
+
+    operator T() const { return load(); }
+
+    Value& operator=(T val)
+    {
+        store(val);
+        return *this;
+    }
+
+private:
+#if SRT_STATS_LOCKFREE
+    sync::atomic<T> m_value;
+#else
+    T m_value;
+#endif
+
+    Value(const Value&);
+    Value& operator=(const Value&);
+};
+
+// Version of a set of statistics values, making it possible to read them
+// all consistently without locking (a sequence lock). The writer, under
+// the lock of the owner, marks the update in progress by making the version
+// odd, and the reader repeats reading while the update was in progress.
+class Version
+{
+public:
+    Version() : m_seq(0) {}
+
+#if SRT_STATS_LOCKFREE
+    void beginWrite()
+    {
+        m_seq.store_relaxed(m_seq.load_relaxed() + 1);
+        sync::atomic_fence_release();
+    }
+
+    void endWrite() { m_seq.store_release(m_seq.load_relaxed() + 1); }
+
+    uint32_t beginRead() const { return m_seq.load_acquire(); }
+
+    /// @returns true if the values read since beginRead() returned @a ver are consistent.
+    bool validRead(uint32_t ver) const
+    {
+        sync::atomic_fence_acquire();
+        return (ver & 1) == 0 && m_seq.load_relaxed() == ver;
+    }
+#else
+    void beginWrite() {}
+    void endWrite() {}
+#endif
+
+private:
+    sync::atomic<uint32_t> m_seq;
+};
+
 class Packets
 {
 public:
@@ -26,6 +107,14 @@ public:
 
     Packets(uint32_t num) : m_count(num) {}
 
+    Packets(const Packets& other) : m_count(other.count()) {}
+
+    Packets& operator= (const Packets& other)
+    {
+        m_count = other.count();
+        return *this;
+    }
+
     void reset()
     {
         m_count = 0;
@@ -33,7 +122,7 @@ public:
 
     Packets& operator+= (const Packets& other)
     {
-        m_count   += other.m_count;
+        m_count = m_count + other.count();
         return *this;
     }
 
@@ -43,7 +132,7 @@ public:
     }
 
 private:
-    uint32_t m_count;
+    Value<uint32_t> m_count;
 };
 
 class BytesPackets
@@ -59,6 +148,17 @@ public:
         , m_packets(n)
     {}
 
+    BytesPackets(const BytesPackets& other)
+        : m_bytes(other.bytes())
+        , m_packets(other.count())
+    {}
+
+    BytesPackets& operator= (const BytesPackets& other)
+    {
+        m_bytes   = other.bytes();
+        m_packets = other.count();
+        return *this;
+    }
 
     void reset()
     {
@@ -68,8 +168,8 @@ public:
 
     void count(uint64_t bytes, size_t n = 1)
     {
-        m_packets += (uint32_t) n;
-        m_bytes += bytes;
+        m_packets = m_packets + (uint32_t) n;
+        m_bytes = m_bytes + bytes;
     }
 
     uint64_t bytes() const 
@@ -84,19 +184,18 @@ public:
 
     BytesPackets& operator+= (const BytesPackets& other)
     {
-        m_bytes   += other.m_bytes;
-        m_packets += other.m_packets;
+        count(other.bytes(), other.count());
         return *this;
     }
 
     uint64_t bytesWithHdr(size_t hdr_size) const
     {
-        return m_bytes + m_packets * hdr_size;
+        return bytes() + count() * hdr_size;
     }
 
 protected:
-    uint64_t m_bytes;
-    uint32_t m_packets;
+    Value<uint64_t> m_bytes;
+    Value<uint32_t> m_packets;
 };
 
 
@@ -27,7 +27,10 @@
 #include <pthread.h>
 
 // Defile clock type to use
-#ifdef IA32
+#if defined(ENABLE_TSC_CLOCK)
+#define SRT_SYNC_CLOCK SRT_SYNC_CLOCK_TSC
+#define SRT_SYNC_CLOCK_STR "TSC"
+#elif defined(IA32)
 #define SRT_SYNC_CLOCK SRT_SYNC_CLOCK_IA32_RDTSC
 #define SRT_SYNC_CLOCK_STR "IA32_RDTSC"
 #elif defined(IA64)
@@ -306,6 +309,37 @@ inline bool is_zero(const TimePoint<steady_clock>& t)
 
 #endif // ENABLE_STDCXX_SYNC
 
+/// The current time cached for one iteration of a worker loop.
+/// A worker thread that handles many packets or sockets in one iteration
+/// keeps an object of this class and calls refresh() once per iteration.
+/// While the object exists, loop_now() called in this thread returns the
+/// time read by the last refresh() instead of reading the clock again.
+class LoopClock
+{
+public:
+    LoopClock();
+    ~LoopClock();
+
+    const steady_clock::time_point& refresh()
+    {
+        m_tsNow = steady_clock::now();
+        return m_tsNow;
+    }
+
+    const steady_clock::time_point& now() const { return m_tsNow; }
+
+private:
+    steady_clock::time_point m_tsNow;
+    LoopClock*               m_pPrevious; // The clock of an enclosing scope in this thread, if any.
+
+    LoopClock(const LoopClock&);
+    LoopClock& operator=(const LoopClock&);
+};
+
+/// Returns the time cached by the LoopClock of the calling thread,
+/// or steady_clock::now() if the thread has none.
+steady_clock::time_point loop_now();
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
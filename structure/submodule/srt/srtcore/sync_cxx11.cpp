@@ -106,3 +106,30 @@ srt::CUDTException& srt::sync::GetThreadLocalError()
     return s_thErr;
 }
 
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// LoopClock class
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// The LoopClock of the innermost scope in the current thread.
+static thread_local srt::sync::LoopClock* s_pLoopClock = NULL;
+
+srt::sync::LoopClock::LoopClock()
+    : m_tsNow(steady_clock::now())
+    , m_pPrevious(s_pLoopClock)
+{
+    s_pLoopClock = this;
+}
+
+srt::sync::LoopClock::~LoopClock()
+{
+    s_pLoopClock = m_pPrevious;
+}
+
+srt::sync::steady_clock::time_point srt::sync::loop_now()
+{
+    const LoopClock* clock = s_pLoopClock;
+    return clock ? clock->now() : steady_clock::now();
+}
@@ -27,6 +27,11 @@
 #include <mach/mach_time.h>
 #endif
 
+#if SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_TSC
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
 namespace srt_logging
 {
     extern Logger inlog;
@@ -38,9 +43,172 @@ namespace srt
 namespace sync
 {
 
+#if SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_TSC
+
+static uint64_t monotonic_ns()
+{
+    timespec tm;
+    clock_gettime(CLOCK_MONOTONIC, &tm);
+    return tm.tv_sec * uint64_t(1000000000) + tm.tv_nsec;
+}
+
+/// Nanoseconds of CLOCK_MONOTONIC read from the CPU timestamp counter.
+///
+/// An invariant TSC runs at a constant rate on all cores, but this rate is
+/// only known as measured against CLOCK_MONOTONIC. It is measured shortly at
+/// start and then again by the first thread that reads the clock after every
+/// RESYNC_PERIOD_NS. Every resync continues from the current reading, so the
+/// clock never jumps back, and the new rate is corrected so that the remaining
+/// difference from CLOCK_MONOTONIC disappears within the next period.
+///
+/// The conversion parameters are published with a sequence counter, so that
+/// readers never lock. Without an invariant TSC this reads CLOCK_MONOTONIC.
+class TscClock
+{
+public:
+    TscClock()
+        : m_bInvariant(hasInvariantTsc())
+        , m_uSeq(0)
+        , m_uBaseTsc(0)
+        , m_uBaseNs(0)
+        , m_uMult(0)
+        , m_uResyncTicks(0)
+        , m_bResyncing(false)
+        , m_uRefTsc(0)
+        , m_uRefNs(0)
+    {
+        if (!m_bInvariant)
+            return;
+
+        uint64_t tsc0, ns0, tsc1, ns1;
+        sample((tsc0), (ns0));
+        do
+            sample((tsc1), (ns1));
+        while (ns1 - ns0 < CALIBRATION_NS);
+
+        m_uRefTsc = tsc1;
+        m_uRefNs  = ns1;
+        publish(tsc1, ns1, double(ns1 - ns0) / double(tsc1 - tsc0));
+    }
+
+    uint64_t now()
+    {
+        if (!m_bInvariant)
+            return monotonic_ns();
+
+        uint64_t seq, tsc, base_tsc, base_ns, mult, resync_ticks;
+        do
+        {
+            seq          = m_uSeq.load();
+            tsc          = __rdtsc();
+            base_tsc     = m_uBaseTsc.load();
+            base_ns      = m_uBaseNs.load();
+            mult         = m_uMult.load();
+            resync_ticks = m_uResyncTicks.load();
+        } while ((seq & 1) || m_uSeq.load() != seq);
+
+        // The base may have been taken on another core a moment after the
+        // counter was read here.
+        const uint64_t delta = tsc > base_tsc ? tsc - base_tsc : 0;
+        const uint64_t ns    = base_ns + convert(delta, mult);
+
+        if (delta > resync_ticks && m_bResyncing.compare_exchange(false, true))
+        {
+            resync(base_tsc, base_ns, mult);
+            m_bResyncing = false;
+        }
+        return ns;
+    }
+
+private:
+    static const int      SHIFT            = 28; // Fraction bits of m_uMult, the nanoseconds per tick.
+    static const uint64_t CALIBRATION_NS   = 1000000;
+    static const uint64_t RESYNC_PERIOD_NS = 1000000000;
+
+    static bool hasInvariantTsc()
+    {
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (edx & (1 << 8)) != 0;
+    }
+
+    // Split so that it never overflows, however long nobody has read the clock.
+    static uint64_t convert(uint64_t delta, uint64_t mult)
+    {
+        const uint64_t mask = (uint64_t(1) << SHIFT) - 1;
+        return (delta >> SHIFT) * mult + (((delta & mask) * mult) >> SHIFT);
+    }
+
+    // Reads both clocks at the same time, as much as possible.
+    static void sample(uint64_t& w_tsc, uint64_t& w_ns)
+    {
+        const uint64_t before = __rdtsc();
+        w_ns                  = monotonic_ns();
+        const uint64_t after  = __rdtsc();
+        w_tsc                 = before + (after - before) / 2;
+    }
+
+    void publish(uint64_t base_tsc, uint64_t base_ns, double ns_per_tick)
+    {
+        m_uSeq = m_uSeq.load() + 1;
+        m_uBaseTsc     = base_tsc;
+        m_uBaseNs      = base_ns;
+        m_uMult        = uint64_t(ns_per_tick * double(uint64_t(1) << SHIFT));
+        m_uResyncTicks = uint64_t(double(RESYNC_PERIOD_NS) / ns_per_tick);
+        m_uSeq = m_uSeq.load() + 1;
+    }
+
+    void resync(uint64_t base_tsc, uint64_t base_ns, uint64_t mult)
+    {
+        uint64_t tsc, ns;
+        sample((tsc), (ns));
+        const uint64_t current = base_ns + convert(tsc - base_tsc, mult);
+        const double   rate    = double(ns - m_uRefNs) / double(tsc - m_uRefTsc);
+        m_uRefTsc = tsc;
+        m_uRefNs  = ns;
+
+        const double period = double(RESYNC_PERIOD_NS);
+        double       offset = double(int64_t(ns - current));
+        if (offset > period)
+        {
+            // Far behind (e.g. after a long stall of the counter): catch up at once.
+            publish(tsc, ns, rate);
+            return;
+        }
+        // When ahead, slow down at most to half of the rate.
+        if (offset < -period / 2)
+            offset = -period / 2;
+        publish(tsc, current, rate * (period + offset) / period);
+    }
+
+    const bool       m_bInvariant;
+    atomic<uint64_t> m_uSeq; // Odd while the parameters are being changed.
+    atomic<uint64_t> m_uBaseTsc;
+    atomic<uint64_t> m_uBaseNs;
+    atomic<uint64_t> m_uMult;
+    atomic<uint64_t> m_uResyncTicks;
+    atomic<bool>     m_bResyncing;
+
+    // The last sample of both clocks, used to measure the rate (resyncing thread only).
+    uint64_t m_uRefTsc;
+    uint64_t m_uRefNs;
+};
+
+// Constructed at the first use, as it may be needed during static initialization.
+static TscClock& tsc_clock()
+{
+    static TscClock clock;
+    return clock;
+}
+
+#endif // SRT_SYNC_CLOCK_TSC
+
 static void rdtsc(uint64_t& x)
 {
-#if SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_IA32_RDTSC
+#if SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_TSC
+    x = tsc_clock().now();
+#elif SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_IA32_RDTSC
     uint32_t lval, hval;
     // asm volatile ("push %eax; push %ebx; push %ecx; push %edx");
     // asm volatile ("xor %eax, %eax; cpuid");
@@ -99,6 +267,9 @@ static int64_t get_cpu_frequency()
         LOGC(inlog.Error, log << "IPE: QueryPerformanceFrequency failed with " << GetLastError());
     }
 
+#elif SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_TSC
+    frequency = 1000; // TscClock counts nanoseconds.
+
 #elif SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_MACH_ABSTIME
     mach_timebase_info_data_t info;
     mach_timebase_info(&info);
@@ -300,7 +471,7 @@ Condition::~Condition() {}
 void Condition::init()
 {
     pthread_condattr_t* attr = NULL;
-#if SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_GETTIME_MONOTONIC
+#if SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_GETTIME_MONOTONIC || SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_TSC
     pthread_condattr_t  CondAttribs;
     pthread_condattr_init(&CondAttribs);
     pthread_condattr_setclock(&CondAttribs, CLOCK_MONOTONIC);
@@ -324,7 +495,7 @@ void Condition::wait(UniqueLock& lock)
 bool Condition::wait_for(UniqueLock& lock, const steady_clock::duration& rel_time)
 {
     timespec timeout;
-#if SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_GETTIME_MONOTONIC
+#if SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_GETTIME_MONOTONIC || SRT_SYNC_CLOCK == SRT_SYNC_CLOCK_TSC
     clock_gettime(CLOCK_MONOTONIC, &timeout);
     const uint64_t now_us = timeout.tv_sec * uint64_t(1000000) + (timeout.tv_nsec / 1000);
 #else
@@ -567,6 +738,46 @@ CUDTException& GetThreadLocalError()
     return *curx;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// LoopClock class
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Keeps the LoopClock of the innermost scope in the current thread.
+class CLoopClockKey
+{
+public:
+    CLoopClockKey() { pthread_key_create(&m_ThreadSpecKey, NULL); }
+    ~CLoopClockKey() { pthread_key_delete(m_ThreadSpecKey); }
+
+    LoopClock* get() const { return (LoopClock*)pthread_getspecific(m_ThreadSpecKey); }
+    void set(LoopClock* clock) { pthread_setspecific(m_ThreadSpecKey, clock); }
+
+private:
+    pthread_key_t m_ThreadSpecKey;
+};
+
+static CLoopClockKey s_LoopClockKey;
+
+LoopClock::LoopClock()
+    : m_tsNow(steady_clock::now())
+    , m_pPrevious(s_LoopClockKey.get())
+{
+    s_LoopClockKey.set(this);
+}
+
+LoopClock::~LoopClock()
+{
+    s_LoopClockKey.set(m_pPrevious);
+}
+
+steady_clock::time_point loop_now()
+{
+    const LoopClock* clock = s_LoopClockKey.get();
+    return clock ? clock->now() : steady_clock::now();
+}
+
 } // namespace sync
 } // namespace srt
 
@@ -0,0 +1,298 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2026 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+#include "platform_sys.h"
+
+#include "tsbpd_sched.h"
+
+#include "core.h"
+#include "logging.h"
+#include "logger_defs.h"
+#include "threadname.h"
+
+using namespace srt_logging;
+using namespace srt::sync;
+
+namespace srt
+{
+
+CTsbPdScheduler::CTsbPdScheduler()
+    : m_iWorkers(0)
+{
+    setupMutex(m_Lock, "TsbPdSched");
+    for (int i = 0; i < MAX_WORKERS; ++i)
+    {
+        Worker& w = m_Workers[i];
+        w.sched   = this;
+        w.ntasks  = 0;
+        w.closing = false;
+        setupMutex(w.lock, "TsbPdWorker");
+        setupCond(w.cond, "TsbPdWorker");
+        setupCond(w.doneCond, "TsbPdDone");
+    }
+}
+
+CTsbPdScheduler::~CTsbPdScheduler()
+{
+    stop();
+    for (int i = 0; i < MAX_WORKERS; ++i)
+    {
+        releaseCond(m_Workers[i].cond);
+        releaseCond(m_Workers[i].doneCond);
+        releaseMutex(m_Workers[i].lock);
+    }
+    releaseMutex(m_Lock);
+}
+
+int CTsbPdScheduler::reserve(int workers)
+{
+    ScopedLock lk(m_Lock);
+    workers = std::min(workers, int(MAX_WORKERS));
+    while (m_iWorkers < workers)
+    {
+        Worker& w = m_Workers[m_iWorkers];
+        {
+            ScopedLock wl(w.lock);
+            w.closing = false;
+        }
+#if ENABLE_LOGGING
+        const std::string thname = "SRT:TsbPd:w" + Sprint(m_iWorkers + 1);
+#else
+        const std::string thname = "SRT:TsbPd";
+#endif
+        if (!StartThread(w.thread, workerThread, &w, thname))
+            break;
+        ++m_iWorkers;
+    }
+    return m_iWorkers;
+}
+
+bool CTsbPdScheduler::add(CTsbPdTask& task)
+{
+    ScopedLock lk(m_Lock);
+    if (m_iWorkers == 0)
+        return false;
+
+    int index = 0;
+    for (int i = 1; i < m_iWorkers; ++i)
+    {
+        if (m_Workers[i].ntasks < m_Workers[index].ntasks)
+            index = i;
+    }
+
+    Worker& w = m_Workers[index];
+    ScopedLock wl(w.lock);
+    ++w.ntasks;
+    task.running = false;
+    task.woken   = false;
+    task.tsWake  = steady_clock::now();
+    task.worker  = index;
+    heapPush(w, &task);
+    w.cond.notify_one();
+    return true;
+}
+
+void CTsbPdScheduler::wake(CTsbPdTask& task)
+{
+    const int index = task.worker;
+    if (index < 0)
+        return;
+
+    Worker& w = m_Workers[index];
+    ScopedLock wl(w.lock);
+    if (task.worker != index) // removed meanwhile
+        return;
+
+    if (task.running)
+    {
+        task.woken = true;
+        return;
+    }
+
+    const steady_clock::time_point now = steady_clock::now();
+    if (task.heappos == CTsbPdTask::NPOS)
+    {
+        task.tsWake = now;
+        heapPush(w, &task);
+    }
+    else if (task.tsWake > now)
+    {
+        task.tsWake = now;
+        heapUp(w, task.heappos);
+    }
+    else
+    {
+        return; // Already due.
+    }
+
+    if (task.heappos == 0)
+        w.cond.notify_one();
+}
+
+void CTsbPdScheduler::remove(CTsbPdTask& task)
+{
+    const int index = task.worker;
+    if (index < 0)
+        return;
+
+    Worker& w = m_Workers[index];
+    {
+        UniqueLock wl(w.lock);
+        task.worker = -1;
+        if (task.heappos != CTsbPdTask::NPOS)
+            heapErase(w, task.heappos);
+        while (task.running)
+            w.doneCond.wait(wl);
+    }
+
+    ScopedLock lk(m_Lock);
+    --w.ntasks;
+}
+
+void CTsbPdScheduler::stop()
+{
+    int workers;
+    {
+        ScopedLock lk(m_Lock);
+        workers = m_iWorkers;
+        for (int i = 0; i < workers; ++i)
+        {
+            ScopedLock wl(m_Workers[i].lock);
+            m_Workers[i].closing = true;
+            m_Workers[i].cond.notify_all();
+        }
+    }
+
+    for (int i = 0; i < workers; ++i)
+        m_Workers[i].thread.join();
+
+    ScopedLock lk(m_Lock);
+    m_iWorkers = 0;
+}
+
+void* CTsbPdScheduler::workerThread(void* arg)
+{
+    Worker* w = (Worker*)arg;
+    THREAD_STATE_INIT("SRT:TsbPd");
+    w->sched->workerLoop(*w);
+    THREAD_EXIT();
+    return NULL;
+}
+
+void CTsbPdScheduler::workerLoop(Worker& w)
+{
+    UniqueLock lk(w.lock);
+    while (!w.closing)
+    {
+        INCREMENT_THREAD_ITERATIONS();
+
+        if (w.heap.empty())
+        {
+            THREAD_PAUSED();
+            w.cond.wait(lk);
+            THREAD_RESUMED();
+            continue;
+        }
+
+        CTsbPdTask* task = w.heap[0];
+        if (task->tsWake > steady_clock::now())
+        {
+            THREAD_PAUSED();
+            w.cond.wait_until(lk, task->tsWake);
+            THREAD_RESUMED();
+            continue;
+        }
+
+        heapErase(w, 0);
+        task->running = true;
+        task->woken   = false;
+
+        steady_clock::time_point next;
+        {
+            InvertedLock unlocked(w.lock);
+            next = task->core->tsbpdCheckShared();
+        }
+
+        task->running = false;
+        if (task->worker >= 0)
+        {
+            if (task->woken)
+            {
+                task->tsWake = steady_clock::now();
+                heapPush(w, task);
+            }
+            else if (!is_zero(next))
+            {
+                task->tsWake = next;
+                heapPush(w, task);
+            }
+        }
+        else
+        {
+            w.doneCond.notify_all();
+        }
+    }
+}
+
+void CTsbPdScheduler::heapPush(Worker& w, CTsbPdTask* task)
+{
+    w.heap.push_back(task);
+    task->heappos = w.heap.size() - 1;
+    heapUp(w, task->heappos);
+}
+
+void CTsbPdScheduler::heapErase(Worker& w, size_t pos)
+{
+    CTsbPdTask* task = w.heap[pos];
+    task->heappos    = CTsbPdTask::NPOS;
+
+    CTsbPdTask* last = w.heap.back();
+    w.heap.pop_back();
+    if (last == task)
+        return;
+
+    heapSet(w, pos, last);
+    heapUp(w, pos);
+    heapDown(w, last->heappos);
+}
+
+void CTsbPdScheduler::heapUp(Worker& w, size_t pos)
+{
+    CTsbPdTask* task = w.heap[pos];
+    while (pos > 0)
+    {
+        const size_t parent = (pos - 1) / 2;
+        if (!(task->tsWake < w.heap[parent]->tsWake))
+            break;
+        heapSet(w, pos, w.heap[parent]);
+        pos = parent;
+    }
+    heapSet(w, pos, task);
+}
+
+void CTsbPdScheduler::heapDown(Worker& w, size_t pos)
+{
+    CTsbPdTask* task = w.heap[pos];
+    const size_t size = w.heap.size();
+    for (;;)
+    {
+        size_t child = 2 * pos + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && w.heap[child + 1]->tsWake < w.heap[child]->tsWake)
+            ++child;
+        if (!(w.heap[child]->tsWake < task->tsWake))
+            break;
+        heapSet(w, pos, w.heap[child]);
+        pos = child;
+    }
+    heapSet(w, pos, task);
+}
+
+} // namespace srt
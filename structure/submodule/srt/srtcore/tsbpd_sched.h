@@ -0,0 +1,117 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2026 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#ifndef INC_SRT_TSBPD_SCHED_H
+#define INC_SRT_TSBPD_SCHED_H
+
+#include <vector>
+
+#include "sync.h"
+#include "atomic.h"
+
+namespace srt
+{
+
+class CUDT;
+
+/// The state of a receiving socket in the shared TSBPD scheduler.
+/// It is a member of CUDT; the fields are managed by the scheduler.
+struct CTsbPdTask
+{
+    static const size_t NPOS = size_t(-1);
+
+    CUDT* core;
+    sync::atomic<int> worker;          //< index of the worker thread, -1 if not scheduled by any
+    sync::steady_clock::time_point tsWake; //< when to check the socket next time
+    size_t heappos;                    //< position in the worker's heap, NPOS if waiting for wake()
+    bool running;                      //< being checked by the worker now
+    bool woken;                        //< wake() was called while running
+
+    CTsbPdTask(CUDT* u)
+        : core(u)
+        , worker(-1)
+        , heappos(NPOS)
+        , running(false)
+        , woken(false)
+    {
+    }
+};
+
+/// Threads doing the TSBPD for the receiving sockets with SRTO_TSBPDWORKERS
+/// set, instead of a thread per socket. Every worker keeps a heap of its
+/// sockets keyed by the time when the next packet is ready to play, and
+/// calls CUDT::tsbpdCheckShared() for the sockets as they become due.
+/// Sockets waiting for a signal (new data acknowledged, data read
+/// by the application, etc.) are not in the heap until wake() is called.
+/// One scheduler is shared by all sockets and it grows up to the highest
+/// number of workers requested.
+class CTsbPdScheduler
+{
+public:
+    static const int MAX_WORKERS = 8;
+
+    CTsbPdScheduler();
+    ~CTsbPdScheduler();
+
+    /// Start more workers, if fewer than @a workers are running.
+    /// @return the number of running workers.
+    int reserve(int workers);
+
+    /// Assign the task to the least loaded worker and have it checked
+    /// as soon as possible.
+    /// @return false if no worker is running
+    bool add(CTsbPdTask& task);
+
+    /// Have the socket checked as soon as possible. Does nothing if the
+    /// task isn't added.
+    void wake(CTsbPdTask& task);
+
+    /// Remove the task and wait until the worker has finished checking it.
+    /// Must not be called with locks that CUDT::tsbpdCheckShared() takes.
+    void remove(CTsbPdTask& task);
+
+    /// Stop and join all workers. All tasks must have been removed.
+    void stop();
+
+private:
+    struct Worker
+    {
+        CTsbPdScheduler* sched;
+        sync::Mutex lock;
+        sync::Condition cond;     //< signaled when the heap top changes or the scheduler stops
+        sync::Condition doneCond; //< signaled when a task has been checked
+        std::vector<CTsbPdTask*> heap;
+        size_t ntasks;
+        bool closing;
+        sync::CThread thread;
+    };
+
+    sync::Mutex m_Lock; // protects m_iWorkers and ntasks
+    Worker m_Workers[MAX_WORKERS];
+    int m_iWorkers;
+
+    static void* workerThread(void* arg);
+    void workerLoop(Worker& w);
+
+    // Heap operations, with the worker's lock applied.
+    static void heapPush(Worker& w, CTsbPdTask* task);
+    static void heapErase(Worker& w, size_t pos);
+    static void heapUp(Worker& w, size_t pos);
+    static void heapDown(Worker& w, size_t pos);
+    static void heapSet(Worker& w, size_t pos, CTsbPdTask* task)
+    {
+        w.heap[pos] = task;
+        task->heappos = pos;
+    }
+};
+
+} // namespace srt
+
+#endif
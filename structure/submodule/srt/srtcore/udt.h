@@ -240,6 +240,8 @@ SRT_API void resetlogfa(const int* fara, size_t fara_size);
 SRT_API void setlogstream(std::ostream& stream);
 SRT_API void setloghandler(void* opaque, SRT_LOG_HANDLER_FN* handler);
 SRT_API void setlogflags(int flags);
+SRT_API void setlogsocket(SRTSOCKET u, srt_logging::LogLevel::type ll);
+SRT_API bool setlogbinfile(const char* path);
 
 SRT_API bool setstreamid(SRTSOCKET u, const std::string& sid);
 SRT_API std::string getstreamid(SRTSOCKET u);
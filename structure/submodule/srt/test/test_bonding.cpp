@@ -2,6 +2,7 @@
 #include <thread>
 #include <chrono>
 #include <vector>
+#include <map>
 #include <functional>
 
 #include "gtest/gtest.h"
@@ -9,6 +10,7 @@
 
 #include "srt.h"
 #include "netinet_any.h"
+#include "buffer_snd.h"
 
 TEST(Bonding, SRTConnectGroup)
 {
@@ -457,3 +459,479 @@ TEST(Bonding, Options)
     srt_close(grp);
 }
 
+
+// Waits until the group has nlinks members, all of them connected. A
+// member is SRT_GST_RUNNING only once it has been used for transmission,
+// so before the first message a connected one is SRT_GST_IDLE.
+static bool waitMembersReady(SRTSOCKET grp, size_t nlinks)
+{
+    std::vector<SRT_SOCKGROUPDATA> members(nlinks);
+    for (int wait = 0; wait < 500; ++wait)
+    {
+        size_t nmembers = nlinks;
+        if (srt_group_data(grp, members.data(), &nmembers) != SRT_ERROR && nmembers == nlinks)
+        {
+            size_t ready = 0;
+            for (size_t i = 0; i < nmembers; ++i)
+                ready += members[i].memberstate == SRT_GST_IDLE || members[i].memberstate == SRT_GST_RUNNING;
+            if (ready == nlinks)
+                return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+// Sends numbered messages over a broadcast group of three links to one listener
+// and checks that all of them are received, in order and with the right contents.
+// With nocopy the application's buffers are lent by srt_sendmsg2_nocopy, otherwise
+// the group stores every message once for all the links.
+static void broadcastTransmit(const std::string& passphrase, bool nocopy)
+{
+    using namespace std;
+    using namespace srt;
+
+    TestInit srtinit;
+    const int NMSG = 200, NLINKS = 3, MSGSIZE = 1316;
+    const sockaddr_any sa = CreateAddr("127.0.0.1", 4300, AF_INET);
+
+    const SRTSOCKET listener = srt_create_socket();
+    const int yes = 1;
+    EXPECT_NE(srt_setsockflag(listener, SRTO_GROUPCONNECT, &yes, sizeof yes), SRT_ERROR);
+    const SRTSOCKET grp = srt_create_group(SRT_GTYPE_BROADCAST);
+    if (!passphrase.empty())
+    {
+        EXPECT_NE(srt_setsockflag(listener, SRTO_PASSPHRASE, passphrase.c_str(), int(passphrase.size())), SRT_ERROR);
+        EXPECT_NE(srt_setsockflag(grp, SRTO_PASSPHRASE, passphrase.c_str(), int(passphrase.size())), SRT_ERROR);
+    }
+    ASSERT_NE(srt_bind(listener, sa.get(), sa.size()), SRT_ERROR);
+    ASSERT_NE(srt_listen(listener, NLINKS), SRT_ERROR);
+
+    future<SRTSOCKET> accepted = async(launch::async, [listener]() {
+        return srt_accept(listener, NULL, NULL);
+    });
+
+    for (int i = 0; i < NLINKS; ++i)
+        EXPECT_NE(srt_connect(grp, sa.get(), sa.size()), SRT_ERROR);
+    const SRTSOCKET rcvgrp = accepted.get();
+    ASSERT_NE(rcvgrp, SRT_INVALID_SOCK);
+    EXPECT_NE(rcvgrp & SRTGROUP_MASK, 0);
+
+    // Let the other links get accepted into the group.
+    ASSERT_TRUE(waitMembersReady(grp, NLINKS));
+    ASSERT_TRUE(waitMembersReady(rcvgrp, NLINKS));
+
+    struct Released
+    {
+        static void count(void* opaque, const char* buf, int)
+        {
+            ++*static_cast<atomic<int>*>(opaque);
+            delete[] buf;
+        }
+    };
+    atomic<int> released {0};
+    const int created = CSndPayload::createdCount();
+
+    thread sender([&]() {
+        for (int n = 0; n < NMSG; ++n)
+        {
+            char* buf = new char[MSGSIZE];
+            memset(buf, n & 0xFF, MSGSIZE);
+            memcpy(buf, &n, sizeof n);
+            SRT_MSGCTRL mc = srt_msgctrl_default;
+            if (nocopy)
+            {
+                EXPECT_EQ(srt_sendmsg2_nocopy(grp, buf, MSGSIZE, &mc, &Released::count, &released), MSGSIZE);
+            }
+            else
+            {
+                EXPECT_EQ(srt_sendmsg2(grp, buf, MSGSIZE, &mc), MSGSIZE);
+                delete[] buf;
+            }
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    });
+
+    int received = 0;
+    for (int n = 0; n < NMSG; ++n)
+    {
+        char buf[MSGSIZE];
+        const int rd = srt_recvmsg(rcvgrp, buf, MSGSIZE);
+        if (rd != MSGSIZE)
+        {
+            ADD_FAILURE() << "srt_recvmsg: " << srt_getlasterror_str();
+            break;
+        }
+        int seq = -1;
+        memcpy(&seq, buf, sizeof seq);
+        EXPECT_EQ(seq, n);
+        EXPECT_EQ(buf[MSGSIZE - 1], char(n & 0xFF));
+        ++received;
+    }
+    sender.join();
+    EXPECT_EQ(received, NMSG);
+
+    // A message is stored once for the links sending it unencrypted. Every encrypting
+    // link copies it into its own sender buffer, so storing it once more is not done.
+    if (nocopy || passphrase.empty())
+        EXPECT_EQ(CSndPayload::createdCount() - created, NMSG);
+    else
+        EXPECT_EQ(CSndPayload::createdCount() - created, 0);
+
+    if (nocopy)
+    {
+        // The payload is released when it's acknowledged on all the links.
+        for (int i = 0; i < 100 && released != NMSG; ++i)
+            this_thread::sleep_for(chrono::milliseconds(20));
+        EXPECT_EQ(released, NMSG);
+    }
+
+    srt_close(grp);
+    srt_close(rcvgrp);
+    srt_close(listener);
+}
+
+TEST(Bonding, BroadcastSharedPayload)
+{
+    broadcastTransmit("", false);
+}
+
+TEST(Bonding, BroadcastSharedPayloadNoCopy)
+{
+    broadcastTransmit("", true);
+}
+
+#ifdef SRT_ENABLE_ENCRYPTION
+TEST(Bonding, BroadcastSharedPayloadEncrypted)
+{
+    broadcastTransmit("longenoughpassword", false);
+}
+#endif
+
+// Sends NMSG messages over a balancing group of two links with the given
+// weights (which must differ) and reports how many were sent over each.
+static void balancingTransmit(uint16_t weight0, uint16_t weight1, int64_t (&w_sent)[2])
+{
+    using namespace std;
+    using namespace srt;
+
+    TestInit srtinit;
+    const int NMSG = 400, MSGSIZE = 1316;
+    const sockaddr_any sa = CreateAddr("127.0.0.1", 4301, AF_INET);
+
+    const SRTSOCKET listener = srt_create_socket();
+    const int yes = 1;
+    EXPECT_NE(srt_setsockflag(listener, SRTO_GROUPCONNECT, &yes, sizeof yes), SRT_ERROR);
+    ASSERT_NE(srt_bind(listener, sa.get(), sa.size()), SRT_ERROR);
+    ASSERT_NE(srt_listen(listener, 2), SRT_ERROR);
+
+    future<SRTSOCKET> accepted = async(launch::async, [listener]() {
+        return srt_accept(listener, NULL, NULL);
+    });
+
+    const SRTSOCKET grp = srt_create_group(SRT_GTYPE_BALANCING);
+    SRT_SOCKGROUPCONFIG targets[2] = {
+        srt_prepare_endpoint(NULL, sa.get(), sa.size()),
+        srt_prepare_endpoint(NULL, sa.get(), sa.size())
+    };
+    targets[0].weight = weight0;
+    targets[1].weight = weight1;
+    ASSERT_NE(srt_connect_group(grp, targets, 2), SRT_ERROR);
+
+    const SRTSOCKET rcvgrp = accepted.get();
+    ASSERT_NE(rcvgrp, SRT_INVALID_SOCK);
+    EXPECT_NE(rcvgrp & SRTGROUP_MASK, 0);
+
+    const int rcvtmo = 1000;
+    EXPECT_NE(srt_setsockflag(rcvgrp, SRTO_RCVTIMEO, &rcvtmo, sizeof rcvtmo), SRT_ERROR);
+
+    // Let the other link get accepted into the group.
+    ASSERT_TRUE(waitMembersReady(grp, 2));
+    ASSERT_TRUE(waitMembersReady(rcvgrp, 2));
+
+    thread sender([&]() {
+        for (int n = 0; n < NMSG; ++n)
+        {
+            char buf[MSGSIZE];
+            memset(buf, n & 0xFF, MSGSIZE);
+            memcpy(buf, &n, sizeof n);
+            EXPECT_EQ(srt_sendmsg(grp, buf, MSGSIZE, -1, true), MSGSIZE);
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    });
+
+    // Every message goes over one link only, but they come out in order.
+    int received = 0;
+    for (int n = 0; n < NMSG; ++n)
+    {
+        char buf[MSGSIZE];
+        const int rd = srt_recvmsg(rcvgrp, buf, MSGSIZE);
+        if (rd != MSGSIZE)
+        {
+            ADD_FAILURE() << "srt_recvmsg: " << srt_getlasterror_str();
+            break;
+        }
+        int seq = -1;
+        memcpy(&seq, buf, sizeof seq);
+        EXPECT_EQ(seq, n);
+        ++received;
+    }
+    sender.join();
+    EXPECT_EQ(received, NMSG);
+
+    SRT_SOCKGROUPDATA members[2];
+    size_t nmembers = 2;
+    ASSERT_NE(srt_group_data(grp, members, &nmembers), SRT_ERROR);
+    ASSERT_EQ(nmembers, size_t(2));
+
+    w_sent[0] = w_sent[1] = 0;
+    for (size_t i = 0; i < nmembers; ++i)
+    {
+        SRT_TRACEBSTATS stats;
+        ASSERT_NE(srt_bstats(members[i].id, &stats, 0), SRT_ERROR);
+        w_sent[members[i].weight == weight1 ? 1 : 0] = stats.pktSentUniqueTotal;
+    }
+    EXPECT_EQ(w_sent[0] + w_sent[1], NMSG);
+
+    srt_close(grp);
+    srt_close(rcvgrp);
+    srt_close(listener);
+}
+
+TEST(Bonding, BalancingWeights)
+{
+    // The second link should get three times as many messages as the first one.
+    int64_t sent[2];
+    balancingTransmit(1, 3, sent);
+    EXPECT_GT(sent[1], 2 * sent[0]);
+    EXPECT_LT(sent[1], 4 * sent[0]);
+}
+
+// With a weight set for one link only the weights can't be compared with
+// anything, so both links share by their estimated bandwidth. Both are
+// local, so none of them may be left with a negligible part.
+TEST(Bonding, BalancingMixedWeights)
+{
+    int64_t sent[2];
+    balancingTransmit(1, 0, sent);
+    EXPECT_GT(sent[0], 400 / 10);
+    EXPECT_GT(sent[1], 400 / 10);
+}
+
+// A message received over all the links of a broadcast group must be stored
+// only in one of the member receiver buffers; the copies coming in over the
+// other links are recognized as duplicates and their units are not taken.
+TEST(Bonding, BroadcastDuplicatesNotStored)
+{
+    using namespace std;
+    using namespace srt;
+
+    TestInit srtinit;
+    const int NMSG = 100, NLINKS = 3, MSGSIZE = 1316;
+    const sockaddr_any sa = CreateAddr("127.0.0.1", 4302, AF_INET);
+
+    const SRTSOCKET listener = srt_create_socket();
+    const int yes = 1;
+    EXPECT_NE(srt_setsockflag(listener, SRTO_GROUPCONNECT, &yes, sizeof yes), SRT_ERROR);
+    // Keep the messages in the receiver buffers while they are counted.
+    const int latency = 1000;
+    EXPECT_NE(srt_setsockflag(listener, SRTO_RCVLATENCY, &latency, sizeof latency), SRT_ERROR);
+    ASSERT_NE(srt_bind(listener, sa.get(), sa.size()), SRT_ERROR);
+    ASSERT_NE(srt_listen(listener, NLINKS), SRT_ERROR);
+
+    future<SRTSOCKET> accepted = async(launch::async, [listener]() {
+        return srt_accept(listener, NULL, NULL);
+    });
+
+    const SRTSOCKET grp = srt_create_group(SRT_GTYPE_BROADCAST);
+    for (int i = 0; i < NLINKS; ++i)
+        EXPECT_NE(srt_connect(grp, sa.get(), sa.size()), SRT_ERROR);
+    const SRTSOCKET rcvgrp = accepted.get();
+    ASSERT_NE(rcvgrp, SRT_INVALID_SOCK);
+
+    // Let the other links get accepted into the group.
+    ASSERT_TRUE(waitMembersReady(grp, NLINKS));
+    ASSERT_TRUE(waitMembersReady(rcvgrp, NLINKS));
+
+    for (int n = 0; n < NMSG; ++n)
+    {
+        char buf[MSGSIZE];
+        memset(buf, n & 0xFF, MSGSIZE);
+        memcpy(buf, &n, sizeof n);
+        EXPECT_EQ(srt_sendmsg(grp, buf, MSGSIZE, -1, true), MSGSIZE);
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    SRT_SOCKGROUPDATA members[NLINKS];
+    size_t nmembers = NLINKS;
+    ASSERT_NE(srt_group_data(rcvgrp, members, &nmembers), SRT_ERROR);
+    ASSERT_EQ(nmembers, size_t(NLINKS));
+
+    // Wait until the copies from all the links have come in.
+    int64_t recvd = 0, unique = 0, stored = 0;
+    for (int wait = 0; wait < 200 && recvd < NLINKS * NMSG; ++wait)
+    {
+        this_thread::sleep_for(chrono::milliseconds(10));
+        recvd = unique = stored = 0;
+        for (size_t i = 0; i < nmembers; ++i)
+        {
+            SRT_TRACEBSTATS stats;
+            ASSERT_NE(srt_bistats(members[i].id, &stats, 0, 1), SRT_ERROR);
+            recvd += stats.pktRecvTotal;
+            unique += stats.pktRecvUniqueTotal;
+            stored += stats.pktRcvBuf;
+        }
+    }
+    EXPECT_EQ(recvd, NLINKS * NMSG);
+    EXPECT_EQ(unique, NMSG);
+    EXPECT_EQ(stored, NMSG);
+
+    for (int n = 0; n < NMSG; ++n)
+    {
+        char buf[MSGSIZE];
+        const int rd = srt_recvmsg(rcvgrp, buf, MSGSIZE);
+        if (rd != MSGSIZE)
+        {
+            ADD_FAILURE() << "srt_recvmsg: " << srt_getlasterror_str();
+            break;
+        }
+        int seq = -1;
+        memcpy(&seq, buf, sizeof seq);
+        EXPECT_EQ(seq, n);
+        EXPECT_EQ(buf[MSGSIZE - 1], char(n & 0xFF));
+    }
+
+    srt_close(grp);
+    srt_close(rcvgrp);
+    srt_close(listener);
+}
+
+// The packets stored by a member link that breaks are not stored by the
+// other links. They must still be delivered, read out from the broken link.
+TEST(Bonding, BroadcastBrokenLinkDrained)
+{
+    using namespace std;
+    using namespace srt;
+
+    TestInit srtinit;
+    const int NMSG = 100, NLINKS = 3, MSGSIZE = 1316;
+    const sockaddr_any sa = CreateAddr("127.0.0.1", 4303, AF_INET);
+
+    const SRTSOCKET listener = srt_create_socket();
+    const int yes = 1;
+    EXPECT_NE(srt_setsockflag(listener, SRTO_GROUPCONNECT, &yes, sizeof yes), SRT_ERROR);
+    const int latency = 1000;
+    EXPECT_NE(srt_setsockflag(listener, SRTO_RCVLATENCY, &latency, sizeof latency), SRT_ERROR);
+    ASSERT_NE(srt_bind(listener, sa.get(), sa.size()), SRT_ERROR);
+    ASSERT_NE(srt_listen(listener, NLINKS), SRT_ERROR);
+
+    future<SRTSOCKET> accepted = async(launch::async, [listener]() {
+        return srt_accept(listener, NULL, NULL);
+    });
+
+    const SRTSOCKET grp = srt_create_group(SRT_GTYPE_BROADCAST);
+    for (int i = 0; i < NLINKS; ++i)
+        EXPECT_NE(srt_connect(grp, sa.get(), sa.size()), SRT_ERROR);
+    const SRTSOCKET rcvgrp = accepted.get();
+    ASSERT_NE(rcvgrp, SRT_INVALID_SOCK);
+    ASSERT_TRUE(waitMembersReady(grp, NLINKS));
+    ASSERT_TRUE(waitMembersReady(rcvgrp, NLINKS));
+
+    for (int n = 0; n < NMSG; ++n)
+    {
+        char buf[MSGSIZE];
+        memset(buf, n & 0xFF, MSGSIZE);
+        memcpy(buf, &n, sizeof n);
+        EXPECT_EQ(srt_sendmsg(grp, buf, MSGSIZE, -1, true), MSGSIZE);
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    // Break the links that store the packets (keeping one link at least),
+    // while the packets wait for their play time.
+    SRT_SOCKGROUPDATA rcvmembers[NLINKS];
+    size_t nrcvmembers = NLINKS;
+    ASSERT_NE(srt_group_data(rcvgrp, rcvmembers, &nrcvmembers), SRT_ERROR);
+    ASSERT_EQ(nrcvmembers, size_t(NLINKS));
+    int64_t stored = 0;
+    for (int wait = 0; wait < 200 && stored < NMSG; ++wait)
+    {
+        this_thread::sleep_for(chrono::milliseconds(10));
+        stored = 0;
+        for (size_t i = 0; i < nrcvmembers; ++i)
+        {
+            SRT_TRACEBSTATS stats;
+            ASSERT_NE(srt_bistats(rcvmembers[i].id, &stats, 0, 1), SRT_ERROR);
+            stored += stats.pktRcvBuf;
+        }
+    }
+    ASSERT_EQ(stored, NMSG);
+    vector<SRTSOCKET> holders;
+    for (size_t i = 0; i < nrcvmembers && holders.size() < size_t(NLINKS - 1); ++i)
+    {
+        SRT_TRACEBSTATS stats;
+        ASSERT_NE(srt_bistats(rcvmembers[i].id, &stats, 0, 1), SRT_ERROR);
+        if (stats.pktRcvBuf > 0)
+            holders.push_back(rcvmembers[i].id);
+    }
+    ASSERT_FALSE(holders.empty());
+
+    SRT_SOCKGROUPDATA sndmembers[NLINKS];
+    size_t nsndmembers = NLINKS;
+    ASSERT_NE(srt_group_data(grp, sndmembers, &nsndmembers), SRT_ERROR);
+    map<int, SRTSOCKET> sndports;
+    for (size_t i = 0; i < nsndmembers; ++i)
+    {
+        sockaddr_any self;
+        ASSERT_NE(srt_getsockname(sndmembers[i].id, self.get(), &self.len), SRT_ERROR);
+        sndports[self.hport()] = sndmembers[i].id;
+    }
+    for (size_t h = 0; h < holders.size(); ++h)
+    {
+        sockaddr_any peer;
+        ASSERT_NE(srt_getpeername(holders[h], peer.get(), &peer.len), SRT_ERROR);
+        ASSERT_EQ(sndports.count(peer.hport()), 1U);
+        srt_close(sndports[peer.hport()]);
+    }
+
+    size_t nbroken = 0;
+    for (int wait = 0; wait < 300 && nbroken < holders.size(); ++wait)
+    {
+        this_thread::sleep_for(chrono::milliseconds(10));
+        nbroken = 0;
+        for (size_t h = 0; h < holders.size(); ++h)
+            nbroken += srt_getsockstate(holders[h]) == SRTS_BROKEN;
+    }
+    ASSERT_EQ(nbroken, holders.size());
+
+    future<int> reading = async(launch::async, [rcvgrp]() {
+        int n = 0;
+        for (; n < NMSG; ++n)
+        {
+            char buf[MSGSIZE];
+            const int rd = srt_recvmsg(rcvgrp, buf, MSGSIZE);
+            if (rd != MSGSIZE)
+            {
+                ADD_FAILURE() << "srt_recvmsg: " << srt_getlasterror_str();
+                break;
+            }
+            int seq = -1;
+            memcpy(&seq, buf, sizeof seq);
+            EXPECT_EQ(seq, n);
+        }
+        return n;
+    });
+
+    // All packets are due within the latency. A lost one would block
+    // the reading forever, so the links are closed to interrupt it.
+    if (reading.wait_for(chrono::seconds(3)) != future_status::ready)
+    {
+        ADD_FAILURE() << "not all packets delivered in time";
+        for (size_t i = 0; i < nrcvmembers; ++i)
+            srt_close(rcvmembers[i].id);
+    }
+    EXPECT_EQ(reading.get(), NMSG);
+
+    srt_close(grp);
+    srt_close(rcvgrp);
+    srt_close(listener);
+}
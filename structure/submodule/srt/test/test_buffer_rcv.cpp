@@ -1,6 +1,7 @@
 #include <array>
 #include <numeric>
 #include "gtest/gtest.h"
+#include "test_env.h"
 #include "buffer_rcv.h"
 
 using namespace srt;
@@ -773,6 +774,58 @@ TEST_F(CRcvBufferReadMsg, TSBPDGapBeforeValid)
     EXPECT_EQ(m_unit_queue->size(), m_unit_queue->capacity());
 }
 
+// A lent unit stays out of the unit queue and off the available
+// receiver window until released.
+TEST_F(CRcvBufferReadMsg, LendAndRelease)
+{
+    const int seqno = m_init_seqno;
+    EXPECT_EQ(addMessage(1, 1, seqno), 0);
+    ackPackets(1);
+    EXPECT_EQ(getAvailBufferSize(), m_buff_size_pkts - 2);
+
+    CUnit*    unit = nullptr;
+    const int res  = m_rcv_buffer->readMessage(nullptr, 0, nullptr, &unit);
+    EXPECT_EQ(res, (int) m_payload_sz);
+    ASSERT_NE(unit, nullptr);
+    EXPECT_TRUE(verifyPayload(unit->m_Packet.m_pcData, res, seqno));
+
+    // The buffer position is free, but the lent unit is still taken.
+    EXPECT_FALSE(hasAvailablePackets());
+    EXPECT_EQ(m_rcv_buffer->countLent(), 1u);
+    EXPECT_EQ(getAvailBufferSize(), m_buff_size_pkts - 2);
+    EXPECT_EQ(m_unit_queue->size(), m_unit_queue->capacity() - 1);
+
+    EXPECT_TRUE(m_rcv_buffer->releaseLent(unit));
+    EXPECT_FALSE(m_rcv_buffer->releaseLent(unit));
+    EXPECT_EQ(getAvailBufferSize(), m_buff_size_pkts - 1);
+    EXPECT_EQ(m_unit_queue->size(), m_unit_queue->capacity());
+}
+
+// A message spanning several packets can't be lent as one view.
+TEST_F(CRcvBufferReadMsg, LendMultiPacketMessage)
+{
+    EXPECT_EQ(addMessage(2, 1, m_init_seqno), 0);
+
+    CUnit* unit = nullptr;
+    EXPECT_EQ(m_rcv_buffer->readMessage(nullptr, 0, nullptr, &unit), -1);
+    EXPECT_EQ(unit, nullptr);
+
+    // Nothing has been taken out of the buffer.
+    array<char, 2 * m_payload_sz> buff;
+    EXPECT_EQ(readMessage(buff.data(), buff.size()), int(2 * m_payload_sz));
+    EXPECT_EQ(m_unit_queue->size(), m_unit_queue->capacity());
+}
+
+// Units still lent are returned to the unit queue when the buffer is deleted.
+TEST_F(CRcvBufferReadMsg, LendAndDestroy)
+{
+    EXPECT_EQ(addMessage(1, 1, m_init_seqno), 0);
+    CUnit* unit = nullptr;
+    EXPECT_EQ(m_rcv_buffer->readMessage(nullptr, 0, nullptr, &unit), (int) m_payload_sz);
+
+    m_rcv_buffer.reset();
+    EXPECT_EQ(m_unit_queue->size(), m_unit_queue->capacity());
+}
 
 class CRcvBufferReadStream
     : public CRcvBufferReadMsg
@@ -880,3 +933,114 @@ TEST_F(CRcvBufferReadStream, ReadFractional)
 
     EXPECT_EQ(m_unit_queue->size(), m_unit_queue->capacity());
 }
+
+// Receiving by lending over a live connection.
+TEST(CRcvBufferLendApi, ReceiveAndRelease)
+{
+    srt::TestInit srtinit;
+    MAKE_UNIQUE_SOCK(listener, "listener", srt_create_socket());
+    MAKE_UNIQUE_SOCK(caller, "caller", srt_create_socket());
+
+    sockaddr_in sa = sockaddr_in();
+    sa.sin_family  = AF_INET;
+    ASSERT_EQ(inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr), 1);
+    int bind_res = -1;
+    for (int port = 5500; port <= 5600 && bind_res == -1; ++port)
+    {
+        sa.sin_port = htons(port);
+        bind_res    = srt_bind(listener, (sockaddr*)&sa, sizeof sa);
+    }
+    ASSERT_NE(bind_res, -1);
+    ASSERT_NE(srt_listen(listener, 1), -1);
+    ASSERT_NE(srt_connect(caller, (sockaddr*)&sa, sizeof sa), SRT_ERROR);
+    MAKE_UNIQUE_SOCK(accepted, "accepted", srt_accept(listener, nullptr, nullptr));
+
+    array<char, 1316> data;
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = char(i * 7);
+    ASSERT_EQ(srt_sendmsg2(caller, data.data(), (int) data.size(), nullptr), (int) data.size());
+
+    SRT_MSGVIEW view;
+    SRT_MSGCTRL mctrl = srt_msgctrl_default;
+    ASSERT_EQ(srt_recvmsg2_lend(accepted, &view, &mctrl), (int) data.size());
+    EXPECT_EQ(view.len, (int) data.size());
+    EXPECT_EQ(memcmp(view.data, data.data(), data.size()), 0);
+    EXPECT_EQ(mctrl.msgno, 1);
+
+    // A token from another socket isn't accepted.
+    EXPECT_EQ(srt_recvmsg2_release(caller, &view), SRT_ERROR);
+    EXPECT_EQ(srt_recvmsg2_release(accepted, &view), 0);
+    EXPECT_EQ(view.token, nullptr);
+    EXPECT_EQ(srt_recvmsg2_release(accepted, &view), SRT_ERROR);
+}
+
+// The entries are allocated as the packets arrive, and released
+// after they have stayed unused for a whole release period.
+TEST(CRcvBufferEntries, FollowOccupancy)
+{
+    const int buff_size_pkts = 8192;
+    const int init_seqno     = 1000;
+    CUnitQueue unit_queue(64, 1500);
+    CRcvBuffer rcv_buffer(init_seqno, buff_size_pkts, &unit_queue, true);
+    EXPECT_EQ(rcv_buffer.allocatedEntries(), 0U);
+
+    // One packet in each of three chunks, with gaps between them.
+    const int offsets[] = {0, 3000, 6000};
+    for (size_t i = 0; i < 3; ++i)
+    {
+        CUnit* unit = unit_queue.getNextAvailUnit();
+        ASSERT_NE(unit, nullptr);
+        unit->m_Packet.set_seqno(CSeqNo::incseq(init_seqno, offsets[i]));
+        unit->m_Packet.set_msgflags(PacketBoundaryBits(PB_SOLO) | MSGNO_PACKET_INORDER::wrap(1) | int32_t(i + 1));
+        unit->m_Packet.setLength(100);
+        ASSERT_EQ(rcv_buffer.insert(unit), 0);
+    }
+    const size_t used = rcv_buffer.allocatedEntries();
+    EXPECT_GT(used, 0U);
+    EXPECT_LT(used, size_t(buff_size_pkts));
+
+    // Nothing is released while the packets are there.
+    sync::steady_clock::time_point now = sync::steady_clock::now() + sync::seconds_from(2);
+    rcv_buffer.releaseUnusedEntries(now);
+    EXPECT_EQ(rcv_buffer.allocatedEntries(), used);
+
+    rcv_buffer.dropUpTo(CSeqNo::incseq(init_seqno, offsets[2] + 1));
+    EXPECT_EQ(unit_queue.size(), unit_queue.capacity());
+
+    // The emptied chunks are kept spare for one period, then freed.
+    now += sync::seconds_from(2);
+    rcv_buffer.releaseUnusedEntries(now);
+    EXPECT_EQ(rcv_buffer.allocatedEntries(), used);
+    now += sync::seconds_from(2);
+    rcv_buffer.releaseUnusedEntries(now);
+    EXPECT_EQ(rcv_buffer.allocatedEntries(), 0U);
+}
+
+// Looking for the packets over a gap doesn't allocate the entries there.
+TEST(CRcvBufferEntries, ReadingDoesNotAllocate)
+{
+    const int buff_size_pkts = 8192;
+    const int init_seqno     = 1000;
+    CUnitQueue unit_queue(64, 1500);
+    CRcvBuffer rcv_buffer(init_seqno, buff_size_pkts, &unit_queue, true);
+
+    // The first and the last packet of a message, far apart.
+    const int offsets[] = {0, 2500};
+    const PacketBoundary boundaries[] = {PB_FIRST, PB_LAST};
+    for (size_t i = 0; i < 2; ++i)
+    {
+        CUnit* unit = unit_queue.getNextAvailUnit();
+        ASSERT_NE(unit, nullptr);
+        unit->m_Packet.set_seqno(CSeqNo::incseq(init_seqno, offsets[i]));
+        unit->m_Packet.set_msgflags(PacketBoundaryBits(boundaries[i]) | MSGNO_PACKET_INORDER::wrap(1) | 1);
+        unit->m_Packet.setLength(100);
+        ASSERT_EQ(rcv_buffer.insert(unit), 0);
+    }
+    const size_t used = rcv_buffer.allocatedEntries();
+    EXPECT_EQ(used, size_t(2 * 1024));
+
+    // Dropping the last packet searches back for the rest of the message.
+    const int32_t last_seqno = CSeqNo::incseq(init_seqno, offsets[1]);
+    EXPECT_EQ(rcv_buffer.dropMessage(last_seqno, last_seqno, 1, CRcvBuffer::DROP_EXISTING), 2);
+    EXPECT_EQ(rcv_buffer.allocatedEntries(), used);
+}
@@ -0,0 +1,323 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test_env.h"
+#include "buffer_snd.h"
+#include "srt.h"
+
+using namespace srt;
+using namespace std;
+
+namespace
+{
+struct ReleaseCounter
+{
+    atomic<int> calls {0};
+    const char* data = nullptr;
+    int         len  = 0;
+
+    static void release(void* opaque, const char* data, int len)
+    {
+        ReleaseCounter* self = static_cast<ReleaseCounter*>(opaque);
+        ++self->calls;
+        self->data = data;
+        self->len  = len;
+    }
+};
+}
+
+class CSndBufferNoCopy
+    : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_buffer.reset(new CSndBuffer(AF_INET, 32, m_pktsize, 0));
+    }
+
+    void TearDown() override
+    {
+        m_buffer.reset();
+    }
+
+    void addMessage(CSndPayload& payload, int len)
+    {
+        SRT_MSGCTRL mctrl = srt_msgctrl_default;
+        mctrl.pktseq      = m_seqno;
+        m_buffer->addBuffer(payload, len, (mctrl));
+        m_seqno = mctrl.pktseq;
+    }
+
+    // Read the next packet for sending, returns its length.
+    int readNext(CPacket& w_packet, int kflags = EK_NOENC)
+    {
+        sync::steady_clock::time_point origin;
+        int                            seqnoinc = 0;
+        return m_buffer->readData((w_packet), (origin), kflags, (seqnoinc));
+    }
+
+    const int              m_pktsize = 1456;
+    int32_t                m_seqno   = 1000;
+    unique_ptr<CSndBuffer> m_buffer;
+};
+
+// The payload is referred to, not copied, and released
+// only when the last of its packets has been acknowledged.
+TEST_F(CSndBufferNoCopy, ReleaseOnAck)
+{
+    vector<char> data(m_pktsize * 3, 'a');
+    ReleaseCounter rc;
+
+    CSndPayload* payload = CSndPayload::create(data.data(), (int) data.size(), &ReleaseCounter::release, &rc);
+    addMessage(*payload, (int) data.size());
+    payload->release(); // the reference held by the submitting call
+    EXPECT_EQ(rc.calls, 0);
+    EXPECT_EQ(m_buffer->getCurrBufSize(), 3);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        CPacket pkt;
+        EXPECT_EQ(readNext(pkt), m_pktsize);
+        EXPECT_EQ(pkt.m_pcData, data.data() + i * m_pktsize);
+    }
+
+    m_buffer->ackData(2);
+    EXPECT_EQ(rc.calls, 0);
+    m_buffer->ackData(1);
+    EXPECT_EQ(rc.calls, 1);
+    EXPECT_EQ(rc.data, data.data());
+    EXPECT_EQ(rc.len, (int) data.size());
+}
+
+// The payload still in the buffer gets released when the buffer is deleted.
+TEST_F(CSndBufferNoCopy, ReleaseOnDestroy)
+{
+    array<char, 100> data;
+    data.fill('b');
+    ReleaseCounter rc;
+
+    CSndPayload* payload = CSndPayload::create(data.data(), (int) data.size(), &ReleaseCounter::release, &rc);
+    addMessage(*payload, (int) data.size());
+    payload->release();
+
+    m_buffer.reset();
+    EXPECT_EQ(rc.calls, 1);
+}
+
+// Encryption is done in place, so with a key set the payload is copied
+// into the buffer's storage at the first read and released immediately.
+TEST_F(CSndBufferNoCopy, CopyWhenEncrypted)
+{
+    array<char, 100> data;
+    data.fill('c');
+    ReleaseCounter rc;
+
+    CSndPayload* payload = CSndPayload::create(data.data(), (int) data.size(), &ReleaseCounter::release, &rc);
+    addMessage(*payload, (int) data.size());
+    payload->release();
+
+    CPacket pkt;
+    EXPECT_EQ(readNext(pkt, EK_EVEN), (int) data.size());
+    EXPECT_NE(pkt.m_pcData, data.data());
+    EXPECT_EQ(memcmp(pkt.m_pcData, data.data(), data.size()), 0);
+    EXPECT_EQ(rc.calls, 1);
+
+    m_buffer->ackData(1);
+    EXPECT_EQ(rc.calls, 1);
+}
+
+// Transmission over a connection, with the release function
+// called once the message is acknowledged by the peer.
+TEST(CSndBufferNoCopyApi, SendAndRelease)
+{
+    srt::TestInit srtinit;
+    MAKE_UNIQUE_SOCK(listener, "listener", srt_create_socket());
+    MAKE_UNIQUE_SOCK(caller, "caller", srt_create_socket());
+
+    sockaddr_in sa = sockaddr_in();
+    sa.sin_family  = AF_INET;
+    ASSERT_EQ(inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr), 1);
+    int bind_res = -1;
+    for (int port = 5400; port <= 5500 && bind_res == -1; ++port)
+    {
+        sa.sin_port = htons(port);
+        bind_res    = srt_bind(listener, (sockaddr*)&sa, sizeof sa);
+    }
+    ASSERT_NE(bind_res, -1);
+    ASSERT_NE(srt_listen(listener, 1), -1);
+    ASSERT_NE(srt_connect(caller, (sockaddr*)&sa, sizeof sa), SRT_ERROR);
+    MAKE_UNIQUE_SOCK(accepted, "accepted", srt_accept(listener, nullptr, nullptr));
+
+    array<char, 1316> data;
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = char(i);
+    ReleaseCounter rc;
+
+    EXPECT_EQ(srt_sendmsg2_nocopy(caller, data.data(), (int) data.size(), nullptr, &ReleaseCounter::release, &rc),
+              (int) data.size());
+
+    array<char, 1500> rcvbuf;
+    EXPECT_EQ(srt_recvmsg(accepted, rcvbuf.data(), (int) rcvbuf.size()), (int) data.size());
+    EXPECT_EQ(memcmp(rcvbuf.data(), data.data(), data.size()), 0);
+
+    // The ACK comes within the ACK period (10ms).
+    for (int i = 0; i < 100 && rc.calls.load() == 0; ++i)
+        this_thread::sleep_for(chrono::milliseconds(10));
+    EXPECT_EQ(rc.calls.load(), 1);
+
+    // On error the release function is called before returning.
+    ReleaseCounter rcerr;
+    EXPECT_EQ(srt_sendmsg2_nocopy(SRT_INVALID_SOCK, data.data(), (int) data.size(), nullptr,
+                                  &ReleaseCounter::release, &rcerr),
+              SRT_ERROR);
+    EXPECT_EQ(rcerr.calls.load(), 1);
+}
+
+// Benchmark: the sender buffer cycle (add, read for sending, acknowledge)
+// with copying vs. referring to the payload, for the default live payload
+// size and the maximum one. Run with --gtest_also_run_disabled_tests.
+TEST_F(CSndBufferNoCopy, DISABLED_Throughput)
+{
+    const int sizes[] = {1316, 1456};
+    const int NMSGS   = 2000000;
+    const int BATCH   = 16;
+    // Payloads come from a pool larger than the CPU caches,
+    // as they would from the application's frame buffers.
+    const int POOL = 8192;
+
+    for (size_t s = 0; s < sizeof sizes / sizeof sizes[0]; ++s)
+    {
+        vector<char> data(size_t(sizes[s]) * POOL, 'x');
+        for (int nocopy = 0; nocopy < 2; ++nocopy)
+        {
+            ReleaseCounter rc;
+            const auto     start = chrono::steady_clock::now();
+            for (int n = 0; n < NMSGS; n += BATCH)
+            {
+                for (int i = 0; i < BATCH; ++i)
+                {
+                    const char* msg = data.data() + size_t((n + i) % POOL) * sizes[s];
+                    if (nocopy)
+                    {
+                        CSndPayload* payload = CSndPayload::create(msg, sizes[s], &ReleaseCounter::release, &rc);
+                        addMessage(*payload, sizes[s]);
+                        payload->release();
+                    }
+                    else
+                    {
+                        SRT_MSGCTRL mctrl = srt_msgctrl_default;
+                        mctrl.pktseq      = m_seqno;
+                        m_buffer->addBuffer(msg, sizes[s], (mctrl));
+                        m_seqno = mctrl.pktseq;
+                    }
+                }
+                for (int i = 0; i < BATCH; ++i)
+                {
+                    CPacket pkt;
+                    readNext(pkt);
+                }
+                m_buffer->ackData(BATCH);
+            }
+            const double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cerr << sizes[s] << " bytes, " << (nocopy ? "srt_sendmsg2_nocopy" : "srt_sendmsg2") << " path: "
+                 << (NMSGS / secs / 1e6) << " Mmsg/s, " << (double(NMSGS) * sizes[s] * 8 / secs / 1e9) << " Gbit/s\n";
+            EXPECT_EQ(rc.calls.load(), nocopy ? NMSGS : 0);
+        }
+    }
+}
+
+namespace
+{
+void addMessages(CSndBuffer& buffer, int32_t& w_seqno, int nmsgs)
+{
+    const char data[100] = {};
+    for (int i = 0; i < nmsgs; ++i)
+    {
+        SRT_MSGCTRL mctrl = srt_msgctrl_default;
+        mctrl.pktseq      = w_seqno;
+        buffer.addBuffer(data, (int) sizeof data, (mctrl));
+        w_seqno = mctrl.pktseq;
+    }
+}
+
+void readAll(CSndBuffer& buffer)
+{
+    for (;;)
+    {
+        CPacket                        pkt;
+        sync::steady_clock::time_point origin;
+        int                            seqnoinc = 0;
+        if (buffer.readData((pkt), (origin), EK_NOENC, (seqnoinc)) <= 0)
+            break;
+    }
+}
+}
+
+// Packets to retransmit are found by their offset from the first unacknowledged
+// one, also when the buffer has grown while the first block is in the middle of the ring.
+TEST(CSndBufferRexmit, ReadAtOffsetAfterGrow)
+{
+    CSndBuffer buffer(AF_INET, 8, 1456, 0);
+    int32_t    seqno = CSeqNo::m_iMaxSeqNo - 10;
+    const int32_t first = seqno;
+
+    addMessages(buffer, seqno, 5);
+    readAll(buffer);
+    buffer.ackData(3);
+
+    addMessages(buffer, seqno, 40);
+    readAll(buffer);
+    ASSERT_EQ(buffer.getCurrBufSize(), 42);
+
+    for (int offset = 0; offset < 42; ++offset)
+    {
+        CPacket pkt;
+        pkt.set_seqno(CSeqNo::incseq(first, 3 + offset));
+        sync::steady_clock::time_point origin;
+        CSndBuffer::DropRange          drop;
+        EXPECT_EQ(buffer.readData(offset, (pkt), (origin), (drop)), 100);
+        EXPECT_EQ(buffer.getMsgNoAt(offset), 4 + offset);
+        EXPECT_NE(buffer.getPacketRexmitTime(offset), sync::steady_clock::time_point());
+    }
+
+    CPacket                        pkt;
+    sync::steady_clock::time_point origin;
+    CSndBuffer::DropRange          drop;
+    EXPECT_EQ(buffer.readData(42, (pkt), (origin), (drop)), int(CSndBuffer::READ_NONE));
+    EXPECT_EQ(buffer.getMsgNoAt(42), SRT_MSGNO_CONTROL);
+}
+
+// Benchmark: retransmission lookups with 100k packets in flight,
+// as in file mode over a long fat network.
+// Run with --gtest_also_run_disabled_tests.
+TEST(CSndBufferRexmit, DISABLED_LookupLargeWindow)
+{
+    const int  NPKTS    = 100000;
+    const int  NLOOKUPS = 1000000;
+    CSndBuffer buffer(AF_INET, 8192, 1456, 0);
+    int32_t    seqno = 0;
+    addMessages(buffer, seqno, NPKTS);
+    readAll(buffer);
+
+    uint32_t   rnd = 1;
+    int64_t    sum = 0;
+    const auto start = chrono::steady_clock::now();
+    for (int i = 0; i < NLOOKUPS; ++i)
+    {
+        rnd = rnd * 1103515245 + 12345;
+        const int offset = int((rnd >> 8) % NPKTS);
+
+        CPacket pkt;
+        pkt.set_seqno(offset);
+        sync::steady_clock::time_point origin;
+        CSndBuffer::DropRange          drop;
+        sum += buffer.readData(offset, (pkt), (origin), (drop));
+    }
+    const double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cerr << NPKTS << " packets in flight: " << (NLOOKUPS / secs / 1e6) << " M retransmission lookups/s\n";
+    EXPECT_EQ(sum, int64_t(NLOOKUPS) * 100);
+}
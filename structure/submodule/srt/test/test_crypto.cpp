@@ -108,3 +108,673 @@ namespace srt
 } // namespace srt
 
 #endif //SRT_ENABLE_ENCRYPTION && ENABLE_AEAD_API_PREVIEW
+
+#if defined(SRT_ENABLE_ENCRYPTION)
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <future>
+#include <thread>
+#include "hcrypt.h"
+#include "crypto.h"
+#include "socketconfig.h"
+#include "api.h"
+#include "test_env.h"
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace srt
+{
+
+    // Encryption of data packets through the HaiCrypt API, AES-CTR.
+    class CryptoBatch
+        : public ::testing::Test
+    {
+    protected:
+        CryptoBatch()
+            : m_tx(NULL)
+            , m_rx(NULL)
+        {
+        }
+
+        void SetUp() override
+        {
+            HaiCrypt_Cfg cfg;
+            memset(&cfg, 0, sizeof(cfg));
+            cfg.flags = HAICRYPT_CFG_F_CRYPTO | HAICRYPT_CFG_F_TX;
+            cfg.xport = HAICRYPT_XPT_SRT;
+            cfg.cryspr = HaiCryptCryspr_Get_Instance();
+            cfg.key_len = 16;
+            cfg.data_max_len = HAICRYPT_DEF_DATA_MAX_LENGTH;
+            cfg.km_refresh_rate_pkt = HAICRYPT_DEF_KM_REFRESH_RATE;
+            cfg.km_pre_announce_pkt = HAICRYPT_DEF_KM_PRE_ANNOUNCE;
+            cfg.secret.typ = HAICRYPT_SECTYP_PASSPHRASE;
+            cfg.secret.len = m_pwd.size();
+            memcpy(cfg.secret.str, m_pwd.c_str(), m_pwd.size());
+            ASSERT_EQ(HaiCrypt_Create(&cfg, &m_tx), HAICRYPT_OK);
+
+            cfg.flags = HAICRYPT_CFG_F_CRYPTO;
+            ASSERT_EQ(HaiCrypt_Create(&cfg, &m_rx), HAICRYPT_OK);
+
+            // Pass the keying material to the receiver.
+            void* km[2];
+            size_t km_len[2];
+            const int nkm = HaiCrypt_Tx_ManageKeys(m_tx, km, km_len, 2);
+            ASSERT_GT(nkm, 0);
+            for (int i = 0; i < nkm; ++i)
+                ASSERT_GE(HaiCrypt_Rx_Process(m_rx, (unsigned char*)km[i], km_len[i], NULL, NULL, 0), 0);
+        }
+
+        void TearDown() override
+        {
+            if (m_tx)
+                HaiCrypt_Close(m_tx);
+            if (m_rx)
+                HaiCrypt_Close(m_rx);
+        }
+
+        struct Pkt
+        {
+            unsigned char pfx[16];
+            std::vector<unsigned char> data;
+        };
+
+        Pkt makePacket(int32_t seqno, size_t len)
+        {
+            Pkt p;
+            const uint32_t pki = seqno;
+            const uint32_t msgno = uint32_t(HaiCrypt_Tx_GetKeyFlags(m_tx)) << 27;
+            memset(p.pfx, 0, sizeof(p.pfx));
+            memcpy(p.pfx, &pki, sizeof(pki));
+            memcpy(p.pfx + 4, &msgno, sizeof(msgno));
+            p.data.resize(len);
+            for (size_t i = 0; i < len; ++i)
+                p.data[i] = (unsigned char)(seqno * 7 + i);
+            return p;
+        }
+
+    protected:
+        HaiCrypt_Handle m_tx;
+        HaiCrypt_Handle m_rx;
+        const std::string m_pwd = "abcdefghijk";
+    };
+
+    // Packets encrypted with the precomputed keystream are the same
+    // as encrypted one by one, and decrypt back in any order.
+    TEST_F(CryptoBatch, KeystreamMatchesSinglePacket)
+    {
+        const uint32_t base = 0x7FFFFFF0; // wraps around the sequence numbers
+        const size_t lengths[] = { 1316, 1316, 188, 1456, 1316, 1, 17, 1456 };
+        std::vector<Pkt> clear, cipher;
+
+        for (int i = 0; i < 64; ++i)
+        {
+            const int32_t seqno = int32_t((base + i) & 0x7FFFFFFF);
+            clear.push_back(makePacket(seqno, lengths[i % 8]));
+            Pkt p = clear.back();
+            ASSERT_EQ(HaiCrypt_Tx_Data(m_tx, p.pfx, p.data.data(), p.data.size()), 0);
+            if (p.data.size() >= 16)
+            {
+                EXPECT_NE(p.data, clear.back().data);
+            }
+            cipher.push_back(p);
+        }
+
+        // Packets behind the keystream window, like retransmissions,
+        // take the per-packet path, and must encrypt the same.
+        for (int i = 0; i < 32; ++i)
+        {
+            Pkt p = clear[i];
+            ASSERT_EQ(HaiCrypt_Tx_Data(m_tx, p.pfx, p.data.data(), p.data.size()), 0);
+            EXPECT_EQ(p.data, cipher[i].data) << "packet " << i;
+        }
+
+        // Decrypt with a loss, reordering and a retransmission.
+        const int order[] = { 0, 1, 2, 4, 3, 5, 30, 31, 6, 7, 40, 41, 42, 8, 43, 63 };
+        for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); ++i)
+        {
+            Pkt p = cipher[order[i]];
+            ASSERT_EQ(HaiCrypt_Rx_Data(m_rx, p.pfx, p.data.data(), p.data.size()), int(p.data.size()));
+            EXPECT_EQ(p.data, clear[order[i]].data) << "packet " << order[i];
+        }
+    }
+
+    TEST_F(CryptoBatch, Batch)
+    {
+        const int NPKT = 40;
+        std::vector<Pkt> clear, pkts;
+        std::vector<unsigned char*> pfx(NPKT), data(NPKT);
+        std::vector<size_t> len(NPKT);
+
+        for (int i = 0; i < NPKT; ++i)
+        {
+            clear.push_back(makePacket(1000 + i, i % 5 ? 1316 : 500));
+            pkts.push_back(clear.back());
+        }
+        for (int i = 0; i < NPKT; ++i)
+        {
+            pfx[i] = pkts[i].pfx;
+            data[i] = pkts[i].data.data();
+            len[i] = pkts[i].data.size();
+        }
+
+        ASSERT_GT(HaiCrypt_Tx_SyncAhead(m_tx), 0);
+        EXPECT_EQ(HaiCrypt_Tx_DataAhead(m_tx, pfx.data(), data.data(), len.data(), NPKT), NPKT);
+
+        // Same as encrypted one by one in another order.
+        for (int i = NPKT - 1; i >= 0; --i)
+        {
+            Pkt p = clear[i];
+            ASSERT_EQ(HaiCrypt_Tx_Data(m_tx, p.pfx, p.data.data(), p.data.size()), 0);
+            EXPECT_EQ(p.data, pkts[i].data) << "packet " << i;
+        }
+
+        for (int i = 0; i < NPKT; ++i)
+        {
+            EXPECT_EQ(len[i], clear[i].data.size());
+            ASSERT_EQ(HaiCrypt_Rx_Data(m_rx, pfx[i], data[i], len[i]), int(len[i]));
+            EXPECT_EQ(pkts[i].data, clear[i].data) << "packet " << i;
+        }
+    }
+
+    // Throughput of the sender's per-packet work with and without
+    // encryption: copying the payload into the packet (clear), plus
+    // encrypting it one by one or in batches, and decrypting.
+    TEST_F(CryptoBatch, DISABLED_EncryptedVsClearThroughput)
+    {
+        using namespace std;
+        const int NPKTS = 2000000;
+        const int BATCH = 16;
+        const size_t LEN = 1316;
+
+        vector<unsigned char> source(LEN, 'x');
+        vector<Pkt> ring;
+        for (int i = 0; i < BATCH; ++i)
+            ring.push_back(makePacket(i, LEN));
+
+        unsigned char* pfx[BATCH];
+        unsigned char* data[BATCH];
+        size_t len[BATCH];
+
+        ASSERT_GT(HaiCrypt_Tx_SyncAhead(m_tx), 0);
+
+        double rate[4];
+        const char* names[4] = { "clear", "encrypt", "encrypt batch", "decrypt" };
+        for (int mode = 0; mode < 4; ++mode)
+        {
+            const auto start = chrono::steady_clock::now();
+            for (int n = 0; n < NPKTS; n += BATCH)
+            {
+                for (int i = 0; i < BATCH; ++i)
+                {
+                    Pkt& p = ring[i];
+                    const uint32_t pki = mode * NPKTS + n + i;
+                    memcpy(p.pfx, &pki, sizeof(pki));
+                    memcpy(p.data.data(), source.data(), LEN);
+                    pfx[i] = p.pfx;
+                    data[i] = p.data.data();
+                    len[i] = LEN;
+                    if (mode == 1)
+                        HaiCrypt_Tx_Data(m_tx, p.pfx, p.data.data(), LEN);
+                    else if (mode == 3)
+                        HaiCrypt_Rx_Data(m_rx, p.pfx, p.data.data(), LEN);
+                }
+                if (mode == 2)
+                    HaiCrypt_Tx_DataAhead(m_tx, pfx, data, len, BATCH);
+            }
+            const double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            rate[mode] = NPKTS / secs;
+            cerr << names[mode] << ": " << (rate[mode] / 1e6) << " Mpkt/s, "
+                << (rate[mode] * LEN * 8 / 1e9) << " Gbps\n";
+        }
+        cerr << "encrypted/clear: " << (rate[1] / rate[0]) << "\n";
+    }
+
+    // Encryption ahead of sending by the crypto worker pool (SRTO_CRYPTOWORKERS).
+    class CryptoAhead
+        : public ::testing::Test
+    {
+    protected:
+        CryptoAhead()
+            : m_crypt(0)
+        {
+        }
+
+        void SetUp() override
+        {
+            CSrtConfig cfg;
+            cfg.CryptoSecret.typ = HAICRYPT_SECTYP_PASSPHRASE;
+            cfg.CryptoSecret.len = m_pwd.size();
+            memcpy(cfg.CryptoSecret.str, m_pwd.c_str(), m_pwd.size());
+            m_crypt.setCryptoSecret(cfg.CryptoSecret);
+            m_crypt.setCryptoKeylen(16);
+
+            // Switch the keys often.
+            cfg.iCryptoMode = CSrtConfig::CIPHER_MODE_AES_CTR;
+            cfg.uKmRefreshRatePkt = 128;
+            cfg.uKmPreAnnouncePkt = 16;
+
+            // Bidirectional, so that the keys get to the receiver context too.
+            ASSERT_TRUE(m_crypt.init(HSD_INITIATOR, cfg, true));
+            m_crypt.m_RcvKmState = SRT_KM_S_SECURED;
+            m_crypt.enableAhead(&m_pool, 2, LEN);
+        }
+
+        void TearDown() override
+        {
+            m_crypt.close();
+            m_pool.stop();
+        }
+
+        static std::vector<char> pattern(int32_t seqno, char salt)
+        {
+            std::vector<char> data(LEN);
+            for (size_t i = 0; i < LEN; ++i)
+                data[i] = char(seqno * 3 + i + salt);
+            return data;
+        }
+
+        // Submits the plaintext for encryption ahead and makes sure
+        // it's encrypted, even if no worker got to it yet.
+        void submit(int32_t seqno, const std::vector<char>& data)
+        {
+            const int slot = seqno % CCryptoControl::AHEAD_SLOTS;
+            m_crypt.submitAhead(seqno, data.data(), data.size());
+            m_crypt.encryptAhead(&slot, 1);
+        }
+
+        // Encrypts the packet the way the sender does, then decrypts it.
+        std::vector<char> sendAndReceive(int32_t seqno, const std::vector<char>& data)
+        {
+            CPacket pkt;
+            pkt.allocate(data.size());
+            pkt.set_seqno(seqno);
+            pkt.set_msgflags(1 | PacketBoundaryBits(PB_SOLO) | MSGNO_ENCKEYSPEC::wrap(m_crypt.getSndCryptoFlags()));
+            memcpy(pkt.data(), data.data(), data.size());
+            pkt.setLength(data.size());
+
+            EXPECT_EQ(m_crypt.encrypt(pkt), ENCS_CLEAR);
+            m_crypt.regenCryptoKm(NULL, true);
+            EXPECT_EQ(m_crypt.decrypt(pkt), ENCS_CLEAR);
+            return std::vector<char>(pkt.data(), pkt.data() + pkt.getLength());
+        }
+
+    protected:
+        static const size_t LEN = 1316;
+        CCryptoWorkerPool m_pool;
+        CCryptoControl m_crypt;
+        const std::string m_pwd = "abcdefghijk";
+    };
+
+    // The sender transmits the ciphertext prepared by a worker, without
+    // encrypting the packet again (here a different payload is given to
+    // the sender to tell the two apart).
+    TEST_F(CryptoAhead, SendsCiphertextPreparedAhead)
+    {
+        const std::vector<char> ahead = pattern(5, 0);
+        submit(5, ahead);
+        EXPECT_EQ(sendAndReceive(5, pattern(5, 1)), ahead);
+
+        // The slot has been taken, so the packet is encrypted when sending.
+        EXPECT_EQ(sendAndReceive(5, pattern(5, 1)), pattern(5, 1));
+
+        // A packet from the previous round over the slots isn't taken.
+        submit(6 + CCryptoControl::AHEAD_SLOTS, ahead);
+        EXPECT_EQ(sendAndReceive(6, pattern(6, 1)), pattern(6, 1));
+    }
+
+    // A batch of slots encrypted at once is sent as encrypted ahead,
+    // except for the packet already sent when the batch was submitted.
+    TEST_F(CryptoAhead, EncryptsBatch)
+    {
+        ASSERT_EQ(sendAndReceive(100, pattern(100, 1)), pattern(100, 1));
+
+        int slots[CCryptoWorkerPool::MAX_BATCH];
+        for (int i = 0; i < CCryptoWorkerPool::MAX_BATCH; ++i)
+        {
+            const int32_t seqno = 100 + i;
+            slots[i] = seqno % CCryptoControl::AHEAD_SLOTS;
+            m_crypt.submitAhead(seqno, pattern(seqno, 0).data(), LEN);
+        }
+        m_crypt.encryptAhead(slots, CCryptoWorkerPool::MAX_BATCH);
+
+        for (int32_t seqno = 101; seqno < 100 + CCryptoWorkerPool::MAX_BATCH; ++seqno)
+            EXPECT_EQ(sendAndReceive(seqno, pattern(seqno, 1)), pattern(seqno, 0)) << "seqno=" << seqno;
+    }
+
+    // Packets encrypted ahead with a key that is no longer the current
+    // one when the packet is sent are encrypted again.
+    TEST_F(CryptoAhead, KeySwitch)
+    {
+        const int32_t LEAD = 20;
+        int taken = 0;
+        for (int32_t seqno = 0; seqno < 1000; ++seqno)
+        {
+            if (seqno % LEAD == 0)
+            {
+                for (int32_t i = seqno; i < seqno + LEAD; ++i)
+                    submit(i, pattern(i, 0));
+            }
+
+            const std::vector<char> received = sendAndReceive(seqno, pattern(seqno, 1));
+            if (received == pattern(seqno, 0))
+                ++taken;
+            else
+                ASSERT_EQ(received, pattern(seqno, 1)) << "seqno=" << seqno;
+        }
+
+        // Many of them are sent as encrypted ahead, but not those
+        // encrypted before a new key was generated.
+        EXPECT_GT(taken, 300);
+        EXPECT_LT(taken, 1000);
+    }
+
+    // Only the packets sent count for the key refresh. A batch encrypted
+    // ahead must not move the key usage counter past the announcement of
+    // the next key, which would switch to a key that the peer doesn't have.
+    TEST_F(CryptoAhead, RefreshCountsSentPackets)
+    {
+        int32_t seqno = 0;
+        for (; seqno < 100; ++seqno)
+            ASSERT_EQ(sendAndReceive(seqno, pattern(seqno, 1)), pattern(seqno, 1));
+
+        const int kflags = m_crypt.getSndCryptoFlags();
+        for (int32_t i = seqno; i < seqno + CCryptoControl::AHEAD_SLOTS; ++i)
+            submit(i, pattern(i, 0));
+        m_crypt.regenCryptoKm(NULL, true);
+        EXPECT_EQ(m_crypt.getSndCryptoFlags(), kflags);
+
+        int taken = 0;
+        for (int32_t i = 0; i < CCryptoControl::AHEAD_SLOTS; ++i, ++seqno)
+        {
+            const std::vector<char> received = sendAndReceive(seqno, pattern(seqno, 1));
+            if (received == pattern(seqno, 0))
+                ++taken;
+            else
+                ASSERT_EQ(received, pattern(seqno, 1)) << "seqno=" << seqno;
+        }
+
+        // Those sent before the next key was announced went as encrypted ahead.
+        EXPECT_GT(taken, 0);
+        EXPECT_LT(taken, int(CCryptoControl::AHEAD_SLOTS));
+        EXPECT_NE(m_crypt.getSndCryptoFlags(), kflags);
+    }
+
+    // Live transmission with the sender encrypting ahead and frequent key switches.
+    TEST(CryptoAheadLive, Connection)
+    {
+        srt::TestInit srtinit;
+
+        SRTSOCKET s = srt_create_socket();
+        SRTSOCKET l = srt_create_socket();
+
+        sockaddr_in sa;
+        memset(&sa, 0, sizeof sa);
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(5555);
+        ASSERT_EQ(inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr), 1);
+
+        const std::string pwd = "abcdefghijk";
+        const int workers = 2, refresh = 1024, preannounce = 128;
+        ASSERT_NE(srt_setsockflag(s, SRTO_PASSPHRASE, pwd.c_str(), pwd.size()), SRT_ERROR);
+        ASSERT_NE(srt_setsockflag(l, SRTO_PASSPHRASE, pwd.c_str(), pwd.size()), SRT_ERROR);
+        ASSERT_NE(srt_setsockflag(s, SRTO_CRYPTOWORKERS, &workers, sizeof workers), SRT_ERROR);
+        ASSERT_NE(srt_setsockflag(s, SRTO_KMPREANNOUNCE, &preannounce, sizeof preannounce), SRT_ERROR);
+        ASSERT_NE(srt_setsockflag(s, SRTO_KMREFRESHRATE, &refresh, sizeof refresh), SRT_ERROR);
+
+        ASSERT_NE(srt_bind(l, (sockaddr*)& sa, sizeof(sa)), SRT_ERROR);
+        ASSERT_NE(srt_listen(l, 1), SRT_ERROR);
+
+        auto connect_res = std::async(std::launch::async, [&s, &sa]() {
+            return srt_connect(s, (sockaddr*)& sa, sizeof(sa));
+            });
+
+        SRTSOCKET a = srt_accept(l, NULL, NULL);
+        ASSERT_NE(a, SRT_INVALID_SOCK);
+        ASSERT_EQ(connect_res.get(), SRT_SUCCESS);
+
+        const int timeout_ms = 1000;
+        srt_setsockflag(a, SRTO_RCVTIMEO, &timeout_ms, sizeof timeout_ms);
+
+        const int NMSG = 5000;
+        auto receive_res = std::async(std::launch::async, [a]() {
+            char buf[1316];
+            int rcvd = 0;
+            for (; rcvd < NMSG; ++rcvd)
+            {
+                if (srt_recvmsg(a, buf, sizeof buf) != int(sizeof buf))
+                    break;
+                for (size_t i = 0; i < sizeof buf; ++i)
+                {
+                    if (buf[i] != char(rcvd + i))
+                        return -rcvd - 1;
+                }
+            }
+            return rcvd;
+            });
+
+        char buf[1316];
+        for (int n = 0; n < NMSG; ++n)
+        {
+            for (size_t i = 0; i < sizeof buf; ++i)
+                buf[i] = char(n + i);
+            ASSERT_EQ(srt_sendmsg(s, buf, sizeof buf, -1, true), int(sizeof buf));
+            if (n % 64 == 63)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        EXPECT_EQ(receive_res.get(), NMSG);
+
+        int workers_set = 0, optlen = sizeof workers_set;
+        EXPECT_NE(srt_getsockflag(s, SRTO_CRYPTOWORKERS, &workers_set, &optlen), SRT_ERROR);
+        EXPECT_EQ(workers_set, workers);
+
+        srt_close(a);
+        srt_close(s);
+        srt_close(l);
+    }
+
+    // Derived keys are taken from the cache and the least recently used are dropped.
+    TEST(KekCache, Derive)
+    {
+        CKekCache cache;
+        const std::string pwd = "abcdefghijk";
+        const int itr = HAICRYPT_PBKDF2_ITER_CNT;
+        const size_t klen = 16;
+
+        unsigned char salt[HAICRYPT_PBKDF2_SALT_LEN] = {1, 2, 3, 4, 5, 6, 7, 8};
+        unsigned char expected[HAICRYPT_KEY_MAX_SZ], kek[HAICRYPT_KEY_MAX_SZ];
+        CRYSPR_methods* cryspr = (CRYSPR_methods*)HaiCryptCryspr_Get_Instance();
+        ASSERT_EQ(cryspr->km_pbkdf2(NULL, (char*)pwd.data(), pwd.size(), salt, sizeof salt, itr, klen, expected), 0);
+        cache.acquire(pwd.data(), pwd.size());
+
+        ASSERT_EQ(cache.derive(pwd.data(), pwd.size(), salt, sizeof salt, itr, klen, kek), 0);
+        EXPECT_EQ(memcmp(kek, expected, klen), 0);
+        memset(kek, 0, sizeof kek);
+        ASSERT_EQ(cache.derive(pwd.data(), pwd.size(), salt, sizeof salt, itr, klen, kek), 0);
+        EXPECT_EQ(memcmp(kek, expected, klen), 0);
+        EXPECT_EQ(cache.stats().hits, 1u);
+        EXPECT_EQ(cache.stats().misses, 1u);
+
+        // Different passphrase or key length isn't taken from the cache.
+        ASSERT_EQ(cache.derive("abcdefghijl", pwd.size(), salt, sizeof salt, itr, klen, kek), 0);
+        EXPECT_NE(memcmp(kek, expected, klen), 0);
+        ASSERT_EQ(cache.derive(pwd.data(), pwd.size(), salt, sizeof salt, itr, 24, kek), 0);
+        EXPECT_EQ(cache.stats().misses, 3u);
+
+        for (size_t i = 0; i < CKekCache::MAX_ENTRIES; ++i)
+        {
+            unsigned char other[HAICRYPT_PBKDF2_SALT_LEN] = {0xFF, 0, 0, 0, 0, 0, 0, 0};
+            memcpy(other + 1, &i, std::min(sizeof i, sizeof other - 1));
+            ASSERT_EQ(cache.derive(pwd.data(), pwd.size(), other, sizeof other, itr, klen, kek), 0);
+        }
+        EXPECT_EQ(cache.stats().entries, size_t(CKekCache::MAX_ENTRIES));
+
+        const uint64_t misses = cache.stats().misses;
+        ASSERT_EQ(cache.derive(pwd.data(), pwd.size(), salt, sizeof salt, itr, klen, kek), 0);
+        EXPECT_EQ(memcmp(kek, expected, klen), 0);
+        EXPECT_EQ(cache.stats().misses, misses + 1);
+    }
+
+    // The keys of a passphrase are kept only while a socket uses it,
+    // and wiped when the last one releases it.
+    TEST(KekCache, Release)
+    {
+        CKekCache cache;
+        const std::string pwd = "abcdefghijk", other = "abcdefghijl";
+        unsigned char salt[HAICRYPT_PBKDF2_SALT_LEN] = {1, 2, 3, 4, 5, 6, 7, 8};
+        unsigned char kek[HAICRYPT_KEY_MAX_SZ];
+
+        ASSERT_EQ(cache.derive(pwd.data(), pwd.size(), salt, sizeof salt, HAICRYPT_PBKDF2_ITER_CNT, 16, kek), 0);
+        EXPECT_EQ(cache.stats().entries, 0u);
+
+        cache.acquire(pwd.data(), pwd.size());
+        cache.acquire(pwd.data(), pwd.size());
+        cache.acquire(other.data(), other.size());
+        ASSERT_EQ(cache.derive(pwd.data(), pwd.size(), salt, sizeof salt, HAICRYPT_PBKDF2_ITER_CNT, 16, kek), 0);
+        ASSERT_EQ(cache.derive(other.data(), other.size(), salt, sizeof salt, HAICRYPT_PBKDF2_ITER_CNT, 16, kek), 0);
+        EXPECT_EQ(cache.stats().entries, 2u);
+
+        cache.release(pwd.data(), pwd.size());
+        EXPECT_EQ(cache.stats().entries, 2u);
+        cache.release(pwd.data(), pwd.size());
+        EXPECT_EQ(cache.stats().entries, 1u);
+
+        const uint64_t misses = cache.stats().misses;
+        ASSERT_EQ(cache.derive(pwd.data(), pwd.size(), salt, sizeof salt, HAICRYPT_PBKDF2_ITER_CNT, 16, kek), 0);
+        EXPECT_EQ(cache.stats().misses, misses + 1);
+        EXPECT_EQ(cache.stats().entries, 1u);
+
+        cache.release(other.data(), other.size());
+        EXPECT_EQ(cache.stats().entries, 0u);
+    }
+
+    // Over the synchronous budget the derivation is left to the derivation thread.
+    TEST(KekCache, Prepare)
+    {
+        CKekCache cache;
+        const std::string pwd = "abcdefghijk";
+        unsigned char salt[HAICRYPT_PBKDF2_SALT_LEN] = {1, 2, 3, 4, 5, 6, 7, 8};
+        unsigned char kek[HAICRYPT_KEY_MAX_SZ];
+
+        cache.acquire(pwd.data(), pwd.size());
+
+        // Measure the cost of a derivation.
+        ASSERT_EQ(cache.derive(pwd.data(), pwd.size(), salt, sizeof salt, HAICRYPT_PBKDF2_ITER_CNT, 16, kek), 0);
+
+        int allowed = 0;
+        for (int i = 0; i < 100000; ++i)
+        {
+            salt[0] = (unsigned char)(i >> 8);
+            salt[1] = (unsigned char)i;
+            if (!cache.prepare(pwd.data(), pwd.size(), salt, sizeof salt, 16))
+                break;
+            ++allowed;
+        }
+
+        EXPECT_GT(allowed, 0);
+        ASSERT_EQ(cache.stats().deferred, 1u);
+        // A repeated request isn't queued again.
+        EXPECT_FALSE(cache.prepare(pwd.data(), pwd.size(), salt, sizeof salt, 16));
+        EXPECT_EQ(cache.stats().deferred, 1u);
+
+        for (int i = 0; i < 200 && cache.stats().entries < 2; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        ASSERT_EQ(cache.stats().entries, 2u);
+
+        EXPECT_TRUE(cache.prepare(pwd.data(), pwd.size(), salt, sizeof salt, 16));
+        EXPECT_EQ(cache.stats().deferred, 1u);
+        cache.stop();
+    }
+
+#ifndef _WIN32
+    // Many callers with a passphrase connecting to one listener at once, several times.
+    // The callers run in a child process so that they don't share the cache with the
+    // listener. Prints the time it takes until all are accepted.
+    TEST(KekCache, DISABLED_ReconnectStorm)
+    {
+        const int NCALLERS = 100, ROUNDS = 3;
+        const std::string pwd = "abcdefghijk";
+
+        sockaddr_in sa;
+        memset(&sa, 0, sizeof sa);
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(5556);
+        ASSERT_EQ(inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr), 1);
+
+        int go[2];
+        ASSERT_EQ(pipe(go), 0);
+        const pid_t child = fork();
+        ASSERT_NE(child, -1);
+        if (child == 0)
+        {
+            srt_startup();
+            int failed = 0;
+            char c;
+            for (int round = 0; round < ROUNDS && read(go[0], &c, 1) == 1; ++round)
+            {
+                std::vector<SRTSOCKET> callers(NCALLERS);
+                std::vector<std::future<int>> results;
+                for (int i = 0; i < NCALLERS; ++i)
+                {
+                    callers[i] = srt_create_socket();
+                    srt_setsockflag(callers[i], SRTO_PASSPHRASE, pwd.c_str(), pwd.size());
+                    results.push_back(std::async(std::launch::async, [&sa](SRTSOCKET s) {
+                        return srt_connect(s, (sockaddr*)& sa, sizeof(sa));
+                        }, callers[i]));
+                }
+                for (size_t i = 0; i < results.size(); ++i)
+                    failed += results[i].get() == SRT_ERROR;
+                // Keep them until the listener has accepted all.
+                read(go[0], &c, 1);
+                for (size_t i = 0; i < callers.size(); ++i)
+                    srt_close(callers[i]);
+            }
+            srt_cleanup();
+            _exit(failed);
+        }
+
+        srt::TestInit srtinit;
+        SRTSOCKET l = srt_create_socket();
+        ASSERT_NE(srt_setsockflag(l, SRTO_PASSPHRASE, pwd.c_str(), pwd.size()), SRT_ERROR);
+        ASSERT_NE(srt_bind(l, (sockaddr*)& sa, sizeof(sa)), SRT_ERROR);
+        ASSERT_NE(srt_listen(l, NCALLERS), SRT_ERROR);
+
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            ASSERT_EQ(write(go[1], "g", 1), 1);
+
+            std::vector<SRTSOCKET> accepted;
+            for (int i = 0; i < NCALLERS; ++i)
+            {
+                SRTSOCKET a = srt_accept(l, NULL, NULL);
+                ASSERT_NE(a, SRT_INVALID_SOCK);
+                accepted.push_back(a);
+            }
+
+            const CKekCache::Stats st = CUDT::uglobal().kekcache_ref().stats();
+            std::cout << "round " << round << ": " << NCALLERS << " callers accepted in "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+                << " ms; KEK cache hits=" << st.hits << " misses=" << st.misses << " deferred=" << st.deferred << std::endl;
+
+            ASSERT_EQ(write(go[1], "c", 1), 1);
+            for (size_t i = 0; i < accepted.size(); ++i)
+                srt_close(accepted[i]);
+        }
+
+        int status = 0;
+        ASSERT_EQ(waitpid(child, &status, 0), child);
+        EXPECT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(WEXITSTATUS(status), 0) << "callers failed to connect";
+        close(go[0]);
+        close(go[1]);
+        srt_close(l);
+    }
+#endif
+
+} // namespace srt
+
+#endif // SRT_ENABLE_ENCRYPTION
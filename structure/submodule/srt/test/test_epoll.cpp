@@ -544,6 +544,64 @@ TEST(CEPoll, ThreadedUpdate)
     }
 }
 
+// Updates through CEPollSubscribers that don't change the state already
+// reported to all subscribed EIDs must be no-ops, and a newly added
+// subscriber must still receive the current state.
+TEST(CEPoll, SubscribersCachedState)
+{
+    srt::TestInit srtinit;
+
+    MAKE_UNIQUE_SOCK(sock, "sock", srt_create_socket());
+    EXPECT_NE(sock, SRT_ERROR);
+
+    CEPoll epoll;
+    const int eid1 = epoll.create();
+    const int eid2 = epoll.create();
+    ASSERT_GE(eid1, 0);
+    ASSERT_GE(eid2, 0);
+
+    const int events_et = SRT_EPOLL_IN | SRT_EPOLL_ET;
+    ASSERT_EQ(epoll.update_usock(eid1, sock, &events_et), 0);
+    ASSERT_EQ(epoll.update_usock(eid2, sock, &events_et), 0);
+
+    srt::CEPollSubscribers subs;
+
+    // No subscribers, nothing to update.
+    EXPECT_EQ(epoll.update_events(sock, subs, SRT_EPOLL_IN, true), 0);
+
+    subs.insert(eid1);
+    EXPECT_EQ(subs.state(), srt::CEPollSubscribers::STATE_UNKNOWN);
+    EXPECT_EQ(epoll.update_events(sock, subs, SRT_EPOLL_IN, true), 1);
+    EXPECT_EQ(subs.state(), int(SRT_EPOLL_IN));
+
+    SRT_EPOLL_EVENT fds[4];
+    ASSERT_EQ(epoll.uwait(eid1, fds, 4, 0), 1);
+    EXPECT_EQ(fds[0].fd, sock);
+    EXPECT_EQ(fds[0].events, int(SRT_EPOLL_IN));
+
+    // Repeated readiness: the edge has already been reported.
+    EXPECT_EQ(epoll.update_events(sock, subs, SRT_EPOLL_IN, true), 0);
+    EXPECT_EQ(epoll.uwait(eid1, fds, 4, 0), 0);
+
+    // The new subscriber must get the event despite the state cached for eid1.
+    subs.insert(eid2);
+    EXPECT_EQ(epoll.update_events(sock, subs, SRT_EPOLL_IN, true), 1);
+    ASSERT_EQ(epoll.uwait(eid2, fds, 4, 0), 1);
+    EXPECT_EQ(fds[0].events, int(SRT_EPOLL_IN));
+
+    EXPECT_EQ(epoll.update_events(sock, subs, SRT_EPOLL_IN, false), 2);
+    EXPECT_EQ(subs.state(), 0);
+    EXPECT_EQ(epoll.update_events(sock, subs, SRT_EPOLL_IN, false), 0);
+
+    // Readiness signalled again after being cleared is a new edge.
+    EXPECT_EQ(epoll.update_events(sock, subs, SRT_EPOLL_IN, true), 2);
+    EXPECT_EQ(epoll.uwait(eid1, fds, 4, 0), 1);
+    EXPECT_EQ(epoll.uwait(eid2, fds, 4, 0), 1);
+
+    EXPECT_EQ(epoll.release(eid1), 0);
+    EXPECT_EQ(epoll.release(eid2), 0);
+}
+
 
 class TestEPoll: public srt::Test
 {
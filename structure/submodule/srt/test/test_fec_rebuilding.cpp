@@ -944,3 +944,82 @@ TEST_F(TestFECRebuilding, Rebuild)
 
     EXPECT_EQ(memcmp(skipped.data(), rebuilt.data(), rebuilt.size()), 0);
 }
+
+// Benchmark: feeding the sender FEC and receiving with rebuilding of 1% lost
+// packets on the receiver FEC, for some common layouts.
+// Run with --gtest_also_run_disabled_tests.
+TEST(TestFEC, DISABLED_FeedRebuildThroughput)
+{
+    PacketFilter::globalInit();
+
+    // Groups that can't be rebuilt because of two losses are
+    // reported as warnings, don't flood the output with them.
+    srt_setloglevel(srt_logging::LogLevel::error);
+
+    const char* layouts[] = {
+        "fec,cols:10,rows:1",
+        "fec,cols:10,rows:5",
+        "fec,cols:20,rows:10",
+        "fec,cols:20,rows:10,layout:staircase"
+    };
+    const int     NPKTS  = 500000;
+    const size_t  plsize = 1316;
+    const int32_t isn    = 1000;
+    const int     sockid = 54321;
+
+    for (size_t l = 0; l < sizeof layouts / sizeof layouts[0]; ++l)
+    {
+        SrtFilterInitializer init = {sockid, isn - 1, isn - 1, plsize, CSrtConfig::DEF_BUFFER_SIZE};
+        vector<SrtPacket> snd_provided, rcv_provided;
+        FECFilterBuiltin  snd(init, snd_provided, layouts[l]);
+        FECFilterBuiltin  rcv(init, rcv_provided, layouts[l]);
+
+        CPacket pkt;
+        pkt.allocate(SRT_LIVE_MAX_PLSIZE);
+        pkt.setLength(plsize);
+        for (size_t b = 0; b < plsize; ++b)
+            pkt.data()[b] = char(b * 7);
+
+        SrtPacket ctl(SRT_LIVE_MAX_PLSIZE);
+        CPacket   ctlpkt;
+        FECFilterBuiltin::loss_seqs_t loss;
+        uint32_t rnd     = 1;
+        size_t   rebuilt = 0;
+
+        const auto start = chrono::steady_clock::now();
+        int32_t    seq   = isn;
+        for (int i = 0; i < NPKTS; ++i, seq = CSeqNo::incseq(seq))
+        {
+            uint32_t* hdr         = pkt.getHeader();
+            hdr[SRT_PH_SEQNO]     = seq;
+            hdr[SRT_PH_MSGNO]     = (i + 1) | MSGNO_PACKET_BOUNDARY::wrap(PB_SOLO);
+            hdr[SRT_PH_ID]        = sockid;
+            hdr[SRT_PH_TIMESTAMP] = i * 10;
+
+            snd.feedSource(pkt);
+
+            rnd = rnd * 1103515245 + 12345;
+            if ((rnd >> 16) % 100 != 0)
+                rcv.receive(pkt, loss);
+
+            while (snd.packControlPacket(ctl, seq))
+            {
+                memcpy(ctlpkt.getHeader(), ctl.hdr, SRT_PH_E_SIZE * sizeof(uint32_t));
+                ctlpkt.m_pcData = ctl.buffer;
+                ctlpkt.setLength(ctl.length);
+                ctlpkt.set_msgflags(SRT_MSGNO_CONTROL | MSGNO_PACKET_BOUNDARY::wrap(PB_SOLO));
+                rcv.receive(ctlpkt, loss);
+            }
+            ctlpkt.m_pcData = NULL;
+
+            rebuilt += rcv_provided.size();
+            rcv_provided.clear();
+            loss.clear();
+        }
+        const double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cerr << layouts[l] << ": " << (NPKTS / secs / 1e6) << " Mpkt/s, "
+             << (NPKTS * plsize * 8 / secs / 1e9) << " Gbit/s, rebuilt " << rebuilt << "\n";
+        EXPECT_GT(rebuilt, 0u);
+    }
+}
@@ -0,0 +1,561 @@
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "test_env.h"
+#include "packet.h"
+#include "fec_rs.h"
+#include "core.h"
+#include "packetfilter.h"
+#include "packetfilter_api.h"
+
+using namespace std;
+using namespace srt;
+
+class TestFECReedSolomon: public srt::Test
+{
+protected:
+    RSFilterBuiltin* snd = nullptr;
+    RSFilterBuiltin* rcv = nullptr;
+    vector<SrtPacket> snd_provided, rcv_provided;
+    vector<unique_ptr<CPacket>> source;
+    int sockid = 54321;
+    int isn = 123456;
+    size_t plsize = 1316;
+
+    TestFECReedSolomon()
+    {
+        // Required to make ParseFilterConfig work
+        PacketFilter::globalInit();
+    }
+
+    void setup() override
+    {
+    }
+
+    void teardown() override
+    {
+        delete snd;
+        delete rcv;
+    }
+
+    void configure(const string& conf, size_t npackets)
+    {
+        SrtFilterInitializer init = {
+            sockid,
+            isn - 1, // It's passed in this form to PacketFilter constructor, it should increase it
+            isn - 1,
+            plsize,
+            CSrtConfig::DEF_BUFFER_SIZE
+        };
+
+        snd = new RSFilterBuiltin(init, snd_provided, conf);
+        rcv = new RSFilterBuiltin(init, rcv_provided, conf);
+
+        int32_t seq = isn;
+        int timestamp = 10;
+        for (size_t i = 0; i < npackets; ++i)
+        {
+            source.emplace_back(new CPacket);
+            CPacket& p = *source.back();
+
+            p.allocate(SRT_LIVE_MAX_PLSIZE);
+
+            uint32_t* hdr = p.getHeader();
+            hdr[SRT_PH_SEQNO] = seq;
+            hdr[SRT_PH_MSGNO] = 1 | MSGNO_PACKET_BOUNDARY::wrap(PB_SOLO);
+            hdr[SRT_PH_ID] = sockid;
+            hdr[SRT_PH_TIMESTAMP] = timestamp;
+
+            // Randomly chosen sizes, mostly not a multiple of the vector size.
+            const int minsize = 100;
+            const size_t length = minsize + rand() % (int(plsize) - minsize + 1);
+
+            p.setLength(length);
+            for (size_t b = 0; b < length; ++b)
+                p.data()[b] = char(rand() % 255);
+
+            timestamp += 10;
+            seq = CSeqNo::incseq(seq);
+        }
+    }
+
+    // Feeds the sender filter with all source packets and collects all
+    // the generated parity packets.
+    vector<SrtPacket> send()
+    {
+        vector<SrtPacket> parity;
+        SrtPacket ctl(SRT_LIVE_MAX_PLSIZE);
+        for (size_t i = 0; i < source.size(); ++i)
+        {
+            snd->feedSource(*source[i]);
+            while (snd->packControlPacket(ctl, source[i]->getSeqNo()))
+                parity.push_back(ctl);
+        }
+        return parity;
+    }
+
+    // Same as PacketFilter::packControlPacket does
+    bool receiveControl(SrtPacket& ctl, RSFilterBuiltin::loss_seqs_t& loss)
+    {
+        CPacket pkt;
+        memcpy(pkt.getHeader(), ctl.hdr, SRT_PH_E_SIZE * sizeof(uint32_t));
+        pkt.m_pcData = ctl.buffer;
+        pkt.setLength(ctl.length);
+        pkt.set_msgflags(SRT_MSGNO_CONTROL | MSGNO_PACKET_BOUNDARY::wrap(PB_SOLO));
+
+        const bool passthru = rcv->receive(pkt, loss);
+        pkt.m_pcData = NULL;
+        return passthru;
+    }
+
+    void expectRebuilt(const SrtPacket& rebuilt)
+    {
+        const int off = CSeqNo::seqoff(isn, rebuilt.hdr[SRT_PH_SEQNO]);
+        ASSERT_GE(off, 0);
+        ASSERT_LT(off, int(source.size()));
+        CPacket& lost = *source[off];
+
+        // The rebuilt packet shall have REXMIT flag set.
+        EXPECT_EQ(lost.getHeader()[SRT_PH_MSGNO] | MSGNO_REXMIT::wrap(true), rebuilt.hdr[SRT_PH_MSGNO]);
+        EXPECT_EQ(lost.getHeader()[SRT_PH_ID], rebuilt.hdr[SRT_PH_ID]);
+        EXPECT_EQ(lost.getHeader()[SRT_PH_TIMESTAMP], rebuilt.hdr[SRT_PH_TIMESTAMP]);
+
+        ASSERT_EQ(lost.size(), rebuilt.size());
+        EXPECT_EQ(memcmp(lost.data(), rebuilt.data(), rebuilt.size()), 0);
+    }
+};
+
+TEST_F(TestFECReedSolomon, Config)
+{
+    const auto verify = [](const char* conf) {
+        SrtFilterConfig cfg;
+        string error;
+        return ParseFilterConfig(conf, (cfg)) && RSFilterBuiltin::verifyConfig(cfg, (error));
+    };
+
+    SrtFilterConfig cfg;
+    EXPECT_TRUE(ParseFilterConfig("rs,k:8,m:4", (cfg)));
+    EXPECT_EQ(cfg.extra_size, size_t(RSFilterBuiltin::EXTRA_SIZE));
+
+    EXPECT_TRUE(verify("rs"));
+    EXPECT_TRUE(verify("rs,k:8,m:4,arq:never"));
+    EXPECT_FALSE(verify("rs,k:1"));
+    EXPECT_FALSE(verify("rs,k:10,m:0"));
+    EXPECT_FALSE(verify("rs,k:250,m:10"));
+    EXPECT_FALSE(verify("rs,k:10,cols:10"));
+    EXPECT_FALSE(verify("rs,arq:sometimes"));
+    EXPECT_TRUE(verify("rs,adaptive:on,target:0.5"));
+    EXPECT_FALSE(verify("rs,adaptive:yes"));
+    EXPECT_FALSE(verify("rs,adaptive:on,target:0"));
+    EXPECT_FALSE(verify("rs,adaptive:on,arq:never"));
+}
+
+TEST_F(TestFECReedSolomon, RebuildMaxLosses)
+{
+    configure("rs,k:10,m:3", 10);
+    vector<SrtPacket> parity = send();
+    ASSERT_EQ(parity.size(), 3U);
+
+    RSFilterBuiltin::loss_seqs_t loss;
+    for (size_t i = 0; i < source.size(); ++i)
+    {
+        // Lose the first, the last and one in the middle.
+        if (i == 0 || i == 5 || i == 9)
+            continue;
+        EXPECT_TRUE(rcv->receive(*source[i], loss));
+    }
+    EXPECT_TRUE(rcv_provided.empty());
+
+    EXPECT_FALSE(receiveControl(parity[0], loss));
+    EXPECT_FALSE(receiveControl(parity[1], loss));
+    EXPECT_TRUE(rcv_provided.empty());
+    EXPECT_FALSE(receiveControl(parity[2], loss));
+
+    EXPECT_EQ(loss.size(), 0U);
+    ASSERT_EQ(rcv_provided.size(), 3U);
+    for (size_t i = 0; i < rcv_provided.size(); ++i)
+        expectRebuilt(rcv_provided[i]);
+}
+
+TEST_F(TestFECReedSolomon, RebuildWithParityLost)
+{
+    configure("rs,k:6,m:4", 6);
+    vector<SrtPacket> parity = send();
+    ASSERT_EQ(parity.size(), 4U);
+
+    RSFilterBuiltin::loss_seqs_t loss;
+    // Parity packets may come in any order and interleaved with data.
+    EXPECT_FALSE(receiveControl(parity[3], loss));
+    for (size_t i = 0; i < source.size(); ++i)
+    {
+        if (i == 1 || i == 2)
+            continue;
+        EXPECT_TRUE(rcv->receive(*source[i], loss));
+    }
+    EXPECT_TRUE(rcv_provided.empty());
+    EXPECT_FALSE(receiveControl(parity[1], loss));
+
+    ASSERT_EQ(rcv_provided.size(), 2U);
+    for (size_t i = 0; i < rcv_provided.size(); ++i)
+        expectRebuilt(rcv_provided[i]);
+    rcv_provided.clear();
+
+    // Packets arriving after rebuilding are passed through and ignored.
+    EXPECT_FALSE(receiveControl(parity[0], loss));
+    EXPECT_TRUE(rcv->receive(*source[1], loss));
+    EXPECT_TRUE(rcv_provided.empty());
+    EXPECT_EQ(loss.size(), 0U);
+}
+
+TEST_F(TestFECReedSolomon, IrrecoverableReported)
+{
+    configure("rs,k:5,m:2", 15);
+    vector<SrtPacket> parity = send();
+    ASSERT_EQ(parity.size(), 6U);
+
+    RSFilterBuiltin::loss_seqs_t loss;
+    // Block 0: three data packets lost, only two parity packets.
+    for (size_t i = 0; i < 5; ++i)
+    {
+        if (i >= 1 && i <= 3)
+            continue;
+        rcv->receive(*source[i], loss);
+    }
+    receiveControl(parity[0], loss);
+    receiveControl(parity[1], loss);
+    EXPECT_TRUE(rcv_provided.empty());
+
+    // Block 1: complete.
+    for (size_t i = 5; i < 10; ++i)
+        rcv->receive(*source[i], loss);
+    EXPECT_EQ(loss.size(), 0U);
+
+    // The first packet of block 2 dismisses block 0.
+    rcv->receive(*source[10], loss);
+    ASSERT_EQ(loss.size(), 1U);
+    EXPECT_EQ(loss[0].first, CSeqNo::incseq(isn, 1));
+    EXPECT_EQ(loss[0].second, CSeqNo::incseq(isn, 3));
+    EXPECT_TRUE(rcv_provided.empty());
+}
+
+TEST_F(TestFECReedSolomon, RebuildRandomLosses)
+{
+    const size_t k = 12, m = 4, nblocks = 50;
+    configure("rs,k:12,m:4", k * nblocks);
+    vector<SrtPacket> parity = send();
+    ASSERT_EQ(parity.size(), m * nblocks);
+
+    RSFilterBuiltin::loss_seqs_t loss;
+    size_t nlost = 0, nrebuilt = 0;
+    for (size_t b = 0; b < nblocks; ++b)
+    {
+        // Lose up to m of the k+m packets in the block.
+        vector<size_t> order(k + m);
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        for (size_t i = order.size() - 1; i > 0; --i)
+            swap(order[i], order[rand() % (i + 1)]);
+        const size_t nloss = b % (m + 1);
+        vector<bool> lost(k + m, false);
+        for (size_t i = 0; i < nloss; ++i)
+            lost[order[i]] = true;
+
+        for (size_t i = 0; i < k + m; ++i)
+        {
+            if (lost[i])
+            {
+                if (i < k)
+                    ++nlost;
+                continue;
+            }
+            if (i < k)
+                EXPECT_TRUE(rcv->receive(*source[b * k + i], loss));
+            else
+                EXPECT_FALSE(receiveControl(parity[b * m + i - k], loss));
+        }
+
+        for (size_t i = 0; i < rcv_provided.size(); ++i)
+            expectRebuilt(rcv_provided[i]);
+        nrebuilt += rcv_provided.size();
+        rcv_provided.clear();
+        EXPECT_EQ(loss.size(), 0U);
+    }
+
+    EXPECT_GT(nlost, 0U);
+    EXPECT_EQ(nrebuilt, nlost);
+}
+
+// Sends the given number of blocks through the sender filter, with the
+// receiver filter losing the first data packet of every block. Returns the
+// number of parity packets sent and verifies that blocks with parity are
+// rebuilt.
+static size_t runAdaptiveBlocks(RSFilterBuiltin& snd, RSFilterBuiltin& rcv, vector<SrtPacket>& rcv_provided,
+        int32_t& w_seq, size_t nblocks)
+{
+    CPacket pkt;
+    pkt.allocate(SRT_LIVE_MAX_PLSIZE);
+    pkt.setLength(1000);
+    memset(pkt.data(), 'x', 1000);
+
+    SrtPacket ctl(SRT_LIVE_MAX_PLSIZE);
+    CPacket   ctlpkt;
+    RSFilterBuiltin::loss_seqs_t loss;
+    size_t nparity = 0;
+
+    for (size_t b = 0; b < nblocks; ++b)
+    {
+        const size_t active = snd.activeParity();
+        for (size_t i = 0; i < snd.numberData(); ++i, w_seq = CSeqNo::incseq(w_seq))
+        {
+            uint32_t* hdr         = pkt.getHeader();
+            hdr[SRT_PH_SEQNO]     = w_seq;
+            hdr[SRT_PH_MSGNO]     = 1 | MSGNO_PACKET_BOUNDARY::wrap(PB_SOLO);
+            hdr[SRT_PH_TIMESTAMP] = w_seq;
+
+            snd.feedSource(pkt);
+            if (i != 0)
+                rcv.receive(pkt, loss);
+
+            while (snd.packControlPacket(ctl, w_seq))
+            {
+                ++nparity;
+                EXPECT_EQ(size_t(uint8_t(ctl.buffer[2])), active);
+                memcpy(ctlpkt.getHeader(), ctl.hdr, SRT_PH_E_SIZE * sizeof(uint32_t));
+                ctlpkt.m_pcData = ctl.buffer;
+                ctlpkt.setLength(ctl.length);
+                ctlpkt.set_msgflags(SRT_MSGNO_CONTROL | MSGNO_PACKET_BOUNDARY::wrap(PB_SOLO));
+                rcv.receive(ctlpkt, loss);
+            }
+            ctlpkt.m_pcData = NULL;
+        }
+
+        EXPECT_EQ(rcv_provided.size(), active > 0 ? 1U : 0U);
+        rcv_provided.clear();
+    }
+
+    return nparity;
+}
+
+TEST(TestFECRS, AdaptiveOnRequest)
+{
+    PacketFilter::globalInit();
+
+    const int32_t isn = 1000;
+    SrtFilterInitializer init = {54321, isn - 1, isn - 1, 1316, CSrtConfig::DEF_BUFFER_SIZE};
+    vector<SrtPacket> snd_provided, rcv_provided;
+    RSFilterBuiltin snd(init, snd_provided, "rs,k:10,m:3,adaptive:on");
+    RSFilterBuiltin rcv(init, rcv_provided, "rs,k:10,m:3,adaptive:on");
+
+    const size_t window_blocks = RSFilterBuiltin::ADAPT_WINDOW / 10;
+    int32_t seq = isn;
+
+    // Starting with the maximum, one parity packet less after every
+    // 3 windows without unrecovered losses reported.
+    EXPECT_EQ(snd.activeParity(), 3U);
+    EXPECT_EQ(runAdaptiveBlocks(snd, rcv, rcv_provided, seq, 3 * window_blocks), 3 * 3 * window_blocks);
+    EXPECT_EQ(snd.activeParity(), 2U);
+    runAdaptiveBlocks(snd, rcv, rcv_provided, seq, 6 * window_blocks);
+    EXPECT_EQ(snd.activeParity(), 0U);
+    EXPECT_EQ(runAdaptiveBlocks(snd, rcv, rcv_provided, seq, window_blocks), 0U);
+
+    // Unrecovered losses over the target raise it at the next block.
+    snd.lossReported(seq, CSeqNo::incseq(seq, 4), 5);
+    runAdaptiveBlocks(snd, rcv, rcv_provided, seq, 1);
+    EXPECT_EQ(snd.activeParity(), 1U);
+
+    // After a decrease was followed by an increase, it takes
+    // twice as long to decrease again.
+    runAdaptiveBlocks(snd, rcv, rcv_provided, seq, 5 * window_blocks);
+    EXPECT_EQ(snd.activeParity(), 1U);
+    runAdaptiveBlocks(snd, rcv, rcv_provided, seq, window_blocks);
+    EXPECT_EQ(snd.activeParity(), 0U);
+}
+
+TEST(TestFECRS, AdaptiveAlways)
+{
+    PacketFilter::globalInit();
+
+    const int32_t isn = 1000;
+    SrtFilterInitializer init = {54321, isn - 1, isn - 1, 1316, CSrtConfig::DEF_BUFFER_SIZE};
+    vector<SrtPacket> snd_provided, rcv_provided;
+    RSFilterBuiltin snd(init, snd_provided, "rs,k:10,m:6,adaptive:on,arq:always,target:0.1");
+    RSFilterBuiltin rcv(init, rcv_provided, "rs,k:10,m:6,adaptive:on,arq:always,target:0.1");
+
+    const size_t window_blocks = RSFilterBuiltin::ADAPT_WINDOW / 10;
+    int32_t seq = isn;
+
+    // Raw losses of 5%: with 2 parity packets the expected
+    // unrecovered rate would be about 0.2%, with 3 about 0.03%.
+    runAdaptiveBlocks(snd, rcv, rcv_provided, seq, window_blocks - 1);
+    snd.lossReported(seq, seq, int(RSFilterBuiltin::ADAPT_WINDOW / 20));
+    runAdaptiveBlocks(snd, rcv, rcv_provided, seq, 1);
+    EXPECT_EQ(snd.activeParity(), 3U);
+
+    // Raw losses of 0.05% need no parity, but the measured rate
+    // decreases slowly.
+    snd.lossReported(seq, seq, 1);
+    runAdaptiveBlocks(snd, rcv, rcv_provided, seq, window_blocks);
+    EXPECT_GT(snd.activeParity(), 0U);
+    runAdaptiveBlocks(snd, rcv, rcv_provided, seq, 20 * window_blocks);
+    EXPECT_EQ(snd.activeParity(), 0U);
+}
+
+TEST(TestFECRS, Connection)
+{
+    srt::TestInit srtinit;
+
+    SRTSOCKET s = srt_create_socket();
+    SRTSOCKET l = srt_create_socket();
+
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(5555);
+    ASSERT_EQ(inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr), 1);
+
+    srt_bind(l, (sockaddr*)& sa, sizeof(sa));
+
+    const char rs_config1 [] = "rs,k:20";
+    const char rs_config2 [] = "rs,m:4,arq:never";
+    const char rs_config_final [] = "rs,k:20,m:4,arq:never";
+
+    ASSERT_NE(srt_setsockflag(s, SRTO_PACKETFILTER, rs_config1, (sizeof rs_config1)-1), -1);
+    ASSERT_NE(srt_setsockflag(l, SRTO_PACKETFILTER, rs_config2, (sizeof rs_config2)-1), -1);
+
+    srt_listen(l, 1);
+
+    auto connect_res = std::async(std::launch::async, [&s, &sa]() {
+        return srt_connect(s, (sockaddr*)& sa, sizeof(sa));
+        });
+
+    SRTSOCKET la[] = { l };
+    SRTSOCKET a = srt_accept_bond(la, 1, 2000);
+    ASSERT_NE(a, SRT_ERROR);
+    EXPECT_EQ(connect_res.get(), SRT_SUCCESS);
+
+    char result_config1[200] = "";
+    int result_config1_size = 200;
+    char result_config2[200] = "";
+    int result_config2_size = 200;
+
+    EXPECT_NE(srt_getsockflag(s, SRTO_PACKETFILTER, result_config1, &result_config1_size), -1);
+    EXPECT_NE(srt_getsockflag(a, SRTO_PACKETFILTER, result_config2, &result_config2_size), -1);
+
+    vector<string> caller_config, accept_config, final_config;
+    Split(string(result_config1), ',', back_inserter(caller_config));
+    Split(string(result_config2), ',', back_inserter(accept_config));
+    Split(string(rs_config_final), ',', back_inserter(final_config));
+    sort(caller_config.begin(), caller_config.end());
+    sort(accept_config.begin(), accept_config.end());
+    sort(final_config.begin(), final_config.end());
+    EXPECT_EQ(caller_config, final_config);
+    EXPECT_EQ(accept_config, final_config);
+
+    // Parity packets are sent and received along with the data.
+    char buf[1316];
+    for (int i = 0; i < 100; ++i)
+    {
+        memset(buf, i, sizeof buf);
+        ASSERT_EQ(srt_sendmsg(s, buf, sizeof buf, -1, true), int(sizeof buf));
+    }
+
+    int rcvd = 0;
+    const int yes = 1;
+    srt_setsockflag(a, SRTO_RCVSYN, &yes, sizeof yes);
+    const int timeout_ms = 1000;
+    srt_setsockflag(a, SRTO_RCVTIMEO, &timeout_ms, sizeof timeout_ms);
+    for (; rcvd < 100; ++rcvd)
+    {
+        if (srt_recvmsg(a, buf, sizeof buf) != int(sizeof buf))
+            break;
+        EXPECT_EQ(buf[0], char(rcvd));
+    }
+    EXPECT_EQ(rcvd, 100);
+
+    SRT_TRACEBSTATS stats;
+    ASSERT_EQ(srt_bstats(s, &stats, 0), 0);
+    EXPECT_EQ(stats.pktSndFilterExtraTotal, 100 / 20 * 4);
+
+    srt_close(a);
+    srt_close(s);
+    srt_close(l);
+}
+
+// Benchmark: feeding the sender filter and receiving with rebuilding of 2%
+// lost packets on the receiver filter, for some common configurations.
+// Run with --gtest_also_run_disabled_tests.
+TEST(TestFECRS, DISABLED_FeedRebuildThroughput)
+{
+    PacketFilter::globalInit();
+    srt_setloglevel(srt_logging::LogLevel::error);
+
+    const char* configs[] = {
+        "rs,k:10,m:2",
+        "rs,k:20,m:4",
+        "rs,k:50,m:10"
+    };
+    const int     NPKTS  = 500000;
+    const size_t  plsize = 1316;
+    const int32_t isn    = 1000;
+    const int     sockid = 54321;
+
+    for (size_t l = 0; l < sizeof configs / sizeof configs[0]; ++l)
+    {
+        SrtFilterInitializer init = {sockid, isn - 1, isn - 1, plsize, CSrtConfig::DEF_BUFFER_SIZE};
+        vector<SrtPacket> snd_provided, rcv_provided;
+        RSFilterBuiltin   snd(init, snd_provided, configs[l]);
+        RSFilterBuiltin   rcv(init, rcv_provided, configs[l]);
+
+        CPacket pkt;
+        pkt.allocate(SRT_LIVE_MAX_PLSIZE);
+        pkt.setLength(plsize);
+        for (size_t b = 0; b < plsize; ++b)
+            pkt.data()[b] = char(b * 7);
+
+        SrtPacket ctl(SRT_LIVE_MAX_PLSIZE);
+        CPacket   ctlpkt;
+        RSFilterBuiltin::loss_seqs_t loss;
+        uint32_t rnd     = 1;
+        size_t   rebuilt = 0;
+
+        const auto start = chrono::steady_clock::now();
+        int32_t    seq   = isn;
+        for (int i = 0; i < NPKTS; ++i, seq = CSeqNo::incseq(seq))
+        {
+            uint32_t* hdr         = pkt.getHeader();
+            hdr[SRT_PH_SEQNO]     = seq;
+            hdr[SRT_PH_MSGNO]     = (i + 1) | MSGNO_PACKET_BOUNDARY::wrap(PB_SOLO);
+            hdr[SRT_PH_ID]        = sockid;
+            hdr[SRT_PH_TIMESTAMP] = i * 10;
+
+            snd.feedSource(pkt);
+
+            rnd = rnd * 1103515245 + 12345;
+            if ((rnd >> 16) % 50 != 0)
+                rcv.receive(pkt, loss);
+
+            while (snd.packControlPacket(ctl, seq))
+            {
+                memcpy(ctlpkt.getHeader(), ctl.hdr, SRT_PH_E_SIZE * sizeof(uint32_t));
+                ctlpkt.m_pcData = ctl.buffer;
+                ctlpkt.setLength(ctl.length);
+                ctlpkt.set_msgflags(SRT_MSGNO_CONTROL | MSGNO_PACKET_BOUNDARY::wrap(PB_SOLO));
+                rcv.receive(ctlpkt, loss);
+            }
+            ctlpkt.m_pcData = NULL;
+
+            rebuilt += rcv_provided.size();
+            rcv_provided.clear();
+            loss.clear();
+        }
+        const double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cerr << configs[l] << ": " << (NPKTS / secs / 1e6) << " Mpkt/s, "
+             << (NPKTS * plsize * 8 / secs / 1e9) << " Gbit/s, rebuilt " << rebuilt << "\n";
+        EXPECT_GT(rebuilt, 0u);
+    }
+}
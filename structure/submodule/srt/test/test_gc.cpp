@@ -0,0 +1,106 @@
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "test_env.h"
+
+#include "srt.h"
+
+// Collecting closed sockets from the GC deadline queue.
+class GarbageCollector
+    : public ::testing::Test
+{
+protected:
+    GarbageCollector()
+    {
+        memset(&m_sa, 0, sizeof m_sa);
+        m_sa.sin_family = AF_INET;
+        m_sa.sin_port = htons(5564);
+        EXPECT_EQ(inet_pton(AF_INET, "127.0.0.1", &m_sa.sin_addr), 1);
+
+        m_listener = srt_create_socket();
+        EXPECT_NE(srt_bind(m_listener, (sockaddr*)& m_sa, sizeof m_sa), SRT_ERROR);
+        EXPECT_NE(srt_listen(m_listener, 16), SRT_ERROR);
+    }
+
+    ~GarbageCollector()
+    {
+        srt_close(m_listener);
+    }
+
+    // Connects a new caller and returns it with its accepted peer.
+    void connect(SRTSOCKET& w_caller, SRTSOCKET& w_accepted)
+    {
+        std::future<SRTSOCKET> accepted = std::async(std::launch::async, [this]() {
+            return srt_accept(m_listener, NULL, NULL);
+        });
+
+        w_caller = srt_create_socket();
+        ASSERT_NE(srt_connect(w_caller, (sockaddr*)& m_sa, sizeof m_sa), SRT_ERROR);
+        w_accepted = accepted.get();
+        ASSERT_NE(w_accepted, SRT_INVALID_SOCK);
+    }
+
+    // Waits until all the sockets are deleted, and returns the time of waiting.
+    static std::chrono::milliseconds waitDeleted(const std::vector<SRTSOCKET>& sockets)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < sockets.size(); ++i)
+        {
+            while (srt_getsockstate(sockets[i]) != SRTS_NONEXIST
+                    && std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    srt::TestInit m_srtinit;
+    sockaddr_in m_sa;
+    SRTSOCKET m_listener = SRT_INVALID_SOCK;
+};
+
+// Both sides of a closed connection must be deleted right after
+// the one second of the closing grace time.
+TEST_F(GarbageCollector, ClosedDeletedAfterGrace)
+{
+    SRTSOCKET caller, accepted;
+    connect(caller, accepted);
+
+    ASSERT_EQ(srt_close(caller), SRT_SUCCESS);
+    ASSERT_EQ(srt_close(accepted), SRT_SUCCESS);
+    EXPECT_EQ(srt_getsockstate(caller), SRTS_CLOSED);
+
+    const std::chrono::milliseconds waited = waitDeleted({caller, accepted});
+    EXPECT_GE(waited.count(), 900);
+    EXPECT_LT(waited.count(), 1500);
+}
+
+// The accepted socket whose peer has closed the connection is broken,
+// and it must be deleted without the application closing it.
+TEST_F(GarbageCollector, BrokenDeleted)
+{
+    SRTSOCKET caller, accepted;
+    connect(caller, accepted);
+
+    ASSERT_EQ(srt_close(caller), SRT_SUCCESS);
+    EXPECT_LT(waitDeleted({caller, accepted}).count(), 2500);
+}
+
+// Many short connections must all be collected in about the same time
+// as a single one.
+TEST_F(GarbageCollector, Churn)
+{
+    std::vector<SRTSOCKET> closed;
+    for (int i = 0; i < 50; ++i)
+    {
+        SRTSOCKET caller, accepted;
+        connect(caller, accepted);
+        ASSERT_EQ(srt_close(caller), SRT_SUCCESS);
+        ASSERT_EQ(srt_close(accepted), SRT_SUCCESS);
+        closed.push_back(caller);
+        closed.push_back(accepted);
+    }
+
+    EXPECT_LT(waitDeleted(closed).count(), 1500);
+}
@@ -0,0 +1,221 @@
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "logging.h"
+
+#if ENABLE_LOGGING
+
+using namespace srt_logging;
+
+// Asynchronous logging (SRT_LOGF_ASYNC) and the binary log.
+class AsyncLogging
+    : public ::testing::Test
+{
+protected:
+    AsyncLogging()
+        : m_config(AllFa(), LogLevel::debug)
+        , m_log(SRT_LOGFA_GENERAL, m_config, "SRT.test")
+    {
+        m_config.loghandler_fn = &AsyncLogging::handler;
+        m_config.loghandler_opaque = this;
+    }
+
+    ~AsyncLogging()
+    {
+        m_config.setAsync(false);
+    }
+
+    static LogConfig::fa_bitset_t AllFa()
+    {
+        LogConfig::fa_bitset_t fa;
+        fa.set();
+        return fa;
+    }
+
+    static void handler(void* opaque, int, const char*, int, const char*, const char* message)
+    {
+        static_cast<AsyncLogging*>(opaque)->m_lines.push_back(message);
+    }
+
+    struct Custom
+    {
+        int value;
+    };
+
+    friend std::ostream& operator<<(std::ostream& os, const Custom& c)
+    {
+        return os << "Custom(" << c.value << ")";
+    }
+
+    // Logs a sample of every kind of argument the ring stores differently.
+    void logSample(int n)
+    {
+        const std::string str = "string";
+        const Custom custom = { n };
+        LOGC(m_log.Debug, log << "int=" << n << " neg=" << -n << " unsigned=" << 3000000000u
+                << " i64=" << int64_t(-1234567890123LL) << " double=" << 2.5 << " float=" << 0.1f
+                << " char=" << 'x' << " bool=" << true << " str=" << str << " custom=" << custom);
+        LOGC(m_log.Note, log << "hex=" << std::hex << 255 << " still hex=" << n << std::dec
+                << " width=[" << std::setw(5) << 42 << "] after=" << n);
+        LOGF(m_log.Warn, "printf-like %d %s", n, "text");
+        SLOGC(m_log.Debug, n, log << LogSocketId(n) << "socket line");
+    }
+
+    static int counted(int& w_count)
+    {
+        return ++w_count;
+    }
+
+    // Strips the time from the beginning of the line.
+    static std::string untimed(const std::string& line)
+    {
+        return line.substr(line.find('/'));
+    }
+
+    LogConfig m_config;
+    Logger m_log;
+    std::vector<std::string> m_lines;
+};
+
+// The lines formatted by the writer thread must be the same
+// as formatted directly at the log call.
+TEST_F(AsyncLogging, SameAsSync)
+{
+    m_config.flags = SRT_LOGF_DISABLE_TIME;
+    logSample(17);
+    const std::vector<std::string> sync_lines = m_lines;
+    ASSERT_EQ(sync_lines.size(), 4U);
+    m_lines.clear();
+
+    m_config.setAsync(true);
+    logSample(17);
+    m_config.setAsync(false); // waits for the pending lines
+    EXPECT_EQ(m_lines, sync_lines);
+}
+
+// Lines logged by threads that have already exited must be delivered,
+// in the order of time.
+TEST_F(AsyncLogging, ExitedThreads)
+{
+    m_config.setAsync(true);
+    for (int i = 0; i < 4; ++i)
+    {
+        std::thread t([this, i]() {
+            LOGC(m_log.Note, log << "thread " << i);
+        });
+        t.join();
+    }
+    m_config.setAsync(false);
+
+    ASSERT_EQ(m_lines.size(), 4U);
+    for (int i = 0; i < 4; ++i)
+    {
+        std::ostringstream expected;
+        expected << "thread " << i << "\n";
+        const std::string& line = m_lines[i];
+        ASSERT_GE(line.size(), expected.str().size());
+        EXPECT_EQ(line.substr(line.size() - expected.str().size()), expected.str());
+    }
+}
+
+// The binary log must be rendered by LogBinReader the same way as the
+// lines are formatted directly at the log call.
+TEST_F(AsyncLogging, BinaryFile)
+{
+    logSample(5);
+    logSample(6);
+    const std::vector<std::string> sync_lines = m_lines;
+    m_lines.clear();
+
+    const std::string path = "test_logging.srtlog";
+    ASSERT_TRUE(SetLogBinaryFile(path.c_str()));
+    m_config.setAsync(true);
+    logSample(5);
+    logSample(6);
+    m_config.setAsync(false);
+    ASSERT_TRUE(SetLogBinaryFile(NULL));
+    EXPECT_TRUE(m_lines.empty());
+
+    std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+    LogBinReader reader(in);
+    ASSERT_TRUE(reader.open());
+    std::vector<std::string> bin_lines;
+    std::string line;
+    while (reader.next((line)))
+        bin_lines.push_back(line);
+    EXPECT_FALSE(reader.failed());
+    in.close();
+    std::remove(path.c_str());
+
+    ASSERT_EQ(bin_lines.size(), sync_lines.size());
+    for (size_t i = 0; i < bin_lines.size(); ++i)
+        EXPECT_EQ(untimed(bin_lines[i]), untimed(sync_lines[i]));
+}
+
+// The lines of the socket set as the filter are logged up to its level,
+// and the arguments of the other lines above the global level are not
+// even evaluated.
+TEST_F(AsyncLogging, SocketFilter)
+{
+    m_config.flags = SRT_LOGF_DISABLE_TIME;
+    m_config.max_level = LogLevel::warning;
+    m_config.sock_filter = 77;
+    m_config.sock_level = LogLevel::debug;
+
+    int evaluated = 0;
+    SLOGC(m_log.Debug, 77, log << LogSocketId(77) << "selected " << counted(evaluated));
+    SLOGC(m_log.Debug, 78, log << LogSocketId(78) << "other " << counted(evaluated));
+    LOGC(m_log.Debug, log << "general " << counted(evaluated));
+    SLOGC(m_log.Warn, 78, log << LogSocketId(78) << "warning " << counted(evaluated));
+
+    EXPECT_EQ(evaluated, 2);
+    ASSERT_EQ(m_lines.size(), 2U);
+    EXPECT_NE(m_lines[0].find("@77: selected 1"), std::string::npos);
+    EXPECT_NE(m_lines[1].find("@78: warning 2"), std::string::npos);
+
+    // Turned off, the global level applies to the socket again.
+    m_lines.clear();
+    m_config.sock_filter = SRT_INVALID_SOCK;
+    SLOGC(m_log.Debug, 77, log << LogSocketId(77) << "selected " << counted(evaluated));
+    EXPECT_EQ(evaluated, 2);
+    EXPECT_TRUE(m_lines.empty());
+}
+
+TEST(LogRing, WrapAndDrop)
+{
+    LogRing ring(new char[LogRing::CAPACITY], "test");
+    std::vector<char> payload(LogRing::CAPACITY / 3, 'a');
+    std::vector<char> rec;
+
+    // Every third record doesn't fit and is dropped. After reading
+    // the other two, the following ones wrap around the end of the buffer.
+    for (int i = 0; i < 10; ++i)
+    {
+        const uint32_t size = uint32_t(sizeof(uint32_t) + payload.size());
+        payload[0] = char('0' + i);
+        ring.begin();
+        ring.put(&size, sizeof size);
+        ring.put(&payload[0], payload.size());
+        EXPECT_EQ(ring.commit(), i % 3 != 2) << i;
+
+        if (i % 3 == 2)
+        {
+            for (int r = 2; r > 0; --r)
+            {
+                ASSERT_TRUE(ring.read((rec)));
+                ASSERT_EQ(rec.size(), size);
+                EXPECT_EQ(rec[sizeof(uint32_t)], char('0' + i - r));
+            }
+            EXPECT_FALSE(ring.read((rec)));
+        }
+    }
+    EXPECT_EQ(ring.dropped(), 3U);
+}
+
+#endif // ENABLE_LOGGING
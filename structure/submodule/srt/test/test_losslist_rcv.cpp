@@ -1,8 +1,12 @@
+#include <chrono>
+#include <deque>
 #include <iostream>
+#include <vector>
 #include "gtest/gtest.h"
 #include "test_env.h"
 #include "common.h"
 #include "list.h"
+#include "packet.h"
 
 using namespace std;
 using namespace srt;
@@ -71,6 +75,138 @@ TEST_F(CRcvLossListTest, InsertTwoElemsEdge)
     CheckEmptyArray();
 }
 
+/// Remove one element from inside a range, then read the ranges for the NAK report.
+TEST_F(CRcvLossListTest, RemoveSplitLossArray)
+{
+    EXPECT_EQ(m_lossList->insert(10, 20), 11);
+    EXPECT_EQ(m_lossList->insert(30, 30), 1);
+    EXPECT_TRUE(m_lossList->remove(15));
+    EXPECT_FALSE(m_lossList->remove(15));
+    EXPECT_EQ(m_lossList->getLossLength(), 11);
+
+    int32_t array[8];
+    int     len = 0;
+    m_lossList->getLossArray(array, len, 8);
+    ASSERT_EQ(len, 5);
+    EXPECT_EQ(array[0], 10 | LOSSDATA_SEQNO_RANGE_FIRST);
+    EXPECT_EQ(array[1], 14);
+    EXPECT_EQ(array[2], 16 | LOSSDATA_SEQNO_RANGE_FIRST);
+    EXPECT_EQ(array[3], 20);
+    EXPECT_EQ(array[4], 30);
+
+    // The array is cut so that there's a place for the range end.
+    m_lossList->getLossArray(array, len, 3);
+    EXPECT_EQ(len, 2);
+
+    EXPECT_TRUE(m_lossList->find(15, 16));
+    EXPECT_FALSE(m_lossList->find(15, 15));
+    EXPECT_FALSE(m_lossList->find(21, 29));
+    EXPECT_TRUE(m_lossList->find(25, 35));
+    // With the end before the start only the start is checked.
+    EXPECT_FALSE(m_lossList->find(25, 20));
+
+    EXPECT_EQ(m_lossList->removeUpTo(16), 10);
+    EXPECT_EQ(m_lossList->getLossLength(), 5);
+    EXPECT_EQ(m_lossList->getFirstLostSeq(), 17);
+
+    EXPECT_TRUE(m_lossList->remove(17, 40));
+    CheckEmptyArray();
+}
+
+/// Removing a range that empties the list leaves the end of the range
+/// as the largest sequence seen, unless the list got empty exactly at it.
+TEST_F(CRcvLossListTest, RemoveRangeLargestSeq)
+{
+    EXPECT_EQ(m_lossList->insert(10, 12), 3);
+    EXPECT_TRUE(m_lossList->remove(10, 20));
+    CheckEmptyArray();
+    EXPECT_EQ(m_lossList->insert(15, 16), 0);
+    EXPECT_EQ(m_lossList->insert(21, 21), 1);
+
+    EXPECT_TRUE(m_lossList->remove(21, 21));
+    CheckEmptyArray();
+    EXPECT_EQ(m_lossList->insert(5, 5), 1);
+    EXPECT_EQ(m_lossList->getFirstLostSeq(), 5);
+}
+
+/// Insert ranges scattered over the whole list size,
+/// also crossing the sequence number wrap.
+TEST_F(CRcvLossListTest, InsertScatteredWrap)
+{
+    const int32_t start = CSeqNo::decseq(0, CRcvLossListTest::SIZE / 2);
+    for (int i = 0; i < CRcvLossListTest::SIZE; i += 4)
+        EXPECT_EQ(m_lossList->insert(CSeqNo::incseq(start, i), CSeqNo::incseq(start, i + 1)), 2);
+    EXPECT_EQ(m_lossList->getLossLength(), CRcvLossListTest::SIZE / 2);
+    EXPECT_EQ(m_lossList->getFirstLostSeq(), start);
+
+    std::vector<int32_t> array(CRcvLossListTest::SIZE);
+    int                  len = 0;
+    m_lossList->getLossArray(array.data(), len, (int) array.size());
+    ASSERT_EQ(len, CRcvLossListTest::SIZE / 2);
+    for (int i = 0; i < len; i += 2)
+    {
+        EXPECT_EQ(array[i], CSeqNo::incseq(start, 2 * i) | LOSSDATA_SEQNO_RANGE_FIRST);
+        EXPECT_EQ(array[i + 1], CSeqNo::incseq(start, 2 * i + 1));
+    }
+
+    EXPECT_TRUE(m_lossList->find(CSeqNo::m_iMaxSeqNo, 1));
+    EXPECT_EQ(m_lossList->removeUpTo(CSeqNo::m_iMaxSeqNo), start);
+    EXPECT_EQ(m_lossList->getFirstLostSeq(), 0);
+    EXPECT_EQ(m_lossList->getLossLength(), CRcvLossListTest::SIZE / 4);
+}
+
+/// Benchmark: a 10 Gbps stream with 200 ms RTT (about 170k packets in flight)
+/// and 1% of scattered losses, recovered out of order. Every received packet
+/// is looked up in the loss list and a NAK report is built every 1000 packets.
+/// Run with --gtest_also_run_disabled_tests.
+TEST(CRcvLossListBench, DISABLED_ScatteredLoss)
+{
+    const int WINDOW = 171000;
+    const int NPKTS  = 1000000;
+    CRcvLossList lossList(WINDOW * 2);
+
+    std::deque<int32_t>  pending;
+    std::vector<int32_t> array(1456 / 4);
+    uint32_t             rnd = 1;
+    long long            nak_len = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int32_t seq = 0; seq < NPKTS; ++seq)
+    {
+        rnd = rnd * 1103515245 + 12345;
+        if ((rnd >> 16) % 100 == 0)
+        {
+            lossList.insert(seq, seq);
+            pending.push_back(seq);
+        }
+        else
+        {
+            lossList.find(seq, seq);
+        }
+
+        // Retransmissions arrive after about one RTT, not in order.
+        if (!pending.empty() && seq - pending.front() >= WINDOW)
+        {
+            const size_t i = (rnd >> 8) % std::min<size_t>(pending.size(), 64);
+            lossList.find(pending[i], pending[i]);
+            lossList.remove(pending[i]);
+            pending.erase(pending.begin() + i);
+        }
+
+        if (seq % 1000 == 0)
+        {
+            int len = 0;
+            lossList.getLossArray(array.data(), len, (int) array.size());
+            nak_len += len;
+        }
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    cerr << NPKTS << " packets, " << lossList.getLossLength() << " losses outstanding (" << pending.size() << " expected): "
+         << (NPKTS / secs / 1e6) << " Mpkt/s (NAK entries " << nak_len << ")\n";
+    EXPECT_GT(nak_len, 0);
+}
+
 TEST(CRcvFreshLossListTest, CheckFreshLossList)
 {
     srt::TestInit srtinit;
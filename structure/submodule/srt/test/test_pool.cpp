@@ -0,0 +1,109 @@
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "test_env.h"
+
+#include "srt.h"
+#include "pool.h"
+
+using srt::CObjectPool;
+
+TEST(ObjectPool, Disabled)
+{
+    void* p = CObjectPool::allocate(1000);
+    CObjectPool::release(p, 1000);
+    EXPECT_EQ(CObjectPool::retained(), 0U);
+}
+
+TEST(ObjectPool, ReuseBySize)
+{
+    CObjectPool::setCapacity(10000);
+
+    void* a = CObjectPool::allocate(1000);
+    void* b = CObjectPool::allocate(2000);
+    CObjectPool::release(a, 1000);
+    CObjectPool::release(b, 2000);
+    EXPECT_EQ(CObjectPool::retained(), 3000U);
+
+    // Only a block of the same size is reused.
+    EXPECT_EQ(CObjectPool::allocate(2000), b);
+    void* c = CObjectPool::allocate(1500);
+    EXPECT_NE(c, a);
+    EXPECT_EQ(CObjectPool::retained(), 1000U);
+    CObjectPool::release(b, 2000);
+    CObjectPool::release(c, 1500);
+    EXPECT_EQ(CObjectPool::retained(), 4500U);
+
+    // Blocks above the capacity are freed.
+    void* big = CObjectPool::allocate(8000);
+    CObjectPool::release(big, 8000);
+    EXPECT_EQ(CObjectPool::retained(), 4500U);
+
+    CObjectPool::setCapacity(2000);
+    EXPECT_LE(CObjectPool::retained(), 2000U);
+    CObjectPool::setCapacity(0);
+    EXPECT_EQ(CObjectPool::retained(), 0U);
+}
+
+// Connections made one after another with the pool enabled must work
+// the same, reusing the memory of the deleted sockets.
+TEST(ObjectPool, ConnectionChurn)
+{
+    srt::TestInit srtinit;
+    CObjectPool::setCapacity(64 * 1024 * 1024);
+
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(5565);
+    ASSERT_EQ(inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr), 1);
+
+    const SRTSOCKET listener = srt_create_socket();
+    ASSERT_NE(srt_bind(listener, (sockaddr*)& sa, sizeof sa), SRT_ERROR);
+    ASSERT_NE(srt_listen(listener, 4), SRT_ERROR);
+
+    size_t retained_idle = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        std::future<SRTSOCKET> accepted_future = std::async(std::launch::async, [listener]() {
+            return srt_accept(listener, NULL, NULL);
+        });
+
+        const SRTSOCKET caller = srt_create_socket();
+        ASSERT_NE(srt_connect(caller, (sockaddr*)& sa, sizeof sa), SRT_ERROR);
+        const SRTSOCKET accepted = accepted_future.get();
+        ASSERT_NE(accepted, SRT_INVALID_SOCK);
+
+        std::vector<char> buf(1316, char('a' + i));
+        std::vector<char> rbuf(1316);
+        for (int n = 0; n < 10; ++n)
+            ASSERT_EQ(srt_sendmsg(caller, buf.data(), int(buf.size()), -1, 1), int(buf.size()));
+        for (int n = 0; n < 10; ++n)
+        {
+            ASSERT_EQ(srt_recvmsg(accepted, rbuf.data(), int(rbuf.size())), int(rbuf.size()));
+            EXPECT_EQ(rbuf, buf);
+        }
+
+        // The new sockets have taken their memory from the pool.
+        if (i > 0)
+        {
+            EXPECT_LT(CObjectPool::retained(), retained_idle);
+        }
+
+        srt_close(caller);
+        srt_close(accepted);
+
+        // Wait for the GC to delete the sockets into the pool.
+        while (srt_getsockstate(caller) != SRTS_NONEXIST || srt_getsockstate(accepted) != SRTS_NONEXIST)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        if (i == 0)
+            retained_idle = CObjectPool::retained();
+        EXPECT_GT(CObjectPool::retained(), 0U);
+    }
+
+    srt_close(listener);
+    CObjectPool::setCapacity(0);
+}
@@ -0,0 +1,121 @@
+#include <chrono>
+#include <ctime>
+#include <future>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "test_env.h"
+
+#include "srt.h"
+
+// Periodic checks of the socket timers (ACK, NAK, EXP, keepalive) done
+// by the receiver queue worker for the connected sockets.
+class RcvTimers
+    : public ::testing::Test
+{
+protected:
+    RcvTimers()
+    {
+        memset(&m_sa, 0, sizeof m_sa);
+        m_sa.sin_family = AF_INET;
+        m_sa.sin_port = htons(5558);
+        EXPECT_EQ(inet_pton(AF_INET, "127.0.0.1", &m_sa.sin_addr), 1);
+    }
+
+    // Connects nsock callers to the listener with the given peer idle timeout.
+    // The callers are bound to the same port, so both sides have all the sockets
+    // in the receiver queue of one multiplexer.
+    void connect(size_t nsock, int peer_idle_ms)
+    {
+        sockaddr_in csa = m_sa;
+        csa.sin_port = htons(5559);
+
+        m_listener = srt_create_socket();
+        EXPECT_NE(srt_setsockflag(m_listener, SRTO_PEERIDLETIMEO, &peer_idle_ms, sizeof peer_idle_ms), SRT_ERROR);
+        EXPECT_NE(srt_bind(m_listener, (sockaddr*)& m_sa, sizeof m_sa), SRT_ERROR);
+        EXPECT_NE(srt_listen(m_listener, int(nsock)), SRT_ERROR);
+
+        std::future<void> accepted = std::async(std::launch::async, [this, nsock]() {
+            for (size_t i = 0; i < nsock; ++i)
+            {
+                const SRTSOCKET a = srt_accept(m_listener, NULL, NULL);
+                if (a == SRT_INVALID_SOCK)
+                    break;
+                m_accepted.push_back(a);
+            }
+        });
+
+        for (size_t i = 0; i < nsock; ++i)
+        {
+            const SRTSOCKET s = srt_create_socket();
+            EXPECT_NE(srt_setsockflag(s, SRTO_PEERIDLETIMEO, &peer_idle_ms, sizeof peer_idle_ms), SRT_ERROR);
+            m_callers.push_back(s);
+            EXPECT_NE(srt_bind(s, (sockaddr*)& csa, sizeof csa), SRT_ERROR);
+            EXPECT_NE(srt_connect(s, (sockaddr*)& m_sa, sizeof m_sa), SRT_ERROR);
+        }
+        accepted.wait();
+        ASSERT_EQ(m_accepted.size(), nsock);
+    }
+
+    ~RcvTimers()
+    {
+        for (size_t i = 0; i < m_callers.size(); ++i)
+            srt_close(m_callers[i]);
+        for (size_t i = 0; i < m_accepted.size(); ++i)
+            srt_close(m_accepted[i]);
+        srt_close(m_listener);
+    }
+
+    srt::TestInit m_srtinit;
+    sockaddr_in m_sa;
+    SRTSOCKET m_listener = SRT_INVALID_SOCK;
+    std::vector<SRTSOCKET> m_callers, m_accepted;
+};
+
+// Idle connections must be kept alive by keepalives, with the peer idle
+// timeout shorter than the idle period, and deliver data sent afterwards.
+TEST_F(RcvTimers, IdleKeepalive)
+{
+    connect(4, 1500);
+    std::this_thread::sleep_for(std::chrono::milliseconds(3000));
+
+    for (size_t i = 0; i < m_callers.size(); ++i)
+    {
+        EXPECT_EQ(srt_getsockstate(m_callers[i]), SRTS_CONNECTED);
+        EXPECT_EQ(srt_getsockstate(m_accepted[i]), SRTS_CONNECTED);
+    }
+
+    const char data[] = "after idle";
+    for (size_t i = 0; i < m_callers.size(); ++i)
+    {
+        SRT_TRACEBSTATS before, after;
+        EXPECT_NE(srt_bstats(m_callers[i], &before, 0), SRT_ERROR);
+
+        EXPECT_EQ(srt_sendmsg(m_callers[i], data, sizeof data, -1, true), int(sizeof data));
+        char buf[1316];
+        EXPECT_EQ(srt_recvmsg(m_accepted[i], buf, sizeof buf), int(sizeof data));
+        EXPECT_STREQ(buf, data);
+
+        // The ACK for the data must come back to the sender.
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        EXPECT_NE(srt_bstats(m_callers[i], &after, 0), SRT_ERROR);
+        EXPECT_GT(after.pktRecvACKTotal, before.pktRecvACKTotal);
+    }
+}
+
+// Processor time used by a number of idle connections.
+TEST_F(RcvTimers, DISABLED_IdleSockets)
+{
+    const size_t NSOCK = 500;
+    connect(NSOCK, 5000);
+
+    const std::clock_t start = std::clock();
+    std::this_thread::sleep_for(std::chrono::seconds(5));
+    const double cpu_ms = 1000.0 * (std::clock() - start) / CLOCKS_PER_SEC;
+
+    size_t connected = 0;
+    for (size_t i = 0; i < NSOCK; ++i)
+        connected += srt_getsockstate(m_accepted[i]) == SRTS_CONNECTED;
+    EXPECT_EQ(connected, NSOCK);
+    std::cout << "Idle connections: " << NSOCK << " x 2 sockets, processor time " << cpu_ms << "ms in 5s" << std::endl;
+}
@@ -0,0 +1,168 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "test_env.h"
+
+#include "srt.h"
+
+// Sharing of the sending rate of a multiplexer (SRTO_MUXMAXBW) by the sockets
+// with different priorities (SRTO_SNDPRIORITY) and weights (SRTO_SNDWEIGHT).
+class SndScheduler
+    : public ::testing::Test
+{
+protected:
+    static const int64_t MUXMAXBW = 2000000;
+
+    SndScheduler()
+        : m_stop(false)
+    {
+        memset(&m_sa, 0, sizeof m_sa);
+        m_sa.sin_family = AF_INET;
+        m_sa.sin_port = htons(5560);
+        EXPECT_EQ(inet_pton(AF_INET, "127.0.0.1", &m_sa.sin_addr), 1);
+    }
+
+    // Connects callers with the given priorities and weights, all bound to the
+    // same local port, so they share one multiplexer with the rate limit.
+    void connect(const std::vector<int>& priorities, const std::vector<int>& weights)
+    {
+        const size_t nsock = priorities.size();
+        sockaddr_in csa = m_sa;
+        csa.sin_port = htons(5561);
+
+        m_listener = srt_create_socket();
+        setup(m_listener);
+        EXPECT_NE(srt_bind(m_listener, (sockaddr*)& m_sa, sizeof m_sa), SRT_ERROR);
+        EXPECT_NE(srt_listen(m_listener, int(nsock)), SRT_ERROR);
+
+        std::future<void> accepted = std::async(std::launch::async, [this, nsock]() {
+            for (size_t i = 0; i < nsock; ++i)
+            {
+                const SRTSOCKET a = srt_accept(m_listener, NULL, NULL);
+                if (a == SRT_INVALID_SOCK)
+                    break;
+                m_accepted.push_back(a);
+            }
+        });
+
+        const int64_t maxbw = MUXMAXBW;
+        for (size_t i = 0; i < nsock; ++i)
+        {
+            const SRTSOCKET s = srt_create_socket();
+            setup(s);
+            EXPECT_NE(srt_setsockflag(s, SRTO_MUXMAXBW, &maxbw, sizeof maxbw), SRT_ERROR);
+            m_callers.push_back(s);
+            EXPECT_NE(srt_bind(s, (sockaddr*)& csa, sizeof csa), SRT_ERROR);
+            EXPECT_NE(srt_connect(s, (sockaddr*)& m_sa, sizeof m_sa), SRT_ERROR);
+            EXPECT_NE(srt_setsockflag(s, SRTO_SNDPRIORITY, &priorities[i], sizeof priorities[i]), SRT_ERROR);
+            EXPECT_NE(srt_setsockflag(s, SRTO_SNDWEIGHT, &weights[i], sizeof weights[i]), SRT_ERROR);
+        }
+        accepted.wait();
+        ASSERT_EQ(m_accepted.size(), nsock);
+    }
+
+    // Sends from all callers as fast as possible and returns the bytes
+    // sent by each of them within the given period.
+    std::vector<int64_t> transmit(int period_ms)
+    {
+        for (size_t i = 0; i < m_callers.size(); ++i)
+        {
+            m_threads.emplace_back([this, i]() {
+                char buf[1316] = {};
+                while (!m_stop)
+                    srt_sendmsg(m_callers[i], buf, sizeof buf, -1, true);
+            });
+            m_threads.emplace_back([this, i]() {
+                char buf[1316];
+                while (!m_stop)
+                    srt_recvmsg(m_accepted[i], buf, sizeof buf);
+            });
+        }
+
+        // Let the sender buffers fill up.
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::vector<int64_t> before = sentBytes();
+        std::this_thread::sleep_for(std::chrono::milliseconds(period_ms));
+        std::vector<int64_t> sent = sentBytes();
+        for (size_t i = 0; i < sent.size(); ++i)
+            sent[i] -= before[i];
+        return sent;
+    }
+
+    std::vector<int64_t> sentBytes()
+    {
+        std::vector<int64_t> bytes;
+        for (size_t i = 0; i < m_callers.size(); ++i)
+        {
+            SRT_TRACEBSTATS st;
+            EXPECT_NE(srt_bstats(m_callers[i], &st, 0), SRT_ERROR);
+            bytes.push_back(int64_t(st.byteSentTotal));
+        }
+        return bytes;
+    }
+
+    // Live mode, where the sending rate of every socket is only limited by
+    // SRTO_MAXBW. This is above the rate limit of the multiplexer, so that
+    // the multiplexer decides how much every socket sends.
+    void setup(SRTSOCKET s)
+    {
+        const int64_t maxbw = 2 * MUXMAXBW;
+        const linger lin = {0, 0};
+        const int timeo = 100;
+        EXPECT_NE(srt_setsockflag(s, SRTO_MAXBW, &maxbw, sizeof maxbw), SRT_ERROR);
+        EXPECT_NE(srt_setsockflag(s, SRTO_LINGER, &lin, sizeof lin), SRT_ERROR);
+        EXPECT_NE(srt_setsockflag(s, SRTO_SNDTIMEO, &timeo, sizeof timeo), SRT_ERROR);
+        EXPECT_NE(srt_setsockflag(s, SRTO_RCVTIMEO, &timeo, sizeof timeo), SRT_ERROR);
+    }
+
+    ~SndScheduler()
+    {
+        m_stop = true;
+        for (size_t i = 0; i < m_threads.size(); ++i)
+            m_threads[i].join();
+        for (size_t i = 0; i < m_callers.size(); ++i)
+            srt_close(m_callers[i]);
+        for (size_t i = 0; i < m_accepted.size(); ++i)
+            srt_close(m_accepted[i]);
+        srt_close(m_listener);
+    }
+
+    srt::TestInit m_srtinit;
+    sockaddr_in m_sa;
+    SRTSOCKET m_listener = SRT_INVALID_SOCK;
+    std::vector<SRTSOCKET> m_callers, m_accepted;
+    std::vector<std::thread> m_threads;
+    std::atomic<bool> m_stop;
+};
+
+TEST_F(SndScheduler, Weights)
+{
+    const int PERIOD_MS = 2000;
+    connect(std::vector<int>(2, 0), {1, 3});
+    const std::vector<int64_t> sent = transmit(PERIOD_MS);
+
+    // The rate limit of the multiplexer, with some tolerance for the timing.
+    EXPECT_LT(sent[0] + sent[1], MUXMAXBW * PERIOD_MS / 1000 * 6 / 5);
+    EXPECT_GT(sent[0] + sent[1], MUXMAXBW * PERIOD_MS / 1000 * 4 / 5);
+    // The socket with the weight 3 sends three times as much.
+    ASSERT_GT(sent[0], 0);
+    const double ratio = double(sent[1]) / sent[0];
+    EXPECT_GT(ratio, 2.0);
+    EXPECT_LT(ratio, 4.0);
+    std::cout << "Weights 1:3 sent " << sent[0] << " and " << sent[1] << " bytes" << std::endl;
+}
+
+TEST_F(SndScheduler, Priorities)
+{
+    const int PERIOD_MS = 2000;
+    connect({0, 1}, std::vector<int>(2, 1));
+    const std::vector<int64_t> sent = transmit(PERIOD_MS);
+
+    // The socket of the higher class takes almost the whole rate.
+    EXPECT_GT(sent[0] + sent[1], MUXMAXBW * PERIOD_MS / 1000 * 4 / 5);
+    EXPECT_GT(sent[1], 9 * sent[0]);
+    std::cout << "Priorities 0 and 1 sent " << sent[0] << " and " << sent[1] << " bytes" << std::endl;
+}
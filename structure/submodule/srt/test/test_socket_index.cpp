@@ -0,0 +1,182 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "test_env.h"
+
+#include "srt.h"
+#include "logging_api.h"
+#include "netinet_any.h"
+
+using namespace std;
+using srt::sockaddr_any;
+
+class TestSocketIndex
+    : public ::srt::Test
+{
+protected:
+    void setup() override
+    {
+        m_listener = srt_create_socket();
+        ASSERT_NE(m_listener, SRT_INVALID_SOCK);
+
+        sockaddr_in sa = sockaddr_in();
+        sa.sin_family = AF_INET;
+        ASSERT_EQ(inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr), 1);
+
+        int bind_res = -1;
+        for (int port = 5200; port <= 5300; ++port)
+        {
+            sa.sin_port = htons(port);
+            bind_res = srt_bind(m_listener, (sockaddr*)&sa, sizeof sa);
+            if (bind_res == 0)
+                break;
+        }
+        ASSERT_NE(bind_res, -1) << srt_getlasterror_str();
+        ASSERT_NE(srt_listen(m_listener, 64), -1);
+        m_sa = sa;
+    }
+
+    void teardown() override
+    {
+        for (size_t i = 0; i < m_callers.size(); ++i)
+            srt_close(m_callers[i]);
+        for (size_t i = 0; i < m_accepted.size(); ++i)
+            srt_close(m_accepted[i]);
+        srt_close(m_listener);
+    }
+
+    // Establish npairs connections over the loopback to the listener.
+    void connectPairs(size_t npairs)
+    {
+        for (size_t i = 0; i < npairs; ++i)
+        {
+            const SRTSOCKET c = srt_create_socket();
+            ASSERT_NE(c, SRT_INVALID_SOCK);
+            ASSERT_NE(srt_connect(c, (sockaddr*)&m_sa, sizeof m_sa), SRT_ERROR) << srt_getlasterror_str();
+            m_callers.push_back(c);
+
+            sockaddr_any peer;
+            int          len = sizeof peer;
+            const SRTSOCKET a = srt_accept(m_listener, peer.get(), &len);
+            ASSERT_NE(a, SRT_INVALID_SOCK);
+            m_accepted.push_back(a);
+        }
+    }
+
+    SRTSOCKET         m_listener = SRT_INVALID_SOCK;
+    sockaddr_in       m_sa       = sockaddr_in();
+    vector<SRTSOCKET> m_callers;
+    vector<SRTSOCKET> m_accepted;
+};
+
+// Lookups done without the global lock must still see a socket being
+// closed in the meantime either as existing or as closed, never anything else.
+TEST_F(TestSocketIndex, LookupWhileClosing)
+{
+    const size_t      NSOCK = 200;
+    vector<SRTSOCKET> socks;
+    for (size_t i = 0; i < NSOCK; ++i)
+    {
+        const SRTSOCKET s = srt_create_socket();
+        ASSERT_NE(s, SRT_INVALID_SOCK);
+        socks.push_back(s);
+    }
+
+    atomic<bool> done {false};
+    atomic<int>  invalid {0};
+    vector<thread> readers;
+    for (int t = 0; t < 4; ++t)
+    {
+        readers.emplace_back([&] {
+            while (!done)
+            {
+                for (size_t i = 0; i < NSOCK; ++i)
+                {
+                    const SRT_SOCKSTATUS st = srt_getsockstate(socks[i]);
+                    if (st != SRTS_INIT && st != SRTS_CLOSED && st != SRTS_NONEXIST)
+                        ++invalid;
+
+                    int       yes = 0;
+                    int       len = sizeof yes;
+                    srt_getsockflag(socks[i], SRTO_RCVSYN, &yes, &len);
+                }
+            }
+        });
+    }
+
+    for (size_t i = 0; i < NSOCK; ++i)
+        EXPECT_EQ(srt_close(socks[i]), 0);
+
+    done = true;
+    for (size_t t = 0; t < readers.size(); ++t)
+        readers[t].join();
+
+    EXPECT_EQ(invalid, 0);
+    for (size_t i = 0; i < NSOCK; ++i)
+    {
+        const SRT_SOCKSTATUS st = srt_getsockstate(socks[i]);
+        EXPECT_TRUE(st == SRTS_CLOSED || st == SRTS_NONEXIST);
+        EXPECT_EQ(srt_sendmsg2(socks[i], "x", 1, NULL), SRT_ERROR);
+    }
+}
+
+// Benchmark: N threads each calling srt_sendmsg2 on its own socket.
+// The sockets are non-blocking, so a full sender buffer only makes the
+// call return an error; the measurement is the rate of the API calls,
+// which is dominated by the socket lookup under contention.
+// Run with --gtest_also_run_disabled_tests.
+TEST_F(TestSocketIndex, DISABLED_SendContention)
+{
+    const size_t NTHREADS = 8;
+    connectPairs(NTHREADS);
+
+    // Nobody reads on the accepted side, don't flood the output
+    // with the receiver buffer overflow warnings.
+    srt_setloglevel(srt_logging::LogLevel::error);
+
+    for (size_t i = 0; i < m_callers.size(); ++i)
+    {
+        int no = 0;
+        ASSERT_NE(srt_setsockflag(m_callers[i], SRTO_SNDSYN, &no, sizeof no), SRT_ERROR);
+    }
+
+    array<char, 1316> payload;
+    payload.fill('x');
+
+    atomic<bool>      start {false};
+    atomic<bool>      stop {false};
+    vector<uint64_t>  calls(NTHREADS, 0);
+    vector<thread>    workers;
+    for (size_t t = 0; t < NTHREADS; ++t)
+    {
+        workers.emplace_back([&, t] {
+            while (!start)
+                this_thread::yield();
+            uint64_t n = 0;
+            while (!stop)
+            {
+                srt_sendmsg2(m_callers[t], payload.data(), (int) payload.size(), NULL);
+                ++n;
+            }
+            calls[t] = n;
+        });
+    }
+
+    const chrono::seconds duration(2);
+    start = true;
+    this_thread::sleep_for(duration);
+    stop = true;
+    for (size_t t = 0; t < workers.size(); ++t)
+        workers[t].join();
+
+    uint64_t total = 0;
+    for (size_t t = 0; t < NTHREADS; ++t)
+        total += calls[t];
+
+    cerr << NTHREADS << " threads: " << (total / duration.count()) << " srt_sendmsg2 calls/s total, "
+         << (total / duration.count() / NTHREADS) << " per thread\n";
+    EXPECT_GT(total, 0u);
+}
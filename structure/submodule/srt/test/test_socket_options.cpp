@@ -170,6 +170,9 @@ const OptionTestEntry g_test_matrix_options[] =
     //SRTO_BINDTODEVICE
     //{ SRTO_CONGESTION,      "SRTO_CONGESTION",  RestrictionType::PRE,               4,           "live",     "file",   "live",       "file",   {"liv", ""} },
     { SRTO_CONNTIMEO,        "SRTO_CONNTIMEO",  RestrictionType::PRE,     sizeof(int),                0,  INT32_MAX,     3000,          250,   {-1} },
+#ifdef SRT_ENABLE_ENCRYPTION
+    { SRTO_CRYPTOWORKERS, "SRTO_CRYPTOWORKERS", RestrictionType::PRE,     sizeof(int),                0,          8,        0,            2,   {-1, 9} },
+#endif
     { SRTO_DRIFTTRACER,    "SRTO_DRIFTTRACER",  RestrictionType::POST,   sizeof(bool),            false,       true,     true,        false,     {} },
     { SRTO_ENFORCEDENCRYPTION, "SRTO_ENFORCEDENCRYPTION", RestrictionType::PRE, sizeof(bool),     false,       true,     true,        false,     {} },
     //SRTO_EVENT
@@ -199,6 +202,7 @@ const OptionTestEntry g_test_matrix_options[] =
     { SRTO_MININPUTBW,       "SRTO_MININPUTBW", RestrictionType::POST, sizeof(int64_t),       int64_t(0),  INT64_MAX,  int64_t(0), int64_t(200000),  {int64_t(-1)}},
     { SRTO_MINVERSION,       "SRTO_MINVERSION", RestrictionType::PRE,     sizeof(int),                 0,  INT32_MAX, 0x010000,    0x010300,    {} },
     { SRTO_MSS,                     "SRTO_MSS", RestrictionType::PREBIND, sizeof(int),                76,     65536,     1500,        1400,    {-1, 0, 75} },
+    { SRTO_MUXMAXBW,           "SRTO_MUXMAXBW", RestrictionType::PREBIND, sizeof(int64_t),     int64_t(0),  INT64_MAX,  int64_t(0), int64_t(1000000), {int64_t(-1)}},
     { SRTO_NAKREPORT,         "SRTO_NAKREPORT", RestrictionType::PRE,    sizeof(bool),             false,      true,     true,        false,     {} },
     { SRTO_OHEADBW,             "SRTO_OHEADBW", RestrictionType::POST,    sizeof(int),                 5,        100,       25,          20, {-1, 0, 4, 101} },
     //SRTO_PACKETFILTER
@@ -223,13 +227,16 @@ const OptionTestEntry g_test_matrix_options[] =
     //SRTO_SNDDATA
     { SRTO_SNDDROPDELAY,  "SRTO_SNDDROPDELAY", RestrictionType::POST,     sizeof(int),                -1, INT32_MAX, 0, 1500, {-2} },
     //SRTO_SNDKMSTATE
+    { SRTO_SNDPRIORITY,    "SRTO_SNDPRIORITY", RestrictionType::POST,     sizeof(int),                 0,         7,   0,    3, {-1, 8} },
     //SRTO_SNDSYN
     { SRTO_SNDTIMEO,          "SRTO_SNDTIMEO", RestrictionType::POST,     sizeof(int),                -1, INT32_MAX, -1, 1400, {-2} },
+    { SRTO_SNDWEIGHT,        "SRTO_SNDWEIGHT", RestrictionType::POST,     sizeof(int),                 1,       100,   1,   10, {0, 101} },
     //SRTO_STATE
     //SRTO_STREAMID
     { SRTO_TLPKTDROP,        "SRTO_TLPKTDROP",  RestrictionType::PRE,    sizeof(bool),             false,      true,     true, false, {} },
     //SRTO_TRANSTYPE
     //SRTO_TSBPDMODE
+    { SRTO_TSBPDWORKERS,  "SRTO_TSBPDWORKERS", RestrictionType::PRE,     sizeof(int),                0,          8,        0,            2,   {-1, 9} },
     //SRTO_UDP_RCVBUF
     //SRTO_UDP_SNDBUF
     //SRTO_VERSION
@@ -0,0 +1,150 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "test_env.h"
+
+#include "srt.h"
+
+// Statistics read with srt_bstats_snapshot(), without locking.
+class StatsSnapshot
+    : public ::testing::Test
+{
+protected:
+    StatsSnapshot()
+    {
+        memset(&m_sa, 0, sizeof m_sa);
+        m_sa.sin_family = AF_INET;
+        m_sa.sin_port = htons(5562);
+        EXPECT_EQ(inet_pton(AF_INET, "127.0.0.1", &m_sa.sin_addr), 1);
+    }
+
+    void connect()
+    {
+        m_listener = srt_create_socket();
+        EXPECT_NE(srt_bind(m_listener, (sockaddr*)& m_sa, sizeof m_sa), SRT_ERROR);
+        EXPECT_NE(srt_listen(m_listener, 1), SRT_ERROR);
+
+        std::future<SRTSOCKET> accepted = std::async(std::launch::async, [this]() {
+            return srt_accept(m_listener, NULL, NULL);
+        });
+
+        m_caller = srt_create_socket();
+        ASSERT_NE(srt_connect(m_caller, (sockaddr*)& m_sa, sizeof m_sa), SRT_ERROR);
+        m_accepted = accepted.get();
+        ASSERT_NE(m_accepted, SRT_INVALID_SOCK);
+    }
+
+    // Sends npkts messages of the given size and reads them all on the other side.
+    void transfer(int npkts, int size)
+    {
+        std::vector<char> buf(size, 'x');
+        std::vector<char> rbuf(1500);
+        for (int i = 0; i < npkts; ++i)
+            ASSERT_EQ(srt_sendmsg(m_caller, buf.data(), size, -1, 1), size);
+        for (int i = 0; i < npkts; ++i)
+            ASSERT_EQ(srt_recvmsg(m_accepted, rbuf.data(), int(rbuf.size())), size);
+    }
+
+    ~StatsSnapshot()
+    {
+        srt_close(m_caller);
+        srt_close(m_accepted);
+        srt_close(m_listener);
+    }
+
+    srt::TestInit m_srtinit;
+    sockaddr_in m_sa;
+    SRTSOCKET m_listener = SRT_INVALID_SOCK;
+    SRTSOCKET m_caller = SRT_INVALID_SOCK;
+    SRTSOCKET m_accepted = SRT_INVALID_SOCK;
+};
+
+TEST_F(StatsSnapshot, InvalidSocket)
+{
+    SRT_TRACEBSTATS stats;
+    EXPECT_EQ(srt_bstats_snapshot(SRT_INVALID_SOCK, &stats), SRT_ERROR);
+    EXPECT_EQ(srt_getlasterror(NULL), SRT_EINVSOCK);
+
+    const SRTSOCKET s = srt_create_socket();
+    EXPECT_EQ(srt_bstats_snapshot(s, &stats), SRT_ERROR);
+    EXPECT_EQ(srt_getlasterror(NULL), SRT_ENOCONN);
+    srt_close(s);
+}
+
+// Once the traffic has settled, the snapshot must report the same counters
+// as srt_bstats(), and it must not clear them.
+TEST_F(StatsSnapshot, MatchesBstats)
+{
+    connect();
+    transfer(100, 1000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    SRT_TRACEBSTATS snap, full;
+    ASSERT_EQ(srt_bstats_snapshot(m_caller, &snap), SRT_SUCCESS);
+    ASSERT_EQ(srt_bistats(m_caller, &full, 0, 1), SRT_SUCCESS);
+
+    EXPECT_EQ(snap.pktSentTotal, 100);
+    EXPECT_EQ(snap.pktSentTotal, full.pktSentTotal);
+    EXPECT_EQ(snap.pktSent, full.pktSent);
+    EXPECT_EQ(snap.byteSentTotal, full.byteSentTotal);
+    EXPECT_EQ(snap.byteSentUniqueTotal, full.byteSentUniqueTotal);
+    EXPECT_EQ(snap.pktRetransTotal, full.pktRetransTotal);
+    EXPECT_EQ(snap.pktSndBuf, full.pktSndBuf);
+    EXPECT_EQ(snap.byteSndBuf, full.byteSndBuf);
+    EXPECT_EQ(snap.msSndBuf, full.msSndBuf);
+    EXPECT_EQ(snap.byteMSS, full.byteMSS);
+
+    ASSERT_EQ(srt_bstats_snapshot(m_accepted, &snap), SRT_SUCCESS);
+    ASSERT_EQ(srt_bistats(m_accepted, &full, 0, 1), SRT_SUCCESS);
+
+    EXPECT_EQ(snap.pktRecvTotal, 100);
+    EXPECT_EQ(snap.pktRecvTotal, full.pktRecvTotal);
+    EXPECT_EQ(snap.pktRecvUniqueTotal, full.pktRecvUniqueTotal);
+    EXPECT_EQ(snap.byteRecvTotal, full.byteRecvTotal);
+    EXPECT_EQ(snap.pktRcvBuf, full.pktRcvBuf);
+    EXPECT_EQ(snap.byteRcvBuf, full.byteRcvBuf);
+    // The timespan is sampled by the buffer, but it does not change anymore
+    // when the traffic has settled.
+    EXPECT_EQ(snap.msRcvBuf, full.msRcvBuf);
+
+    // The snapshot never clears the interval counters.
+    ASSERT_EQ(srt_bstats_snapshot(m_accepted, &snap), SRT_SUCCESS);
+    EXPECT_EQ(snap.pktRecv, 100);
+}
+
+// Polling the snapshot from other threads while data are being sent
+// must always see the counters growing.
+TEST_F(StatsSnapshot, ConcurrentPolling)
+{
+    connect();
+
+    std::atomic<bool> done(false);
+    std::vector<std::future<bool>> pollers;
+    for (int i = 0; i < 2; ++i)
+    {
+        const SRTSOCKET s = i == 0 ? m_caller : m_accepted;
+        pollers.push_back(std::async(std::launch::async, [s, &done]() {
+            int64_t prev_sent = 0, prev_recv = 0;
+            while (!done)
+            {
+                SRT_TRACEBSTATS stats;
+                if (srt_bstats_snapshot(s, &stats) == SRT_ERROR)
+                    return false;
+                if (stats.pktSentTotal < prev_sent || stats.pktRecvTotal < prev_recv)
+                    return false;
+                prev_sent = stats.pktSentTotal;
+                prev_recv = stats.pktRecvTotal;
+            }
+            return true;
+        }));
+    }
+
+    transfer(500, 1000);
+    done = true;
+
+    for (size_t i = 0; i < pollers.size(); ++i)
+        EXPECT_TRUE(pollers[i].get());
+}
@@ -1,10 +1,15 @@
 #include "gtest/gtest.h"
 #include <array>
+#include <functional>
+#include <iomanip>
+#include <vector>
 #include <chrono>
 #include <thread>
 #include <future>
 #include <numeric> // std::accumulate
 #include <regex>   // Used in FormatTime test
+#include <ctime>
+#include "test_env.h"
 #include "sync.h"
 #include "common.h"
 
@@ -706,3 +711,157 @@ TEST(Sync, FormatTimeSys)
     EXPECT_TRUE(time1 == time2);
 }
 #endif
+
+// The steady clock must never go back in any thread, also across
+// the periodic recalibrations of SRT_SYNC_CLOCK_TSC (every second).
+TEST(SyncSteadyClock, MonotonicInThreads)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const steady_clock::time_point srt_start = steady_clock::now();
+
+    std::vector<std::future<bool>> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.push_back(std::async(std::launch::async, [start]() {
+            steady_clock::time_point prev = steady_clock::now();
+            while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1200))
+            {
+                const steady_clock::time_point now = steady_clock::now();
+                if (now < prev)
+                    return false;
+                prev = now;
+            }
+            return true;
+        }));
+    }
+    for (auto& r : readers)
+        EXPECT_TRUE(r.get());
+
+    // And it must count the same time as the system steady clock.
+    const long long srt_us = count_microseconds(steady_clock::now() - srt_start);
+    const long long std_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_NEAR(srt_us, std_us, 1000 + std_us / 1000);
+}
+
+TEST(SyncLoopClock, CachedInScope)
+{
+    const steady_clock::time_point before = loop_now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    EXPECT_GT(loop_now(), before);
+
+    {
+        LoopClock loop_clock;
+        const steady_clock::time_point cached = loop_clock.now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        EXPECT_EQ(loop_now(), cached);
+
+        // Other threads don't see it.
+        std::async(std::launch::async, [cached]() {
+            EXPECT_GT(loop_now(), cached);
+        }).wait();
+
+        {
+            const LoopClock inner;
+            EXPECT_EQ(loop_now(), inner.now());
+            EXPECT_GT(inner.now(), cached);
+        }
+        EXPECT_EQ(loop_now(), cached);
+
+        loop_clock.refresh();
+        EXPECT_GT(loop_clock.now(), cached);
+        EXPECT_EQ(loop_now(), loop_clock.now());
+    }
+
+    const steady_clock::time_point after = steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    EXPECT_GT(loop_now(), after);
+}
+
+// The cost of reading the time with the clock the library was built with
+// (see ENABLE_TSC_CLOCK), compared to the other clocks.
+TEST(SyncSteadyClock, DISABLED_NowCost)
+{
+    const int N = 10000000;
+    auto measure = [N](const char* name, const std::function<long long()>& fn) {
+        long long sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < N; ++i)
+            sink += fn();
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / N;
+        cout << setw(36) << left << name << ns << " ns/call" << (sink == 42 ? " " : "") << endl;
+    };
+
+    cout << "SRT clock: " << SRT_SYNC_CLOCK_STR << endl;
+    measure("sync::steady_clock::now()", []() { return (long long) steady_clock::now().time_since_epoch().count(); });
+    measure("std::chrono::steady_clock::now()", []() { return (long long) std::chrono::steady_clock::now().time_since_epoch().count(); });
+#ifndef _WIN32
+    measure("clock_gettime(CLOCK_MONOTONIC)", []() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (long long) ts.tv_nsec;
+    });
+#endif
+    measure("sync::loop_now() without LoopClock", []() { return (long long) loop_now().time_since_epoch().count(); });
+    const LoopClock loop_clock;
+    measure("sync::loop_now() with LoopClock", []() { return (long long) loop_now().time_since_epoch().count(); });
+}
+
+// Processor time used by the send and receive queue workers for a transfer
+// at full speed. Compare the builds with different clocks (ENABLE_TSC_CLOCK).
+TEST(SyncSteadyClock, DISABLED_WorkersCpuTime)
+{
+    srt::TestInit srtinit;
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(5563);
+    ASSERT_EQ(inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr), 1);
+
+    const SRTSOCKET listener = srt_create_socket();
+    const int file_mode = SRTT_FILE;
+    ASSERT_NE(srt_setsockflag(listener, SRTO_TRANSTYPE, &file_mode, sizeof file_mode), SRT_ERROR);
+    ASSERT_NE(srt_bind(listener, (sockaddr*)&sa, sizeof sa), SRT_ERROR);
+    ASSERT_NE(srt_listen(listener, 1), SRT_ERROR);
+    auto accepted = std::async(std::launch::async, [listener]() { return srt_accept(listener, NULL, NULL); });
+
+    const SRTSOCKET caller = srt_create_socket();
+    ASSERT_NE(srt_setsockflag(caller, SRTO_TRANSTYPE, &file_mode, sizeof file_mode), SRT_ERROR);
+    ASSERT_NE(srt_connect(caller, (sockaddr*)&sa, sizeof sa), SRT_ERROR);
+    const SRTSOCKET acc = accepted.get();
+    ASSERT_NE(acc, SRT_INVALID_SOCK);
+
+    const int64_t total = 100 * 1000 * 1000;
+    auto receiver = std::async(std::launch::async, [acc, total]() {
+        std::vector<char> buf(65536);
+        int64_t received = 0;
+        while (received < total)
+        {
+            const int n = srt_recv(acc, buf.data(), int(buf.size()));
+            if (n <= 0)
+                break;
+            received += n;
+        }
+        return received;
+    });
+
+    std::vector<char> buf(65536, 'x');
+    const std::clock_t cpu_start = std::clock();
+    const auto start = std::chrono::steady_clock::now();
+    for (int64_t sent = 0; sent < total; )
+    {
+        const int n = srt_send(caller, buf.data(), int(std::min<int64_t>(buf.size(), total - sent)));
+        if (n <= 0)
+            break;
+        sent += n;
+    }
+    EXPECT_EQ(receiver.get(), total);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const double cpu_ms = 1000.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+    cout << "SRT clock " << SRT_SYNC_CLOCK_STR << ": " << (total / 1000000) << "MB in " << ms << "ms, processor time "
+         << cpu_ms << "ms" << endl;
+
+    srt_close(caller);
+    srt_close(acc);
+    srt_close(listener);
+}
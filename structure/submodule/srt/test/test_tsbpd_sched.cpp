@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "test_env.h"
+
+#include "srt.h"
+
+// Live connections receiving with the TSBPD done by the shared scheduler
+// (SRTO_TSBPDWORKERS) or by a thread per socket.
+class TsbPdWorkers
+    : public ::testing::Test
+{
+protected:
+    static const int LATENCY_MS = 60;
+
+    struct Result
+    {
+        int received;      // packets received in total
+        int out_of_order;  // packets received in a wrong order
+        double mean_late_us; // average delivery time after the play time
+        int64_t max_late_us;
+    };
+
+    // Connects nsock callers to a listener with the given number of TSBPD workers,
+    // sends npkt packets over every connection in intervals of interval_ms and
+    // receives them with epoll (every other socket) or blocking reading.
+    Result transmit(int workers, int nsock, int npkt, int interval_ms)
+    {
+        Result r = Result();
+        srt::TestInit srtinit;
+
+        sockaddr_in sa;
+        memset(&sa, 0, sizeof sa);
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(5557);
+        EXPECT_EQ(inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr), 1);
+
+        SRTSOCKET l = srt_create_socket();
+        const int latency = LATENCY_MS;
+        EXPECT_NE(srt_setsockflag(l, SRTO_TSBPDWORKERS, &workers, sizeof workers), SRT_ERROR);
+        EXPECT_NE(srt_setsockflag(l, SRTO_RCVLATENCY, &latency, sizeof latency), SRT_ERROR);
+        EXPECT_NE(srt_bind(l, (sockaddr*)& sa, sizeof sa), SRT_ERROR);
+        EXPECT_NE(srt_listen(l, nsock), SRT_ERROR);
+
+        std::vector<SRTSOCKET> callers(nsock), accepted;
+        std::vector<std::future<int>> connected;
+        for (int i = 0; i < nsock; ++i)
+        {
+            callers[i] = srt_create_socket();
+            connected.push_back(std::async(std::launch::async, [&sa](SRTSOCKET s) {
+                return srt_connect(s, (sockaddr*)& sa, sizeof sa);
+                }, callers[i]));
+        }
+        for (int i = 0; i < nsock; ++i)
+        {
+            const SRTSOCKET a = srt_accept(l, NULL, NULL);
+            EXPECT_NE(a, SRT_INVALID_SOCK);
+            accepted.push_back(a);
+        }
+        for (size_t i = 0; i < connected.size(); ++i)
+            EXPECT_NE(connected[i].get(), SRT_ERROR);
+
+        int workers_set = -1, optlen = sizeof workers_set;
+        EXPECT_NE(srt_getsockflag(accepted[0], SRTO_TSBPDWORKERS, &workers_set, &optlen), SRT_ERROR);
+        EXPECT_EQ(workers_set, workers);
+
+        const int eid = srt_epoll_create();
+        const int ev = SRT_EPOLL_IN;
+        std::vector<SRTSOCKET> blocking;
+        for (int i = 0; i < nsock; ++i)
+        {
+            if (i % 2 == 0)
+            {
+                const bool no = false;
+                srt_setsockflag(accepted[i], SRTO_RCVSYN, &no, sizeof no);
+                srt_epoll_add_usock(eid, accepted[i], &ev);
+            }
+            else
+            {
+                const int timeout_ms = 1000;
+                srt_setsockflag(accepted[i], SRTO_RCVTIMEO, &timeout_ms, sizeof timeout_ms);
+                blocking.push_back(accepted[i]);
+            }
+        }
+
+        std::vector<int> next(nsock, 0);
+        std::vector<int64_t> late;
+        std::mutex rlock;
+        const auto receive = [&](SRTSOCKET s, int i) -> bool {
+            char buf[1316];
+            SRT_MSGCTRL mc = srt_msgctrl_default;
+            const int st = srt_recvmsg2(s, buf, sizeof buf, &mc);
+            if (st <= 0)
+                return false;
+            const int64_t now = srt_time_now();
+            std::lock_guard<std::mutex> lk(rlock);
+            late.push_back(now - mc.srctime); // srctime is the play time
+            int seq = 0;
+            memcpy(&seq, buf, sizeof seq);
+            if (seq != next[i])
+                ++r.out_of_order;
+            next[i] = seq + 1;
+            ++r.received;
+            return true;
+        };
+        const auto index_of = [&](SRTSOCKET s) {
+            return int(std::find(accepted.begin(), accepted.end(), s) - accepted.begin());
+        };
+
+        std::vector<std::thread> readers;
+        for (size_t i = 0; i < blocking.size(); ++i)
+        {
+            readers.emplace_back([&, i]() {
+                for (int n = 0; n < npkt; ++n)
+                {
+                    if (!receive(blocking[i], index_of(blocking[i])))
+                        break;
+                }
+            });
+        }
+        readers.emplace_back([&]() {
+            const int nepoll = (nsock + 1) / 2;
+            int done = 0;
+            while (done < nepoll * npkt)
+            {
+                SRTSOCKET ready[64];
+                int rlen = 64;
+                if (srt_epoll_wait(eid, ready, &rlen, NULL, NULL, 1000, 0, 0, 0, 0) <= 0)
+                    break;
+                for (int k = 0; k < rlen; ++k)
+                {
+                    while (receive(ready[k], index_of(ready[k])))
+                        ++done;
+                }
+            }
+        });
+
+        char buf[1316] = {};
+        for (int n = 0; n < npkt; ++n)
+        {
+            memcpy(buf, &n, sizeof n);
+            for (int i = 0; i < nsock; ++i)
+                EXPECT_EQ(srt_sendmsg(callers[i], buf, sizeof buf, -1, true), int(sizeof buf));
+            std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+        }
+
+        for (size_t i = 0; i < readers.size(); ++i)
+            readers[i].join();
+
+        int64_t sum = 0;
+        r.max_late_us = 0;
+        for (size_t i = 0; i < late.size(); ++i)
+        {
+            sum += late[i];
+            r.max_late_us = std::max(r.max_late_us, late[i]);
+        }
+        r.mean_late_us = late.empty() ? 0 : double(sum) / late.size();
+
+        srt_epoll_release(eid);
+        for (int i = 0; i < nsock; ++i)
+        {
+            srt_close(accepted[i]);
+            srt_close(callers[i]);
+        }
+        srt_close(l);
+        return r;
+    }
+};
+
+TEST_F(TsbPdWorkers, Delivery)
+{
+    const int NSOCK = 6, NPKT = 200;
+    const Result r = transmit(2, NSOCK, NPKT, 2);
+    EXPECT_EQ(r.received, NSOCK * NPKT);
+    EXPECT_EQ(r.out_of_order, 0);
+    // Not delivered before the play time.
+    EXPECT_GE(r.mean_late_us, 0);
+}
+
+// Compares the delay of the delivery after the play time, with a thread per socket
+// and with the shared scheduler.
+TEST_F(TsbPdWorkers, DISABLED_WakeupLatency)
+{
+    const int NSOCK = 100, NPKT = 300;
+    const int workers[] = {0, 1, 2, 4};
+    for (size_t i = 0; i < sizeof workers / sizeof workers[0]; ++i)
+    {
+        const Result r = transmit(workers[i], NSOCK, NPKT, 10);
+        EXPECT_EQ(r.received, NSOCK * NPKT);
+        std::cout << "TSBPD " << (workers[i] ? "workers=" + std::to_string(workers[i]) : std::string("thread per socket"))
+            << ": received " << r.received
+            << " late mean=" << r.mean_late_us << "us max=" << r.max_late_us << "us" << std::endl;
+    }
+}
@@ -86,3 +86,51 @@ TEST(CUnitQueue, IncreaseAndFreeGrouped)
             << "Buffer capacity should not exceed two queues of 4 units";
     }
 }
+
+/// Grow the queue to 5 blocks of 4 units, then free all but one unit.
+/// After the low occupancy has lasted SHRINK_DELAY_MS, the blocks
+/// that are all free are released, keeping twice the units in use
+/// and the first block. The remaining units must still be usable.
+TEST(CUnitQueue, Shrink)
+{
+    srt::TestInit srtinit;
+    const int buffer_size_pkts = 4;
+    CUnitQueue unit_queue(buffer_size_pkts, 1500);
+
+    vector<CUnit*> taken_units;
+    for (int i = 0; i < 5 * buffer_size_pkts; ++i)
+    {
+        CUnit* unit = unit_queue.getNextAvailUnit();
+        ASSERT_NE(unit, nullptr);
+        unit_queue.makeUnitTaken(unit);
+        taken_units.push_back(unit);
+    }
+    const int grown = unit_queue.capacity();
+    EXPECT_GT(grown, 5 * buffer_size_pkts - 1);
+
+    sync::steady_clock::time_point now = sync::steady_clock::now();
+    unit_queue.shrink(now);
+    EXPECT_EQ(unit_queue.capacity(), grown) << "Nothing to release while all the units are in use";
+
+    // Keep one unit of the third block taken.
+    for (size_t i = 0; i < taken_units.size(); ++i)
+    {
+        if (i != 2 * buffer_size_pkts)
+            unit_queue.makeUnitFree(taken_units[i]);
+    }
+
+    unit_queue.shrink(now);
+    EXPECT_EQ(unit_queue.capacity(), grown) << "The low occupancy must last for a while";
+    now += sync::milliseconds_from(CUnitQueue::SHRINK_DELAY_MS);
+    unit_queue.shrink(now);
+    EXPECT_EQ(unit_queue.capacity(), 2 * buffer_size_pkts);
+    EXPECT_EQ(unit_queue.size(), 2 * buffer_size_pkts - 1);
+
+    for (int i = 0; i < 2 * buffer_size_pkts - 1; ++i)
+    {
+        CUnit* unit = unit_queue.getNextAvailUnit();
+        ASSERT_NE(unit, nullptr);
+        EXPECT_NE(unit, taken_units[2 * buffer_size_pkts]);
+        unit_queue.makeUnitTaken(unit);
+    }
+}